@@ -0,0 +1,295 @@
+/******************************************************************************
+    AUTHOR:
+    File written and Copyrighted by Zachary Dovel. All Rights Reserved.
+
+    LICENSE:
+    This file is part of gWaei.
+
+    gWaei is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    gWaei is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with gWaei.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+//!
+//! @file ahocorasick.c
+//!
+//! @brief Checks LwAhoCorasick against a brute force search on random patterns
+//!        and texts.
+//!
+//! Each round adds a few short random patterns, duplicates included, and
+//! scans a random text.  The bytes are drawn from a small alphabet with
+//! some UTF-8 lead and continuation bytes so patterns overlap and share
+//! prefixes and suffixes often.  Every reported (pattern, start, end) has to
+//! be one the brute force search finds at every offset of the text, and the
+//! other way around.  Every other round folds ASCII case and is checked
+//! against g_ascii_strncasecmp instead of memcmp.
+//!
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <glib.h>
+
+#include <libwaei/libwaei.h>
+
+#include "bench.h"
+
+
+static const gchar _alphabet[] = { 'a', 'b', 'c', 'A', 'B', ' ', '\xe3', '\x81', '\x82' };
+
+#define LW_BENCH_AHOCORASICK_MAX_PATTERNS 24
+#define LW_BENCH_AHOCORASICK_MAX_PATTERN_LENGTH 6
+#define LW_BENCH_AHOCORASICK_MAX_TEXT_LENGTH 256
+
+
+struct _LwBenchMatch {
+  gint pattern;
+  gsize start;
+  gsize end;
+};
+typedef struct _LwBenchMatch LwBenchMatch;
+
+
+static gint
+_compare_match (gconstpointer a, gconstpointer b)
+{
+    //Declarations
+    const LwBenchMatch *x;
+    const LwBenchMatch *y;
+
+    //Initializations
+    x = a;
+    y = b;
+
+    if (x->start != y->start) return (x->start < y->start) ? -1 : 1;
+    if (x->pattern != y->pattern) return (x->pattern < y->pattern) ? -1 : 1;
+    return 0;
+}
+
+
+static gchar*
+_new_random_string (GRand *rand, gint min, gint max)
+{
+    //Declarations
+    gchar *string;
+    gint length;
+    gint i;
+
+    //Initializations
+    length = g_rand_int_range (rand, min, max + 1);
+    string = g_new (gchar, length + 1);
+
+    for (i = 0; i < length; i++)
+      string[i] = _alphabet[g_rand_int_range (rand, 0, G_N_ELEMENTS (_alphabet))];
+    string[length] = '\0';
+
+    return string;
+}
+
+
+static gboolean
+_collect_match (gint pattern, gsize start, gsize end, gpointer data)
+{
+    //Declarations
+    LwBenchMatch match;
+
+    //Initializations
+    match.pattern = pattern;
+    match.start = start;
+    match.end = end;
+
+    g_array_append_val ((GArray*) data, match);
+
+    return TRUE;
+}
+
+
+static gboolean
+_stop_at_first_match (gint pattern, gsize start, gsize end, gpointer data)
+{
+    (*(gint*) data)++;
+
+    return FALSE;
+}
+
+
+//!
+//! @brief Finds every pattern at every offset of the text the slow way
+//!
+static void
+_brute_force (GPtrArray *patterns, const gchar *TEXT, gsize length, gboolean ignore_case, GArray *matches)
+{
+    //Declarations
+    LwBenchMatch match;
+    const gchar *pattern;
+    gsize pattern_length;
+    gsize i;
+    guint j;
+
+    for (i = 0; i < length; i++)
+    {
+      for (j = 0; j < patterns->len; j++)
+      {
+        pattern = g_ptr_array_index (patterns, j);
+        pattern_length = strlen (pattern);
+        if (i + pattern_length > length) continue;
+        if (ignore_case && g_ascii_strncasecmp (TEXT + i, pattern, pattern_length) != 0) continue;
+        if (!ignore_case && memcmp (TEXT + i, pattern, pattern_length) != 0) continue;
+
+        match.pattern = j;
+        match.start = i;
+        match.end = i + pattern_length;
+        g_array_append_val (matches, match);
+      }
+    }
+}
+
+
+//!
+//! @brief Runs one round and prints the first difference
+//! @returns TRUE if the automaton found the same matches as the brute force search
+//!
+static gboolean
+_run_round (GRand *rand, gint round, gboolean ignore_case)
+{
+    //Declarations
+    LwAhoCorasick *automaton;
+    GPtrArray *patterns;
+    GArray *expected;
+    GArray *actual;
+    LwBenchMatch *x;
+    LwBenchMatch *y;
+    gchar *text;
+    gchar *escaped;
+    gsize length;
+    gint total;
+    gint stops;
+    gint i;
+    gboolean same;
+
+    //Initializations
+    automaton = lw_ahocorasick_new ();
+    patterns = g_ptr_array_new_with_free_func (g_free);
+    expected = g_array_new (FALSE, FALSE, sizeof(LwBenchMatch));
+    actual = g_array_new (FALSE, FALSE, sizeof(LwBenchMatch));
+    total = g_rand_int_range (rand, 1, LW_BENCH_AHOCORASICK_MAX_PATTERNS + 1);
+    stops = 0;
+
+    lw_ahocorasick_set_ignore_case (automaton, ignore_case);
+    for (i = 0; i < total; i++)
+    {
+      //Repeat an earlier pattern now and then since each copy has to be reported
+      if (i > 0 && g_rand_int_range (rand, 0, 8) == 0)
+        g_ptr_array_add (patterns, g_strdup (g_ptr_array_index (patterns, g_rand_int_range (rand, 0, i))));
+      else
+        g_ptr_array_add (patterns, _new_random_string (rand, 1, LW_BENCH_AHOCORASICK_MAX_PATTERN_LENGTH));
+      lw_ahocorasick_add (automaton, g_ptr_array_index (patterns, i), GINT_TO_POINTER (i));
+    }
+    lw_ahocorasick_compile (automaton);
+
+    text = _new_random_string (rand, 0, LW_BENCH_AHOCORASICK_MAX_TEXT_LENGTH);
+    length = strlen (text);
+
+    _brute_force (patterns, text, length, ignore_case, expected);
+    lw_ahocorasick_scan (automaton, text, length, _collect_match, actual);
+    g_array_sort (expected, _compare_match);
+    g_array_sort (actual, _compare_match);
+
+    same = (expected->len == actual->len);
+    for (i = 0; same && i < (gint) expected->len; i++)
+    {
+      x = &g_array_index (expected, LwBenchMatch, i);
+      y = &g_array_index (actual, LwBenchMatch, i);
+      same = (_compare_match (x, y) == 0 && x->end == y->end);
+    }
+    for (i = 0; same && i < (gint) actual->len; i++)
+    {
+      y = &g_array_index (actual, LwBenchMatch, i);
+      same = (GPOINTER_TO_INT (lw_ahocorasick_get_pattern_data (automaton, y->pattern)) == y->pattern);
+    }
+    if (!same)
+    {
+      escaped = g_strescape (text, NULL);
+      fprintf (stderr, "Round %d%s: %u matches were expected and %u were reported in \"%s\"\n", round, (ignore_case) ? " ignoring case" : "", expected->len, actual->len, escaped);
+      g_free (escaped);
+    }
+
+    //A callback returning FALSE ends the scan at the first match
+    if (same)
+    {
+      same = (lw_ahocorasick_scan (automaton, text, length, _stop_at_first_match, &stops) == (expected->len == 0));
+      same = same && (stops == MIN (expected->len, 1));
+      if (!same) fprintf (stderr, "Round %d: the scan went on after the callback stopped it\n", round);
+    }
+
+    //Cleanup
+    g_free (text);
+    g_array_free (expected, TRUE);
+    g_array_free (actual, TRUE);
+    g_ptr_array_free (patterns, TRUE);
+    lw_ahocorasick_free (automaton);
+
+    return same;
+}
+
+
+int
+main (int argc, char *argv[])
+{
+    //Declarations
+    GOptionContext *context;
+    GError *error;
+    GRand *rand;
+    gint rounds;
+    gint seed;
+    gint i;
+    gboolean ok;
+
+    //Initializations
+    error = NULL;
+    rounds = 20000;
+    seed = 1;
+    ok = TRUE;
+
+    GOptionEntry entries[] = {
+      { "rounds", 'n', 0, G_OPTION_ARG_INT, &rounds, "Random pattern sets and texts to check", "N" },
+      { "seed", 0, 0, G_OPTION_ARG_INT, &seed, "Random seed so runs can be reproduced", "N" },
+      { NULL }
+    };
+
+    context = g_option_context_new (NULL);
+    g_option_context_set_summary (context, "Checks LwAhoCorasick against a brute force search.");
+    g_option_context_add_main_entries (context, entries, NULL);
+    g_option_context_parse (context, &argc, &argv, &error);
+    g_option_context_free (context);
+
+    if (error != NULL)
+    {
+      fprintf (stderr, "%s\n", error->message);
+      g_error_free (error);
+      return EXIT_FAILURE;
+    }
+
+    rand = g_rand_new_with_seed ((guint32) seed);
+
+    for (i = 0; i < rounds && ok; i++)
+      ok = _run_round (rand, i, i % 2 == 1);
+
+    if (ok) printf ("{ \"rounds\": %d }\n", rounds);
+
+    //Cleanup
+    g_rand_free (rand);
+
+    return (ok) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,47 @@
+#ifndef LW_BENCH_INCLUDED
+#define LW_BENCH_INCLUDED
+
+//!
+//! @file bench.h
+//!
+//! @brief Shared sizes for the benchmark generator and driver, and the
+//!        fixtures the checks share
+//!
+
+//Rough entry counts of the real dictionaries at scale 1
+#define LW_BENCH_EDICT_LINES     180000L
+#define LW_BENCH_ENAMDIC_LINES   740000L
+#define LW_BENCH_KANJIDIC_LINES   13000L
+#define LW_BENCH_EXAMPLES_PAIRS  150000L
+
+#define LW_BENCH_SEED_INTERVAL 1000  //!< A known entry is written every this many lines
+#define LW_BENCH_CJK_FIRST 0x4e00
+#define LW_BENCH_CJK_LAST  0x9fa5
+#define LW_BENCH_POLL_INTERVAL 100  //!< Microseconds between checks for threaded results
+
+//Handwriting corpus written by lwbench-strokegen
+#define LW_BENCH_STROKE_SIZE 256         //!< Width and height of the drawing area like the kanjipad canvas
+#define LW_BENCH_STROKE_LENGTH 96        //!< Pixels a synthesized stroke covers
+#define LW_BENCH_STROKE_POINTS_PER_CODE 4 //!< Points drawn along each direction code of a path
+#define LW_BENCH_STROKE_NOISE 3          //!< Default pixels of jitter added to each point
+#define LW_BENCH_CANDIDATES 5            //!< The top-N accuracy that is reported next to top-1
+
+#define LW_BENCH_DICTIONARY_HEADER "　？？？ /header/\n"  //!< The first line of a written EDICT dictionary
+
+typedef enum {
+  LW_BENCH_CORPUS_EDICT,
+  LW_BENCH_CORPUS_ENAMDIC,
+  LW_BENCH_CORPUS_KANJIDIC,
+  LW_BENCH_CORPUS_EXAMPLES
+} LwBenchCorpus;
+
+//Fixtures of the checks in fixture.c
+GHashTable* lw_bench_postings_new (void);
+void lw_bench_postings_add (GHashTable*, const gchar*, gsize, guint32);
+
+gchar* lw_bench_make_tmp_dir (const gchar*);
+gchar* lw_bench_make_config_dir (const gchar*);
+void lw_bench_remove_config_dir (const gchar*);
+FILE* lw_bench_open_dictionary (const gchar*, guint32*);
+
+#endif
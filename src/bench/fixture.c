@@ -0,0 +1,197 @@
+/******************************************************************************
+    AUTHOR:
+    File written and Copyrighted by Zachary Dovel. All Rights Reserved.
+
+    LICENSE:
+    This file is part of gWaei.
+
+    gWaei is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    gWaei is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with gWaei.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+//!
+//! @file fixture.c
+//!
+//! @brief Temporary folders, written dictionaries and the posting tables the
+//!        checks compare the indexes of libwaei with
+//!
+//! A posting table maps each key of a written dictionary to a GArray of the
+//! guint32 offsets of the lines it is in, in the order they were written.
+//!
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include <libwaei/libwaei.h>
+
+#include "bench.h"
+
+
+static void
+_free_postings (gpointer data)
+{
+    g_array_free ((GArray*) data, TRUE);
+}
+
+
+//!
+//! @brief Creates an empty posting table
+//! @returns A GHashTable to free with g_hash_table_destroy
+//!
+GHashTable*
+lw_bench_postings_new ()
+{
+    return g_hash_table_new_full (g_str_hash, g_str_equal, g_free, _free_postings);
+}
+
+
+//!
+//! @brief Records that a key is in the line at offset.  A key found twice in
+//!        the same line is only recorded once.
+//! @param postings A table made with lw_bench_postings_new
+//! @param KEY The start of the key
+//! @param length The length of the key in bytes
+//! @param offset The offset of its line in the dictionary
+//!
+void
+lw_bench_postings_add (GHashTable *postings, const gchar *KEY, gsize length, guint32 offset)
+{
+    //Declarations
+    GArray *offsets;
+    gchar *key;
+
+    //Initializations
+    key = g_strndup (KEY, length);
+    offsets = g_hash_table_lookup (postings, key);
+
+    if (offsets == NULL)
+    {
+      offsets = g_array_new (FALSE, FALSE, sizeof(guint32));
+      g_hash_table_insert (postings, key, offsets);
+    }
+    else
+    {
+      g_free (key);
+    }
+
+    if (offsets->len == 0 || g_array_index (offsets, guint32, offsets->len - 1) != offset)
+      g_array_append_val (offsets, offset);
+}
+
+
+//!
+//! @brief Creates a temporary folder and prints why when it can't
+//! @param NAME The name of the check the folder is for
+//! @returns The path of the folder to free with g_free or NULL
+//!
+gchar*
+lw_bench_make_tmp_dir (const gchar *NAME)
+{
+    //Declarations
+    GError *error;
+    gchar *template;
+    gchar *directory;
+
+    //Initializations
+    error = NULL;
+    template = g_strdup_printf ("%s-XXXXXX", NAME);
+    directory = g_dir_make_tmp (template, &error);
+
+    if (directory == NULL)
+    {
+      fprintf (stderr, "%s\n", error->message);
+      g_error_free (error);
+    }
+
+    //Cleanup
+    g_free (template);
+
+    return directory;
+}
+
+
+//!
+//! @brief Creates a temporary folder and makes it the user config folder, so
+//!        the dictionaries and caches libwaei builds paths to are in it
+//! @param NAME The name of the check the folder is for
+//! @returns The path of the folder to give to lw_bench_remove_config_dir or NULL
+//!
+gchar*
+lw_bench_make_config_dir (const gchar *NAME)
+{
+    //Declarations
+    gchar *directory;
+
+    //Initializations
+    directory = lw_bench_make_tmp_dir (NAME);
+
+    if (directory != NULL) g_setenv ("XDG_CONFIG_HOME", directory, TRUE);
+
+    return directory;
+}
+
+
+//!
+//! @brief Removes the folders libwaei made in a config folder of
+//!        lw_bench_make_config_dir and the folder itself.  The files in
+//!        them have to be removed first.
+//! @param DIRECTORY The folder
+//!
+void
+lw_bench_remove_config_dir (const gchar *DIRECTORY)
+{
+    //Declarations
+    static const LwFolderPath FOLDERS[] = { LW_PATH_DICTIONARY_EDICT, LW_PATH_DICTIONARY, LW_PATH_CACHE, LW_PATH_BASE };
+    gchar *folder;
+    gint i;
+
+    for (i = 0; i < G_N_ELEMENTS (FOLDERS); i++)
+    {
+      folder = lw_util_build_filename (FOLDERS[i], NULL);
+      g_rmdir (folder);
+      g_free (folder);
+    }
+    g_rmdir (DIRECTORY);
+}
+
+
+//!
+//! @brief Opens a dictionary to write and writes its header line
+//! @param PATH The path of the dictionary
+//! @param offset Set to the offset of the first line after the header
+//! @returns The open FILE or NULL if the header couldn't be written
+//!
+FILE*
+lw_bench_open_dictionary (const gchar *PATH, guint32 *offset)
+{
+    //Declarations
+    FILE *file;
+
+    //Initializations
+    file = g_fopen (PATH, "wb");
+    if (file == NULL) return NULL;
+
+    if (fputs (LW_BENCH_DICTIONARY_HEADER, file) == EOF)
+    {
+      fclose (file);
+      return NULL;
+    }
+    *offset = strlen (LW_BENCH_DICTIONARY_HEADER);
+
+    return file;
+}
@@ -0,0 +1,501 @@
+/******************************************************************************
+    AUTHOR:
+    File written and Copyrighted by Zachary Dovel. All Rights Reserved.
+
+    LICENSE:
+    This file is part of gWaei.
+
+    gWaei is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    gWaei is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with gWaei.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+//!
+//! @file fuzzy.c
+//!
+//! @brief Checks the fuzzy term search against brute force matching
+//!
+//! A random EDICT dictionary is written to a temporary config folder and its
+//! term index is built into the cache folder there.  The gloss words and
+//! readings of the dictionary are kept in a hash table with the offsets of
+//! their lines, and the index has to hold exactly those terms and lines.
+//! Then random queries, most of them a few edits away from a term, are looked
+//! up with lw_termindex_find_fuzzy.  The matches and their distances have to
+//! be the terms the whole edit distance table puts within the max distance,
+//! and lw_levenshtein_match has to agree with the table on every term.
+//!
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include <libwaei/libwaei.h>
+
+#include "bench.h"
+
+
+//Few letters so many words are only an edit or two apart
+static const gchar *_letters[] = { "a", "b", "c", "d", "e" };
+static const gchar *_capitals[] = { "A", "B", "C", "D", "E" };
+
+//The katakana are indexed as the hiragana at the same place
+static const gchar *_kana[] = { "あ", "か", "き", "ー" };
+static const gchar *_katakana[] = { "ア", "カ", "キ", "ー" };
+
+#define LW_BENCH_FUZZY_FILENAME "lwbench-fuzzy"
+#define LW_BENCH_FUZZY_MAX_WORD_LENGTH 8
+#define LW_BENCH_FUZZY_MAX_READING_LENGTH 6
+
+
+//!
+//! @brief Appends a random gloss word to the line and its lowercased term to term
+//!
+static void
+_append_random_word (GString *line, GString *term, GRand *rand)
+{
+    //Declarations
+    gint length;
+    gint c;
+    gint i;
+
+    //Initializations
+    length = g_rand_int_range (rand, 1, LW_BENCH_FUZZY_MAX_WORD_LENGTH + 1);
+    g_string_truncate (term, 0);
+
+    for (i = 0; i < length; i++)
+    {
+      c = g_rand_int_range (rand, 0, G_N_ELEMENTS (_letters));
+      g_string_append (line, (g_rand_int_range (rand, 0, 6) == 0) ? _capitals[c] : _letters[c]);
+      g_string_append (term, _letters[c]);
+    }
+}
+
+
+//!
+//! @brief Appends a random reading to the line and its hiragana term to term
+//!
+static void
+_append_random_reading (GString *line, GString *term, GRand *rand)
+{
+    //Declarations
+    gint length;
+    gint c;
+    gint i;
+
+    //Initializations
+    length = g_rand_int_range (rand, 1, LW_BENCH_FUZZY_MAX_READING_LENGTH + 1);
+    g_string_truncate (term, 0);
+
+    for (i = 0; i < length; i++)
+    {
+      c = g_rand_int_range (rand, 0, G_N_ELEMENTS (_kana));
+      g_string_append (line, (g_rand_boolean (rand)) ? _katakana[c] : _kana[c]);
+      g_string_append (term, _kana[c]);
+    }
+}
+
+
+//!
+//! @brief Writes a random EDICT dictionary and keeps the terms an index of it should have
+//! @returns FALSE if the dictionary couldn't be written
+//!
+static gboolean
+_write_dictionary (const gchar *PATH, gint lines, GRand *rand, GHashTable *terms)
+{
+    //Declarations
+    FILE *file;
+    GString *line;
+    GString *term;
+    guint32 offset;
+    gint glosses;
+    gint words;
+    gint i;
+    gint j;
+    gint k;
+    gboolean written;
+
+    //Initializations
+    file = lw_bench_open_dictionary (PATH, &offset);
+    if (file == NULL) return FALSE;
+    line = g_string_new (NULL);
+    term = g_string_new (NULL);
+    written = TRUE;
+
+    for (i = 0; i < lines && written; i++)
+    {
+      g_string_truncate (line, 0);
+
+      //A kana headword is its own reading, otherwise the readings are in brackets
+      if (g_rand_int_range (rand, 0, 4) == 0)
+      {
+        _append_random_reading (line, term, rand);
+        if (term->len > 3) lw_bench_postings_add (terms, term->str, term->len, offset);
+      }
+      else
+      {
+        g_string_append (line, "日本 [");
+        _append_random_reading (line, term, rand);
+        if (term->len > 3) lw_bench_postings_add (terms, term->str, term->len, offset);
+        if (g_rand_int_range (rand, 0, 3) == 0)
+        {
+          g_string_append_c (line, ';');
+          _append_random_reading (line, term, rand);
+          if (term->len > 3) lw_bench_postings_add (terms, term->str, term->len, offset);
+          g_string_append (line, "(ok)");
+        }
+        g_string_append_c (line, ']');
+      }
+
+      g_string_append (line, " /(n)");
+      glosses = g_rand_int_range (rand, 1, 4);
+      for (j = 0; j < glosses; j++)
+      {
+        words = g_rand_int_range (rand, 1, 4);
+        for (k = 0; k < words; k++)
+        {
+          g_string_append_c (line, ' ');
+          _append_random_word (line, term, rand);
+          if (term->len > 1) lw_bench_postings_add (terms, term->str, term->len, offset);
+        }
+
+        //Notes and words with digits aren't terms
+        if (g_rand_int_range (rand, 0, 5) == 0)
+        {
+          g_string_append (line, " (");
+          _append_random_word (line, term, rand);
+          g_string_append_c (line, ')');
+        }
+        if (g_rand_int_range (rand, 0, 5) == 0)
+        {
+          g_string_append_c (line, ' ');
+          _append_random_word (line, term, rand);
+          g_string_append_c (line, '2');
+        }
+        g_string_append_c (line, '/');
+      }
+
+      g_string_append_printf (line, "%s\n", (g_rand_int_range (rand, 0, 4) == 0) ? "(P)/" : "");
+      written = (fputs (line->str, file) != EOF);
+      offset += line->len;
+    }
+
+    //Cleanup
+    g_string_free (line, TRUE);
+    g_string_free (term, TRUE);
+    if (fclose (file) != 0) written = FALSE;
+
+    return written;
+}
+
+
+//!
+//! @brief Checks that the index holds the written terms in order with their lines
+//! @returns TRUE if the terms and postings are the same
+//!
+static gboolean
+_check_terms (LwTermIndex *index, GHashTable *terms)
+{
+    //Declarations
+    GArray *expected;
+    const guint32 *postings;
+    const gchar *term;
+    const gchar *previous;
+    guint32 total_terms;
+    guint32 total;
+    guint32 i;
+    gboolean same;
+
+    //Initializations
+    total_terms = lw_termindex_get_total_terms (index);
+    previous = NULL;
+    same = (total_terms == g_hash_table_size (terms));
+
+    if (!same) fprintf (stderr, "The index has %u terms and the dictionary has %u\n", total_terms, g_hash_table_size (terms));
+
+    for (i = 0; same && i < total_terms; i++)
+    {
+      term = lw_termindex_get_term (index, i);
+      expected = g_hash_table_lookup (terms, term);
+      postings = lw_termindex_get_postings (index, i, &total);
+
+      same = (expected != NULL && (previous == NULL || strcmp (previous, term) < 0));
+      same = same && (total == expected->len && memcmp (postings, expected->data, sizeof(guint32) * total) == 0);
+      if (!same) fprintf (stderr, "Term %u \"%s\" is out of order, not in the dictionary or has the wrong lines\n", i, term);
+
+      previous = term;
+    }
+
+    return same;
+}
+
+
+//!
+//! @brief The edit distance from the whole table, without any capping
+//!
+static gint
+_brute_force_distance (const gunichar *PATTERN, glong pattern_length, const gchar *TEXT)
+{
+    //Declarations
+    gunichar *text;
+    glong text_length;
+    gint *row;
+    gint diagonal;
+    gint above;
+    gint distance;
+    glong i;
+    glong j;
+
+    //Initializations
+    text = g_utf8_to_ucs4_fast (TEXT, -1, &text_length);
+    row = g_new (gint, pattern_length + 1);
+
+    for (j = 0; j <= pattern_length; j++)
+      row[j] = j;
+
+    for (i = 1; i <= text_length; i++)
+    {
+      diagonal = row[0];
+      row[0] = i;
+      for (j = 1; j <= pattern_length; j++)
+      {
+        above = row[j];
+        row[j] = MIN (MIN (above + 1, row[j - 1] + 1), diagonal + (PATTERN[j - 1] != text[i - 1]));
+        diagonal = above;
+      }
+    }
+    distance = row[pattern_length];
+
+    //Cleanup
+    g_free (row);
+    g_free (text);
+
+    return distance;
+}
+
+
+//!
+//! @brief Makes a query from a random term with a few random edits, or from nothing
+//!
+static gchar*
+_new_random_query (GPtrArray *keys, GRand *rand)
+{
+    //Declarations
+    GString *query;
+    const gchar *character;
+    gsize offset;
+    glong length;
+    gint edits;
+    gint position;
+    gint i;
+
+    //Initializations
+    query = g_string_new ((g_rand_int_range (rand, 0, 8) > 0) ? g_ptr_array_index (keys, g_rand_int_range (rand, 0, keys->len)) : "");
+    edits = g_rand_int_range (rand, 0, LW_LEVENSHTEIN_MAX_DISTANCE + 2);
+
+    for (i = 0; i < edits || query->len == 0; i++)
+    {
+      if (g_rand_boolean (rand))
+        character = _letters[g_rand_int_range (rand, 0, G_N_ELEMENTS (_letters))];
+      else
+        character = _kana[g_rand_int_range (rand, 0, G_N_ELEMENTS (_kana))];
+      length = g_utf8_strlen (query->str, -1);
+      position = g_rand_int_range (rand, 0, length + 1);
+      offset = g_utf8_offset_to_pointer (query->str, position) - query->str;
+
+      //Insert, delete or substitute the character at a random position
+      switch ((length > 0 && position < length) ? g_rand_int_range (rand, 0, 3) : 0)
+      {
+        case 0:
+          g_string_insert (query, offset, character);
+          break;
+        case 1:
+          g_string_erase (query, offset, g_utf8_skip[(guchar) query->str[offset]]);
+          break;
+        default:
+          g_string_erase (query, offset, g_utf8_skip[(guchar) query->str[offset]]);
+          g_string_insert (query, offset, character);
+          break;
+      }
+    }
+
+    return g_string_free (query, FALSE);
+}
+
+
+//!
+//! @brief Looks up a random query and prints the first difference
+//! @returns TRUE if the fuzzy search found the same terms as the brute force matching
+//!
+static gboolean
+_run_round (LwTermIndex *index, GPtrArray *keys, GRand *rand, gint round, gint *found)
+{
+    //Declarations
+    LwLevenshtein *automaton;
+    LwTermIndexMatch *match;
+    GArray *matches;
+    gunichar *pattern;
+    glong pattern_length;
+    gchar *query;
+    const gchar *term;
+    gint max_distance;
+    gint distance;
+    gint expected;
+    guint total;
+    guint i;
+    gboolean same;
+
+    //Initializations
+    query = _new_random_query (keys, rand);
+    max_distance = g_rand_int_range (rand, 0, LW_LEVENSHTEIN_MAX_DISTANCE + 1);
+    automaton = lw_levenshtein_new (query, max_distance);
+    pattern = g_utf8_to_ucs4_fast (query, -1, &pattern_length);
+    matches = g_array_new (FALSE, FALSE, sizeof(LwTermIndexMatch));
+    total = 0;
+    same = TRUE;
+
+    lw_termindex_find_fuzzy (index, automaton, matches);
+
+    //Every match has to be a different term the table puts at the same distance
+    for (i = 0; same && i < matches->len; i++)
+    {
+      match = &g_array_index (matches, LwTermIndexMatch, i);
+      term = lw_termindex_get_term (index, match->term);
+      distance = _brute_force_distance (pattern, pattern_length, term);
+      same = ((i == 0 || match->term > g_array_index (matches, LwTermIndexMatch, i - 1).term) && match->distance == distance && distance <= max_distance);
+      if (!same) fprintf (stderr, "Round %d: \"%s\" matched \"%s\" at distance %d, the table says %d of at most %d\n", round, term, query, match->distance, distance, max_distance);
+    }
+
+    //And no term within the distance can be missing
+    for (i = 0; same && i < keys->len; i++)
+    {
+      term = g_ptr_array_index (keys, i);
+      distance = _brute_force_distance (pattern, pattern_length, term);
+      expected = (distance <= max_distance) ? distance : -1;
+      if (expected >= 0) total++;
+
+      same = (lw_levenshtein_match (automaton, term) == expected);
+      if (!same) fprintf (stderr, "Round %d: lw_levenshtein_match says \"%s\" is %d from \"%s\", the table says %d\n", round, term, lw_levenshtein_match (automaton, term), query, distance);
+    }
+    if (same && total != matches->len)
+    {
+      fprintf (stderr, "Round %d: %u terms are within %d of \"%s\" and the search found %u\n", round, total, max_distance, query, matches->len);
+      same = FALSE;
+    }
+    *found += matches->len;
+
+    //Cleanup
+    g_array_free (matches, TRUE);
+    g_free (pattern);
+    lw_levenshtein_free (automaton);
+    g_free (query);
+
+    return same;
+}
+
+
+int
+main (int argc, char *argv[])
+{
+    //Declarations
+    GOptionContext *context;
+    GError *error;
+    GRand *rand;
+    GHashTable *terms;
+    GHashTableIter iter;
+    GPtrArray *keys;
+    gpointer key;
+    LwTermIndex *index;
+    gchar *directory;
+    gchar *path;
+    gint lines;
+    gint rounds;
+    gint seed;
+    gint found;
+    gint i;
+    gboolean ok;
+
+    //Initializations
+    error = NULL;
+    index = NULL;
+    lines = 60000;
+    rounds = 200;
+    seed = 1;
+    found = 0;
+
+    GOptionEntry entries[] = {
+      { "lines", 'l', 0, G_OPTION_ARG_INT, &lines, "Entries in the written dictionary", "N" },
+      { "rounds", 'n', 0, G_OPTION_ARG_INT, &rounds, "Random queries to look up", "N" },
+      { "seed", 0, 0, G_OPTION_ARG_INT, &seed, "Random seed so runs can be reproduced", "N" },
+      { NULL }
+    };
+
+    context = g_option_context_new (NULL);
+    g_option_context_set_summary (context, "Checks the fuzzy term search against brute force matching.");
+    g_option_context_add_main_entries (context, entries, NULL);
+    g_option_context_parse (context, &argc, &argv, &error);
+    g_option_context_free (context);
+
+    if (error != NULL)
+    {
+      fprintf (stderr, "%s\n", error->message);
+      g_error_free (error);
+      return EXIT_FAILURE;
+    }
+
+    //The dictionary and cache paths are built from the user config dir
+    directory = lw_bench_make_config_dir ("lwbench-fuzzy");
+    if (directory == NULL) return EXIT_FAILURE;
+
+    rand = g_rand_new_with_seed ((guint32) seed);
+    terms = lw_bench_postings_new ();
+    keys = g_ptr_array_new ();
+    path = lw_util_build_filename_by_dicttype (LW_DICTTYPE_EDICT, LW_BENCH_FUZZY_FILENAME);
+
+    ok = _write_dictionary (path, lines, rand, terms);
+    if (!ok) fprintf (stderr, "Unable to write the dictionary %s\n", path);
+
+    if (ok)
+    {
+      index = lw_termindex_new (LW_DICTTYPE_EDICT, LW_BENCH_FUZZY_FILENAME, &error);
+      ok = (index != NULL);
+      if (error != NULL) fprintf (stderr, "%s\n", error->message);
+    }
+
+    if (ok) ok = _check_terms (index, terms);
+
+    g_hash_table_iter_init (&iter, terms);
+    while (g_hash_table_iter_next (&iter, &key, NULL))
+      g_ptr_array_add (keys, key);
+
+    for (i = 0; ok && keys->len > 0 && i < rounds; i++)
+      ok = _run_round (index, keys, rand, i, &found);
+
+    if (ok) printf ("{ \"terms\": %u, \"rounds\": %d, \"matches\": %d }\n", keys->len, rounds, found);
+
+    //Cleanup
+    if (index != NULL) lw_termindex_free (index);
+    lw_termindex_remove (LW_DICTTYPE_EDICT, LW_BENCH_FUZZY_FILENAME);
+    g_remove (path);
+    lw_bench_remove_config_dir (directory);
+    if (error != NULL) g_error_free (error);
+    g_ptr_array_free (keys, TRUE);
+    g_hash_table_destroy (terms);
+    g_rand_free (rand);
+    g_free (path);
+    g_free (directory);
+
+    return (ok) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,418 @@
+/******************************************************************************
+    AUTHOR:
+    File written and Copyrighted by Zachary Dovel. All Rights Reserved.
+
+    LICENSE:
+    This file is part of gWaei.
+
+    gWaei is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    gWaei is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    
+    You should have received a copy of the GNU General Public License
+    along with gWaei.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+//!
+//! @file generate.c
+//!
+//! @brief Writes synthetic EDICT, KANJIDIC, ENAMDIC and Tanaka corpus files
+//!        laid out like an installed dictionary folder so the search
+//!        benchmark can be run against them.
+//!
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include "bench.h"
+
+
+static const char *_kanji_pool[] = {
+  "日", "本", "水", "飲", "食", "人", "大", "小", "山", "川", "田", "中", "上", "下", "学", "生",
+  "先", "年", "月", "火", "木", "金", "土", "話", "語", "書", "読", "見", "行", "来", "出", "入",
+  "高", "安", "新", "古", "長", "白", "赤", "青", "東", "西", "南", "北", "国", "外", "電", "車",
+  "駅", "道", "名", "前", "後", "時", "間", "分", "半", "今", "何", "毎", "朝", "昼", "夜", "雨",
+  "天", "気", "花", "魚", "犬", "鳥", "手", "足", "目", "耳", "口", "心", "体", "力", "男", "女",
+  "子", "父", "母", "友", "家", "店", "社", "会", "員", "医", "者", "病", "院", "部", "屋", "室",
+  NULL
+};
+
+static const char *_hiragana_pool[] = {
+  "あ", "い", "う", "え", "お", "か", "き", "く", "け", "こ", "さ", "し", "す", "せ", "そ",
+  "た", "ち", "つ", "て", "と", "な", "に", "ぬ", "ね", "の", "は", "ひ", "ふ", "へ", "ほ",
+  "ま", "み", "む", "め", "も", "や", "ゆ", "よ", "ら", "り", "る", "れ", "ろ", "わ", "ん",
+  "が", "ぎ", "ぐ", "げ", "ご", "ざ", "じ", "ず", "ぜ", "ぞ", "だ", "で", "ど", "ば", "び",
+  NULL
+};
+
+static const char *_katakana_pool[] = {
+  "ア", "イ", "ウ", "エ", "オ", "カ", "キ", "ク", "ケ", "コ", "サ", "シ", "ス", "セ", "ソ",
+  "タ", "チ", "ツ", "テ", "ト", "ナ", "ニ", "ヌ", "ネ", "ノ", "ハ", "ヒ", "フ", "ヘ", "ホ",
+  "マ", "ミ", "ム", "メ", "モ", "ラ", "リ", "ル", "レ", "ロ", "ン", "ー", "ッ", "ジ", "ド",
+  NULL
+};
+
+static const char *_english_pool[] = {
+  "house", "river", "mountain", "person", "large", "small", "study", "teacher", "year",
+  "month", "fire", "tree", "gold", "soil", "speak", "language", "write", "read", "see",
+  "go", "come", "exit", "enter", "high", "cheap", "new", "old", "long", "white", "red",
+  "blue", "east", "west", "south", "north", "country", "outside", "electricity", "car",
+  "station", "road", "name", "before", "after", "time", "interval", "minute", "half",
+  "now", "what", "every", "morning", "noon", "night", "rain", "heaven", "spirit", "flower",
+  "fish", "dog", "bird", "hand", "foot", "eye", "ear", "mouth", "heart", "body", "power",
+  "man", "woman", "child", "father", "mother", "friend", "shop", "company", "member",
+  NULL
+};
+
+static const char *_pos_pool[] = {
+  "(n)", "(n,vs)", "(adj-i)", "(adj-na,n)", "(v5r,vi)", "(v1,vt)", "(adv)", "(exp)", NULL
+};
+
+static const char *_name_tag_pool[] = {
+  "(s)", "(p)", "(u)", "(g)", "(f)", "(m)", "(h)", "(pr)", "(c)", "(st)", NULL
+};
+
+//!
+//! @brief Real looking entries that the benchmark queries are written against.  They
+//!        are mixed into the random lines at a fixed interval.
+//!
+static const char *_edict_seeds[] = {
+  "日本 [にほん] /(n) Japan/",
+  "水 [みず] /(n) water/",
+  "飲む [のむ] /(v5m,vt) to drink/to gulp/to swallow/",
+  "飲み水 [のみみず] /(n) drinking water/potable water/",
+  "日本語 [にほんご] /(n) Japanese (language)/",
+  "コーヒー /(n) coffee/",
+  "食べる [たべる] /(v1,vt) to eat/",
+  NULL
+};
+
+static const char *_enamdic_seeds[] = {
+  "阿部 [あべ] /Abe (s)/",
+  "日本橋 [にほんばし] /Nihonbashi (p)/",
+  "水野 [みずの] /Mizuno (s)/",
+  NULL
+};
+
+static const char *_examples_seeds[] = {
+  "A: 日本語を話します。\tI speak Japanese.#ID=1\nB: 日本語 話す{話します}\n",
+  "A: 水を飲みたい。\tI want to drink water.#ID=2\nB: 水 を 飲む{飲み} たい\n",
+  NULL
+};
+
+
+static const char* 
+_pick (GRand *rand, const char **pool)
+{
+    int length;
+
+    for (length = 0; pool[length] != NULL; length++);
+
+    return pool[g_rand_int_range (rand, 0, length)];
+}
+
+
+static void 
+_append_random (GString *string, GRand *rand, const char **pool, int min, int max)
+{
+    int length;
+    int i;
+
+    length = g_rand_int_range (rand, min, max + 1);
+    for (i = 0; i < length; i++)
+      g_string_append (string, _pick (rand, pool));
+}
+
+
+static void 
+_append_glosses (GString *string, GRand *rand)
+{
+    int total;
+    int i;
+
+    total = g_rand_int_range (rand, 1, 4);
+    for (i = 0; i < total; i++)
+    {
+      g_string_append_c (string, '/');
+      if (i == 0)
+      {
+        g_string_append (string, _pick (rand, _pos_pool));
+        g_string_append_c (string, ' ');
+      }
+      g_string_append (string, _pick (rand, _english_pool));
+      if (g_rand_boolean (rand))
+      {
+        g_string_append_c (string, ' ');
+        g_string_append (string, _pick (rand, _english_pool));
+      }
+    }
+    g_string_append (string, "/\n");
+}
+
+
+static gboolean 
+_write_edict (FILE *file, GRand *rand, long lines, const char **seeds, gboolean names)
+{
+    //Declarations
+    GString *line;
+    long i;
+    int seed;
+
+    //Initializations
+    line = g_string_new (NULL);
+    seed = 0;
+
+    fputs ("　？？？？ /EDICT, EDICT_SUB(P), EDICT2 Japanese-English Electronic Dictionary Files/Synthetic benchmark data/\n", file);
+
+    for (i = 0; i < lines && ferror (file) == 0; i++)
+    {
+      g_string_truncate (line, 0);
+
+      if (i % LW_BENCH_SEED_INTERVAL == 0)
+      {
+        if (seeds[seed] == NULL) seed = 0;
+        g_string_append (line, seeds[seed++]);
+        g_string_append_c (line, '\n');
+      }
+      else if (g_rand_int_range (rand, 0, 10) == 0)
+      {
+        //Katakana only loan words
+        _append_random (line, rand, _katakana_pool, 2, 6);
+        g_string_append_c (line, ' ');
+        _append_glosses (line, rand);
+      }
+      else
+      {
+        _append_random (line, rand, _kanji_pool, 1, 4);
+        g_string_append (line, " [");
+        _append_random (line, rand, _hiragana_pool, 2, 6);
+        g_string_append (line, "] ");
+        if (names)
+        {
+          g_string_append_c (line, '/');
+          g_string_append (line, _pick (rand, _english_pool));
+          g_string_append_c (line, ' ');
+          g_string_append (line, _pick (rand, _name_tag_pool));
+          g_string_append (line, "/\n");
+        }
+        else
+        {
+          _append_glosses (line, rand);
+        }
+      }
+
+      fputs (line->str, file);
+    }
+
+    g_string_free (line, TRUE);
+
+    return (ferror (file) == 0);
+}
+
+
+static gboolean 
+_write_kanjidic (FILE *file, GRand *rand, long lines)
+{
+    //Declarations
+    GString *line;
+    gchar character[7];
+    gunichar c;
+    long i;
+    int length;
+
+    //Initializations
+    line = g_string_new (NULL);
+
+    fputs ("# KANJIDIC JIS X 0208 Kanji Information File/Synthetic benchmark data/\n", file);
+
+    for (i = 0; i < lines && ferror (file) == 0; i++)
+    {
+      g_string_truncate (line, 0);
+
+      //Walk the CJK block so every line has a distinct kanji until it wraps
+      c = LW_BENCH_CJK_FIRST + (i % (LW_BENCH_CJK_LAST - LW_BENCH_CJK_FIRST));
+      if (i == 0) c = g_utf8_get_char ("水");
+      length = g_unichar_to_utf8 (c, character);
+      character[length] = '\0';
+
+      g_string_append_printf (line, "%s %04x U%04x B%d G%d S%d F%d N%d ",
+                              character, (guint) (0x3021 + (i % 0x5000)), (guint) c,
+                              g_rand_int_range (rand, 1, 215),
+                              (i == 0) ? 1 : g_rand_int_range (rand, 1, 11),
+                              (i == 0) ? 4 : g_rand_int_range (rand, 1, 31),
+                              g_rand_int_range (rand, 1, 2501),
+                              g_rand_int_range (rand, 1, 5500));
+      _append_random (line, rand, _katakana_pool, 1, 3);
+      g_string_append_c (line, ' ');
+      _append_random (line, rand, _hiragana_pool, 1, 3);
+      g_string_append (line, ".");
+      _append_random (line, rand, _hiragana_pool, 1, 2);
+      g_string_append_printf (line, " {%s} {%s}\n", _pick (rand, _english_pool), _pick (rand, _english_pool));
+
+      fputs (line->str, file);
+    }
+
+    g_string_free (line, TRUE);
+
+    return (ferror (file) == 0);
+}
+
+
+static gboolean 
+_write_examples (FILE *file, GRand *rand, long pairs)
+{
+    //Declarations
+    GString *line;
+    long i;
+    int seed;
+
+    //Initializations
+    line = g_string_new (NULL);
+    seed = 0;
+
+    for (i = 0; i < pairs && ferror (file) == 0; i++)
+    {
+      g_string_truncate (line, 0);
+
+      if (i % LW_BENCH_SEED_INTERVAL == 0)
+      {
+        if (_examples_seeds[seed] == NULL) seed = 0;
+        g_string_append (line, _examples_seeds[seed++]);
+      }
+      else
+      {
+        g_string_append (line, "A: ");
+        _append_random (line, rand, _kanji_pool, 1, 3);
+        _append_random (line, rand, _hiragana_pool, 2, 8);
+        g_string_append (line, "。\t");
+        g_string_append_printf (line, "The %s %s the %s.#ID=%ld\n",
+                                _pick (rand, _english_pool), _pick (rand, _english_pool), _pick (rand, _english_pool), i);
+        g_string_append (line, "B: ");
+        _append_random (line, rand, _kanji_pool, 1, 3);
+        g_string_append_c (line, ' ');
+        _append_random (line, rand, _hiragana_pool, 1, 3);
+        g_string_append_c (line, '\n');
+      }
+
+      fputs (line->str, file);
+    }
+
+    g_string_free (line, TRUE);
+
+    return (ferror (file) == 0);
+}
+
+
+static gboolean 
+_generate (const char *DIRECTORY, const char *TYPE, const char *FILENAME, LwBenchCorpus corpus, GRand *rand, long lines)
+{
+    //Declarations
+    gchar *folder;
+    gchar *path;
+    FILE *file;
+    gboolean ok;
+
+    //Initializations
+    folder = g_build_filename (DIRECTORY, PACKAGE, "dictionaries", TYPE, NULL);
+    path = g_build_filename (folder, FILENAME, NULL);
+    g_mkdir_with_parents (folder, 0755);
+    file = g_fopen (path, "wb");
+    ok = FALSE;
+
+    if (file != NULL)
+    {
+      fprintf (stderr, "Writing %ld entries to %s\n", lines, path);
+      switch (corpus)
+      {
+        case LW_BENCH_CORPUS_EDICT:
+          ok = _write_edict (file, rand, lines, _edict_seeds, FALSE);
+          break;
+        case LW_BENCH_CORPUS_ENAMDIC:
+          ok = _write_edict (file, rand, lines, _enamdic_seeds, TRUE);
+          break;
+        case LW_BENCH_CORPUS_KANJIDIC:
+          ok = _write_kanjidic (file, rand, lines);
+          break;
+        case LW_BENCH_CORPUS_EXAMPLES:
+          ok = _write_examples (file, rand, lines);
+          break;
+      }
+      if (fclose (file) != 0) ok = FALSE;
+    }
+
+    if (!ok) fprintf (stderr, "Unable to write to the file %s\n", path);
+
+    g_free (folder);
+    g_free (path);
+
+    return ok;
+}
+
+
+int 
+main (int argc, char *argv[])
+{
+    //Declarations
+    GOptionContext *context;
+    GError *error;
+    GRand *rand;
+    gchar *directory;
+    gint scale;
+    gint seed;
+    gboolean ok;
+
+    //Initializations
+    error = NULL;
+    directory = NULL;
+    scale = 1;
+    seed = 1;
+
+    GOptionEntry entries[] = {
+      { "output", 'o', 0, G_OPTION_ARG_FILENAME, &directory, "Folder to use as the config root of the generated dictionaries", "DIR" },
+      { "scale", 's', 0, G_OPTION_ARG_INT, &scale, "Size relative to the real dictionaries (1 to 20)", "N" },
+      { "seed", 0, 0, G_OPTION_ARG_INT, &seed, "Random seed so runs can be reproduced", "N" },
+      { NULL }
+    };
+
+    context = g_option_context_new (NULL);
+    g_option_context_set_summary (context, "Generates synthetic dictionaries for lwbench-search.");
+    g_option_context_add_main_entries (context, entries, NULL);
+    g_option_context_parse (context, &argc, &argv, &error);
+    g_option_context_free (context);
+
+    if (error != NULL)
+    {
+      fprintf (stderr, "%s\n", error->message);
+      g_error_free (error);
+      return EXIT_FAILURE;
+    }
+    if (directory == NULL || scale < 1 || scale > 20)
+    {
+      fprintf (stderr, "An output folder and a scale between 1 and 20 are required.\n");
+      return EXIT_FAILURE;
+    }
+
+    rand = g_rand_new_with_seed ((guint32) seed);
+
+    ok = _generate (directory, "edict", "English", LW_BENCH_CORPUS_EDICT, rand, LW_BENCH_EDICT_LINES * scale) &&
+         _generate (directory, "edict", "Names", LW_BENCH_CORPUS_ENAMDIC, rand, LW_BENCH_ENAMDIC_LINES * scale) &&
+         _generate (directory, "kanji", "Kanji", LW_BENCH_CORPUS_KANJIDIC, rand, LW_BENCH_KANJIDIC_LINES * scale) &&
+         _generate (directory, "examples", "Examples", LW_BENCH_CORPUS_EXAMPLES, rand, LW_BENCH_EXAMPLES_PAIRS * scale);
+
+    //Cleanup
+    g_rand_free (rand);
+    g_free (directory);
+
+    return (ok) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
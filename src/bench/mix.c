@@ -0,0 +1,406 @@
+/******************************************************************************
+    AUTHOR:
+    File written and Copyrighted by Zachary Dovel. All Rights Reserved.
+
+    LICENSE:
+    This file is part of gWaei.
+
+    gWaei is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    gWaei is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with gWaei.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+//!
+//! @file mix.c
+//!
+//! @brief Checks that lw_io_create_mix_dictionary writes the same Mix
+//!        dictionary byte for byte as the scan it replaced, and times both.
+//!
+//! The reference below is the merge as it was before the radicals were
+//! loaded into a hash table: the radicals file is rewound and read again
+//! for every kanjidic line.  Without --kanjidic and --radicals a small pair
+//! of files is written with the cases the hash join has to keep: comments
+//! in both files, kanji with no radicals, a kanji listed twice in the
+//! radicals where the first line wins, radicals for kanji that aren't in
+//! kanjidic, and characters outside the Basic Multilingual Plane.
+//!
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include <libwaei/libwaei.h>
+
+#include "bench.h"
+
+
+static const char *_radical_pool[] = {
+  "一", "丨", "丶", "丿", "乙", "亅", "二", "亠", "人", "儿", "入", "八", "冂", "冖", "冫", "几",
+  "凵", "刀", "力", "勹", "匕", "匚", "十", "卜", "卩", "厂", "厶", "又", "口", "囗", "土", "士",
+  NULL
+};
+
+
+static const char*
+_pick (GRand *rand, const char **pool)
+{
+    int length;
+
+    for (length = 0; pool[length] != NULL; length++);
+
+    return pool[g_rand_int_range (rand, 0, length)];
+}
+
+
+//!
+//! @brief Gets the character of the nth kanjidic line.  Every ninth one is
+//!        taken from CJK Extension B so it is four bytes long.
+//!
+static gunichar
+_get_character (long i)
+{
+    if (i % 9 == 8) return 0x20000 + i;
+    return LW_BENCH_CJK_FIRST + (i % (LW_BENCH_CJK_LAST - LW_BENCH_CJK_FIRST));
+}
+
+
+static void
+_append_radicals (GString *line, GRand *rand, gunichar c)
+{
+    //Declarations
+    int total;
+    int i;
+
+    //Initializations
+    total = g_rand_int_range (rand, 1, 6);
+
+    g_string_append_unichar (line, c);
+    g_string_append (line, " :");
+    for (i = 0; i < total; i++)
+    {
+      g_string_append_c (line, ' ');
+      g_string_append (line, _pick (rand, _radical_pool));
+    }
+    g_string_append_c (line, '\n');
+}
+
+
+static gboolean
+_write_sample (const gchar *KANJIDIC, const gchar *RADICALS, long lines, GRand *rand)
+{
+    //Declarations
+    FILE *kanjidic;
+    FILE *radicals;
+    GString *line;
+    long i;
+    gboolean ok;
+
+    //Initializations
+    kanjidic = g_fopen (KANJIDIC, "wb");
+    radicals = g_fopen (RADICALS, "wb");
+    line = g_string_new (NULL);
+    ok = (kanjidic != NULL && radicals != NULL);
+
+    if (ok)
+    {
+      fputs ("# KANJIDIC JIS X 0208 Kanji Information File/Synthetic check data/\n", kanjidic);
+      fputs ("# RADKFILE/KRADFILE synthetic check data\n", radicals);
+
+      //Radicals are written back to front so a lookup can't count on the order
+      for (i = lines - 1; i >= 0; i--)
+      {
+        if (i % 7 == 3) continue;
+        g_string_truncate (line, 0);
+        _append_radicals (line, rand, _get_character (i));
+        if (i % 11 == 5) _append_radicals (line, rand, _get_character (i));
+        if (i % 13 == 0) _append_radicals (line, rand, _get_character (i + lines));
+        if (i % 97 == 0) g_string_append (line, "# A comment between the entries\n");
+        fputs (line->str, radicals);
+      }
+
+      for (i = 0; i < lines; i++)
+      {
+        g_string_truncate (line, 0);
+        g_string_append_unichar (line, _get_character (i));
+        g_string_append_printf (line, " %04x U%04x B%d S%d {%s}\n",
+                                (guint) (0x3021 + i % 0x5000), (guint) _get_character (i),
+                                g_rand_int_range (rand, 1, 215), g_rand_int_range (rand, 1, 31),
+                                _pick (rand, _radical_pool));
+        if (i % 101 == 0) fputs ("# A comment between the entries\n", kanjidic);
+        fputs (line->str, kanjidic);
+      }
+    }
+
+    if (kanjidic != NULL && fclose (kanjidic) != 0) ok = FALSE;
+    if (radicals != NULL && fclose (radicals) != 0) ok = FALSE;
+
+    //Cleanup
+    g_string_free (line, TRUE);
+
+    return ok;
+}
+
+
+//!
+//! @brief The Mix dictionary merge before the hash join, kept to compare against
+//!
+static gboolean
+_write_reference (const char *output_path, const char *kanji_dictionary_path, const char *radicals_dictionary_path)
+{
+    //Declarations
+    FILE *output_file, *kanji_file, *radicals_file;
+    char radicals_input[LW_IO_MAX_FGETS_LINE];
+    char kanji_input[LW_IO_MAX_FGETS_LINE];
+    char output[LW_IO_MAX_FGETS_LINE * 2];
+    char *radicals_ptr, *kanji_ptr, *output_ptr, *temp_ptr;
+    gboolean ok;
+
+    //Initializations
+    kanji_file = g_fopen (kanji_dictionary_path, "r");
+    radicals_file = g_fopen (radicals_dictionary_path, "r");
+    output_file = g_fopen (output_path, "wb");
+    ok = (kanji_file != NULL && radicals_file != NULL && output_file != NULL);
+
+    while (ok && fgets(kanji_input, LW_IO_MAX_FGETS_LINE, kanji_file) != NULL)
+    {
+      if (kanji_input[0] == '#') continue;
+
+      kanji_ptr = kanji_input;
+      output_ptr = output;
+
+      //1. Copy the kanji character from the kanji line
+      while (*kanji_ptr != ' ')
+      {
+        *output_ptr = *kanji_ptr;
+        output_ptr++;
+        kanji_ptr++;
+      }
+
+      //2. Find the relevent radical line and insert it if available
+      rewind (radicals_file);
+      while (fgets(radicals_input, LW_IO_MAX_FGETS_LINE, radicals_file) != NULL)
+      {
+        //Check for a match
+        temp_ptr = kanji_input;
+        radicals_ptr = radicals_input;
+        while (*radicals_ptr != ' ' && *radicals_ptr == *temp_ptr)
+        {
+          temp_ptr++;
+          radicals_ptr++;
+        }
+
+        //If a match is found...
+        if (*radicals_ptr == ' ')
+        {
+          //Skip over the colon
+          radicals_ptr++;
+          radicals_ptr++;
+
+          //Copy the data
+          while (*(radicals_ptr + 1) != '\0')
+          {
+            *output_ptr = *radicals_ptr;
+            output_ptr++;
+            radicals_ptr++;
+          }
+
+          break;
+        }
+      }
+
+      //3. Copy the rest of the kanji line to output
+      while (*kanji_ptr != '\0')
+      {
+        *output_ptr = *kanji_ptr;
+        output_ptr++;
+        kanji_ptr++;
+      }
+
+      //4. Close off the string and write it to the file
+      *output_ptr = '\0';
+      fputs(output, output_file);
+    }
+
+    //Cleanup
+    if (kanji_file != NULL) fclose (kanji_file);
+    if (radicals_file != NULL) fclose (radicals_file);
+    if (output_file != NULL && fclose (output_file) != 0) ok = FALSE;
+
+    return ok;
+}
+
+
+//!
+//! @brief Compares two files and prints the first line where they differ
+//! @returns TRUE if they are the same byte for byte
+//!
+static gboolean
+_compare (const gchar *EXPECTED, const gchar *ACTUAL, gsize *length)
+{
+    //Declarations
+    gchar *expected;
+    gchar *actual;
+    gsize expected_length;
+    gsize actual_length;
+    gsize i;
+    gsize line;
+    gboolean same;
+
+    //Initializations
+    expected = NULL;
+    actual = NULL;
+    same = FALSE;
+    *length = 0;
+
+    if (!g_file_get_contents (EXPECTED, &expected, &expected_length, NULL) ||
+        !g_file_get_contents (ACTUAL, &actual, &actual_length, NULL))
+    {
+      fprintf (stderr, "Unable to read back the Mix dictionaries\n");
+    }
+    else
+    {
+      for (i = 0, line = 1; i < expected_length && i < actual_length && expected[i] == actual[i]; i++)
+        if (expected[i] == '\n') line++;
+
+      same = (i == expected_length && i == actual_length);
+      *length = expected_length;
+
+      if (!same)
+        fprintf (stderr, "The Mix dictionaries differ at byte %lu, line %lu (%lu and %lu bytes long)\n",
+                 (gulong) i, (gulong) line, (gulong) expected_length, (gulong) actual_length);
+    }
+
+    //Cleanup
+    g_free (expected);
+    g_free (actual);
+
+    return same;
+}
+
+
+int
+main (int argc, char *argv[])
+{
+    //Declarations
+    GOptionContext *context;
+    GError *error;
+    GTimer *timer;
+    GRand *rand;
+    gchar *directory;
+    gchar *kanjidic;
+    gchar *radicals;
+    gchar *expected;
+    gchar *actual;
+    gint lines;
+    gint seed;
+    gsize length;
+    double reference_time;
+    double join_time;
+    gboolean ok;
+
+    //Initializations
+    error = NULL;
+    kanjidic = NULL;
+    radicals = NULL;
+    lines = 3000;
+    seed = 1;
+
+    GOptionEntry entries[] = {
+      { "kanjidic", 'k', 0, G_OPTION_ARG_FILENAME, &kanjidic, "A kanjidic file to merge instead of the written sample", "FILE" },
+      { "radicals", 'r', 0, G_OPTION_ARG_FILENAME, &radicals, "The radicals file to merge it with", "FILE" },
+      { "lines", 'n', 0, G_OPTION_ARG_INT, &lines, "Kanji in the written sample", "N" },
+      { "seed", 0, 0, G_OPTION_ARG_INT, &seed, "Random seed of the written sample", "N" },
+      { NULL }
+    };
+
+    g_thread_init (NULL);
+
+    context = g_option_context_new (NULL);
+    g_option_context_set_summary (context, "Checks the Mix dictionary against the merge it replaced and times both.");
+    g_option_context_add_main_entries (context, entries, NULL);
+    g_option_context_parse (context, &argc, &argv, &error);
+    g_option_context_free (context);
+
+    if (error != NULL)
+    {
+      fprintf (stderr, "%s\n", error->message);
+      g_error_free (error);
+      return EXIT_FAILURE;
+    }
+    if ((kanjidic == NULL) != (radicals == NULL) || lines < 1)
+    {
+      fprintf (stderr, "Both --kanjidic and --radicals or neither of them are required.\n");
+      return EXIT_FAILURE;
+    }
+
+    directory = lw_bench_make_tmp_dir ("lwbench-mix");
+    if (directory == NULL) return EXIT_FAILURE;
+    if (kanjidic == NULL)
+    {
+      kanjidic = g_build_filename (directory, "kanjidic", NULL);
+      radicals = g_build_filename (directory, "radicals", NULL);
+      rand = g_rand_new_with_seed ((guint32) seed);
+      ok = _write_sample (kanjidic, radicals, lines, rand);
+      g_rand_free (rand);
+      if (!ok) fprintf (stderr, "Unable to write the sample files to %s\n", directory);
+    }
+    else
+    {
+      ok = TRUE;
+    }
+    expected = g_build_filename (directory, "expected", NULL);
+    actual = g_build_filename (directory, "actual", NULL);
+    timer = g_timer_new ();
+    reference_time = join_time = 0.0;
+
+    if (ok)
+    {
+      g_timer_start (timer);
+      ok = _write_reference (expected, kanjidic, radicals);
+      reference_time = g_timer_elapsed (timer, NULL);
+      if (!ok) fprintf (stderr, "Unable to write the reference Mix dictionary\n");
+    }
+
+    if (ok)
+    {
+      g_timer_start (timer);
+      ok = lw_io_create_mix_dictionary (actual, kanjidic, radicals, NULL, NULL, &error);
+      join_time = g_timer_elapsed (timer, NULL);
+      if (error != NULL) fprintf (stderr, "%s\n", error->message);
+    }
+
+    if (ok) ok = _compare (expected, actual, &length);
+
+    if (ok)
+      printf ("{ \"bytes\": %lu, \"reference_ms\": %.3f, \"hash_join_ms\": %.3f }\n",
+              (gulong) length, reference_time * 1000.0, join_time * 1000.0);
+
+    //Cleanup
+    g_remove (expected);
+    g_remove (actual);
+    if (g_str_has_prefix (kanjidic, directory)) g_remove (kanjidic);
+    if (g_str_has_prefix (radicals, directory)) g_remove (radicals);
+    g_rmdir (directory);
+    if (error != NULL) g_error_free (error);
+    g_timer_destroy (timer);
+    g_free (expected);
+    g_free (actual);
+    g_free (kanjidic);
+    g_free (radicals);
+    g_free (directory);
+
+    return (ok) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
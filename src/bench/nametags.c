@@ -0,0 +1,200 @@
+/******************************************************************************
+    AUTHOR:
+    File written and Copyrighted by Zachary Dovel. All Rights Reserved.
+
+    LICENSE:
+    This file is part of gWaei.
+
+    gWaei is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    gWaei is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with gWaei.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+//!
+//! @file nametags.c
+//!
+//! @brief Checks lw_io_parse_name_tags against the regexes that used to
+//!        split the Names and Places dictionaries.
+//!
+//! Each round builds an Enamdic-like line out of tags, near misses such as
+//! "ps" or "(s" and separators, in both cases.  A line has to go to the Names
+//! dictionary when the old name regex matches it and to the Places dictionary
+//! when the old place regex does.  The tag lists of the names-places-split
+//! preference are checked against the masks they replace too.
+//!
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <glib.h>
+
+#include <libwaei/libwaei.h>
+
+#include "bench.h"
+
+
+//The patterns of lw_io_split_places_from_names_dictionary before it was streamed
+static const gchar *_place_pattern = "([\\(,])((p)|(st))([\\),])";
+static const gchar *_name_pattern = "([\\(,])((s)|(u)|(g)|(f)|(m)|(h)|(pr)|(co))([\\),])";
+
+static const gchar *_pieces[] = {
+  "(", ")", ",", "/", " ", "s", "p", "u", "g", "f", "m", "h", "pr", "co", "st",
+  "S", "P", "St", "CO", "ps", "x", "prs", "田中", "[たなか]", "Tanaka"
+};
+
+#define LW_BENCH_NAMETAGS_MAX_PIECES 16
+
+
+//!
+//! @brief Runs one round and prints the line when the splits differ
+//! @returns TRUE if the line goes to the same dictionaries as with the regexes
+//!
+static gboolean
+_run_round (GRegex *re_name, GRegex *re_place, GRand *rand, gint round)
+{
+    //Declarations
+    GString *line;
+    guint32 tags;
+    gint total;
+    gint i;
+    gboolean expected_name;
+    gboolean expected_place;
+    gboolean name;
+    gboolean place;
+    gboolean same;
+
+    //Initializations
+    line = g_string_new (NULL);
+    total = g_rand_int_range (rand, 1, LW_BENCH_NAMETAGS_MAX_PIECES + 1);
+
+    for (i = 0; i < total; i++)
+      g_string_append (line, _pieces[g_rand_int_range (rand, 0, G_N_ELEMENTS (_pieces))]);
+    g_string_append_c (line, '\n');
+
+    expected_name = g_regex_match (re_name, line->str, 0, NULL);
+    expected_place = g_regex_match (re_place, line->str, 0, NULL);
+    tags = lw_io_parse_name_tags (line->str, line->len);
+    name = ((tags & LW_IO_NAME_TAGS_NAMES) != 0);
+    place = ((tags & LW_IO_NAME_TAGS_PLACES) != 0);
+
+    same = (name == expected_name && place == expected_place);
+    if (!same)
+    {
+      fprintf (stderr, "Round %d: names %d places %d were expected and names %d places %d were parsed in %s", round, expected_name, expected_place, name, place, line->str);
+    }
+
+    //Cleanup
+    g_string_free (line, TRUE);
+
+    return same;
+}
+
+
+//!
+//! @brief Checks that the default names-places-split preference gives the masks
+//!        the installer used before it could be configured
+//!
+static gboolean
+_check_preference ()
+{
+    //Declarations
+    const gchar *DEFAULT = "s,u,g,f,m,h,pr,co;p,st";
+    const guint32 expected[] = { LW_IO_NAME_TAGS_NAMES, LW_IO_NAME_TAGS_PLACES };
+    gchar **atoms;
+    guint32 tags;
+    gint i;
+    gboolean same;
+
+    //Initializations
+    atoms = g_strsplit (DEFAULT, ";", 2);
+    same = (g_strv_length (atoms) == 2);
+
+    for (i = 0; same && i < 2; i++)
+    {
+      tags = lw_io_get_name_tags_from_string (atoms[i]);
+      same = (tags == expected[i]);
+      if (!same) fprintf (stderr, "The tags \"%s\" give %#x instead of %#x\n", atoms[i], tags, expected[i]);
+    }
+
+    //Whitespace and unknown names are skipped
+    if (same)
+    {
+      tags = lw_io_get_name_tags_from_string (" s , x,p ,");
+      same = (tags == (LW_IO_NAME_TAG_SURNAME | LW_IO_NAME_TAG_PLACE));
+      if (!same) fprintf (stderr, "The tags \" s , x,p ,\" give %#x\n", tags);
+    }
+
+    //Cleanup
+    g_strfreev (atoms);
+
+    return same;
+}
+
+
+int
+main (int argc, char *argv[])
+{
+    //Declarations
+    GOptionContext *context;
+    GError *error;
+    GRegex *re_name;
+    GRegex *re_place;
+    GRand *rand;
+    gint rounds;
+    gint seed;
+    gint i;
+    gboolean ok;
+
+    //Initializations
+    error = NULL;
+    rounds = 200000;
+    seed = 1;
+
+    GOptionEntry entries[] = {
+      { "rounds", 'n', 0, G_OPTION_ARG_INT, &rounds, "Random lines to check", "N" },
+      { "seed", 0, 0, G_OPTION_ARG_INT, &seed, "Random seed so runs can be reproduced", "N" },
+      { NULL }
+    };
+
+    context = g_option_context_new (NULL);
+    g_option_context_set_summary (context, "Checks lw_io_parse_name_tags against the regexes it replaced.");
+    g_option_context_add_main_entries (context, entries, NULL);
+    g_option_context_parse (context, &argc, &argv, &error);
+    g_option_context_free (context);
+
+    if (error != NULL)
+    {
+      fprintf (stderr, "%s\n", error->message);
+      g_error_free (error);
+      return EXIT_FAILURE;
+    }
+
+    re_name = g_regex_new (_name_pattern, LW_RE_COMPILE_FLAGS, LW_RE_LOCATE_FLAGS, NULL);
+    re_place = g_regex_new (_place_pattern, LW_RE_COMPILE_FLAGS, LW_RE_LOCATE_FLAGS, NULL);
+    rand = g_rand_new_with_seed ((guint32) seed);
+
+    ok = _check_preference ();
+
+    for (i = 0; i < rounds && ok; i++)
+      ok = _run_round (re_name, re_place, rand, i);
+
+    if (ok) printf ("{ \"rounds\": %d }\n", rounds);
+
+    //Cleanup
+    g_rand_free (rand);
+    g_regex_unref (re_name);
+    g_regex_unref (re_place);
+
+    return (ok) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,661 @@
+/******************************************************************************
+    AUTHOR:
+    File written and Copyrighted by Zachary Dovel. All Rights Reserved.
+
+    LICENSE:
+    This file is part of gWaei.
+
+    gWaei is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    gWaei is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with gWaei.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+//!
+//! @file scoring.c
+//!
+//! @brief Checks the jstroke scorer of libwaei against the scoring it replaced
+//!
+//! Random strokes are scored against every distinct stroke path of the
+//! stroke database and against random paths of up to diPathBufLen
+//! directions.  Each one is scored through the StrokeCache of a StrokeScorer
+//! and with the plain recursion jstroke had before the cache, and the scores
+//! have to be the same.  Paths of five or more directions go through the
+//! sub-path memo of the cache, and the few in the database are short, so the
+//! random paths are what exercise it.
+//!
+//! Random drawings of every stroke count are then recognized with
+//! lw_strokedb_recognize, which scores the decoded tables across threads, and
+//! with StrokeScorerProcess over the letter coded characters of jdata.dat
+//! one after the other.  Both have to give the same candidates in the same
+//! order with the same scores.  No stroke count of jdata.dat has enough
+//! characters to be split between threads, so the check loads a copy with
+//! the characters of each stroke count repeated.  The repeats also tie with
+//! each other across the slices, and the earlier one has to win like it does
+//! in the jstroke list.
+//!
+//! Last, random drawings are fed to an LwStrokeDBSession one stroke at a
+//! time.  After each stroke the characters with as many strokes as were
+//! drawn have to come in the order and with the scores lw_strokedb_recognize
+//! gives them.  Each character with more strokes has to be scored on the
+//! strokes drawn so far like the old recursion scores them.
+//!
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include <libwaei/libwaei.h>
+
+#include "jstroke/jstroke.h"
+
+#include "bench.h"
+
+
+#define LW_BENCH_SCORING_HUGE_COST ((24UL * 98 + 52) * 100)   //!< diHugeCost of scoring.c
+#define LW_BENCH_SCORING_MAX_POINTS 160
+#define LW_BENCH_SCORING_RANDOM_PATHS 64
+#define LW_BENCH_SCORING_CANDIDATES 20
+#define LW_BENCH_SCORING_COPIES 4   //!< Makes the largest stroke counts big enough for LW_STROKEDB_MAX_THREADS slices
+
+
+//!
+//! @brief StrokeDicScoreStroke as it was before the StrokeCache.  Every call
+//!        works its angles out again and nothing is remembered between paths.
+//!
+static gulong
+_reference_score_stroke (const guchar *x, const guchar *y, guint length, const gchar *path, guint path_length, guint depth)
+{
+    //Declarations
+    gulong score;
+    gulong this_score;
+    glong mid;
+    glong step;
+    glong path_mid;
+    glong path_rest;
+    glong dx;
+    glong dy;
+    guint angle;
+    guint direction;
+    guint difference;
+
+    if (length < 2 || path_length < 1) return LW_BENCH_SCORING_HUGE_COST;
+
+    if (path_length == 1)
+    {
+      dx = x[length - 1] - x[0];
+      dy = y[0] - y[length - 1];
+      if (dx == 0 && dy == 0) return LW_BENCH_SCORING_HUGE_COST;
+
+      //Long strokes are cut in half a few times, using the middle point on both sides
+      if ((dx * dx + dy * dy) > (20 * 20) && length > 5 && depth < 4)
+      {
+        mid = length >> 1;
+        score = _reference_score_stroke (x, y, mid + 1, path, path_length, depth + 1);
+        score += _reference_score_stroke (x + mid, y + mid, length - mid, path, path_length, depth + 1);
+        return (score >> 1);
+      }
+
+      angle = Angle32 (dx, dy);
+      direction = *path;
+      difference = (angle >= direction) ? angle - direction : direction - angle;
+
+      return difference * 98 + 52;
+    }
+
+    //Try the mid-points splitting the path in two halves
+    score = LW_BENCH_SCORING_HUGE_COST * path_length * 2;
+    path_mid = path_length >> 1;
+    path_rest = path_length - path_mid;
+    step = (length < 20) ? 1 : length / 10;
+
+    for (mid = path_mid; mid < length - path_rest; mid += step)
+    {
+      this_score = _reference_score_stroke (x, y, mid + 1, path, path_mid, depth + 1);
+      this_score += _reference_score_stroke (x + mid, y + mid, length - mid, path + path_mid, path_rest, depth + 1);
+      this_score >>= 1;
+
+      if (this_score < score) score = this_score;
+    }
+
+    return score;
+}
+
+
+//!
+//! @brief Converts a Shift-JIS character of jdata.dat to a JIS row and cell
+//!        like lw_strokedb_new does
+//!
+static void
+_sjis_to_jis (const gchar *SJIS, guchar *jis)
+{
+    //Declarations
+    guchar c1;
+    guchar c2;
+    gint adjust;
+
+    //Initializations
+    c1 = SJIS[0];
+    c2 = SJIS[1];
+    adjust = (c2 < 159);
+
+    jis[0] = ((c1 - ((c1 < 160) ? 112 : 176)) << 1) - adjust;
+    jis[1] = c2 - ((adjust) ? ((c2 > 127) ? 32 : 31) : 126);
+}
+
+
+//!
+//! @brief Finds the letter coded characters of each stroke count in the contents of jdata.dat
+//!
+static void
+_get_blocks (gchar *contents, gsize length, gchar **blocks)
+{
+    //Declarations
+    gchar *ptr;
+    gchar *end;
+    guint32 header[2];
+    guint32 strokes;
+    guint32 size;
+
+    //Initializations
+    ptr = contents;
+    end = contents + length;
+    memset (blocks, 0, sizeof(gchar*) * (LW_STROKEDB_MAX_STROKES + 1));
+
+    //Each block is a big endian stroke count and length followed by the characters
+    while (ptr + sizeof(header) <= end)
+    {
+      memcpy (header, ptr, sizeof(header));
+      strokes = GUINT32_FROM_BE (header[0]);
+      size = GUINT32_FROM_BE (header[1]);
+      ptr += sizeof(header);
+      if (strokes == 0 || strokes > LW_STROKEDB_MAX_STROKES || size > end - ptr) break;
+
+      blocks[strokes] = ptr;
+      ptr += size;
+    }
+}
+
+
+//!
+//! @brief Repeats the characters of each stroke count of jdata.dat
+//! @returns The contents of the larger database in the same format
+//!
+static GString*
+_repeat_characters (const gchar *CONTENTS, gsize length, gint copies)
+{
+    //Declarations
+    GString *repeated;
+    const gchar *ptr;
+    const gchar *end;
+    guint32 header[2];
+    guint32 strokes;
+    guint32 size;
+    gint i;
+
+    //Initializations
+    repeated = g_string_new (NULL);
+    ptr = CONTENTS;
+    end = CONTENTS + length;
+
+    while (ptr + sizeof(header) <= end)
+    {
+      memcpy (header, ptr, sizeof(header));
+      strokes = GUINT32_FROM_BE (header[0]);
+      size = GUINT32_FROM_BE (header[1]);
+      ptr += sizeof(header);
+      if (strokes == 0 || size == 0 || size > end - ptr) break;
+
+      //The characters end with a single null byte
+      header[1] = GUINT32_TO_BE ((size - 1) * copies + 1);
+      g_string_append_len (repeated, (gchar*) header, sizeof(header));
+      for (i = 0; i < copies; i++) g_string_append_len (repeated, ptr, size - 1);
+      g_string_append_c (repeated, '\0');
+      ptr += size;
+    }
+
+    header[0] = header[1] = 0;
+    g_string_append_len (repeated, (gchar*) header, sizeof(header));
+
+    return repeated;
+}
+
+
+//!
+//! @brief Draws a random stroke of a few straight runs with some jitter.  Some
+//!        are a single point or have repeated points.
+//!
+static void
+_new_random_stroke (GRand *rand, RawStroke *raw)
+{
+    //Declarations
+    gint x;
+    gint y;
+    gint dx;
+    gint dy;
+    guint i;
+
+    //Initializations
+    raw->m_len = g_rand_int_range (rand, 1, LW_BENCH_SCORING_MAX_POINTS + 1);
+    x = g_rand_int_range (rand, 0, 256);
+    y = g_rand_int_range (rand, 0, 256);
+    dx = dy = 0;
+
+    for (i = 0; i < raw->m_len; i++)
+    {
+      if (i % 12 == 0 && g_rand_boolean (rand))
+      {
+        dx = g_rand_int_range (rand, -6, 7);
+        dy = g_rand_int_range (rand, -6, 7);
+      }
+      x = CLAMP (x + dx + g_rand_int_range (rand, -1, 2), 0, 255);
+      y = CLAMP (y + dy + g_rand_int_range (rand, -1, 2), 0, 255);
+      raw->m_x[i] = x;
+      raw->m_y[i] = y;
+    }
+}
+
+
+//!
+//! @brief Gathers every distinct stroke path of the database and adds some
+//!        random ones.  The direction codes are shifted up by 'A' so the
+//!        paths can be kept as strings.
+//!
+static GPtrArray*
+_get_paths (LwStrokeDB *db, GRand *rand)
+{
+    //Declarations
+    GHashTable *seen;
+    GPtrArray *paths;
+    LwStrokeDBTable *table;
+    gchar key[diPathBufLen + 1];
+    gchar *copy;
+    guint start;
+    guint end;
+    guint i;
+    guint j;
+    gint strokes;
+    gint length;
+
+    //Initializations
+    seen = g_hash_table_new (g_str_hash, g_str_equal);
+    paths = g_ptr_array_new_with_free_func (g_free);
+
+    for (strokes = 1; strokes <= LW_STROKEDB_MAX_STROKES; strokes++)
+    {
+      table = &db->tables[strokes];
+      for (i = 0; i < (guint) (table->total * table->strokes); i++)
+      {
+        start = table->path_offsets[i];
+        end = table->path_offsets[i + 1];
+        if (end == start || end - start > diPathBufLen) continue;
+
+        for (j = start; j < end; j++) key[j - start] = table->paths[j] + 'A';
+        key[end - start] = '\0';
+        if (g_hash_table_lookup (seen, key) != NULL) continue;
+
+        copy = g_strdup (key);
+        g_ptr_array_add (paths, copy);
+        g_hash_table_insert (seen, copy, copy);
+      }
+    }
+
+    //The directions are in 32nds of a circle and the database only uses every fourth one
+    for (i = 0; i < LW_BENCH_SCORING_RANDOM_PATHS; i++)
+    {
+      length = g_rand_int_range (rand, 1, diPathBufLen + 1);
+      for (j = 0; j < length; j++) key[j] = g_rand_int_range (rand, 0, 8) * 4 + 'A';
+      key[length] = '\0';
+      g_ptr_array_add (paths, g_strdup (key));
+    }
+
+    //Cleanup
+    g_hash_table_destroy (seen);
+
+    return paths;
+}
+
+
+//!
+//! @brief Scores one random stroke against every path, each one twice so the
+//!        second score comes from the path cache
+//! @returns TRUE if the cached scores are the ones of the old recursion
+//!
+static gboolean
+_check_paths (GRand *rand, GPtrArray *paths, gint round)
+{
+    //Declarations
+    StrokeScorer *scorer;
+    RawStroke raw;
+    gchar path[diPathBufLen];
+    const gchar *key;
+    gulong expected;
+    gulong actual;
+    gulong again;
+    guint length;
+    guint i;
+    guint j;
+    gboolean same;
+
+    //Initializations
+    _new_random_stroke (rand, &raw);
+    scorer = StrokeScorerCreate (NULL, &raw, 1);
+    if (scorer == NULL) return FALSE;
+    same = TRUE;
+
+    for (i = 0; same && i < paths->len; i++)
+    {
+      key = g_ptr_array_index (paths, i);
+      length = strlen (key);
+      for (j = 0; j < length; j++) path[j] = key[j] - 'A';
+
+      expected = _reference_score_stroke (raw.m_x, raw.m_y, raw.m_len, path, length, 0);
+      actual = StrokeScorerScoreStroke (scorer, 0, path, length);
+      again = StrokeScorerScoreStroke (scorer, 0, path, length);
+      same = (expected == actual && expected == again);
+
+      if (!same)
+        fprintf (stderr, "Round %d: a %u point stroke scored %lu against path %u of %u directions, then %lu from the cache, and the old recursion gives %lu\n",
+                 round, raw.m_len, actual, i, length, again, expected);
+    }
+
+    //Cleanup
+    StrokeScorerDestroy (scorer);
+
+    return same;
+}
+
+
+//!
+//! @brief Recognizes a random drawing of each stroke count with lw_strokedb_recognize
+//!        and with StrokeScorerProcess
+//! @returns TRUE if both gave the same candidates
+//!
+static gboolean
+_check_recognize (LwStrokeDB *db, gchar **blocks, GRand *rand, gint round)
+{
+    //Declarations
+    StrokeScorer *scorer;
+    RawStroke raw[LW_STROKEDB_MAX_STROKES];
+    LwStroke strokes[LW_STROKEDB_MAX_STROKES];
+    LwStrokeDBCandidate candidates[diMaxListCount];
+    ScoreItem *expected;
+    guchar jis[2];
+    gint total;
+    gint count;
+    gint i;
+    gboolean same;
+
+    //Initializations
+    same = TRUE;
+
+    for (total = 1; same && total <= LW_STROKEDB_MAX_STROKES; total++)
+    {
+      if (blocks[total] == NULL) continue;
+
+      for (i = 0; i < total; i++)
+      {
+        _new_random_stroke (rand, &raw[i]);
+        strokes[i].length = raw[i].m_len;
+        memcpy (strokes[i].x, raw[i].m_x, raw[i].m_len);
+        memcpy (strokes[i].y, raw[i].m_y, raw[i].m_len);
+      }
+
+      scorer = StrokeScorerCreate (blocks[total], raw, total);
+      if (scorer == NULL) return FALSE;
+      StrokeScorerProcess (scorer, -1);
+      count = lw_strokedb_recognize (db, strokes, total, candidates, diMaxListCount);
+
+      for (i = 0; i < count && i < (gint) scorer->m_iScoreLen; i++)
+      {
+        expected = &scorer->m_pScores[i];
+        _sjis_to_jis (expected->m_cp, jis);
+        if (candidates[i].jis[0] != jis[0] || candidates[i].jis[1] != jis[1] || candidates[i].score != expected->m_iScore) break;
+      }
+      same = (i == count && count == (gint) scorer->m_iScoreLen);
+
+      if (!same)
+        fprintf (stderr, "Round %d: %d strokes gave %d candidates and StrokeScorerProcess gave %u, the first %d agree\n",
+                 round, total, count, scorer->m_iScoreLen, i);
+
+      StrokeScorerDestroy (scorer);
+    }
+
+    return same;
+}
+
+
+//!
+//! @brief Scores the first strokes of a character with the old recursion.  A
+//!        character can be in a table more than once with different strokes,
+//!        so any of them can have the score.
+//! @returns TRUE if an entry of the character has the score of the candidate
+//!
+static gboolean
+_has_prefix_score (LwStrokeDB *db, const LwStrokeDBCandidate *CANDIDATE, RawStroke *raw, gint drawn)
+{
+    //Declarations
+    LwStrokeDBTable *table;
+    gulong sum;
+    guint offset;
+    guint length;
+    gint i;
+    gint j;
+
+    //Initializations
+    table = &db->tables[CANDIDATE->strokes];
+
+    for (i = 0; i < table->total; i++)
+    {
+      if (table->jis[i * 2] != CANDIDATE->jis[0] || table->jis[i * 2 + 1] != CANDIDATE->jis[1]) continue;
+
+      //A description that ran out of strokes adds nothing for the rest
+      for (sum = 0, j = 0; j < drawn; j++)
+      {
+        offset = table->path_offsets[i * table->strokes + j];
+        length = table->path_offsets[i * table->strokes + j + 1] - offset;
+        if (length == 0) continue;
+
+        sum = StrokeScoreAddSquare (sum, _reference_score_stroke (raw[j].m_x, raw[j].m_y, raw[j].m_len, table->paths + offset, length, 0));
+      }
+
+      if (SqrtULong (sum) == CANDIDATE->score) return TRUE;
+    }
+
+    return FALSE;
+}
+
+
+//!
+//! @brief Draws a random character into a session one stroke at a time and
+//!        checks the candidates after each stroke
+//! @returns TRUE if every candidate had the score it should
+//!
+static gboolean
+_check_session (LwStrokeDB *db, LwStrokeDBSession *session, GRand *rand, gint round)
+{
+    //Declarations
+    RawStroke raw[LW_STROKEDB_MAX_STROKES];
+    LwStroke strokes[LW_STROKEDB_MAX_STROKES];
+    LwStrokeDBCandidate candidates[LW_BENCH_SCORING_CANDIDATES];
+    LwStrokeDBCandidate expected[LW_BENCH_SCORING_CANDIDATES];
+    LwStrokeDBCandidate *candidate;
+    gint total;
+    gint drawn;
+    gint count;
+    gint exact_total;
+    gint exact;
+    gint i;
+    gboolean same;
+
+    //Initializations
+    total = g_rand_int_range (rand, 1, LW_STROKEDB_MAX_STROKES + 1);
+    same = TRUE;
+
+    lw_strokedb_session_clear (session);
+
+    for (drawn = 1; same && drawn <= total; drawn++)
+    {
+      _new_random_stroke (rand, &raw[drawn - 1]);
+      strokes[drawn - 1].length = raw[drawn - 1].m_len;
+      memcpy (strokes[drawn - 1].x, raw[drawn - 1].m_x, raw[drawn - 1].m_len);
+      memcpy (strokes[drawn - 1].y, raw[drawn - 1].m_y, raw[drawn - 1].m_len);
+
+      lw_strokedb_session_add_stroke (session, &strokes[drawn - 1]);
+      count = lw_strokedb_session_get_candidates (session, candidates, LW_BENCH_SCORING_CANDIDATES);
+      exact_total = lw_strokedb_recognize (db, strokes, drawn, expected, LW_BENCH_SCORING_CANDIDATES);
+      exact = 0;
+
+      //The exact matches are a prefix of what lw_strokedb_recognize gives
+      for (i = 0; same && i < count; i++)
+      {
+        candidate = &candidates[i];
+        if (i > 0 && candidate->score < candidates[i - 1].score)
+          same = FALSE;
+        else if (candidate->strokes == drawn)
+        {
+          same = (exact < exact_total && memcmp (candidate->jis, expected[exact].jis, 2) == 0 && candidate->score == expected[exact].score);
+          exact++;
+        }
+        else
+          same = (candidate->strokes > drawn && _has_prefix_score (db, candidate, raw, drawn));
+      }
+
+      if (!same)
+        fprintf (stderr, "Round %d: after %d strokes, candidate %d of %d strokes with the score %lu is out of place\n",
+                 round, drawn, i, candidate->strokes, candidate->score);
+    }
+
+    return same;
+}
+
+
+int
+main (int argc, char *argv[])
+{
+    //Declarations
+    GOptionContext *context;
+    GError *error;
+    GRand *rand;
+    GPtrArray *paths;
+    LwStrokeDB *db;
+    LwStrokeDBSession *session;
+    GString *repeated;
+    gchar *blocks[LW_STROKEDB_MAX_STROKES + 1];
+    gchar *contents;
+    gchar *directory;
+    gchar *path;
+    gchar *jdata;
+    gsize length;
+    gint rounds;
+    gint seed;
+    gint i;
+    gboolean ok;
+
+    //Initializations
+    error = NULL;
+    jdata = NULL;
+    rounds = 40;
+    seed = 1;
+    ok = TRUE;
+
+    GOptionEntry entries[] = {
+      { "jdata", 'j', 0, G_OPTION_ARG_FILENAME, &jdata, "The stroke database, jdata.dat", "FILE" },
+      { "rounds", 'n', 0, G_OPTION_ARG_INT, &rounds, "Random strokes to score, drawings of each stroke count to recognize and drawings to recognize stroke by stroke", "N" },
+      { "seed", 0, 0, G_OPTION_ARG_INT, &seed, "Random seed so runs can be reproduced", "N" },
+      { NULL }
+    };
+
+    g_thread_init (NULL);
+
+    context = g_option_context_new (NULL);
+    g_option_context_set_summary (context, "Checks the jstroke scorer against the scoring it replaced.");
+    g_option_context_add_main_entries (context, entries, NULL);
+    g_option_context_parse (context, &argc, &argv, &error);
+    g_option_context_free (context);
+
+    if (error != NULL)
+    {
+      fprintf (stderr, "%s\n", error->message);
+      g_error_free (error);
+      return EXIT_FAILURE;
+    }
+
+    if (jdata == NULL) jdata = lw_strokedb_get_default_path ();
+    if (!g_file_get_contents (jdata, &contents, &length, &error))
+    {
+      fprintf (stderr, "%s\n", error->message);
+      g_error_free (error);
+      g_free (jdata);
+      return EXIT_FAILURE;
+    }
+
+    directory = g_dir_make_tmp ("lwbench-scoring-XXXXXX", &error);
+    if (directory == NULL)
+    {
+      fprintf (stderr, "%s\n", error->message);
+      g_error_free (error);
+      g_free (contents);
+      g_free (jdata);
+      return EXIT_FAILURE;
+    }
+
+    //The copy is only read while it is loaded
+    repeated = _repeat_characters (contents, length, LW_BENCH_SCORING_COPIES);
+    g_free (contents);
+    path = g_build_filename (directory, "jdata.dat", NULL);
+    db = NULL;
+    if (g_file_set_contents (path, repeated->str, repeated->len, &error))
+      db = lw_strokedb_new (path, &error);
+    g_remove (path);
+    g_rmdir (directory);
+    g_free (path);
+    g_free (directory);
+
+    if (db == NULL)
+    {
+      fprintf (stderr, "%s\n", (error != NULL) ? error->message : "Unable to load the stroke database");
+      if (error != NULL) g_error_free (error);
+      g_string_free (repeated, TRUE);
+      g_free (jdata);
+      return EXIT_FAILURE;
+    }
+
+    rand = g_rand_new_with_seed ((guint32) seed);
+    paths = _get_paths (db, rand);
+    _get_blocks (repeated->str, repeated->len, blocks);
+
+    for (i = 0; ok && i < rounds; i++)
+      ok = _check_paths (rand, paths, i);
+
+    for (i = 0; ok && i < rounds; i++)
+      ok = _check_recognize (db, blocks, rand, i);
+
+    session = lw_strokedb_session_new (db);
+    for (i = 0; ok && i < rounds; i++)
+      ok = _check_session (db, session, rand, i);
+
+    if (ok) printf ("{ \"paths\": %u, \"rounds\": %d }\n", paths->len, rounds);
+
+    //Cleanup
+    g_ptr_array_free (paths, TRUE);
+    g_rand_free (rand);
+    lw_strokedb_session_free (session);
+    g_string_free (repeated, TRUE);
+    lw_strokedb_free (db);
+    g_free (jdata);
+
+    return (ok) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
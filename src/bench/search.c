@@ -0,0 +1,323 @@
+/******************************************************************************
+    AUTHOR:
+    File written and Copyrighted by Zachary Dovel. All Rights Reserved.
+
+    LICENSE:
+    This file is part of gWaei.
+
+    gWaei is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    gWaei is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    
+    You should have received a copy of the GNU General Public License
+    along with gWaei.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+//!
+//! @file search.c
+//!
+//! @brief Times lw_searchitem_start_search on a set of representative query
+//!        classes against the dictionaries written by lwbench-generate and
+//!        prints the measurements as JSON.
+//!
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <locale.h>
+
+#include <glib.h>
+#ifdef G_OS_UNIX
+#include <sys/resource.h>
+#endif
+
+#include <libwaei/libwaei.h>
+
+#include "bench.h"
+
+
+struct _LwBenchQuery {
+  const char *name;
+  LwDictType type;
+  const char *filename;
+  const char *query;
+};
+typedef struct _LwBenchQuery LwBenchQuery;
+
+static const LwBenchQuery _queries[] = {
+  { "exact_kanji",     LW_DICTTYPE_EDICT,    "English",  "日本" },
+  { "kana_conversion", LW_DICTTYPE_EDICT,    "English",  "こーひー" },
+  { "romaji_to_kana",  LW_DICTTYPE_EDICT,    "English",  "mizu" },
+  { "english_word",    LW_DICTTYPE_EDICT,    "English",  "water" },
+  { "multi_atom",      LW_DICTTYPE_EDICT,    "English",  "水&drink" },
+  { "regex_wildcard",  LW_DICTTYPE_EDICT,    "English",  "飲.*水" },
+  { "kanji_filters",   LW_DICTTYPE_KANJI,    "Kanji",    "S4 G1" },
+  { "names_kana",      LW_DICTTYPE_EDICT,    "Names",    "あべ" },
+  { "examples_kanji",  LW_DICTTYPE_EXAMPLES, "Examples", "日本語" },
+  { NULL }
+};
+
+struct _LwBenchSample {
+  double first;   //!< Seconds until the first result could be read or -1.0
+  double total;   //!< Seconds until the search finished
+  int results;
+};
+typedef struct _LwBenchSample LwBenchSample;
+
+
+//!
+//! @brief Gets the peak resident set size of the process in kilobytes or -1 if unknown
+//!
+static long 
+_get_peak_rss (void)
+{
+#ifdef G_OS_UNIX
+    struct rusage usage;
+
+    if (getrusage (RUSAGE_SELF, &usage) == 0)
+      return usage.ru_maxrss;
+#endif
+    return -1;
+}
+
+
+//!
+//! @brief Counts the lines of a dictionary file so throughput can be given in lines/sec
+//!
+static long 
+_count_lines (LwDictInfo *di)
+{
+    //Declarations
+    gchar *uri;
+    FILE *file;
+    char buffer[LW_IO_MAX_FGETS_LINE];
+    long lines;
+
+    //Initializations
+    uri = lw_dictinfo_get_uri (di);
+    file = fopen (uri, "r");
+    lines = 0;
+
+    if (file != NULL)
+    {
+      while (fgets (buffer, LW_IO_MAX_FGETS_LINE, file) != NULL)
+        if (strchr (buffer, '\n') != NULL) lines++;
+      fclose (file);
+    }
+
+    g_free (uri);
+
+    return lines;
+}
+
+
+//!
+//! @brief Runs one search, reading the results out as they become available
+//!
+static gboolean 
+_run_sample (LwBenchSample *sample, LwDictInfo *di, LwPreferences *pm, const char *QUERY, gboolean threaded)
+{
+    //Declarations
+    LwSearchItem *item;
+    LwResultLine *resultline;
+    GTimer *timer;
+    GError *error;
+
+    //Initializations
+    error = NULL;
+    sample->first = -1.0;
+    sample->total = 0.0;
+    sample->results = 0;
+    timer = g_timer_new ();
+    item = lw_searchitem_new (QUERY, di, pm, &error);
+
+    if (item == NULL)
+    {
+      if (error != NULL)
+      {
+        fprintf (stderr, "%s\n", error->message);
+        g_error_free (error);
+      }
+      g_timer_destroy (timer);
+      return FALSE;
+    }
+
+    g_timer_start (timer);
+    lw_searchitem_start_search (item, threaded, FALSE);
+
+    while (lw_searchitem_should_check_results (item))
+    {
+      while ((resultline = lw_searchitem_get_result (item)) != NULL)
+      {
+        if (sample->first < 0.0) sample->first = g_timer_elapsed (timer, NULL);
+        sample->results++;
+        lw_resultline_free (resultline);
+      }
+      if (threaded) g_usleep (LW_BENCH_POLL_INTERVAL);
+    }
+
+    sample->total = g_timer_elapsed (timer, NULL);
+
+    //Make sure the search thread let go of the item
+    if (threaded)
+    {
+      lw_searchitem_lock_mutex (item);
+      lw_searchitem_unlock_mutex (item);
+    }
+
+    //Cleanup
+    lw_searchitem_free (item);
+    g_timer_destroy (timer);
+
+    return TRUE;
+}
+
+
+static void 
+_print_query (GString *json, const LwBenchQuery *query, LwDictInfo *di, LwPreferences *pm, int iterations, gboolean threaded)
+{
+    //Declarations
+    LwBenchSample sample;
+    double first, total, best;
+    long lines;
+    int results;
+    int runs;
+    int i;
+
+    //Initializations
+    lines = _count_lines (di);
+    first = total = 0.0;
+    best = -1.0;
+    results = 0;
+    runs = 0;
+
+    for (i = 0; i < iterations; i++)
+    {
+      if (!_run_sample (&sample, di, pm, query->query, threaded)) break;
+      if (sample.first >= 0.0) first += sample.first;
+      total += sample.total;
+      if (best < 0.0 || sample.total < best) best = sample.total;
+      results = sample.results;
+      runs++;
+    }
+    if (runs == 0) return;
+
+    first /= runs;
+    total /= runs;
+
+    if (json->len > 0) g_string_append (json, ",\n");
+    g_string_append_printf (json, "    {\"class\": \"%s\", \"dictionary\": \"%s/%s\", \"query\": \"%s\", \"threaded\": %s, "
+                                  "\"iterations\": %d, \"results\": %d, \"lines\": %ld, "
+                                  "\"time_to_first_result_ms\": %.3f, \"total_ms\": %.3f, \"best_total_ms\": %.3f, "
+                                  "\"lines_per_sec\": %.0f, \"peak_rss_kb\": %ld}",
+                            query->name, lw_util_dicttype_to_string (query->type), query->filename, query->query,
+                            (threaded) ? "true" : "false", runs, results, lines,
+                            first * 1000.0, total * 1000.0, best * 1000.0,
+                            (total > 0.0) ? (double) lines / total : 0.0, _get_peak_rss ());
+}
+
+
+int 
+main (int argc, char *argv[])
+{
+    //Declarations
+    GOptionContext *context;
+    GError *error;
+    LwPreferences *pm;
+    LwDictInfo *di;
+    GString *json;
+    const LwBenchQuery *query;
+    gchar *directory;
+    gchar *filter;
+    gint iterations;
+    gboolean threaded_only;
+    gboolean unthreaded_only;
+    int mode;
+
+    //Initializations
+    error = NULL;
+    directory = NULL;
+    filter = NULL;
+    iterations = 5;
+    threaded_only = FALSE;
+    unthreaded_only = FALSE;
+
+    GOptionEntry entries[] = {
+      { "data", 'd', 0, G_OPTION_ARG_FILENAME, &directory, "Folder that was given to lwbench-generate", "DIR" },
+      { "iterations", 'n', 0, G_OPTION_ARG_INT, &iterations, "Times each query is run", "N" },
+      { "class", 'c', 0, G_OPTION_ARG_STRING, &filter, "Only run the named query class", "NAME" },
+      { "threaded", 0, 0, G_OPTION_ARG_NONE, &threaded_only, "Only run threaded searches", NULL },
+      { "unthreaded", 0, 0, G_OPTION_ARG_NONE, &unthreaded_only, "Only run searches in the calling thread", NULL },
+      { NULL }
+    };
+
+    setlocale (LC_ALL, "");
+    g_type_init ();
+    g_thread_init (NULL);
+
+    context = g_option_context_new (NULL);
+    g_option_context_set_summary (context, "Times the libwaei search engine and prints the results as JSON.");
+    g_option_context_set_description (context, "The gwaei GSettings schema has to be installed or be pointed to with GSETTINGS_SCHEMA_DIR.");
+    g_option_context_add_main_entries (context, entries, NULL);
+    g_option_context_parse (context, &argc, &argv, &error);
+    g_option_context_free (context);
+
+    if (error != NULL)
+    {
+      fprintf (stderr, "%s\n", error->message);
+      g_error_free (error);
+      return EXIT_FAILURE;
+    }
+    if (directory == NULL || iterations < 1)
+    {
+      fprintf (stderr, "A data folder written by lwbench-generate is required.\n");
+      return EXIT_FAILURE;
+    }
+
+    //The dictionary paths are built from the user config dir
+    g_setenv ("XDG_CONFIG_HOME", directory, TRUE);
+
+    lw_regex_initialize ();
+    pm = lw_preferences_new (g_memory_settings_backend_new ());
+    json = g_string_new (NULL);
+
+    for (query = _queries; query->name != NULL; query++)
+    {
+      if (filter != NULL && strcmp (filter, query->name) != 0) continue;
+
+      di = lw_dictinfo_new (query->type, query->filename);
+      if (di->length <= 0)
+      {
+        fprintf (stderr, "Skipping %s, %s/%s was not found\n", query->name, lw_util_dicttype_to_string (query->type), query->filename);
+        lw_dictinfo_free (di);
+        continue;
+      }
+
+      for (mode = 0; mode < 2; mode++)
+      {
+        if (mode == 0 && threaded_only) continue;
+        if (mode == 1 && unthreaded_only) continue;
+        _print_query (json, query, di, pm, iterations, (mode == 1));
+      }
+
+      lw_dictinfo_free (di);
+    }
+
+    printf ("{\n  \"iterations\": %d,\n  \"queries\": [\n%s\n  ]\n}\n", iterations, json->str);
+
+    //Cleanup
+    g_string_free (json, TRUE);
+    lw_preferences_free (pm);
+    lw_regex_free ();
+    g_free (directory);
+    g_free (filter);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,539 @@
+/******************************************************************************
+    AUTHOR:
+    File written and Copyrighted by Zachary Dovel. All Rights Reserved.
+
+    LICENSE:
+    This file is part of gWaei.
+
+    gWaei is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    gWaei is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with gWaei.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+//!
+//! @file spans.c
+//!
+//! @brief Checks the match spans the low relevance comparison records against
+//!        the LOCATE regexes the output used to highlight with.
+//!
+//! Each round parses a random kanji, kana or romaji query and runs the low
+//! relevance comparison of an LwSearchItem over a random EDICT line.  The
+//! words are drawn from small pools so atoms match many times in a field.
+//! The old highlighting pass ran the LOCATE regex of each atom over the text
+//! of a field and marked every match.  The check does the same over the
+//! fields the comparison reaches, in its order, and the spans recorded in
+//! the result line have to be the same ones with the same byte offsets from
+//! the start of their field.  The romaji words never overlap themselves so
+//! the literal atoms found with LwAhoCorasick give the spans the regexes do.
+//!
+//! Every few rounds the fields are long enough for more spans than
+//! LW_RESULTLINE_MAX_MATCHES.  Then the result line has to be full and only
+//! hold spans the LOCATE pass found.  Spans past the offsets a guint16 holds
+//! are checked to be refused by lw_resultline_add_match.
+//!
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <glib.h>
+
+#include <libwaei/libwaei.h>
+
+#include "bench.h"
+
+
+static const char *_kanji[] = { "日", "本", "語", "学", "生", "先", "ねこ" };
+static const char *_kana[] = { "ねこ", "いぬ", "さかな", "ネコ", "イヌ" };
+static const char *_words[] = { "cat", "dog", "fish", "bird", "wolf", "lynx", "quiz", "Cat", "DOG" };
+static const char *_patterns[] = { "c.t", "fi[s]h", "(bird|wolf)", "d?og", "ly.x", "qu+iz" };
+
+#define LW_BENCH_SPANS_KANJI 6    //!< The pure kanji of _kanji that queries are made of
+#define LW_BENCH_SPANS_LITERALS 7 //!< The lower case words of _words that queries are made of
+#define LW_BENCH_SPANS_MAX_ATOMS 2
+#define LW_BENCH_SPANS_MAX_WORDS 4
+#define LW_BENCH_SPANS_MAX_DEFINITIONS 3
+#define LW_BENCH_SPANS_LONG_INTERVAL 16 //!< Every this many rounds the fields have more spans than a result line holds
+
+typedef enum {
+  LW_BENCH_SPANS_QUERY_KANJI,
+  LW_BENCH_SPANS_QUERY_KANA,
+  LW_BENCH_SPANS_QUERY_ROMAJI,
+  TOTAL_LW_BENCH_SPANS_QUERIES
+} LwBenchSpansQuery;
+
+
+struct _LwBenchSpan {
+  gsize start;   //!< Byte offset from the start of the result line string
+  gsize end;
+};
+typedef struct _LwBenchSpan LwBenchSpan;
+
+
+static gint
+_compare_spans (gconstpointer a, gconstpointer b)
+{
+    const LwBenchSpan *x = a;
+    const LwBenchSpan *y = b;
+
+    if (x->start != y->start) return (x->start < y->start) ? -1 : 1;
+    if (x->end != y->end) return (x->end < y->end) ? -1 : 1;
+    return 0;
+}
+
+
+static void
+_append_words (GString *text, GRand *rand, const char **pool, gint length, gint total, const char *separator)
+{
+    //Declarations
+    gint i;
+
+    for (i = 0; i < total; i++)
+    {
+      if (i > 0) g_string_append (text, separator);
+      g_string_append (text, pool[g_rand_int_range (rand, 0, length)]);
+    }
+}
+
+
+//!
+//! @brief Writes an EDICT line with one to three numbered definitions
+//!
+static gchar*
+_new_line (GRand *rand, gboolean is_long)
+{
+    //Declarations
+    GString *line;
+    gint definitions;
+    gint i;
+
+    //Initializations
+    line = g_string_new (NULL);
+    definitions = g_rand_int_range (rand, 1, LW_BENCH_SPANS_MAX_DEFINITIONS + 1);
+
+    _append_words (line, rand, _kanji, G_N_ELEMENTS (_kanji), (is_long) ? LW_RESULTLINE_MAX_MATCHES + 8 : g_rand_int_range (rand, 1, LW_BENCH_SPANS_MAX_WORDS), "");
+    g_string_append (line, " [");
+    _append_words (line, rand, _kana, G_N_ELEMENTS (_kana), (is_long) ? LW_RESULTLINE_MAX_MATCHES + 8 : g_rand_int_range (rand, 1, LW_BENCH_SPANS_MAX_WORDS), "");
+    g_string_append (line, "] /(n) ");
+
+    for (i = 0; i < definitions; i++)
+    {
+      if (definitions > 1) g_string_append_printf (line, "(%d) ", i + 1);
+      _append_words (line, rand, _words, G_N_ELEMENTS (_words), (is_long) ? LW_RESULTLINE_MAX_MATCHES + 8 : g_rand_int_range (rand, 1, LW_BENCH_SPANS_MAX_WORDS + 1), " ");
+      if (i + 1 < definitions) g_string_append_c (line, ' ');
+    }
+    g_string_append (line, "/\n");
+
+    return g_string_free (line, FALSE);
+}
+
+
+//!
+//! @brief Writes a query of one or two atoms of a script.  The romaji atoms are
+//!        literals, alternatives of literals or small regexes.
+//!
+static gchar*
+_new_query (GRand *rand, LwBenchSpansQuery type)
+{
+    //Declarations
+    GString *query;
+    gint atoms;
+    gint first, second;
+    gint i;
+
+    //Initializations
+    query = g_string_new (NULL);
+    atoms = g_rand_int_range (rand, 1, LW_BENCH_SPANS_MAX_ATOMS + 1);
+
+    for (i = 0; i < atoms; i++)
+    {
+      if (i > 0) g_string_append_c (query, '&');
+
+      switch (type)
+      {
+        case LW_BENCH_SPANS_QUERY_KANJI:
+          //Four kanji are also looked for by their halves
+          _append_words (query, rand, _kanji, LW_BENCH_SPANS_KANJI, (g_rand_int_range (rand, 0, 4) == 0) ? 4 : g_rand_int_range (rand, 1, 3), "");
+          break;
+        case LW_BENCH_SPANS_QUERY_KANA:
+          _append_words (query, rand, _kana, G_N_ELEMENTS (_kana), 1, "");
+          break;
+        case LW_BENCH_SPANS_QUERY_ROMAJI:
+          switch (g_rand_int_range (rand, 0, 3))
+          {
+            case 0:
+              _append_words (query, rand, _words, LW_BENCH_SPANS_LITERALS, 1, "");
+              break;
+            case 1:
+              first = g_rand_int_range (rand, 0, LW_BENCH_SPANS_LITERALS);
+              second = (first + g_rand_int_range (rand, 1, LW_BENCH_SPANS_LITERALS)) % LW_BENCH_SPANS_LITERALS;
+              g_string_append_printf (query, "%s|%s", _words[first], _words[second]);
+              break;
+            default:
+              _append_words (query, rand, _patterns, G_N_ELEMENTS (_patterns), 1, "");
+              break;
+          }
+          break;
+        default:
+          g_assert_not_reached ();
+      }
+    }
+
+    return g_string_free (query, FALSE);
+}
+
+
+//!
+//! @brief Adds every match of the LOCATE regex of an atom in a field like the
+//!        old highlighting pass
+//! @returns Whether the atom was found at all
+//!
+static gboolean
+_locate (GArray *spans, LwResultLine *rl, GRegex **re, const char *text)
+{
+    //Declarations
+    GMatchInfo *match_info;
+    LwBenchSpan span;
+    gboolean matched;
+    int start, end;
+
+    //Initializations
+    matched = g_regex_match (re[LW_RELEVANCE_LOCATE], text, 0, &match_info);
+
+    while (g_match_info_matches (match_info))
+    {
+      g_match_info_fetch_pos (match_info, 0, &start, &end);
+      span.start = (text - rl->string) + start;
+      span.end = (text - rl->string) + end;
+      g_array_append_val (spans, span);
+      g_match_info_next (match_info, NULL);
+    }
+
+    //Cleanup
+    g_match_info_free (match_info);
+
+    return matched;
+}
+
+
+//!
+//! @brief Locates the atoms of a kind in a field until one is missing
+//! @returns Whether all of them were found
+//!
+static gboolean
+_locate_all (GArray *spans, LwResultLine *rl, GRegex ***atoms, const char *text)
+{
+    //Declarations
+    GRegex ***iter;
+
+    for (iter = atoms; *iter != NULL && **iter != NULL; iter++)
+    {
+      if (!_locate (spans, rl, *iter, text)) break;
+    }
+
+    return (atoms[0][LW_RELEVANCE_LOW] != NULL && *iter == NULL);
+}
+
+
+//!
+//! @brief Locates the atoms in the fields of an EDICT line in the order the low
+//!        relevance comparison reaches them
+//!
+static void
+_locate_line (GArray *spans, LwQueryLine *ql, LwResultLine *rl)
+{
+    //Declarations
+    GRegex ***iter;
+    gboolean found;
+    gboolean all;
+    int j;
+
+    if (rl->kanji_start != NULL && _locate_all (spans, rl, ql->re_kanji, rl->kanji_start)) return;
+    if (rl->furigana_start != NULL && _locate_all (spans, rl, ql->re_furi, rl->furigana_start)) return;
+    if (rl->kanji_start != NULL && _locate_all (spans, rl, ql->re_furi, rl->kanji_start)) return;
+
+    found = FALSE;
+    for (j = 0; rl->def_start[j] != NULL; j++)
+    {
+      if (ql->roma_literals != NULL)
+      {
+        //One scan finds every literal, whether or not the others are in the definition
+        all = TRUE;
+        for (iter = ql->re_roma; *iter != NULL && **iter != NULL; iter++)
+        {
+          if (!_locate (spans, rl, *iter, rl->def_start[j])) all = FALSE;
+        }
+        if (all) found = TRUE;
+      }
+      else if (_locate_all (spans, rl, ql->re_roma, rl->def_start[j]))
+      {
+        found = TRUE;
+      }
+    }
+    if (found) return;
+
+    _locate_all (spans, rl, ql->re_mix, rl->string);
+}
+
+
+//!
+//! @brief Turns the spans recorded in a result line into offsets from the start
+//!        of its string after checking they point inside of their field
+//!
+static gboolean
+_get_recorded_spans (GArray *spans, LwResultLine *rl)
+{
+    //Declarations
+    LwResultLineMatch *match;
+    LwBenchSpan span;
+    const char *text;
+    gboolean valid;
+    int i;
+
+    //Initializations
+    valid = TRUE;
+
+    for (i = 0; i < rl->match_total && valid; i++)
+    {
+      match = &rl->matches[i];
+      text = lw_resultline_get_field (rl, match->field, match->index);
+
+      valid = (text != NULL &&
+               (match->field != LW_RESULTLINE_FIELD_DEFINITION || match->index < rl->def_total) &&
+               match->start < match->end &&
+               match->end <= strlen (text) &&
+               (text[match->start] & 0xc0) != 0x80 &&
+               (text[match->end] & 0xc0) != 0x80);
+
+      if (valid)
+      {
+        span.start = (text - rl->string) + match->start;
+        span.end = (text - rl->string) + match->end;
+        g_array_append_val (spans, span);
+      }
+      else
+      {
+        fprintf (stderr, "Span %d of field %d[%d] from %d to %d is outside of it or splits a character\n",
+                 i, match->field, match->index, match->start, match->end);
+      }
+    }
+
+    return valid;
+}
+
+
+//!
+//! @brief Whether the recorded spans are the located ones, or all located ones
+//!        when there were more than a result line holds
+//!
+static gboolean
+_spans_match (GArray *recorded, GArray *located)
+{
+    //Declarations
+    gboolean same;
+    guint i, j;
+
+    //Initializations
+    same = TRUE;
+
+    g_array_sort (recorded, _compare_spans);
+    g_array_sort (located, _compare_spans);
+
+    if (located->len < LW_RESULTLINE_MAX_MATCHES)
+    {
+      same = (recorded->len == located->len);
+      for (i = 0; i < recorded->len && same; i++)
+        same = (_compare_spans (&g_array_index (recorded, LwBenchSpan, i), &g_array_index (located, LwBenchSpan, i)) == 0);
+    }
+    else
+    {
+      same = (recorded->len == LW_RESULTLINE_MAX_MATCHES);
+      for (i = 0, j = 0; i < recorded->len && same; i++)
+      {
+        while (j < located->len && _compare_spans (&g_array_index (located, LwBenchSpan, j), &g_array_index (recorded, LwBenchSpan, i)) < 0) j++;
+        same = (j < located->len && _compare_spans (&g_array_index (located, LwBenchSpan, j), &g_array_index (recorded, LwBenchSpan, i)) == 0);
+        j++;
+      }
+    }
+
+    return same;
+}
+
+
+static void
+_print_spans (const char *name, GArray *spans)
+{
+    //Declarations
+    guint i;
+
+    fprintf (stderr, "  %s:", name);
+    for (i = 0; i < spans->len; i++)
+      fprintf (stderr, " %lu-%lu", g_array_index (spans, LwBenchSpan, i).start, g_array_index (spans, LwBenchSpan, i).end);
+    fprintf (stderr, "\n");
+}
+
+
+static gboolean
+_run_round (GRand *rand, LwDictInfo *di, gint round, gulong *total)
+{
+    //Declarations
+    LwSearchItem *item;
+    GError *error;
+    GArray *recorded;
+    GArray *located;
+    gchar *query;
+    gchar *line;
+    gboolean same;
+
+    //Initializations
+    error = NULL;
+    query = _new_query (rand, round % TOTAL_LW_BENCH_SPANS_QUERIES);
+    line = _new_line (rand, round % LW_BENCH_SPANS_LONG_INTERVAL == 0);
+    recorded = g_array_new (FALSE, FALSE, sizeof(LwBenchSpan));
+    located = g_array_new (FALSE, FALSE, sizeof(LwBenchSpan));
+    same = FALSE;
+
+    item = lw_searchitem_new (query, di, NULL, &error);
+    if (item == NULL)
+    {
+      fprintf (stderr, "Round %d: \"%s\" could not be parsed%s%s\n", round, query, (error != NULL) ? ": " : "", (error != NULL) ? error->message : "");
+    }
+    else
+    {
+      item->resultline = lw_resultline_new ();
+      g_strlcpy (item->resultline->string, line, LW_IO_MAX_FGETS_LINE);
+      lw_searchitem_parse_result_string (item);
+      lw_searchitem_run_comparison (item, LW_RELEVANCE_LOW);
+
+      same = _get_recorded_spans (recorded, item->resultline);
+      _locate_line (located, item->queryline, item->resultline);
+      if (same) same = _spans_match (recorded, located);
+
+      if (!same)
+      {
+        fprintf (stderr, "Round %d: the spans of \"%s\" in %s", round, query, line);
+        _print_spans ("recorded", recorded);
+        _print_spans ("located", located);
+      }
+      *total += recorded->len;
+    }
+
+    //Cleanup
+    if (error != NULL) g_error_free (error);
+    if (item != NULL) lw_searchitem_free (item);
+    g_array_free (recorded, TRUE);
+    g_array_free (located, TRUE);
+    g_free (query);
+    g_free (line);
+
+    return same;
+}
+
+
+//!
+//! @brief Spans that a guint16 can't hold or that don't fit are refused
+//!        instead of being cut down
+//!
+static gboolean
+_check_limits ()
+{
+    //Declarations
+    LwResultLine *rl;
+    LwResultLineMatch *match;
+    gboolean ok;
+    int i;
+
+    //Initializations
+    rl = lw_resultline_new ();
+    ok = TRUE;
+
+    ok = ok && lw_resultline_add_match (rl, LW_RESULTLINE_FIELD_DEFINITION, 3, G_MAXUINT16 - 2, G_MAXUINT16);
+    match = &rl->matches[0];
+    ok = ok && rl->match_total == 1 && match->field == LW_RESULTLINE_FIELD_DEFINITION && match->index == 3 &&
+         match->start == G_MAXUINT16 - 2 && match->end == G_MAXUINT16;
+    ok = ok && !lw_resultline_add_match (rl, LW_RESULTLINE_FIELD_DEFINITION, 0, G_MAXUINT16, G_MAXUINT16 + 1);
+    ok = ok && !lw_resultline_add_match (rl, LW_RESULTLINE_FIELD_DEFINITION, 0, 4, G_MAXUINT16 + 5);
+    ok = ok && !lw_resultline_add_match (rl, LW_RESULTLINE_FIELD_DEFINITION, 0, 4, 4);
+    ok = ok && !lw_resultline_add_match (rl, LW_RESULTLINE_FIELD_DEFINITION, 0, -1, 4);
+    ok = ok && rl->match_total == 1;
+
+    for (i = 1; i < LW_RESULTLINE_MAX_MATCHES && ok; i++)
+      ok = lw_resultline_add_match (rl, LW_RESULTLINE_FIELD_KANJI, 0, i, i + 1);
+    ok = ok && !lw_resultline_add_match (rl, LW_RESULTLINE_FIELD_KANJI, 0, 0, 1);
+    ok = ok && rl->match_total == LW_RESULTLINE_MAX_MATCHES;
+
+    if (!ok) fprintf (stderr, "lw_resultline_add_match kept a span it can't hold or lost one it can\n");
+
+    //Cleanup
+    lw_resultline_free (rl);
+
+    return ok;
+}
+
+
+int
+main (int argc, char *argv[])
+{
+    //Declarations
+    GOptionContext *context;
+    GError *error;
+    LwDictInfo *di;
+    GRand *rand;
+    gulong total;
+    gint rounds;
+    gint seed;
+    gint i;
+    gboolean ok;
+
+    //Initializations
+    error = NULL;
+    rounds = 20000;
+    seed = 1;
+    total = 0;
+
+    GOptionEntry entries[] = {
+      { "rounds", 'n', 0, G_OPTION_ARG_INT, &rounds, "Random queries and lines to check", "N" },
+      { "seed", 0, 0, G_OPTION_ARG_INT, &seed, "Random seed so runs can be reproduced", "N" },
+      { NULL }
+    };
+
+    context = g_option_context_new (NULL);
+    g_option_context_set_summary (context, "Checks the recorded match spans against the LOCATE regexes.");
+    g_option_context_add_main_entries (context, entries, NULL);
+    g_option_context_parse (context, &argc, &argv, &error);
+    g_option_context_free (context);
+
+    if (error != NULL)
+    {
+      fprintf (stderr, "%s\n", error->message);
+      g_error_free (error);
+      return EXIT_FAILURE;
+    }
+
+    lw_regex_initialize ();
+    rand = g_rand_new_with_seed ((guint32) seed);
+    di = lw_dictinfo_new (LW_DICTTYPE_EDICT, "English");
+
+    ok = _check_limits ();
+
+    for (i = 0; i < rounds && ok; i++)
+      ok = _run_round (rand, di, i, &total);
+
+    if (ok) printf ("{ \"rounds\": %d, \"spans\": %lu }\n", rounds, total);
+
+    //Cleanup
+    lw_dictinfo_free (di);
+    g_rand_free (rand);
+
+    return (ok) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,233 @@
+/******************************************************************************
+    AUTHOR:
+    File written and Copyrighted by Zachary Dovel. All Rights Reserved.
+
+    LICENSE:
+    This file is part of gWaei.
+
+    gWaei is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    gWaei is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    
+    You should have received a copy of the GNU General Public License
+    along with gWaei.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+//!
+//! @file strokegen.c
+//!
+//! @brief Writes a handwriting corpus for lwbench-strokes by drawing the
+//!        direction codes of each character in the stroke database as
+//!        straight runs of points with a little jitter.
+//!
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include <libwaei/libwaei.h>
+
+#include "bench.h"
+
+
+//!
+//! @brief Converts a JIS X 0208 row and cell to UTF-8 for the corpus comments
+//!
+static gchar* 
+_jis_to_utf8 (const guchar *JIS)
+{
+    //Declarations
+    gchar euc[3];
+
+    //Initializations
+    euc[0] = JIS[0] | 0x80;
+    euc[1] = JIS[1] | 0x80;
+    euc[2] = '\0';
+
+    return g_convert (euc, -1, "UTF-8", "EUC-JP", NULL, NULL, NULL);
+}
+
+
+static guint8 
+_clamp_point (double value)
+{
+    return (guint8) CLAMP (value, 0.0, (double) (LW_BENCH_STROKE_SIZE - 1));
+}
+
+
+//!
+//! @brief Draws one stroke of a character.  Direction codes are in 32nds of a
+//!        circle, clockwise from straight up, in screen coordinates.
+//!
+static void 
+_write_stroke (FILE *file, GRand *rand, const gchar *PATH, gint length, gint noise)
+{
+    //Declarations
+    double x, y;
+    double step;
+    double angle;
+    int i, j;
+
+    //Initializations
+    step = (length > 0) ? (double) LW_BENCH_STROKE_LENGTH / (length * LW_BENCH_STROKE_POINTS_PER_CODE) : 0.0;
+    x = g_rand_double_range (rand, LW_BENCH_STROKE_SIZE / 4, LW_BENCH_STROKE_SIZE * 3 / 4);
+    y = g_rand_double_range (rand, LW_BENCH_STROKE_SIZE / 4, LW_BENCH_STROKE_SIZE * 3 / 4);
+
+    fprintf (file, "%d %d", _clamp_point (x), _clamp_point (y));
+
+    for (i = 0; i < length; i++)
+    {
+      angle = PATH[i] * G_PI / 16.0;
+      for (j = 0; j < LW_BENCH_STROKE_POINTS_PER_CODE; j++)
+      {
+        x += step * sin (angle);
+        y -= step * cos (angle);
+        fprintf (file, " %d %d", 
+                 _clamp_point (x + ((noise > 0) ? g_rand_int_range (rand, -noise, noise + 1) : 0)),
+                 _clamp_point (y + ((noise > 0) ? g_rand_int_range (rand, -noise, noise + 1) : 0)));
+      }
+    }
+
+    fputc ('\n', file);
+}
+
+
+//!
+//! @brief Writes every stride-th character with the given stroke count
+//!
+static gboolean 
+_write_table (FILE *file, GRand *rand, const LwStrokeDBTable *table, gint samples, gint stride, gint noise)
+{
+    //Declarations
+    const guint *offsets;
+    gchar *character;
+    gint i, j, s;
+
+    for (i = 0; i < table->total && ferror (file) == 0; i += stride)
+    {
+      character = _jis_to_utf8 (table->jis + i * 2);
+      offsets = table->path_offsets + i * table->strokes;
+
+      for (j = 0; j < samples; j++)
+      {
+        fprintf (file, "K%02x%02x %s\n", table->jis[i * 2], table->jis[i * 2 + 1], (character != NULL) ? character : "?");
+        for (s = 0; s < table->strokes; s++)
+        {
+          //Descriptions that ran out of strokes are drawn as a dot
+          _write_stroke (file, rand, table->paths + offsets[s], offsets[s + 1] - offsets[s], noise);
+        }
+        fputc ('\n', file);
+      }
+
+      g_free (character);
+    }
+
+    return (ferror (file) == 0);
+}
+
+
+int 
+main (int argc, char *argv[])
+{
+    //Declarations
+    GOptionContext *context;
+    GError *error;
+    GRand *rand;
+    LwStrokeDB *db;
+    FILE *file;
+    gchar *jdata;
+    gchar *output;
+    gint samples;
+    gint stride;
+    gint noise;
+    gint strokes;
+    gint seed;
+    gboolean ok;
+    int i;
+
+    //Initializations
+    error = NULL;
+    jdata = NULL;
+    output = NULL;
+    samples = 1;
+    stride = 1;
+    noise = LW_BENCH_STROKE_NOISE;
+    strokes = 0;
+    seed = 1;
+    ok = TRUE;
+
+    GOptionEntry entries[] = {
+      { "jdata", 'j', 0, G_OPTION_ARG_FILENAME, &jdata, "The stroke database built from strokedata.h", "FILE" },
+      { "output", 'o', 0, G_OPTION_ARG_FILENAME, &output, "File to write the corpus to instead of standard out", "FILE" },
+      { "samples", 'n', 0, G_OPTION_ARG_INT, &samples, "Drawings written for each character", "N" },
+      { "stride", 0, 0, G_OPTION_ARG_INT, &stride, "Only write every Nth character", "N" },
+      { "noise", 0, 0, G_OPTION_ARG_INT, &noise, "Pixels of jitter added to each point", "N" },
+      { "strokes", 's', 0, G_OPTION_ARG_INT, &strokes, "Only write characters with this many strokes", "N" },
+      { "seed", 0, 0, G_OPTION_ARG_INT, &seed, "Random seed so runs can be reproduced", "N" },
+      { NULL }
+    };
+
+    context = g_option_context_new (NULL);
+    g_option_context_set_summary (context, "Synthesizes a handwriting corpus for lwbench-strokes.");
+    g_option_context_add_main_entries (context, entries, NULL);
+    g_option_context_parse (context, &argc, &argv, &error);
+    g_option_context_free (context);
+
+    if (error != NULL)
+    {
+      fprintf (stderr, "%s\n", error->message);
+      g_error_free (error);
+      return EXIT_FAILURE;
+    }
+    if (samples < 1 || stride < 1 || noise < 0 || strokes < 0 || strokes > LW_STROKEDB_MAX_STROKES)
+    {
+      fprintf (stderr, "The samples and stride have to be at least 1 and the stroke count at most %d.\n", LW_STROKEDB_MAX_STROKES);
+      return EXIT_FAILURE;
+    }
+
+    db = lw_strokedb_new (jdata, &error);
+    if (db == NULL)
+    {
+      fprintf (stderr, "%s\n", (error != NULL) ? error->message : "Can't open jdata.dat");
+      if (error != NULL) g_error_free (error);
+      return EXIT_FAILURE;
+    }
+
+    file = (output != NULL) ? g_fopen (output, "wb") : stdout;
+    if (file == NULL)
+    {
+      fprintf (stderr, "Unable to write to the file %s\n", output);
+      lw_strokedb_free (db);
+      return EXIT_FAILURE;
+    }
+
+    rand = g_rand_new_with_seed ((guint32) seed);
+
+    for (i = 1; i <= LW_STROKEDB_MAX_STROKES && ok; i++)
+    {
+      if (strokes != 0 && strokes != i) continue;
+      ok = _write_table (file, rand, &db->tables[i], samples, stride, noise);
+    }
+
+    if (file != stdout && fclose (file) != 0) ok = FALSE;
+    if (!ok) fprintf (stderr, "Unable to write the corpus\n");
+
+    //Cleanup
+    g_rand_free (rand);
+    lw_strokedb_free (db);
+    g_free (jdata);
+    g_free (output);
+
+    return (ok) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,420 @@
+/******************************************************************************
+    AUTHOR:
+    File written and Copyrighted by Zachary Dovel. All Rights Reserved.
+
+    LICENSE:
+    This file is part of gWaei.
+
+    gWaei is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    gWaei is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    
+    You should have received a copy of the GNU General Public License
+    along with gWaei.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+//!
+//! @file strokes.c
+//!
+//! @brief Replays a handwriting corpus through the stroke database in the
+//!        calling process and prints the accuracy and latency as JSON.
+//!
+//! The corpus is what lwbench-strokegen writes.  Each drawing starts with a
+//! line "K" followed by the expected character as four hex digits of JIS X
+//! 0208, then has one line of "x y x y ..." points per stroke like kpengine
+//! reads, and ends with a blank line.  Lines starting with # are skipped.
+//!
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <glib.h>
+
+#include <libwaei/libwaei.h>
+
+#include "bench.h"
+
+
+struct _LwBenchDrawing {
+  guchar jis[2];
+  gint total;
+  LwStroke *strokes;
+};
+typedef struct _LwBenchDrawing LwBenchDrawing;
+
+
+static gboolean 
+_parse_stroke (const gchar *LINE, LwStroke *stroke)
+{
+    //Declarations
+    const gchar *ptr;
+    gchar *end;
+    glong x, y;
+
+    //Initializations
+    ptr = LINE;
+    stroke->length = 0;
+
+    while (stroke->length < LW_STROKEDB_MAX_POINTS)
+    {
+      x = strtol (ptr, &end, 0);
+      if (end == ptr) break;
+      ptr = end;
+      y = strtol (ptr, &end, 0);
+      if (end == ptr) break;
+      ptr = end;
+
+      stroke->x[stroke->length] = (guint8) CLAMP (x, 0, 255);
+      stroke->y[stroke->length] = (guint8) CLAMP (y, 0, 255);
+      stroke->length++;
+    }
+
+    return (stroke->length > 0);
+}
+
+
+//!
+//! @brief Reads a whole corpus into memory so no file reading is timed
+//!
+static GArray* 
+_load_corpus (const gchar *PATH, GError **error)
+{
+    //Declarations
+    GArray *drawings;
+    LwBenchDrawing drawing;
+    LwStroke strokes[LW_STROKEDB_MAX_STROKES];
+    gchar *text;
+    gchar **lines;
+    guint expected[2];
+    gboolean open;
+    int i;
+
+    //Initializations
+    if (!g_file_get_contents (PATH, &text, NULL, error)) return NULL;
+    lines = g_strsplit (text, "\n", -1);
+    drawings = g_array_new (FALSE, FALSE, sizeof(LwBenchDrawing));
+    open = FALSE;
+    drawing.total = 0;
+
+    for (i = 0; lines[i] != NULL; i++)
+    {
+      g_strchomp (lines[i]);
+
+      if (lines[i][0] == '#')
+      {
+        continue;
+      }
+      else if (lines[i][0] == 'K')
+      {
+        open = (sscanf (lines[i] + 1, "%2x%2x", &expected[0], &expected[1]) == 2);
+        drawing.jis[0] = expected[0];
+        drawing.jis[1] = expected[1];
+        drawing.total = 0;
+      }
+      else if (lines[i][0] == '\0')
+      {
+        if (open && drawing.total > 0)
+        {
+          drawing.strokes = g_memdup (strokes, sizeof(LwStroke) * drawing.total);
+          g_array_append_val (drawings, drawing);
+        }
+        open = FALSE;
+      }
+      else if (open && drawing.total < LW_STROKEDB_MAX_STROKES)
+      {
+        if (_parse_stroke (lines[i], &strokes[drawing.total])) drawing.total++;
+      }
+    }
+
+    //A corpus without a final blank line
+    if (open && drawing.total > 0)
+    {
+      drawing.strokes = g_memdup (strokes, sizeof(LwStroke) * drawing.total);
+      g_array_append_val (drawings, drawing);
+    }
+
+    //Cleanup
+    g_strfreev (lines);
+    g_free (text);
+
+    return drawings;
+}
+
+
+static void 
+_free_corpus (GArray *drawings)
+{
+    //Declarations
+    int i;
+
+    for (i = 0; i < drawings->len; i++)
+      g_free (g_array_index (drawings, LwBenchDrawing, i).strokes);
+    g_array_free (drawings, TRUE);
+}
+
+
+static gint 
+_compare_doubles (gconstpointer a, gconstpointer b)
+{
+    double da = *(const double*) a;
+    double db = *(const double*) b;
+
+    return (da > db) - (da < db);
+}
+
+
+//!
+//! @brief Appends the mean and 99th percentile of each list of latencies as JSON
+//!
+static void 
+_append_latencies (GString *json, const char *KEY, GArray **latencies)
+{
+    //Declarations
+    GArray *times;
+    double mean;
+    gboolean first;
+    int i, j;
+
+    //Initializations
+    first = TRUE;
+
+    g_string_append_printf (json, ",\n  \"%s\": [", KEY);
+
+    for (i = 1; i <= LW_STROKEDB_MAX_STROKES; i++)
+    {
+      times = latencies[i];
+      if (times->len == 0) continue;
+
+      g_array_sort (times, _compare_doubles);
+      mean = 0.0;
+      for (j = 0; j < times->len; j++) mean += g_array_index (times, double, j);
+      mean /= times->len;
+
+      g_string_append_printf (json, "%s\n    {\"strokes\": %d, \"samples\": %d, \"mean_ms\": %.3f, \"p99_ms\": %.3f}",
+                              (first) ? "" : ",", i, times->len, mean * 1000.0,
+                              g_array_index (times, double, (times->len - 1) * 99 / 100) * 1000.0);
+      first = FALSE;
+    }
+
+    g_string_append (json, "\n  ]");
+}
+
+
+static gboolean 
+_is_match (const LwStrokeDBCandidate *candidate, const LwBenchDrawing *drawing)
+{
+    return (candidate->jis[0] == drawing->jis[0] && candidate->jis[1] == drawing->jis[1]);
+}
+
+
+//!
+//! @brief Times lw_strokedb_recognize on every drawing once the strokes are finished
+//!
+static void 
+_run_batch (GString *json, LwStrokeDB *db, GArray *drawings, gint candidates)
+{
+    //Declarations
+    GArray *latencies[LW_STROKEDB_MAX_STROKES + 1];
+    LwStrokeDBCandidate *results;
+    LwBenchDrawing *drawing;
+    GTimer *timer;
+    double elapsed, total_time;
+    gint top1, topn;
+    gint total;
+    int i, j;
+
+    //Initializations
+    results = g_new (LwStrokeDBCandidate, candidates);
+    timer = g_timer_new ();
+    total_time = 0.0;
+    top1 = topn = 0;
+    for (i = 0; i <= LW_STROKEDB_MAX_STROKES; i++) latencies[i] = g_array_new (FALSE, FALSE, sizeof(double));
+
+    for (i = 0; i < drawings->len; i++)
+    {
+      drawing = &g_array_index (drawings, LwBenchDrawing, i);
+
+      g_timer_start (timer);
+      total = lw_strokedb_recognize (db, drawing->strokes, drawing->total, results, candidates);
+      elapsed = g_timer_elapsed (timer, NULL);
+
+      total_time += elapsed;
+      g_array_append_val (latencies[drawing->total], elapsed);
+
+      if (total > 0 && _is_match (&results[0], drawing)) top1++;
+      for (j = 0; j < total && j < LW_BENCH_CANDIDATES; j++)
+      {
+        if (_is_match (&results[j], drawing))
+        {
+          topn++;
+          break;
+        }
+      }
+    }
+
+    g_string_append_printf (json, ",\n  \"top1_accuracy\": %.4f, \"top%d_accuracy\": %.4f, \"total_ms\": %.3f, \"drawings_per_sec\": %.1f",
+                            (double) top1 / drawings->len, LW_BENCH_CANDIDATES, (double) topn / drawings->len,
+                            total_time * 1000.0, (total_time > 0.0) ? drawings->len / total_time : 0.0);
+    _append_latencies (json, "latency_by_stroke_count", latencies);
+
+    //Cleanup
+    for (i = 0; i <= LW_STROKEDB_MAX_STROKES; i++) g_array_free (latencies[i], TRUE);
+    g_timer_destroy (timer);
+    g_free (results);
+}
+
+
+//!
+//! @brief Times each stroke added to an LwStrokeDBSession, which is what the
+//!        kanjipad does while the user draws
+//!
+static void 
+_run_incremental (GString *json, LwStrokeDB *db, GArray *drawings, gint candidates)
+{
+    //Declarations
+    GArray *latencies[LW_STROKEDB_MAX_STROKES + 1];
+    LwStrokeDBSession *session;
+    LwStrokeDBCandidate *results;
+    LwBenchDrawing *drawing;
+    GTimer *timer;
+    double elapsed;
+    gint top1;
+    gint total;
+    int i, j;
+
+    //Initializations
+    session = lw_strokedb_session_new (db);
+    results = g_new (LwStrokeDBCandidate, candidates);
+    timer = g_timer_new ();
+    top1 = 0;
+    total = 0;
+    for (i = 0; i <= LW_STROKEDB_MAX_STROKES; i++) latencies[i] = g_array_new (FALSE, FALSE, sizeof(double));
+
+    for (i = 0; i < drawings->len; i++)
+    {
+      drawing = &g_array_index (drawings, LwBenchDrawing, i);
+      lw_strokedb_session_clear (session);
+
+      for (j = 0; j < drawing->total; j++)
+      {
+        g_timer_start (timer);
+        total = 0;
+        if (lw_strokedb_session_add_stroke (session, &drawing->strokes[j]))
+          total = lw_strokedb_session_get_candidates (session, results, candidates);
+        elapsed = g_timer_elapsed (timer, NULL);
+
+        g_array_append_val (latencies[j + 1], elapsed);
+      }
+
+      if (total > 0 && _is_match (&results[0], drawing)) top1++;
+    }
+
+    g_string_append_printf (json, ",\n  \"incremental_top1_accuracy\": %.4f", (double) top1 / drawings->len);
+    _append_latencies (json, "incremental_latency_by_stroke", latencies);
+
+    //Cleanup
+    for (i = 0; i <= LW_STROKEDB_MAX_STROKES; i++) g_array_free (latencies[i], TRUE);
+    g_timer_destroy (timer);
+    g_free (results);
+    lw_strokedb_session_free (session);
+}
+
+
+int 
+main (int argc, char *argv[])
+{
+    //Declarations
+    GOptionContext *context;
+    GError *error;
+    GTimer *timer;
+    GString *json;
+    GArray *drawings;
+    LwStrokeDB *db;
+    gchar *jdata;
+    gchar *corpus;
+    gint candidates;
+    gboolean incremental;
+    double load_time;
+
+    //Initializations
+    error = NULL;
+    jdata = NULL;
+    corpus = NULL;
+    candidates = LW_BENCH_CANDIDATES;
+    incremental = FALSE;
+
+    GOptionEntry entries[] = {
+      { "corpus", 'c', 0, G_OPTION_ARG_FILENAME, &corpus, "Drawings written by lwbench-strokegen", "FILE" },
+      { "jdata", 'j', 0, G_OPTION_ARG_FILENAME, &jdata, "The stroke database to recognize with", "FILE" },
+      { "candidates", 'n', 0, G_OPTION_ARG_INT, &candidates, "Candidates asked for from each recognition", "N" },
+      { "incremental", 'i', 0, G_OPTION_ARG_NONE, &incremental, "Also time recognition after every stroke", NULL },
+      { NULL }
+    };
+
+    g_thread_init (NULL);
+
+    context = g_option_context_new (NULL);
+    g_option_context_set_summary (context, "Times handwriting recognition and prints the results as JSON.");
+    g_option_context_add_main_entries (context, entries, NULL);
+    g_option_context_parse (context, &argc, &argv, &error);
+    g_option_context_free (context);
+
+    if (error != NULL)
+    {
+      fprintf (stderr, "%s\n", error->message);
+      g_error_free (error);
+      return EXIT_FAILURE;
+    }
+    if (corpus == NULL || candidates < LW_BENCH_CANDIDATES)
+    {
+      fprintf (stderr, "A corpus written by lwbench-strokegen and at least %d candidates are required.\n", LW_BENCH_CANDIDATES);
+      return EXIT_FAILURE;
+    }
+
+    drawings = _load_corpus (corpus, &error);
+    if (drawings == NULL || drawings->len == 0)
+    {
+      fprintf (stderr, "%s\n", (error != NULL) ? error->message : "The corpus has no drawings");
+      if (error != NULL) g_error_free (error);
+      if (drawings != NULL) _free_corpus (drawings);
+      return EXIT_FAILURE;
+    }
+
+    timer = g_timer_new ();
+    db = lw_strokedb_new (jdata, &error);
+    load_time = g_timer_elapsed (timer, NULL);
+    g_timer_destroy (timer);
+
+    if (db == NULL)
+    {
+      fprintf (stderr, "%s\n", (error != NULL) ? error->message : "Can't open jdata.dat");
+      if (error != NULL) g_error_free (error);
+      _free_corpus (drawings);
+      return EXIT_FAILURE;
+    }
+
+    json = g_string_new (NULL);
+    g_string_append_printf (json, "{\n  \"drawings\": %d, \"candidates\": %d, \"load_ms\": %.3f", drawings->len, candidates, load_time * 1000.0);
+
+    _run_batch (json, db, drawings, candidates);
+    if (incremental) _run_incremental (json, db, drawings, candidates);
+
+    printf ("%s\n}\n", json->str);
+
+    //Cleanup
+    g_string_free (json, TRUE);
+    lw_strokedb_free (db);
+    _free_corpus (drawings);
+    g_free (jdata);
+    g_free (corpus);
+
+    return EXIT_SUCCESS;
+}
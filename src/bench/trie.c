@@ -0,0 +1,307 @@
+/******************************************************************************
+    AUTHOR:
+    File written and Copyrighted by Zachary Dovel. All Rights Reserved.
+
+    LICENSE:
+    This file is part of gWaei.
+
+    gWaei is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    gWaei is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with gWaei.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+//!
+//! @file trie.c
+//!
+//! @brief Checks LwHeadwordTrie against a brute force longest prefix search
+//!
+//! A random EDICT dictionary is written to a temporary config folder and its
+//! headword trie is built into the cache folder there.  The headwords and
+//! readings of the dictionary are kept in a hash table with the offsets of
+//! their lines.  At every character of random texts, the longest match of
+//! the trie has to be the longest prefix found in the hash table, and the
+//! postings of the matched key have to be the lines of that prefix.
+//!
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include <libwaei/libwaei.h>
+
+#include "bench.h"
+
+
+//Short keys from a few characters share prefixes often.  The last one takes four bytes.
+static const gchar *_characters[] = { "あ", "い", "う", "か", "き", "日", "本", "語", "a", "ー", "\xf0\xa0\x80\x8b" };
+
+#define LW_BENCH_TRIE_FILENAME "lwbench-trie"
+#define LW_BENCH_TRIE_MAX_KEY_CHARACTERS 6
+#define LW_BENCH_TRIE_MAX_TEXT_CHARACTERS 200
+
+
+static void
+_append_random_key (GString *line, GRand *rand)
+{
+    //Declarations
+    gint length;
+    gint i;
+
+    //Initializations
+    length = g_rand_int_range (rand, 1, LW_BENCH_TRIE_MAX_KEY_CHARACTERS + 1);
+
+    for (i = 0; i < length; i++)
+      g_string_append (line, _characters[g_rand_int_range (rand, 0, G_N_ELEMENTS (_characters))]);
+}
+
+
+//!
+//! @brief Writes a random EDICT dictionary and keeps its keys
+//! @returns FALSE if the dictionary couldn't be written
+//!
+static gboolean
+_write_dictionary (const gchar *PATH, gint lines, GRand *rand, GHashTable *keys)
+{
+    //Declarations
+    FILE *file;
+    GString *line;
+    gsize start;
+    guint32 offset;
+    gint i;
+    gboolean written;
+
+    //Initializations
+    file = lw_bench_open_dictionary (PATH, &offset);
+    if (file == NULL) return FALSE;
+    line = g_string_new (NULL);
+    written = TRUE;
+
+    for (i = 0; i < lines && written; i++)
+    {
+      g_string_truncate (line, 0);
+
+      //A headword, sometimes a second one with a note
+      _append_random_key (line, rand);
+      lw_bench_postings_add (keys, line->str, line->len, offset);
+      if (g_rand_int_range (rand, 0, 3) == 0)
+      {
+        g_string_append_c (line, ';');
+        start = line->len;
+        _append_random_key (line, rand);
+        lw_bench_postings_add (keys, line->str + start, line->len - start, offset);
+        g_string_append (line, "(oK)");
+      }
+
+      //A reading now and then
+      if (g_rand_boolean (rand))
+      {
+        g_string_append (line, " [");
+        start = line->len;
+        _append_random_key (line, rand);
+        lw_bench_postings_add (keys, line->str + start, line->len - start, offset);
+        g_string_append_c (line, ']');
+      }
+
+      g_string_append_printf (line, " /(n) definition %d/%s\n", i, (g_rand_int_range (rand, 0, 4) == 0) ? "(P)/" : "");
+      written = (fputs (line->str, file) != EOF);
+      offset += line->len;
+    }
+
+    //Cleanup
+    g_string_free (line, TRUE);
+    if (fclose (file) != 0) written = FALSE;
+
+    return written;
+}
+
+
+//!
+//! @brief Finds the longest key a text starts with by looking up each prefix
+//! @returns The length of the key in bytes or 0
+//!
+static gsize
+_brute_force (GHashTable *keys, const gchar *TEXT, GArray **postings)
+{
+    //Declarations
+    gchar buffer[LW_HEADWORDTRIE_MAX_KEY_LENGTH + 1];
+    GArray *found;
+    gsize longest;
+    gsize length;
+
+    //Initializations
+    longest = 0;
+    *postings = NULL;
+
+    for (length = 1; length <= LW_HEADWORDTRIE_MAX_KEY_LENGTH && TEXT[length - 1] != '\0'; length++)
+    {
+      memcpy (buffer, TEXT, length);
+      buffer[length] = '\0';
+      found = g_hash_table_lookup (keys, buffer);
+      if (found == NULL) continue;
+
+      longest = length;
+      *postings = found;
+    }
+
+    return longest;
+}
+
+
+//!
+//! @brief Matches a random text at each of its characters and prints the first difference
+//! @returns TRUE if the trie agreed with the brute force search everywhere
+//!
+static gboolean
+_run_round (LwHeadwordTrie *trie, GHashTable *keys, GRand *rand, gint round)
+{
+    //Declarations
+    GString *text;
+    GArray *expected;
+    const guint32 *postings;
+    const gchar *ptr;
+    guint32 total;
+    guint32 key;
+    gsize longest;
+    gsize length;
+    gint characters;
+    gint i;
+    gboolean same;
+
+    //Initializations
+    text = g_string_new (NULL);
+    characters = g_rand_int_range (rand, 0, LW_BENCH_TRIE_MAX_TEXT_CHARACTERS + 1);
+    same = TRUE;
+
+    //An x is in no key, so matches have to stop at it
+    for (i = 0; i < characters; i++)
+    {
+      if (g_rand_int_range (rand, 0, 20) == 0) g_string_append_c (text, 'x');
+      else g_string_append (text, _characters[g_rand_int_range (rand, 0, G_N_ELEMENTS (_characters))]);
+    }
+
+    for (ptr = text->str; same && *ptr != '\0'; ptr = g_utf8_next_char (ptr))
+    {
+      length = text->len - (ptr - text->str);
+      longest = _brute_force (keys, ptr, &expected);
+      key = 0;
+      total = 0;
+      postings = NULL;
+
+      same = (lw_headwordtrie_match_longest (trie, ptr, length, &key) == longest);
+      if (same && longest > 0)
+      {
+        postings = lw_headwordtrie_get_postings (trie, key, &total);
+        same = (postings != NULL && total == expected->len && memcmp (postings, expected->data, sizeof(guint32) * total) == 0);
+      }
+
+      if (!same)
+        fprintf (stderr, "Round %d: the trie disagrees at byte %lu of \"%s\", the longest key is %lu bytes with %u lines\n",
+                 round, (gulong) (ptr - text->str), text->str, (gulong) longest, (expected != NULL) ? expected->len : 0);
+    }
+
+    //Cleanup
+    g_string_free (text, TRUE);
+
+    return same;
+}
+
+
+int
+main (int argc, char *argv[])
+{
+    //Declarations
+    GOptionContext *context;
+    GError *error;
+    GRand *rand;
+    GHashTable *keys;
+    LwHeadwordTrie *trie;
+    gchar *directory;
+    gchar *path;
+    gint lines;
+    gint rounds;
+    gint seed;
+    gint i;
+    gboolean ok;
+
+    //Initializations
+    error = NULL;
+    trie = NULL;
+    lines = 20000;
+    rounds = 300;
+    seed = 1;
+
+    GOptionEntry entries[] = {
+      { "lines", 'l', 0, G_OPTION_ARG_INT, &lines, "Entries in the written dictionary", "N" },
+      { "rounds", 'n', 0, G_OPTION_ARG_INT, &rounds, "Random texts to match", "N" },
+      { "seed", 0, 0, G_OPTION_ARG_INT, &seed, "Random seed so runs can be reproduced", "N" },
+      { NULL }
+    };
+
+    context = g_option_context_new (NULL);
+    g_option_context_set_summary (context, "Checks LwHeadwordTrie against a brute force longest prefix search.");
+    g_option_context_add_main_entries (context, entries, NULL);
+    g_option_context_parse (context, &argc, &argv, &error);
+    g_option_context_free (context);
+
+    if (error != NULL)
+    {
+      fprintf (stderr, "%s\n", error->message);
+      g_error_free (error);
+      return EXIT_FAILURE;
+    }
+
+    //The dictionary and cache paths are built from the user config dir
+    directory = lw_bench_make_config_dir ("lwbench-trie");
+    if (directory == NULL) return EXIT_FAILURE;
+
+    rand = g_rand_new_with_seed ((guint32) seed);
+    keys = lw_bench_postings_new ();
+    path = lw_util_build_filename_by_dicttype (LW_DICTTYPE_EDICT, LW_BENCH_TRIE_FILENAME);
+
+    ok = _write_dictionary (path, lines, rand, keys);
+    if (!ok) fprintf (stderr, "Unable to write the dictionary %s\n", path);
+
+    if (ok)
+    {
+      trie = lw_headwordtrie_new (LW_DICTTYPE_EDICT, LW_BENCH_TRIE_FILENAME, &error);
+      ok = (trie != NULL);
+      if (error != NULL) fprintf (stderr, "%s\n", error->message);
+    }
+
+    if (ok && trie->header->total_keys != g_hash_table_size (keys))
+    {
+      fprintf (stderr, "The trie has %u keys and the dictionary has %u\n", trie->header->total_keys, g_hash_table_size (keys));
+      ok = FALSE;
+    }
+
+    for (i = 0; ok && i < rounds; i++)
+      ok = _run_round (trie, keys, rand, i);
+
+    if (ok) printf ("{ \"keys\": %u, \"cells\": %u, \"rounds\": %d }\n", trie->header->total_keys, trie->header->total_cells, rounds);
+
+    //Cleanup
+    if (trie != NULL) lw_headwordtrie_free (trie);
+    lw_headwordtrie_remove (LW_DICTTYPE_EDICT, LW_BENCH_TRIE_FILENAME);
+    g_remove (path);
+    lw_bench_remove_config_dir (directory);
+    if (error != NULL) g_error_free (error);
+    g_hash_table_destroy (keys);
+    g_rand_free (rand);
+    g_free (path);
+    g_free (directory);
+
+    return (ok) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
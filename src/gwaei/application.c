@@ -127,6 +127,8 @@ gw_application_finalize (GObject *object)
     if (priv->error != NULL) g_error_free (priv->error); priv->error = NULL;
 
     if (priv->dictinstlist != NULL) lw_dictinstlist_free (priv->dictinstlist); priv->dictinstlist = NULL;
+    if (priv->strokedb != NULL) lw_strokedb_free (priv->strokedb); priv->strokedb = NULL;
+    if (priv->spellindex != NULL) lw_spellindex_free (priv->spellindex); priv->spellindex = NULL;
     if (priv->dictinfolist != NULL) gw_dictinfolist_free (priv->dictinfolist); priv->dictinfolist = NULL;
     if (priv->context != NULL) g_option_context_free (priv->context); priv->context = NULL;
     if (priv->arg_query != NULL) g_free(priv->arg_query); priv->arg_query = NULL;
@@ -600,6 +602,44 @@ gw_application_get_dictinstlist (GwApplication *application)
 }
 
 
+//!
+//! @brief Gets the handwriting database, mapping it the first time it is asked for
+//! @param application A GwApplication
+//! @param error A pointer to a GError to write loading errors to
+//! @returns The LwStrokeDB shared by all of the kanjipads or NULL if it couldn't be loaded
+//!
+LwStrokeDB* 
+gw_application_get_strokedb (GwApplication *application, GError **error)
+{
+    GwApplicationPrivate *priv;
+    priv = application->priv;
+
+    if (priv->strokedb == NULL)
+      priv->strokedb = lw_strokedb_new (NULL, error);
+
+    return priv->strokedb;
+}
+
+
+//!
+//! @brief Gets the spelling suggestions made from the dictionary glosses.  It
+//!        starts out empty and the spellchecks load it off of the main thread.
+//! @param application A GwApplication
+//! @returns The LwSpellIndex shared by all of the windows
+//!
+LwSpellIndex* 
+gw_application_get_spellindex (GwApplication *application)
+{
+    GwApplicationPrivate *priv;
+    priv = application->priv;
+
+    if (priv->spellindex == NULL)
+      priv->spellindex = lw_spellindex_new ();
+
+    return priv->spellindex;
+}
+
+
 GtkListStore*
 gw_application_get_vocabularyliststore (GwApplication *application)
 {
@@ -169,6 +169,9 @@ void gw_dictinfolist_reload (GwDictInfoList *dil)
     lw_dictinfolist_reload (LW_DICTINFOLIST (dil));
     lw_dictinfolist_load_dictionary_order_from_pref (LW_DICTINFOLIST (dil), preferences);
 
+    //The spelling suggestions are made from the glosses of the installed dictionaries
+    lw_spellindex_clear (gw_application_get_spellindex (dil->application));
+
     if (dil->signalids[GW_DICTINFOLIST_SIGNALID_ROW_CHANGED] > 0)
       g_signal_handler_block (dil->model, dil->signalids[GW_DICTINFOLIST_SIGNALID_ROW_CHANGED]);
 
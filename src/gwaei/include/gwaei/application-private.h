@@ -23,6 +23,8 @@ struct _GwApplicationPrivate {
   LwPreferences *preferences;
   GwDictInfoList *dictinfolist;
   LwDictInstList *dictinstlist;
+  LwStrokeDB *strokedb;
+  LwSpellIndex *spellindex;
   GtkTextTagTable *tagtable;
   GwSearchWindow *last_focused;
 
@@ -72,6 +72,8 @@ struct _GwSearchWindow* gw_application_get_last_focused_searchwindow (GwApplicat
 LwPreferences* gw_application_get_preferences (GwApplication*);
 struct _GwDictInfoList* gw_application_get_dictinfolist (GwApplication*);
 struct _LwDictInstList* gw_application_get_dictinstlist (GwApplication*);
+LwStrokeDB* gw_application_get_strokedb (GwApplication*, GError**);
+LwSpellIndex* gw_application_get_spellindex (GwApplication*);
 GtkTextTagTable* gw_application_get_tagtable (GwApplication*);
 GtkListStore* gw_application_get_vocabularyliststore (GwApplication*);
 
@@ -15,6 +15,7 @@
 #include <gwaei/dictinfolist.h>
 #include <gwaei/spellcheck.h>
 #include <gwaei/printing.h>
+#include <gwaei/resultsview.h>
 
 #include <gwaei/window.h>
 #include <gwaei/searchwindow.h>
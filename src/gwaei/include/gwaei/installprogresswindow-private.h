@@ -4,7 +4,7 @@
 G_BEGIN_DECLS
 
 struct _GwInstallProgressWindowPrivate {
-  LwDictInst *di;
+  gboolean installing;
 
   GtkLabel *label;
   GtkLabel *sublabel;
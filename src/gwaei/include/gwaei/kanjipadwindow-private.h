@@ -15,7 +15,12 @@ struct _GwKanjipadWindowPrivate {
   gboolean instroke;
   char kselected[2];
   char kanji_candidates[GW_KANJIPADWINDOW_MAX_GUESSES][2];
+  gboolean kanji_predicted[GW_KANJIPADWINDOW_MAX_GUESSES];  //!< The candidate has more strokes than are drawn
   int total_candidates;
+  LwStrokeDB *strokedb;       //!< Owned by the application.  NULL when kpengine is used.
+  GThreadPool *pool;          //!< Runs the recognitions off of the main thread
+  LwStrokeDBSession *session; //!< The strokes scored so far.  Only used by the pool thread.
+  gint serial;                //!< Changes with each look up so results for old strokes are dropped
   GPid engine_pid;
   GIOChannel *from_engine;
   GIOChannel *to_engine;
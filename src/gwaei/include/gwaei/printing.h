@@ -1,6 +1,10 @@
 #ifndef GW_PRINTING_INCLUDED
 #define GW_PRINTING_INCLUDED
 
+#define GW_PRINTING_PAGINATE_BUDGET 8 //!< Milliseconds of pagination per main loop dispatch
+#define GW_PRINTING_RESULTS_TOP 10    //!< Millimeters between the top of the page and the results
+#define GW_PRINTING_RESULTS_LEFT 5    //!< Millimeters between the left of the page and the results
+
 G_MODULE_EXPORT void gw_print_preview_cb (GtkWidget*, gpointer);
 G_MODULE_EXPORT void gw_print_cb (GtkWidget*, gpointer);
 
@@ -0,0 +1,50 @@
+#ifndef GW_RESULTSVIEW_PRIVATE_INCLUDED
+#define GW_RESULTSVIEW_PRIVATE_INCLUDED
+
+G_BEGIN_DECLS
+
+//!
+//! @brief A laid out result.  Only the rows near the visible area have one.
+//!
+struct _GwResultsViewRow {
+  PangoLayout *layout;
+  GArray *links;            //!< GwResultsViewLink spans of the row text
+};
+typedef struct _GwResultsViewRow GwResultsViewRow;
+
+struct _GwResultsViewLink {
+  gint start;               //!< Byte offset into the row text
+  gint end;
+  gchar *vocabulary_data;
+};
+typedef struct _GwResultsViewLink GwResultsViewLink;
+
+struct _GwResultsViewPrivate {
+  LwResultList *results;
+  LwResultLine *resultline;   //!< Scratch space for rebuilding stored results
+  LwDictType type;
+  GArray *lines;              //!< The line each row starts at.  The last element is the line total.
+  GtkTextTagTable *tagtable;
+
+  GHashTable *rows;           //!< Laid out rows by index
+  gint line_height;
+  gint ascent;
+  gint width;                 //!< Widest row laid out so far
+  gint press_x;
+  gint press_y;
+  gint press_row;             //!< Row the first button went down on or -1
+
+  gint selection_anchor;      //!< Row the selection was started from or -1 when nothing is selected
+  gint selection_cursor;      //!< Row the selection was extended to
+
+  GtkAdjustment *hadjustment;
+  GtkAdjustment *vadjustment;
+  guint hscroll_policy : 1;
+  guint vscroll_policy : 1;
+};
+
+#define GW_RESULTSVIEW_GET_PRIVATE(object)(G_TYPE_INSTANCE_GET_PRIVATE ((object), GW_TYPE_RESULTSVIEW, GwResultsViewPrivate))
+
+G_END_DECLS
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef GW_RESULTSVIEW_INCLUDED
+#define GW_RESULTSVIEW_INCLUDED
+
+G_BEGIN_DECLS
+
+typedef enum {
+  GW_RESULTSVIEW_CLASS_SIGNALID_KANJI_ACTIVATED,
+  GW_RESULTSVIEW_CLASS_SIGNALID_VOCABULARY_ACTIVATED,
+  TOTAL_GW_RESULTSVIEW_CLASS_SIGNALIDS
+} GwResultsViewClassSignalId;
+
+//Boilerplate
+typedef struct _GwResultsView GwResultsView;
+typedef struct _GwResultsViewClass GwResultsViewClass;
+typedef struct _GwResultsViewPrivate GwResultsViewPrivate;
+
+#define GW_TYPE_RESULTSVIEW              (gw_resultsview_get_type())
+#define GW_RESULTSVIEW(obj)              (G_TYPE_CHECK_INSTANCE_CAST((obj), GW_TYPE_RESULTSVIEW, GwResultsView))
+#define GW_RESULTSVIEW_CLASS(klass)      (G_TYPE_CHECK_CLASS_CAST((klass), GW_TYPE_RESULTSVIEW, GwResultsViewClass))
+#define GW_IS_RESULTSVIEW(obj)           (G_TYPE_CHECK_INSTANCE_TYPE((obj), GW_TYPE_RESULTSVIEW))
+#define GW_IS_RESULTSVIEW_CLASS(klass)   (G_TYPE_CHECK_CLASS_TYPE ((klass), GW_TYPE_RESULTSVIEW))
+#define GW_RESULTSVIEW_GET_CLASS(obj)    (G_TYPE_INSTANCE_GET_CLASS((obj), GW_TYPE_RESULTSVIEW, GwResultsViewClass))
+
+#define GW_RESULTSVIEW_OVERSCAN 10 //!< Rows laid out past each edge of the visible area
+#define GW_RESULTSVIEW_MARGIN 10
+
+struct _GwResultsView {
+  GtkDrawingArea area;
+  GwResultsViewPrivate *priv;
+};
+
+struct _GwResultsViewClass {
+  GtkDrawingAreaClass parent_class;
+  guint signalid[TOTAL_GW_RESULTSVIEW_CLASS_SIGNALIDS];
+  void (*kanji_activated) (GwResultsView *view, guint character, gint x_root, gint y_root);
+  void (*vocabulary_activated) (GwResultsView *view, const gchar *vocabulary_data);
+};
+
+GtkWidget* gw_resultsview_new (GtkTextTagTable*);
+GType gw_resultsview_get_type (void) G_GNUC_CONST;
+
+void gw_resultsview_reset (GwResultsView*, LwSearchItem*);
+void gw_resultsview_append (GwResultsView*, LwResultLine*);
+guint gw_resultsview_get_length (GwResultsView*);
+gchar* gw_resultsview_get_text (GwResultsView*);
+
+gboolean gw_resultsview_has_selection (GwResultsView*);
+void gw_resultsview_select_all (GwResultsView*);
+void gw_resultsview_select_none (GwResultsView*);
+void gw_resultsview_copy_clipboard (GwResultsView*, GtkClipboard*);
+
+G_END_DECLS
+
+#endif
@@ -5,6 +5,7 @@
 
 struct _GwSearchData {
   GtkTextView *view;
+  GwResultsView *resultsview;   //!< Set instead of the view for list view tabs
   GwSearchWindow *window;
   LwResultLine *resultline;
 };
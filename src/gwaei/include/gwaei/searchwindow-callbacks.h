@@ -17,6 +17,7 @@ void gw_searchwindow_copy_cb (GtkWidget *widget, gpointer data);
 void gw_searchwindow_about_cb (GtkWidget *widget, gpointer data);
 void gw_searchwindow_destroy_cb (GObject*, gpointer);
 void gw_searchwindow_search_cb (GtkWidget *widget, gpointer data);
+void gw_searchwindow_analyze_text_cb (GtkWidget *widget, gpointer data);
 void gw_searchwindow_search_from_history_cb (GtkWidget*, gpointer);
 void gw_searchwindow_clear_search_cb (GtkWidget*, gpointer);
 void gw_searchwindow_update_button_states_based_on_entry_text_cb (GtkWidget*, gpointer);
@@ -78,6 +79,8 @@ gboolean gw_searchwindow_focus_in_event_cb (GtkWidget*, GdkEvent*, gpointer);
 void gw_searchwindow_event_after_cb (GtkWidget*, GdkEvent*, gpointer);
 
 gboolean gw_searchwindow_motion_notify_event_cb (GtkWidget*, GdkEventButton*, gpointer);
+void gw_searchwindow_kanji_activated_cb (GwResultsView*, guint, gint, gint, gpointer);
+void gw_searchwindow_vocabulary_activated_cb (GwResultsView*, const gchar*, gpointer);
 
 #endif
 
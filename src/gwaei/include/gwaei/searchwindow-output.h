@@ -2,7 +2,9 @@
 #define GW_SEARCHWINDOW_OUTPUT_INCLUDED
 
 void gw_searchwindow_append_result (GwSearchWindow*, LwSearchItem*);
+void gw_searchwindow_append_results (GwSearchWindow*, LwSearchItem*, gint64);
 void gw_searchwindow_append_kanjidict_tooltip_result (GwSearchWindow*, LwSearchItem*);
 void gw_searchwindow_display_no_results_found_page (GwSearchWindow*, LwSearchItem*);
+void gw_searchwindow_display_analysis (GwSearchWindow*, GtkTextView*, LwTextAnalyzer*, GList*);
 
 #endif
@@ -4,9 +4,7 @@
 G_BEGIN_DECLS
 
 typedef enum {
-  GW_SEARCHWINDOW_TIMEOUTID_PROGRESS,
   GW_SEARCHWINDOW_TIMEOUTID_KEEP_SEARCHING,
-  GW_SEARCHWINDOW_TIMEOUTID_APPEND_RESULT,
   TOTAL_GW_SEARCHWINDOW_TIMEOUTIDS
 } GwSearchWindowTimeoutId;
 
@@ -52,6 +50,7 @@ struct _GwSearchWindowPrivate {
   LwSearchItem *feedback_item;
   long feedback;
   LwSearchStatus feedback_status;
+  gdouble render_cost;      //!< Running average of microseconds to render a result
 
   //Mouse variables
   LwSearchItem *mouse_item;
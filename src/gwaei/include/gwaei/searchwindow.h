@@ -18,6 +18,10 @@ typedef struct _GwSearchWindowPrivate GwSearchWindowPrivate;
 #define GW_SEARCHWINDOW_GET_CLASS(obj)    (G_TYPE_INSTANCE_GET_CLASS((obj), GW_TYPE_SEARCHWINDOW, GwSearchWindowClass))
 
 #define GW_SEARCHWINDOW_KEEP_SEARCHING_MAX_DELAY 3
+#define GW_SEARCHWINDOW_FRAME_BUDGET 8 //!< Milliseconds of result appending per main loop dispatch
+#define GW_SEARCHWINDOW_FIRST_RUN 16 //!< Results in a run before the cost per result is known
+#define GW_SEARCHWINDOW_MAX_RUN 1000
+#define GW_SEARCHWINDOW_RUN_PREALLOCATE 4096
 
 struct _GwSearchWindow {
   GwWindow window;
@@ -31,7 +35,9 @@ struct _GwSearchWindowClass {
 GtkWindow* gw_searchwindow_new (GtkApplication *application);
 GType gw_searchwindow_get_type (void) G_GNUC_CONST;
 
-gboolean gw_searchwindow_update_progress_feedback_timeout (GwSearchWindow*);
+void gw_searchwindow_update_progress_feedback (GwSearchWindow*);
+gboolean gw_searchwindow_append_result_watch (LwSearchItem*, gpointer);
+gboolean gw_searchwindow_append_kanjidict_tooltip_watch (LwSearchItem*, gpointer);
 gboolean gw_searchwindow_update_icons_for_selection_timeout (GwSearchWindow*);
 gboolean gw_searchwindow_keep_searching_timeout (GwSearchWindow*);
 
@@ -103,6 +109,12 @@ void gw_searchwindow_set_color_to_swatch (GwSearchWindow*, const char*, const ch
 void gw_searchwindow_guarantee_first_tab (GwSearchWindow*);
 
 GtkTextView* gw_searchwindow_get_current_textview (GwSearchWindow*);
+GwResultsView* gw_searchwindow_get_current_resultsview (GwSearchWindow*);
+GtkWidget* gw_searchwindow_get_current_view (GwSearchWindow*);
+GtkTextView* gw_searchwindow_guarantee_current_textview (GwSearchWindow*);
+
+void gw_searchwindow_lookup_kanji (GwSearchWindow*, gunichar, gint, gint);
+void gw_searchwindow_add_vocabulary (GwSearchWindow*, const gchar*);
 
 void gw_searchwindow_set_tab_text_by_searchitem (GwSearchWindow*, LwSearchItem*);
 void gw_searchwindow_set_current_searchitem (GwSearchWindow*, LwSearchItem*);
@@ -1,6 +1,9 @@
 #ifndef GW_SPELLCHECK_INCLUDED
 #define GW_SPELLCHECK_INCLUDED
 
+#define GW_SPELLCHECK_MIN_WORD_LENGTH 3    //!< Shorter words are never marked
+#define GW_SPELLCHECK_MAX_SUGGESTIONS 8    //!< Most replacements offered for a word
+
 typedef enum {
   GW_SPELLCHECK_SIGNALID_DRAW,
   GW_SPELLCHECK_SIGNALID_CHANGED,
@@ -19,7 +22,10 @@ struct _GwSpellcheck {
   GtkEntry *entry;
   GList *corrections;
   GMutex *mutex;
-  GThread *thread;
+  GThreadPool *pool;          //!< A single thread that checks the queries in order
+  gboolean has_enchant;
+  FILE *enchant_in;           //!< The pipes of the enchant coprocess or NULL when it isn't running
+  FILE *enchant_out;
   gboolean needs_spellcheck;
   char* query_text;
   gboolean sensitive;
@@ -48,17 +54,19 @@ struct _SpellingReplacementData {
 };
 typedef struct _SpellingReplacementData _SpellingReplacementData;
 
-struct _GwSpellcheckStreamWithData {
+//!
+//! @brief A query handed to the spellcheck thread
+//!
+struct _GwSpellcheckJob {
     GwSpellcheck *spellcheck;
-    int stream;
-    gpointer data;
-    int length;
-    GPid pid;
+    char *query;
+    LwSpellIndex *spellindex;
+    gchar **paths;            //!< The dictionaries to load the spellindex from or NULL if it is loaded
 };
-typedef struct _GwSpellcheckStreamWithData GwSpellcheckStreamWithData;
+typedef struct _GwSpellcheckJob GwSpellcheckJob;
 
-GwSpellcheckStreamWithData* gw_spellcheck_streamwithdata_new (GwSpellcheck*, int, const char*, int, GPid);
-void gw_spellcheck_streamwithdata_free (GwSpellcheckStreamWithData*);
+GwSpellcheckJob* gw_spellcheck_job_new (GwSpellcheck*, const char*, LwSpellIndex*, gchar**);
+void gw_spellcheck_job_free (GwSpellcheckJob*);
 
 #include <gwaei/spellcheck-callbacks.h>
 
@@ -7,8 +7,11 @@ struct _GwVocabularyWordStorePrivate {
   gchar* name;
   gchar* filename;
   LwVocabularyList *vocabulary_list;
+  GList *changed_rows;             //!< GtkTreeRowReferences of the rows shown as changed
   gboolean has_changes;
   gboolean loaded;
+  GList *fill_link;                //!< The next item of the list to add a row for while loading
+  guint fillid;                    //!< Idle source adding the rows or 0
 };
 
 #define GW_VOCABULARYWORDSTORE_GET_PRIVATE(object)(G_TYPE_INSTANCE_GET_PRIVATE ((object), GW_TYPE_VOCABULARYWORDSTORE, GwVocabularyWordStorePrivate))
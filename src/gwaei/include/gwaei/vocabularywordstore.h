@@ -13,6 +13,7 @@ typedef enum {
   GW_VOCABULARYWORDSTORE_COLUMN_FURIGANA,
   GW_VOCABULARYWORDSTORE_COLUMN_DEFINITIONS,
   GW_VOCABULARYWORDSTORE_COLUMN_CHANGED,
+  GW_VOCABULARYWORDSTORE_COLUMN_ITEM,
   TOTAL_GW_VOCABULARYWORDSTORE_COLUMNS
 } GwVocabularyWordStoreColumn;
 
@@ -28,6 +29,9 @@ typedef struct _GwVocabularyWordStorePrivate GwVocabularyWordStorePrivate;
 #define GW_IS_VOCABULARYWORDSTORE_CLASS(klass)            (G_TYPE_CHECK_CLASS_TYPE ((klass), GW_TYPE_VOCABULARYWORDSTORE))
 #define GW_VOCABULARYWORDSTORE_GET_CLASS(obj)    (G_TYPE_INSTANCE_GET_CLASS((obj), GW_TYPE_VOCABULARYWORDSTORE, GwVocabularyWordStoreClass))
 
+#define GW_VOCABULARYWORDSTORE_FIRST_PAGE 200 //!< Rows added right away when a list is loaded
+#define GW_VOCABULARYWORDSTORE_FILL_BUDGET 8  //!< Milliseconds of adding the other rows per main loop dispatch
+
 struct _GwVocabularyWordStore {
   GtkListStore model;
   GwVocabularyWordStorePrivate *priv;
@@ -39,6 +43,22 @@ struct _GwVocabularyWordStoreClass {
   void (*changed) (GwVocabularyWordStore *store);
 };
 
+//!
+//! @brief A lookup of the words of a store in the EDICT dictionaries.  It is made
+//!        and applied in the main thread, and run from any thread in between.
+//!
+struct _GwVocabularyWordStoreLookup {
+  GwVocabularyWordStore *store;
+  LwBatchLookup *batchlookup;
+  GPtrArray *rows;                //!< GtkTreeRowReference of each word added to the batchlookup
+  GList *dictionaries;            //!< The EDICT LwDictInfos to look in
+  LwIoProgressCallback cb;
+  gpointer data;
+  gint current;                   //!< Index of the dictionary being read
+  gint total;
+};
+typedef struct _GwVocabularyWordStoreLookup GwVocabularyWordStoreLookup;
+
 //Methods
 GtkListStore* gw_vocabularywordstore_new (const gchar*);
 GType gw_vocabularywordstore_get_type (void) G_GNUC_CONST;
@@ -46,6 +66,7 @@ GType gw_vocabularywordstore_get_type (void) G_GNUC_CONST;
 void gw_vocabularywordstore_save (GwVocabularyWordStore*);
 void gw_vocabularywordstore_load (GwVocabularyWordStore*);
 gboolean gw_vocabularywordstore_loaded (GwVocabularyWordStore*);
+void gw_vocabularywordstore_finish_loading (GwVocabularyWordStore*);
 const gchar* gw_vocabularywordstore_get_name (GwVocabularyWordStore*);
 gchar* gw_vocabularywordstore_get_filename (GwVocabularyWordStore*);
 gboolean gw_vocabularywordstore_file_exists (GwVocabularyWordStore*);
@@ -61,6 +82,12 @@ void gw_vocabularywordstore_new_word (GwVocabularyWordStore*, GtkTreeIter*, GtkT
 void gw_vocabularywordstore_set_string (GwVocabularyWordStore*, GtkTreeIter*, gint, const gchar*);
 gchar* gw_vocabularywordstore_iter_to_string (GwVocabularyWordStore*, GtkTreeIter*);
 
+GwVocabularyWordStoreLookup* gw_vocabularywordstore_lookup_new (GwVocabularyWordStore*, LwDictInfoList*);
+void gw_vocabularywordstore_lookup_free (GwVocabularyWordStoreLookup*);
+gboolean gw_vocabularywordstore_lookup_run (GwVocabularyWordStoreLookup*, LwIoProgressCallback, gpointer, GError**);
+gint gw_vocabularywordstore_lookup_apply (GwVocabularyWordStoreLookup*);
+gint gw_vocabularywordstore_lookup_get_total_words (GwVocabularyWordStoreLookup*);
+
 G_END_DECLS
 
 #endif
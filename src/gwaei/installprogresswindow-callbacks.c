@@ -63,7 +63,7 @@ gw_installprogresswindow_update_dictinst_cb (double fraction, gpointer data)
     priv = window->priv;
 
     g_mutex_lock (priv->mutex); 
-    priv->install_fraction = lw_dictinst_get_total_progress (priv->di, fraction);
+    priv->install_fraction = fraction;
     g_mutex_unlock (priv->mutex);
 
     return 0;
@@ -89,9 +89,10 @@ gw_installprogresswindow_update_ui_timeout (gpointer data)
     GwDictInfoList *dictinfolist;
     LwDictInst *di;
     GList *iter;
-    int current_to_install;
     int total_to_install;
-    char *text_installing;
+    GString *filenames;
+    GString *statuses;
+    char *status;
     char *text_installing_markup;
     char *text_left;
     char *text_left_markup;
@@ -103,11 +104,10 @@ gw_installprogresswindow_update_ui_timeout (gpointer data)
     application = gw_window_get_application (GW_WINDOW (window));
     dictinstlist = gw_application_get_dictinstlist (application);
     priv = window->priv;
-    current_to_install = 0;
     total_to_install = 0;
 
     //The install is complete close the window
-    if (priv->di == NULL)
+    if (!priv->installing)
     {
       settingswindow = gtk_window_get_transient_for (GTK_WINDOW (window));
       dictinfolist = gw_application_get_dictinfolist (application);
@@ -126,34 +126,30 @@ gw_installprogresswindow_update_ui_timeout (gpointer data)
 
     g_mutex_lock (priv->mutex);
 
-    //Calculate the number of dictionaries left to install
-    for (iter = dictinstlist->list; iter != NULL; iter = iter->next)
-    {
-      di = LW_DICTINST (iter->data);
-      if (di != NULL && di->selected)
-      {
-        current_to_install++;
-      }
-      if (iter->data == priv->di) break;
-    }
+    filenames = g_string_new (NULL);
+    statuses = g_string_new (NULL);
 
-    //Calculate the number of dictionaries left to install
+    //Several dictionaries can be installing at once so list every active one
     for (iter = dictinstlist->list; iter != NULL; iter = iter->next)
     {
       di = LW_DICTINST (iter->data);
-      if (di->selected)
-      {
-        total_to_install++;
-      }
+      if (di == NULL || !di->selected) continue;
+      total_to_install++;
+      if (di->uri_group_index < LW_DICTINST_NEEDS_DOWNLOADING) continue;
+
+      if (filenames->len > 0) g_string_append (filenames, ", ");
+      g_string_append (filenames, di->filename);
+
+      status = lw_dictinst_get_status_string (di, TRUE);
+      if (statuses->len > 0) g_string_append_c (statuses, '\n');
+      g_string_append (statuses, status);
+      g_free (status);
     }
-    
-    di = priv->di;
 
-    text_progressbar =  g_markup_printf_escaped (gettext("Installing %s..."), di->filename);
-    text_left = g_strdup_printf (gettext("Installing dictionary %d of %d..."), current_to_install, total_to_install);
+    text_progressbar =  g_markup_printf_escaped (gettext("Installing %s..."), filenames->str);
+    text_left = g_strdup_printf (ngettext("Installing %d dictionary...", "Installing %d dictionaries...", total_to_install), total_to_install);
     text_left_markup = g_markup_printf_escaped ("<big><b>%s</b></big>", text_left);
-    text_installing = lw_dictinst_get_status_string (di, TRUE);
-    text_installing_markup = g_markup_printf_escaped ("<small>%s</small>", text_installing);
+    text_installing_markup = g_markup_printf_escaped ("<small>%s</small>", statuses->str);
 
     gtk_label_set_markup (priv->label, text_left_markup);
     gtk_label_set_markup (priv->sublabel, text_installing_markup);
@@ -166,8 +162,9 @@ gw_installprogresswindow_update_ui_timeout (gpointer data)
     g_free (text_progressbar);
     g_free (text_left);
     g_free (text_left_markup);
-    g_free (text_installing);
     g_free (text_installing_markup);
+    g_string_free (filenames, TRUE);
+    g_string_free (statuses, TRUE);
 
     return TRUE;
 }
@@ -176,8 +176,6 @@ static gpointer _installprogresswindow_install_thread (gpointer data)
     GwInstallProgressWindowPrivate *priv;
     GwApplication *application;
     LwDictInstList *dictinstlist;
-    GList *iter;
-    LwDictInst *di;
     GError *error;
 
     //Initializations
@@ -188,26 +186,20 @@ static gpointer _installprogresswindow_install_thread (gpointer data)
     dictinstlist = gw_application_get_dictinstlist (application);
     error = NULL;
 
+    g_mutex_lock (priv->mutex);
+    priv->installing = TRUE;
+    g_mutex_unlock (priv->mutex);
+
     //Do the installation
     g_timeout_add (100, gw_installprogresswindow_update_ui_timeout, window);
-    for (iter = dictinstlist->list; iter != NULL && error == NULL; iter = iter->next)
-    {
-      di = LW_DICTINST (iter->data);
-      if (di->selected)
-      {
-        g_mutex_lock (priv->mutex);
-        priv->di = di;
-        g_mutex_unlock (priv->mutex);
-        lw_dictinst_install (di, gw_installprogresswindow_update_dictinst_cb, window, &error);
-      }
-    }
+    lw_dictinstlist_install (dictinstlist, LW_DICTINSTLIST_MAX_CONCURRENT, gw_installprogresswindow_update_dictinst_cb, window, &error);
 
     gw_application_set_error (application, error);
     error = NULL;
 
     g_mutex_lock (priv->mutex);
     //This will clue the progress window to close itself
-    priv->di = NULL;
+    priv->installing = FALSE;
     g_mutex_unlock (priv->mutex);
 
     return NULL;
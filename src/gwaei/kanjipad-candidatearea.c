@@ -140,6 +140,7 @@ static void _kanjipadwindow_draw_candidate_character (GwKanjipadWindow *window,
     GdkRGBA bgcolorn;
     GdkRGBA fgcolors;
     GdkRGBA bgcolors;
+    gdouble alpha;
 
     //Initializations
     priv = window->priv;
@@ -179,10 +180,13 @@ static void _kanjipadwindow_draw_candidate_character (GwKanjipadWindow *window,
     layout = gtk_widget_create_pango_layout (GTK_WIDGET (priv->candidates), string_utf);
     g_free (string_utf);
     
+    //Suggestions that need more strokes are faded until they are drawn
+    alpha = (priv->kanji_predicted[index]) ? 0.5 : 1.0;
+
     if (selected >= 0 && selected)
-      cairo_set_source_rgba (cr, fgcolors.red, fgcolors.green, fgcolors.blue, 1.0);
+      cairo_set_source_rgba (cr, fgcolors.red, fgcolors.green, fgcolors.blue, alpha);
     else
-      cairo_set_source_rgba (cr, fgcolorn.red, fgcolorn.green, fgcolorn.blue, 1.0);
+      cairo_set_source_rgba (cr, fgcolorn.red, fgcolorn.green, fgcolorn.blue, alpha);
 
     pango_cairo_update_layout (cr, layout);
     pango_cairo_show_layout (cr, layout);
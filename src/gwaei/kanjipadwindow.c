@@ -45,6 +45,20 @@
 
 static void _kanjipadwindow_initialize_engine (GwKanjipadWindow*);
 static gboolean _kanjipadwindow_engine_input_handler (GIOChannel*, GIOCondition, gpointer);
+static void _kanjipadwindow_recognize_func (gpointer, gpointer);
+
+//!
+//! @brief A copy of the strokes to recognize in the thread pool and the results
+//!
+struct _GwKanjipadJob {
+  GwKanjipadWindow *window;
+  gint serial;
+  LwStroke strokes[LW_STROKEDB_MAX_STROKES];
+  gint total_strokes;
+  LwStrokeDBCandidate candidates[GW_KANJIPADWINDOW_MAX_GUESSES];
+  gint total_candidates;
+};
+typedef struct _GwKanjipadJob GwKanjipadJob;
 
 G_DEFINE_TYPE (GwKanjipadWindow, gw_kanjipadwindow, GW_TYPE_WINDOW)
 
@@ -87,6 +101,13 @@ void gw_kanjipadwindow_finalize (GObject *object)
     priv = window->priv;
     error = NULL;
 
+    //Jobs keep a reference to the window so the pool is idle by now
+    if (priv->pool != NULL) g_thread_pool_free (priv->pool, TRUE, TRUE);
+    priv->pool = NULL;
+    if (priv->session != NULL) lw_strokedb_session_free (priv->session);
+    priv->session = NULL;
+    priv->strokedb = NULL;
+
     if (g_main_current_source () != NULL &&
         !g_source_is_destroyed (g_main_current_source ()) &&
         priv->iowatchid > 0
@@ -100,21 +121,21 @@ void gw_kanjipadwindow_finalize (GObject *object)
     }
     priv->iowatchid = 0;
 
-    if (error == NULL) 
+    if (error == NULL && priv->from_engine != NULL) 
     {
       g_io_channel_shutdown (priv->from_engine, FALSE, &error);
       g_io_channel_unref (priv->from_engine);
       priv->from_engine = NULL;
     }
 
-    if (error == NULL)
+    if (error == NULL && priv->to_engine != NULL)
     {
       g_io_channel_shutdown (priv->to_engine, FALSE, &error);
       g_io_channel_unref (priv->to_engine);
       priv->to_engine = NULL;
     }
 
-    g_spawn_close_pid (priv->engine_pid);
+    if (priv->engine_pid != 0) g_spawn_close_pid (priv->engine_pid);
 
     if (error != NULL)
     {
@@ -181,13 +202,15 @@ gw_kanjipadwindow_class_init (GwKanjipadWindowClass *klass)
 
 
 //!
-//! @brief Open the connection to the engine
+//! @brief Gets the recognizer ready.  The strokes are scored in this process
+//!        unless the kpengine compatibility preference is set.
 //!
 static void _kanjipadwindow_initialize_engine (GwKanjipadWindow *window)
 {
     //Declarations
     GwApplication *application;
     GwKanjipadWindowPrivate *priv;
+    LwPreferences *preferences;
     char *dir;
     char *path;
     char *argv[2];
@@ -197,8 +220,25 @@ static void _kanjipadwindow_initialize_engine (GwKanjipadWindow *window)
 
     //Initializations
     application = gw_window_get_application (GW_WINDOW (window));
+    preferences = gw_application_get_preferences (application);
     priv = window->priv;
     error = NULL;
+
+    if (!lw_preferences_get_boolean_by_schema (preferences, LW_SCHEMA_BASE, LW_KEY_KANJIPAD_ENGINE_PROCESS))
+    {
+      priv->strokedb = gw_application_get_strokedb (application, &error);
+      if (priv->strokedb != NULL)
+        priv->pool = g_thread_pool_new (_kanjipadwindow_recognize_func, NULL, 1, FALSE, &error);
+      if (priv->pool != NULL)
+        priv->session = lw_strokedb_session_new (priv->strokedb);
+      if (error != NULL)
+      {
+        gw_application_handle_error (application, GTK_WINDOW (window), TRUE, &error);
+        priv->strokedb = NULL;
+      }
+      return;
+    }
+
     dir = g_get_current_dir ();
 #ifdef G_OS_WIN32
     path = g_build_filename (dir, "..", "lib", PACKAGE, "kpengine.exe", NULL);
@@ -288,6 +328,7 @@ static gboolean _kanjipadwindow_engine_input_handler (GIOChannel *source, GIOCon
         }
         priv->kanji_candidates[i][0] = t1;
         priv->kanji_candidates[i][1] = t2;
+        priv->kanji_predicted[i] = FALSE;
         while (*p && !isspace(*p)) p++;
       }
       priv->total_candidates = i + 1;
@@ -300,3 +341,193 @@ static gboolean _kanjipadwindow_engine_input_handler (GIOChannel *source, GIOCon
     return TRUE;
 }
 
+
+
+//!
+//! @brief Shows the candidates of a finished job if they are still for the current strokes
+//!
+static gboolean _kanjipadwindow_recognize_done (gpointer data)
+{
+    //Declarations
+    GwKanjipadJob *job;
+    GwKanjipadWindow *window;
+    GwKanjipadWindowPrivate *priv;
+    int i;
+
+    //Initializations
+    job = data;
+    window = job->window;
+    priv = window->priv;
+
+    if (job->serial == g_atomic_int_get (&priv->serial) && gtk_widget_get_visible (GTK_WIDGET (window)))
+    {
+      for (i = 0; i < job->total_candidates && i < GW_KANJIPADWINDOW_MAX_GUESSES; i++)
+      {
+        priv->kanji_candidates[i][0] = job->candidates[i].jis[0];
+        priv->kanji_candidates[i][1] = job->candidates[i].jis[1];
+        priv->kanji_predicted[i] = (job->candidates[i].strokes > job->total_strokes);
+      }
+      priv->total_candidates = i;
+
+      gw_kanjipadwindow_draw_candidates (window);
+    }
+
+    //Cleanup
+    g_object_unref (window);
+    g_free (job);
+
+    return FALSE;
+}
+
+
+//!
+//! @brief Checks if the strokes of the session are the first strokes of a job
+//!
+static gboolean _kanjipadwindow_session_is_prefix (LwStrokeDBSession *session, GwKanjipadJob *job)
+{
+    //Declarations
+    LwStroke *a;
+    LwStroke *b;
+    int i;
+
+    if (session->total_strokes > job->total_strokes) return FALSE;
+
+    for (i = 0; i < session->total_strokes; i++)
+    {
+      a = &session->strokes[i];
+      b = &job->strokes[i];
+      if (a->length != b->length) return FALSE;
+      if (memcmp (a->x, b->x, a->length) != 0 || memcmp (a->y, b->y, a->length) != 0) return FALSE;
+    }
+
+    return TRUE;
+}
+
+
+//!
+//! @brief Scores a job in the thread pool.  Jobs that were replaced by newer strokes are skipped.
+//!        The session only has to score the strokes added since the last job, so the
+//!        suggestions can be updated after every stroke.
+//!
+static void _kanjipadwindow_recognize_func (gpointer data, gpointer user_data)
+{
+    //Declarations
+    GwKanjipadJob *job;
+    GwKanjipadWindowPrivate *priv;
+    LwStrokeDBSession *session;
+    int i;
+
+    //Initializations
+    job = data;
+    priv = job->window->priv;
+    session = priv->session;
+
+    if (job->serial == g_atomic_int_get (&priv->serial))
+    {
+      //The pad was cleared or a stroke changed
+      if (!_kanjipadwindow_session_is_prefix (session, job))
+        lw_strokedb_session_clear (session);
+
+      for (i = session->total_strokes; i < job->total_strokes; i++)
+        lw_strokedb_session_add_stroke (session, &job->strokes[i]);
+
+      job->total_candidates = lw_strokedb_session_get_candidates (session, 
+                                                                  job->candidates, 
+                                                                  GW_KANJIPADWINDOW_MAX_GUESSES);
+    }
+
+    g_idle_add (_kanjipadwindow_recognize_done, job);
+}
+
+
+//!
+//! @brief Writes the strokes to kpengine.  The answer comes back through _kanjipadwindow_engine_input_handler.
+//!
+static void _kanjipadwindow_send_to_engine (GwKanjipadWindow *window)
+{
+    //Declarations
+    GwKanjipadWindowPrivate *priv;
+    GList *iter;
+    GList *inner_iter;
+    GString *message;
+    GError *error;
+    gint16 x;
+    gint16 y;
+
+    //Initializations
+    priv = window->priv;
+    if (priv->to_engine == NULL) return;
+    message = g_string_new (NULL);
+    error = NULL;
+      
+    for (iter = priv->strokes; iter != NULL; iter = iter->next)
+    {
+      for (inner_iter = iter->data; inner_iter != NULL; inner_iter = inner_iter->next)
+      {
+        x = ((GdkPoint*) inner_iter->data)->x;
+        y = ((GdkPoint*) inner_iter->data)->y;
+        g_string_append_printf (message, "%d %d ", x, y);
+      }
+      g_string_append (message, "\n");
+    }
+    g_string_append (message, "\n");
+
+    if (g_io_channel_write_chars (priv->to_engine, message->str, message->len, NULL, &error) != G_IO_STATUS_NORMAL)
+    {
+      fprintf (stderr, "Cannot write message to engine: %s\n", error->message);
+      exit (EXIT_FAILURE);
+    }
+
+    if (g_io_channel_flush (priv->to_engine, &error) != G_IO_STATUS_NORMAL)
+    {
+      fprintf (stderr, "Error flushing message to engine: %s\n", error->message);
+      exit (EXIT_FAILURE);
+    }
+
+    g_string_free (message, TRUE);
+}
+
+
+//!
+//! @brief Starts recognizing the strokes drawn so far
+//! @param window A GwKanjipadWindow
+//!
+void gw_kanjipadwindow_look_up (GwKanjipadWindow *window)
+{
+    //Declarations
+    GwKanjipadWindowPrivate *priv;
+    GwKanjipadJob *job;
+    LwStroke *stroke;
+    GdkPoint *point;
+    GList *iter;
+    GList *inner_iter;
+
+    //Initializations
+    priv = window->priv;
+
+    if (priv->pool == NULL)
+    {
+      _kanjipadwindow_send_to_engine (window);
+      return;
+    }
+
+    job = g_new0 (GwKanjipadJob, 1);
+    job->window = GW_KANJIPADWINDOW (g_object_ref (window));
+    g_atomic_int_inc (&priv->serial);
+    job->serial = g_atomic_int_get (&priv->serial);
+
+    for (iter = priv->strokes; iter != NULL && job->total_strokes < LW_STROKEDB_MAX_STROKES; iter = iter->next)
+    {
+      stroke = &job->strokes[job->total_strokes];
+      for (inner_iter = iter->data; inner_iter != NULL && stroke->length < LW_STROKEDB_MAX_POINTS; inner_iter = inner_iter->next)
+      {
+        point = (GdkPoint*) inner_iter->data;
+        stroke->x[stroke->length] = point->x;
+        stroke->y[stroke->length] = point->y;
+        stroke->length++;
+      }
+      job->total_strokes++;
+    }
+
+    g_thread_pool_push (priv->pool, job, NULL);
+}
@@ -42,11 +42,14 @@
 static GtkPrintSettings *_settings = NULL;
 
 //!
-//! @brief Primitive for storing information on printing
+//! @brief Primitive for storing information on printing.  A page runs from a
+//!        line of one of the cached layouts to a line of another one.
 //!
 typedef struct GwPageInfo {
-    GtkTextIter start; //!< pages GList of all the created pages
-    GtkTextIter end;   //!< Mark in the buffer where we have paginated to
+    guint start_layout; //!< Index of the layout the page starts in
+    gint start_line;    //!< Line of that layout the page starts at
+    guint end_layout;   //!< Index of the layout the next page starts in
+    gint end_line;      //!< Line of that layout the next page starts at
 } GwPageInfo;
 
 #define GW_PAGEINFO(object) (GwPageInfo*)object
@@ -54,7 +57,7 @@ typedef struct GwPageInfo {
 //!
 //! @brief Allocates a new GwPageInfo object
 //!
-GwPageInfo* gw_pageinfo_new (GtkTextIter start, GtkTextIter end)
+GwPageInfo* gw_pageinfo_new (guint start_layout, gint start_line)
 {
     GwPageInfo *temp;
 
@@ -62,8 +65,10 @@ GwPageInfo* gw_pageinfo_new (GtkTextIter start, GtkTextIter end)
 
     if (temp != NULL)
     {
-      temp->start = start;
-      temp->end = end;
+      temp->start_layout = start_layout;
+      temp->start_line = start_line;
+      temp->end_layout = start_layout;
+      temp->end_line = start_line;
     }
 
     //Finish
@@ -80,9 +85,18 @@ void gw_pageinfo_free (GwPageInfo *pi) {
     free(pi);
 }
 
+//!
+//! @brief The state of a print operation.  Pagination lays each line of the
+//!        text out once and keeps the layouts so drawing the pages reuses them.
+//!
 struct _GwPrintData {
-  GList *pages;
+  GPtrArray *pages;              //!< The GwPageInfo of the pages paginated so far
+  GPtrArray *layouts;            //!< A PangoLayout for each line of the printed text
   GwSearchWindow *window;
+  PangoFontDescription *desc;
+  gchar *text;                   //!< The printed text or NULL before pagination starts
+  const gchar *next;             //!< Start of the first line not laid out yet or NULL at the end
+  gdouble used_height;           //!< Height the lines of the last page take so far
 };
 typedef struct _GwPrintData GwPrintData;
 
@@ -95,8 +109,13 @@ GwPrintData* gw_printdata_new (GwSearchWindow *window)
 
     if (temp != NULL)
     {
-      temp->pages = NULL;
+      temp->pages = g_ptr_array_new_with_free_func ((GDestroyNotify) gw_pageinfo_free);
+      temp->layouts = g_ptr_array_new_with_free_func (g_object_unref);
       temp->window = window;
+      temp->desc = pango_font_description_from_string ("sans 10");
+      temp->text = NULL;
+      temp->next = NULL;
+      temp->used_height = 0.0;
     }
     
     return temp;
@@ -104,18 +123,10 @@ GwPrintData* gw_printdata_new (GwSearchWindow *window)
 
 void gw_printdata_free (GwPrintData *data)
 {
-    //Declarations
-    GList *iter;
-    GwPageInfo *pi;
-
-    for (iter = data->pages; iter != NULL; iter = iter->next)
-    {
-       pi = GW_PAGEINFO (iter->data);
-       if (pi != NULL)
-         gw_pageinfo_free (pi);
-
-    }
-    g_list_free (data->pages);
+    g_ptr_array_free (data->pages, TRUE);
+    g_ptr_array_free (data->layouts, TRUE);
+    if (data->desc != NULL) pango_font_description_free (data->desc);
+    g_free (data->text);
     
     free (data);
 }
@@ -179,7 +190,7 @@ static void _draw_page_number (GtkPrintContext *context, gint page_nr, GwPageInf
     gdouble drawable_width;
 
     //Initializations
-    text = g_strdup_printf (gettext("Page %d/%d"), page_nr + 1, g_list_length (data->pages));
+    text = g_strdup_printf (gettext("Page %d/%d"), page_nr + 1, (gint) data->pages->len);
     layout = gtk_print_context_create_pango_layout (context);
     desc = pango_font_description_from_string ("sans 8");
     cr = gtk_print_context_get_cairo_context (context);
@@ -204,64 +215,104 @@ static void _draw_page_number (GtkPrintContext *context, gint page_nr, GwPageInf
 }
 
  
+//!
+//! @brief Draws the lines of the cached layouts that belong to a page
+//!
 static void _draw_page_results (GtkPrintContext *context, GwPageInfo *page, GwPrintData *data)
 {
     //Declarations
-    GtkTextView *view;
-    GtkTextBuffer *buffer;
     PangoLayout *layout;
-    char *text;
-    PangoFontDescription *desc;
-    int width;
-    int height;
-    gdouble drawable_width, drawable_height;
+    PangoLayoutIter *iter;
+    PangoRectangle logical;
     cairo_t *cr;
-    gint line_start;
-    gint line_end;
+    gdouble y;
+    guint i;
+    gint line;
 
     //Initializations
-    view = gw_searchwindow_get_current_textview (data->window);
-    buffer = gtk_text_view_get_buffer (view);
-    text = gtk_text_buffer_get_text (buffer, &(page->start), &(page->end), FALSE);
-    layout = gtk_print_context_create_pango_layout (context);
-    desc = pango_font_description_from_string ("sans 10");
-    drawable_width = gtk_print_context_get_width (context);
-    drawable_height = gtk_print_context_get_height (context);
     cr = gtk_print_context_get_cairo_context (context);
-    line_start = 0;
-    line_end = 0;
+    y = GW_PRINTING_RESULTS_TOP;
 
     //Draw
-    if (text != NULL)
+    for (i = page->start_layout; i <= page->end_layout && i < data->layouts->len; i++)
     {
-      cairo_move_to (cr, 5, 10);
-      pango_layout_set_font_description (layout, desc);
-      pango_layout_set_markup (layout, text, -1);
-      pango_layout_set_width (layout, drawable_width * PANGO_SCALE);
-      pango_layout_set_alignment (layout, PANGO_ALIGN_LEFT);
-      pango_layout_set_height (layout, drawable_height * PANGO_SCALE);
-      pango_layout_get_size (layout, &width, &height);
-      pango_cairo_show_layout (cr, layout);
-      
-      //Adjust the end GtkTextIter to the cutoff in the visible cairo context
-      line_start = gtk_text_iter_get_line (&page->start);
-      line_end = line_start + pango_layout_get_line_count (layout) - 1;
-      gtk_text_buffer_get_iter_at_line (buffer, &(page->end), line_end);
+      layout = g_ptr_array_index (data->layouts, i);
+      iter = pango_layout_get_iter (layout);
+      line = 0;
+
+      do
+      {
+        if ((i > page->start_layout || line >= page->start_line) && (i < page->end_layout || line < page->end_line))
+        {
+          pango_layout_iter_get_line_extents (iter, NULL, &logical);
+          cairo_move_to (cr, 
+              GW_PRINTING_RESULTS_LEFT + (gdouble) logical.x / PANGO_SCALE, 
+              y + (gdouble) (pango_layout_iter_get_baseline (iter) - logical.y) / PANGO_SCALE);
+          pango_cairo_show_layout_line (cr, pango_layout_iter_get_line_readonly (iter));
+          y += (gdouble) logical.height / PANGO_SCALE;
+        }
+        line++;
+      }
+      while (pango_layout_iter_next_line (iter));
+
+      pango_layout_iter_free (iter);
     }
+}
 
-    //Cleanup
-    if (text != NULL) g_free (text);
-    if (layout != NULL) g_object_unref (layout);
-    if (desc != NULL) pango_font_description_free (desc);
+
+//!
+//! @brief Gets the text to print.  If a section of the results is selected only it
+//!        is printed.  The list view gives the text of its selected rows the same way.
+//!
+static gchar* _get_text (GwPrintData *data)
+{
+    //Declarations
+    gchar *text;
+
+    //Initializations
+    text = gw_searchwindow_get_text (data->window, NULL);
+    if (text == NULL) text = g_strdup ("");
+
+    return text;
+}
+
+
+//!
+//! @brief Lays out the next line of the text for the width of the page
+//!
+static PangoLayout* _layout_next_line (GtkPrintContext *context, GwPrintData *data)
+{
+    //Declarations
+    PangoLayout *layout;
+    const gchar *end;
+
+    //Initializations
+    layout = gtk_print_context_create_pango_layout (context);
+    end = strchr (data->next, '\n');
+
+    pango_layout_set_font_description (layout, data->desc);
+    pango_layout_set_width (layout, (gtk_print_context_get_width (context) - GW_PRINTING_RESULTS_LEFT) * PANGO_SCALE);
+    pango_layout_set_alignment (layout, PANGO_ALIGN_LEFT);
+    pango_layout_set_text (layout, data->next, (end != NULL) ? end - data->next : -1);
+
+    g_ptr_array_add (data->layouts, layout);
+    data->next = (end != NULL) ? end + 1 : NULL;
+
+    return layout;
 }
 
 
 //!
 //! @brief Pagination algorithm to calculate how many pages are needed
-//! @param operation Unused GtkPrintOperation
-//! @param context Pointer co a GtkPrintContext to draw on
-//! @param page_nr Integer of the current page number being draw
-//! @param data Painter to a PageInfo struct to use for information
+//!
+//! Every call lays out lines of the text for GW_PRINTING_PAGINATE_BUDGET
+//! milliseconds and breaks pages where the lines stop fitting.  GTK keeps
+//! calling it from the main loop until it returns TRUE, so the progress
+//! dialog and the windows stay responsive while long results paginate.
+//!
+//! @param operation The GtkPrintOperation to set the number of pages of
+//! @param context Pointer co a GtkPrintContext to lay the text out for
+//! @param data Painter to a GwPrintData struct to cache the layouts and pages in
 //! @return Return true when pagination finishes
 //! @sa _done() _begin_print() draw() _begin_print()
 //!
@@ -269,65 +320,73 @@ static gboolean _paginate (GtkPrintOperation *operation,
                            GtkPrintContext   *context,
                            GwPrintData       *data      )
 {
-    printf("paginate!\n");
-
     //Declarations
     GwPageInfo *page;
-    GwPageInfo *prev_page;
-    GList *iter;
-    GtkTextIter end_bound;
-    GtkTextIter start_bound;
-    GtkTextView *view;
-    GtkTextBuffer *buffer;
+    PangoLayout *layout;
+    PangoLayoutIter *iter;
+    PangoRectangle logical;
+    gdouble page_height;
+    gdouble height;
+    gint64 deadline;
+    gint line;
 
     //Initializations
-    view = gw_searchwindow_get_current_textview (data->window);
-    buffer = gtk_text_view_get_buffer (view);
-
-    //Get the draw bounds
-    if (gtk_text_buffer_get_has_selection (buffer))
-    {
-      gtk_text_buffer_get_selection_bounds (buffer, &start_bound, &end_bound);
-    }
-    else
-    {
-      gtk_text_buffer_get_start_iter (buffer, &start_bound);
-      gtk_text_buffer_get_end_iter (buffer, &end_bound);
-    }
+    deadline = g_get_monotonic_time () + GW_PRINTING_PAGINATE_BUDGET * 1000;
+    page_height = gtk_print_context_get_height (context) - GW_PRINTING_RESULTS_TOP;
 
     //Create the first page
-    if (data->pages == NULL)
+    if (data->text == NULL)
     {
-      page = gw_pageinfo_new (start_bound, end_bound);
-      _draw_page_results (context, page, data);
-      data->pages = g_list_append (data->pages, page);
-      return FALSE;
+      data->text = _get_text (data);
+      data->next = data->text;
+      g_ptr_array_add (data->pages, gw_pageinfo_new (0, 0));
     }
 
-    iter = g_list_last (data->pages);
-    prev_page = GW_PAGEINFO (iter->data);
+    page = g_ptr_array_index (data->pages, data->pages->len - 1);
 
-    //Finish paginating
-    if (gtk_text_iter_get_line (&(prev_page->end)) == gtk_text_iter_get_line (&end_bound))
+    while (data->next != NULL && g_get_monotonic_time () < deadline)
     {
-      gtk_print_operation_set_n_pages (operation, g_list_length (data->pages));
-      return TRUE;
+      layout = _layout_next_line (context, data);
+      iter = pango_layout_get_iter (layout);
+      line = 0;
+
+      //Start a new page at the first line that doesn't fit
+      do
+      {
+        pango_layout_iter_get_line_extents (iter, NULL, &logical);
+        height = (gdouble) logical.height / PANGO_SCALE;
+        if (data->used_height + height > page_height && data->used_height > 0.0)
+        {
+          page->end_layout = data->layouts->len - 1;
+          page->end_line = line;
+          page = gw_pageinfo_new (page->end_layout, page->end_line);
+          g_ptr_array_add (data->pages, page);
+          data->used_height = 0.0;
+        }
+        data->used_height += height;
+        line++;
+      }
+      while (pango_layout_iter_next_line (iter));
+
+      pango_layout_iter_free (iter);
     }
 
-    //Add another page
-    page = gw_pageinfo_new (prev_page->end, end_bound);
-    _draw_page_results (context, page, data);
-    data->pages = g_list_append (data->pages, page);
+    if (data->next != NULL) return FALSE;
+
+    //Finish paginating
+    page->end_layout = data->layouts->len;
+    page->end_line = 0;
+    gtk_print_operation_set_n_pages (operation, data->pages->len);
 
-    return FALSE;
+    return TRUE;
 }
 
 
 //!
 //! @brief Draws a page for pagination
 //!
-//! THIS IS A PRIVATE FUNCTION.  This draws a page for pagination to be printed
-//! using the current position.
+//! THIS IS A PRIVATE FUNCTION.  This draws a page that was paginated using the
+//! layouts cached by _paginate().
 //!
 //! @param operation Unused GtkPrintOperation
 //! @param context Pointer co a GtkPrintContext to draw on
@@ -340,20 +399,16 @@ static void _draw_page (GtkPrintOperation *operation,
                         gint               page_nr,
                         GwPrintData       *data     )
 {
-    printf("draw!\n");
-
     //Declarations
     GwPageInfo *page;
 
     //Initializations
-    page = GW_PAGEINFO (g_list_nth_data (data->pages, page_nr));
+    if (page_nr < 0 || page_nr >= data->pages->len) return;
+    page = GW_PAGEINFO (g_ptr_array_index (data->pages, page_nr));
 
-    if (page != NULL)
-    {
-      _draw_page_title (context, page, data);
-      _draw_page_number (context, page_nr, page, data);
-      _draw_page_results (context, page, data);
-    }
+    _draw_page_title (context, page, data);
+    _draw_page_number (context, page_nr, page, data);
+    _draw_page_results (context, page, data);
 }
 
 
@@ -399,6 +454,7 @@ void gw_print (const GtkPrintOperationAction ACTION, GwSearchWindow *window)
     gtk_print_operation_set_default_page_setup (operation, NULL);
     gtk_print_operation_set_use_full_page (operation, FALSE);
     gtk_print_operation_set_unit (operation, GTK_UNIT_MM);
+    gtk_print_operation_set_show_progress (operation, TRUE);
 
     if (_settings != NULL)
       gtk_print_operation_set_print_settings (operation, _settings);
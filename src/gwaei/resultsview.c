@@ -0,0 +1,1459 @@
+/******************************************************************************
+    AUTHOR:
+    File written and Copyrighted by Zachary Dovel. All Rights Reserved.
+
+    LICENSE:
+    This file is part of gWaei.
+
+    gWaei is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    gWaei is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    
+    You should have received a copy of the GNU General Public License
+    along with gWaei.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+//!
+//! @file resultsview.c
+//!
+//! @brief A results view that only lays out the rows that are on screen
+//!
+//! The results are kept compacted in a LwResultList and each row has a fixed
+//! number of lines, so scrolling only has to find the rows in view.
+//!
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <gtk/gtk.h>
+
+#include <gwaei/gwaei.h>
+#include <gwaei/resultsview-private.h>
+
+
+typedef enum {
+  PROP_0,
+  PROP_HADJUSTMENT,
+  PROP_VADJUSTMENT,
+  PROP_HSCROLL_POLICY,
+  PROP_VSCROLL_POLICY
+} GwResultsViewProp;
+
+
+static void gw_resultsview_set_adjustment (GwResultsView*, GtkAdjustment**, GtkAdjustment*);
+static void gw_resultsview_update_adjustments (GwResultsView*);
+static void gw_resultsview_update_metrics (GwResultsView*);
+
+
+G_DEFINE_TYPE_WITH_CODE (GwResultsView, gw_resultsview, GTK_TYPE_DRAWING_AREA,
+                         G_IMPLEMENT_INTERFACE (GTK_TYPE_SCROLLABLE, NULL))
+
+
+//!
+//! @brief Creates a new results view
+//! @param tagtable The GtkTextTagTable the text views use.  Its tags style the rows.
+//!
+GtkWidget* 
+gw_resultsview_new (GtkTextTagTable *tagtable)
+{
+    //Declarations
+    GwResultsView *view;
+
+    //Initializations
+    view = GW_RESULTSVIEW (g_object_new (GW_TYPE_RESULTSVIEW, NULL));
+    view->priv->tagtable = g_object_ref (tagtable);
+
+    return GTK_WIDGET (view);
+}
+
+
+static void 
+gw_resultsview_row_free (GwResultsViewRow *row)
+{
+    int i;
+
+    for (i = 0; i < row->links->len; i++)
+      g_free (g_array_index (row->links, GwResultsViewLink, i).vocabulary_data);
+    g_array_free (row->links, TRUE);
+    g_object_unref (row->layout);
+
+    free (row);
+}
+
+
+static void 
+gw_resultsview_init (GwResultsView *view)
+{
+    //Declarations
+    GwResultsViewPrivate *priv;
+    guint start;
+
+    view->priv = GW_RESULTSVIEW_GET_PRIVATE (view);
+    memset(view->priv, 0, sizeof(GwResultsViewPrivate));
+
+    //Initializations
+    priv = view->priv;
+    start = 0;
+    priv->results = lw_resultlist_new ();
+    priv->resultline = lw_resultline_new ();
+    priv->type = LW_DICTTYPE_UNKNOWN;
+    priv->press_row = -1;
+    priv->selection_anchor = -1;
+    priv->selection_cursor = -1;
+    priv->lines = g_array_new (FALSE, FALSE, sizeof(guint));
+    g_array_append_val (priv->lines, start);
+    priv->rows = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, (GDestroyNotify) gw_resultsview_row_free);
+
+    gtk_widget_set_can_focus (GTK_WIDGET (view), TRUE);
+    gtk_widget_add_events (GTK_WIDGET (view), GDK_POINTER_MOTION_MASK | 
+                                              GDK_BUTTON_PRESS_MASK   | 
+                                              GDK_BUTTON_RELEASE_MASK | 
+                                              GDK_KEY_PRESS_MASK      |
+                                              GDK_SCROLL_MASK           );
+    gtk_style_context_add_class (gtk_widget_get_style_context (GTK_WIDGET (view)), GTK_STYLE_CLASS_VIEW);
+
+    gw_resultsview_update_metrics (view);
+}
+
+
+static void 
+gw_resultsview_adjustment_value_changed_cb (GtkAdjustment *adjustment, gpointer data)
+{
+    gtk_widget_queue_draw (GTK_WIDGET (data));
+}
+
+
+static void 
+gw_resultsview_dispose (GObject *object)
+{
+    //Declarations
+    GwResultsView *view;
+    GwResultsViewPrivate *priv;
+
+    //Initializations
+    view = GW_RESULTSVIEW (object);
+    priv = view->priv;
+
+    if (priv->hadjustment != NULL)
+    {
+      g_signal_handlers_disconnect_by_func (priv->hadjustment, gw_resultsview_adjustment_value_changed_cb, view);
+      g_object_unref (priv->hadjustment);
+      priv->hadjustment = NULL;
+    }
+    if (priv->vadjustment != NULL)
+    {
+      g_signal_handlers_disconnect_by_func (priv->vadjustment, gw_resultsview_adjustment_value_changed_cb, view);
+      g_object_unref (priv->vadjustment);
+      priv->vadjustment = NULL;
+    }
+
+    G_OBJECT_CLASS (gw_resultsview_parent_class)->dispose (object);
+}
+
+
+static void 
+gw_resultsview_finalize (GObject *object)
+{
+    //Declarations
+    GwResultsView *view;
+    GwResultsViewPrivate *priv;
+
+    //Initializations
+    view = GW_RESULTSVIEW (object);
+    priv = view->priv;
+
+    g_hash_table_destroy (priv->rows); priv->rows = NULL;
+    g_array_free (priv->lines, TRUE); priv->lines = NULL;
+    lw_resultline_free (priv->resultline); priv->resultline = NULL;
+    lw_resultlist_free (priv->results); priv->results = NULL;
+    if (priv->tagtable != NULL) g_object_unref (priv->tagtable); priv->tagtable = NULL;
+
+    G_OBJECT_CLASS (gw_resultsview_parent_class)->finalize (object);
+}
+
+
+//!
+//! @brief Swaps one of the scrolling adjustments of the view
+//! @param target The adjustment pointer of the private struct to replace
+//! @param adjustment The new GtkAdjustment or NULL to make an empty one
+//!
+static void 
+gw_resultsview_set_adjustment (GwResultsView *view, GtkAdjustment **target, GtkAdjustment *adjustment)
+{
+    if (adjustment != NULL && adjustment == *target) return;
+
+    if (*target != NULL)
+    {
+      g_signal_handlers_disconnect_by_func (*target, gw_resultsview_adjustment_value_changed_cb, view);
+      g_object_unref (*target);
+      *target = NULL;
+    }
+
+    if (adjustment == NULL) adjustment = gtk_adjustment_new (0.0, 0.0, 0.0, 0.0, 0.0, 0.0);
+
+    g_signal_connect (adjustment, "value-changed", G_CALLBACK (gw_resultsview_adjustment_value_changed_cb), view);
+    *target = GTK_ADJUSTMENT (g_object_ref_sink (adjustment));
+
+    gw_resultsview_update_adjustments (view);
+}
+
+
+static void 
+gw_resultsview_set_property (GObject      *object,
+                             guint         property_id,
+                             const GValue *value,
+                             GParamSpec   *pspec)
+{
+    GwResultsView *view;
+    GwResultsViewPrivate *priv;
+
+    view = GW_RESULTSVIEW (object);
+    priv = view->priv;
+
+    switch (property_id)
+    {
+      case PROP_HADJUSTMENT:
+        gw_resultsview_set_adjustment (view, &priv->hadjustment, GTK_ADJUSTMENT (g_value_get_object (value)));
+        break;
+      case PROP_VADJUSTMENT:
+        gw_resultsview_set_adjustment (view, &priv->vadjustment, GTK_ADJUSTMENT (g_value_get_object (value)));
+        break;
+      case PROP_HSCROLL_POLICY:
+        priv->hscroll_policy = g_value_get_enum (value);
+        gtk_widget_queue_resize (GTK_WIDGET (view));
+        break;
+      case PROP_VSCROLL_POLICY:
+        priv->vscroll_policy = g_value_get_enum (value);
+        gtk_widget_queue_resize (GTK_WIDGET (view));
+        break;
+      default:
+        G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+        break;
+    }
+}
+
+
+static void 
+gw_resultsview_get_property (GObject      *object,
+                             guint         property_id,
+                             GValue       *value,
+                             GParamSpec   *pspec)
+{
+    GwResultsView *view;
+    GwResultsViewPrivate *priv;
+
+    view = GW_RESULTSVIEW (object);
+    priv = view->priv;
+
+    switch (property_id)
+    {
+      case PROP_HADJUSTMENT:
+        g_value_set_object (value, priv->hadjustment);
+        break;
+      case PROP_VADJUSTMENT:
+        g_value_set_object (value, priv->vadjustment);
+        break;
+      case PROP_HSCROLL_POLICY:
+        g_value_set_enum (value, priv->hscroll_policy);
+        break;
+      case PROP_VSCROLL_POLICY:
+        g_value_set_enum (value, priv->vscroll_policy);
+        break;
+      default:
+        G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+        break;
+    }
+}
+
+
+//!
+//! @brief Adds the look of one of the text buffer tags to a byte range of a row
+//!
+static void 
+gw_resultsview_add_tag_attributes (GwResultsView  *view, 
+                                   PangoAttrList  *attrs, 
+                                   const gchar    *TAG, 
+                                   gint            start, 
+                                   gint            end   )
+{
+    //Declarations
+    GwResultsViewPrivate *priv;
+    GtkTextTag *tag;
+    PangoFontDescription *desc;
+    GdkRGBA *foreground;
+    GdkRGBA *background;
+    gboolean foreground_set;
+    gboolean background_set;
+    PangoAttribute *attr;
+
+    //Initializations
+    priv = view->priv;
+    if (attrs == NULL || TAG == NULL || priv->tagtable == NULL || start >= end) return;
+    tag = gtk_text_tag_table_lookup (priv->tagtable, TAG);
+    if (tag == NULL) return;
+    desc = NULL;
+    foreground = NULL;
+    background = NULL;
+
+    g_object_get (tag, "font-desc", &desc, 
+                       "foreground-set", &foreground_set, "foreground-rgba", &foreground, 
+                       "background-set", &background_set, "background-rgba", &background, 
+                       NULL);
+
+    if (desc != NULL && pango_font_description_get_set_fields (desc) != 0)
+    {
+      attr = pango_attr_font_desc_new (desc);
+      attr->start_index = start;
+      attr->end_index = end;
+      pango_attr_list_insert (attrs, attr);
+    }
+    if (foreground_set && foreground != NULL)
+    {
+      attr = pango_attr_foreground_new (foreground->red * 65535, foreground->green * 65535, foreground->blue * 65535);
+      attr->start_index = start;
+      attr->end_index = end;
+      pango_attr_list_insert (attrs, attr);
+    }
+    if (background_set && background != NULL)
+    {
+      attr = pango_attr_background_new (background->red * 65535, background->green * 65535, background->blue * 65535);
+      attr->start_index = start;
+      attr->end_index = end;
+      pango_attr_list_insert (attrs, attr);
+    }
+
+    //Cleanup
+    if (desc != NULL) pango_font_description_free (desc);
+    if (foreground != NULL) gdk_rgba_free (foreground);
+    if (background != NULL) gdk_rgba_free (background);
+}
+
+
+//!
+//! @brief Appends text to a row with up to two tags applied to it
+//! @returns The byte offset the text starts at
+//!
+static gint 
+gw_resultsview_append_text (GwResultsView *view, 
+                            GString       *text, 
+                            PangoAttrList *attrs, 
+                            const gchar   *TEXT, 
+                            const gchar   *TAG, 
+                            const gchar   *TAG2 )
+{
+    //Declarations
+    gint start;
+
+    //Initializations
+    start = text->len;
+
+    g_string_append (text, TEXT);
+
+    gw_resultsview_add_tag_attributes (view, attrs, TAG, start, text->len);
+    gw_resultsview_add_tag_attributes (view, attrs, TAG2, start, text->len);
+
+    return start;
+}
+
+
+//!
+//! @brief Appends a field of a result to a row and highlights the matches the search engine found in it
+//! @returns The byte offset the field starts at
+//!
+static gint 
+gw_resultsview_append_field (GwResultsView      *view, 
+                             GString            *text, 
+                             PangoAttrList      *attrs, 
+                             LwResultLine       *resultline, 
+                             LwResultLineField   FIELD, 
+                             gint                index, 
+                             const gchar        *TAG )
+{
+    //Declarations
+    const gchar *field;
+    LwResultLineMatch *match;
+    gint start;
+    int i;
+
+    //Initializations
+    field = lw_resultline_get_field (resultline, FIELD, index);
+    if (field == NULL) return text->len;
+    start = gw_resultsview_append_text (view, text, attrs, field, TAG, NULL);
+    if (attrs == NULL) return start;
+
+    for (i = 0; i < resultline->match_total; i++)
+    {
+      match = &resultline->matches[i];
+      if (match->field != FIELD || match->index != index) continue;
+
+      gw_resultsview_add_tag_attributes (view, attrs, "match", start + match->start, start + match->end);
+    }
+
+    return start;
+}
+
+
+//!
+//! @brief Appends the " +" link that adds an edict result to a vocabulary list
+//!
+static void 
+gw_resultsview_append_edict_link (GwResultsView *view, GString *text, GArray *links, LwResultLine *resultline)
+{
+    //Declarations
+    LwVocabularyItem *item;
+    GwResultsViewLink link;
+    gchar *definitions;
+
+    g_string_append (text, " ");
+    link.start = gw_resultsview_append_text (view, text, NULL, "+", NULL, NULL);
+    link.end = text->len;
+    g_string_append (text, " ");
+
+    if (links == NULL) return;
+
+    //Initializations
+    definitions = g_strjoinv ("/", resultline->def_start);
+    if (definitions == NULL) return;
+    item = lw_vocabularyitem_new ();
+
+    if (item != NULL)
+    {
+      lw_vocabularyitem_set_kanji (item, resultline->kanji_start);
+      lw_vocabularyitem_set_furigana (item, resultline->furigana_start);
+      lw_vocabularyitem_set_definitions (item, definitions);
+      link.vocabulary_data = lw_vocabularyitem_to_string (item);
+      g_array_append_val (links, link);
+      lw_vocabularyitem_free (item);
+    }
+
+    g_free (definitions);
+}
+
+
+static void 
+gw_resultsview_format_edict (GwResultsView *view, LwResultLine *resultline, GString *text, PangoAttrList *attrs, GArray *links)
+{
+    //Declarations
+    int i;
+
+    if (resultline->kanji_start != NULL)
+    {
+      gw_resultsview_append_field (view, text, attrs, resultline, LW_RESULTLINE_FIELD_KANJI, 0, "important");
+    }
+    if (resultline->furigana_start != NULL)
+    {
+      gw_resultsview_append_text (view, text, attrs, " [", "important", NULL);
+      gw_resultsview_append_field (view, text, attrs, resultline, LW_RESULTLINE_FIELD_FURIGANA, 0, "important");
+      gw_resultsview_append_text (view, text, attrs, "]", "important", NULL);
+    }
+    if (resultline->classification_start != NULL)
+    {
+      g_string_append (text, " ");
+      gw_resultsview_append_text (view, text, attrs, resultline->classification_start, "gray", "italic");
+    }
+    if (resultline->important == TRUE)
+    {
+      g_string_append (text, " ");
+      gw_resultsview_append_text (view, text, attrs, gettext("Pop"), "small", NULL);
+    }
+    gw_resultsview_append_edict_link (view, text, links, resultline);
+
+    for (i = 0; resultline->def_start[i] != NULL; i++)
+    {
+      g_string_append (text, "\n      ");
+      if (resultline->number[i] != NULL)
+      {
+        gw_resultsview_append_text (view, text, attrs, resultline->number[i], "comment", NULL);
+        g_string_append (text, " ");
+      }
+      gw_resultsview_append_field (view, text, attrs, resultline, LW_RESULTLINE_FIELD_DEFINITION, i, NULL);
+    }
+}
+
+
+static void 
+gw_resultsview_format_kanji (GwResultsView *view, LwResultLine *resultline, GString *text, PangoAttrList *attrs)
+{
+    //Declarations
+    gboolean line_started;
+
+    //Initializations
+    line_started = FALSE;
+
+    if (resultline->kanji != NULL)
+    {
+      gw_resultsview_append_field (view, text, attrs, resultline, LW_RESULTLINE_FIELD_CHARACTER, 0, "important");
+    }
+    if (resultline->radicals != NULL)
+    {
+      g_string_append (text, "\n");
+      gw_resultsview_append_text (view, text, attrs, gettext("Radicals:"), "important", NULL);
+      g_string_append (text, " ");
+      gw_resultsview_append_field (view, text, attrs, resultline, LW_RESULTLINE_FIELD_RADICALS, 0, NULL);
+    }
+    if (resultline->readings[0] != NULL)
+    {
+      g_string_append (text, "\n");
+      gw_resultsview_append_text (view, text, attrs, gettext("Readings:"), "important", NULL);
+      g_string_append (text, " ");
+      gw_resultsview_append_field (view, text, attrs, resultline, LW_RESULTLINE_FIELD_READING, 0, NULL);
+    }
+    if (resultline->readings[1] != NULL)
+    {
+      g_string_append (text, "\n");
+      gw_resultsview_append_text (view, text, attrs, gettext("Name:"), "important", NULL);
+      g_string_append (text, " ");
+      gw_resultsview_append_field (view, text, attrs, resultline, LW_RESULTLINE_FIELD_READING, 1, NULL);
+    }
+    if (resultline->readings[2] != NULL)
+    {
+      g_string_append (text, "\n");
+      gw_resultsview_append_text (view, text, attrs, gettext("Radical Name:"), "important", NULL);
+      g_string_append (text, " ");
+      gw_resultsview_append_field (view, text, attrs, resultline, LW_RESULTLINE_FIELD_READING, 2, NULL);
+    }
+
+    g_string_append (text, "\n");
+    if (resultline->strokes != NULL)
+    {
+      gw_resultsview_append_text (view, text, attrs, gettext("Stroke:"), "important", NULL);
+      g_string_append_printf (text, " %s", resultline->strokes);
+      line_started = TRUE;
+    }
+    if (resultline->frequency != NULL)
+    {
+      if (line_started) g_string_append (text, "  ");
+      gw_resultsview_append_text (view, text, attrs, gettext("Freq:"), "important", NULL);
+      g_string_append_printf (text, " %s", resultline->frequency);
+      line_started = TRUE;
+    }
+    if (resultline->grade != NULL)
+    {
+      if (line_started) g_string_append (text, "  ");
+      gw_resultsview_append_text (view, text, attrs, gettext("Grade:"), "important", NULL);
+      g_string_append_printf (text, " %s", resultline->grade);
+      line_started = TRUE;
+    }
+    if (resultline->jlpt != NULL)
+    {
+      if (line_started) g_string_append (text, "  ");
+      gw_resultsview_append_text (view, text, attrs, gettext("JLPT:"), "important", NULL);
+      g_string_append_printf (text, " %s", resultline->jlpt);
+    }
+
+    if (resultline->meanings != NULL)
+    {
+      g_string_append (text, "\n");
+      gw_resultsview_append_text (view, text, attrs, gettext("Meanings:"), "important", NULL);
+      g_string_append (text, " ");
+      gw_resultsview_append_field (view, text, attrs, resultline, LW_RESULTLINE_FIELD_MEANINGS, 0, NULL);
+    }
+}
+
+
+static void 
+gw_resultsview_format_examples (GwResultsView *view, LwResultLine *resultline, GString *text, PangoAttrList *attrs)
+{
+    if (resultline->def_start[0] != NULL)
+    {
+      // TRANSLATORS: The "E" stands for "English"
+      gw_resultsview_append_text (view, text, attrs, gettext("E:\t"), "important", "comment");
+      gw_resultsview_append_field (view, text, attrs, resultline, LW_RESULTLINE_FIELD_DEFINITION, 0, "important");
+    }
+    if (resultline->kanji_start != NULL)
+    {
+      if (text->len > 0) g_string_append (text, "\n");
+      // TRANSLATORS: The "J" stands for "Japanese"
+      gw_resultsview_append_text (view, text, attrs, gettext("J:\t"), "important", "comment");
+      gw_resultsview_append_field (view, text, attrs, resultline, LW_RESULTLINE_FIELD_KANJI, 0, NULL);
+    }
+    if (resultline->furigana_start != NULL)
+    {
+      if (text->len > 0) g_string_append (text, "\n");
+      // TRANSLATORS: The "D" stands for "Detail"
+      gw_resultsview_append_text (view, text, attrs, gettext("D:\t"), "important", "comment");
+      gw_resultsview_append_field (view, text, attrs, resultline, LW_RESULTLINE_FIELD_FURIGANA, 0, NULL);
+    }
+}
+
+
+//!
+//! @brief Writes a result as the text of a row.  The row text does not end with a
+//!        newline and the blank line between rows is left to the layout.
+//! @param attrs A PangoAttrList to style the row with or NULL when only the text is needed
+//! @param links A GArray to fill with the GwResultsViewLinks of the row or NULL
+//!
+static void 
+gw_resultsview_format (GwResultsView *view, LwResultLine *resultline, GString *text, PangoAttrList *attrs, GArray *links)
+{
+    switch (view->priv->type)
+    {
+      case LW_DICTTYPE_EDICT:
+        gw_resultsview_format_edict (view, resultline, text, attrs, links);
+        break;
+      case LW_DICTTYPE_KANJI:
+        gw_resultsview_format_kanji (view, resultline, text, attrs);
+        break;
+      case LW_DICTTYPE_EXAMPLES:
+        gw_resultsview_format_examples (view, resultline, text, attrs);
+        break;
+      default:
+        gw_resultsview_append_field (view, text, attrs, resultline, LW_RESULTLINE_FIELD_STRING, 0, NULL);
+        break;
+    }
+}
+
+
+//!
+//! @brief Gets the laid out row for a result, laying it out if it isn't cached
+//!
+static GwResultsViewRow* 
+gw_resultsview_get_row (GwResultsView *view, guint index)
+{
+    //Declarations
+    GwResultsViewPrivate *priv;
+    GwResultsViewRow *row;
+    GString *text;
+    PangoAttrList *attrs;
+    gint width;
+
+    //Initializations
+    priv = view->priv;
+    row = g_hash_table_lookup (priv->rows, GUINT_TO_POINTER (index));
+    if (row != NULL) return row;
+    if (!lw_resultlist_get (priv->results, index, priv->resultline)) return NULL;
+
+    row = (GwResultsViewRow*) malloc(sizeof(GwResultsViewRow));
+    if (row == NULL) return NULL;
+
+    text = g_string_new (NULL);
+    attrs = pango_attr_list_new ();
+    row->links = g_array_new (FALSE, FALSE, sizeof(GwResultsViewLink));
+
+    gw_resultsview_format (view, priv->resultline, text, attrs, row->links);
+    row->layout = gtk_widget_create_pango_layout (GTK_WIDGET (view), text->str);
+    pango_layout_set_attributes (row->layout, attrs);
+    g_hash_table_insert (priv->rows, GUINT_TO_POINTER (index), row);
+
+    //Let the horizontal scrollbar reach the widest row seen so far
+    pango_layout_get_pixel_size (row->layout, &width, NULL);
+    width += GW_RESULTSVIEW_MARGIN * 2;
+    if (width > priv->width)
+    {
+      priv->width = width;
+      gw_resultsview_update_adjustments (view);
+    }
+
+    //Cleanup
+    pango_attr_list_unref (attrs);
+    g_string_free (text, TRUE);
+
+    return row;
+}
+
+
+static gboolean 
+gw_resultsview_row_is_outside (gpointer key, gpointer value, gpointer data)
+{
+    guint index;
+    guint *range;
+
+    index = GPOINTER_TO_UINT (key);
+    range = data;
+
+    return (index < range[0] || index > range[1]);
+}
+
+
+//!
+//! @brief Finds the row a line of the view belongs to
+//!
+static guint 
+gw_resultsview_get_row_at_line (GwResultsView *view, guint line)
+{
+    //Declarations
+    GArray *lines;
+    guint low;
+    guint high;
+    guint middle;
+
+    //Initializations
+    lines = view->priv->lines;
+    low = 0;
+    high = lines->len - 1;
+
+    if (high == 0) return 0;
+
+    //Find the last row starting at or before the line
+    while (high - low > 1)
+    {
+      middle = (low + high) / 2;
+      if (g_array_index (lines, guint, middle) <= line)
+        low = middle;
+      else
+        high = middle;
+    }
+
+    return low;
+}
+
+
+//!
+//! @brief Finds the row under a y coordinate of the view.  Points past the ends
+//!        of the results snap to the first or last row.
+//! @returns The row index or -1 if the view is empty
+//!
+static gint 
+gw_resultsview_get_row_at_position (GwResultsView *view, gdouble y)
+{
+    //Declarations
+    GwResultsViewPrivate *priv;
+    gdouble y_offset;
+    guint length;
+    guint index;
+
+    //Initializations
+    priv = view->priv;
+    y_offset = (priv->vadjustment != NULL) ? gtk_adjustment_get_value (priv->vadjustment) : 0.0;
+    length = lw_resultlist_length (priv->results);
+    y = y + y_offset - GW_RESULTSVIEW_MARGIN / 2;
+
+    if (length == 0) return -1;
+    if (y < 0) return 0;
+
+    index = gw_resultsview_get_row_at_line (view, (guint) y / priv->line_height);
+    if (index >= length) index = length - 1;
+
+    return (gint) index;
+}
+
+
+//!
+//! @brief Gets the first and last selected rows
+//! @returns FALSE if no rows are selected
+//!
+static gboolean 
+gw_resultsview_get_selection_bounds (GwResultsView *view, guint *first, guint *last)
+{
+    //Declarations
+    GwResultsViewPrivate *priv;
+
+    //Initializations
+    priv = view->priv;
+
+    if (priv->selection_anchor < 0 || priv->selection_cursor < 0) return FALSE;
+
+    *first = MIN (priv->selection_anchor, priv->selection_cursor);
+    *last = MAX (priv->selection_anchor, priv->selection_cursor);
+
+    return TRUE;
+}
+
+
+static void 
+gw_resultsview_update_adjustments (GwResultsView *view)
+{
+    //Declarations
+    GwResultsViewPrivate *priv;
+    GtkWidget *widget;
+    gdouble width;
+    gdouble height;
+    gdouble upper;
+    gdouble value;
+
+    //Initializations
+    priv = view->priv;
+    widget = GTK_WIDGET (view);
+    width = gtk_widget_get_allocated_width (widget);
+    height = gtk_widget_get_allocated_height (widget);
+
+    if (priv->vadjustment != NULL)
+    {
+      upper = MAX (height, g_array_index (priv->lines, guint, priv->lines->len - 1) * priv->line_height + GW_RESULTSVIEW_MARGIN);
+      value = CLAMP (gtk_adjustment_get_value (priv->vadjustment), 0.0, upper - height);
+      gtk_adjustment_configure (priv->vadjustment, value, 0.0, upper, priv->line_height, height * 0.9, height);
+    }
+
+    if (priv->hadjustment != NULL)
+    {
+      upper = MAX (width, priv->width);
+      value = CLAMP (gtk_adjustment_get_value (priv->hadjustment), 0.0, upper - width);
+      gtk_adjustment_configure (priv->hadjustment, value, 0.0, upper, priv->line_height, width * 0.9, width);
+    }
+}
+
+
+//!
+//! @brief Measures the line pitch of the current font.  Every line of the view is
+//!        drawn at this pitch so the row of a line can be found without layout.
+//!
+static void 
+gw_resultsview_update_metrics (GwResultsView *view)
+{
+    //Declarations
+    GwResultsViewPrivate *priv;
+    PangoContext *context;
+    PangoFontMetrics *metrics;
+    gint descent;
+
+    //Initializations
+    priv = view->priv;
+    context = gtk_widget_get_pango_context (GTK_WIDGET (view));
+    metrics = pango_context_get_metrics (context, 
+                                         pango_context_get_font_description (context), 
+                                         pango_language_from_string ("ja"));
+
+    priv->ascent = PANGO_PIXELS (pango_font_metrics_get_ascent (metrics));
+    descent = PANGO_PIXELS (pango_font_metrics_get_descent (metrics));
+    priv->line_height = priv->ascent + descent + 2;
+    priv->width = 0;
+
+    g_hash_table_remove_all (priv->rows);
+    gw_resultsview_update_adjustments (view);
+
+    //Cleanup
+    pango_font_metrics_unref (metrics);
+}
+
+
+static void 
+gw_resultsview_style_updated (GtkWidget *widget)
+{
+    GTK_WIDGET_CLASS (gw_resultsview_parent_class)->style_updated (widget);
+
+    gw_resultsview_update_metrics (GW_RESULTSVIEW (widget));
+    gtk_widget_queue_draw (widget);
+}
+
+
+static void 
+gw_resultsview_size_allocate (GtkWidget *widget, GtkAllocation *allocation)
+{
+    GTK_WIDGET_CLASS (gw_resultsview_parent_class)->size_allocate (widget, allocation);
+
+    gw_resultsview_update_adjustments (GW_RESULTSVIEW (widget));
+}
+
+
+static gboolean 
+gw_resultsview_draw (GtkWidget *widget, cairo_t *cr)
+{
+    //Declarations
+    GwResultsView *view;
+    GwResultsViewPrivate *priv;
+    GtkStyleContext *context;
+    GwResultsViewRow *row;
+    PangoLayoutLine *line;
+    GdkRGBA color;
+    GdkRGBA selected_color;
+    GdkRGBA selected_background;
+    gboolean has_selection;
+    gboolean selected;
+    guint selection_first;
+    guint selection_last;
+    gdouble x_offset;
+    gdouble y_offset;
+    gint width;
+    gint height;
+    guint range[2];
+    guint first;
+    guint last;
+    guint length;
+    guint start;
+    gint total;
+    gint y;
+    guint i;
+    gint j;
+
+    //Initializations
+    view = GW_RESULTSVIEW (widget);
+    priv = view->priv;
+    context = gtk_widget_get_style_context (widget);
+    width = gtk_widget_get_allocated_width (widget);
+    height = gtk_widget_get_allocated_height (widget);
+    x_offset = (priv->hadjustment != NULL) ? gtk_adjustment_get_value (priv->hadjustment) : 0.0;
+    y_offset = (priv->vadjustment != NULL) ? gtk_adjustment_get_value (priv->vadjustment) : 0.0;
+    length = lw_resultlist_length (priv->results);
+    first = gw_resultsview_get_row_at_line (view, (guint) y_offset / priv->line_height);
+    last = gw_resultsview_get_row_at_line (view, ((guint) y_offset + height) / priv->line_height);
+
+    gtk_render_background (context, cr, 0, 0, width, height);
+
+    if (length == 0) return FALSE;
+
+    //Forget the rows that scrolled well out of view
+    range[0] = (first > GW_RESULTSVIEW_OVERSCAN) ? first - GW_RESULTSVIEW_OVERSCAN : 0;
+    range[1] = last + GW_RESULTSVIEW_OVERSCAN;
+    g_hash_table_foreach_remove (priv->rows, gw_resultsview_row_is_outside, range);
+
+    gtk_style_context_get_color (context, gtk_widget_get_state_flags (widget), &color);
+    gtk_style_context_get_color (context, GTK_STATE_FLAG_SELECTED, &selected_color);
+    gtk_style_context_get_background_color (context, GTK_STATE_FLAG_SELECTED, &selected_background);
+    has_selection = gw_resultsview_get_selection_bounds (view, &selection_first, &selection_last);
+
+    for (i = first; i <= last && i < length; i++)
+    {
+      row = gw_resultsview_get_row (view, i);
+      if (row == NULL) continue;
+      start = g_array_index (priv->lines, guint, i);
+      total = pango_layout_get_line_count (row->layout);
+      selected = (has_selection && i >= selection_first && i <= selection_last);
+
+      //Selected rows are highlighted across the view including the blank line after them
+      if (selected)
+      {
+        y = start * priv->line_height - (gint) y_offset + GW_RESULTSVIEW_MARGIN / 2;
+        gdk_cairo_set_source_rgba (cr, &selected_background);
+        cairo_rectangle (cr, 0, y, width, (g_array_index (priv->lines, guint, i + 1) - start) * priv->line_height);
+        cairo_fill (cr);
+      }
+      gdk_cairo_set_source_rgba (cr, (selected) ? &selected_color : &color);
+
+      for (j = 0; j < total; j++)
+      {
+        y = (start + j) * priv->line_height - (gint) y_offset + GW_RESULTSVIEW_MARGIN / 2;
+        if (y + priv->line_height < 0 || y > height) continue;
+        line = pango_layout_get_line_readonly (row->layout, j);
+        cairo_move_to (cr, GW_RESULTSVIEW_MARGIN - x_offset, y + priv->ascent);
+        pango_cairo_show_layout_line (cr, line);
+      }
+    }
+
+    //Lay out the overscan so that scrolling a little doesn't have to
+    for (i = range[0]; i < first; i++)
+      gw_resultsview_get_row (view, i);
+    for (i = last + 1; i <= range[1] && i < length; i++)
+      gw_resultsview_get_row (view, i);
+
+    return FALSE;
+}
+
+
+//!
+//! @brief Finds the text under a point of the view
+//! @param x The x coordinate in widget space
+//! @param y The y coordinate in widget space
+//! @param row Set to the row under the point
+//! @returns The byte offset into the row text or -1 if there is no text there
+//!
+static gint 
+gw_resultsview_get_index_at_position (GwResultsView *view, gdouble x, gdouble y, GwResultsViewRow **row)
+{
+    //Declarations
+    GwResultsViewPrivate *priv;
+    PangoLayoutLine *line;
+    gdouble x_offset;
+    gdouble y_offset;
+    guint number;
+    guint index;
+    gint start;
+    gint trailing;
+
+    //Initializations
+    priv = view->priv;
+    x_offset = (priv->hadjustment != NULL) ? gtk_adjustment_get_value (priv->hadjustment) : 0.0;
+    y_offset = (priv->vadjustment != NULL) ? gtk_adjustment_get_value (priv->vadjustment) : 0.0;
+    y = y + y_offset - GW_RESULTSVIEW_MARGIN / 2;
+    x = x + x_offset - GW_RESULTSVIEW_MARGIN;
+
+    if (x < 0 || y < 0 || lw_resultlist_length (priv->results) == 0) return -1;
+
+    number = (guint) y / priv->line_height;
+    index = gw_resultsview_get_row_at_line (view, number);
+    number -= g_array_index (priv->lines, guint, index);
+    *row = gw_resultsview_get_row (view, index);
+    if (*row == NULL || number >= pango_layout_get_line_count ((*row)->layout)) return -1;
+
+    line = pango_layout_get_line_readonly ((*row)->layout, number);
+    if (!pango_layout_line_x_to_index (line, (gint) x * PANGO_SCALE, &start, &trailing)) return -1;
+
+    return start;
+}
+
+
+static gunichar 
+gw_resultsview_get_kanji_at_index (GwResultsViewRow *row, gint index)
+{
+    gunichar character;
+
+    character = g_utf8_get_char (pango_layout_get_text (row->layout) + index);
+
+    if (g_unichar_get_script (character) != G_UNICODE_SCRIPT_HAN)
+      character = 0;
+
+    return character;
+}
+
+
+static const gchar* 
+gw_resultsview_get_vocabulary_data_at_index (GwResultsViewRow *row, gint index)
+{
+    GwResultsViewLink *link;
+    int i;
+
+    for (i = 0; i < row->links->len; i++)
+    {
+      link = &g_array_index (row->links, GwResultsViewLink, i);
+      if (index >= link->start && index < link->end) return link->vocabulary_data;
+    }
+
+    return NULL;
+}
+
+
+static gboolean 
+gw_resultsview_motion_notify_event (GtkWidget *widget, GdkEventMotion *event)
+{
+    //Declarations
+    GwResultsView *view;
+    GwResultsViewPrivate *priv;
+    GwResultsViewRow *row;
+    GtkWidget *tooltip_window;
+    GdkCursor *cursor;
+    gunichar character;
+    const gchar *vocabulary_data;
+    gint selection_cursor;
+    gint index;
+
+    //Initializations
+    view = GW_RESULTSVIEW (widget);
+    priv = view->priv;
+    row = NULL;
+    index = gw_resultsview_get_index_at_position (view, event->x, event->y, &row);
+    character = 0;
+    vocabulary_data = NULL;
+
+    //Dragging with the first button selects the rows between the press and the pointer
+    if ((event->state & GDK_BUTTON1_MASK) && priv->press_row > -1 &&
+        (abs (priv->press_x - (gint) event->x) >= 3 || abs (priv->press_y - (gint) event->y) >= 3))
+    {
+      selection_cursor = gw_resultsview_get_row_at_position (view, event->y);
+      if (priv->selection_anchor != priv->press_row || priv->selection_cursor != selection_cursor)
+      {
+        priv->selection_anchor = priv->press_row;
+        priv->selection_cursor = selection_cursor;
+        gtk_widget_queue_draw (widget);
+      }
+    }
+
+    if (index > -1)
+    {
+      character = gw_resultsview_get_kanji_at_index (row, index);
+      vocabulary_data = gw_resultsview_get_vocabulary_data_at_index (row, index);
+    }
+
+    if (character != 0 || vocabulary_data != NULL)
+    {
+      cursor = gdk_cursor_new (GDK_HAND1);
+      gdk_window_set_cursor (gtk_widget_get_window (widget), cursor);
+      g_object_unref (cursor);
+    }
+    else
+    {
+      gdk_window_set_cursor (gtk_widget_get_window (widget), NULL);
+    }
+
+    tooltip_window = GTK_WIDGET (gtk_widget_get_tooltip_window (widget));
+    if (tooltip_window != NULL && character == 0)
+    {
+      gtk_widget_destroy (tooltip_window);
+      gtk_widget_set_tooltip_window (widget, NULL);
+    }
+
+    return FALSE;
+}
+
+
+static gboolean 
+gw_resultsview_button_press_event (GtkWidget *widget, GdkEventButton *event)
+{
+    //Declarations
+    GwResultsView *view;
+    GwResultsViewPrivate *priv;
+    gint index;
+
+    //Initializations
+    view = GW_RESULTSVIEW (widget);
+    priv = view->priv;
+    priv->press_x = (gint) event->x;
+    priv->press_y = (gint) event->y;
+
+    gtk_widget_grab_focus (widget);
+
+    if (event->button != 1 || event->type != GDK_BUTTON_PRESS) return FALSE;
+
+    index = gw_resultsview_get_row_at_position (view, event->y);
+
+    //Shift extends the selection to the clicked row and anything else starts a new one
+    if ((event->state & GDK_SHIFT_MASK) && priv->selection_anchor > -1 && index > -1)
+    {
+      priv->selection_cursor = index;
+      priv->press_row = -1;
+    }
+    else
+    {
+      priv->selection_anchor = -1;
+      priv->selection_cursor = -1;
+      priv->press_row = index;
+    }
+
+    gtk_widget_queue_draw (widget);
+
+    return FALSE;
+}
+
+
+static gboolean 
+gw_resultsview_button_release_event (GtkWidget *widget, GdkEventButton *event)
+{
+    //Declarations
+    GwResultsView *view;
+    GwResultsViewPrivate *priv;
+    GwResultsViewClass *klass;
+    GwResultsViewRow *row;
+    gunichar character;
+    const gchar *vocabulary_data;
+    gint index;
+
+    //Initializations
+    view = GW_RESULTSVIEW (widget);
+    priv = view->priv;
+    klass = GW_RESULTSVIEW_GET_CLASS (view);
+    row = NULL;
+
+    if (event->button != 1) return FALSE;
+    priv->press_row = -1;
+
+    //A click that made a selection doesn't also activate what is under it
+    if (priv->selection_anchor > -1) return FALSE;
+    if (abs (priv->press_x - (gint) event->x) >= 3 || abs (priv->press_y - (gint) event->y) >= 3) return FALSE;
+
+    index = gw_resultsview_get_index_at_position (view, event->x, event->y, &row);
+    if (index < 0) return FALSE;
+
+    character = gw_resultsview_get_kanji_at_index (row, index);
+    vocabulary_data = gw_resultsview_get_vocabulary_data_at_index (row, index);
+
+    if (character != 0)
+    {
+      g_signal_emit (G_OBJECT (view), klass->signalid[GW_RESULTSVIEW_CLASS_SIGNALID_KANJI_ACTIVATED], 0, 
+                     character, (gint) event->x_root, (gint) event->y_root);
+    }
+    else if (vocabulary_data != NULL)
+    {
+      g_signal_emit (G_OBJECT (view), klass->signalid[GW_RESULTSVIEW_CLASS_SIGNALID_VOCABULARY_ACTIVATED], 0, 
+                     vocabulary_data);
+    }
+
+    return FALSE;
+}
+
+
+static gboolean 
+gw_resultsview_key_press_event (GtkWidget *widget, GdkEventKey *event)
+{
+    //Declarations
+    GwResultsView *view;
+    GwResultsViewPrivate *priv;
+    GtkAdjustment *adjustment;
+    gdouble value;
+
+    //Initializations
+    view = GW_RESULTSVIEW (widget);
+    priv = view->priv;
+    adjustment = priv->vadjustment;
+    if (adjustment == NULL) return FALSE;
+    value = gtk_adjustment_get_value (adjustment);
+
+    switch (event->keyval)
+    {
+      case GDK_KEY_Up:
+        value -= gtk_adjustment_get_step_increment (adjustment);
+        break;
+      case GDK_KEY_Down:
+        value += gtk_adjustment_get_step_increment (adjustment);
+        break;
+      case GDK_KEY_Page_Up:
+        value -= gtk_adjustment_get_page_increment (adjustment);
+        break;
+      case GDK_KEY_Page_Down:
+        value += gtk_adjustment_get_page_increment (adjustment);
+        break;
+      case GDK_KEY_Home:
+        value = gtk_adjustment_get_lower (adjustment);
+        break;
+      case GDK_KEY_End:
+        value = gtk_adjustment_get_upper (adjustment);
+        break;
+      default:
+        return GTK_WIDGET_CLASS (gw_resultsview_parent_class)->key_press_event (widget, event);
+    }
+
+    value = CLAMP (value, gtk_adjustment_get_lower (adjustment), gtk_adjustment_get_upper (adjustment) - gtk_adjustment_get_page_size (adjustment));
+    gtk_adjustment_set_value (adjustment, value);
+
+    return TRUE;
+}
+
+
+static void 
+gw_resultsview_get_preferred_width (GtkWidget *widget, gint *minimum, gint *natural)
+{
+    *minimum = *natural = GW_RESULTSVIEW_MARGIN * 2;
+}
+
+
+static void 
+gw_resultsview_get_preferred_height (GtkWidget *widget, gint *minimum, gint *natural)
+{
+    *minimum = *natural = GW_RESULTSVIEW (widget)->priv->line_height;
+}
+
+
+static void
+gw_resultsview_class_init (GwResultsViewClass *klass)
+{
+    //Declarations
+    GObjectClass *object_class;
+    GtkWidgetClass *widget_class;
+
+    //Initializations
+    object_class = G_OBJECT_CLASS (klass);
+    widget_class = GTK_WIDGET_CLASS (klass);
+
+    object_class->set_property = gw_resultsview_set_property;
+    object_class->get_property = gw_resultsview_get_property;
+    object_class->dispose = gw_resultsview_dispose;
+    object_class->finalize = gw_resultsview_finalize;
+
+    widget_class->draw = gw_resultsview_draw;
+    widget_class->size_allocate = gw_resultsview_size_allocate;
+    widget_class->style_updated = gw_resultsview_style_updated;
+    widget_class->motion_notify_event = gw_resultsview_motion_notify_event;
+    widget_class->button_press_event = gw_resultsview_button_press_event;
+    widget_class->button_release_event = gw_resultsview_button_release_event;
+    widget_class->key_press_event = gw_resultsview_key_press_event;
+    widget_class->get_preferred_width = gw_resultsview_get_preferred_width;
+    widget_class->get_preferred_height = gw_resultsview_get_preferred_height;
+
+    g_type_class_add_private (object_class, sizeof (GwResultsViewPrivate));
+
+    g_object_class_override_property (object_class, PROP_HADJUSTMENT, "hadjustment");
+    g_object_class_override_property (object_class, PROP_VADJUSTMENT, "vadjustment");
+    g_object_class_override_property (object_class, PROP_HSCROLL_POLICY, "hscroll-policy");
+    g_object_class_override_property (object_class, PROP_VSCROLL_POLICY, "vscroll-policy");
+
+    klass->signalid[GW_RESULTSVIEW_CLASS_SIGNALID_KANJI_ACTIVATED] = g_signal_new (
+        "kanji-activated",
+        G_OBJECT_CLASS_TYPE (object_class),
+        G_SIGNAL_RUN_FIRST,
+        G_STRUCT_OFFSET (GwResultsViewClass, kanji_activated),
+        NULL, NULL,
+        g_cclosure_marshal_generic,
+        G_TYPE_NONE, 3,
+        G_TYPE_UINT, G_TYPE_INT, G_TYPE_INT
+    );
+
+    klass->signalid[GW_RESULTSVIEW_CLASS_SIGNALID_VOCABULARY_ACTIVATED] = g_signal_new (
+        "vocabulary-activated",
+        G_OBJECT_CLASS_TYPE (object_class),
+        G_SIGNAL_RUN_FIRST,
+        G_STRUCT_OFFSET (GwResultsViewClass, vocabulary_activated),
+        NULL, NULL,
+        g_cclosure_marshal_VOID__STRING,
+        G_TYPE_NONE, 1,
+        G_TYPE_STRING
+    );
+}
+
+
+//!
+//! @brief Empties the view and gets it ready for the results of a search
+//! @param view The GwResultsView to reset
+//! @param item The LwSearchItem whose results will be shown or NULL
+//!
+void 
+gw_resultsview_reset (GwResultsView *view, LwSearchItem *item)
+{
+    //Declarations
+    GwResultsViewPrivate *priv;
+
+    //Initializations
+    priv = view->priv;
+
+    lw_resultlist_clear (priv->results);
+    g_array_set_size (priv->lines, 1);
+    g_hash_table_remove_all (priv->rows);
+    priv->type = LW_DICTTYPE_UNKNOWN;
+    priv->width = 0;
+    priv->press_row = -1;
+    priv->selection_anchor = -1;
+    priv->selection_cursor = -1;
+
+    if (item != NULL) priv->type = item->dictionary->type;
+
+    if (priv->vadjustment != NULL) gtk_adjustment_set_value (priv->vadjustment, 0.0);
+    if (priv->hadjustment != NULL) gtk_adjustment_set_value (priv->hadjustment, 0.0);
+    gw_resultsview_update_adjustments (view);
+    gtk_widget_queue_draw (GTK_WIDGET (view));
+}
+
+
+//!
+//! @brief Adds a result to the end of the view.  Only its line count is worked
+//!        out here; the row is laid out once it is scrolled near.
+//! @param view The GwResultsView to append to
+//! @param resultline The LwResultLine to copy.  The caller keeps ownership.
+//!
+void 
+gw_resultsview_append (GwResultsView *view, LwResultLine *resultline)
+{
+    //Declarations
+    GwResultsViewPrivate *priv;
+    GString *text;
+    guint start;
+    guint count;
+    gchar *ptr;
+    gdouble y_offset;
+    gint height;
+
+    //Initializations
+    priv = view->priv;
+    text = g_string_new (NULL);
+    start = g_array_index (priv->lines, guint, priv->lines->len - 1);
+    count = 2;
+
+    lw_resultlist_append (priv->results, resultline);
+    gw_resultsview_format (view, resultline, text, NULL, NULL);
+    for (ptr = text->str; *ptr != '\0'; ptr++)
+      if (*ptr == '\n') count++;
+    start += count;
+    g_array_append_val (priv->lines, start);
+
+    gw_resultsview_update_adjustments (view);
+
+    //Only redraw when the new row is on screen
+    y_offset = (priv->vadjustment != NULL) ? gtk_adjustment_get_value (priv->vadjustment) : 0.0;
+    height = gtk_widget_get_allocated_height (GTK_WIDGET (view));
+    if ((start - count) * priv->line_height < y_offset + height)
+      gtk_widget_queue_draw (GTK_WIDGET (view));
+
+    //Cleanup
+    g_string_free (text, TRUE);
+}
+
+
+guint 
+gw_resultsview_get_length (GwResultsView *view)
+{
+    return lw_resultlist_length (view->priv->results);
+}
+
+
+//!
+//! @brief Gets the plain text of the results for saving, copying or printing.
+//!        If some rows are selected only they are returned.
+//! @returns A newly allocated string to be freed with g_free
+//!
+gchar* 
+gw_resultsview_get_text (GwResultsView *view)
+{
+    //Declarations
+    GwResultsViewPrivate *priv;
+    GString *text;
+    guint length;
+    guint first;
+    guint last;
+    guint i;
+
+    //Initializations
+    priv = view->priv;
+    text = g_string_new (NULL);
+    length = lw_resultlist_length (priv->results);
+    first = 0;
+    last = (length > 0) ? length - 1 : 0;
+
+    gw_resultsview_get_selection_bounds (view, &first, &last);
+
+    for (i = first; i <= last && i < length; i++)
+    {
+      if (!lw_resultlist_get (priv->results, i, priv->resultline)) continue;
+      gw_resultsview_format (view, priv->resultline, text, NULL, NULL);
+      g_string_append (text, "\n\n");
+    }
+
+    return g_string_free (text, FALSE);
+}
+
+
+gboolean 
+gw_resultsview_has_selection (GwResultsView *view)
+{
+    guint first, last;
+
+    return gw_resultsview_get_selection_bounds (view, &first, &last);
+}
+
+
+void 
+gw_resultsview_select_all (GwResultsView *view)
+{
+    //Declarations
+    GwResultsViewPrivate *priv;
+    guint length;
+
+    //Initializations
+    priv = view->priv;
+    length = lw_resultlist_length (priv->results);
+    if (length == 0) return;
+
+    priv->selection_anchor = 0;
+    priv->selection_cursor = length - 1;
+
+    gtk_widget_queue_draw (GTK_WIDGET (view));
+}
+
+
+void 
+gw_resultsview_select_none (GwResultsView *view)
+{
+    //Declarations
+    GwResultsViewPrivate *priv;
+
+    //Initializations
+    priv = view->priv;
+
+    priv->selection_anchor = -1;
+    priv->selection_cursor = -1;
+
+    gtk_widget_queue_draw (GTK_WIDGET (view));
+}
+
+
+//!
+//! @brief Puts the text of the selected rows on a clipboard.  Nothing is copied
+//!        if no rows are selected.
+//!
+void 
+gw_resultsview_copy_clipboard (GwResultsView *view, GtkClipboard *clipboard)
+{
+    //Declarations
+    gchar *text;
+
+    if (!gw_resultsview_has_selection (view)) return;
+
+    //Initializations
+    text = gw_resultsview_get_text (view);
+
+    gtk_clipboard_set_text (clipboard, text, -1);
+
+    //Cleanup
+    g_free (text);
+}
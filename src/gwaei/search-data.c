@@ -47,6 +47,7 @@ gw_searchdata_new (GtkTextView *view, GwSearchWindow *window)
     {
       temp->window = window;
       temp->view = view;
+      temp->resultsview = NULL;
       temp->resultline = NULL;
     }
     return temp;
@@ -62,6 +63,7 @@ gw_searchdata_free (GwSearchData *data)
 
     data->window = NULL;
     data->view = NULL;
+    data->resultsview = NULL;
     data->resultline = NULL;
 
     free (data);
@@ -108,6 +108,7 @@ gw_searchwindow_motion_notify_event_cb (GtkWidget       *widget,
     if (window == NULL) return FALSE;
     application = gw_window_get_application (GW_WINDOW (window));
     view = gw_searchwindow_get_current_textview (window);
+    if (view == NULL) return FALSE;
     type = gtk_text_view_get_window_type (view, event->window);
     gtk_text_view_window_to_buffer_coords (view, type, (gint) event->x, (gint) event->y, &x, &y);
     gtk_text_view_get_iter_at_position (view, &iter, NULL, x, y);
@@ -189,15 +190,11 @@ gw_searchwindow_get_iter_for_button_release_cb (GtkWidget      *widget,
     //Declarations
     GwSearchWindow *window;
     GwSearchWindowPrivate *priv;
-    GwApplication *application;
-    LwPreferences *preferences;
     GtkTextView *view;
     GtkTextIter iter;
     gint x;
     gint y;
     const gchar *vocabulary_data;
-    LwDictInfoList *dictinfolist;
-    LwDictInfo *dictinfo;
     GtkTextWindowType type;
     gboolean within_movement_threshold;
     gunichar character;
@@ -206,14 +203,11 @@ gw_searchwindow_get_iter_for_button_release_cb (GtkWidget      *widget,
     window = GW_SEARCHWINDOW (gtk_widget_get_ancestor (GTK_WIDGET (data), GW_TYPE_SEARCHWINDOW));
     if (window == NULL) return FALSE;
     priv = window->priv;
-    application = gw_window_get_application (GW_WINDOW (window));
-    preferences = gw_application_get_preferences (application);
     view = gw_searchwindow_get_current_textview (window);
+    if (view == NULL) return FALSE;
     type = gtk_text_view_get_window_type (view, event->window);
     gtk_text_view_window_to_buffer_coords (view, type, (gint) event->x, (gint) event->y, &x, &y);
     gtk_text_view_get_iter_at_position (view, &iter, NULL, x, y);
-    dictinfolist = LW_DICTINFOLIST (gw_application_get_dictinfolist (application));
-    dictinfo = lw_dictinfolist_get_dictinfo (dictinfolist, LW_DICTTYPE_KANJI, "Kanji");
     within_movement_threshold = (abs (priv->mouse_button_press_x - x) < 3 && abs (priv->mouse_button_press_y - y) < 3);
 
     character = gw_searchwindow_hovering_kanji_character (&iter);
@@ -222,46 +216,134 @@ gw_searchwindow_get_iter_for_button_release_cb (GtkWidget      *widget,
     if (!within_movement_threshold) return FALSE;
  
     // Characters above 0xFF00 represent inserted images
-    if (character && dictinfo != NULL)
+    if (character)
     {
-      //Convert the unicode character into to a utf8 string
-      gchar query[7];
-      gint length = g_unichar_to_utf8 (character, query);
-      query[length] = '\0'; 
-
-      //Start the search
-      if (priv->mouse_item != NULL)
-      {
-        lw_searchitem_cancel_search (priv->mouse_item);
-        lw_searchitem_free (priv->mouse_item);
-        priv->mouse_item = NULL;
-      }
       priv->mouse_button_press_x = event->x;
       priv->mouse_button_press_y = event->y;
-      priv->mouse_button_press_root_x = event->x_root; //x position of the tooltip
-      priv->mouse_button_press_root_y = event->y_root; //y position of the tooltip
-      priv->mouse_button_character = character;
-      priv->mouse_item = lw_searchitem_new (query, dictinfo, preferences, NULL);
-      lw_searchitem_start_search (priv->mouse_item, TRUE, FALSE);
+      gw_searchwindow_lookup_kanji (window, character, event->x_root, event->y_root);
     }
     else if (vocabulary_data)
     {
-      GtkWindow *avw = gw_addvocabularywindow_new (GTK_APPLICATION (application));
-      LwVocabularyItem *vi = lw_vocabularyitem_new_from_string (vocabulary_data);
-      gtk_window_set_transient_for (avw, GTK_WINDOW (window));
-      gw_addvocabularywindow_set_kanji (GW_ADDVOCABULARYWINDOW (avw), lw_vocabularyitem_get_kanji (vi));
-      gw_addvocabularywindow_set_furigana (GW_ADDVOCABULARYWINDOW (avw), lw_vocabularyitem_get_furigana (vi));
-      gw_addvocabularywindow_set_definitions (GW_ADDVOCABULARYWINDOW (avw), lw_vocabularyitem_get_definitions (vi));
-      lw_vocabularyitem_free (vi); vi = NULL;
-      gtk_widget_show (GTK_WIDGET (avw));
-      gw_addvocabularywindow_set_focus (GW_ADDVOCABULARYWINDOW (avw), GW_ADDVOCABULARYWINDOW_FOCUS_LIST);
-      g_signal_connect (G_OBJECT (avw), "word-added", G_CALLBACK (gw_searchwindow_add_vocabulary_destroy_cb), NULL);
+      gw_searchwindow_add_vocabulary (window, vocabulary_data);
     }
 
     return FALSE; 
 }
 
 
+//!
+//! @brief Starts a kanji dictionary search for a character and shows the result as a tooltip
+//! @param window The GwSearchWindow to show the tooltip for
+//! @param character The kanji character to look up
+//! @param x_root The x position of the tooltip
+//! @param y_root The y position of the tooltip
+//!
+void 
+gw_searchwindow_lookup_kanji (GwSearchWindow *window, gunichar character, gint x_root, gint y_root)
+{
+    //Declarations
+    GwSearchWindowPrivate *priv;
+    GwApplication *application;
+    LwPreferences *preferences;
+    LwDictInfoList *dictinfolist;
+    LwDictInfo *dictinfo;
+    gchar query[7];
+    gint length;
+
+    //Initializations
+    priv = window->priv;
+    application = gw_window_get_application (GW_WINDOW (window));
+    preferences = gw_application_get_preferences (application);
+    dictinfolist = LW_DICTINFOLIST (gw_application_get_dictinfolist (application));
+    dictinfo = lw_dictinfolist_get_dictinfo (dictinfolist, LW_DICTTYPE_KANJI, "Kanji");
+    if (dictinfo == NULL) return;
+
+    //Convert the unicode character into to a utf8 string
+    length = g_unichar_to_utf8 (character, query);
+    query[length] = '\0'; 
+
+    //Start the search
+    if (priv->mouse_item != NULL)
+    {
+      lw_searchitem_cancel_search (priv->mouse_item);
+      lw_searchitem_free (priv->mouse_item);
+      priv->mouse_item = NULL;
+    }
+    priv->mouse_button_press_root_x = x_root; //x position of the tooltip
+    priv->mouse_button_press_root_y = y_root; //y position of the tooltip
+    priv->mouse_button_character = character;
+    priv->mouse_item = lw_searchitem_new (query, dictinfo, preferences, NULL);
+    if (priv->mouse_item == NULL) return;
+    lw_searchitem_start_search (priv->mouse_item, TRUE, FALSE);
+    lw_searchitem_add_watch (priv->mouse_item, NULL, gw_searchwindow_append_kanjidict_tooltip_watch, g_object_ref (window), g_object_unref);
+}
+
+
+//!
+//! @brief Opens the add vocabulary window filled in with a result
+//! @param window The GwSearchWindow the add vocabulary window is transient for
+//! @param vocabulary_data A result in the LwVocabularyItem string format
+//!
+void 
+gw_searchwindow_add_vocabulary (GwSearchWindow *window, const gchar *vocabulary_data)
+{
+    //Declarations
+    GwApplication *application;
+    GtkWindow *avw;
+    LwVocabularyItem *vi;
+
+    //Initializations
+    application = gw_window_get_application (GW_WINDOW (window));
+    avw = gw_addvocabularywindow_new (GTK_APPLICATION (application));
+    vi = lw_vocabularyitem_new_from_string (vocabulary_data);
+
+    gtk_window_set_transient_for (avw, GTK_WINDOW (window));
+    gw_addvocabularywindow_set_kanji (GW_ADDVOCABULARYWINDOW (avw), lw_vocabularyitem_get_kanji (vi));
+    gw_addvocabularywindow_set_furigana (GW_ADDVOCABULARYWINDOW (avw), lw_vocabularyitem_get_furigana (vi));
+    gw_addvocabularywindow_set_definitions (GW_ADDVOCABULARYWINDOW (avw), lw_vocabularyitem_get_definitions (vi));
+    lw_vocabularyitem_free (vi); vi = NULL;
+    gtk_widget_show (GTK_WIDGET (avw));
+    gw_addvocabularywindow_set_focus (GW_ADDVOCABULARYWINDOW (avw), GW_ADDVOCABULARYWINDOW_FOCUS_LIST);
+    g_signal_connect (G_OBJECT (avw), "word-added", G_CALLBACK (gw_searchwindow_add_vocabulary_destroy_cb), NULL);
+}
+
+
+//!
+//! @brief Looks up a kanji clicked in a list view tab
+//! @see gw_searchwindow_lookup_kanji ()
+//!
+G_MODULE_EXPORT void 
+gw_searchwindow_kanji_activated_cb (GwResultsView *view, guint character, gint x_root, gint y_root, gpointer data)
+{
+    //Declarations
+    GwSearchWindow *window;
+
+    //Initializations
+    window = GW_SEARCHWINDOW (gtk_widget_get_ancestor (GTK_WIDGET (data), GW_TYPE_SEARCHWINDOW));
+    if (window == NULL) return;
+
+    gw_searchwindow_lookup_kanji (window, character, x_root, y_root);
+}
+
+
+//!
+//! @brief Opens the add vocabulary window for a link clicked in a list view tab
+//! @see gw_searchwindow_add_vocabulary ()
+//!
+G_MODULE_EXPORT void 
+gw_searchwindow_vocabulary_activated_cb (GwResultsView *view, const gchar *vocabulary_data, gpointer data)
+{
+    //Declarations
+    GwSearchWindow *window;
+
+    //Initializations
+    window = GW_SEARCHWINDOW (gtk_widget_get_ancestor (GTK_WIDGET (data), GW_TYPE_SEARCHWINDOW));
+    if (window == NULL) return;
+
+    gw_searchwindow_add_vocabulary (window, vocabulary_data);
+}
+
+
 //!
 //! @brief Closes the window passed throught the widget pointer
 //! @param widget GtkWidget pointer to the window to close
@@ -392,6 +474,7 @@ gw_searchwindow_search_from_history_cb (GtkWidget *widget, gpointer data)
     current = gw_searchwindow_get_current_searchitem (window);
     sdata = lw_searchitem_get_data (item);
     sdata->view = gw_searchwindow_get_current_textview (window);
+    sdata->resultsview = gw_searchwindow_get_current_resultsview (window);
     
     //Checks to make sure everything is sane
     gw_searchwindow_cancel_search_for_current_tab (window);
@@ -1084,20 +1167,20 @@ gw_searchwindow_key_press_modify_status_update_cb (GtkWidget *widget,
     //Declarations
     GwSearchWindow *window;
     GwSearchWindowPrivate *priv;
-    GtkTextView *view;
+    GtkWidget *view;
     GtkWidget *tooltip_window;
 
     //Initializations
     window = GW_SEARCHWINDOW (gtk_widget_get_ancestor (GTK_WIDGET (data), GW_TYPE_SEARCHWINDOW));
     if (window == NULL) return FALSE;
     priv = window->priv;
-    view = gw_searchwindow_get_current_textview (window);
-    tooltip_window = GTK_WIDGET (gtk_widget_get_tooltip_window (GTK_WIDGET (view)));
+    view = gw_searchwindow_get_current_view (window);
+    tooltip_window = (view != NULL) ? GTK_WIDGET (gtk_widget_get_tooltip_window (view)) : NULL;
 
     if (tooltip_window != NULL) 
     {
       gtk_widget_destroy (tooltip_window);
-      gtk_widget_set_tooltip_window (GTK_WIDGET (view), NULL);
+      gtk_widget_set_tooltip_window (view, NULL);
     }
 
     guint keyval = ((GdkEventKey*)event)->keyval;
@@ -1165,7 +1248,7 @@ gw_searchwindow_focus_change_on_key_press_cb (GtkWidget *widget,
     guint state;
     guint keyval;
     guint modifiers;
-    GtkTextView *view;
+    GtkWidget *view;
 
     window = GW_SEARCHWINDOW (gtk_widget_get_ancestor (GTK_WIDGET (data), GW_TYPE_SEARCHWINDOW));
     if (window == NULL) return FALSE;
@@ -1183,7 +1266,7 @@ gw_searchwindow_focus_change_on_key_press_cb (GtkWidget *widget,
        GDK_KEY_Alt_L    |
        GDK_KEY_Alt_R
     );
-    view = gw_searchwindow_get_current_textview (window);
+    view = gw_searchwindow_get_current_view (window);
 
     //Make sure no modifier keys are pressed
     if (
@@ -1219,12 +1302,12 @@ gw_searchwindow_focus_change_on_key_press_cb (GtkWidget *widget,
              keyval == GDK_KEY_Page_Down   
            ) &&
            (
-             widget != GTK_WIDGET (view)
+             view != NULL && widget != view
            )
          )
       {
-        gw_searchwindow_select_none (window, GTK_WIDGET (view));
-        gtk_widget_grab_focus (GTK_WIDGET (view));
+        if (GTK_IS_TEXT_VIEW (view)) gw_searchwindow_select_none (window, view);
+        gtk_widget_grab_focus (view);
         return TRUE;
       }
 
@@ -1300,6 +1383,7 @@ gw_searchwindow_search_cb (GtkWidget *widget, gpointer data)
       return;
     }
     sdata = gw_searchdata_new (view, window);
+    sdata->resultsview = gw_searchwindow_get_current_resultsview (window);
     lw_searchitem_set_data (new_item, sdata, LW_SEARCHITEM_DATA_FREE_FUNC (gw_searchdata_free));
 
     //Check for problems, and quit if there are
@@ -1342,6 +1426,65 @@ gw_searchwindow_search_cb (GtkWidget *widget, gpointer data)
 }
 
 
+//!
+//! @brief Shows the words of the search text with their entries in the current tab
+//! @see gw_searchwindow_display_analysis ()
+//! @param widget Unused GtkWidget pointer
+//! @param data A pointer to the GwSearchWindow object
+//!
+G_MODULE_EXPORT void 
+gw_searchwindow_analyze_text_cb (GtkWidget *widget, gpointer data)
+{
+    //Declarations
+    GwApplication *application;
+    GwSearchWindow *window;
+    GwSearchWindowPrivate *priv;
+    LwTextAnalyzer *analyzer;
+    LwDictInfo *di;
+    GList *segments;
+    GtkTextView *view;
+    const gchar *text;
+    GError *error;
+
+    //Initializations
+    error = NULL;
+    window = GW_SEARCHWINDOW (gtk_widget_get_ancestor (GTK_WIDGET (data), GW_TYPE_SEARCHWINDOW));
+    if (window == NULL) return;
+    priv = window->priv;
+    application = gw_window_get_application (GW_WINDOW (window));
+
+    gw_searchwindow_guarantee_first_tab (window);
+    text = gtk_entry_get_text (priv->entry);
+    di = gw_searchwindow_get_dictionary (window);
+    if (strlen(text) == 0 || di == NULL) return;
+
+    analyzer = lw_textanalyzer_new (di, &error);
+    if (analyzer == NULL)
+    {
+      gw_application_handle_error (application, NULL, FALSE, &error);
+      return;
+    }
+
+    //The reading takes the place of the results of the tab.  It is laid out in a
+    //text buffer so a list view tab is switched to a text view.
+    gw_searchwindow_cancel_search_for_current_tab (window);
+    view = gw_searchwindow_guarantee_current_textview (window);
+    if (view == NULL)
+    {
+      lw_textanalyzer_free (analyzer);
+      return;
+    }
+
+    segments = lw_textanalyzer_analyze (analyzer, text);
+    gw_searchwindow_display_analysis (window, view, analyzer, segments);
+
+    //Cleanup
+    g_list_foreach (segments, (GFunc) lw_textsegment_free, NULL);
+    g_list_free (segments);
+    lw_textanalyzer_free (analyzer);
+}
+
+
 //!
 //! @brief Inserts an unknown regex character into the entry
 //! @see gw_searchwindow_insert_word_edge_cb ()
@@ -2368,7 +2511,7 @@ gw_searchwindow_event_after_cb (GtkWidget *widget,
       gtk_action_set_sensitive (action_paste, TRUE);
       gtk_action_set_sensitive (action_select_all, TRUE);
     }
-    else if (GTK_IS_TEXT_VIEW (selectable))
+    else if (GTK_IS_TEXT_VIEW (selectable) || GW_IS_RESULTSVIEW (selectable))
     {
       gtk_action_set_sensitive (action_cut, FALSE);
       gtk_action_set_sensitive (action_copy, has_selection);
@@ -42,63 +42,6 @@ static void gw_searchwindow_append_less_relevant_header (GwSearchWindow*, LwSear
 static void gw_searchwindow_append_more_relevant_header (GwSearchWindow*, LwSearchItem*);
 
 
-static void
-gw_searchwindow_insert_addlink (GwSearchWindow   *window,
-                                GtkTextBuffer    *buffer,
-                                GtkTextIter      *iter,
-                                LwVocabularyItem *item   )
-{
-    //Sanity check
-    g_assert (item != NULL);
-
-    //Declarations
-    GtkTextTag *tag;
-    gchar *data;
-    
-    //Initializations
-    tag = gtk_text_buffer_create_tag (buffer, NULL, 
-        "rise",   5000, 
-        "scale",  0.75, 
-        "weight", PANGO_WEIGHT_BOLD,
-        NULL);
-    data = lw_vocabularyitem_to_string (item);
-    g_object_set_data_full (G_OBJECT (tag), 
-        "vocabulary-data", 
-        data, g_free);
-
-    gtk_text_buffer_insert (buffer, iter, " ", -1);
-    gtk_text_buffer_insert_with_tags (buffer, iter, "+", -1, tag, NULL);
-    gtk_text_buffer_insert (buffer, iter, " ", -1 );
-}
-
-
-void
-gw_searchwindow_insert_edict_addlink (GwSearchWindow *window, LwResultLine *resultline, GtkTextBuffer *buffer, GtkTextIter *iter)
-{
-    //Declarations
-    gchar *kanji, *furigana, *definitions;
-    LwVocabularyItem *item;
-
-    //Initializations
-    kanji = resultline->kanji_start;
-    furigana = resultline->furigana_start;
-    definitions = g_strjoinv ("/", resultline->def_start);
-
-    if (definitions != NULL)
-    {
-      item = lw_vocabularyitem_new ();
-      if (item != NULL)
-      {
-        lw_vocabularyitem_set_kanji (item, kanji);
-        lw_vocabularyitem_set_furigana (item, furigana);
-        lw_vocabularyitem_set_definitions (item, definitions);
-
-        gw_searchwindow_insert_addlink (window, buffer, iter, item);
-      }
-      g_free (definitions);
-    }
-}
-
 //!
 //! @brief Appends a result to the output
 //! @param engine The LwEngine to use for output
@@ -189,369 +132,679 @@ gw_searchwindow_set_header (LwSearchItem *item, char* text, char* mark_name)
 
 
 //!
-//! @brief PRIVATE FUNCTION. Applies a tag to a section of text
+//! @brief PRIVATE FUNCTION. Applies the match tag to the spans the search engine found in a field
 //!
-//! @param line An integer showing the line in the buffer to tag
-//! @param start_offset the ending character in the line to highlight
-//! @param end_offset The ending character in the line to highlight
-//! @param item A LwSearchItem to get general information from
+//! @param buffer The GtkTextBuffer the field was inserted into
+//! @param offset The character offset in the buffer where the field starts
+//! @param resultline The LwResultLine holding the field and its match spans
+//! @param FIELD The LwResultLineField that was inserted
+//! @param index The index of the definition or reading when the field has many
 //!
 static void 
-gw_add_match_highlights (gint line, gint start_offset, gint end_offset, LwSearchItem* item)
+gw_add_match_highlights (GtkTextBuffer *buffer, gint offset, LwResultLine *resultline, LwResultLineField FIELD, gint index)
 {
-    //Sanity check
-    g_assert (lw_searchitem_has_data (item));
-
     //Declarations
-    GwSearchData *sdata;
-    GtkTextView *view;
-    GtkTextBuffer *buffer;
-    LwQueryLine *ql;
-    int match_start_byte_offset;
-    int match_end_byte_offset;
-    int match_character_offset;
+    const char *text;
+    LwResultLineMatch *match;
     GtkTextIter start_iter;
     GtkTextIter end_iter;
-    char *text;
-    GRegex *re;
-    GRegex ***iter;
-    GMatchInfo *match_info;
+    int i;
 
     //Initializations
-    sdata = GW_SEARCHDATA (lw_searchitem_get_data (item));
-    view = GTK_TEXT_VIEW (sdata->view);
-    buffer = gtk_text_view_get_buffer (view);
-    ql = item->queryline;
-    gtk_text_buffer_get_iter_at_line_offset (buffer, &start_iter, line, start_offset);
-    gtk_text_buffer_get_iter_at_line_offset (buffer, &end_iter, line, end_offset);
-    text = gtk_text_buffer_get_slice (buffer, &start_iter, &end_iter, FALSE);
+    text = lw_resultline_get_field (resultline, FIELD, index);
+    if (text == NULL) return;
 
-    //Look for kanji atoms
-    for (iter = ql->re_kanji; *iter != NULL && **iter != NULL; iter++)
+    for (i = 0; i < resultline->match_total; i++)
     {
-      re = (*iter)[LW_RELEVANCE_LOCATE];
-      if (g_regex_match (re, text, 0, &match_info))
-      { 
-        while (g_match_info_matches (match_info))
-        {
-          g_match_info_fetch_pos (match_info, 0, &match_start_byte_offset, &match_end_byte_offset);
-          match_character_offset = g_utf8_pointer_to_offset (text, text + match_start_byte_offset);
-          gtk_text_buffer_get_iter_at_line_offset (buffer, &start_iter, line, match_character_offset + start_offset);
-          match_character_offset = g_utf8_pointer_to_offset (text, text + match_end_byte_offset);
-          gtk_text_buffer_get_iter_at_line_offset (buffer, &end_iter, line, match_character_offset + start_offset);
-          gtk_text_buffer_apply_tag_by_name (buffer, "match", &start_iter, &end_iter);
-          g_match_info_next (match_info, NULL);
-        }
-      }
-      g_match_info_free (match_info);
+      match = &resultline->matches[i];
+      if (match->field != FIELD || match->index != index) continue;
+
+      gtk_text_buffer_get_iter_at_offset (buffer, &start_iter, offset + g_utf8_pointer_to_offset (text, text + match->start));
+      gtk_text_buffer_get_iter_at_offset (buffer, &end_iter, offset + g_utf8_pointer_to_offset (text, text + match->end));
+      gtk_text_buffer_apply_tag_by_name (buffer, "match", &start_iter, &end_iter);
     }
+}
+
+
+gboolean lw_searchitem_next_is_same (LwSearchItem *item, LwResultLine *current)
+{
+  //Declarations
+  GwSearchData *sdata;
+  LwResultLine *previous;
+
+  //Initializations
+  sdata = GW_SEARCHDATA (lw_searchitem_get_data (item));
+  previous = gw_searchdata_get_resultline (sdata);
 
-    //Look for furigana atoms
-    for (iter = ql->re_furi; *iter != NULL && **iter != NULL; iter++)
+  return lw_resultline_is_similar (previous, current);
+}
+
+
+//!
+//! @brief A tagged range of a GwResultRun in character offsets
+//!
+struct _GwResultSpan {
+  gint start;
+  gint end;
+  const gchar *tag;         //!< Name of a tag in the buffer's tag table or NULL
+  gchar *vocabulary;        //!< Data for a new "add to vocabulary" link tag when tag is NULL
+};
+typedef struct _GwResultSpan GwResultSpan;
+
+//!
+//! @brief A batch of formatted results that goes into the buffer with one insert
+//!
+struct _GwResultRun {
+  GString *text;
+  gint length;              //!< Length of the text in characters
+  GArray *spans;            //!< The GwResultSpans to apply after inserting the text
+  gint count;               //!< Number of results in the run
+  LwResultLineRelevance relevance;
+  gint header_offset;       //!< Character offset after the header line of the last entry or -1
+  gsize header_index;       //!< Byte index of header_offset
+};
+typedef struct _GwResultRun GwResultRun;
+
+
+static GwResultRun* 
+gw_resultrun_new ()
+{
+    GwResultRun *temp;
+
+    temp = (GwResultRun*) malloc(sizeof(GwResultRun));
+
+    if (temp != NULL)
     {
-      re = (*iter)[LW_RELEVANCE_LOCATE];
-      if (g_regex_match (re, text, 0, &match_info))
-      { 
-        while (g_match_info_matches (match_info))
-        {
-          g_match_info_fetch_pos (match_info, 0, &match_start_byte_offset, &match_end_byte_offset);
-          match_character_offset = g_utf8_pointer_to_offset (text, text + match_start_byte_offset);
-          gtk_text_buffer_get_iter_at_line_offset (buffer, &start_iter, line, match_character_offset + start_offset);
-          match_character_offset = g_utf8_pointer_to_offset (text, text + match_end_byte_offset);
-          gtk_text_buffer_get_iter_at_line_offset (buffer, &end_iter, line, match_character_offset + start_offset);
-          gtk_text_buffer_apply_tag_by_name (buffer, "match", &start_iter, &end_iter);
-          g_match_info_next (match_info, NULL);
-        }
-      }
-      g_match_info_free (match_info);
+      temp->text = g_string_sized_new (GW_SEARCHWINDOW_RUN_PREALLOCATE);
+      temp->spans = g_array_new (FALSE, FALSE, sizeof(GwResultSpan));
+      temp->length = 0;
+      temp->count = 0;
+      temp->relevance = LW_RESULTLINE_RELEVANCE_UNSET;
+      temp->header_offset = -1;
+      temp->header_index = 0;
+    }
+
+    return temp;
+}
+
+
+static void 
+gw_resultrun_clear (GwResultRun *run)
+{
+    int i;
+
+    for (i = 0; i < run->spans->len; i++)
+      g_free (g_array_index (run->spans, GwResultSpan, i).vocabulary);
+    g_array_set_size (run->spans, 0);
+    g_string_truncate (run->text, 0);
+    run->length = 0;
+    run->count = 0;
+    run->relevance = LW_RESULTLINE_RELEVANCE_UNSET;
+    run->header_offset = -1;
+    run->header_index = 0;
+}
+
+
+static void 
+gw_resultrun_free (GwResultRun *run)
+{
+    gw_resultrun_clear (run);
+    g_array_free (run->spans, TRUE);
+    g_string_free (run->text, TRUE);
+    free (run);
+}
+
+
+static void 
+gw_resultrun_add_span (GwResultRun *run, gint start, gint end, const gchar *TAG, gchar *vocabulary)
+{
+    GwResultSpan span;
+
+    span.start = start;
+    span.end = end;
+    span.tag = TAG;
+    span.vocabulary = vocabulary;
+
+    g_array_append_val (run->spans, span);
+}
+
+
+//!
+//! @brief Appends text to the run with up to two tags applied to it
+//!
+static void 
+gw_resultrun_append (GwResultRun *run, const gchar *TEXT, const gchar *TAG, const gchar *TAG2)
+{
+    //Declarations
+    gint start;
+
+    //Initializations
+    start = run->length;
+
+    g_string_append (run->text, TEXT);
+    run->length += g_utf8_strlen (TEXT, -1);
+
+    if (TAG != NULL) gw_resultrun_add_span (run, start, run->length, TAG, NULL);
+    if (TAG2 != NULL) gw_resultrun_add_span (run, start, run->length, TAG2, NULL);
+}
+
+
+//!
+//! @brief Appends a field of a result to the run and adds "match" spans for the matches the engine found in it
+//!
+//! This is gw_add_match_highlights working on the run instead of the buffer.
+//!
+static void 
+gw_resultrun_append_field (GwResultRun *run, LwResultLine *resultline, LwResultLineField FIELD, gint index, const gchar *TAG)
+{
+    //Declarations
+    const gchar *text;
+    LwResultLineMatch *match;
+    gint offset;
+    int i;
+
+    //Initializations
+    text = lw_resultline_get_field (resultline, FIELD, index);
+    if (text == NULL) return;
+    offset = run->length;
+
+    gw_resultrun_append (run, text, TAG, NULL);
+
+    for (i = 0; i < resultline->match_total; i++)
+    {
+      match = &resultline->matches[i];
+      if (match->field != FIELD || match->index != index) continue;
+
+      gw_resultrun_add_span (run, 
+        offset + g_utf8_pointer_to_offset (text, text + match->start),
+        offset + g_utf8_pointer_to_offset (text, text + match->end),
+        "match", NULL
+      );
     }
+}
 
-    //Look for romaji atoms
-    for (iter = ql->re_roma; *iter != NULL; iter++)
+
+//!
+//! @brief Appends the " +" link that adds an edict result to a vocabulary list
+//!
+static void 
+gw_resultrun_append_edict_addlink (GwResultRun *run, LwResultLine *resultline)
+{
+    //Declarations
+    LwVocabularyItem *item;
+    gchar *definitions;
+    gint start;
+
+    //Initializations
+    definitions = g_strjoinv ("/", resultline->def_start);
+    if (definitions == NULL) return;
+    item = lw_vocabularyitem_new ();
+
+    if (item != NULL)
     {
-      re = (*iter)[LW_RELEVANCE_LOCATE];
-      if (re != NULL)
-      { 
-        if (g_regex_match (re, text, 0, &match_info))
-        {
-          while (g_match_info_matches (match_info))
-          {
-            g_match_info_fetch_pos (match_info, 0, &match_start_byte_offset, &match_end_byte_offset);
-            match_character_offset = g_utf8_pointer_to_offset (text, text + match_start_byte_offset);
-            gtk_text_buffer_get_iter_at_line_offset (buffer, &start_iter, line, match_character_offset + start_offset);
-            match_character_offset = g_utf8_pointer_to_offset (text, text + match_end_byte_offset);
-            gtk_text_buffer_get_iter_at_line_offset (buffer, &end_iter, line, match_character_offset + start_offset);
-            gtk_text_buffer_apply_tag_by_name (buffer, "match", &start_iter, &end_iter);
-            g_match_info_next (match_info, NULL);
-          }
-        }
-        g_match_info_free (match_info);
+      lw_vocabularyitem_set_kanji (item, resultline->kanji_start);
+      lw_vocabularyitem_set_furigana (item, resultline->furigana_start);
+      lw_vocabularyitem_set_definitions (item, definitions);
+
+      gw_resultrun_append (run, " ", NULL, NULL);
+      start = run->length;
+      gw_resultrun_append (run, "+", NULL, NULL);
+      gw_resultrun_add_span (run, start, run->length, NULL, lw_vocabularyitem_to_string (item));
+      gw_resultrun_append (run, " ", NULL, NULL);
+
+      lw_vocabularyitem_free (item);
+    }
+
+    g_free (definitions);
+}
+
+
+//!
+//! @brief Formats the kanji, furigana and tags of an edict result on one line
+//!
+static void 
+gw_resultrun_append_edict_header (GwResultRun *run, LwResultLine *resultline, const gchar *IMPORTANT)
+{
+    if (resultline->kanji_start != NULL)
+    {
+      gw_resultrun_append_field (run, resultline, LW_RESULTLINE_FIELD_KANJI, 0, IMPORTANT);
+    }
+    if (resultline->furigana_start != NULL)
+    {
+      gw_resultrun_append (run, " [", IMPORTANT, NULL);
+      gw_resultrun_append_field (run, resultline, LW_RESULTLINE_FIELD_FURIGANA, 0, IMPORTANT);
+      gw_resultrun_append (run, "]", IMPORTANT, NULL);
+    }
+    if (resultline->classification_start != NULL)
+    {
+      gw_resultrun_append (run, " ", NULL, NULL);
+      gw_resultrun_append (run, resultline->classification_start, "gray", "italic");
+    }
+    if (resultline->important == TRUE)
+    {
+      gw_resultrun_append (run, " ", NULL, NULL);
+      gw_resultrun_append (run, gettext("Pop"), "small", NULL);
+    }
+}
+
+
+//!
+//! @brief Formats the numbered definitions of an edict result, one per line
+//!
+static void 
+gw_resultrun_append_edict_definitions (GwResultRun *run, LwResultLine *resultline)
+{
+    int i;
+
+    for (i = 0; resultline->def_start[i] != NULL; i++)
+    {
+      gw_resultrun_append (run, "      ", NULL, NULL);
+      gw_resultrun_append (run, resultline->number[i], "comment", NULL);
+      gw_resultrun_append (run, " ", NULL, NULL);
+      gw_resultrun_append_field (run, resultline, LW_RESULTLINE_FIELD_DEFINITION, i, NULL);
+      gw_resultrun_append (run, "\n", NULL, NULL);
+    }
+    gw_resultrun_append (run, "\n", NULL, NULL);
+}
+
+
+//!
+//! @brief Inserts a run into another run at a position, shifting the spans after it
+//!
+static void 
+gw_resultrun_splice (GwResultRun *run, GwResultRun *insert, gsize index, gint offset)
+{
+    //Declarations
+    GwResultSpan *span;
+    int i;
+
+    g_string_insert_len (run->text, index, insert->text->str, insert->text->len);
+
+    for (i = 0; i < run->spans->len; i++)
+    {
+      span = &g_array_index (run->spans, GwResultSpan, i);
+      if (span->start >= offset)
+      {
+        span->start += insert->length;
+        span->end += insert->length;
       }
     }
+    for (i = 0; i < insert->spans->len; i++)
+    {
+      span = &g_array_index (insert->spans, GwResultSpan, i);
+      gw_resultrun_add_span (run, span->start + offset, span->end + offset, span->tag, span->vocabulary);
+      span->vocabulary = NULL;
+    }
 
-    //Cleanup
-    g_free (text);
+    run->length += insert->length;
 }
 
 
 //!
-//! @brief PRIVATE FUNCTION. Moves the content insertion mark to another mark's spot
+//! @brief Formats the part of an edict result that is merged into the header line of
+//!        the entry before it when they are the same word
 //!
-//! @param item A LwSearchItem pointer to gleam information from
-//! @param name The name of the mark to move the content insertion mark to
+static void 
+gw_resultrun_append_edict_same (GwResultRun *run, LwResultLine *resultline)
+{
+    gw_resultrun_append (run, " /", "important", NULL);
+    gw_resultrun_append (run, " ", NULL, NULL);
+    gw_resultrun_append_edict_header (run, resultline, "important");
+    gw_resultrun_append_edict_addlink (run, resultline);
+}
+
+
+//!
+//! @brief Formats an edict result into the run.  This is the only edict formatter of
+//!        the text view.  It only works on the run and the search data so it doesn't
+//!        have to run where the buffer is.
+//! @returns FALSE if the result has to be merged into an entry already in the buffer
+//!
+static gboolean 
+gw_resultrun_append_edict_result (GwResultRun *run, LwSearchItem *item, LwResultLine *resultline)
+{
+    //Declarations
+    GwSearchData *sdata;
+    GwResultRun *same;
+
+    //Initializations
+    sdata = GW_SEARCHDATA (lw_searchitem_get_data (item));
+
+    if (lw_searchitem_next_is_same (item, resultline))
+    {
+      if (run->header_offset < 0) return FALSE;
+
+      //Merge into the header line of the previous entry of this run
+      same = gw_resultrun_new ();
+      gw_resultrun_append_edict_same (same, resultline);
+      gw_resultrun_splice (run, same, run->header_index, run->header_offset);
+      gw_resultrun_free (same);
+    }
+    else
+    {
+      gw_resultrun_append_edict_header (run, resultline, "important");
+      gw_resultrun_append_edict_addlink (run, resultline);
+      run->header_offset = run->length;
+      run->header_index = run->text->len;
+      gw_resultrun_append (run, "\n", NULL, NULL);
+      gw_resultrun_append_edict_definitions (run, resultline);
+    }
+
+    gw_searchdata_set_resultline (sdata, resultline);
+    run->count++;
+
+    return TRUE;
+}
+
+
+//!
+//! @brief Tags the text of a run after it was inserted into a buffer
+//! @param start The character offset the run was inserted at
 //!
 static void 
-gw_shift_stay_mark (LwSearchItem *item, char *name)
+gw_resultrun_apply_spans (GwResultRun *run, GtkTextBuffer *buffer, gint start)
 {
-    //Sanity check
-    g_assert (lw_searchitem_has_data (item));
+    //Declarations
+    GtkTextTag *tag;
+    GtkTextIter start_iter, end_iter;
+    GwResultSpan *span;
+    int i;
 
+    for (i = 0; i < run->spans->len; i++)
+    {
+      span = &g_array_index (run->spans, GwResultSpan, i);
+      gtk_text_buffer_get_iter_at_offset (buffer, &start_iter, start + span->start);
+      gtk_text_buffer_get_iter_at_offset (buffer, &end_iter, start + span->end);
+      if (span->tag != NULL)
+      {
+        gtk_text_buffer_apply_tag_by_name (buffer, span->tag, &start_iter, &end_iter);
+      }
+      else
+      {
+        tag = gtk_text_buffer_create_tag (buffer, NULL, 
+            "rise",   5000, 
+            "scale",  0.75, 
+            "weight", PANGO_WEIGHT_BOLD,
+            NULL);
+        g_object_set_data_full (G_OBJECT (tag), "vocabulary-data", span->vocabulary, g_free);
+        span->vocabulary = NULL;
+        gtk_text_buffer_apply_tag (buffer, tag, &start_iter, &end_iter);
+      }
+    }
+}
+
+
+//!
+//! @brief Puts a run into the buffer with a single insert and then tags it
+//!
+static void 
+gw_searchwindow_apply_resultrun (GwSearchWindow *window, LwSearchItem *item, GwResultRun *run)
+{
     //Declarations
     GwSearchData *sdata;
-    GtkTextView *view;
     GtkTextBuffer *buffer;
     GtkTextMark *mark;
     GtkTextIter iter;
+    gint start;
+
+    if (run->count == 0) return;
 
     //Initializations
     sdata = GW_SEARCHDATA (lw_searchitem_get_data (item));
-    view = GTK_TEXT_VIEW (sdata->view);
-    buffer = gtk_text_view_get_buffer (view);
+    buffer = gtk_text_view_get_buffer (GTK_TEXT_VIEW (sdata->view));
+
+    if (run->relevance == LW_RESULTLINE_RELEVANCE_HIGH)
+      gw_searchwindow_append_more_relevant_header (window, item);
+    else
+      gw_searchwindow_append_less_relevant_header (window, item);
+
     mark = gtk_text_buffer_get_mark (buffer, "content_insertion_mark");
     gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark);
+    start = gtk_text_iter_get_offset (&iter);
+    gtk_text_buffer_insert (buffer, &iter, run->text->str, run->text->len);
 
-    if ((mark = gtk_text_buffer_get_mark (buffer, name)) == NULL)
-      gtk_text_buffer_create_mark (buffer, name, &iter, TRUE);
-    else
-      gtk_text_buffer_move_mark (buffer, mark, &iter);
+    gw_resultrun_apply_spans (run, buffer, start);
+
+    //Later results that merge into the last entry are inserted at this mark
+    if (run->header_offset >= 0)
+    {
+      gtk_text_buffer_get_iter_at_offset (buffer, &iter, start + run->header_offset);
+      if ((mark = gtk_text_buffer_get_mark (buffer, "previous_result")) == NULL)
+        gtk_text_buffer_create_mark (buffer, "previous_result", &iter, TRUE);
+      else
+        gtk_text_buffer_move_mark (buffer, mark, &iter);
+    }
 }
 
 
 //!
-//! @brief PRIVATE FUNCTION.  Updates the position of a mark to accomidate new results.
-//!
-//! @param item A LwSearchItem to gleam information from.
-//! @param stay_name The name of the mark that stays in place before the new result.
-//! @param append_name The name of the mark that moves to the end after the new result is added.
+//! @brief Merges an edict result into the header line of the last entry in the buffer
 //!
 static void 
-gw_searchwindow_shift_append_mark (GwSearchWindow *window, LwSearchItem *item, char *stay_name, char *append_name)
+gw_searchwindow_merge_edict_result (GwSearchWindow *window, LwSearchItem *item, LwResultLine *resultline)
 {
-    //Sanity check
-    g_assert (lw_searchitem_has_data (item));
-
     //Declarations
     GwSearchData *sdata;
-    GtkTextView *view;
     GtkTextBuffer *buffer;
+    GtkTextMark *mark;
     GtkTextIter iter;
-    GtkTextMark *stay_mark, *append_mark;
+    GwResultRun *same;
+    gint start;
 
     //Initializations
     sdata = GW_SEARCHDATA (lw_searchitem_get_data (item));
-    view = GTK_TEXT_VIEW (sdata->view);
-    buffer = gtk_text_view_get_buffer (view);
-    stay_mark = gtk_text_buffer_get_mark (buffer, stay_name);
-    gtk_text_buffer_get_iter_at_mark (buffer, &iter, stay_mark);
+    buffer = gtk_text_view_get_buffer (GTK_TEXT_VIEW (sdata->view));
+    mark = gtk_text_buffer_get_mark (buffer, "previous_result");
+    if (mark == NULL) return;
+    same = gw_resultrun_new ();
 
-    if ((append_mark = gtk_text_buffer_get_mark (buffer, append_name)) == NULL)
-      gtk_text_buffer_create_mark (buffer, append_name, &iter, FALSE);
-    else
-      gtk_text_buffer_move_mark (buffer, append_mark, &iter);
+    gw_resultrun_append_edict_same (same, resultline);
+
+    gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark);
+    start = gtk_text_iter_get_offset (&iter);
+    gtk_text_buffer_insert (buffer, &iter, same->text->str, same->text->len);
+    gw_resultrun_apply_spans (same, buffer, start);
+
+    //Cleanup
+    gw_resultrun_free (same);
 }
 
 
 //!
-//! @brief PRIVATE FUNCTION.  When adding a result to the buffer, it just adds the the kanji/hiragana section
-//!
-//! This function is made to help readability of edict results since there is a lot of repeating.
-//!
-//! @param item A LwSearchItem pointer to use for sdata.
+//! @brief Adds an edict result to a run, putting the run into the buffer first
+//!        when the result can't go into it
 //!
 static void 
-gw_searchwindow_append_def_same_to_buffer (GwSearchWindow *window, LwSearchItem* item, LwResultLine *resultline)
+gw_searchwindow_add_edict_result (GwSearchWindow *window, LwSearchItem *item, GwResultRun *run, LwResultLine *resultline)
 {
-    //Sanity check
-    g_assert (lw_searchitem_has_data (item));
-
     //Declarations
     GwSearchData *sdata;
-    GtkTextView *view;
-    GtkTextBuffer *buffer;
-    GtkTextMark *mark;
 
     //Initializations
     sdata = GW_SEARCHDATA (lw_searchitem_get_data (item));
-    view = GTK_TEXT_VIEW (sdata->view);
-    buffer = gtk_text_view_get_buffer (view);
 
-    gw_searchwindow_shift_append_mark (window, item, "previous_result", "new_result");
-    if ((mark = gtk_text_buffer_get_mark (buffer, "previous_result")) != NULL)
+    //A run only holds results for one of the two result sections
+    if (run->count > 0 && (run->relevance == LW_RESULTLINE_RELEVANCE_HIGH) != (resultline->relevance == LW_RESULTLINE_RELEVANCE_HIGH))
     {
-      GtkTextIter iter;
-      int line, start_offset, end_offset;
-      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark);
-      line = gtk_text_iter_get_line (&iter);
-      start_offset = gtk_text_iter_get_line_offset (&iter);
-      gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, " /", -1, "important", NULL);
-      gtk_text_buffer_insert (buffer, &iter, " ", -1);
-      //Kanji
-      if (resultline->kanji_start != NULL)
-        gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, resultline->kanji_start, -1, "important", NULL);
-      //Furigana
-      if (resultline->furigana_start != NULL)
-      {
-        gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, " [", -1, "important", NULL);
-        gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, resultline->furigana_start, -1, "important", NULL);
-        gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, "]", -1, "important", NULL);
-      }
-      //Other info
-      if (resultline->classification_start != NULL)
-      {
-        gtk_text_buffer_insert (buffer, &iter, " ", -1);
-        GtkTextIter copy = iter;
-        gtk_text_iter_backward_char (&copy);
-        gtk_text_buffer_remove_tag_by_name (buffer, "important", &copy, &iter);
-        gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, resultline->classification_start, -1, "gray", "italic", NULL);
-      }
-      if (resultline->important == TRUE)
-      {
-        gtk_text_buffer_insert                   (buffer, &iter, " ", -1);
-        gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, gettext("Pop"), -1, "small", NULL);
-      }
-      end_offset = gtk_text_iter_get_line_offset (&iter);
-      gw_add_match_highlights (line, start_offset, end_offset, item);
-
-      gw_searchwindow_insert_edict_addlink (window, resultline, buffer, &iter);
+      gw_searchwindow_apply_resultrun (window, item, run);
+      gw_resultrun_clear (run);
     }
+    if (run->count == 0) run->relevance = resultline->relevance;
 
+    if (!gw_resultrun_append_edict_result (run, item, resultline))
+    {
+      gw_searchwindow_apply_resultrun (window, item, run);
+      gw_resultrun_clear (run);
+      gw_searchwindow_merge_edict_result (window, item, resultline);
+      gw_searchdata_set_resultline (sdata, resultline);
+    }
 }
 
 
-gboolean lw_searchitem_next_is_same (LwSearchItem *item, LwResultLine *current)
+//!
+//! @brief Appends one edict result to the buffer as a run of one result
+//!
+static void 
+gw_searchwindow_append_edict_result (GwSearchWindow *window, LwSearchItem *item)
 {
-  //Declarations
-  GwSearchData *sdata;
-  LwResultLine *previous;
+    //Declarations
+    LwResultLine *resultline;
+    GwResultRun *run;
 
-  //Initializations
-  sdata = GW_SEARCHDATA (lw_searchitem_get_data (item));
-  previous = gw_searchdata_get_resultline (sdata);
+    //Initializations
+    resultline = lw_searchitem_get_result (item);
+    if (resultline == NULL) return;
+    run = gw_resultrun_new ();
 
-  return lw_resultline_is_similar (previous, current);
+    gw_searchwindow_add_edict_result (window, item, run, resultline);
+    gw_searchwindow_apply_resultrun (window, item, run);
+
+    //Cleanup
+    gw_resultrun_free (run);
 }
 
 
 //!
-//! @brief Appends an edict style result to the buffer, adding nice formatting.
+//! @brief Appends the waiting results of a search until a deadline passes
 //!
-//! This is a part of a set of functions used for the global output function pointers and
-//! isn't used directly
+//! Edict results are formatted into runs that go into the buffer with one insert
+//! each.  The run size adapts to the measured cost per result so that a run fits
+//! in what is left of the frame.  Other dictionary types are appended one result
+//! at a time.
 //!
-//! @param item A LwSearchItem to gleam information from.
+//! @param window The GwSearchWindow the results belong to
+//! @param item The LwSearchItem to take the results from
+//! @param deadline The g_get_monotonic_time value to stop at
 //!
-static void 
-gw_searchwindow_append_edict_result (GwSearchWindow *window, LwSearchItem *item)
+void 
+gw_searchwindow_append_results (GwSearchWindow *window, LwSearchItem *item, gint64 deadline)
 {
-    //Sanity check
-    if (window == NULL || item == NULL) return;
-    g_assert (lw_searchitem_has_data (item));
-
     //Declarations
+    GwSearchWindowPrivate *priv;
+    GwResultRun *run;
     LwResultLine *resultline;
     GwSearchData *sdata;
-    GtkTextView *view;
-    GtkTextBuffer *buffer;
-    GtkTextMark *mark;
-    GtkTextIter iter;
-    int line, start_offset, end_offset;
+    gint64 start;
+    gint64 now;
+    gint batch;
 
     //Initializations
-    resultline = lw_searchitem_get_result (item);
-    if (resultline == NULL) return;
+    priv = window->priv;
     sdata = GW_SEARCHDATA (lw_searchitem_get_data (item));
-    view = GTK_TEXT_VIEW (sdata->view);
-    buffer = gtk_text_view_get_buffer (view);
 
-    if (lw_searchitem_next_is_same (item, resultline))
+    //List view tabs only store the results.  Rows are laid out when they are shown.
+    if (sdata->resultsview != NULL)
     {
-      gw_searchwindow_append_def_same_to_buffer (window, item, resultline);
-      gw_searchdata_set_resultline (sdata, resultline);
+      while (g_get_monotonic_time () < deadline && (resultline = lw_searchitem_get_result (item)) != NULL)
+      {
+        gw_resultsview_append (sdata->resultsview, resultline);
+        lw_resultline_free (resultline);
+      }
       return;
     }
 
-    gw_searchdata_set_resultline (sdata, resultline);
-
-    switch (resultline->relevance)
+    if (item->dictionary->type != LW_DICTTYPE_EDICT)
     {
-      case LW_RESULTLINE_RELEVANCE_HIGH:
-        gw_searchwindow_append_more_relevant_header (window, item);
-        break;
-      case LW_RESULTLINE_RELEVANCE_MEDIUM:
-      case LW_RESULTLINE_RELEVANCE_LOW:
-        gw_searchwindow_append_less_relevant_header (window, item);
-        break;
-      default:
-        g_assert_not_reached ();
-        break;
+      while (lw_searchitem_has_result (item) && g_get_monotonic_time () < deadline)
+        gw_searchwindow_append_result (window, item);
+      return;
     }
 
-    //Start output
-    mark = gtk_text_buffer_get_mark (buffer, "content_insertion_mark");
-
-    gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark);
-    line = gtk_text_iter_get_line (&iter);
+    run = gw_resultrun_new ();
 
-    //Kanji
-    if (resultline->kanji_start != NULL)
+    while (lw_searchitem_has_result (item) && (start = g_get_monotonic_time ()) < deadline)
     {
-      gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, resultline->kanji_start, -1, "important", NULL);
-    }
+      if (priv->render_cost > 0.0)
+        batch = CLAMP ((gint) ((deadline - start) / priv->render_cost), 1, GW_SEARCHWINDOW_MAX_RUN);
+      else
+        batch = GW_SEARCHWINDOW_FIRST_RUN;
 
-    //Furigana
-    if (resultline->furigana_start != NULL)
-    {
-      gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, " [", -1, "important", NULL);
-      gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, resultline->furigana_start, -1, "important", NULL);
-      gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, "]", -1, "important", NULL);
+      while (run->count < batch && (resultline = lw_searchitem_get_result (item)) != NULL)
+        gw_searchwindow_add_edict_result (window, item, run, resultline);
+
+      batch = run->count;
+      gw_searchwindow_apply_resultrun (window, item, run);
+      gw_resultrun_clear (run);
+
+      //Keep a running average of the microseconds a result takes
+      now = g_get_monotonic_time ();
+      if (batch > 0)
+      {
+        if (priv->render_cost > 0.0)
+          priv->render_cost = 0.75 * priv->render_cost + 0.25 * (gdouble) (now - start) / (gdouble) batch;
+        else
+          priv->render_cost = (gdouble) (now - start) / (gdouble) batch;
+      }
     }
-    //Other info
-    if (resultline->classification_start != NULL)
+
+    gw_resultrun_free (run);
+}
+
+
+//!
+//! @brief Replaces the contents of a text view with an annotated reading of a text
+//!
+//! The text is shown first with its words marked, then each word in text order
+//! with the entries the analyzer chose for it.
+//!
+//! @param window The GwSearchWindow the view belongs to
+//! @param view The GtkTextView of a tab
+//! @param analyzer The LwTextAnalyzer the segments came from
+//! @param segments The LwTextSegments from lw_textanalyzer_analyze
+//!
+void 
+gw_searchwindow_display_analysis (GwSearchWindow *window, GtkTextView *view, LwTextAnalyzer *analyzer, GList *segments)
+{
+    //Declarations
+    GtkTextBuffer *buffer;
+    GtkTextIter iter;
+    GwResultRun *run;
+    LwResultLine *resultline;
+    LwTextSegment *segment;
+    GList *link;
+    gint i;
+
+    //Initializations
+    buffer = gtk_text_view_get_buffer (view);
+    run = gw_resultrun_new ();
+    resultline = lw_resultline_new ();
+
+    //The text with spaces between the words
+    for (link = segments; link != NULL; link = link->next)
     {
-      gtk_text_buffer_insert (buffer, &iter, " ", -1);
-      gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, resultline->classification_start, -1, "gray", "italic", NULL);
+      segment = link->data;
+      if (link != segments) gw_resultrun_append (run, " ", NULL, NULL);
+      gw_resultrun_append (run, segment->text, "larger", (segment->total_entries > 0) ? "match" : NULL);
     }
-    if (resultline->important == TRUE)
+    gw_resultrun_append (run, "\n\n", NULL, NULL);
+
+    //The entries of each word
+    for (link = segments; link != NULL; link = link->next)
     {
-      gtk_text_buffer_insert (buffer, &iter, " ", -1);
-      gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, gettext("Pop"), -1, "small", NULL);
-    }
+      segment = link->data;
+      if (segment->total_entries == 0) continue;
 
-    gw_searchwindow_insert_edict_addlink (window, resultline, buffer, &iter);
+      gw_resultrun_append (run, segment->text, "header", "important");
+      gw_resultrun_append (run, "\n", NULL, NULL);
 
-    gw_shift_stay_mark (item, "previous_result");
-    start_offset = 0;
-    end_offset = gtk_text_iter_get_line_offset (&iter);
+      for (i = 0; i < segment->total_entries; i++)
+      {
+        if (!lw_textanalyzer_read_entry (analyzer, segment->entries[i], resultline)) continue;
+        gw_resultrun_append_edict_header (run, resultline, "important");
+        gw_resultrun_append_edict_addlink (run, resultline);
+        gw_resultrun_append (run, "\n", NULL, NULL);
+        gw_resultrun_append_edict_definitions (run, resultline);
+      }
+    }
 
-    gtk_text_buffer_insert (buffer, &iter, "\n", -1);
-    gw_add_match_highlights (line, start_offset, end_offset, item);
+    gtk_text_buffer_set_text (buffer, "", -1);
+    gtk_text_buffer_get_start_iter (buffer, &iter);
+    gtk_text_buffer_insert (buffer, &iter, run->text->str, run->text->len);
+    gw_resultrun_apply_spans (run, buffer, 0);
 
-    //Definitions
-    int i = 0;
-    while (resultline->def_start[i] != NULL)
-    {
-      gtk_text_buffer_insert (buffer, &iter, "      ", -1);
-
-      gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, resultline->number[i], -1, "comment", NULL);
-      gtk_text_buffer_insert                   (buffer, &iter, " ", -1);
-      gtk_text_buffer_insert                   (buffer, &iter, resultline->def_start[i], -1);
-      end_offset = gtk_text_iter_get_line_offset (&iter);
-      line = gtk_text_iter_get_line (&iter);
-      gw_add_match_highlights (line, start_offset, end_offset, item);
-      gtk_text_buffer_insert                   (buffer, &iter, "\n", -1);
-      i++;
-    }
-    gtk_text_buffer_insert (buffer, &iter, "\n", -1);
+    //Cleanup
+    lw_resultline_free (resultline);
+    gw_resultrun_free (run);
 }
 
 
@@ -577,7 +830,7 @@ gw_searchwindow_append_kanjidict_result (GwSearchWindow *window, LwSearchItem *i
     GtkTextBuffer *buffer;
     GtkTextIter iter;
     GtkTextMark *mark;
-    int line, start_offset, end_offset;
+    int offset;
 
     //Initializations
     application = gw_window_get_application (GW_WINDOW (window));
@@ -607,28 +860,27 @@ gw_searchwindow_append_kanjidict_result (GwSearchWindow *window, LwSearchItem *i
     gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark);
 
     //Kanji
-    gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); start_offset = gtk_text_iter_get_line_offset (&iter);
+    gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); offset = gtk_text_iter_get_offset (&iter);
     gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, resultline->kanji, -1, "large", "center", NULL);
     gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, " ", -1, "large", "center", NULL);
-    gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); end_offset = gtk_text_iter_get_line_offset (&iter);
-    gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); line = gtk_text_iter_get_line (&iter);
-    gw_add_match_highlights (line, start_offset, end_offset, item);
+    gw_add_match_highlights (buffer, offset, resultline, LW_RESULTLINE_FIELD_CHARACTER, 0);
 
+    gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark);
     gtk_text_buffer_insert (buffer, &iter, "\n", -1);
-    gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); line = gtk_text_iter_get_line (&iter);
+    gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark);
 
     //Radicals
     if (resultline->radicals != NULL)
     {
       gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, gettext("Radicals:"), -1, "important", NULL);
-      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); start_offset = gtk_text_iter_get_line_offset (&iter);
+      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); offset = gtk_text_iter_get_offset (&iter);
       gtk_text_buffer_insert (buffer, &iter, resultline->radicals, -1);
       gtk_text_buffer_insert (buffer, &iter, " ", -1);
-      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); end_offset = gtk_text_iter_get_line_offset (&iter);
-      gw_add_match_highlights (line, start_offset, end_offset, item);
+      gw_add_match_highlights (buffer, offset, resultline, LW_RESULTLINE_FIELD_RADICALS, 0);
 
+      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark);
       gtk_text_buffer_insert (buffer, &iter, "\n", -1);
-      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); line = gtk_text_iter_get_line (&iter);
+      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark);
 
       GwRadicalsWindow *radicalswindow;
       radicalswindow =  GW_RADICALSWINDOW (gw_application_get_window_by_type (application, GW_TYPE_RADICALSWINDOW));
@@ -642,32 +894,32 @@ gw_searchwindow_append_kanjidict_result (GwSearchWindow *window, LwSearchItem *i
     if (resultline->readings[0] != NULL)
     {
       gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, gettext("Readings:"), -1, "important", NULL);
-      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); start_offset = gtk_text_iter_get_line_offset (&iter);
+      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); offset = gtk_text_iter_get_offset (&iter);
       gtk_text_buffer_insert (buffer, &iter, resultline->readings[0], -1);
-      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); end_offset = gtk_text_iter_get_line_offset (&iter);
-      gw_add_match_highlights (line, start_offset, end_offset, item);
+      gw_add_match_highlights (buffer, offset, resultline, LW_RESULTLINE_FIELD_READING, 0);
+      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark);
       gtk_text_buffer_insert (buffer, &iter, "\n", -1);
-      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); line = gtk_text_iter_get_line (&iter);
+      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark);
     }
     if (resultline->readings[1] != NULL)
     {
       gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, gettext("Name:"), -1, "important", NULL);
-      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); start_offset = gtk_text_iter_get_line_offset (&iter);
+      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); offset = gtk_text_iter_get_offset (&iter);
       gtk_text_buffer_insert (buffer, &iter, resultline->readings[1], -1);
-      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); end_offset = gtk_text_iter_get_line_offset (&iter);
-      gw_add_match_highlights (line, start_offset, end_offset, item);
+      gw_add_match_highlights (buffer, offset, resultline, LW_RESULTLINE_FIELD_READING, 1);
+      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark);
       gtk_text_buffer_insert (buffer, &iter, "\n", -1);
-      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); line = gtk_text_iter_get_line (&iter);
+      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark);
     }
     if (resultline->readings[2] != NULL)
     {
       gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, gettext("Radical Name:"), -1, "important", NULL);
-      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); start_offset = gtk_text_iter_get_line_offset (&iter);
+      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); offset = gtk_text_iter_get_offset (&iter);
       gtk_text_buffer_insert (buffer, &iter, resultline->readings[2], -1);
-      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); end_offset = gtk_text_iter_get_line_offset (&iter);
-      gw_add_match_highlights (line, start_offset, end_offset, item);
+      gw_add_match_highlights (buffer, offset, resultline, LW_RESULTLINE_FIELD_READING, 2);
+      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark);
       gtk_text_buffer_insert (buffer, &iter, "\n", -1);
-      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); line = gtk_text_iter_get_line (&iter);
+      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark);
     }
 
 
@@ -700,14 +952,14 @@ gw_searchwindow_append_kanjidict_result (GwSearchWindow *window, LwSearchItem *i
     }
 
     gtk_text_buffer_insert (buffer, &iter, "\n", -1);
-    gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); line = gtk_text_iter_get_line (&iter);
+    gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark);
 
     //Meanings
-    gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); start_offset = gtk_text_iter_get_line_offset (&iter);
     gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, gettext("Meanings:"), -1, "important", NULL);
+    gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); offset = gtk_text_iter_get_offset (&iter);
     gtk_text_buffer_insert (buffer, &iter, resultline->meanings, -1);
-    gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); end_offset = gtk_text_iter_get_line_offset (&iter);
-    gw_add_match_highlights (line, start_offset, end_offset, item);
+    gw_add_match_highlights (buffer, offset, resultline, LW_RESULTLINE_FIELD_MEANINGS, 0);
+    gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark);
 
     gtk_text_buffer_insert (buffer, &iter, "\n\n", -1);
 }
@@ -732,7 +984,7 @@ gw_searchwindow_append_examplesdict_result (GwSearchWindow *window, LwSearchItem
     LwResultLine *resultline;
     GtkTextView *view;
     GtkTextBuffer *buffer;
-    int line, start_offset, end_offset;
+    int offset;
     GtkTextMark *mark;
     GtkTextIter iter;
 
@@ -751,33 +1003,30 @@ gw_searchwindow_append_examplesdict_result (GwSearchWindow *window, LwSearchItem
     {
       // TRANSLATORS: The "E" stands for "English"
       gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, gettext("E:\t"), -1, "important", "comment", NULL);
-      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); start_offset = gtk_text_iter_get_line_offset (&iter);
+      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); offset = gtk_text_iter_get_offset (&iter);
       gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, resultline->def_start[0], -1, "important", NULL, NULL);
-      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); end_offset = gtk_text_iter_get_line_offset (&iter);
-      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); line = gtk_text_iter_get_line (&iter);
-      gw_add_match_highlights (line, start_offset, end_offset, item);
+      gw_add_match_highlights (buffer, offset, resultline, LW_RESULTLINE_FIELD_DEFINITION, 0);
+      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark);
     }
 
     if (resultline->kanji_start != NULL)
     {
       // TRANSLATORS: The "J" stands for "Japanese"
       gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, gettext("\nJ:\t"), -1, "important", "comment", NULL);
-      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); start_offset = gtk_text_iter_get_line_offset (&iter);
+      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); offset = gtk_text_iter_get_offset (&iter);
       gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, resultline->kanji_start, -1, NULL, NULL, NULL);
-      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); end_offset = gtk_text_iter_get_line_offset (&iter);
-      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); line = gtk_text_iter_get_line (&iter);
-      gw_add_match_highlights (line, start_offset, end_offset, item);
+      gw_add_match_highlights (buffer, offset, resultline, LW_RESULTLINE_FIELD_KANJI, 0);
+      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark);
     }
 
     if (resultline->furigana_start != NULL)
     {
       // TRANSLATORS: The "D" stands for "Detail"
       gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, gettext("\nD:\t"), -1, "important", "comment", NULL);
-      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); start_offset = gtk_text_iter_get_line_offset (&iter);
+      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); offset = gtk_text_iter_get_offset (&iter);
       gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, resultline->furigana_start, -1, NULL, NULL, NULL);
-      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); end_offset = gtk_text_iter_get_line_offset (&iter);
-      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); line = gtk_text_iter_get_line (&iter);
-      gw_add_match_highlights (line, start_offset, end_offset, item);
+      gw_add_match_highlights (buffer, offset, resultline, LW_RESULTLINE_FIELD_FURIGANA, 0);
+      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark);
     }
 
     gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark);
@@ -806,7 +1055,7 @@ gw_searchwindow_append_unknowndict_result (GwSearchWindow *window, LwSearchItem
     GtkTextBuffer *buffer;
     GtkTextIter iter;
     GtkTextMark *mark;
-    int line, start_offset, end_offset;
+    int offset;
 
 
     //Initializations
@@ -819,16 +1068,13 @@ gw_searchwindow_append_unknowndict_result (GwSearchWindow *window, LwSearchItem
 
     gw_searchdata_set_resultline (sdata, resultline);
 
-    gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); start_offset = gtk_text_iter_get_line_offset (&iter);
+    gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); offset = gtk_text_iter_get_offset (&iter);
     gtk_text_buffer_insert (buffer, &iter, resultline->string, -1);
     gtk_text_buffer_insert (buffer, &iter, " ", -1);
-    gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); end_offset = gtk_text_iter_get_line_offset (&iter);
-    gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); line = gtk_text_iter_get_line (&iter);
-    gw_add_match_highlights (line, start_offset, end_offset, item);
+    gw_add_match_highlights (buffer, offset, resultline, LW_RESULTLINE_FIELD_STRING, 0);
 
     gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark);
     gtk_text_buffer_insert (buffer, &iter, "\n\n", -1);
-    gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); line = gtk_text_iter_get_line (&iter);
 }
 
 
@@ -882,7 +1128,7 @@ gw_searchwindow_append_kanjidict_tooltip_result (GwSearchWindow *window, LwSearc
     //Declarations
     GwSearchWindowPrivate *priv;
     LwResultLine *resultline;
-    GtkTextView *view;
+    GtkWidget *view;
     char *markup;
     char *new;
     char *base;
@@ -899,7 +1145,7 @@ gw_searchwindow_append_kanjidict_tooltip_result (GwSearchWindow *window, LwSearc
     resultline = lw_searchitem_get_result (item);
     if (resultline == NULL) return;
     priv = window->priv;
-    view = gw_searchwindow_get_current_textview (window);
+    view = gw_searchwindow_get_current_view (window);
     if (view == NULL) return;
     markup = g_strdup ("");
     new = NULL;
@@ -1000,7 +1246,7 @@ gw_searchwindow_append_kanjidict_tooltip_result (GwSearchWindow *window, LwSearc
     }
 
     markup2 = g_markup_printf_escaped ("<span font=\"KanjiStrokeOrders 80\">%s</span>", resultline->kanji);
-    tooltip_window = GTK_WIDGET (gtk_widget_get_tooltip_window (GTK_WIDGET (view)));
+    tooltip_window = GTK_WIDGET (gtk_widget_get_tooltip_window (view));
 
     if (tooltip_window != NULL) {
       gtk_widget_destroy (tooltip_window);
@@ -1014,7 +1260,7 @@ gw_searchwindow_append_kanjidict_tooltip_result (GwSearchWindow *window, LwSearc
     gtk_window_set_transient_for (GTK_WINDOW (tooltip_window), NULL);
     gtk_window_set_type_hint (GTK_WINDOW (tooltip_window), GDK_WINDOW_TYPE_HINT_TOOLTIP);
     gtk_widget_set_name (GTK_WIDGET (tooltip_window), "gtk-tooltip");
-    gtk_widget_set_tooltip_window (GTK_WIDGET (view), GTK_WINDOW (tooltip_window));
+    gtk_widget_set_tooltip_window (view, GTK_WINDOW (tooltip_window));
     gtk_window_set_gravity (GTK_WINDOW (tooltip_window), GDK_GRAVITY_NORTH_WEST);
     gtk_window_set_position (GTK_WINDOW (tooltip_window), GTK_WIN_POS_NONE);
     gtk_window_move (GTK_WINDOW (tooltip_window), x, y);
@@ -1101,6 +1347,7 @@ gw_searchwindow_display_no_results_found_page (GwSearchWindow *window, LwSearchI
     application = gw_window_get_application (GW_WINDOW (window));
     dictinfolist = LW_DICTINFOLIST (gw_application_get_dictinfolist (application));
     sdata = (GwSearchData*) lw_searchitem_get_data (item);
+    if (sdata->view == NULL) return; //The list view has no page to show this on
     view = GTK_TEXT_VIEW (sdata->view);
     buffer = gtk_text_view_get_buffer (view);
     query_text = gtk_entry_get_text (priv->entry);
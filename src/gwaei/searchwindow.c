@@ -287,16 +287,12 @@ gw_searchwindow_init_accelerators (GwSearchWindow *window)
 
 
 //!
-//! @brief Updates the progress information based on the LwSearchItem info
-//! @param item A LwSearchItem pointer to gleam information from.
-//! @returns Currently always returns TRUE
+//! @brief Updates the progress information based on the current LwSearchItem info
+//! @param window The GwSearchWindow to update
 //!
-gboolean 
-gw_searchwindow_update_progress_feedback_timeout (GwSearchWindow *window)
+void 
+gw_searchwindow_update_progress_feedback (GwSearchWindow *window)
 {
-    //Sanity checks
-    if (gtk_widget_get_visible (GTK_WIDGET (window)) == FALSE) return TRUE;
-
     //Declarations
     GwSearchWindowPrivate *priv;
     LwSearchItem *item;
@@ -325,49 +321,70 @@ gw_searchwindow_update_progress_feedback_timeout (GwSearchWindow *window)
         }
       lw_searchitem_unlock_mutex (item);
     }
-
-   return TRUE;
 }
 
 
+//!
+//! @brief Appends the results a search has ready.  The engine wakes this watch
+//!        up when results arrive so there is no polling delay.  It only appends
+//!        for GW_SEARCHWINDOW_FRAME_BUDGET milliseconds at a time so the window
+//!        keeps redrawing, and the rest is picked up on the next dispatch.
+//! @param item The LwSearchItem being watched
+//! @param data The GwSearchWindow the results go to
+//! @returns FALSE once the search is finished and all of its results are shown
+//!
 gboolean 
-gw_searchwindow_append_result_timeout (GwSearchWindow *window)
+gw_searchwindow_append_result_watch (LwSearchItem *item, gpointer data)
 {
-    //Sanity check
-    if (gtk_widget_get_visible (GTK_WIDGET (window)) == FALSE) return TRUE;
+    //Declarations
+    GwSearchWindow *window;
+    gint64 deadline;
+
+    //Initializations
+    window = GW_SEARCHWINDOW (data);
+    deadline = g_get_monotonic_time () + GW_SEARCHWINDOW_FRAME_BUDGET * 1000;
+
+    gw_searchwindow_append_results (window, item, deadline);
+
+    if (item == gw_searchwindow_get_current_searchitem (window))
+    {
+      gw_searchwindow_update_progress_feedback (window);
+    }
+
+    if (lw_searchitem_should_check_results (item)) return TRUE;
+
+    gw_searchwindow_display_no_results_found_page (window, item);
+
+    return FALSE;
+}
 
+
+//!
+//! @brief Shows the kanji tooltip as soon as the mouse item search has a result
+//! @param item The LwSearchItem being watched
+//! @param data The GwSearchWindow that shows the tooltip
+//!
+gboolean 
+gw_searchwindow_append_kanjidict_tooltip_watch (LwSearchItem *item, gpointer data)
+{
     //Declarations
+    GwSearchWindow *window;
     GwSearchWindowPrivate *priv;
-    LwSearchItem *item;
-    int chunk;
-    int max_chunk;
 
     //Initializations
+    window = GW_SEARCHWINDOW (data);
     priv = window->priv;
-    item = gw_searchwindow_get_current_searchitem (window);
-    chunk = 0;
-    max_chunk = 10;
-    
-    if (item != NULL && lw_searchitem_should_check_results (item))
-    {
-      while (item != NULL && lw_searchitem_should_check_results (item) && chunk < max_chunk)
-      {
-        gw_searchwindow_append_result (window, item);
-        chunk++;
-      }
-    }
-    else
-    {
-        gw_searchwindow_display_no_results_found_page (window, item);
-    }
 
-    
-    if (priv->mouse_item != NULL)
+    if (item != priv->mouse_item) return FALSE;
+
+    if (lw_searchitem_has_result (item))
     {
-      gw_searchwindow_append_kanjidict_tooltip_result (window, priv->mouse_item);
+      //This frees the item and with it the watch
+      gw_searchwindow_append_kanjidict_tooltip_result (window, item);
+      return FALSE;
     }
 
-    return TRUE;
+    return lw_searchitem_should_check_results (item);
 }
 
 
@@ -561,11 +578,22 @@ gw_searchwindow_set_total_results_label_by_searchitem (GwSearchWindow *window, L
 
       char *base_message = NULL;
       char *final_message = NULL;
+      char *stats_message = NULL;
+      LwSearchStats stats;
 
       //Initializations
       switch (item->status)
       {
         case LW_SEARCHSTATUS_IDLE:
+            //Put a compact summary of the search stats in the tooltip.  The
+            //callers can hold the item mutex so it is read directly.
+            stats = item->stats;
+            if (item->current > 0L)
+              stats_message = g_strdup_printf (gettext("%ld lines scanned in %.0f ms (first result after %.0f ms)"),
+                                               stats.lines_scanned, stats.wall_time * 1000.0,
+                                               (stats.first_result_time < 0.0) ? stats.wall_time * 1000.0 : stats.first_result_time * 1000.0);
+            gtk_widget_set_tooltip_text (label, stats_message);
+
             if (item->current == 0L)
               gtk_label_set_text (GTK_LABEL (label), idle_message_none);
             else if (relevant == total)
@@ -596,6 +624,8 @@ gw_searchwindow_set_total_results_label_by_searchitem (GwSearchWindow *window, L
       //Finalize
       if (base_message != NULL)
         g_free (base_message);
+      if (stats_message != NULL)
+        g_free (stats_message);
       if (final_message != NULL)
       {
         gtk_label_set_text(GTK_LABEL (label), final_message);
@@ -1001,10 +1031,18 @@ gw_searchwindow_initialize_buffer_by_searchitem (GwSearchWindow *window, LwSearc
     GtkTextBuffer *buffer;
 
     data = GW_SEARCHDATA (lw_searchitem_get_data (item));
+
+    if (data->resultsview != NULL)
+    {
+      gw_resultsview_reset (data->resultsview, item);
+      gw_searchwindow_set_total_results_label_by_searchitem (window, item);
+      return;
+    }
+
     view = GTK_TEXT_VIEW (data->view);
+    if (view == NULL) return;
     buffer = gtk_text_view_get_buffer (view);
-
-    if (view == NULL || buffer == NULL) return;
+    if (buffer == NULL) return;
 
     gtk_text_buffer_set_text (buffer, "", -1);
 
@@ -1096,6 +1134,10 @@ gw_searchwindow_select_all (GwSearchWindow* window, GtkWidget *widget)
       gtk_text_buffer_get_end_iter (buffer, &end);
       gtk_text_buffer_select_range (buffer, &start, &end);
     }
+    else if (GW_IS_RESULTSVIEW (widget))
+    {
+      gw_resultsview_select_all (GW_RESULTSVIEW (widget));
+    }
     else
     {
       g_warning ("Unsupported widget type for gw_searchwindow_select_all()\n");
@@ -1129,6 +1171,10 @@ gw_searchwindow_select_none (GwSearchWindow *window, GtkWidget *widget)
       gtk_text_buffer_get_end_iter (buffer, &end);
       gtk_text_buffer_select_range (buffer, &start, &end);
     }
+    else if (GW_IS_RESULTSVIEW (widget))
+    {
+      gw_resultsview_select_none (GW_RESULTSVIEW (widget));
+    }
     else
     {
       g_warning ("Unsupported widget type for gw_searchwindow_select_none()\n");
@@ -1159,6 +1205,11 @@ gw_searchwindow_copy_text (GwSearchWindow* window, GtkWidget *widget)
       clipboard = gtk_clipboard_get (GDK_SELECTION_CLIPBOARD);
       gtk_text_buffer_copy_clipboard (buffer, clipboard);
     }
+    else if (GW_IS_RESULTSVIEW (widget))
+    {
+      clipboard = gtk_clipboard_get (GDK_SELECTION_CLIPBOARD);
+      gw_resultsview_copy_clipboard (GW_RESULTSVIEW (widget), clipboard);
+    }
     else
     {
       g_warning ("Unsupported widget type for gw_searchwindow_copy_text()\n");
@@ -1295,10 +1346,18 @@ char*
 gw_searchwindow_get_text (GwSearchWindow *window, GtkWidget *widget)
 {
     GtkTextView *view;
+    GwResultsView *resultsview;
     GtkTextBuffer *buffer;
     GtkTextIter s, e;
 
     view = gw_searchwindow_get_current_textview (window);
+    if (view == NULL)
+    {
+      //The list view returns its selected rows or all of them in the same way
+      resultsview = gw_searchwindow_get_current_resultsview (window);
+      if (resultsview == NULL) return NULL;
+      return gw_resultsview_get_text (resultsview);
+    }
     buffer = gtk_text_view_get_buffer (view);
 
     if (gtk_text_buffer_get_has_selection (buffer))
@@ -1388,6 +1447,10 @@ gw_searchwindow_has_selection (GwSearchWindow *window, GtkWidget *widget)
       buffer = gtk_text_view_get_buffer (GTK_TEXT_VIEW (widget));
       has_selection = (buffer != NULL && gtk_text_buffer_get_has_selection (buffer));
     }
+    else if (GW_IS_RESULTSVIEW (widget))
+    {
+      has_selection = gw_resultsview_has_selection (GW_RESULTSVIEW (widget));
+    }
     else
     {
       has_selection = FALSE;
@@ -1495,8 +1558,12 @@ gw_searchwindow_cancel_search_by_content (GwSearchWindow *window, gpointer conta
 }
 
 
-GtkTextView* 
-gw_searchwindow_get_current_textview (GwSearchWindow *window)
+//!
+//! @brief Gets the widget showing the results of the current tab
+//! @returns A GtkTextView, a GwResultsView or NULL if there are no tabs
+//!
+GtkWidget* 
+gw_searchwindow_get_current_view (GwSearchWindow *window)
 {
     //Sanity check
     g_assert (window != NULL);
@@ -1505,7 +1572,7 @@ gw_searchwindow_get_current_textview (GwSearchWindow *window)
     GwSearchWindowPrivate *priv;
     int page_num;
     GtkScrolledWindow *scrolledwindow;
-    GtkTextView *view;
+    GtkWidget *view;
 
     //Initializations
     priv = window->priv;
@@ -1513,12 +1580,46 @@ gw_searchwindow_get_current_textview (GwSearchWindow *window)
     page_num = gtk_notebook_get_current_page (priv->notebook);
     scrolledwindow = GTK_SCROLLED_WINDOW (gtk_notebook_get_nth_page (priv->notebook, page_num));
     if (scrolledwindow != NULL)
-      view = GTK_TEXT_VIEW (gtk_bin_get_child (GTK_BIN (scrolledwindow)));
+      view = gtk_bin_get_child (GTK_BIN (scrolledwindow));
 
     return view;
 }
 
 
+//!
+//! @brief Gets the text view of the current tab
+//! @returns The GtkTextView or NULL if the tab uses the list view
+//!
+GtkTextView* 
+gw_searchwindow_get_current_textview (GwSearchWindow *window)
+{
+    GtkWidget *view;
+
+    view = gw_searchwindow_get_current_view (window);
+
+    if (view == NULL || !GTK_IS_TEXT_VIEW (view)) return NULL;
+
+    return GTK_TEXT_VIEW (view);
+}
+
+
+//!
+//! @brief Gets the list view of the current tab
+//! @returns The GwResultsView or NULL if the tab uses a text view
+//!
+GwResultsView* 
+gw_searchwindow_get_current_resultsview (GwSearchWindow *window)
+{
+    GtkWidget *view;
+
+    view = gw_searchwindow_get_current_view (window);
+
+    if (view == NULL || !GW_IS_RESULTSVIEW (view)) return NULL;
+
+    return GW_RESULTSVIEW (view);
+}
+
+
 //!
 //! @brief Makes sure that at least one tab is available to output search results.
 //!
@@ -1607,55 +1708,137 @@ gw_searchwindow_set_tab_text_by_searchitem (GwSearchWindow *window, LwSearchItem
 
 
 //!
-//! @brief Creats a new tab.  The focus and other details are handled by gw_tabs_new_cb ()
+//! @brief Creates the widget the results of a tab are shown in
+//! @param list_view TRUE for a GwResultsView or FALSE for a GtkTextView
 //!
-int 
-gw_searchwindow_new_tab (GwSearchWindow *window)
+static GtkWidget* 
+gw_searchwindow_new_view (GwSearchWindow *window, gboolean list_view)
 {
     //Declarations
     GwApplication *application;
-    GwSearchWindowPrivate *priv;
-    GtkWidget *scrolledwindow;
-    GtkTextView *view;
+    GtkWidget *view;
+    GtkTextView *textview;
     GtkTextBuffer *buffer;
     GtkTextIter iter;
     GtkTextTagTable *tagtable;
 
     //Initializations
     application = gw_window_get_application (GW_WINDOW (window));
-    priv = window->priv;
     tagtable = gw_application_get_tagtable (application);
-    scrolledwindow = GTK_WIDGET (gtk_scrolled_window_new (NULL, NULL));
-    buffer = GTK_TEXT_BUFFER (gtk_text_buffer_new (tagtable));
-    view = GTK_TEXT_VIEW (gtk_text_view_new_with_buffer (buffer));
 
-    //Set up the text buffer
-    gtk_text_buffer_get_start_iter (buffer, &iter);
-    gtk_text_buffer_create_mark (buffer, "more_relevant_header_mark", &iter, TRUE);
-    gtk_text_buffer_create_mark (buffer, "less_relevant_header_mark", &iter, TRUE);
-    gtk_text_buffer_create_mark (buffer, "less_rel_content_insertion_mark", &iter, FALSE);
-    gtk_text_buffer_create_mark (buffer, "more_rel_content_insertion_mark", &iter, FALSE);
-    gtk_text_buffer_create_mark (buffer, "content_insertion_mark", &iter, FALSE);
-    gtk_text_buffer_create_mark (buffer, "footer_insertion_mark", &iter, FALSE);
+    if (list_view)
+    {
+      //Set up the list view
+      view = gw_resultsview_new (tagtable);
+
+      g_signal_connect (G_OBJECT (view), "kanji-activated", G_CALLBACK (gw_searchwindow_kanji_activated_cb), window);
+      g_signal_connect (G_OBJECT (view), "vocabulary-activated", G_CALLBACK (gw_searchwindow_vocabulary_activated_cb), window);
+    }
+    else
+    {
+      buffer = GTK_TEXT_BUFFER (gtk_text_buffer_new (tagtable));
+      view = gtk_text_view_new_with_buffer (buffer);
+      textview = GTK_TEXT_VIEW (view);
+
+      //Set up the text buffer
+      gtk_text_buffer_get_start_iter (buffer, &iter);
+      gtk_text_buffer_create_mark (buffer, "more_relevant_header_mark", &iter, TRUE);
+      gtk_text_buffer_create_mark (buffer, "less_relevant_header_mark", &iter, TRUE);
+      gtk_text_buffer_create_mark (buffer, "less_rel_content_insertion_mark", &iter, FALSE);
+      gtk_text_buffer_create_mark (buffer, "more_rel_content_insertion_mark", &iter, FALSE);
+      gtk_text_buffer_create_mark (buffer, "content_insertion_mark", &iter, FALSE);
+      gtk_text_buffer_create_mark (buffer, "footer_insertion_mark", &iter, FALSE);
+
+      //Set up the text view
+      gtk_text_view_set_right_margin (textview, 10);
+      gtk_text_view_set_left_margin (textview, 10);
+      gtk_text_view_set_cursor_visible (textview, FALSE); 
+      gtk_text_view_set_editable (textview, FALSE);
+      gtk_text_view_set_wrap_mode (textview, GTK_WRAP_WORD);
+
+      g_signal_connect (G_OBJECT (view), "drag_motion", G_CALLBACK (gw_searchwindow_drag_motion_1_cb), window);
+      g_signal_connect (G_OBJECT (view), "button_press_event", G_CALLBACK (gw_searchwindow_get_position_for_button_press_cb), window);
+      g_signal_connect (G_OBJECT (view), "motion_notify_event", G_CALLBACK (gw_searchwindow_motion_notify_event_cb), window);
+      g_signal_connect (G_OBJECT (view), "drag_drop", G_CALLBACK (gw_searchwindow_drag_drop_1_cb), window);
+      g_signal_connect (G_OBJECT (view), "button_release_event", G_CALLBACK (gw_searchwindow_get_iter_for_button_release_cb), window);
+      g_signal_connect (G_OBJECT (view), "drag_leave", G_CALLBACK (gw_searchwindow_drag_leave_1_cb), window);
+      g_signal_connect (G_OBJECT (view), "drag_data_received", G_CALLBACK (gw_searchwindow_search_drag_data_recieved_cb), window);
+    }
 
-    //Set up the text view
-    gtk_text_view_set_right_margin (view, 10);
-    gtk_text_view_set_left_margin (view, 10);
-    gtk_text_view_set_cursor_visible (view, FALSE); 
-    gtk_text_view_set_editable (view, FALSE);
-    gtk_scrolled_window_set_policy (GTK_SCROLLED_WINDOW (scrolledwindow), GTK_POLICY_AUTOMATIC, GTK_POLICY_ALWAYS);
-    gtk_text_view_set_wrap_mode (view, GTK_WRAP_WORD);
-
-    g_signal_connect (G_OBJECT (view), "drag_motion", G_CALLBACK (gw_searchwindow_drag_motion_1_cb), window);
-    g_signal_connect (G_OBJECT (view), "button_press_event", G_CALLBACK (gw_searchwindow_get_position_for_button_press_cb), window);
-    g_signal_connect (G_OBJECT (view), "motion_notify_event", G_CALLBACK (gw_searchwindow_motion_notify_event_cb), window);
-    g_signal_connect (G_OBJECT (view), "drag_drop", G_CALLBACK (gw_searchwindow_drag_drop_1_cb), window);
-    g_signal_connect (G_OBJECT (view), "button_release_event", G_CALLBACK (gw_searchwindow_get_iter_for_button_release_cb), window);
-    g_signal_connect (G_OBJECT (view), "drag_leave", G_CALLBACK (gw_searchwindow_drag_leave_1_cb), window);
-    g_signal_connect (G_OBJECT (view), "drag_data_received", G_CALLBACK (gw_searchwindow_search_drag_data_recieved_cb), window);
     g_signal_connect (G_OBJECT (view), "key_press_event", G_CALLBACK (gw_searchwindow_focus_change_on_key_press_cb), window);
     g_signal_connect (G_OBJECT (view), "scroll_event", G_CALLBACK (gw_searchwindow_scroll_or_zoom_cb), window);
 
+    return view;
+}
+
+
+//!
+//! @brief Makes sure the current tab shows its results in a text view.  A list
+//!        view is swapped for one so things that are laid out in a text buffer,
+//!        like a reading, can be shown in the tab.
+//! @returns The GtkTextView of the current tab or NULL if there are no tabs
+//!
+GtkTextView* 
+gw_searchwindow_guarantee_current_textview (GwSearchWindow *window)
+{
+    //Declarations
+    GtkWidget *scrolledwindow;
+    GtkWidget *view;
+    LwSearchItem *item;
+    GwSearchData *sdata;
+
+    //Initializations
+    view = gw_searchwindow_get_current_view (window);
+    if (view == NULL) return NULL;
+    if (GTK_IS_TEXT_VIEW (view)) return GTK_TEXT_VIEW (view);
+    scrolledwindow = gtk_widget_get_parent (view);
+    item = gw_searchwindow_get_current_searchitem (window);
+
+    //The search of the tab writes to the view so it has to stop first
+    gw_searchwindow_cancel_search_for_current_tab (window);
+
+    gtk_widget_destroy (view);
+    view = gw_searchwindow_new_view (window, FALSE);
+    gtk_container_add (GTK_CONTAINER (scrolledwindow), view);
+    gtk_widget_show (view);
+    gw_searchwindow_set_font (window);
+
+    //Don't leave the search item of the tab pointing to the destroyed view
+    if (item != NULL)
+    {
+      sdata = GW_SEARCHDATA (lw_searchitem_get_data (item));
+      if (sdata != NULL)
+      {
+        sdata->view = GTK_TEXT_VIEW (view);
+        sdata->resultsview = NULL;
+      }
+    }
+
+    return GTK_TEXT_VIEW (view);
+}
+
+
+//!
+//! @brief Creats a new tab.  The focus and other details are handled by gw_tabs_new_cb ()
+//!
+int 
+gw_searchwindow_new_tab (GwSearchWindow *window)
+{
+    //Declarations
+    GwApplication *application;
+    GwSearchWindowPrivate *priv;
+    LwPreferences *preferences;
+    GtkWidget *scrolledwindow;
+    GtkWidget *view;
+
+    //Initializations
+    application = gw_window_get_application (GW_WINDOW (window));
+    priv = window->priv;
+    preferences = gw_application_get_preferences (application);
+    scrolledwindow = GTK_WIDGET (gtk_scrolled_window_new (NULL, NULL));
+    view = gw_searchwindow_new_view (window, lw_preferences_get_boolean_by_schema (preferences, LW_SCHEMA_BASE, LW_KEY_RESULTS_LIST_VIEW));
+
+    gtk_scrolled_window_set_policy (GTK_SCROLLED_WINDOW (scrolledwindow), GTK_POLICY_AUTOMATIC, GTK_POLICY_ALWAYS);
 
     gtk_container_add (GTK_CONTAINER (scrolledwindow), GTK_WIDGET (view));
     gtk_widget_show_all (GTK_WIDGET (scrolledwindow));
@@ -1840,6 +2023,12 @@ gw_searchwindow_set_current_searchitem (GwSearchWindow *window, LwSearchItem *it
     enable = (item != NULL);
     gtk_action_set_sensitive (action, enable);
 
+    //Update Analyze sensitivity state
+    id = "edit_analyze_action";
+    action = GTK_ACTION (gw_window_get_object (GW_WINDOW (window), id));
+    enable = (gw_searchwindow_get_current_view (window) != NULL);
+    gtk_action_set_sensitive (action, enable);
+
     //Set the label's mnemonic widget since glade doesn't seem to want to
     id = "search_entry_label";
     label = GTK_LABEL (gw_window_get_object (GW_WINDOW (window), id));
@@ -1884,6 +2073,7 @@ gw_searchwindow_start_search (GwSearchWindow *window, LwSearchItem* item)
     if (!gw_application_can_start_search (application)) return;
     view = gw_searchwindow_get_current_textview (window);
     sdata = GW_SEARCHDATA (gw_searchdata_new (view, window));
+    sdata->resultsview = gw_searchwindow_get_current_resultsview (window);
 
     gw_searchwindow_guarantee_first_tab (window);
     lw_searchitem_set_data (item, sdata, LW_SEARCHITEM_DATA_FREE_FUNC (gw_searchdata_free));
@@ -1891,6 +2081,7 @@ gw_searchwindow_start_search (GwSearchWindow *window, LwSearchItem* item)
     gw_searchwindow_initialize_buffer_by_searchitem (sdata->window, item);
 
     lw_searchitem_start_search (item, TRUE, FALSE);
+    lw_searchitem_add_watch (item, NULL, gw_searchwindow_append_result_watch, g_object_ref (window), g_object_unref);
     gw_searchwindow_update_history_popups (window);
 }
 
@@ -1906,7 +2097,7 @@ gw_searchwindow_set_font (GwSearchWindow *window)
     GwSearchWindowPrivate *priv;
     LwPreferences *preferences;
 
-    GtkTextView *view;
+    GtkWidget *view;
     gboolean use_global_font_setting;
     int size;
     int magnification;
@@ -1954,9 +2145,9 @@ gw_searchwindow_set_font (GwSearchWindow *window)
       i = 0;
       while ((container = GTK_CONTAINER (gtk_notebook_get_nth_page (priv->notebook, i))) != NULL)
       {
-        view = GTK_TEXT_VIEW (gtk_bin_get_child (GTK_BIN (container)));
+        view = gtk_bin_get_child (GTK_BIN (container));
         if (view != NULL)
-          gtk_widget_override_font (GTK_WIDGET (view), desc);
+          gtk_widget_override_font (view, desc);
         i++;
       }
 
@@ -2088,21 +2279,6 @@ gw_searchwindow_attach_signals (GwSearchWindow *window)
           (GSourceFunc) gw_searchwindow_keep_searching_timeout, 
           window
     );
-
-    priv->timeoutid[GW_SEARCHWINDOW_TIMEOUTID_PROGRESS] = g_timeout_add_full (
-          G_PRIORITY_LOW, 
-          100, 
-          (GSourceFunc) gw_searchwindow_update_progress_feedback_timeout, 
-          window, 
-          NULL
-    );
-    priv->timeoutid[GW_SEARCHWINDOW_TIMEOUTID_APPEND_RESULT] = g_timeout_add_full (
-          G_PRIORITY_LOW, 
-          100, 
-          (GSourceFunc) gw_searchwindow_append_result_timeout, 
-          window, 
-          NULL
-    );
 }
 
 
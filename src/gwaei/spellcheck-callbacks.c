@@ -88,6 +88,24 @@ static int _get_string_index (GtkEntry *entry, int x, int y)
 }
 
 
+//!
+//! @brief Converts the character offset of a correction to a byte index of the entry text
+//! @returns The index or -1 if the text is too short now
+//!
+static int _get_text_index (GtkEntry *entry, int offset)
+{
+    //Declarations
+    const char *text;
+
+    //Initializations
+    text = gtk_entry_get_text (entry);
+
+    if (offset < 0 || offset > g_utf8_strlen (text, -1)) return -1;
+
+    return (g_utf8_offset_to_pointer (text, offset) - text);
+}
+
+
 gboolean _get_line_coordinates (GwSpellcheck *spellcheck, int startindex, int endindex, int *x, int *y, int *x2, int *y2)
 {
     //Declarations
@@ -189,11 +207,11 @@ void gw_spellcheck_populate_cb (GtkEntry *entry, GtkMenu *menu, gpointer data)
       //Create the start and end offsets 
       split = g_strsplit (iter->data, ":", 2);
       info = g_strsplit (split[0], " ", -1); 
-      start_offset = (int) g_ascii_strtoull (info[3], NULL, 10);
+      start_offset = _get_text_index (entry, (int) g_ascii_strtoull (info[3], NULL, 10));
       end_offset = strlen(info[1]) + start_offset;
 
       //If the mouse position is between the offsets, create the popup menuitems
-      if (index >= start_offset && index <= end_offset)
+      if (start_offset > -1 && index >= start_offset && index <= end_offset)
       {
         replacements = g_strsplit (split[1], ",", -1);
 
@@ -250,15 +268,18 @@ gboolean gw_spellcheck_draw_underline_cb (GtkWidget *widget, cairo_t *cr, gpoint
       info = g_strsplit (iter->data, ":", -1);
       atoms = g_strsplit (info[0], " ", -1);
 
-      start_offset = (int) g_ascii_strtoull (atoms[3], NULL, 10);
-      end_offset = strlen(atoms[1]) + start_offset;
-      start_offset = gtk_entry_text_index_to_layout_index (GTK_ENTRY (widget), start_offset);
-      end_offset = gtk_entry_text_index_to_layout_index (GTK_ENTRY (widget), end_offset);
-
-      //Calculate the line
-      if (_get_line_coordinates (spellcheck, start_offset, end_offset, &x, &y, &x2, &y2))
+      start_offset = _get_text_index (GTK_ENTRY (widget), (int) g_ascii_strtoull (atoms[3], NULL, 10));
+      if (start_offset > -1)
       {
-        _draw_line (cr, x, y, x2, y2);
+        end_offset = strlen(atoms[1]) + start_offset;
+        start_offset = gtk_entry_text_index_to_layout_index (GTK_ENTRY (widget), start_offset);
+        end_offset = gtk_entry_text_index_to_layout_index (GTK_ENTRY (widget), end_offset);
+
+        //Calculate the line
+        if (_get_line_coordinates (spellcheck, start_offset, end_offset, &x, &y, &x2, &y2))
+        {
+          _draw_line (cr, x, y, x2, y2);
+        }
       }
 
       g_strfreev (info);
@@ -302,110 +323,29 @@ void gw_spellcheck_queue_cb (GtkEditable *editable, gpointer data)
 }
 
 
-GwSpellcheckStreamWithData* gw_spellcheck_streamwithdata_new (GwSpellcheck *spellcheck, int stream, const char* data, int length, GPid pid)
-{
-    GwSpellcheckStreamWithData *temp;
-
-    if ((temp = malloc(sizeof(GwSpellcheckStreamWithData))) != NULL)
-    {
-      temp->spellcheck = spellcheck;
-      temp->stream = stream;
-      temp->data = malloc(length);
-      if (temp->data != NULL) strncpy(temp->data, data, length);
-      temp->length = length;
-      temp->pid = pid;
-    }
-
-    return temp;
-}
-
-
-void gw_spellcheck_streamwithdata_free (GwSpellcheckStreamWithData *swd)
-{
-    free(swd->data);
-    free(swd);
-}
-
-
-static gpointer _infunc (gpointer data)
-{
-    //Declarations
-    GwSpellcheckStreamWithData *swd;
-    FILE *file;
-    int stream;
-    char *text;
-
-    //Initializations
-    swd = data;
-    stream = swd->stream;
-    text = swd->data;
-    file = fdopen(stream, "w");
-
-    if (file != NULL)
-    {
-      if (ferror(file) == 0 && feof(file) == 0)
-      {
-        fwrite(text, sizeof(char), strlen(text), file);
-      }
-
-      fclose(file);
-    }
-
-    gw_spellcheck_streamwithdata_free (swd);
-
-    return NULL;
-}
-
-
-static gpointer _outfunc (gpointer data)
+//!
+//! @brief Gets the paths of the dictionaries whose glosses the spellindex is made from
+//!
+static gchar** _get_gloss_dictionary_paths (GwApplication *application)
 {
     //Declarations
-    const int MAX = 500;
-    GwSpellcheckStreamWithData *swd;
-    FILE *file;
-    char buffer[MAX];
-    GwSpellcheck *spellcheck;
+    LwDictInfoList *dictinfolist;
+    LwDictInfo *di;
+    GPtrArray *paths;
+    GList *iter;
 
     //Initializations
-    swd = data;
-    spellcheck = swd->spellcheck;
-    file = fdopen (swd->stream, "r");
+    dictinfolist = LW_DICTINFOLIST (gw_application_get_dictinfolist (application));
+    paths = g_ptr_array_new ();
 
-    if (file != NULL)
+    for (iter = dictinfolist->list; iter != NULL; iter = iter->next)
     {
-
-      //Clear out the old links
-      while (spellcheck->corrections != NULL)
-      {
-        g_mutex_lock (spellcheck->mutex);
-        g_free (spellcheck->corrections->data);
-        spellcheck->corrections = g_list_delete_link (spellcheck->corrections, spellcheck->corrections);
-        g_mutex_unlock (spellcheck->mutex);
-      }
-
-      //Add the new links
-      while (file != NULL && ferror(file) == 0 && feof(file) == 0 && fgets(buffer, MAX, file) != NULL)
-      {
-        g_mutex_lock (spellcheck->mutex);
-        if (buffer[0] != '@' && buffer[0] != '*' && buffer[0] != '#' && strlen(buffer) > 1)
-          spellcheck->corrections = g_list_append (spellcheck->corrections, g_strdup (buffer));
-        g_mutex_unlock (spellcheck->mutex);
-      }
-
-      //Cleanup
-      fclose (file);
+      di = LW_DICTINFO (iter->data);
+      if (di->type == LW_DICTTYPE_EDICT) g_ptr_array_add (paths, lw_dictinfo_get_uri (di));
     }
+    g_ptr_array_add (paths, NULL);
 
-    g_spawn_close_pid (swd->pid);
-
-    gw_spellcheck_streamwithdata_free (swd);
-
-    g_mutex_lock (spellcheck->mutex);
-    spellcheck->running_check = FALSE;
-    spellcheck->thread = NULL;
-    g_mutex_unlock (spellcheck->mutex);
-
-    return NULL;
+    return (gchar**) g_ptr_array_free (paths, FALSE);
 }
 
 
@@ -462,16 +402,10 @@ gboolean gw_spellcheck_update_timeout (gpointer data)
     gboolean is_convertable_to_hiragana;
     const int MAX = 300;
     char kana[MAX];
-    gboolean exists;
+    LwSpellIndex *spellindex;
+    GwSpellcheckJob *job;
+    gchar **paths;
     GError *error;
-
-    char *argv[] = { ENCHANT, "-a", "-d", "en", NULL};
-    GPid pid;
-    int stdin_stream;
-    int stdout_stream;
-    gboolean success;
-    GwSpellcheckStreamWithData *indata;
-    GwSpellcheckStreamWithData *outdata;
     
     //Initializations
     rk_conv_pref = lw_preferences_get_int_by_schema (preferences, LW_SCHEMA_BASE, LW_KEY_ROMAN_KANA);
@@ -479,12 +413,10 @@ gboolean gw_spellcheck_update_timeout (gpointer data)
     query = gtk_entry_get_text (spellcheck->entry);
     is_convertable_to_hiragana = (want_conv && lw_util_str_roma_to_hira (query, kana, MAX));
     spellcheck_pref = lw_preferences_get_boolean_by_schema (preferences, LW_SCHEMA_BASE, LW_KEY_SPELLCHECK);
-    exists = g_file_test (ENCHANT, G_FILE_TEST_IS_REGULAR);
     error = NULL;
 
     //Sanity checks
     if (
-      exists == FALSE    || 
       strlen(query) == 0 || 
       !spellcheck_pref   || 
       !spellcheck->sensitive        || 
@@ -498,36 +430,15 @@ gboolean gw_spellcheck_update_timeout (gpointer data)
 
     spellcheck->needs_spellcheck = FALSE;
 
-    success = g_spawn_async_with_pipes (
-      NULL, 
-      argv,
-      NULL,
-      0,
-      NULL,
-      NULL,
-      &pid,
-      &stdin_stream,
-      &stdout_stream,
-      NULL,
-      &error
-    );
-
-    if (success)
-    {
-      indata = gw_spellcheck_streamwithdata_new (spellcheck, stdin_stream, query, strlen(query) + 1, pid);
-      outdata = gw_spellcheck_streamwithdata_new (spellcheck, stdout_stream, query, strlen(query) + 1, pid);
+    //The dictionary glosses are read on the spellcheck thread the first time
+    spellindex = gw_application_get_spellindex (application);
+    paths = (lw_spellindex_is_loaded (spellindex)) ? NULL : _get_gloss_dictionary_paths (application);
+    job = gw_spellcheck_job_new (spellcheck, query, spellindex, paths);
 
-      if (indata != NULL && outdata != NULL)
-      {
-        _infunc ((gpointer) indata);
-        spellcheck->thread = g_thread_create (_outfunc, (gpointer) outdata, TRUE, &error);
-      }
-
-      if (spellcheck->thread == NULL)
-      {
-        spellcheck->running_check = FALSE;
-      }
-    }
+    if (job != NULL)
+      g_thread_pool_push (spellcheck->pool, job, &error);
+    else
+      spellcheck->running_check = FALSE;
     
     gw_application_handle_error (application, NULL, FALSE, &error);
 
@@ -22,12 +22,17 @@
 //!
 //! @file spellcheck.c
 //!
-//! @brief To be written
+//! @brief Spellchecking of the English words of the search entry
+//!
+//! The words are checked on a thread of their own against the glosses of
+//! the installed dictionaries and an enchant coprocess that is kept running
+//! for as long as the entry has a spellcheck.
 //!
 
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <unistd.h>
 
 #include <gtk/gtk.h>
 
@@ -35,6 +40,8 @@
 
 static void gw_spellcheck_attach_signals (GwSpellcheck*);
 static void gw_spellcheck_remove_signals (GwSpellcheck*);
+static void gw_spellcheck_check (gpointer, gpointer);
+static void gw_spellcheck_stop_enchant (GwSpellcheck*);
 
 GwSpellcheck* gw_spellcheck_new (GtkEntry *entry)
 {
@@ -67,7 +74,10 @@ void gw_spellcheck_init (GwSpellcheck *spellcheck, GtkEntry *entry)
     spellcheck->sensitive = TRUE;
     spellcheck->running_check = FALSE;
     spellcheck->timeout = 0;
-    spellcheck->thread = NULL;
+    spellcheck->has_enchant = g_file_test (ENCHANT, G_FILE_TEST_IS_REGULAR);
+    spellcheck->enchant_in = NULL;
+    spellcheck->enchant_out = NULL;
+    spellcheck->pool = g_thread_pool_new (gw_spellcheck_check, spellcheck, 1, FALSE, NULL);
 
     gw_spellcheck_attach_signals (spellcheck);
 }
@@ -77,8 +87,15 @@ void gw_spellcheck_deinit (GwSpellcheck *spellcheck)
 {
     gw_spellcheck_remove_signals (spellcheck);
 
-    if (spellcheck->thread != NULL) g_thread_join (spellcheck->thread);
-    spellcheck->thread = NULL;
+    if (spellcheck->pool != NULL) g_thread_pool_free (spellcheck->pool, FALSE, TRUE);
+    spellcheck->pool = NULL;
+    gw_spellcheck_stop_enchant (spellcheck);
+
+    while (spellcheck->corrections != NULL)
+    {
+      g_free (spellcheck->corrections->data);
+      spellcheck->corrections = g_list_delete_link (spellcheck->corrections, spellcheck->corrections);
+    }
 
     g_free (spellcheck->query_text);
     g_mutex_free (spellcheck->mutex);
@@ -164,6 +181,309 @@ static void gw_spellcheck_remove_signals (GwSpellcheck *spellcheck)
     }
 }
 
+GwSpellcheckJob* gw_spellcheck_job_new (GwSpellcheck *spellcheck, const char *query, LwSpellIndex *spellindex, gchar **paths)
+{
+    GwSpellcheckJob *temp;
+
+    if ((temp = malloc(sizeof(GwSpellcheckJob))) != NULL)
+    {
+      temp->spellcheck = spellcheck;
+      temp->query = g_strdup (query);
+      temp->spellindex = spellindex;
+      temp->paths = paths;
+    }
+
+    return temp;
+}
+
+
+void gw_spellcheck_job_free (GwSpellcheckJob *job)
+{
+    g_free (job->query);
+    g_strfreev (job->paths);
+    free (job);
+}
+
+
+//!
+//! @brief Starts the enchant coprocess if it isn't running already
+//! @returns TRUE if it can be written to
+//!
+static gboolean gw_spellcheck_start_enchant (GwSpellcheck *spellcheck)
+{
+    //Declarations
+    char *argv[] = { ENCHANT, "-a", "-d", "en", NULL};
+    int stdin_stream;
+    int stdout_stream;
+
+    if (spellcheck->enchant_in != NULL) return TRUE;
+    if (spellcheck->has_enchant == FALSE) return FALSE;
+
+    if (!g_spawn_async_with_pipes (NULL, argv, NULL, 0, NULL, NULL, NULL, &stdin_stream, &stdout_stream, NULL, NULL))
+    {
+      //Don't try again on every check
+      spellcheck->has_enchant = FALSE;
+      return FALSE;
+    }
+
+    spellcheck->enchant_in = fdopen (stdin_stream, "w");
+    spellcheck->enchant_out = fdopen (stdout_stream, "r");
+
+    if (spellcheck->enchant_in == NULL || spellcheck->enchant_out == NULL)
+    {
+      if (spellcheck->enchant_in == NULL) close (stdin_stream);
+      if (spellcheck->enchant_out == NULL) close (stdout_stream);
+      gw_spellcheck_stop_enchant (spellcheck);
+      spellcheck->has_enchant = FALSE;
+      return FALSE;
+    }
+
+    return TRUE;
+}
+
+
+//!
+//! @brief Closes the pipes of the enchant coprocess, which makes it exit
+//!
+static void gw_spellcheck_stop_enchant (GwSpellcheck *spellcheck)
+{
+    if (spellcheck->enchant_in != NULL) fclose (spellcheck->enchant_in);
+    if (spellcheck->enchant_out != NULL) fclose (spellcheck->enchant_out);
+    spellcheck->enchant_in = NULL;
+    spellcheck->enchant_out = NULL;
+}
+
+
+//!
+//! @brief Sends a query to enchant and reads back its answer, which ends with
+//!        a blank line.  The query is sent after a space so a leading character
+//!        is never read as an ispell command.
+//! @returns The lines for the misspelled words as allocated strings
+//!
+static GList* gw_spellcheck_ask_enchant (GwSpellcheck *spellcheck, const char *query)
+{
+    //Declarations
+    char buffer[LW_IO_MAX_FGETS_LINE];
+    GList *replies;
+    gboolean finished;
+
+    //Initializations
+    replies = NULL;
+    finished = FALSE;
+
+    if (!gw_spellcheck_start_enchant (spellcheck)) return NULL;
+
+    if (fprintf (spellcheck->enchant_in, " %s\n", query) > 0 && fflush (spellcheck->enchant_in) == 0)
+    {
+      while (fgets (buffer, LW_IO_MAX_FGETS_LINE, spellcheck->enchant_out) != NULL)
+      {
+        if (buffer[0] == '\n') 
+        {
+          finished = TRUE;
+          break;
+        }
+        if (buffer[0] == '&' || buffer[0] == '#')
+          replies = g_list_prepend (replies, g_strdup (buffer));
+      }
+    }
+
+    //It will be restarted on the next check
+    if (!finished) gw_spellcheck_stop_enchant (spellcheck);
+
+    return g_list_reverse (replies);
+}
+
+
+//!
+//! @brief Finds the suggestions enchant gave for the word at an offset of the query
+//! @returns An allocated array of suggestions or NULL if enchant didn't mark the word
+//!
+static gchar** gw_spellcheck_get_enchant_suggestions (GList *replies, int offset)
+{
+    //Declarations
+    GList *iter;
+    gchar **split;
+    gchar **info;
+    gchar **suggestions;
+    int reply_offset;
+
+    //Initializations
+    suggestions = NULL;
+
+    //Replies look like "& word count offset: suggestion, suggestion" or "# word offset"
+    for (iter = replies; iter != NULL && suggestions == NULL; iter = iter->next)
+    {
+      split = g_strsplit (iter->data, ":", 2);
+      info = g_strsplit (split[0], " ", -1);
+
+      if (g_strv_length (info) > 3 && info[0][0] == '&')
+        reply_offset = (int) g_ascii_strtoull (info[3], NULL, 10) - 1;
+      else if (g_strv_length (info) > 2 && info[0][0] == '#')
+        reply_offset = (int) g_ascii_strtoull (info[2], NULL, 10) - 1;
+      else
+        reply_offset = -1;
+
+      if (reply_offset == offset)
+      {
+        if (split[1] != NULL)
+          suggestions = g_strsplit (split[1], ",", -1);
+        else
+          suggestions = g_new0 (gchar*, 1);
+      }
+
+      g_strfreev (split);
+      g_strfreev (info);
+    }
+
+    return suggestions;
+}
+
+
+//!
+//! @brief Makes the correction line for a word in the format of an enchant reply,
+//!        which is what the drawing and popup callbacks read.  Dictionary words
+//!        are suggested first so a replacement finds results.
+//! @returns An allocated correction or NULL if there is nothing to suggest
+//!
+static gchar* gw_spellcheck_make_correction (const char *word, int offset, GList *matches, gchar **suggestions)
+{
+    //Declarations
+    GString *text;
+    gchar *correction;
+    GList *iter;
+    gboolean duplicate;
+    int total;
+    int i;
+
+    //Initializations
+    text = g_string_new (NULL);
+    total = 0;
+
+    for (iter = matches; iter != NULL && total < GW_SPELLCHECK_MAX_SUGGESTIONS; iter = iter->next)
+    {
+      g_string_append_printf (text, "%s%s", (total > 0) ? ", " : "", (char*) iter->data);
+      total++;
+    }
+
+    for (i = 0; suggestions != NULL && suggestions[i] != NULL && total < GW_SPELLCHECK_MAX_SUGGESTIONS; i++)
+    {
+      g_strstrip (suggestions[i]);
+      if (suggestions[i][0] == '\0') continue;
+
+      duplicate = FALSE;
+      for (iter = matches; iter != NULL && !duplicate; iter = iter->next)
+        duplicate = (g_ascii_strcasecmp (iter->data, suggestions[i]) == 0);
+      if (duplicate) continue;
+
+      g_string_append_printf (text, "%s%s", (total > 0) ? ", " : "", suggestions[i]);
+      total++;
+    }
+
+    correction = (total > 0) ? g_strdup_printf ("& %s %d %d: %s\n", word, total, offset, text->str) : NULL;
+
+    //Cleanup
+    g_string_free (text, TRUE);
+
+    return correction;
+}
+
+
+//!
+//! @brief Checks a query on the spellcheck thread.  A word gets marked when
+//!        enchant says it is misspelled, or when there is no enchant, unless the
+//!        dictionaries use it.  The corrections replace the old ones in one go
+//!        if the query is still the one in the entry.
+//!
+static void gw_spellcheck_check (gpointer data, gpointer user_data)
+{
+    //Declarations
+    GwSpellcheckJob *job;
+    GwSpellcheck *spellcheck;
+    LwSpellIndex *spellindex;
+    GList *corrections;
+    GList *temp;
+    GList *replies;
+    GList *matches;
+    gchar **suggestions;
+    gchar *correction;
+    gchar *word;
+    const char *ptr;
+    const char *start;
+    gboolean has_enchant;
+    int offset;
+
+    //Initializations
+    job = data;
+    spellcheck = job->spellcheck;
+    spellindex = job->spellindex;
+    corrections = NULL;
+
+    if (job->paths != NULL) lw_spellindex_load (spellindex, job->paths, NULL);
+    replies = gw_spellcheck_ask_enchant (spellcheck, job->query);
+    has_enchant = (spellcheck->enchant_in != NULL);
+
+    for (ptr = job->query; *ptr != '\0';)
+    {
+      if (!g_ascii_isalpha (*ptr))
+      {
+        ptr++;
+        continue;
+      }
+
+      start = ptr;
+      while (g_ascii_isalpha (*ptr)) ptr++;
+      if (ptr - start < GW_SPELLCHECK_MIN_WORD_LENGTH) continue;
+
+      //Enchant counts characters, not bytes
+      word = g_strndup (start, ptr - start);
+      offset = g_utf8_pointer_to_offset (job->query, start);
+      suggestions = gw_spellcheck_get_enchant_suggestions (replies, offset);
+
+      if ((suggestions != NULL || !has_enchant) && !lw_spellindex_has_word (spellindex, word))
+      {
+        matches = lw_spellindex_lookup (spellindex, word, GW_SPELLCHECK_MAX_SUGGESTIONS);
+        correction = gw_spellcheck_make_correction (word, offset, matches, suggestions);
+        if (correction != NULL) corrections = g_list_prepend (corrections, correction);
+
+        while (matches != NULL)
+        {
+          g_free (matches->data);
+          matches = g_list_delete_link (matches, matches);
+        }
+      }
+
+      g_strfreev (suggestions);
+      g_free (word);
+    }
+
+    corrections = g_list_reverse (corrections);
+
+    g_mutex_lock (spellcheck->mutex);
+    if (spellcheck->query_text != NULL && strcmp (spellcheck->query_text, job->query) == 0)
+    {
+      //Swap so the old corrections are freed below
+      temp = spellcheck->corrections;
+      spellcheck->corrections = corrections;
+      corrections = temp;
+    }
+    spellcheck->running_check = FALSE;
+    g_mutex_unlock (spellcheck->mutex);
+
+    //Cleanup
+    while (corrections != NULL)
+    {
+      g_free (corrections->data);
+      corrections = g_list_delete_link (corrections, corrections);
+    }
+    while (replies != NULL)
+    {
+      g_free (replies->data);
+      replies = g_list_delete_link (replies, replies);
+    }
+    gw_spellcheck_job_free (job);
+}
+
+
 void gw_spellcheck_free_menuitem_data_cb (GtkWidget *widget, gpointer data)
 {
     //Declarations
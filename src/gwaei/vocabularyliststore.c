@@ -225,6 +225,7 @@ gw_vocabularyliststore_clean_files (GwVocabularyListStore *store)
     GDir *dir;
     gchar *uri;
     gchar *filename;
+    gchar *listname;
     const gchar *name;
 
     if ((uri = lw_util_build_filename (LW_PATH_VOCABULARY, NULL)) != NULL)
@@ -233,7 +234,9 @@ gw_vocabularyliststore_clean_files (GwVocabularyListStore *store)
       {
         while ((name = g_dir_read_name (dir)) != NULL)
         {
-          if (!gw_vocabularyliststore_list_exists (store, name))
+          //Journals are kept as long as their list is
+          listname = lw_vocabularylist_get_name_from_filename (name);
+          if (!gw_vocabularyliststore_list_exists (store, listname))
           {
             if ((filename = g_build_filename (uri, name, NULL)) != NULL)
             {
@@ -241,6 +244,7 @@ gw_vocabularyliststore_clean_files (GwVocabularyListStore *store)
               g_free (filename); filename = NULL;
             }
           }
+          g_free (listname); listname = NULL;
         }
         g_dir_close (dir); dir = NULL;
       }
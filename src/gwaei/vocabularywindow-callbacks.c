@@ -198,6 +198,217 @@ gw_vocabularywindow_remove_word_cb (GtkWidget *widget, gpointer data)
 }
 
 
+//!
+//! @brief A lookup of the words of the shown list running in its own thread
+//!
+struct _GwVocabularyWindowLookupJob {
+  GwVocabularyWindow *window;
+  GwVocabularyWordStoreLookup *lookup;
+  GtkWidget *dialog;              //!< NULL once the progress dialog was closed
+  GtkProgressBar *progressbar;
+  GMutex *mutex;
+  gdouble fraction;               //!< Guarded by the mutex
+  gboolean cancel;                //!< Guarded by the mutex
+  GError *error;
+  guint timeoutid;
+};
+typedef struct _GwVocabularyWindowLookupJob GwVocabularyWindowLookupJob;
+
+
+//!
+//! @brief A LwIoProgressCallback that notes the progress of the lookup thread for the dialog
+//!
+static int 
+_vocabularywindow_lookup_progress_cb (double fraction, gpointer data)
+{
+    //Declarations
+    GwVocabularyWindowLookupJob *job;
+    gboolean cancel;
+
+    //Initializations
+    job = data;
+
+    g_mutex_lock (job->mutex);
+    job->fraction = fraction;
+    cancel = job->cancel;
+    g_mutex_unlock (job->mutex);
+
+    return cancel;
+}
+
+
+//!
+//! @brief Shows the progress of the lookup thread in the progress dialog
+//!
+static gboolean 
+_vocabularywindow_lookup_update_ui_timeout (gpointer data)
+{
+    //Declarations
+    GwVocabularyWindowLookupJob *job;
+    gdouble fraction;
+
+    //Initializations
+    job = data;
+
+    g_mutex_lock (job->mutex);
+    fraction = job->fraction;
+    g_mutex_unlock (job->mutex);
+
+    if (job->progressbar != NULL) gtk_progress_bar_set_fraction (job->progressbar, fraction);
+
+    return TRUE;
+}
+
+
+//!
+//! @brief Cancels the lookup when the progress dialog is closed
+//!
+static void 
+_vocabularywindow_lookup_dialog_destroy_cb (GtkWidget *widget, gpointer data)
+{
+    //Declarations
+    GwVocabularyWindowLookupJob *job;
+
+    //Initializations
+    job = data;
+    job->dialog = NULL;
+    job->progressbar = NULL;
+
+    g_mutex_lock (job->mutex);
+    job->cancel = TRUE;
+    g_mutex_unlock (job->mutex);
+}
+
+
+//!
+//! @brief Applies the entries found by the lookup thread to the list from the main loop
+//!
+static gboolean 
+_vocabularywindow_lookup_done (gpointer data)
+{
+    //Declarations
+    GwVocabularyWindowLookupJob *job;
+    GwApplication *application;
+    GtkWidget *dialog;
+    gboolean cancelled;
+    gint found;
+
+    //Initializations
+    job = data;
+    application = gw_window_get_application (GW_WINDOW (job->window));
+    cancelled = (job->dialog == NULL);
+
+    g_source_remove (job->timeoutid);
+    if (job->dialog != NULL) gtk_widget_destroy (job->dialog);
+
+    //Nothing is shown once the dialog was closed or went with the window
+    if (!cancelled && job->error != NULL)
+    {
+      gw_application_handle_error (application, GTK_WINDOW (job->window), TRUE, &job->error);
+    }
+    else if (!cancelled)
+    {
+      found = gw_vocabularywordstore_lookup_apply (job->lookup);
+      dialog = gtk_message_dialog_new (GTK_WINDOW (job->window),
+                                       GTK_DIALOG_MODAL,
+                                       GTK_MESSAGE_INFO,
+                                       GTK_BUTTONS_CLOSE,
+                                       gettext("Found dictionary entries for %d of %d words."),
+                                       found, gw_vocabularywordstore_lookup_get_total_words (job->lookup)
+                                      );
+      gtk_dialog_run (GTK_DIALOG (dialog));
+      gtk_widget_destroy (dialog);
+    }
+
+    //Cleanup
+    if (job->error != NULL) g_error_free (job->error); job->error = NULL;
+    gw_vocabularywordstore_lookup_free (job->lookup);
+    g_mutex_free (job->mutex);
+    g_object_unref (job->window);
+    g_free (job);
+
+    return FALSE;
+}
+
+
+//!
+//! @brief Runs the lookup away from the main loop so the window stays responsive
+//!
+static gpointer 
+_vocabularywindow_lookup_thread (gpointer data)
+{
+    //Declarations
+    GwVocabularyWindowLookupJob *job;
+
+    //Initializations
+    job = data;
+
+    gw_vocabularywordstore_lookup_run (job->lookup, _vocabularywindow_lookup_progress_cb, job, &job->error);
+    g_idle_add (_vocabularywindow_lookup_done, job);
+
+    return NULL;
+}
+
+
+//!
+//! @brief Fills in the furigana and definitions of every word of the shown list
+//!        from the EDICT dictionaries in one pass over each dictionary.  The
+//!        dictionaries are read in a thread while a progress dialog is shown.
+//!
+G_MODULE_EXPORT void
+gw_vocabularywindow_lookup_all_cb (GtkWidget *widget, gpointer data)
+{
+    //Declarations
+    GwVocabularyWindow *window;
+    GwVocabularyWindowPrivate *priv;
+    GwApplication *application;
+    GwVocabularyWindowLookupJob *job;
+    LwDictInfoList *dictinfolist;
+    GtkTreeModel *model;
+    GtkWidget *content;
+    GError *error;
+
+    //Initializations
+    window = GW_VOCABULARYWINDOW (gtk_widget_get_ancestor (GTK_WIDGET (data), GW_TYPE_VOCABULARYWINDOW));
+    if (window == NULL) return;
+    priv = window->priv;
+    application = gw_window_get_application (GW_WINDOW (window));
+    model = gtk_tree_view_get_model (priv->word_treeview);
+    if (model == NULL) return;
+    dictinfolist = LW_DICTINFOLIST (gw_application_get_dictinfolist (application));
+    error = NULL;
+
+    job = g_new0 (GwVocabularyWindowLookupJob, 1);
+    job->window = GW_VOCABULARYWINDOW (g_object_ref (window));
+    job->lookup = gw_vocabularywordstore_lookup_new (GW_VOCABULARYWORDSTORE (model), dictinfolist);
+    job->mutex = g_mutex_new ();
+
+    //The dialog is modal so the list isn't edited while its words are looked up
+    job->dialog = gtk_dialog_new_with_buttons (gettext("Looking Up Words..."),
+                                               GTK_WINDOW (window),
+                                               GTK_DIALOG_MODAL | GTK_DIALOG_DESTROY_WITH_PARENT,
+                                               GTK_STOCK_CANCEL, GTK_RESPONSE_CANCEL,
+                                               NULL
+                                              );
+    job->progressbar = GTK_PROGRESS_BAR (gtk_progress_bar_new ());
+    content = gtk_dialog_get_content_area (GTK_DIALOG (job->dialog));
+    gtk_container_set_border_width (GTK_CONTAINER (job->dialog), 8);
+    gtk_box_pack_start (GTK_BOX (content), GTK_WIDGET (job->progressbar), TRUE, TRUE, 8);
+    gtk_window_set_default_size (GTK_WINDOW (job->dialog), 300, -1);
+    g_signal_connect (G_OBJECT (job->dialog), "response", G_CALLBACK (gtk_widget_destroy), NULL);
+    g_signal_connect (G_OBJECT (job->dialog), "destroy", G_CALLBACK (_vocabularywindow_lookup_dialog_destroy_cb), job);
+    gtk_widget_show_all (job->dialog);
+
+    job->timeoutid = g_timeout_add (100, _vocabularywindow_lookup_update_ui_timeout, job);
+
+    if (g_thread_create (_vocabularywindow_lookup_thread, job, FALSE, &error) == NULL)
+    {
+      job->error = error;
+      _vocabularywindow_lookup_done (job);
+    }
+}
+
+
 G_MODULE_EXPORT void
 gw_vocabularywindow_list_selection_changed_cb (GtkTreeView *view, gpointer data)
 {
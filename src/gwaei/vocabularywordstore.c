@@ -63,7 +63,7 @@ gw_vocabularywordstore_new (const gchar *NAME)
 static void 
 gw_vocabularywordstore_init (GwVocabularyWordStore *model)
 {
-    GType types[] = { G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_INT };
+    GType types[] = { G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_INT, G_TYPE_POINTER };
     gtk_list_store_set_column_types (GTK_LIST_STORE (model), TOTAL_GW_VOCABULARYWORDSTORE_COLUMNS, types);
 
     model->priv = GW_VOCABULARYWORDSTORE_GET_PRIVATE (model);
@@ -80,9 +80,12 @@ gw_vocabularywordstore_finalize (GObject *object)
     model = GW_VOCABULARYWORDSTORE (object);
     priv = model->priv;
 
+    if (priv->fillid != 0) g_source_remove (priv->fillid); priv->fillid = 0;
     if (priv->name != NULL) g_free (priv->name); 
     if (priv->filename != NULL) g_free (priv->filename);
     if (priv->vocabulary_list != NULL) lw_vocabularylist_free (priv->vocabulary_list); 
+    g_list_foreach (priv->changed_rows, (GFunc) gtk_tree_row_reference_free, NULL);
+    g_list_free (priv->changed_rows); priv->changed_rows = NULL;
 
     G_OBJECT_CLASS (gw_vocabularywordstore_parent_class)->finalize (object);
 }
@@ -172,68 +175,214 @@ gw_vocabularywordstore_class_init (GwVocabularyWordStoreClass *klass)
 }
 
 
-void
-gw_vocabularywordstore_save (GwVocabularyWordStore *store)
+//!
+//! @brief Remembers a row to show as changed until the next save
+//!
+static void
+gw_vocabularywordstore_mark_changed (GwVocabularyWordStore *store, GtkTreeIter *iter)
 {
+    //Declarations
     GwVocabularyWordStorePrivate *priv;
-    LwVocabularyItem *item;
     GtkTreeModel *model;
-    GtkTreeIter iter;
-    PangoWeight weight;
-    gchar *text;
-    gboolean valid;
+    GtkTreePath *path;
 
+    //Initializations
     priv = store->priv;
     model = GTK_TREE_MODEL (store);
-    weight = PANGO_WEIGHT_NORMAL;
 
-    if (!gw_vocabularywordstore_has_changes (store)) return;
+    gtk_list_store_set (GTK_LIST_STORE (store), iter, GW_VOCABULARYWORDSTORE_COLUMN_CHANGED, PANGO_WEIGHT_SEMIBOLD, -1);
 
-    gw_vocabularywordstore_load (store);
+    if ((path = gtk_tree_model_get_path (model, iter)) != NULL)
+    {
+      priv->changed_rows = g_list_prepend (priv->changed_rows, gtk_tree_row_reference_new (model, path));
+      gtk_tree_path_free (path); path = NULL;
+    }
+}
 
-    if (priv->vocabulary_list != NULL) lw_vocabularylist_free (priv->vocabulary_list);
 
-    if ((priv->vocabulary_list = lw_vocabularylist_new (priv->name)) != NULL)
+//!
+//! @brief Forgets the rows shown as changed, only visiting those rows instead of the whole store
+//! @param store The GwVocabularyWordStore
+//! @param reset_weight Set the rows that still exist back to the normal weight
+//!
+static void
+gw_vocabularywordstore_clear_changed_rows (GwVocabularyWordStore *store, gboolean reset_weight)
+{
+    //Declarations
+    GwVocabularyWordStorePrivate *priv;
+    GtkTreeModel *model;
+    GtkTreeRowReference *reference;
+    GtkTreePath *path;
+    GtkTreeIter iter;
+    GList *link;
+
+    //Initializations
+    priv = store->priv;
+    model = GTK_TREE_MODEL (store);
+
+    for (link = priv->changed_rows; link != NULL; link = link->next)
     {
-      valid = gtk_tree_model_get_iter_first (model, &iter);
-      while (valid)
+      reference = (GtkTreeRowReference*) link->data;
+      if (reset_weight && (path = gtk_tree_row_reference_get_path (reference)) != NULL)
       {
-        if ((item = lw_vocabularyitem_new ()) != NULL)
-        {
-          gtk_tree_model_get (model, &iter,  GW_VOCABULARYWORDSTORE_COLUMN_KANJI, &text, -1);
-          if (text != NULL)
-          {
-            lw_vocabularyitem_set_kanji (item, text);
-            g_free (text);
-          }
-
-          gtk_tree_model_get (model, &iter,  GW_VOCABULARYWORDSTORE_COLUMN_FURIGANA, &text, -1);
-          if (text != NULL)
-          {
-            lw_vocabularyitem_set_furigana (item, text);
-            g_free (text);
-          }
-
-          gtk_tree_model_get (model, &iter,  GW_VOCABULARYWORDSTORE_COLUMN_DEFINITIONS, &text, -1);
-          if (text != NULL)
-          {
-            lw_vocabularyitem_set_definitions (item, text);
-            g_free (text);
-          }
-
-          priv->vocabulary_list->items = g_list_append (priv->vocabulary_list->items, item);
-          gtk_list_store_set (GTK_LIST_STORE (model), &iter, GW_VOCABULARYWORDSTORE_COLUMN_CHANGED, weight, -1);
-        }
-        valid = gtk_tree_model_iter_next (model, &iter);
+        if (gtk_tree_model_get_iter (model, &iter, path))
+          gtk_list_store_set (GTK_LIST_STORE (store), &iter, GW_VOCABULARYWORDSTORE_COLUMN_CHANGED, PANGO_WEIGHT_NORMAL, -1);
+        gtk_tree_path_free (path); path = NULL;
       }
+      gtk_tree_row_reference_free (reference);
+    }
+
+    g_list_free (priv->changed_rows); priv->changed_rows = NULL;
+}
+
+
+//!
+//! @brief Gets the LwVocabularyItem of the row before a row
+//! @returns The item or NULL if the row is the first one
+//!
+static LwVocabularyItem*
+gw_vocabularywordstore_get_previous_item (GwVocabularyWordStore *store, GtkTreeIter *iter)
+{
+    //Declarations
+    GtkTreeModel *model;
+    GtkTreePath *path;
+    GtkTreeIter previous;
+    LwVocabularyItem *item;
+
+    //Initializations
+    model = GTK_TREE_MODEL (store);
+    item = NULL;
+
+    if ((path = gtk_tree_model_get_path (model, iter)) != NULL)
+    {
+      if (gtk_tree_path_prev (path) && gtk_tree_model_get_iter (model, &previous, path))
+        gtk_tree_model_get (model, &previous, GW_VOCABULARYWORDSTORE_COLUMN_ITEM, &item, -1);
+      gtk_tree_path_free (path); path = NULL;
+    }
 
+    return item;
+}
+
+
+//!
+//! @brief Adds the word of a newly inserted row to the LwVocabularyList behind the store
+//!
+static void
+gw_vocabularywordstore_insert_item (GwVocabularyWordStore *store, GtkTreeIter *iter, gchar **fields)
+{
+    //Declarations
+    GwVocabularyWordStorePrivate *priv;
+    LwVocabularyItem *item;
+    gint i;
+
+    //Initializations
+    priv = store->priv;
+
+    if ((item = lw_vocabularyitem_new ()) != NULL)
+    {
+      for (i = 0; fields[i] != NULL && i < TOTAL_LW_VOCABULARYITEM_FIELDS; i++)
+        lw_vocabularyitem_set_field (item, i, fields[i]);
+      lw_vocabularylist_insert_after (priv->vocabulary_list, gw_vocabularywordstore_get_previous_item (store, iter), item);
+      gtk_list_store_set (GTK_LIST_STORE (store), iter, GW_VOCABULARYWORDSTORE_COLUMN_ITEM, item, -1);
+    }
+
+    gw_vocabularywordstore_mark_changed (store, iter);
+}
+
+
+//!
+//! @brief Saves the edits made to the store.  The edits were recorded in the
+//!        LwVocabularyList as they were made, so only they are written instead
+//!        of the whole list.
+//!
+void
+gw_vocabularywordstore_save (GwVocabularyWordStore *store)
+{
+    GwVocabularyWordStorePrivate *priv;
+
+    priv = store->priv;
+
+    if (!gw_vocabularywordstore_has_changes (store)) return;
+
+    gw_vocabularywordstore_load (store);
+
+    if (priv->vocabulary_list != NULL)
+    {
       lw_vocabularylist_save (priv->vocabulary_list, NULL);
-      lw_vocabularylist_free (priv->vocabulary_list); priv->vocabulary_list = NULL;
+      gw_vocabularywordstore_clear_changed_rows (store, TRUE);
       gw_vocabularywordstore_set_has_changes (store, FALSE);
     }
 }
 
 
+//!
+//! @brief Adds the rows for the items of the list that don't have one yet
+//! @param store The GwVocabularyWordStore being loaded
+//! @param deadline The g_get_monotonic_time value to stop at or 0 to add rows until count is reached
+//! @param count The most rows to add or -1 for all of them
+//! @returns TRUE if there are items left without a row
+//!
+static gboolean
+gw_vocabularywordstore_fill (GwVocabularyWordStore *store, gint64 deadline, gint count)
+{
+    //Declarations
+    GwVocabularyWordStorePrivate *priv;
+    GtkTreeIter treeiter;
+    LwVocabularyItem *item;
+    gint i;
+
+    //Initializations
+    priv = store->priv;
+
+    for (i = 0; priv->fill_link != NULL && i != count; i++)
+    {
+      if (deadline > 0 && i % 32 == 0 && g_get_monotonic_time () >= deadline) break;
+
+      item = LW_VOCABULARYITEM (priv->fill_link->data);
+      gtk_list_store_insert_with_values (GTK_LIST_STORE (store), &treeiter, -1,
+          GW_VOCABULARYWORDSTORE_COLUMN_KANJI, lw_vocabularyitem_get_kanji (item), 
+          GW_VOCABULARYWORDSTORE_COLUMN_FURIGANA, lw_vocabularyitem_get_furigana (item), 
+          GW_VOCABULARYWORDSTORE_COLUMN_DEFINITIONS, lw_vocabularyitem_get_definitions (item), 
+          GW_VOCABULARYWORDSTORE_COLUMN_CHANGED, PANGO_WEIGHT_NORMAL,
+          GW_VOCABULARYWORDSTORE_COLUMN_ITEM, item,
+      -1);
+      priv->fill_link = priv->fill_link->next;
+    }
+
+    return (priv->fill_link != NULL);
+}
+
+
+static gboolean
+gw_vocabularywordstore_fill_cb (gpointer data)
+{
+    //Declarations
+    GwVocabularyWordStore *store;
+    GwVocabularyWordStorePrivate *priv;
+    gint64 deadline;
+
+    //Initializations
+    store = GW_VOCABULARYWORDSTORE (data);
+    priv = store->priv;
+    deadline = g_get_monotonic_time () + GW_VOCABULARYWORDSTORE_FILL_BUDGET * 1000;
+
+    if (gw_vocabularywordstore_fill (store, deadline, -1)) return TRUE;
+
+    priv->fillid = 0;
+
+    return FALSE;
+}
+
+
+//!
+//! @brief Loads the list of the store.  The list file is read right away but only
+//!        the first page of rows is added before returning.  The rest are added
+//!        from the main loop a few milliseconds at a time so that lists of tens
+//!        of thousands of words don't freeze the window.  Words inserted while
+//!        the rows are being added keep their place in the list because the
+//!        rows still to come all go after the ones already shown.
+//! @see gw_vocabularywordstore_finish_loading ()
+//!
 void 
 gw_vocabularywordstore_load (GwVocabularyWordStore *store)
 {
@@ -244,32 +393,38 @@ gw_vocabularywordstore_load (GwVocabularyWordStore *store)
 
     //Declarations
     GwVocabularyWordStorePrivate *priv;
-    GtkTreeModel *model;
-    GtkTreeIter treeiter;
-    GList *listiter;
-    LwVocabularyItem *item;
 
     //Initializations
     priv = store->priv;
-    model = GTK_TREE_MODEL (store);
 
     if (priv->vocabulary_list != NULL) lw_vocabularylist_free (priv->vocabulary_list);
     priv->vocabulary_list = lw_vocabularylist_new (priv->name);
     lw_vocabularylist_load (priv->vocabulary_list, NULL);
+    priv->fill_link = lw_vocabularylist_get_items (priv->vocabulary_list);
+    priv->loaded = TRUE;
 
-    for (listiter = priv->vocabulary_list->items; listiter != NULL; listiter = listiter->next)
-    {
-      item = LW_VOCABULARYITEM (listiter->data);
-      gtk_list_store_append (GTK_LIST_STORE (model), &treeiter);
-      gtk_list_store_set (GTK_LIST_STORE (model), &treeiter, 
-          GW_VOCABULARYWORDSTORE_COLUMN_KANJI, lw_vocabularyitem_get_kanji (item), 
-          GW_VOCABULARYWORDSTORE_COLUMN_FURIGANA, lw_vocabularyitem_get_furigana (item), 
-          GW_VOCABULARYWORDSTORE_COLUMN_DEFINITIONS, lw_vocabularyitem_get_definitions (item), 
-          GW_VOCABULARYWORDSTORE_COLUMN_CHANGED, PANGO_WEIGHT_NORMAL,
-      -1);
-    }
+    if (gw_vocabularywordstore_fill (store, 0, GW_VOCABULARYWORDSTORE_FIRST_PAGE) && priv->fillid == 0)
+      priv->fillid = g_idle_add (gw_vocabularywordstore_fill_cb, store);
+}
 
-    priv->loaded = TRUE;
+
+//!
+//! @brief Adds the rows that gw_vocabularywordstore_load left for the main loop
+//!        right away.  Things that walk every row of the store call this first.
+//!
+void
+gw_vocabularywordstore_finish_loading (GwVocabularyWordStore *store)
+{
+    //Declarations
+    GwVocabularyWordStorePrivate *priv;
+
+    //Initializations
+    priv = store->priv;
+
+    gw_vocabularywordstore_load (store);
+    gw_vocabularywordstore_fill (store, 0, -1);
+
+    if (priv->fillid != 0) g_source_remove (priv->fillid); priv->fillid = 0;
 }
 
 
@@ -281,12 +436,15 @@ gw_vocabularywordstore_reset (GwVocabularyWordStore *store)
     priv = store->priv;
     priv->loaded = FALSE;
 
+    if (priv->fillid != 0) g_source_remove (priv->fillid); priv->fillid = 0;
+    priv->fill_link = NULL;
+    gw_vocabularywordstore_clear_changed_rows (store, FALSE);
+    gtk_list_store_clear (GTK_LIST_STORE (store));
     if (priv->vocabulary_list != NULL) 
     {
       lw_vocabularylist_free (priv->vocabulary_list);
       priv->vocabulary_list = NULL;
     }
-    gtk_list_store_clear (GTK_LIST_STORE (store));
     priv->loaded = FALSE;
     gw_vocabularywordstore_set_has_changes (store, FALSE);
 }
@@ -316,6 +474,13 @@ gw_vocabularywordstore_set_name (GwVocabularyWordStore *store, const gchar *NAME
       g_free (priv->filename);
       priv->filename = NULL;
     }
+
+    //The list is written under its new name on the next save
+    if (priv->vocabulary_list != NULL)
+    {
+      lw_vocabularylist_set_name (priv->vocabulary_list, NAME);
+      gw_vocabularywordstore_set_has_changes (store, TRUE);
+    }
 }
 
 
@@ -455,14 +620,19 @@ gw_vocabularywordstore_remove_path_list (GwVocabularyWordStore *store, GList *li
     GtkTreePath *path;
     GtkTreeIter iter;
     GList *link;
+    LwVocabularyItem *item;
 
     //Initializations
     model = GTK_TREE_MODEL (store);
 
+    gw_vocabularywordstore_load (store);
+
     for (link = g_list_last (list); link != NULL; link = link->prev)
     {
       path = (GtkTreePath*) link->data;
       gtk_tree_model_get_iter (model, &iter, path);
+      gtk_tree_model_get (model, &iter, GW_VOCABULARYWORDSTORE_COLUMN_ITEM, &item, -1);
+      if (item != NULL) lw_vocabularylist_remove (store->priv->vocabulary_list, item);
       gtk_list_store_remove (GTK_LIST_STORE (model), &iter);
     }
 
@@ -483,6 +653,11 @@ gw_vocabularywordstore_append_text (GwVocabularyWordStore *store, GtkTreeIter *i
     GtkTreeIter new_iter;
     gboolean modified;
 
+    //Initializations
+    modified = FALSE;
+
+    gw_vocabularywordstore_load (store);
+
     rows = g_strsplit (text, "\n", -1);
     if (rows != NULL)
     {
@@ -497,7 +672,7 @@ gw_vocabularywordstore_append_text (GwVocabularyWordStore *store, GtkTreeIter *i
             gtk_list_store_insert_after (GTK_LIST_STORE (store), &new_iter, iter);
           for (j = 0; atoms[j] != NULL; j++)
             gtk_list_store_set (GTK_LIST_STORE (store), &new_iter, j, atoms[j], -1);
-          gtk_list_store_set (GTK_LIST_STORE (store), &new_iter, GW_VOCABULARYWORDSTORE_COLUMN_CHANGED, PANGO_WEIGHT_SEMIBOLD, -1);
+          gw_vocabularywordstore_insert_item (store, &new_iter, atoms);
           g_strfreev (atoms); atoms = NULL;
           modified = TRUE;
         }
@@ -512,6 +687,36 @@ gw_vocabularywordstore_append_text (GwVocabularyWordStore *store, GtkTreeIter *i
 }
 
 
+//!
+//! @brief Gets the text a new word shows in a field until it is set
+//!
+static const gchar*
+gw_vocabularywordstore_get_placeholder (gint column)
+{
+    switch (column)
+    {
+      case GW_VOCABULARYWORDSTORE_COLUMN_KANJI:
+        return gettext("(Click to set Kanji)");
+      case GW_VOCABULARYWORDSTORE_COLUMN_FURIGANA:
+        return gettext("(Click to set Furigana)");
+      case GW_VOCABULARYWORDSTORE_COLUMN_DEFINITIONS:
+        return gettext("(Click to set Definitions)");
+      default:
+        return NULL;
+    }
+}
+
+
+//!
+//! @brief Tells if a field of a word is empty or still shows its placeholder
+//!
+static gboolean
+gw_vocabularywordstore_is_unset (const gchar *TEXT, gint column)
+{
+    return (TEXT == NULL || *TEXT == '\0' || strcmp (TEXT, gw_vocabularywordstore_get_placeholder (column)) == 0);
+}
+
+
 void
 gw_vocabularywordstore_new_word (GwVocabularyWordStore *store, 
                                  GtkTreeIter           *iter,
@@ -523,22 +728,27 @@ gw_vocabularywordstore_new_word (GwVocabularyWordStore *store,
     //Declarations
     GtkListStore *wordstore;
     const gchar *kanji, *furigana, *definitions;
-    PangoWeight weight;
+    gchar *fields[TOTAL_LW_VOCABULARYITEM_FIELDS + 1];
 
     //Initializations
     wordstore = GTK_LIST_STORE (store);
-    if ((kanji = KANJI) == NULL)             kanji = gettext("(Click to set Kanji)");
-    if ((furigana = FURIGANA) == NULL)       furigana = gettext("(Click to set Furigana)");
-    if ((definitions = DEFINITIONS) == NULL) definitions = gettext("(Click to set Definitions)");
-    weight = PANGO_WEIGHT_SEMIBOLD;
+    if ((kanji = KANJI) == NULL)             kanji = gw_vocabularywordstore_get_placeholder (GW_VOCABULARYWORDSTORE_COLUMN_KANJI);
+    if ((furigana = FURIGANA) == NULL)       furigana = gw_vocabularywordstore_get_placeholder (GW_VOCABULARYWORDSTORE_COLUMN_FURIGANA);
+    if ((definitions = DEFINITIONS) == NULL) definitions = gw_vocabularywordstore_get_placeholder (GW_VOCABULARYWORDSTORE_COLUMN_DEFINITIONS);
+    fields[LW_VOCABULARYITEM_FIELD_KANJI] = (gchar*) kanji;
+    fields[LW_VOCABULARYITEM_FIELD_FURIGANA] = (gchar*) furigana;
+    fields[LW_VOCABULARYITEM_FIELD_DEFINITIONS] = (gchar*) definitions;
+    fields[TOTAL_LW_VOCABULARYITEM_FIELDS] = NULL;
+
+    gw_vocabularywordstore_load (store);
 
     gtk_list_store_insert_before (wordstore, iter, sibling);
     gtk_list_store_set (wordstore, iter, 
         GW_VOCABULARYWORDSTORE_COLUMN_KANJI,       kanji, 
         GW_VOCABULARYWORDSTORE_COLUMN_FURIGANA,    furigana,
         GW_VOCABULARYWORDSTORE_COLUMN_DEFINITIONS, definitions,
-        GW_VOCABULARYWORDSTORE_COLUMN_CHANGED,     weight,
     -1);
+    gw_vocabularywordstore_insert_item (store, iter, fields);
     gw_vocabularywordstore_set_has_changes (store, TRUE);
 }
 
@@ -557,24 +767,225 @@ gw_vocabularywordstore_set_string (GwVocabularyWordStore *store,
     //Declarations
     GtkTreeModel *wordmodel;
     GtkListStore *wordstore;
+    LwVocabularyItem *item;
     gchar *text;
 
     //Initializations
     wordmodel = GTK_TREE_MODEL (store);
     wordstore = GTK_LIST_STORE (store);
 
-    gtk_tree_model_get (wordmodel, iter, column, &text, -1);
+    gtk_tree_model_get (wordmodel, iter, column, &text, GW_VOCABULARYWORDSTORE_COLUMN_ITEM, &item, -1);
     if (text != NULL)
     {
       if (strcmp(text, NEW_TEXT) != 0)
       {
-        gtk_list_store_set (wordstore, iter, 
-          column, NEW_TEXT,
-          GW_VOCABULARYWORDSTORE_COLUMN_CHANGED, PANGO_WEIGHT_SEMIBOLD,
-          -1);
+        gtk_list_store_set (wordstore, iter, column, NEW_TEXT, -1);
+        if (item != NULL) lw_vocabularylist_set_field (store->priv->vocabulary_list, item, column, NEW_TEXT);
+        gw_vocabularywordstore_mark_changed (store, iter);
         gw_vocabularywordstore_set_has_changes (store, TRUE);
       }
       g_free (text); text = NULL;
     }
 }
 
+
+
+//!
+//! @brief Sets a field of a word to the text of a dictionary entry if the field isn't set yet
+//! @returns TRUE if the field was filled in
+//!
+static gboolean
+gw_vocabularywordstore_fill_in (GwVocabularyWordStore *store, GtkTreeIter *iter, gint column, const gchar *TEXT)
+{
+    //Declarations
+    gchar *text;
+    gboolean fill;
+
+    if (TEXT == NULL || *TEXT == '\0') return FALSE;
+
+    gtk_tree_model_get (GTK_TREE_MODEL (store), iter, column, &text, -1);
+    fill = gw_vocabularywordstore_is_unset (text, column);
+    if (text != NULL) g_free (text); text = NULL;
+
+    if (fill) gw_vocabularywordstore_set_string (store, iter, column, TEXT);
+
+    return fill;
+}
+
+
+//!
+//! @brief Gets the words of the store ready to be looked up in the EDICT
+//!        dictionaries with one pass over each dictionary.  This has to be
+//!        called from the main thread, but the lookup can then be run from any.
+//! @param store The GwVocabularyWordStore to look up
+//! @param dictinfolist The LwDictInfoList with the dictionaries to look in
+//! @returns An allocated GwVocabularyWordStoreLookup to be freed with gw_vocabularywordstore_lookup_free
+//!
+GwVocabularyWordStoreLookup*
+gw_vocabularywordstore_lookup_new (GwVocabularyWordStore *store, LwDictInfoList *dictinfolist)
+{
+    //Declarations
+    GwVocabularyWordStoreLookup *lookup;
+    GtkTreeModel *model;
+    GtkTreeIter iter;
+    GtkTreePath *path;
+    LwDictInfo *di;
+    GList *link;
+    gchar *kanji, *furigana;
+    gboolean valid;
+
+    //Initializations
+    lookup = g_new0 (GwVocabularyWordStoreLookup, 1);
+    lookup->store = GW_VOCABULARYWORDSTORE (g_object_ref (store));
+    lookup->batchlookup = lw_batchlookup_new ();
+    lookup->rows = g_ptr_array_new_with_free_func ((GDestroyNotify) gtk_tree_row_reference_free);
+    model = GTK_TREE_MODEL (store);
+
+    gw_vocabularywordstore_finish_loading (store);
+
+    //Row references follow the rows if the list is changed while the lookup runs
+    valid = gtk_tree_model_get_iter_first (model, &iter);
+    while (valid)
+    {
+      gtk_tree_model_get (model, &iter, 
+          GW_VOCABULARYWORDSTORE_COLUMN_KANJI,    &kanji, 
+          GW_VOCABULARYWORDSTORE_COLUMN_FURIGANA, &furigana, 
+      -1);
+      lw_batchlookup_add (lookup->batchlookup, 
+          gw_vocabularywordstore_is_unset (kanji, GW_VOCABULARYWORDSTORE_COLUMN_KANJI) ? NULL : kanji,
+          gw_vocabularywordstore_is_unset (furigana, GW_VOCABULARYWORDSTORE_COLUMN_FURIGANA) ? NULL : furigana);
+      path = gtk_tree_model_get_path (model, &iter);
+      g_ptr_array_add (lookup->rows, gtk_tree_row_reference_new (model, path));
+      gtk_tree_path_free (path); path = NULL;
+      if (kanji != NULL) g_free (kanji); kanji = NULL;
+      if (furigana != NULL) g_free (furigana); furigana = NULL;
+      valid = gtk_tree_model_iter_next (model, &iter);
+    }
+
+    for (link = dictinfolist->list; link != NULL; link = link->next)
+    {
+      di = LW_DICTINFO (link->data);
+      if (di->type == LW_DICTTYPE_EDICT) lookup->dictionaries = g_list_append (lookup->dictionaries, di);
+    }
+
+    return lookup;
+}
+
+
+//!
+//! @brief Frees a GwVocabularyWordStoreLookup.  This has to be called from the main thread.
+//! @param lookup The GwVocabularyWordStoreLookup to free
+//!
+void
+gw_vocabularywordstore_lookup_free (GwVocabularyWordStoreLookup *lookup)
+{
+    g_list_free (lookup->dictionaries); lookup->dictionaries = NULL;
+    g_ptr_array_free (lookup->rows, TRUE); lookup->rows = NULL;
+    lw_batchlookup_free (lookup->batchlookup); lookup->batchlookup = NULL;
+    g_object_unref (lookup->store); lookup->store = NULL;
+    g_free (lookup);
+}
+
+
+//!
+//! @brief Gives the progress of a dictionary as the progress of the whole lookup
+//!
+static int
+_vocabularywordstore_lookup_progress_cb (double fraction, gpointer data)
+{
+    //Declarations
+    GwVocabularyWordStoreLookup *lookup;
+
+    //Initializations
+    lookup = data;
+
+    return lookup->cb ((lookup->current + fraction) / lookup->total, lookup->data);
+}
+
+
+//!
+//! @brief Reads each EDICT dictionary once to find the entries of the words.
+//!        This doesn't touch the store, so it can be run from another thread.
+//! @param lookup A GwVocabularyWordStoreLookup made by gw_vocabularywordstore_lookup_new
+//! @param cb A LwIoProgressCallback to use to give progress feedback or NULL
+//! @param data A gpointer to data to pass to the LwIoProgressCallback
+//! @param error A pointer to a GError to write errors to or NULL
+//! @returns FALSE if a dictionary couldn't be read or the progress callback cancelled the lookup
+//!
+gboolean
+gw_vocabularywordstore_lookup_run (GwVocabularyWordStoreLookup *lookup, LwIoProgressCallback cb, gpointer data, GError **error)
+{
+    //Sanity check
+    if (error != NULL && *error != NULL) return FALSE;
+
+    //Declarations
+    GList *link;
+    gboolean ok;
+
+    //Initializations
+    lookup->cb = cb;
+    lookup->data = data;
+    lookup->current = 0;
+    lookup->total = g_list_length (lookup->dictionaries);
+    ok = TRUE;
+
+    for (link = lookup->dictionaries; link != NULL && ok; link = link->next)
+    {
+      ok = lw_batchlookup_run (lookup->batchlookup, 
+                               LW_DICTINFO (link->data), 
+                               (cb != NULL) ? _vocabularywordstore_lookup_progress_cb : NULL, 
+                               lookup, 
+                               error);
+      lookup->current++;
+    }
+
+    return ok;
+}
+
+
+//!
+//! @brief Fills in the furigana and definitions that aren't set yet of the words
+//!        an entry was found for.  This has to be called from the main thread.
+//! @param lookup A GwVocabularyWordStoreLookup that was run
+//! @returns The number of words an entry was found for
+//!
+gint
+gw_vocabularywordstore_lookup_apply (GwVocabularyWordStoreLookup *lookup)
+{
+    //Declarations
+    GwVocabularyWordStore *store;
+    LwVocabularyItem *result;
+    GtkTreePath *path;
+    GtkTreeIter iter;
+    gint found;
+    guint i;
+
+    //Initializations
+    store = lookup->store;
+    found = 0;
+
+    for (i = 0; i < lookup->rows->len; i++)
+    {
+      if ((result = lw_batchlookup_get_result (lookup->batchlookup, i)) == NULL) continue;
+      if ((path = gtk_tree_row_reference_get_path (g_ptr_array_index (lookup->rows, i))) == NULL) continue;
+      if (gtk_tree_model_get_iter (GTK_TREE_MODEL (store), &iter, path))
+      {
+        gw_vocabularywordstore_fill_in (store, &iter, GW_VOCABULARYWORDSTORE_COLUMN_FURIGANA, lw_vocabularyitem_get_furigana (result));
+        gw_vocabularywordstore_fill_in (store, &iter, GW_VOCABULARYWORDSTORE_COLUMN_DEFINITIONS, lw_vocabularyitem_get_definitions (result));
+        found++;
+      }
+      gtk_tree_path_free (path); path = NULL;
+    }
+
+    return found;
+}
+
+
+//!
+//! @brief Gets the number of words being looked up
+//!
+gint
+gw_vocabularywordstore_lookup_get_total_words (GwVocabularyWordStoreLookup *lookup)
+{
+    return lookup->rows->len;
+}
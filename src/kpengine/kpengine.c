@@ -20,109 +20,140 @@
 #include <unistd.h>
 #include <string.h>
 #include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <glib.h>
-#include "jstroke/jstroke.h"
+#include <libwaei/libwaei.h>
+
+/* The recognizer lives in libwaei now (see strokedb.c).  This program only
+ * speaks the old line protocol for front ends that still use a subprocess.
+ */
 
-#define MAX_STROKES 32
 #define BUFLEN 1024
 
-static char *stroke_dicts[MAX_STROKES];
+static LwStrokeDB *stroke_db;
 static char *progname;
 static char *data_file;
+static int max_candidates = LW_STROKEDB_DEFAULT_CANDIDATES;
+static int incremental;
 
 void
 load_database()
 {
-  FILE *file;
-  int i;
+  GError *error = NULL;
 
-  if (data_file)
+  stroke_db = lw_strokedb_new (data_file, &error);
+
+  if (stroke_db == NULL)
     {
-      file = fopen (data_file, "rb");
+      fprintf(stderr,"%s: %s\n", progname,
+	      (error != NULL) ? error->message : "Can't open jdata.dat");
+      exit(1);
     }
-  else
-    {
-#ifdef G_OS_WIN32
-      //char *dir = g_win32_get_package_installation_directory (NULL, NULL);
-      char *dir = g_build_filename ("..", "share", "gwaei", NULL);
-#else
-      char *dir = g_strdup (KP_LIBDIR);
-#endif      
-      char *fname = g_build_filename (dir, "jdata.dat", NULL);
-      file = fopen (fname, "rb");
-      
-      if (!file)
-	      file = fopen ("jdata.dat", "rb");
+}
 
-      g_free (fname);
-      g_free (dir);
-    }
+/* Reads one stroke, all of its points on one line.  Returns the number of
+ * points, 0 for a blank line, or -1 at the end of the file.
+ */
+int
+read_stroke (FILE *file, char **buffer, int *buflen, LwStroke *stroke)
+{
+  char *p,*q;
+  int len;
 
-  if (!file)
+  if (!fgets(*buffer, *buflen, file))
+    return -1;
+
+  while ((strlen(*buffer) == *buflen - 1) && ((*buffer)[*buflen-2] != '\n'))
     {
-      fprintf(stderr,"%s: Can't open %s\n", progname,
-	      data_file ? data_file : "jdata.dat");
-      exit(1);
+      *buflen += BUFLEN;
+      *buffer = realloc(*buffer, *buflen);
+      if (!fgets(*buffer+*buflen-BUFLEN-1, BUFLEN+1, file))
+	return -1;
     }
 
+  len = 0;
+  p = *buffer;
 
-  for (i=0;i<MAX_STROKES;i++)
-    stroke_dicts[i] = NULL;
+  while (len < LW_STROKEDB_MAX_POINTS) {
+    while (isspace (*p)) p++;
+    if (*p == 0)
+      break;
+    stroke->x[len] = strtol (p, &q, 0);
+    if (p == q)
+      break;
+    p = q;
 
-  while (1)
-    {
-      int n_read;
-      unsigned int nstrokes;
-      unsigned int len;
-      int buf[2];
+    while (isspace (*p)) p++;
+    if (*p == 0)
+      break;
+    stroke->y[len] = strtol (p, &q, 0);
+    if (p == q)
+      break;
+    p = q;
 
-      n_read = fread (buf, sizeof(int), 2, file);
-      
-      nstrokes = GUINT32_FROM_BE(buf[0]);
-      len = GUINT32_FROM_BE(buf[1]);
+    len++;
+  }
 
-      if ((n_read != 2) || (nstrokes > MAX_STROKES))
-	{
-	  fprintf(stderr, "%s: Corrupt stroke database\n", progname);
-	  exit(1);
-	}
+  stroke->length = len;
+  return len;
+}
 
-      if (nstrokes == 0)
-	break;
+void
+print_candidates (LwStrokeDBCandidate *candidates, int total)
+{
+  int i;
+
+  printf("K");
+  for (i=0;i<total;i++)
+    {
+      if (i)
+	printf(" ");
+      printf("%2x%2x",candidates[i].jis[0],candidates[i].jis[1]);
+    }
+  printf("\n");
 
-      stroke_dicts[nstrokes] = malloc(len);
-      n_read = fread(stroke_dicts[nstrokes], 1, len, file);
+  fflush(stdout);
+}
 
-      if (n_read != len)
+/* In incremental mode every stroke is answered as soon as it is read, with
+ * characters that have more strokes ranked on the strokes so far.  A blank
+ * line starts a new character.
+ */
+int
+process_incremental (FILE *file)
+{
+  LwStrokeDBSession *session = lw_strokedb_session_new (stroke_db);
+  LwStrokeDBCandidate *candidates = g_new (LwStrokeDBCandidate, max_candidates);
+  LwStroke stroke;
+  char *buffer = malloc(BUFLEN);
+  int buflen = BUFLEN;
+  int len;
+
+  while ((len = read_stroke (file, &buffer, &buflen, &stroke)) >= 0)
+    {
+      if (len == 0)
 	{
-	  fprintf(stderr, "%s: Corrupt stroke database", progname);
-	  exit(1);
+	  lw_strokedb_session_clear (session);
+	  continue;
 	}
+
+      if (lw_strokedb_session_add_stroke (session, &stroke))
+	print_candidates (candidates,
+			  lw_strokedb_session_get_candidates (session, candidates, max_candidates));
     }
-  
-  fclose (file);
-}
 
-/* From Ken Lunde's _Understanding Japanese Information Processing_
-   O'Reilly, 1993 */
+  free (buffer);
+  g_free (candidates);
+  lw_strokedb_session_free (session);
 
-void 
-sjis2jis(unsigned char *p1, unsigned char *p2)
-{
-  unsigned char c1 = *p1;
-  unsigned char c2 = *p2;
-  int adjust = c2 < 159;
-  int rowOffset = c1 < 160 ? 112 : 176;
-  int cellOffset = adjust ? (c2 > 127 ? 32 : 31) : 126;
-  
-  *p1 = ((c1 - rowOffset) << 1) - adjust;
-  *p2 -= cellOffset;  
+  return 0;
 }
 
 int
 process_strokes (FILE *file)
 {
-  RawStroke strokes[MAX_STROKES];
+  LwStroke strokes[LW_STROKEDB_MAX_STROKES];
   char *buffer = malloc(BUFLEN);
   int buflen = BUFLEN;
   int nstrokes = 0;
@@ -133,81 +164,31 @@ process_strokes (FILE *file)
   
   while (1)
     {
-      char *p,*q;
       int len;
 
-      if (!fgets(buffer, buflen, file))
+      len = read_stroke (file, &buffer, &buflen, &strokes[nstrokes]);
+      if (len < 0)
 	return 0;
-
-      while ((strlen(buffer) == buflen - 1) && (buffer[buflen-2] != '\n'))
-	{
-	  buflen += BUFLEN;
-	  buffer = realloc(buffer, buflen);
-	  if (!fgets(buffer+buflen-BUFLEN-1, BUFLEN+1, file))
-	    return 0;
-	}
-      
-      len = 0;
-      p = buffer;
-      
-      while (1) {
-	while (isspace (*p)) p++;
-	if (*p == 0)
-	  break;
-	strokes[nstrokes].m_x[len] = strtol (p, &q, 0);
-	if (p == q)
-	  break;
-	p = q;
-	  
-	while (isspace (*p)) p++;
-	if (*p == 0)
-	  break;
-	strokes[nstrokes].m_y[len] = strtol (p, &q, 0);
-	if (p == q)
-	  break;
-	p = q;
-	
-	len++;
-      }
-      
       if (len == 0)
 	break;
       
-      strokes[nstrokes].m_len = len;
       nstrokes++;
-      if (nstrokes == MAX_STROKES)
+      if (nstrokes == LW_STROKEDB_MAX_STROKES)
 	break;
     }
   
-  if (nstrokes != 0 && stroke_dicts[nstrokes])
+  free (buffer);
+
+  if (nstrokes != 0 && stroke_db->tables[nstrokes].total > 0)
     {
-      int i;
-      ListMem *top_picks;
-      StrokeScorer *scorer = StrokeScorerCreate (stroke_dicts[nstrokes],
-						 strokes, nstrokes);
-      if (scorer)
-	{
-	  StrokeScorerProcess(scorer, -1);
-	  top_picks = StrokeScorerTopPicks(scorer);
-	  StrokeScorerDestroy(scorer);
-	  
-	  printf("K");
-	  for (i=0;i<top_picks->m_argc;i++)
-	    {
-	      unsigned char c[2];
-	      if (i)
-		printf(" ");
-	      c[0] = top_picks->m_argv[i][0];
-	      c[1] = top_picks->m_argv[i][1];
-	      sjis2jis(&c[0],&c[1]);
-	      printf("%2x%2x",c[0],c[1]);
-	    }
-	  
-	  free(top_picks);
-	}
-      printf("\n");
+      int total;
+      LwStrokeDBCandidate *candidates = g_new (LwStrokeDBCandidate, max_candidates);
+
+      total = lw_strokedb_recognize (stroke_db, strokes, nstrokes,
+				     candidates, max_candidates);
 
-      fflush(stdout);
+      print_candidates (candidates, total);
+      g_free (candidates);
     }
   return 1;
 }
@@ -215,7 +196,7 @@ process_strokes (FILE *file)
 void
 usage ()
 {
-  fprintf(stderr, "Usage: %s [-f/--data-file FILE]\n", progname);
+  fprintf(stderr, "Usage: %s [-f/--data-file FILE] [-n/--candidates N] [-i/--incremental]\n", progname);
   exit (1);
 }
 
@@ -241,16 +222,39 @@ real_main(int argc, char **argv)
 	  else
 	    usage();
 	}
+      else if (!strcmp(argv[i], "--candidates") ||
+	       !strcmp(argv[i], "-n"))
+	{
+	  i++;
+	  if (i < argc && atoi(argv[i]) > 0)
+	    max_candidates = atoi(argv[i]);
+	  else
+	    usage();
+	}
+      else if (!strcmp(argv[i], "--incremental") ||
+	       !strcmp(argv[i], "-i"))
+	{
+	  incremental = 1;
+	}
       else
 	{
 	  usage();
 	}
     }
   
+  /* Recognition is split over threads */
+  if (!g_thread_supported ())
+    g_thread_init (NULL);
+
   load_database();
 
-  while (process_strokes (stdin))
-    ;
+  if (incremental)
+    process_incremental (stdin);
+  else
+    while (process_strokes (stdin))
+      ;
+
+  lw_strokedb_free (stroke_db);
 
   return 0;
 }
@@ -0,0 +1,406 @@
+/******************************************************************************
+    AUTHOR:
+    File written and Copyrighted by Zachary Dovel. All Rights Reserved.
+
+    LICENSE:
+    This file is part of gWaei.
+
+    gWaei is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    gWaei is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    
+    You should have received a copy of the GNU General Public License
+    along with gWaei.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+
+
+//!
+//! @file ahocorasick.c
+//!
+//! @brief An Aho-Corasick automaton for finding many patterns in one pass
+//!
+//! The patterns are added to a byte trie, and compiling gives every trie
+//! node a failure link to the node of its longest proper suffix, found in
+//! breadth first order, and an output link to the nearest node on that chain
+//! that ends a pattern.  Scanning a text then takes one transition per byte
+//! plus one callback per match, however many patterns there are.  Working on
+//! bytes instead of characters is safe for UTF-8 since a match of a whole
+//! UTF-8 pattern always starts and ends on character boundaries.
+//!
+
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <glib.h>
+
+#include <libwaei/libwaei.h>
+
+
+//!
+//! @brief Creates a new LwAhoCorasick object
+//! @return An allocated LwAhoCorasick that will be needed to be freed by lw_ahocorasick_free.
+//!
+LwAhoCorasick* 
+lw_ahocorasick_new ()
+{
+    LwAhoCorasick *temp;
+
+    temp = (LwAhoCorasick*) malloc(sizeof(LwAhoCorasick));
+
+    if (temp != NULL)
+    {
+      lw_ahocorasick_init (temp);
+    }
+
+    return temp;
+}
+
+
+//!
+//! @brief Releases a LwAhoCorasick object from memory.
+//! @param automaton A LwAhoCorasick object created by lw_ahocorasick_new.
+//!
+void 
+lw_ahocorasick_free (LwAhoCorasick *automaton)
+{
+    lw_ahocorasick_deinit (automaton);
+    free (automaton);
+}
+
+
+static guint32 
+_ahocorasick_new_state (LwAhoCorasick *automaton)
+{
+    //Declarations
+    LwAhoCorasickState state;
+
+    //Initializations
+    memset (&state, 0, sizeof(LwAhoCorasickState));
+    state.pattern = -1;
+
+    g_array_append_val (automaton->states, state);
+
+    return automaton->states->len - 1;
+}
+
+
+//!
+//! @brief Used to initialize the memory inside of a new LwAhoCorasick object.
+//!        Usually lw_ahocorasick_new calls this for you.
+//! @param automaton The LwAhoCorasick to initialize
+//!
+void 
+lw_ahocorasick_init (LwAhoCorasick *automaton)
+{
+    automaton->states = g_array_new (FALSE, FALSE, sizeof(LwAhoCorasickState));
+    automaton->edges = g_array_new (FALSE, FALSE, sizeof(LwAhoCorasickEdge));
+    automaton->patterns = g_array_new (FALSE, FALSE, sizeof(LwAhoCorasickPattern));
+    automaton->trie = g_hash_table_new (g_direct_hash, g_direct_equal);
+    memset (automaton->root, 0, sizeof(automaton->root));
+    automaton->ignore_case = FALSE;
+    automaton->compiled = FALSE;
+
+    _ahocorasick_new_state (automaton);
+}
+
+
+//!
+//! @brief Used to free the memory inside of a LwAhoCorasick object.
+//!        Usually lw_ahocorasick_free calls this for you.
+//! @param automaton The LwAhoCorasick to deinitialize
+//!
+void 
+lw_ahocorasick_deinit (LwAhoCorasick *automaton)
+{
+    g_array_free (automaton->states, TRUE); automaton->states = NULL;
+    g_array_free (automaton->edges, TRUE); automaton->edges = NULL;
+    g_array_free (automaton->patterns, TRUE); automaton->patterns = NULL;
+    if (automaton->trie != NULL) g_hash_table_destroy (automaton->trie); automaton->trie = NULL;
+}
+
+
+//!
+//! @brief Sets if the automaton should ignore the case of ASCII letters.  It has
+//!        to be set before any pattern is added.
+//! @param automaton The LwAhoCorasick to set
+//! @param ignore_case Whether upper and lower case ASCII letters match each other
+//!
+void 
+lw_ahocorasick_set_ignore_case (LwAhoCorasick *automaton, gboolean ignore_case)
+{
+    g_return_if_fail (automaton->patterns->len == 0);
+    automaton->ignore_case = ignore_case;
+}
+
+
+//!
+//! @brief Adds a pattern to an automaton that hasn't been compiled yet.  The same
+//!        pattern can be added more than once, and each one is reported.
+//! @param automaton The LwAhoCorasick to add to
+//! @param PATTERN A nonempty string to find
+//! @param data Data to keep with the pattern
+//! @returns The index of the pattern or -1 if it couldn't be added
+//!
+gint 
+lw_ahocorasick_add (LwAhoCorasick *automaton, const gchar *PATTERN, gpointer data)
+{
+    //Sanity check
+    g_return_val_if_fail (!automaton->compiled, -1);
+    if (PATTERN == NULL || *PATTERN == '\0') return -1;
+
+    //Declarations
+    LwAhoCorasickState *state;
+    LwAhoCorasickPattern pattern;
+    const guchar *ptr;
+    guint32 current;
+    guint32 next;
+    guint key;
+    guchar c;
+
+    //Initializations
+    current = LW_AHOCORASICK_ROOT;
+
+    for (ptr = (const guchar*) PATTERN; *ptr != '\0'; ptr++)
+    {
+      c = (automaton->ignore_case) ? g_ascii_tolower (*ptr) : *ptr;
+      key = (current << 8) | c;
+      next = GPOINTER_TO_UINT (g_hash_table_lookup (automaton->trie, GUINT_TO_POINTER (key)));
+      if (next == LW_AHOCORASICK_ROOT)
+      {
+        next = _ahocorasick_new_state (automaton);
+        g_hash_table_insert (automaton->trie, GUINT_TO_POINTER (key), GUINT_TO_POINTER (next));
+      }
+      current = next;
+    }
+
+    state = &g_array_index (automaton->states, LwAhoCorasickState, current);
+    pattern.length = ptr - (const guchar*) PATTERN;
+    pattern.next = state->pattern;
+    pattern.data = data;
+    g_array_append_val (automaton->patterns, pattern);
+    state->pattern = automaton->patterns->len - 1;
+
+    return state->pattern;
+}
+
+
+static gint 
+_ahocorasick_compare_edges (gconstpointer a, gconstpointer b)
+{
+    //Declarations
+    const LwAhoCorasickEdge *edge_a, *edge_b;
+
+    //Initializations
+    edge_a = a;
+    edge_b = b;
+
+    if (edge_a->state != edge_b->state) return (edge_a->state < edge_b->state) ? -1 : 1;
+    return (gint) edge_a->byte - (gint) edge_b->byte;
+}
+
+
+//!
+//! @brief Follows the trie edge of a state for a byte
+//! @returns The target state or the root if the state has no such edge
+//!
+static inline guint32 
+_ahocorasick_follow_edge (LwAhoCorasick *automaton, guint32 current, guchar c)
+{
+    //Declarations
+    const LwAhoCorasickState *state;
+    const LwAhoCorasickEdge *edges;
+    guint32 low, high, middle;
+
+    if (current == LW_AHOCORASICK_ROOT) return automaton->root[c];
+
+    //Initializations
+    state = &g_array_index (automaton->states, LwAhoCorasickState, current);
+    edges = &g_array_index (automaton->edges, LwAhoCorasickEdge, state->edges);
+    low = 0;
+    high = state->total_edges;
+
+    while (low < high)
+    {
+      middle = (low + high) / 2;
+      if (edges[middle].byte < c) low = middle + 1;
+      else if (edges[middle].byte > c) high = middle;
+      else return edges[middle].target;
+    }
+
+    return LW_AHOCORASICK_ROOT;
+}
+
+
+//!
+//! @brief Gets the state the automaton moves to from a state on a byte,
+//!        following failure links until an edge matches
+//!
+static inline guint32 
+_ahocorasick_next (LwAhoCorasick *automaton, guint32 current, guchar c)
+{
+    //Declarations
+    guint32 next;
+
+    while (current != LW_AHOCORASICK_ROOT)
+    {
+      if ((next = _ahocorasick_follow_edge (automaton, current, c)) != LW_AHOCORASICK_ROOT) return next;
+      current = g_array_index (automaton->states, LwAhoCorasickState, current).fail;
+    }
+
+    return automaton->root[c];
+}
+
+
+//!
+//! @brief Lays out the trie edges and computes the failure and output links.
+//!        No more patterns can be added afterwards.
+//! @param automaton The LwAhoCorasick to compile
+//!
+void 
+lw_ahocorasick_compile (LwAhoCorasick *automaton)
+{
+    if (automaton->compiled) return;
+
+    //Declarations
+    GHashTableIter iter;
+    gpointer key, value;
+    LwAhoCorasickEdge edge;
+    LwAhoCorasickEdge *edges;
+    LwAhoCorasickState *states;
+    guint32 *queue;
+    guint32 head, tail;
+    guint32 current;
+    guint32 fail;
+    guint32 target;
+    guint i;
+
+    //Lay out the edges of every state sorted by byte
+    g_hash_table_iter_init (&iter, automaton->trie);
+    while (g_hash_table_iter_next (&iter, &key, &value))
+    {
+      edge.state = GPOINTER_TO_UINT (key) >> 8;
+      edge.byte = GPOINTER_TO_UINT (key) & 0xff;
+      edge.target = GPOINTER_TO_UINT (value);
+      g_array_append_val (automaton->edges, edge);
+    }
+    g_hash_table_destroy (automaton->trie); automaton->trie = NULL;
+    g_array_sort (automaton->edges, _ahocorasick_compare_edges);
+
+    states = (LwAhoCorasickState*) automaton->states->data;
+    edges = (LwAhoCorasickEdge*) automaton->edges->data;
+
+    for (i = automaton->edges->len; i > 0; i--)
+    {
+      states[edges[i - 1].state].edges = i - 1;
+      states[edges[i - 1].state].total_edges++;
+    }
+    for (i = 0; i < states[LW_AHOCORASICK_ROOT].total_edges; i++)
+    {
+      edge = edges[states[LW_AHOCORASICK_ROOT].edges + i];
+      automaton->root[edge.byte] = edge.target;
+    }
+    automaton->compiled = TRUE;
+
+    //Breadth first, so the failure links of shallower states are always known
+    queue = g_new (guint32, automaton->states->len);
+    head = tail = 0;
+    queue[tail++] = LW_AHOCORASICK_ROOT;
+
+    while (head < tail)
+    {
+      current = queue[head++];
+      for (i = 0; i < states[current].total_edges; i++)
+      {
+        edge = edges[states[current].edges + i];
+        target = edge.target;
+
+        if (current == LW_AHOCORASICK_ROOT)
+          fail = LW_AHOCORASICK_ROOT;
+        else
+          fail = _ahocorasick_next (automaton, states[current].fail, edge.byte);
+
+        states[target].fail = fail;
+        states[target].output = (states[target].pattern >= 0) ? target : states[fail].output;
+        queue[tail++] = target;
+      }
+    }
+
+    //Cleanup
+    g_free (queue); queue = NULL;
+}
+
+
+//!
+//! @brief Finds every occurrence of every pattern in a text, overlapping ones included
+//! @param automaton A compiled LwAhoCorasick
+//! @param TEXT The text to scan
+//! @param LENGTH The length of the text in bytes
+//! @param func The LwAhoCorasickMatchFunc to call for each match
+//! @param data Data to pass to func
+//! @returns FALSE if func stopped the scan
+//!
+gboolean 
+lw_ahocorasick_scan (LwAhoCorasick         *automaton, 
+                     const gchar           *TEXT, 
+                     gsize                  LENGTH, 
+                     LwAhoCorasickMatchFunc func, 
+                     gpointer               data)
+{
+    //Sanity check
+    g_return_val_if_fail (automaton->compiled, FALSE);
+
+    //Declarations
+    const LwAhoCorasickState *states;
+    const LwAhoCorasickPattern *patterns;
+    guint32 current;
+    guint32 output;
+    gint32 pattern;
+    gsize i;
+    guchar c;
+
+    //Initializations
+    states = (const LwAhoCorasickState*) automaton->states->data;
+    patterns = (const LwAhoCorasickPattern*) automaton->patterns->data;
+    current = LW_AHOCORASICK_ROOT;
+
+    for (i = 0; i < LENGTH; i++)
+    {
+      c = (guchar) TEXT[i];
+      if (automaton->ignore_case) c = g_ascii_tolower (c);
+      current = _ahocorasick_next (automaton, current, c);
+
+      for (output = states[current].output; output != LW_AHOCORASICK_ROOT; output = states[states[output].fail].output)
+      {
+        for (pattern = states[output].pattern; pattern >= 0; pattern = patterns[pattern].next)
+        {
+          if (!func (pattern, i + 1 - patterns[pattern].length, i + 1, data)) return FALSE;
+        }
+      }
+    }
+
+    return TRUE;
+}
+
+
+gint 
+lw_ahocorasick_get_total_patterns (LwAhoCorasick *automaton)
+{
+    return automaton->patterns->len;
+}
+
+
+gpointer 
+lw_ahocorasick_get_pattern_data (LwAhoCorasick *automaton, gint pattern)
+{
+    g_return_val_if_fail (pattern >= 0 && pattern < automaton->patterns->len, NULL);
+    return g_array_index (automaton->patterns, LwAhoCorasickPattern, pattern).data;
+}
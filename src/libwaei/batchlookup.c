@@ -0,0 +1,407 @@
+/******************************************************************************
+    AUTHOR:
+    File written and Copyrighted by Zachary Dovel. All Rights Reserved.
+
+    LICENSE:
+    This file is part of gWaei.
+
+    gWaei is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    gWaei is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    
+    You should have received a copy of the GNU General Public License
+    along with gWaei.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+
+
+//!
+//! @file batchlookup.c
+//!
+//! @brief Looks up a whole vocabulary list in one pass over an EDICT dictionary
+//!
+//! Only the headword part of each line, before the first gloss, is scanned.
+//! A key only counts where it is a whole headword or reading, so it has to
+//! start after the start of the line, a ';' or a '[' and end before a ' ',
+//! ';', ']' or '('.  A word takes an entry when its kanji, or its furigana
+//! for a kana word, is one of the headwords of the entry, and the entry that
+//! also has the furigana of the word as a reading and is common wins over the
+//! others.
+//!
+
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include <libwaei/libwaei.h>
+
+
+//!
+//! @brief Creates a new LwBatchLookup object
+//! @return An allocated LwBatchLookup that will be needed to be freed by lw_batchlookup_free.
+//!
+LwBatchLookup* 
+lw_batchlookup_new ()
+{
+    LwBatchLookup *temp;
+
+    temp = (LwBatchLookup*) malloc(sizeof(LwBatchLookup));
+
+    if (temp != NULL)
+    {
+      lw_batchlookup_init (temp);
+    }
+
+    return temp;
+}
+
+
+//!
+//! @brief Releases a LwBatchLookup object from memory.
+//! @param lookup A LwBatchLookup object created by lw_batchlookup_new.
+//!
+void 
+lw_batchlookup_free (LwBatchLookup *lookup)
+{
+    lw_batchlookup_deinit (lookup);
+    free (lookup);
+}
+
+
+//!
+//! @brief Used to initialize the memory inside of a new LwBatchLookup object.
+//!        Usually lw_batchlookup_new calls this for you.
+//! @param lookup The LwBatchLookup to initialize
+//!
+void 
+lw_batchlookup_init (LwBatchLookup *lookup)
+{
+    lookup->automaton = lw_ahocorasick_new ();
+    lookup->scores = g_array_new (FALSE, TRUE, sizeof(gint));
+    lookup->results = g_ptr_array_new ();
+    lookup->hits = g_array_new (FALSE, FALSE, sizeof(LwBatchLookupHit));
+    lookup->line = NULL;
+    lookup->reading = NULL;
+}
+
+
+//!
+//! @brief Used to free the memory inside of a LwBatchLookup object.
+//!        Usually lw_batchlookup_free calls this for you.
+//! @param lookup The LwBatchLookup to deinitialize
+//!
+void 
+lw_batchlookup_deinit (LwBatchLookup *lookup)
+{
+    //Declarations
+    guint i;
+
+    for (i = 0; i < lookup->results->len; i++)
+    {
+      if (g_ptr_array_index (lookup->results, i) != NULL)
+        lw_vocabularyitem_free (LW_VOCABULARYITEM (g_ptr_array_index (lookup->results, i)));
+    }
+
+    lw_ahocorasick_free (lookup->automaton); lookup->automaton = NULL;
+    g_array_free (lookup->scores, TRUE); lookup->scores = NULL;
+    g_ptr_array_free (lookup->results, TRUE); lookup->results = NULL;
+    g_array_free (lookup->hits, TRUE); lookup->hits = NULL;
+}
+
+
+//!
+//! @brief Adds a word to look up.  Words can't be added after the first run.
+//! @param lookup The LwBatchLookup to add to
+//! @param KANJI The kanji of the word or the kana of a kana word, or NULL
+//! @param FURIGANA The reading of the word or NULL
+//! @returns The index of the word to get its result with
+//!
+gint 
+lw_batchlookup_add (LwBatchLookup *lookup, const gchar *KANJI, const gchar *FURIGANA)
+{
+    //Declarations
+    gint word;
+    gint score;
+    gpointer result;
+
+    //Initializations
+    word = lookup->results->len;
+    score = 0;
+    result = NULL;
+
+    //The low bit of the pattern data tells the kanji from the furigana
+    if (KANJI != NULL) lw_ahocorasick_add (lookup->automaton, KANJI, GINT_TO_POINTER (word << 1));
+    if (FURIGANA != NULL) lw_ahocorasick_add (lookup->automaton, FURIGANA, GINT_TO_POINTER ((word << 1) | 1));
+
+    g_array_append_val (lookup->scores, score);
+    g_ptr_array_add (lookup->results, result);
+
+    return word;
+}
+
+
+//!
+//! @brief Adds every item of a vocabulary list in order, so the result of the
+//!        nth item is the nth result
+//! @param lookup The LwBatchLookup to add to
+//! @param list The LwVocabularyList to look up
+//! @returns The number of words added
+//!
+gint 
+lw_batchlookup_add_vocabularylist (LwBatchLookup *lookup, LwVocabularyList *list)
+{
+    //Declarations
+    LwVocabularyItem *item;
+    GList *link;
+    gint total;
+
+    //Initializations
+    total = 0;
+
+    for (link = lw_vocabularylist_get_items (list); link != NULL; link = link->next)
+    {
+      item = LW_VOCABULARYITEM (link->data);
+      lw_batchlookup_add (lookup, lw_vocabularyitem_get_kanji (item), lw_vocabularyitem_get_furigana (item));
+      total++;
+    }
+
+    return total;
+}
+
+
+//!
+//! @brief A LwAhoCorasickMatchFunc that notes the words whose keys are whole
+//!        headwords or readings of the line being scanned
+//!
+static gboolean 
+_batchlookup_add_hit (gint pattern, gsize start, gsize end, gpointer data)
+{
+    //Declarations
+    LwBatchLookup *lookup;
+    LwBatchLookupHit hit;
+    LwBatchLookupHit *hits;
+    const gchar *line;
+    gboolean is_furigana;
+    gboolean is_reading;
+    guint i;
+
+    //Initializations
+    lookup = LW_BATCHLOOKUP (data);
+    line = lookup->line;
+    hit.word = GPOINTER_TO_INT (lw_ahocorasick_get_pattern_data (lookup->automaton, pattern));
+    is_furigana = (hit.word & 1);
+    hit.word >>= 1;
+
+    if (start > 0 && line[start - 1] != ';' && line[start - 1] != '[') return TRUE;
+    if (strchr (" ;](", line[end]) == NULL || line[end] == '\0') return TRUE;
+
+    is_reading = (lookup->reading != NULL && line + start >= lookup->reading);
+    if (is_furigana)
+      hit.matches = (is_reading) ? LW_BATCHLOOKUP_MATCH_FURIGANA_AS_READING : LW_BATCHLOOKUP_MATCH_FURIGANA_AS_HEADWORD;
+    else
+      hit.matches = (is_reading) ? LW_BATCHLOOKUP_MATCH_KANJI_AS_READING : LW_BATCHLOOKUP_MATCH_KANJI_AS_HEADWORD;
+
+    //A line only ever matches a few words
+    hits = (LwBatchLookupHit*) lookup->hits->data;
+    for (i = 0; i < lookup->hits->len; i++)
+    {
+      if (hits[i].word == hit.word)
+      {
+        hits[i].matches |= hit.matches;
+        return TRUE;
+      }
+    }
+    g_array_append_val (lookup->hits, hit);
+
+    return TRUE;
+}
+
+
+//!
+//! @brief Scores how well a line fits a word
+//! @returns The score or 0 if the line isn't an entry of the word
+//!
+static gint
+_batchlookup_get_score (guint matches, gboolean common)
+{
+    //Declarations
+    gint score;
+
+    if (!(matches & (LW_BATCHLOOKUP_MATCH_KANJI_AS_HEADWORD | LW_BATCHLOOKUP_MATCH_FURIGANA_AS_HEADWORD))) return 0;
+
+    //Initializations
+    score = 0;
+
+    if (matches & LW_BATCHLOOKUP_MATCH_KANJI_AS_HEADWORD) score += 8;
+    if (matches & LW_BATCHLOOKUP_MATCH_FURIGANA_AS_READING) score += 4;
+    if (matches & (LW_BATCHLOOKUP_MATCH_FURIGANA_AS_HEADWORD | LW_BATCHLOOKUP_MATCH_KANJI_AS_READING)) score += 2;
+    if (common) score += 1;
+
+    return score;
+}
+
+
+//!
+//! @brief Makes the result of a word from a dictionary line the way the
+//!        add links of the search results do
+//!
+static LwVocabularyItem*
+_batchlookup_new_result (LwResultLine *resultline, const gchar *LINE)
+{
+    //Declarations
+    LwVocabularyItem *item;
+    gchar *definitions;
+    gchar *ptr;
+
+    strncpy (resultline->string, LINE, LW_IO_MAX_FGETS_LINE - 1);
+    resultline->string[LW_IO_MAX_FGETS_LINE - 1] = '\0';
+    lw_resultline_parse_edict_result_string (resultline);
+
+    if ((definitions = g_strjoinv ("/", resultline->def_start)) == NULL) return NULL;
+    g_strdelimit (definitions, ";", ',');
+
+    //Keep the first headword and reading of EDICT2 lines since ';' splits the fields of a word
+    if ((ptr = strpbrk (resultline->kanji_start, ";(")) != NULL) *ptr = '\0';
+    if (resultline->furigana_start != NULL && (ptr = strpbrk (resultline->furigana_start, ";(")) != NULL) *ptr = '\0';
+
+    if ((item = lw_vocabularyitem_new ()) != NULL)
+    {
+      lw_vocabularyitem_set_kanji (item, resultline->kanji_start);
+      lw_vocabularyitem_set_furigana (item, resultline->furigana_start);
+      lw_vocabularyitem_set_definitions (item, definitions);
+    }
+
+    //Cleanup
+    g_free (definitions); definitions = NULL;
+
+    return item;
+}
+
+
+//!
+//! @brief Streams an EDICT dictionary once, keeping the best entry of every word
+//!        added.  It can be run on more than one dictionary, and a later
+//!        dictionary only replaces a result with a better one.
+//! @param lookup The LwBatchLookup to run
+//! @param di The LwDictInfo of an EDICT dictionary
+//! @param cb A LwIoProgressCallback to use to give progress feedback or NULL
+//! @param data A gpointer to data to pass to the LwIoProgressCallback
+//! @param error A pointer to a GError to write errors to or NULL
+//! @returns FALSE if the dictionary couldn't be read or the progress callback cancelled the run
+//!
+gboolean 
+lw_batchlookup_run (LwBatchLookup *lookup, LwDictInfo *di, LwIoProgressCallback cb, gpointer data, GError **error)
+{
+    //Sanity check
+    if (error != NULL && *error != NULL) return FALSE;
+    g_return_val_if_fail (di->type == LW_DICTTYPE_EDICT, FALSE);
+
+    //Declarations
+    gchar *path;
+    FILE *file;
+    gchar buffer[LW_IO_MAX_FGETS_LINE];
+    LwResultLine *resultline;
+    LwBatchLookupHit *hit;
+    LwVocabularyItem *result;
+    gchar *end;
+    gint *best;
+    gint score;
+    glong offset;
+    glong lines;
+    guint i;
+    gboolean ok;
+
+    //Initializations
+    path = lw_dictinfo_get_uri (di);
+    file = NULL;
+    resultline = lw_resultline_new ();
+    offset = 0;
+    lines = 0;
+    ok = TRUE;
+
+    lw_ahocorasick_compile (lookup->automaton);
+
+    if (path == NULL || (file = g_fopen (path, "r")) == NULL)
+    {
+      g_set_error (error, g_quark_from_string (LW_IO_ERROR), LW_IO_READ_ERROR, "Unable to read the dictionary %s", path);
+      ok = FALSE;
+    }
+
+    if (cb != NULL && ok) cb (0.0, data);
+
+    while (ok && fgets (buffer, LW_IO_MAX_FGETS_LINE, file) != NULL)
+    {
+      offset += strlen (buffer);
+      if (cb != NULL && (++lines % 10000) == 0 && di->length > 0)
+      {
+        if (cb (MIN ((gdouble) offset / (gdouble) di->length, 1.0), data) != 0) ok = FALSE;
+      }
+      if (buffer[0] == '#' || (end = strstr (buffer, " /")) == NULL) continue;
+
+      lookup->line = buffer;
+      lookup->reading = strchr (buffer, '[');
+      if (lookup->reading != NULL && lookup->reading > end) lookup->reading = NULL;
+      g_array_set_size (lookup->hits, 0);
+
+      lw_ahocorasick_scan (lookup->automaton, buffer, end - buffer, _batchlookup_add_hit, lookup);
+
+      for (i = 0; i < lookup->hits->len; i++)
+      {
+        hit = &g_array_index (lookup->hits, LwBatchLookupHit, i);
+        best = &g_array_index (lookup->scores, gint, hit->word);
+        score = _batchlookup_get_score (hit->matches, strstr (end, "/(P)/") != NULL);
+
+        if (score > *best && (result = _batchlookup_new_result (resultline, buffer)) != NULL)
+        {
+          if (g_ptr_array_index (lookup->results, hit->word) != NULL)
+            lw_vocabularyitem_free (LW_VOCABULARYITEM (g_ptr_array_index (lookup->results, hit->word)));
+          g_ptr_array_index (lookup->results, hit->word) = result;
+          *best = score;
+        }
+      }
+    }
+
+    if (cb != NULL && ok) cb (1.0, data);
+
+    //Cleanup
+    lookup->line = NULL;
+    lookup->reading = NULL;
+    if (file != NULL) fclose (file); file = NULL;
+    if (path != NULL) g_free (path); path = NULL;
+    lw_resultline_free (resultline); resultline = NULL;
+
+    return ok;
+}
+
+
+gint 
+lw_batchlookup_get_total_words (LwBatchLookup *lookup)
+{
+    return lookup->results->len;
+}
+
+
+//!
+//! @brief Gets the entry found for a word
+//! @param lookup A LwBatchLookup that has been run
+//! @param word The index of the word returned by lw_batchlookup_add
+//! @returns A LwVocabularyItem owned by the lookup with the kanji, furigana and
+//!          definitions of the entry, or NULL if none was found
+//!
+LwVocabularyItem* 
+lw_batchlookup_get_result (LwBatchLookup *lookup, gint word)
+{
+    g_return_val_if_fail (word >= 0 && word < lookup->results->len, NULL);
+    return LW_VOCABULARYITEM (g_ptr_array_index (lookup->results, word));
+}
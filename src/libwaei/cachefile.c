@@ -0,0 +1,247 @@
+/******************************************************************************
+    AUTHOR:
+    File written and Copyrighted by Zachary Dovel. All Rights Reserved.
+
+    LICENSE:
+    This file is part of gWaei.
+
+    gWaei is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    gWaei is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with gWaei.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+
+//!
+//! @file cachefile.c
+//!
+//! @brief Writes and maps the index files kept in the cache folder for a dictionary
+//!
+//! Every index file starts with a LwCacheFileHeader that stamps the size and
+//! modification time of the dictionary it was made from.  The index files
+//! are written to the cache folder rather than next to the dictionary, since
+//! every file in a dictionary folder is taken to be a dictionary.
+//!
+
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include <libwaei/libwaei.h>
+
+
+//!
+//! @brief Gets the path of the index file of a dictionary
+//! @param TYPE The LwCacheFileType of the index
+//! @param DICTTYPE The LwDictType of the dictionary
+//! @param FILENAME The filename of the dictionary in its dictionary folder
+//! @returns An allocated string that should be freed with g_free
+//!
+gchar* 
+lw_cachefile_get_uri (const LwCacheFileType *TYPE, LwDictType DICTTYPE, const gchar *FILENAME)
+{
+    //Declarations
+    gchar *name;
+    gchar *uri;
+
+    //Initializations
+    name = g_strdup_printf ("%s-%s.%s", lw_util_dicttype_to_string (DICTTYPE), FILENAME, TYPE->extension);
+    uri = lw_util_build_filename (LW_PATH_CACHE, name);
+
+    //Cleanup
+    g_free (name);
+
+    return uri;
+}
+
+
+//!
+//! @brief Stamps the header of a laid out index with the dictionary as it is now
+//!        and writes it to the cache folder
+//! @param TYPE The LwCacheFileType of the index
+//! @param DICTTYPE The LwDictType of the dictionary
+//! @param FILENAME The filename of the dictionary in its dictionary folder
+//! @param data The contents of the index file.  It has to start with a LwCacheFileHeader.
+//! @param length The length of the contents in bytes
+//! @param error A pointer to a GError to write errors to or NULL
+//! @returns FALSE if the dictionary is missing or the index couldn't be written
+//!
+gboolean 
+lw_cachefile_write (const LwCacheFileType *TYPE, LwDictType DICTTYPE, const gchar *FILENAME, gchar *data, gsize length, GError **error)
+{
+    //Sanity check
+    if (error != NULL && *error != NULL) return FALSE;
+    g_assert (length >= sizeof(LwCacheFileHeader));
+
+    //Declarations
+    LwCacheFileHeader *header;
+    GStatBuf info;
+    gchar *path;
+    gchar *uri;
+    gboolean written;
+
+    //Initializations
+    header = (LwCacheFileHeader*) data;
+    path = lw_util_build_filename_by_dicttype (DICTTYPE, FILENAME);
+    uri = lw_cachefile_get_uri (TYPE, DICTTYPE, FILENAME);
+    written = FALSE;
+
+    if (g_stat (path, &info) != 0)
+    {
+      g_set_error (error, g_quark_from_string (LW_IO_ERROR), LW_IO_READ_ERROR, "Unable to read the dictionary %s", path);
+    }
+    else
+    {
+      header->magic = TYPE->magic;
+      header->version = TYPE->version;
+      header->dictionary_size = info.st_size;
+      header->dictionary_mtime = info.st_mtime;
+      written = g_file_set_contents (uri, data, length, error);
+    }
+
+    //Cleanup
+    g_free (path);
+    g_free (uri);
+
+    return written;
+}
+
+
+//!
+//! @brief Checks that a mapped index is whole and was made from the dictionary as it is now
+//!
+static gboolean 
+_cachefile_validate (const LwCacheFileType *TYPE, GMappedFile *file, GStatBuf *info, GError **error)
+{
+    //Declarations
+    const LwCacheFileHeader *header;
+    gsize length;
+
+    //Initializations
+    header = (const LwCacheFileHeader*) g_mapped_file_get_contents (file);
+    length = g_mapped_file_get_length (file);
+
+    if (length < sizeof(LwCacheFileHeader) || header->magic != TYPE->magic || header->version != TYPE->version)
+    {
+      g_set_error (error, g_quark_from_string (LW_CACHEFILE_ERROR), LW_CACHEFILE_ERROR_CORRUPT, "The %s index is not one this version can read", TYPE->extension);
+      return FALSE;
+    }
+
+    if (header->dictionary_size != info->st_size || header->dictionary_mtime != info->st_mtime)
+    {
+      g_set_error (error, g_quark_from_string (LW_CACHEFILE_ERROR), LW_CACHEFILE_ERROR_OUTDATED, "The dictionary changed since its %s index was made", TYPE->extension);
+      return FALSE;
+    }
+
+    if (!TYPE->check (header, length))
+    {
+      g_set_error (error, g_quark_from_string (LW_CACHEFILE_ERROR), LW_CACHEFILE_ERROR_CORRUPT, "The %s index is truncated", TYPE->extension);
+      return FALSE;
+    }
+
+    return TRUE;
+}
+
+
+//!
+//! @brief Maps an index file and validates it
+//! @returns The mapped file or NULL if it is missing or not valid
+//!
+static GMappedFile* 
+_cachefile_open (const LwCacheFileType *TYPE, const gchar *URI, GStatBuf *info, GError **error)
+{
+    //Declarations
+    GMappedFile *file;
+
+    //Initializations
+    file = g_mapped_file_new (URI, FALSE, error);
+
+    if (file != NULL && !_cachefile_validate (TYPE, file, info, error))
+    {
+      g_mapped_file_unref (file);
+      file = NULL;
+    }
+
+    return file;
+}
+
+
+//!
+//! @brief Maps the index file of a dictionary, writing it first if it is missing
+//!        or older than the dictionary.  Writing it reads the whole dictionary,
+//!        so this shouldn't be called from the main thread.
+//! @param TYPE The LwCacheFileType of the index
+//! @param DICTTYPE The LwDictType of the dictionary
+//! @param FILENAME The filename of the dictionary in its dictionary folder
+//! @param error A pointer to a GError to write errors to or NULL
+//! @returns A GMappedFile starting with a valid LwCacheFileHeader to be freed with g_mapped_file_unref or NULL on error
+//!
+GMappedFile* 
+lw_cachefile_map (const LwCacheFileType *TYPE, LwDictType DICTTYPE, const gchar *FILENAME, GError **error)
+{
+    //Sanity check
+    if (error != NULL && *error != NULL) return NULL;
+
+    //Declarations
+    GMappedFile *file;
+    GStatBuf info;
+    gchar *path;
+    gchar *uri;
+
+    //Initializations
+    path = lw_util_build_filename_by_dicttype (DICTTYPE, FILENAME);
+    uri = lw_cachefile_get_uri (TYPE, DICTTYPE, FILENAME);
+    file = NULL;
+
+    if (g_stat (path, &info) != 0)
+    {
+      g_set_error (error, g_quark_from_string (LW_IO_ERROR), LW_IO_READ_ERROR, "Unable to read the dictionary %s", path);
+    }
+    else
+    {
+      file = _cachefile_open (TYPE, uri, &info, NULL);
+      if (file == NULL && TYPE->build (DICTTYPE, FILENAME, error))
+        file = _cachefile_open (TYPE, uri, &info, error);
+    }
+
+    //Cleanup
+    g_free (path);
+    g_free (uri);
+
+    return file;
+}
+
+
+//!
+//! @brief Removes the index file of a dictionary from the cache folder if there is one
+//! @param TYPE The LwCacheFileType of the index
+//! @param DICTTYPE The LwDictType of the dictionary
+//! @param FILENAME The filename of the dictionary in its dictionary folder
+//!
+void 
+lw_cachefile_remove (const LwCacheFileType *TYPE, LwDictType DICTTYPE, const gchar *FILENAME)
+{
+    //Declarations
+    gchar *uri;
+
+    //Initializations
+    uri = lw_cachefile_get_uri (TYPE, DICTTYPE, FILENAME);
+
+    g_remove (uri);
+
+    //Cleanup
+    g_free (uri);
+}
@@ -220,6 +220,9 @@ lw_dictinfo_uninstall (LwDictInfo *di, LwIoProgressCallback cb, GError **error)
     uri =  lw_util_build_filename_by_dicttype (di->type, di->filename);
 
     lw_io_remove (uri, error);
+    lw_dictmanifest_forget (di->type, di->filename, error);
+    lw_termindex_remove (di->type, di->filename);
+    lw_headwordtrie_remove (di->type, di->filename);
     if (cb != NULL) cb (1.0, di);
 
     g_free (uri);
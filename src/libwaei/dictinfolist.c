@@ -139,6 +139,9 @@ lw_dictinfolist_reload (LwDictInfoList *dil)
       g_strfreev (pair);
     }
     g_strfreev(dictionarylist);
+
+    //Forget what the manifest knew about dictionaries that changed behind our back
+    lw_dictmanifest_refresh (dil->list, NULL);
 }
 
 
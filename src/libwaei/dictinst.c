@@ -202,6 +202,8 @@ lw_dictinst_init (LwDictInst *di,
     di->compression = COMPRESSION; 
     di->encoding = ENCODING;    
     di->split = split;
+    di->split_tags[0] = LW_IO_NAME_TAGS_NAMES;
+    di->split_tags[1] = LW_IO_NAME_TAGS_PLACES;
     di->merge = merge;
     di->builtin = builtin;
 
@@ -387,6 +389,35 @@ lw_dictinst_set_split (LwDictInst *di, const gboolean SPLIT)
 }
 
 
+//!
+//! @brief Updates which lines of the names dictionary go to the Names and
+//!        which to the Places dictionary when it is split
+//! @param di The LwDictInfo objcet to set the split tags on
+//! @param TAGS The tag names of the Names and of the Places dictionary separated
+//!        by a semicolon such as "s,u,g,f,m,h;p".  An empty side keeps its tags.
+//!
+void 
+lw_dictinst_set_split_tags (LwDictInst *di, const char *TAGS)
+{
+    //Declarations
+    gchar **atoms;
+    guint32 tags;
+    int i;
+
+    //Initializations
+    atoms = g_strsplit (TAGS, ";", 2);
+
+    for (i = 0; i < 2 && atoms[i] != NULL; i++)
+    {
+      tags = lw_io_get_name_tags_from_string (atoms[i]);
+      if (tags != 0) di->split_tags[i] = tags;
+    }
+
+    //Cleanup
+    g_strfreev (atoms);
+}
+
+
 //!
 //! @brief This method should be called after the filename, engine, compression,
 //!        or encoding members of the LwDictInst is changed to sync the new paths
@@ -533,9 +564,7 @@ lw_dictinst_data_is_valid (LwDictInst *di)
 //! @param cb A LwIoProgressCallback used to giver user feedback on how far the download is.
 //! @param data A gpointer to data to pass to the LwIoProgressCallback.
 //! @param error A pointer to a GError object to pass errors to or NULL.
-//! @see lw_dictinst_download
-//! @see lw_dictinst_convert_encoding
-//! @see lw_dictinst_postprocess
+//! @see lw_dictinst_process
 //! @see lw_dictinst_install
 //!
 gboolean 
@@ -551,156 +580,148 @@ lw_dictinst_download (LwDictInst *di, LwIoProgressCallback cb, gpointer data, GE
     char *target;
     int i;
     LwDictInstUri group_index;
+    gboolean downloaded;
 
     //Initializations
     group_index = LW_DICTINST_NEEDS_DOWNLOADING;
     i = 0;
+    downloaded = TRUE;
 
-    while ((source = lw_dictinst_get_source_uri (di, group_index, i)) != NULL &&
+    while (downloaded &&
+           (source = lw_dictinst_get_source_uri (di, group_index, i)) != NULL &&
            (target = lw_dictinst_get_target_uri (di, group_index, i)) != NULL
           )
     {
-      //File is located locally so copy it
-      if (g_file_test (source, G_FILE_TEST_IS_REGULAR))
-        lw_io_copy (source, target, (LwIoProgressCallback) cb, data, error);
-      //Download the file
-      else
-        lw_io_download (source, target, cb, data, error);
+      //Download the file.  Local files are read in place by lw_dictinst_process.
+      if (!g_file_test (source, G_FILE_TEST_IS_REGULAR))
+        downloaded = lw_io_download (source, target, cb, data, error);
       i++;
     }
 
-    return (*error == NULL);
+    return downloaded;
 }
 
 
 //!
-//! @brief Detects the compression scheme of a file and decompresses it using the approprate function.
-//!        This function should normally only be used in the lw_dictinst_install function.
-//! @param di The LwDictInst object to use to decompress the dictionary with.
-//! @param cb A LwIoProgressCallback used to giver user feedback on how far the decompression is.
-//! @param data A gpointer to data to pass to the LwIoProgressCallback.
-//! @param error A pointer to a GError object to pass errors to or NULL.
-//! @see lw_dictinst_download
-//! @see lw_dictinst_convert_encoding
-//! @see lw_dictinst_postprocess
-//! @see lw_dictinst_install
+//! @brief A dictionary file being written by lw_dictinst_process
 //!
-gboolean 
-lw_dictinst_decompress (LwDictInst *di, LwIoProgressCallback cb, gpointer data, GError **error)
+struct _LwDictInstOutput {
+  FILE *file;                 //!< The file being written to in the cache folder
+  LwDictManifestTally tally;  //!< The line count and checksum for the manifest
+  LwTermIndexBuilder *terms;  //!< Collects the term index of an EDICT dictionary or NULL
+  LwHeadwordTrieBuilder *trie; //!< Collects the headword trie of an EDICT dictionary or NULL
+  GString *line;              //!< The line being passed to the index builders
+};
+typedef struct _LwDictInstOutput LwDictInstOutput;
+
+
+//!
+//! @brief Used for passing the output state to the LwIoLineFuncs of lw_dictinst_process
+//!
+struct _LwDictInstSink {
+  LwDictInstOutput output[2]; //!< The dictionary files being written
+  LwIoSplitter *splitter;     //!< Sorts the lines of a split dictionary into the outputs
+  LwIoMixData *mix;           //!< The radicals and output of a merged dictionary
+};
+typedef struct _LwDictInstSink LwDictInstSink;
+
+
+//!
+//! @brief Passes the collected line of a LwDictInstOutput to its index builders
+//!
+static void 
+_dictinst_index_line (LwDictInstOutput *output)
 {
-    //Sanity check
-    if (error != NULL && *error != NULL) return FALSE;
-    if (_cancel) return FALSE;
-    g_assert (di != NULL);
+    if (output->line->len == 0) return;
+
+    lw_termindex_builder_add_line (output->line->str, output->line->len, output->terms);
+    lw_headwordtrie_builder_add_line (output->line->str, output->line->len, output->trie);
+    g_string_truncate (output->line, 0);
+}
+
 
+//!
+//! @brief A LwIoWriteFunc that writes to a LwDictInstOutput.  What was written is
+//!        tallied for the manifest and its lines are given to the index builders,
+//!        so the installed dictionary doesn't have to be read again.
+//!
+static gboolean 
+_dictinst_write_output (const gchar *TEXT, gsize LENGTH, gpointer data)
+{
     //Declarations
-    char *source;
-    char *target;
-    LwDictInstUri group_index;
+    LwDictInstOutput *output;
+    const gchar *ptr;
+    const gchar *end;
+    const gchar *next;
 
     //Initializations
-    group_index = LW_DICTINST_NEEDS_DECOMPRESSION;
+    output = data;
+    end = TEXT + LENGTH;
 
-    if ((source = lw_dictinst_get_source_uri (di, group_index, 0)) != NULL &&
-        (target = lw_dictinst_get_target_uri (di, group_index, 0)) != NULL
-       )
-    {
-      //Sanity check
-      g_assert (g_file_test (source, G_FILE_TEST_IS_REGULAR));
+    if (fwrite(TEXT, sizeof(char), LENGTH, output->file) != LENGTH) return FALSE;
+    lw_dictmanifest_tally_text (TEXT, LENGTH, &output->tally);
 
-      //Preform the correct decompression
-      switch (di->compression)
-      {
-        case LW_COMPRESSION_GZIP:
-          lw_io_gunzip_file (source, target, cb, data, error);
-          break;
-        case LW_COMPRESSION_NONE:
-          lw_io_copy (source, target, cb, data, error);
-          break;
-        default:
-          break;
-      }
-
-      //If there is another path, it is assumed to be the radicals dictionary
-      if ((source = lw_dictinst_get_source_uri (di, group_index, 1)) != NULL &&
-          (target = lw_dictinst_get_target_uri (di, group_index, 1)) != NULL
-         )
-      {
-        //Sanity check
-        g_assert (g_file_test (source, G_FILE_TEST_IS_REGULAR));
+    if (output->terms == NULL) return TRUE;
 
-        lw_io_gunzip_file (source, target, cb, data, error);
-      }
+    //The text can hold many lines or the end of one
+    for (ptr = TEXT; ptr < end; ptr = next)
+    {
+      next = memchr (ptr, '\n', end - ptr);
+      next = (next != NULL) ? next + 1 : end;
+      g_string_append_len (output->line, ptr, next - ptr);
+      if (next[-1] == '\n') _dictinst_index_line (output);
     }
 
-    return (error == NULL && *error == NULL);
+    return TRUE;
 }
 
 
 //!
-//! @brief Converts the encoding to UTF8 for the file
-//!        This function should normally only be used in the lw_dictinst_install function.
-//! @param di The LwDictInst object to use to convert the text encoding the dictionary with.
-//! @param cb A LwIoProgressCallback used to giver user feedback on how far the text encoding conversion is.
-//! @param data A gpointer to data to pass to the LwIoProgressCallback.
-//! @param error A pointer to a GError object to pass errors to or NULL.
-//! @see lw_dictinst_download
-//! @see lw_dictinst_convert_encoding
-//! @see lw_dictinst_postprocess
-//! @see lw_dictinst_install
+//! @brief Gets the path a dictionary atom should be streamed from.  Local files are
+//!        read in place and downloaded files are read from the cache.
+//! @param di The LwDictInst object to get the path for
+//! @param ATOM_INDEX The atom of the download group
+//! @returns An allocated string that should be freed with g_free
 //!
-gboolean 
-lw_dictinst_convert_encoding (LwDictInst *di, LwIoProgressCallback cb, gpointer data, GError **error)
+static gchar* 
+_dictinst_get_stream_uri (LwDictInst *di, const int ATOM_INDEX)
 {
-    //Sanity check
-    if (error != NULL && *error != NULL) return FALSE;
-    if (_cancel) return FALSE;
-    g_assert (di != NULL);
-
     //Declarations
-    char *source;
-    char *target;
-    const char *encoding_name;
-    LwDictInstUri group_index;
+    gchar **atoms;
+    gchar *uri;
 
     //Initializations
-    group_index = LW_DICTINST_NEEDS_TEXT_ENCODING;
-    encoding_name = lw_util_get_encoding_name (di->encoding);
+    atoms = g_strsplit (di->uri[LW_DICTINST_NEEDS_DOWNLOADING], ";", -1);
+    uri = g_strdup (lw_dictinst_get_source_uri (di, LW_DICTINST_NEEDS_DECOMPRESSION, ATOM_INDEX));
 
-    if ((source = lw_dictinst_get_source_uri (di, group_index, 0)) != NULL &&
-        (target = lw_dictinst_get_target_uri (di, group_index, 0)) != NULL
-       )
+    if (ATOM_INDEX < g_strv_length (atoms) && g_file_test (atoms[ATOM_INDEX], G_FILE_TEST_IS_REGULAR))
     {
-      if (di->encoding == LW_ENCODING_UTF8)
-        lw_io_copy (source, target, cb, data, error);
-      else
-        lw_io_copy_with_encoding (source, target, encoding_name, "UTF-8", cb, data, error);
-
-      //If there is another path, it is assumed to be the radicals dictionary
-      if ((source = lw_dictinst_get_source_uri (di, group_index, 1)) != NULL &&
-          (target = lw_dictinst_get_target_uri (di, group_index, 1)) != NULL
-         )
-        lw_io_copy_with_encoding (source, target, "EUC-JP", "UTF-8", cb, data, error);
+      g_free (uri);
+      uri = g_strdup (atoms[ATOM_INDEX]);
     }
 
-    return (*error == NULL);
+    //Cleanup
+    g_strfreev (atoms);
+
+    return uri;
 }
 
 
 //!
-//! @brief does the required postprocessing on a dictionary
+//! @brief Decompresses, converts and postprocesses the downloaded dictionary in a single
+//!        streaming pass and then moves it into place.  Nothing is written except the
+//!        final dictionary files, which are built in the cache folder so a failed
+//!        install leaves the currently installed dictionary alone.
 //!        This function should normally only be used in the lw_dictinst_install function.
-//! @param di The LwDictInst object to use for postprocessing the dictionary with.
-//! @param cb A LwIoProgressCallback used to giver user feedback on how far the postprocessing is.
+//! @param di The LwDictInst object to use to process the dictionary with.
+//! @param cb A LwIoProgressCallback used to giver user feedback on how far the processing is.
 //! @param data A gpointer to data to pass to the LwIoProgressCallback.
 //! @param error A pointer to a GError object to pass errors to or NULL.
 //! @see lw_dictinst_download
-//! @see lw_dictinst_convert_encoding
-//! @see lw_dictinst_postprocess
 //! @see lw_dictinst_install
 //!
 gboolean 
-lw_dictinst_postprocess (LwDictInst *di, LwIoProgressCallback cb, gpointer data, GError **error)
+lw_dictinst_process (LwDictInst *di, LwIoProgressCallback cb, gpointer data, GError **error)
 {
     //Sanity check
     if (error != NULL && *error != NULL) return FALSE;
@@ -708,91 +729,151 @@ lw_dictinst_postprocess (LwDictInst *di, LwIoProgressCallback cb, gpointer data,
     g_assert (di != NULL);
 
     //Declarations
+    LwDictInstSink sink;
+    gpointer outputs[2];
+    gchar **temp_uris;
+    gchar **final_uris;
     gchar *source;
-    gchar *source2;
-    gchar *target;
-    gchar *target2;
-    LwDictInstUri group_index;
+    gchar *filename;
+    const char *encoding_name;
+    int total;
+    int i;
+    GQuark domain;
+    const char *message;
+    GError *local_error;
 
     //Initializations
-    group_index = LW_DICTINST_NEEDS_POSTPROCESSING;
-
-    //Rebuild the mix dictionary
-    if (di->merge)
+    local_error = NULL;
+    temp_uris = g_strsplit (di->uri[LW_DICTINST_NEEDS_FINALIZATION], ";", -1);
+    final_uris = g_strsplit (di->uri[LW_DICTINST_NEEDS_NOTHING], ";", -1);
+    total = g_strv_length (temp_uris);
+    encoding_name = NULL;
+    if (di->encoding != LW_ENCODING_UTF8) encoding_name = lw_util_get_encoding_name (di->encoding);
+    sink.mix = NULL;
+    sink.splitter = NULL;
+    for (i = 0; i < 2; i++)
+    {
+      sink.output[i].file = NULL;
+      lw_dictmanifest_tally_init (&sink.output[i].tally);
+      sink.output[i].terms = NULL;
+      sink.output[i].trie = NULL;
+      sink.output[i].line = NULL;
+      outputs[i] = NULL;
+    }
+    for (i = 0; i < total && i < 2; i++)
     {
-      if ((source = lw_dictinst_get_source_uri (di, group_index, 0)) != NULL &&
-          (source2 = lw_dictinst_get_source_uri (di, group_index, 1)) != NULL &&
-          (target = lw_dictinst_get_target_uri (di, group_index, 0)) != NULL
-         )
+      sink.output[i].file = fopen (temp_uris[i], "wb");
+      if (sink.output[i].file != NULL) outputs[i] = &sink.output[i];
+      if (di->type == LW_DICTTYPE_EDICT)
+      {
+        sink.output[i].terms = lw_termindex_builder_new ();
+        sink.output[i].trie = lw_headwordtrie_builder_new ();
+        sink.output[i].line = g_string_sized_new (LW_IO_MAX_FGETS_LINE);
+      }
+      if (sink.output[i].file == NULL && local_error == NULL)
       {
-      lw_io_create_mix_dictionary (target, source, source2, cb, data, error);
+        domain = g_quark_from_string (LW_DICTINST_ERROR);
+        message = gettext("Unable to write to the file %s.");
+        local_error = g_error_new (domain, LW_DICTINST_ERROR_TARGET_PATH, message, temp_uris[i]);
       }
     }
 
-    //Rebuild the names dictionary
-    else if(di->split)
+    //Build the mix dictionary.  The radicals have to be loaded first.
+    if (di->merge && local_error == NULL)
     {
-      if ((source = lw_dictinst_get_source_uri (di, group_index, 0)) != NULL &&
-          (target = lw_dictinst_get_target_uri (di, group_index, 0)) != NULL &&
-          (target2 = lw_dictinst_get_target_uri (di, group_index, 1)) != NULL
-         )
-      lw_io_split_places_from_names_dictionary (target, target2, source, cb, data, error);
+      sink.mix = lw_io_mixdata_new (_dictinst_write_output, &sink.output[0]);
+
+      //The atoms are streamed out of order so track the progress by the stream count
+      source = _dictinst_get_stream_uri (di, 1);
+      di->uri_atom_index = 0;
+      lw_io_stream_file (source, LW_COMPRESSION_GZIP, "EUC-JP", lw_io_mixdata_add_radicals_line, sink.mix, cb, data, &local_error);
+      g_free (source);
+
+      source = _dictinst_get_stream_uri (di, 0);
+      di->uri_atom_index = 1;
+      lw_io_stream_file (source, di->compression, encoding_name, lw_io_mixdata_merge_kanji_line, sink.mix, cb, data, &local_error);
+      g_free (source);
     }
 
-    //Just copy the file no postprocessing required
-    else
+    //Split the names dictionary
+    else if (di->split && local_error == NULL)
     {
-      if ((source = lw_dictinst_get_source_uri (di, group_index, 0)) != NULL &&
-          (target = lw_dictinst_get_target_uri (di, group_index, 0)) != NULL
-         )
-      lw_io_copy (source, target, cb, data, error);
-    }
+      sink.splitter = lw_io_splitter_new (_dictinst_write_output, outputs, di->split_tags, 2);
 
-    //Finish
-    return (*error == NULL);
-}
+      source = _dictinst_get_stream_uri (di, 0);
+      lw_io_stream_file (source, di->compression, encoding_name, lw_io_splitter_add_line, sink.splitter, cb, data, &local_error);
+      if (!lw_io_splitter_finish (sink.splitter) && local_error == NULL)
+      {
+        domain = g_quark_from_string (LW_DICTINST_ERROR);
+        message = gettext("Unable to write to the file %s.");
+        local_error = g_error_new (domain, LW_DICTINST_ERROR_TARGET_PATH, message, temp_uris[0]);
+      }
+      g_free (source);
+    }
 
+    //No postprocessing required
+    else if (local_error == NULL)
+    {
+      source = _dictinst_get_stream_uri (di, 0);
+      lw_io_stream_file (source, di->compression, encoding_name, _dictinst_write_output, &sink.output[0], cb, data, &local_error);
+      g_free (source);
+    }
 
-//!
-//! @brief does the required postprocessing on a dictionary
-//!        This function should normally only be used in the lw_dictinst_install function.
-//! @param di The LwDictInst object to use for finalizing the dictionary with.
-//! @param cb A LwIoProgressCallback used to giver user feedback on how far the finalization is.
-//! @param data A gpointer to data to pass to the LwIoProgressCallback.
-//! @param error A pointer to a GError object to pass errors to or NULL.
-//! @see lw_dictinst_download
-//! @see lw_dictinst_convert_encoding
-//! @see lw_dictinst_postprocess
-//! @see lw_dictinst_install
-//!
-gboolean 
-lw_dictinst_finalize (LwDictInst *di, LwIoProgressCallback cb, gpointer data, GError **error)
-{
-    //Sanity check
-    if (error != NULL && *error != NULL) return FALSE;
-    if (_cancel) return FALSE;
-    g_assert (di != NULL);
+    for (i = 0; i < 2; i++)
+    {
+      if (sink.output[i].file != NULL && fclose (sink.output[i].file) != 0 && local_error == NULL)
+      {
+        domain = g_quark_from_string (LW_DICTINST_ERROR);
+        message = gettext("Unable to write to the file %s.");
+        local_error = g_error_new (domain, LW_DICTINST_ERROR_TARGET_PATH, message, temp_uris[i]);
+      }
+    }
 
-    //Declarations
-    char *source;
-    char *target;
-    LwDictInstUri group_index;
-    int i;
+    //Move the finished files into place
+    for (i = 0; i < total && local_error == NULL && !_cancel; i++)
+    {
+      g_remove (final_uris[i]);
+      if (g_rename (temp_uris[i], final_uris[i]) != 0)
+      {
+        lw_io_copy (temp_uris[i], final_uris[i], NULL, NULL, &local_error);
+        g_remove (temp_uris[i]);
 
-    //Initializations
-    group_index = LW_DICTINST_NEEDS_FINALIZATION;
-    i = 0;
+        //A partial copy isn't installed, so it isn't recorded or indexed either
+        if (local_error != NULL)
+        {
+          g_remove (final_uris[i]);
+          break;
+        }
+      }
+      filename = g_path_get_basename (final_uris[i]);
+      lw_dictmanifest_record (di->type, filename, &sink.output[i].tally, NULL);
+      if (sink.output[i].terms != NULL)
+      {
+        _dictinst_index_line (&sink.output[i]);
+        lw_termindex_builder_write (sink.output[i].terms, di->type, filename, NULL);
+        lw_headwordtrie_builder_write (sink.output[i].trie, di->type, filename, NULL);
+      }
+      g_free (filename);
+    }
 
-    while ((source = lw_dictinst_get_source_uri (di, group_index, i)) != NULL &&
-           (target = lw_dictinst_get_target_uri (di, group_index, i)) != NULL
-          )
+    //Cleanup
+    if (sink.splitter != NULL) lw_io_splitter_free (sink.splitter);
+    if (sink.mix != NULL) lw_io_mixdata_free (sink.mix);
+    for (i = 0; i < 2; i++)
     {
-      lw_io_copy (source, target, cb, data, error);
-      i++;
+      lw_dictmanifest_tally_deinit (&sink.output[i].tally);
+      if (sink.output[i].terms != NULL) lw_termindex_builder_free (sink.output[i].terms);
+      if (sink.output[i].trie != NULL) lw_headwordtrie_builder_free (sink.output[i].trie);
+      if (sink.output[i].line != NULL) g_string_free (sink.output[i].line, TRUE);
     }
+    g_strfreev (temp_uris);
+    g_strfreev (final_uris);
 
-    //Finish
-    return (*error == NULL);
+    if (local_error == NULL) return !_cancel;
+
+    g_propagate_error (error, local_error);
+
+    return FALSE;
 }
 
 
@@ -811,9 +892,9 @@ lw_dictinst_clean (LwDictInst *di, LwIoProgressCallback cb, gpointer data)
     char *source;
 
     //Initializations
-    group_index = 0;
+    group_index = LW_DICTINST_NEEDS_DECOMPRESSION;
 
-    //Loop through all of the uris except the final destination
+    //Loop through all of the cache uris except the final destination
     while (group_index < LW_DICTINST_NEEDS_NOTHING)
     {
       i = 0;
@@ -842,8 +923,7 @@ lw_dictinst_clean (LwDictInst *di, LwIoProgressCallback cb, gpointer data)
 //! @param data A gpointer to data to pass to the LwIoProgressCallback.
 //! @param error A pointer to a GError object to pass errors to or NULL.
 //! @see lw_dictinst_download
-//! @see lw_dictinst_convert_encoding
-//! @see lw_dictinst_postprocess
+//! @see lw_dictinst_process
 //! @see lw_dictinst_install
 //!
 gboolean 
@@ -852,10 +932,7 @@ lw_dictinst_install (LwDictInst *di, LwIoProgressCallback cb, gpointer data, GEr
     g_assert (*error == NULL && di != NULL);
 
     lw_dictinst_download (di, cb, data, error);
-    lw_dictinst_decompress (di, cb, data, error);
-    lw_dictinst_convert_encoding (di, cb, data, error);
-    lw_dictinst_postprocess (di, cb, data, error);
-    lw_dictinst_finalize (di, cb, data, error);
+    lw_dictinst_process (di, cb, data, error);
     lw_dictinst_clean (di, cb, data);
 
     return (*error == NULL);
@@ -963,47 +1040,43 @@ lw_dictinst_get_total_progress (LwDictInst *di, double fraction)
 {
     //Declarations
     double output_fraction, current, final;
-    int i;
+    double downloads, streams;
     char *ptr;
 
     //Definitions
     output_fraction = 0.0;
     current = 0.0;
     final = 0.0;
+    downloads = 0.0;
+    streams = 0.0;
     di->progress = fraction;
     const double DOWNLOAD_WEIGHT = 3.0;
 
-    //Calculate the already completed activities
-    for (i = 0; i < di->uri_group_index && i < LW_DICTINST_NEEDS_NOTHING; i++)
+    //Everything after the download is done in one streaming pass per source file
+    for (ptr = di->uri[LW_DICTINST_NEEDS_DOWNLOADING]; ptr != NULL; ptr = strchr(ptr, ';'))
     {
-      for (ptr = di->uri[i]; ptr != NULL; ptr = strchr(ptr, ';'))
-      {
-        if (i == LW_DICTINST_NEEDS_DOWNLOADING)
-          current += 1.0 * DOWNLOAD_WEIGHT;
-        else
-          current += 1.0;
-        ptr++;
-      }
+      downloads += 1.0;
+      ptr++;
     }
-    //Add the current in progress activity
-    if (i == LW_DICTINST_NEEDS_DOWNLOADING)
-      current += (fraction + (double) di->uri_atom_index) * DOWNLOAD_WEIGHT;
-    else
-      current += fraction + (double) di->uri_atom_index;
-
-    //Calculate the amount needed for the whole process to finish
-    for (i = 0; i < LW_DICTINST_NEEDS_NOTHING; i++)
+    for (ptr = di->uri[LW_DICTINST_NEEDS_DECOMPRESSION]; ptr != NULL; ptr = strchr(ptr, ';'))
     {
-      for (ptr = di->uri[i]; ptr != NULL; ptr = strchr(ptr, ';'))
-      {
-        if (i == LW_DICTINST_NEEDS_DOWNLOADING)
-          final += 1.0 * DOWNLOAD_WEIGHT;
-        else
-          final += 1.0;
-        ptr++;
-      }
+      streams += 1.0;
+      ptr++;
     }
 
+    //Calculate the amount needed for the whole process to finish
+    final = downloads * DOWNLOAD_WEIGHT + streams;
+
+    //Add the current in progress activity
+    if (di->uri_group_index < LW_DICTINST_NEEDS_DOWNLOADING)
+      current = 0.0;
+    else if (di->uri_group_index == LW_DICTINST_NEEDS_DOWNLOADING)
+      current = (fraction + (double) di->uri_atom_index) * DOWNLOAD_WEIGHT;
+    else if (di->uri_group_index < LW_DICTINST_NEEDS_FINALIZATION)
+      current = downloads * DOWNLOAD_WEIGHT + fraction + (double) di->uri_atom_index;
+    else
+      current = final;
+
     if (final > 0.0)
       output_fraction = current / final;
 
@@ -44,6 +44,7 @@ lw_dictinstlist_new (LwPreferences *pm)
 
   LwDictInst *di;
   LwDictInstList *temp;
+  char split_tags[200];
 
   temp = (LwDictInstList*) malloc(sizeof(LwDictInstList));
 
@@ -101,6 +102,8 @@ lw_dictinstlist_new (LwPreferences *pm)
       FALSE,
       TRUE 
     );
+    lw_preferences_get_string_by_schema (pm, split_tags, LW_SCHEMA_DICTIONARY, LW_KEY_NAMES_PLACES_SPLIT, 200);
+    lw_dictinst_set_split_tags (di, split_tags);
     temp->list = g_list_append (temp->list, di);
 
     di = lw_dictinst_new_using_pref_uri (
@@ -314,3 +317,221 @@ lw_dictinstlist_set_cancel_operations (LwDictInstList *dil, gboolean state)
 }
 
 
+
+//!
+//! @brief Shared state of a lw_dictinstlist_install run
+//!
+struct _LwDictInstListInstall {
+  GThreadPool *download_pool;
+  GThreadPool *process_pool;
+  GMutex *mutex;
+  GList *jobs;
+  LwIoProgressCallback cb;
+  gpointer data;
+  GError *error;
+};
+typedef struct _LwDictInstListInstall LwDictInstListInstall;
+
+//!
+//! @brief A single dictionary moving through the install stages
+//!
+struct _LwDictInstListJob {
+  LwDictInst *di;
+  double progress;
+  LwDictInstListInstall *install;
+};
+typedef struct _LwDictInstListJob LwDictInstListJob;
+
+
+//!
+//! @brief Reports the average progress of all of the jobs.  The install mutex
+//!        should be held when this is called.
+//!
+static int 
+_dictinstlist_report_progress (LwDictInstListInstall *install)
+{
+    //Declarations
+    GList *iter;
+    double total;
+
+    //Initializations
+    total = 0.0;
+
+    if (install->cb == NULL || install->jobs == NULL) return 0;
+
+    for (iter = install->jobs; iter != NULL; iter = iter->next)
+      total += ((LwDictInstListJob*) iter->data)->progress;
+
+    return install->cb (total / (double) g_list_length (install->jobs), install->data);
+}
+
+
+static int 
+_dictinstlist_job_progress_cb (double fraction, gpointer data)
+{
+    //Declarations
+    LwDictInstListJob *job;
+    LwDictInstListInstall *install;
+    int resolution;
+
+    //Initializations
+    job = data;
+    install = job->install;
+
+    g_mutex_lock (install->mutex);
+    job->progress = lw_dictinst_get_total_progress (job->di, fraction);
+    resolution = _dictinstlist_report_progress (install);
+    g_mutex_unlock (install->mutex);
+
+    return resolution;
+}
+
+
+//!
+//! @brief Marks a job as done and keeps the first error for the caller
+//!
+static void 
+_dictinstlist_job_finish (LwDictInstListJob *job, GError *error)
+{
+    LwDictInstListInstall *install;
+
+    install = job->install;
+
+    lw_dictinst_clean (job->di, NULL, NULL);
+
+    g_mutex_lock (install->mutex);
+    if (error != NULL && install->error == NULL)
+      install->error = error;
+    else if (error != NULL)
+      g_error_free (error);
+    job->progress = 1.0;
+    _dictinstlist_report_progress (install);
+    g_mutex_unlock (install->mutex);
+}
+
+
+static void 
+_dictinstlist_download_func (gpointer data, gpointer user_data)
+{
+    //Declarations
+    LwDictInstListJob *job;
+    LwDictInstListInstall *install;
+    GError *error;
+    gboolean skip;
+
+    //Initializations
+    job = data;
+    install = user_data;
+    error = NULL;
+
+    //Don't start anything new once one of the dictionaries failed
+    g_mutex_lock (install->mutex);
+    skip = (install->error != NULL);
+    g_mutex_unlock (install->mutex);
+
+    if (!skip && lw_dictinst_download (job->di, _dictinstlist_job_progress_cb, job, &error))
+      g_thread_pool_push (install->process_pool, job, NULL);
+    else
+      _dictinstlist_job_finish (job, error);
+}
+
+
+static void 
+_dictinstlist_process_func (gpointer data, gpointer user_data)
+{
+    //Declarations
+    LwDictInstListJob *job;
+    LwDictInstListInstall *install;
+    GError *error;
+    gboolean skip;
+
+    //Initializations
+    job = data;
+    install = user_data;
+    error = NULL;
+
+    g_mutex_lock (install->mutex);
+    skip = (install->error != NULL);
+    g_mutex_unlock (install->mutex);
+
+    if (!skip)
+      lw_dictinst_process (job->di, _dictinstlist_job_progress_cb, job, &error);
+
+    _dictinstlist_job_finish (job, error);
+}
+
+
+//!
+//! @brief Installs all of the selected dictionaries at the same time.  Downloads
+//!        and processing run in separate thread pools so one dictionary can be
+//!        downloading while another is being decompressed and converted.  The
+//!        call blocks until every dictionary is finished or cancelled.
+//! @param dil The LwDictInstList to install the selected dictionaries of
+//! @param MAX_CONCURRENT How many dictionaries may be in one stage at once or 0 for the default
+//! @param cb A LwIoProgressCallback that is given the averaged progress of all of the dictionaries
+//! @param data A gpointer to data to pass to the LwIoProgressCallback
+//! @param error A pointer to a GError object to pass errors to or NULL
+//! @returns FALSE if an error occurred or the install was cancelled
+//! @see lw_dictinstlist_set_cancel_operations
+//!
+gboolean 
+lw_dictinstlist_install (LwDictInstList *dil, int MAX_CONCURRENT, LwIoProgressCallback cb, gpointer data, GError **error)
+{
+    //Sanity check
+    if (error != NULL && *error != NULL) return FALSE;
+    g_assert (dil != NULL);
+
+    //Declarations
+    LwDictInstListInstall install;
+    LwDictInstListJob *job;
+    LwDictInst *di;
+    GList *iter;
+    int max;
+
+    //Initializations
+    max = (MAX_CONCURRENT > 0) ? MAX_CONCURRENT : LW_DICTINSTLIST_MAX_CONCURRENT;
+    install.mutex = g_mutex_new ();
+    install.jobs = NULL;
+    install.cb = cb;
+    install.data = data;
+    install.error = NULL;
+
+    for (iter = dil->list; iter != NULL; iter = iter->next)
+    {
+      di = LW_DICTINST (iter->data);
+      if (di == NULL || !di->selected) continue;
+      job = g_new0 (LwDictInstListJob, 1);
+      job->di = di;
+      job->install = &install;
+      install.jobs = g_list_append (install.jobs, job);
+    }
+
+    install.download_pool = g_thread_pool_new (_dictinstlist_download_func, &install, max, FALSE, &install.error);
+    install.process_pool = NULL;
+    if (install.download_pool != NULL)
+      install.process_pool = g_thread_pool_new (_dictinstlist_process_func, &install, max, FALSE, &install.error);
+
+    if (install.download_pool != NULL && install.process_pool != NULL)
+    {
+      for (iter = install.jobs; iter != NULL; iter = iter->next)
+        g_thread_pool_push (install.download_pool, iter->data, NULL);
+    }
+
+    //The downloads feed the processing pool so they have to drain first
+    if (install.download_pool != NULL) g_thread_pool_free (install.download_pool, FALSE, TRUE);
+    if (install.process_pool != NULL) g_thread_pool_free (install.process_pool, FALSE, TRUE);
+
+    //Cleanup
+    for (iter = install.jobs; iter != NULL; iter = iter->next)
+      g_free (iter->data);
+    g_list_free (install.jobs);
+    g_mutex_free (install.mutex);
+
+    if (install.error != NULL)
+    {
+      g_propagate_error (error, install.error);
+      return FALSE;
+    }
+
+    return !dil->cancel;
+}
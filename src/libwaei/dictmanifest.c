@@ -0,0 +1,473 @@
+/******************************************************************************
+    AUTHOR:
+    File written and Copyrighted by Zachary Dovel. All Rights Reserved.
+
+    LICENSE:
+    This file is part of gWaei.
+
+    gWaei is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    gWaei is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    
+    You should have received a copy of the GNU General Public License
+    along with gWaei.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+//!
+//!  @file dictmanifest.c
+//!  @brief LwDictManifest objects keep the size, line count, checksum and
+//!         other metadata of the installed dictionaries in a keyfile.  An
+//!         entry is validated with a single stat so the dictionaries
+//!         themselves never have to be read when the program starts.
+//!         The search indexes aren't tracked here because each index file
+//!         carries its own version and is rebuilt when it doesn't match.
+//!
+
+
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include <libwaei/libwaei.h>
+
+G_LOCK_DEFINE_STATIC (_manifest);
+
+
+//!
+//! @brief Creates a new LwDictManifest object and loads the manifest from
+//!        the dictionary folder if there is one
+//! @returns A newly allocated LwDictManifest object that should be freed with lw_dictmanifest_free.
+//!
+LwDictManifest* 
+lw_dictmanifest_new ()
+{
+    LwDictManifest *temp;
+
+    temp = (LwDictManifest*) malloc(sizeof(LwDictManifest));
+
+    if (temp != NULL)
+    {
+      lw_dictmanifest_init (temp);
+    }
+
+    return temp;
+}
+
+
+//!
+//! @brief Releases a LwDictManifest object from memory.  Unsaved changes are lost.
+//! @param manifest A LwDictManifest object created by lw_dictmanifest_new.
+//!
+void 
+lw_dictmanifest_free (LwDictManifest *manifest)
+{
+    lw_dictmanifest_deinit (manifest);
+
+    free (manifest);
+}
+
+
+//!
+//! @brief Used to initialize the memory inside of a new LwDictManifest
+//!        object.  Usually lw_dictmanifest_new calls this for you.
+//! @param manifest The LwDictManifest to initialize
+//!
+void 
+lw_dictmanifest_init (LwDictManifest *manifest)
+{
+    manifest->keyfile = g_key_file_new ();
+    manifest->uri = lw_util_build_filename (LW_PATH_DICTIONARY, LW_DICTMANIFEST_FILENAME);
+    manifest->changed = FALSE;
+
+    g_key_file_load_from_file (manifest->keyfile, manifest->uri, G_KEY_FILE_NONE, NULL);
+}
+
+
+//!
+//! @brief Used to free the memory inside of a LwDictManifest object.
+//!        Usually lw_dictmanifest_free calls this for you.
+//! @param manifest The LwDictManifest object to have it's inner memory freed.
+//!
+void 
+lw_dictmanifest_deinit (LwDictManifest *manifest)
+{
+    g_key_file_free (manifest->keyfile);
+    g_free (manifest->uri);
+}
+
+
+//!
+//! @brief Builds the keyfile group name of a dictionary
+//! @returns An allocated string that should be freed with g_free
+//!
+static gchar* 
+_dictmanifest_get_group (const LwDictType DICTTYPE, const char *FILENAME)
+{
+    return g_strdup_printf ("%s/%s", lw_util_dicttype_to_string (DICTTYPE), FILENAME);
+}
+
+
+//!
+//! @brief Gets the metadata of an installed dictionary.  The entry is checked against
+//!        the size and modification time of the file.  If it doesn't match it is reset
+//!        so only the values that can be known from a stat are set.
+//! @param manifest The LwDictManifest to look in
+//! @param DICTTYPE The type of the dictionary
+//! @param FILENAME The filename of the dictionary
+//! @param entry A LwDictManifestEntry to write the metadata to
+//! @returns TRUE if the recorded entry was still valid
+//!
+gboolean 
+lw_dictmanifest_get_entry (LwDictManifest *manifest, const LwDictType DICTTYPE, const char *FILENAME, LwDictManifestEntry *entry)
+{
+    //Declarations
+    gchar *uri;
+    gchar *group;
+    gchar *string;
+    GStatBuf info;
+    gboolean valid;
+
+    //Initializations
+    uri = lw_util_build_filename_by_dicttype (DICTTYPE, FILENAME);
+    group = _dictmanifest_get_group (DICTTYPE, FILENAME);
+    valid = FALSE;
+
+    memset(entry, 0, sizeof(LwDictManifestEntry));
+    entry->lines = -1;
+
+    if (uri != NULL && g_stat (uri, &info) == 0)
+    {
+      entry->size = info.st_size;
+      entry->mtime = info.st_mtime;
+
+      valid = (g_key_file_has_group (manifest->keyfile, group) &&
+               g_key_file_get_int64 (manifest->keyfile, group, "size", NULL) == entry->size &&
+               g_key_file_get_int64 (manifest->keyfile, group, "mtime", NULL) == entry->mtime);
+
+      if (valid)
+      {
+        entry->lines = g_key_file_get_int64 (manifest->keyfile, group, "lines", NULL);
+        if ((string = g_key_file_get_string (manifest->keyfile, group, "encoding", NULL)) != NULL)
+        {
+          g_strlcpy (entry->encoding, string, sizeof(entry->encoding));
+          g_free (string);
+        }
+        if ((string = g_key_file_get_string (manifest->keyfile, group, "checksum", NULL)) != NULL)
+        {
+          g_strlcpy (entry->checksum, string, sizeof(entry->checksum));
+          g_free (string);
+        }
+      }
+      else
+      {
+        //The file changed behind our back so forget what we knew about it
+        g_key_file_remove_group (manifest->keyfile, group, NULL);
+        g_key_file_set_int64 (manifest->keyfile, group, "size", entry->size);
+        g_key_file_set_int64 (manifest->keyfile, group, "mtime", entry->mtime);
+        g_key_file_set_int64 (manifest->keyfile, group, "lines", entry->lines);
+        manifest->changed = TRUE;
+      }
+    }
+
+    //Cleanup
+    g_free (uri);
+    g_free (group);
+
+    return valid;
+}
+
+
+//!
+//! @brief Prepares a LwDictManifestTally to count the text of a dictionary
+//! @param tally The LwDictManifestTally to initialize
+//!
+void 
+lw_dictmanifest_tally_init (LwDictManifestTally *tally)
+{
+    tally->lines = 0;
+    tally->partial = FALSE;
+    tally->checksum = g_checksum_new (G_CHECKSUM_SHA256);
+}
+
+
+//!
+//! @brief Frees the memory inside of a LwDictManifestTally
+//! @param tally The LwDictManifestTally to deinitialize
+//!
+void 
+lw_dictmanifest_tally_deinit (LwDictManifestTally *tally)
+{
+    g_checksum_free (tally->checksum);
+    tally->checksum = NULL;
+}
+
+
+//!
+//! @brief A LwIoWriteFunc that counts and checksums the text of a dictionary as
+//!        it is written, so installing it doesn't need another pass over the file.
+//!        It can be used as a LwIoLineFunc too.
+//! @param TEXT Text written to the dictionary in file order
+//! @param LENGTH The length of the text in bytes
+//! @param data A LwDictManifestTally
+//! @returns Always TRUE
+//!
+gboolean 
+lw_dictmanifest_tally_text (const gchar *TEXT, gsize LENGTH, gpointer data)
+{
+    //Declarations
+    LwDictManifestTally *tally;
+    const gchar *ptr;
+    const gchar *end;
+
+    //Initializations
+    tally = data;
+    end = TEXT + LENGTH;
+
+    if (LENGTH == 0) return TRUE;
+
+    for (ptr = TEXT; (ptr = memchr (ptr, '\n', end - ptr)) != NULL; ptr++)
+      tally->lines++;
+    tally->partial = (end[-1] != '\n');
+    g_checksum_update (tally->checksum, (const guchar*) TEXT, LENGTH);
+
+    return TRUE;
+}
+
+
+//!
+//! @brief Writes a complete entry to the manifest
+//!
+static void 
+_dictmanifest_set_entry (LwDictManifest *manifest, const gchar *GROUP, GStatBuf *info, LwDictManifestTally *tally)
+{
+    g_key_file_remove_group (manifest->keyfile, GROUP, NULL);
+    g_key_file_set_int64 (manifest->keyfile, GROUP, "size", info->st_size);
+    g_key_file_set_int64 (manifest->keyfile, GROUP, "mtime", info->st_mtime);
+    g_key_file_set_int64 (manifest->keyfile, GROUP, "lines", tally->lines + ((tally->partial) ? 1 : 0));
+    g_key_file_set_string (manifest->keyfile, GROUP, "encoding", "UTF-8");
+    g_key_file_set_string (manifest->keyfile, GROUP, "checksum", g_checksum_get_string (tally->checksum));
+    manifest->changed = TRUE;
+}
+
+
+//!
+//! @brief Reads an installed dictionary once and records all of its metadata.
+//! @param manifest The LwDictManifest to record to
+//! @param DICTTYPE The type of the dictionary
+//! @param FILENAME The filename of the dictionary
+//! @param error A pointer to a GError object to pass errors to or NULL.
+//! @returns FALSE if the dictionary couldn't be read
+//!
+gboolean 
+lw_dictmanifest_update_entry (LwDictManifest *manifest, const LwDictType DICTTYPE, const char *FILENAME, GError **error)
+{
+    //Sanity check
+    if (error != NULL && *error != NULL) return FALSE;
+
+    //Declarations
+    gchar *uri;
+    gchar *group;
+    GStatBuf info;
+    LwDictManifestTally tally;
+    gboolean read;
+
+    //Initializations
+    uri = lw_util_build_filename_by_dicttype (DICTTYPE, FILENAME);
+    group = _dictmanifest_get_group (DICTTYPE, FILENAME);
+    lw_dictmanifest_tally_init (&tally);
+
+    read = (g_stat (uri, &info) == 0 && 
+            lw_io_stream_file (uri, LW_COMPRESSION_NONE, NULL, lw_dictmanifest_tally_text, &tally, NULL, NULL, error));
+    if (read) _dictmanifest_set_entry (manifest, group, &info, &tally);
+
+    //Cleanup
+    lw_dictmanifest_tally_deinit (&tally);
+    g_free (uri);
+    g_free (group);
+
+    return read;
+}
+
+
+//!
+//! @brief Removes the metadata of a dictionary from the manifest
+//! @param manifest The LwDictManifest to remove from
+//! @param DICTTYPE The type of the dictionary
+//! @param FILENAME The filename of the dictionary
+//!
+void 
+lw_dictmanifest_remove_entry (LwDictManifest *manifest, const LwDictType DICTTYPE, const char *FILENAME)
+{
+    //Declarations
+    gchar *group;
+
+    //Initializations
+    group = _dictmanifest_get_group (DICTTYPE, FILENAME);
+
+    if (g_key_file_remove_group (manifest->keyfile, group, NULL))
+      manifest->changed = TRUE;
+
+    //Cleanup
+    g_free (group);
+}
+
+
+//!
+//! @brief Writes the manifest file.  The caller should hold the manifest lock.
+//!
+static gboolean 
+_dictmanifest_write (LwDictManifest *manifest, GError **error)
+{
+    //Declarations
+    gchar *data;
+    gsize length;
+
+    //Initializations
+    data = g_key_file_to_data (manifest->keyfile, &length, NULL);
+
+    if (g_file_set_contents (manifest->uri, data, length, error))
+      manifest->changed = FALSE;
+
+    //Cleanup
+    g_free (data);
+
+    return (!manifest->changed);
+}
+
+
+//!
+//! @brief Writes the manifest to the dictionary folder if it was changed
+//! @param manifest The LwDictManifest to save
+//! @param error A pointer to a GError object to pass errors to or NULL.
+//!
+gboolean 
+lw_dictmanifest_save (LwDictManifest *manifest, GError **error)
+{
+    //Sanity check
+    if (error != NULL && *error != NULL) return FALSE;
+    if (!manifest->changed) return TRUE;
+
+    //Declarations
+    gboolean saved;
+
+    G_LOCK (_manifest);
+    saved = _dictmanifest_write (manifest, error);
+    G_UNLOCK (_manifest);
+
+    return saved;
+}
+
+
+//!
+//! @brief Records the metadata of a newly installed dictionary in the manifest file.
+//!        It is safe to call from multiple installer threads.
+//! @param DICTTYPE The type of the dictionary
+//! @param FILENAME The filename of the dictionary
+//! @param tally The LwDictManifestTally the text of the dictionary was passed to as it was written
+//! @param error A pointer to a GError object to pass errors to or NULL.
+//!
+gboolean 
+lw_dictmanifest_record (const LwDictType DICTTYPE, const char *FILENAME, LwDictManifestTally *tally, GError **error)
+{
+    //Sanity check
+    if (error != NULL && *error != NULL) return FALSE;
+
+    //Declarations
+    LwDictManifest *manifest;
+    gchar *uri;
+    gchar *group;
+    GStatBuf info;
+    gboolean saved;
+
+    //Initializations
+    uri = lw_util_build_filename_by_dicttype (DICTTYPE, FILENAME);
+    group = _dictmanifest_get_group (DICTTYPE, FILENAME);
+    saved = FALSE;
+
+    if (g_stat (uri, &info) == 0)
+    {
+      G_LOCK (_manifest);
+      manifest = lw_dictmanifest_new ();
+      _dictmanifest_set_entry (manifest, group, &info, tally);
+      saved = _dictmanifest_write (manifest, error);
+      lw_dictmanifest_free (manifest);
+      G_UNLOCK (_manifest);
+    }
+
+    //Cleanup
+    g_free (uri);
+    g_free (group);
+
+    return saved;
+}
+
+
+//!
+//! @brief Removes the metadata of an uninstalled dictionary from the manifest file
+//! @param DICTTYPE The type of the dictionary
+//! @param FILENAME The filename of the dictionary
+//! @param error A pointer to a GError object to pass errors to or NULL.
+//!
+gboolean 
+lw_dictmanifest_forget (const LwDictType DICTTYPE, const char *FILENAME, GError **error)
+{
+    //Sanity check
+    if (error != NULL && *error != NULL) return FALSE;
+
+    //Declarations
+    LwDictManifest *manifest;
+    gboolean saved;
+
+    G_LOCK (_manifest);
+    manifest = lw_dictmanifest_new ();
+    lw_dictmanifest_remove_entry (manifest, DICTTYPE, FILENAME);
+    saved = (!manifest->changed || _dictmanifest_write (manifest, error));
+    lw_dictmanifest_free (manifest);
+    G_UNLOCK (_manifest);
+
+    return saved;
+}
+
+
+//!
+//! @brief Checks the manifest entries of the installed dictionaries against their
+//!        files and resets the ones that went stale.  The manifest file is read
+//!        and written under the same lock as lw_dictmanifest_record.
+//! @param list A GList of the LwDictInfo of the installed dictionaries
+//! @param error A pointer to a GError object to pass errors to or NULL.
+//!
+gboolean 
+lw_dictmanifest_refresh (GList *list, GError **error)
+{
+    //Sanity check
+    if (error != NULL && *error != NULL) return FALSE;
+
+    //Declarations
+    LwDictManifest *manifest;
+    LwDictManifestEntry entry;
+    LwDictInfo *di;
+    GList *link;
+    gboolean saved;
+
+    G_LOCK (_manifest);
+    manifest = lw_dictmanifest_new ();
+    for (link = list; link != NULL; link = link->next)
+    {
+      di = LW_DICTINFO (link->data);
+      if (di != NULL) lw_dictmanifest_get_entry (manifest, di->type, di->filename, &entry);
+    }
+    saved = (!manifest->changed || _dictmanifest_write (manifest, error));
+    lw_dictmanifest_free (manifest);
+    G_UNLOCK (_manifest);
+
+    return saved;
+}
@@ -54,6 +54,17 @@ static int _get_relevance (LwSearchItem *item) {
 }
 
 
+//!
+//! @brief Counts an accepted result and notes when the first one arrived
+//!
+static void _record_accepted (LwSearchItem *item)
+{
+    if (item->stats.results_accepted == 0)
+      item->stats.first_result_time = g_timer_elapsed (item->timer, NULL);
+    item->stats.results_accepted++;
+}
+
+
 //!
 //! @brief Preforms the brute work of the search
 //!
@@ -70,6 +81,8 @@ static gpointer _stream_results_thread (gpointer data)
     LwEngineData *enginedata;
     LwSearchItem *item;
     gboolean show_only_exact_matches;
+    long progress_step;
+    long progress_next;
 
     //Initializations
     enginedata = LW_ENGINEDATA (data);
@@ -77,6 +90,8 @@ static gpointer _stream_results_thread (gpointer data)
     show_only_exact_matches = enginedata->exact;
 
     if (item == NULL || item->fd == NULL) return NULL;
+    progress_step = item->dictionary->length / LW_ENGINE_PROGRESS_STEPS + 1;
+    progress_next = progress_step;
     char *line_pointer = NULL;
 
     lw_searchitem_lock_mutex (item);
@@ -96,16 +111,28 @@ static gpointer _stream_results_thread (gpointer data)
       lw_searchitem_lock_mutex (item);
 
       item->current += strlen(item->resultline->string);
+      item->stats.lines_scanned++;
+      item->stats.bytes_read += strlen(item->resultline->string);
+
+      //Let the watches update their progress displays now and then
+      if (item->current >= progress_next)
+      {
+        lw_searchitem_notify_sources (item);
+        progress_next = item->current + progress_step;
+      }
 
       //Commented input in the dictionary...we should skip over it
       if(item->resultline->string[0] == '#' || g_utf8_get_char(item->resultline->string) == L'？') 
       {
+        item->stats.comment_lines_skipped++;
         continue;
       }
       else if (item->resultline->string[0] == 'A' && item->resultline->string[1] == ':' &&
                fgets(item->scratch_buffer, LW_IO_MAX_FGETS_LINE, item->fd) != NULL             )
       {
         item->current += strlen(item->scratch_buffer);
+        item->stats.lines_scanned++;
+        item->stats.bytes_read += strlen(item->scratch_buffer);
         char *eraser = NULL;
         if ((eraser = g_utf8_strchr (item->resultline->string, -1, L'\n')) != NULL) { *eraser = '\0'; }
         if ((eraser = g_utf8_strchr (item->scratch_buffer, -1, L'\n')) != NULL) { *eraser = '\0'; }
@@ -128,8 +155,14 @@ static gpointer _stream_results_thread (gpointer data)
                 item->total_results++;
                 item->total_relevant_results++;
                 item->resultline->relevance = LW_RESULTLINE_RELEVANCE_HIGH;
+                _record_accepted (item);
                 item->results_high =  g_list_append (item->results_high, item->resultline);
                 item->resultline = lw_resultline_new ();
+                lw_searchitem_notify_sources (item);
+              }
+              else
+              {
+                item->stats.results_dropped++;
               }
               break;
           if (!show_only_exact_matches)
@@ -140,9 +173,14 @@ static gpointer _stream_results_thread (gpointer data)
                 item->total_results++;
                 item->total_irrelevant_results++;
                 item->resultline->relevance = LW_RESULTLINE_RELEVANCE_MEDIUM;
+                _record_accepted (item);
                 item->results_medium =  g_list_append (item->results_medium, item->resultline);
                 item->resultline = lw_resultline_new ();
               }
+              else
+              {
+                item->stats.results_dropped++;
+              }
               break;
           default:
               if (item->total_irrelevant_results < LW_MAX_LOW_IRRELEVENT_RESULTS)
@@ -150,20 +188,392 @@ static gpointer _stream_results_thread (gpointer data)
                 item->total_results++;
                 item->total_irrelevant_results++;
                 item->resultline->relevance = LW_RESULTLINE_RELEVANCE_LOW;
+                _record_accepted (item);
                 item->results_low = g_list_append (item->results_low, item->resultline);
                 item->resultline = lw_resultline_new ();
               }
+              else
+              {
+                item->stats.results_dropped++;
+              }
               break;
           }
         }
       }
     }
 
+    lw_searchitem_stats_end (item);
+    lw_searchitem_cleanup_search (item);
+    lw_enginedata_free (enginedata);
+    lw_searchitem_notify_sources (item);
+
+    lw_searchitem_unlock_mutex (item);
+
+    return NULL;
+}
+
+
+//!
+//! @brief A dictionary line found through the term index by a fuzzy search
+//!
+struct _LwEngineFuzzyHit {
+    guint32 offset;             //!< Byte offset of the line in the dictionary
+    gint distance;              //!< Edit distance of the closest term the line is listed under
+    const gchar *term;          //!< That term
+    gint relevance;             //!< The LwRelevance tier of the term in the line
+    LwResultLine *resultline;   //!< The parsed line once it is read
+};
+typedef struct _LwEngineFuzzyHit LwEngineFuzzyHit;
+
+
+static gint 
+_compare_fuzzy_distance (gconstpointer a, gconstpointer b)
+{
+    const LwEngineFuzzyHit *ha = a;
+    const LwEngineFuzzyHit *hb = b;
+
+    if (ha->distance != hb->distance) return ha->distance - hb->distance;
+    if (ha->offset != hb->offset) return (ha->offset < hb->offset) ? -1 : 1;
+    return 0;
+}
+
+
+//!
+//! @brief Orders fuzzy hits by edit distance, then by relevance tier, then by their place in the dictionary
+//!
+static gint 
+_compare_fuzzy_hits (gconstpointer a, gconstpointer b)
+{
+    const LwEngineFuzzyHit *ha = a;
+    const LwEngineFuzzyHit *hb = b;
+
+    if (ha->distance != hb->distance) return ha->distance - hb->distance;
+    if (ha->relevance != hb->relevance) return ha->relevance - hb->relevance;
+    if (ha->offset != hb->offset) return (ha->offset < hb->offset) ? -1 : 1;
+    return 0;
+}
+
+
+static void 
+_free_fuzzy_regexes (gpointer data)
+{
+    //Declarations
+    GRegex **re;
+    gint i;
+
+    //Initializations
+    re = data;
+
+    for (i = 0; i < LW_RELEVANCE_TOTAL; i++)
+      if (re[i] != NULL) g_regex_unref (re[i]);
+    g_free (re);
+}
+
+
+//!
+//! @brief Compiles the usual relevance regexes of a matched term.  Readings are
+//!        stored in hiragana in the term index, so they match katakana too.
+//!
+static GRegex** 
+_get_fuzzy_regexes (GHashTable *cache, const gchar *TERM)
+{
+    //Declarations
+    GRegex **re;
+    gchar *katakana;
+    gchar *expression;
+    gint i;
+
+    //Initializations
+    re = g_hash_table_lookup (cache, TERM);
+    if (re != NULL) return re;
+
+    re = g_new0 (GRegex*, LW_RELEVANCE_TOTAL);
+
+    if (lw_util_is_furigana_str (TERM))
+    {
+      katakana = g_strdup (TERM);
+      lw_util_str_shift_hira_to_kata (katakana);
+      expression = g_strdup_printf ("(%s)|(%s)", TERM, katakana);
+      for (i = 0; i < LW_RELEVANCE_TOTAL; i++)
+        re[i] = lw_regex_furi_new (expression, LW_DICTTYPE_EDICT, i, NULL);
+      g_free (expression);
+      g_free (katakana);
+    }
+    else
+    {
+      for (i = 0; i < LW_RELEVANCE_TOTAL; i++)
+        re[i] = lw_regex_romaji_new (TERM, LW_DICTTYPE_EDICT, i, NULL);
+    }
+
+    g_hash_table_insert (cache, (gpointer) TERM, re);
+
+    return re;
+}
+
+
+//!
+//! @brief Runs the relevance regex of a tier over the fields a term could be in
+//! @param FIELD LW_RESULTLINE_FIELD_FURIGANA for readings or LW_RESULTLINE_FIELD_DEFINITION for gloss words
+//! @param locate Whether to record the match spans instead of stopping at the first match
+//!
+static gboolean 
+_match_fuzzy_fields (LwSearchItem *item, GRegex *re, LwResultLineField FIELD, LwRelevance RELEVANCE, gboolean locate)
+{
+    //Declarations
+    LwResultLine *rl;
+    LwResultLineField fields[2];
+    GMatchInfo *match_info;
+    const char *text;
+    gboolean found;
+    int start, end;
+    int total;
+    int i, j;
+
+    //Initializations
+    rl = item->resultline;
+    found = FALSE;
+    if (re == NULL) return FALSE;
+
+    if (FIELD == LW_RESULTLINE_FIELD_FURIGANA)
+    {
+      //A kana headword has no reading field of its own
+      fields[0] = LW_RESULTLINE_FIELD_FURIGANA;
+      fields[1] = LW_RESULTLINE_FIELD_KANJI;
+      total = 2;
+    }
+    else
+    {
+      fields[0] = LW_RESULTLINE_FIELD_DEFINITION;
+      total = 1;
+    }
+
+    for (i = 0; i < total && (locate || !found); i++)
+    {
+      for (j = 0; (text = lw_resultline_get_field (rl, fields[i], j)) != NULL && (locate || !found); j++)
+      {
+        item->stats.regex_evaluations[RELEVANCE]++;
+        item->stats.field_evaluations[(FIELD == LW_RESULTLINE_FIELD_FURIGANA) ? LW_SEARCHFIELD_FURIGANA : LW_SEARCHFIELD_ROMAJI]++;
+
+        if (g_regex_match (re, text, 0, &match_info))
+        {
+          found = TRUE;
+          while (locate && g_match_info_matches (match_info))
+          {
+            g_match_info_fetch_pos (match_info, 0, &start, &end);
+            lw_resultline_add_match (rl, fields[i], j, start, end);
+            g_match_info_next (match_info, NULL);
+          }
+        }
+        g_match_info_free (match_info);
+
+        if (fields[i] != LW_RESULTLINE_FIELD_DEFINITION) break;
+      }
+    }
+
+    return found;
+}
+
+
+//!
+//! @brief Finds the relevance tier of the matched term in the current resultline
+//!        and records where it is for the output
+//!
+static int 
+_get_fuzzy_relevance (LwSearchItem *item, GRegex **re, const gchar *TERM)
+{
+    //Declarations
+    LwResultLineField field;
+    int relevance;
+
+    //Initializations
+    field = (lw_util_is_furigana_str (TERM)) ? LW_RESULTLINE_FIELD_FURIGANA : LW_RESULTLINE_FIELD_DEFINITION;
+
+    for (relevance = LW_RELEVANCE_HIGH; relevance < LW_RELEVANCE_LOW; relevance++)
+      if (_match_fuzzy_fields (item, re[relevance], field, relevance, FALSE)) break;
+
+    lw_resultline_clear_matches (item->resultline);
+    _match_fuzzy_fields (item, re[LW_RELEVANCE_LOCATE], field, LW_RELEVANCE_LOCATE, TRUE);
+
+    return relevance;
+}
+
+
+//!
+//! @brief Looks the fuzzy terms of the query up in the term index of the dictionary
+//!
+//! THIS IS A PRIVATE FUNCTION.  Only the lines listed under the terms that a
+//! Levenshtein automaton of a query term accepts are read.  The results are
+//! ordered by the edit distance of their closest term first and by the usual
+//! relevance tier second, so they are all put in the high relevance list in
+//! that order and keep their real tier in the resultline.
+//!
+//! @param data A LwEngineData with the LwSearchItem to search with
+//!
+static gpointer _fuzzy_results_thread (gpointer data)
+{
+    //Declarations
+    LwEngineData *enginedata;
+    LwSearchItem *item;
+    LwQueryLine *ql;
+    LwTermIndex *index;
+    LwLevenshtein *automaton;
+    GArray *matches;
+    GArray *hits;
+    GHashTable *lines;
+    GHashTable *regexes;
+    LwTermIndexMatch *match;
+    LwEngineFuzzyHit *hit;
+    LwEngineFuzzyHit temp;
+    const guint32 *postings;
+    guint32 total_postings;
+    gpointer position;
+    gboolean show_only_exact_matches;
+    char **iter;
+    guint total_read;
+    guint i, j;
+
+    //Initializations
+    enginedata = LW_ENGINEDATA (data);
+    item = LW_SEARCHITEM (enginedata->item);
+    show_only_exact_matches = enginedata->exact;
+
+    if (item == NULL || item->fd == NULL) return NULL;
+    ql = item->queryline;
+    hits = g_array_new (FALSE, FALSE, sizeof(LwEngineFuzzyHit));
+    matches = g_array_new (FALSE, FALSE, sizeof(LwTermIndexMatch));
+    lines = g_hash_table_new (g_direct_hash, g_direct_equal);
+    regexes = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, _free_fuzzy_regexes);
+    total_read = 0;
+
+    lw_searchitem_lock_mutex (item);
+    item->status = LW_SEARCHSTATUS_SEARCHING;
+    lw_searchitem_unlock_mutex (item);
+
+    //A missing index is made here, which reads the whole dictionary, so the lock isn't held
+    index = lw_termindex_new (item->dictionary->type, item->dictionary->filename, NULL);
+
+    lw_searchitem_lock_mutex (item);
+
+    //Collect the lines of every matching term with the distance of the closest one
+    for (iter = ql->fuzzy; index != NULL && *iter != NULL && item->status != LW_SEARCHSTATUS_CANCELING; iter++)
+    {
+      automaton = lw_levenshtein_new (*iter, lw_queryline_get_fuzzy_distance (ql, *iter));
+      g_array_set_size (matches, 0);
+      lw_termindex_find_fuzzy (index, automaton, matches);
+      item->stats.terms_matched += matches->len;
+
+      for (i = 0; i < matches->len; i++)
+      {
+        match = &g_array_index (matches, LwTermIndexMatch, i);
+        postings = lw_termindex_get_postings (index, match->term, &total_postings);
+
+        for (j = 0; j < total_postings; j++)
+        {
+          position = g_hash_table_lookup (lines, GUINT_TO_POINTER (postings[j] + 1));
+          if (position == NULL)
+          {
+            temp.offset = postings[j];
+            temp.distance = match->distance;
+            temp.term = lw_termindex_get_term (index, match->term);
+            temp.relevance = LW_RELEVANCE_LOW;
+            temp.resultline = NULL;
+            g_array_append_val (hits, temp);
+            g_hash_table_insert (lines, GUINT_TO_POINTER (postings[j] + 1), GUINT_TO_POINTER (hits->len));
+          }
+          else
+          {
+            hit = &g_array_index (hits, LwEngineFuzzyHit, GPOINTER_TO_UINT (position) - 1);
+            if (match->distance < hit->distance)
+            {
+              hit->distance = match->distance;
+              hit->term = lw_termindex_get_term (index, match->term);
+            }
+          }
+        }
+      }
+
+      lw_levenshtein_free (automaton);
+    }
+
+    //Read the closest lines first so the result cap drops the farthest ones
+    g_array_sort (hits, _compare_fuzzy_distance);
+
+    for (i = 0; i < hits->len && total_read < LW_MAX_HIGH_RELEVENT_RESULTS && item->status != LW_SEARCHSTATUS_CANCELING; i++)
+    {
+      //Give a chance for something else to run
+      lw_searchitem_unlock_mutex (item);
+      if (g_main_context_pending (NULL))
+      {
+        g_main_context_iteration (NULL, FALSE);
+      }
+      lw_searchitem_lock_mutex (item);
+
+      hit = &g_array_index (hits, LwEngineFuzzyHit, i);
+      if (fseek (item->fd, hit->offset, SEEK_SET) != 0 || 
+          fgets (item->resultline->string, LW_IO_MAX_FGETS_LINE, item->fd) == NULL) continue;
+
+      item->stats.lines_scanned++;
+      item->stats.bytes_read += strlen(item->resultline->string);
+
+      lw_searchitem_parse_result_string (item);
+      hit->relevance = _get_fuzzy_relevance (item, _get_fuzzy_regexes (regexes, hit->term), hit->term);
+      if (show_only_exact_matches && hit->relevance != LW_RELEVANCE_HIGH) continue;
+
+      hit->resultline = item->resultline;
+      item->resultline = lw_resultline_new ();
+      total_read++;
+    }
+    item->stats.results_dropped += hits->len - i;
+
+    //Hand the results over in order
+    g_array_sort (hits, _compare_fuzzy_hits);
+
+    for (i = 0; i < hits->len; i++)
+    {
+      hit = &g_array_index (hits, LwEngineFuzzyHit, i);
+      if (hit->resultline == NULL) continue;
+
+      if (item->status == LW_SEARCHSTATUS_CANCELING)
+      {
+        lw_resultline_free (hit->resultline);
+        continue;
+      }
+
+      switch (hit->relevance)
+      {
+        case LW_RELEVANCE_HIGH:
+          hit->resultline->relevance = LW_RESULTLINE_RELEVANCE_HIGH;
+          break;
+        case LW_RELEVANCE_MEDIUM:
+          hit->resultline->relevance = LW_RESULTLINE_RELEVANCE_MEDIUM;
+          break;
+        default:
+          hit->resultline->relevance = LW_RESULTLINE_RELEVANCE_LOW;
+          break;
+      }
+
+      if (item->stats.results_accepted == 0)
+        item->stats.first_result_time = g_timer_elapsed (item->timer, NULL);
+      item->stats.results_accepted++;
+      item->total_results++;
+      item->total_relevant_results++;
+      item->results_high = g_list_append (item->results_high, hit->resultline);
+    }
+
+    lw_searchitem_stats_end (item);
     lw_searchitem_cleanup_search (item);
     lw_enginedata_free (enginedata);
+    lw_searchitem_notify_sources (item);
 
     lw_searchitem_unlock_mutex (item);
 
+    //Cleanup
+    g_hash_table_destroy (regexes);
+    g_hash_table_destroy (lines);
+    g_array_free (matches, TRUE);
+    g_array_free (hits, TRUE);
+    if (index != NULL) lw_termindex_free (index);
+
     return NULL;
 }
 
@@ -177,15 +587,17 @@ static gpointer _stream_results_thread (gpointer data)
 void lw_searchitem_start_search (LwSearchItem *item, gboolean create_thread, gboolean exact)
 {
     gpointer data;
+    GThreadFunc func;
 
     data = lw_enginedata_new (item, exact);
+    func = (item->queryline->fuzzy != NULL) ? (GThreadFunc) _fuzzy_results_thread : (GThreadFunc) _stream_results_thread;
 
     if (data != NULL)
     {
       lw_searchitem_prepare_search (item);
       if (create_thread)
       {
-        item->thread = g_thread_create ((GThreadFunc) _stream_results_thread, (gpointer) data, TRUE, NULL);
+        item->thread = g_thread_create (func, (gpointer) data, TRUE, NULL);
         if (item->thread == NULL)
         {
           fprintf(stderr, "Couldn't create the thread");
@@ -194,7 +606,7 @@ void lw_searchitem_start_search (LwSearchItem *item, gboolean create_thread, gbo
       else
       {
         item->thread = NULL;
-        _stream_results_thread ((gpointer) data);
+        func ((gpointer) data);
       }
     }
 }
@@ -219,6 +631,7 @@ void lw_searchitem_cancel_search (LwSearchItem *item)
       {
         item->thread = NULL;
         item->status = LW_SEARCHSTATUS_IDLE;
+        lw_searchitem_notify_sources (item);
         lw_searchitem_unlock_mutex (item);
         return;
       }
@@ -0,0 +1,616 @@
+/******************************************************************************
+    AUTHOR:
+    File written and Copyrighted by Zachary Dovel. All Rights Reserved.
+
+    LICENSE:
+    This file is part of gWaei.
+
+    gWaei is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    gWaei is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with gWaei.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+
+//!
+//! @file headwordtrie.c
+//!
+//! @brief A double-array trie of the headwords and readings of an EDICT dictionary
+//!
+//! The keys are the headwords and the readings of the entries as they are
+//! written, since they are matched against the text of the user.  Walking
+//! the trie takes one array lookup per byte, so the longest key at a position
+//! of a text is found without any search, and the walk never goes further than
+//! LW_HEADWORDTRIE_MAX_KEY_LENGTH bytes.  Like the term index, the trie is
+//! kept in the cache folder as a LwCacheFile.
+//!
+
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include <libwaei/libwaei.h>
+
+
+//!
+//! @brief The growing arrays of a trie while it is built
+//!
+struct _LwHeadwordTrieCells {
+  GArray *base;
+  GArray *check;
+  gchar **keys;                   //!< The keys sorted by strcmp
+  guint32 next_check_pos;         //!< Cells before this one are almost all taken
+};
+typedef struct _LwHeadwordTrieCells LwHeadwordTrieCells;
+
+
+static void 
+_headwordtrie_add (LwHeadwordTrieBuilder *builder, const gchar *KEY, gsize length, guint32 offset)
+{
+    //Declarations
+    gchar buffer[LW_HEADWORDTRIE_MAX_KEY_LENGTH + 1];
+    GArray *postings;
+
+    if (length == 0 || length > LW_HEADWORDTRIE_MAX_KEY_LENGTH) return;
+
+    //Initializations
+    memcpy (buffer, KEY, length);
+    buffer[length] = '\0';
+    postings = g_hash_table_lookup (builder->table, buffer);
+
+    if (postings == NULL)
+    {
+      postings = g_array_new (FALSE, FALSE, sizeof(guint32));
+      g_hash_table_insert (builder->table, g_string_chunk_insert (builder->strings, buffer), postings);
+    }
+
+    //A reading can be the same as the headword
+    if (postings->len > 0 && g_array_index (postings, guint32, postings->len - 1) == offset) return;
+
+    g_array_append_val (postings, offset);
+}
+
+
+//!
+//! @brief Adds a list of headwords or readings separated with semicolons.  Each
+//!        one can have notes in parentheses after it.
+//!
+static void 
+_headwordtrie_add_list (LwHeadwordTrieBuilder *builder, const gchar *START, const gchar *END, guint32 offset)
+{
+    //Declarations
+    const gchar *ptr;
+    const gchar *next;
+    const gchar *paren;
+
+    for (ptr = START; ptr < END; ptr = next + 1)
+    {
+      next = memchr (ptr, ';', END - ptr);
+      if (next == NULL) next = END;
+
+      paren = memchr (ptr, '(', next - ptr);
+      _headwordtrie_add (builder, ptr, ((paren != NULL) ? paren : next) - ptr, offset);
+    }
+}
+
+
+//!
+//! @brief Adds the headwords and the readings in the brackets of one EDICT line
+//!
+static void 
+_headwordtrie_add_entry (LwHeadwordTrieBuilder *builder, const gchar *LINE, guint32 offset)
+{
+    //Declarations
+    const gchar *slash;
+    const gchar *end;
+    const gchar *start;
+
+    //Initializations
+    slash = strchr (LINE, '/');
+    if (slash == NULL) return;
+
+    end = memchr (LINE, ' ', slash - LINE);
+    if (end == NULL) return;
+    _headwordtrie_add_list (builder, LINE, end, offset);
+
+    start = memchr (end, '[', slash - end);
+    if (start == NULL) return;
+    start++;
+    end = memchr (start, ']', slash - start);
+    if (end == NULL) return;
+    _headwordtrie_add_list (builder, start, end, offset);
+}
+
+
+static void 
+_headwordtrie_free_postings (gpointer data)
+{
+    g_array_free ((GArray*) data, TRUE);
+}
+
+
+//!
+//! @brief Makes sure there are at least length cells.  New cells are free.
+//!
+static void 
+_headwordtrie_reserve (LwHeadwordTrieCells *cells, guint32 length)
+{
+    //Declarations
+    guint32 i;
+    guint32 old;
+
+    if (length <= cells->check->len) return;
+
+    //Initializations
+    old = cells->check->len;
+    length = MAX (length, old * 2);
+
+    g_array_set_size (cells->base, length);
+    g_array_set_size (cells->check, length);
+    for (i = old; i < length; i++)
+    {
+      g_array_index (cells->base, gint32, i) = 0;
+      g_array_index (cells->check, gint32, i) = -1;
+    }
+}
+
+
+//!
+//! @brief Finds a base where every child of a cell lands on a free cell.  The
+//!        search starts after the cells that are almost all taken so the
+//!        build stays linear.
+//! @param codes The bytes of the children in increasing order
+//! @param total The number of children
+//!
+static gint32 
+_headwordtrie_find_base (LwHeadwordTrieCells *cells, const guchar *codes, gint total)
+{
+    //Declarations
+    guint32 pos;
+    guint32 nonzero;
+    gboolean first;
+    gint32 base;
+    gint i;
+
+    //Initializations
+    pos = MAX (cells->next_check_pos, (guint32) codes[0] + 1);
+    nonzero = 0;
+    first = TRUE;
+
+    for (;; pos++)
+    {
+      _headwordtrie_reserve (cells, pos + 1);
+      if (g_array_index (cells->check, gint32, pos) != -1)
+      {
+        nonzero++;
+        continue;
+      }
+      if (first)
+      {
+        cells->next_check_pos = pos;
+        first = FALSE;
+      }
+
+      base = pos - codes[0];
+      _headwordtrie_reserve (cells, base + codes[total - 1] + 1);
+      for (i = 1; i < total && g_array_index (cells->check, gint32, base + codes[i]) == -1; i++);
+      if (i == total) break;
+    }
+
+    if (nonzero * 20 >= (pos - cells->next_check_pos + 1) * 19) cells->next_check_pos = pos;
+
+    return base;
+}
+
+
+//!
+//! @brief Places the children of a cell and then their subtrees
+//! @param parent The cell of the prefix the keys share
+//! @param first The first key with the prefix
+//! @param last One after the last key with the prefix
+//! @param depth The length of the prefix in bytes
+//!
+static void 
+_headwordtrie_insert (LwHeadwordTrieCells *cells, gint32 parent, guint32 first, guint32 last, gsize depth)
+{
+    //Declarations
+    guchar codes[256];
+    gint total;
+    gint32 base;
+    guchar c;
+    guint32 i;
+    guint32 j;
+
+    //Initializations
+    total = 0;
+
+    for (i = first; i < last; i++)
+    {
+      c = (guchar) cells->keys[i][depth];
+      if (total == 0 || codes[total - 1] != c) codes[total++] = c;
+    }
+
+    base = _headwordtrie_find_base (cells, codes, total);
+    g_array_index (cells->base, gint32, parent) = base;
+    for (i = 0; i < total; i++)
+      g_array_index (cells->check, gint32, base + codes[i]) = parent;
+
+    for (i = first; i < last; i = j)
+    {
+      c = (guchar) cells->keys[i][depth];
+      for (j = i + 1; j < last && (guchar) cells->keys[j][depth] == c; j++);
+
+      //The sorted keys have the one that ends here first
+      if (c == '\0')
+        g_array_index (cells->base, gint32, base) = -((gint32) i) - 1;
+      else
+        _headwordtrie_insert (cells, base + c, i, j, depth + 1);
+    }
+}
+
+
+//!
+//! @brief Checks that the counts in the header of a headword trie match its length
+//!
+static gboolean 
+_headwordtrie_check (const LwCacheFileHeader *FILE_HEADER, gsize length)
+{
+    //Declarations
+    const LwHeadwordTrieHeader *header;
+    const guint32 *posting_offsets;
+
+    //Initializations
+    header = (const LwHeadwordTrieHeader*) FILE_HEADER;
+
+    if (length < sizeof(LwHeadwordTrieHeader) || header->total_cells == 0) return FALSE;
+    if (length != sizeof(LwHeadwordTrieHeader) + sizeof(gint32) * 2 * (gsize) header->total_cells + sizeof(guint32) * ((gsize) header->total_keys + 1 + header->total_postings)) return FALSE;
+
+    posting_offsets = (const guint32*) ((const gint32*) (header + 1) + 2 * (gsize) header->total_cells);
+
+    return (posting_offsets[header->total_keys] == header->total_postings);
+}
+
+
+static const LwCacheFileType _headwordtrie_type = {
+  "trie", LW_HEADWORDTRIE_MAGIC, LW_HEADWORDTRIE_VERSION, _headwordtrie_check, lw_headwordtrie_build
+};
+
+
+//!
+//! @brief Creates a new LwHeadwordTrieBuilder object to collect the keys of a dictionary
+//! @return An allocated LwHeadwordTrieBuilder that will be needed to be freed by lw_headwordtrie_builder_free.
+//!
+LwHeadwordTrieBuilder* 
+lw_headwordtrie_builder_new ()
+{
+    LwHeadwordTrieBuilder *temp;
+
+    temp = (LwHeadwordTrieBuilder*) malloc(sizeof(LwHeadwordTrieBuilder));
+
+    if (temp != NULL)
+    {
+      temp->table = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, _headwordtrie_free_postings);
+      temp->strings = g_string_chunk_new (64 * 1024);
+      temp->offset = 0;
+    }
+
+    return temp;
+}
+
+
+//!
+//! @brief Releases a LwHeadwordTrieBuilder object from memory.
+//! @param builder A LwHeadwordTrieBuilder object created by lw_headwordtrie_builder_new.
+//!
+void 
+lw_headwordtrie_builder_free (LwHeadwordTrieBuilder *builder)
+{
+    g_hash_table_destroy (builder->table);
+    g_string_chunk_free (builder->strings);
+
+    free (builder);
+}
+
+
+//!
+//! @brief A LwIoLineFunc that adds the headwords and readings of the next line of an
+//!        EDICT dictionary to a LwHeadwordTrieBuilder.  The lines have to be passed
+//!        in file order.
+//! @param LINE The nul terminated line with its line end
+//! @param LENGTH The length of the line in bytes
+//! @param data A LwHeadwordTrieBuilder
+//! @returns Always TRUE
+//!
+gboolean 
+lw_headwordtrie_builder_add_line (const gchar *LINE, gsize LENGTH, gpointer data)
+{
+    //Declarations
+    LwHeadwordTrieBuilder *builder;
+    gunichar first;
+
+    //Initializations
+    builder = data;
+    first = g_utf8_get_char (LINE);
+
+    if (first != '#' && first != L'？' && first != 0x3000)
+      _headwordtrie_add_entry (builder, LINE, builder->offset);
+    builder->offset += LENGTH;
+
+    return TRUE;
+}
+
+
+//!
+//! @brief Writes the headword trie of an installed dictionary to the cache folder
+//!        from the lines given to a LwHeadwordTrieBuilder
+//! @param builder A LwHeadwordTrieBuilder that was given every line of the dictionary
+//! @param TYPE The LwDictType of the dictionary
+//! @param FILENAME The filename of the dictionary in its dictionary folder
+//! @param error A pointer to a GError to write errors to or NULL
+//! @returns FALSE if the trie couldn't be written
+//!
+gboolean 
+lw_headwordtrie_builder_write (LwHeadwordTrieBuilder *builder, LwDictType TYPE, const gchar *FILENAME, GError **error)
+{
+    //Sanity check
+    if (error != NULL && *error != NULL) return FALSE;
+
+    //Declarations
+    GList *keys;
+    GList *link;
+    GArray *postings;
+    LwHeadwordTrieCells cells;
+    LwHeadwordTrieHeader header;
+    gchar *data;
+    gsize length;
+    gint32 *cell_data;
+    guint32 *posting_offsets;
+    guint32 *posting_data;
+    guint32 i;
+    gboolean written;
+
+    //Initializations
+    keys = g_list_sort (g_hash_table_get_keys (builder->table), (GCompareFunc) strcmp);
+    cells.base = g_array_new (FALSE, FALSE, sizeof(gint32));
+    cells.check = g_array_new (FALSE, FALSE, sizeof(gint32));
+    cells.keys = g_new (gchar*, g_hash_table_size (builder->table) + 1);
+    cells.next_check_pos = 1;
+
+    //Build the trie from the sorted keys with the root in cell 0
+    for (link = keys, i = 0; link != NULL; link = link->next, i++)
+      cells.keys[i] = (gchar*) link->data;
+    cells.keys[i] = NULL;
+
+    _headwordtrie_reserve (&cells, 256);
+    g_array_index (cells.check, gint32, 0) = 0;
+    if (keys != NULL) _headwordtrie_insert (&cells, 0, 0, i, 0);
+
+    memset (&header, 0, sizeof(LwHeadwordTrieHeader));
+    header.total_cells = cells.check->len;
+    header.total_keys = g_hash_table_size (builder->table);
+
+    for (link = keys; link != NULL; link = link->next)
+    {
+      postings = g_hash_table_lookup (builder->table, link->data);
+      header.total_postings += postings->len;
+    }
+
+    //Lay out the file
+    length = sizeof(LwHeadwordTrieHeader) + sizeof(gint32) * 2 * header.total_cells + sizeof(guint32) * (header.total_keys + 1 + header.total_postings);
+    data = g_malloc (length);
+    memcpy (data, &header, sizeof(LwHeadwordTrieHeader));
+    cell_data = (gint32*) (data + sizeof(LwHeadwordTrieHeader));
+    memcpy (cell_data, cells.base->data, sizeof(gint32) * header.total_cells);
+    memcpy (cell_data + header.total_cells, cells.check->data, sizeof(gint32) * header.total_cells);
+    posting_offsets = (guint32*) (cell_data + 2 * header.total_cells);
+    posting_data = posting_offsets + header.total_keys + 1;
+
+    posting_offsets[0] = 0;
+    for (link = keys, i = 0; link != NULL; link = link->next, i++)
+    {
+      postings = g_hash_table_lookup (builder->table, link->data);
+      memcpy (posting_data + posting_offsets[i], postings->data, sizeof(guint32) * postings->len);
+      posting_offsets[i + 1] = posting_offsets[i] + postings->len;
+    }
+
+    written = lw_cachefile_write (&_headwordtrie_type, TYPE, FILENAME, data, length, error);
+
+    //Cleanup
+    g_list_free (keys);
+    g_array_free (cells.base, TRUE);
+    g_array_free (cells.check, TRUE);
+    g_free (cells.keys);
+    g_free (data);
+
+    return written;
+}
+
+
+//!
+//! @brief Reads an installed EDICT dictionary and writes its headword trie to the cache folder.
+//!        The installer feeds a LwHeadwordTrieBuilder from the lines it writes instead.
+//! @param TYPE The LwDictType of the dictionary
+//! @param FILENAME The filename of the dictionary in its dictionary folder
+//! @param error A pointer to a GError to write errors to or NULL
+//! @returns FALSE if the dictionary couldn't be read or the trie couldn't be written
+//!
+gboolean 
+lw_headwordtrie_build (LwDictType TYPE, const gchar *FILENAME, GError **error)
+{
+    //Sanity check
+    if (error != NULL && *error != NULL) return FALSE;
+
+    //Declarations
+    LwHeadwordTrieBuilder *builder;
+    gchar *path;
+    gboolean written;
+
+    //Initializations
+    builder = lw_headwordtrie_builder_new ();
+    path = lw_util_build_filename_by_dicttype (TYPE, FILENAME);
+
+    written = (lw_io_stream_file (path, LW_COMPRESSION_NONE, NULL, lw_headwordtrie_builder_add_line, builder, NULL, NULL, error) &&
+               lw_headwordtrie_builder_write (builder, TYPE, FILENAME, error));
+
+    //Cleanup
+    lw_headwordtrie_builder_free (builder);
+    g_free (path);
+
+    return written;
+}
+
+
+//!
+//! @brief Removes the headword trie of a dictionary from the cache folder if there is one
+//! @param TYPE The LwDictType of the dictionary
+//! @param FILENAME The filename of the dictionary in its dictionary folder
+//!
+void 
+lw_headwordtrie_remove (LwDictType TYPE, const gchar *FILENAME)
+{
+    lw_cachefile_remove (&_headwordtrie_type, TYPE, FILENAME);
+}
+
+
+//!
+//! @brief Maps the headword trie of a dictionary, writing it first if it is missing
+//!        or older than the dictionary.  Writing it reads the whole dictionary,
+//!        so this shouldn't be called from the main thread when the dictionary
+//!        wasn't installed through libwaei.
+//! @param TYPE The LwDictType of the dictionary
+//! @param FILENAME The filename of the dictionary in its dictionary folder
+//! @param error A pointer to a GError to write errors to or NULL
+//! @return An allocated LwHeadwordTrie that will be needed to be freed by lw_headwordtrie_free or NULL on error
+//!
+LwHeadwordTrie* 
+lw_headwordtrie_new (LwDictType TYPE, const gchar *FILENAME, GError **error)
+{
+    //Sanity check
+    if (error != NULL && *error != NULL) return NULL;
+
+    //Declarations
+    LwHeadwordTrie *trie;
+    GMappedFile *file;
+    const LwHeadwordTrieHeader *header;
+
+    //Initializations
+    file = lw_cachefile_map (&_headwordtrie_type, TYPE, FILENAME, error);
+    if (file == NULL) return NULL;
+
+    trie = (LwHeadwordTrie*) malloc(sizeof(LwHeadwordTrie));
+    if (trie == NULL)
+    {
+      g_mapped_file_unref (file);
+      return NULL;
+    }
+
+    header = (const LwHeadwordTrieHeader*) g_mapped_file_get_contents (file);
+    trie->file = file;
+    trie->header = header;
+    trie->base = (const gint32*) (header + 1);
+    trie->check = trie->base + header->total_cells;
+    trie->posting_offsets = (const guint32*) (trie->check + header->total_cells);
+    trie->postings = trie->posting_offsets + header->total_keys + 1;
+
+    return trie;
+}
+
+
+//!
+//! @brief Releases a LwHeadwordTrie object from memory.
+//! @param trie A LwHeadwordTrie object created by lw_headwordtrie_new.
+//!
+void 
+lw_headwordtrie_free (LwHeadwordTrie *trie)
+{
+    g_mapped_file_unref (trie->file);
+    free (trie);
+}
+
+
+//!
+//! @brief Finds the longest headword or reading that a text starts with
+//! @param trie An LwHeadwordTrie
+//! @param TEXT The text to match
+//! @param LENGTH The length of the text in bytes
+//! @param key A pointer to write the number of the matched key to
+//! @returns The length of the match in bytes or 0 if no key starts the text
+//!
+gsize 
+lw_headwordtrie_match_longest (LwHeadwordTrie *trie, const gchar *TEXT, gsize LENGTH, guint32 *key)
+{
+    //Declarations
+    const gint32 *base;
+    const gint32 *check;
+    gint64 total;
+    gint64 current;
+    gint64 next;
+    gsize longest;
+    gsize i;
+
+    //Initializations
+    base = trie->base;
+    check = trie->check;
+    total = trie->header->total_cells;
+    current = 0;
+    longest = 0;
+
+    for (i = 0; i < LENGTH && i < LW_HEADWORDTRIE_MAX_KEY_LENGTH && TEXT[i] != '\0'; i++)
+    {
+      next = (gint64) base[current] + (guchar) TEXT[i];
+      if (next <= 0 || next >= total || check[next] != current) break;
+      current = next;
+
+      //Does a key end here
+      next = base[current];
+      if (next > 0 && next < total && check[next] == current && base[next] < 0 && -((gint64) base[next]) - 1 < trie->header->total_keys)
+      {
+        longest = i + 1;
+        *key = -((gint64) base[next]) - 1;
+      }
+    }
+
+    return longest;
+}
+
+
+//!
+//! @brief Gets the lines a key is a headword or reading of
+//! @param trie An LwHeadwordTrie
+//! @param key The number of the key
+//! @param total A pointer to write the number of lines to
+//! @returns The byte offsets of the lines in increasing order.  They belong to the trie.
+//!
+const guint32* 
+lw_headwordtrie_get_postings (LwHeadwordTrie *trie, guint32 key, guint32 *total)
+{
+    //Declarations
+    guint32 start;
+    guint32 end;
+
+    //Initializations
+    *total = 0;
+
+    g_return_val_if_fail (key < trie->header->total_keys, NULL);
+
+    start = trie->posting_offsets[key];
+    end = trie->posting_offsets[key + 1];
+    if (start > end || end > trie->header->total_postings) return NULL;
+
+    *total = end - start;
+
+    return trie->postings + start;
+}
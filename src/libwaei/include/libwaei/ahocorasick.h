@@ -0,0 +1,75 @@
+#ifndef LW_AHOCORASICK_INCLUDED
+#define LW_AHOCORASICK_INCLUDED
+
+#define LW_AHOCORASICK(object) (LwAhoCorasick*) object
+
+#define LW_AHOCORASICK_ROOT 0
+
+//!
+//! @brief Called for every pattern found in a scanned text
+//! @param pattern The index of the pattern as returned by lw_ahocorasick_add
+//! @param start The byte offset of the start of the match in the text
+//! @param end The byte offset just past the end of the match
+//! @param data The data given to lw_ahocorasick_scan
+//! @returns FALSE to stop the scan
+//!
+typedef gboolean (*LwAhoCorasickMatchFunc) (gint pattern, gsize start, gsize end, gpointer data);
+
+//!
+//! @brief A state of the automaton, which is a node of the trie of the patterns
+//!
+struct _LwAhoCorasickState {
+  guint32 fail;          //!< State of the longest proper suffix that is also a trie node
+  guint32 output;        //!< Nearest state on the fail chain, this one included, that ends a pattern, or the root
+  gint32 pattern;        //!< First pattern ending at this state or -1
+  guint32 edges;         //!< Index of the first edge of the state
+  guint32 total_edges;
+};
+typedef struct _LwAhoCorasickState LwAhoCorasickState;
+
+struct _LwAhoCorasickEdge {
+  guint32 state;
+  guint32 target;
+  guint8 byte;
+};
+typedef struct _LwAhoCorasickEdge LwAhoCorasickEdge;
+
+struct _LwAhoCorasickPattern {
+  gsize length;          //!< Length of the pattern in bytes
+  gint32 next;           //!< Next pattern ending at the same state or -1
+  gpointer data;
+};
+typedef struct _LwAhoCorasickPattern LwAhoCorasickPattern;
+
+//!
+//! @brief An Aho-Corasick automaton finding any number of byte patterns in
+//!        one pass over a text.  Patterns are added first, then the automaton is
+//!        compiled once and can scan any number of texts.  The root keeps a full
+//!        256 entry table since most bytes of a text lead back to it, and the
+//!        other states keep their edges sorted by byte.
+//!
+struct _LwAhoCorasick {
+  GArray *states;               //!< LwAhoCorasickStates with the root at LW_AHOCORASICK_ROOT
+  GArray *edges;                //!< LwAhoCorasickEdges sorted by state and byte once compiled
+  GArray *patterns;             //!< LwAhoCorasickPatterns
+  GHashTable *trie;             //!< State << 8 | byte to the target state while patterns are added
+  guint32 root[256];            //!< Next state from the root for every byte
+  gboolean ignore_case;         //!< Patterns and texts are matched without regard to ASCII case
+  gboolean compiled;
+};
+typedef struct _LwAhoCorasick LwAhoCorasick;
+
+LwAhoCorasick* lw_ahocorasick_new (void);
+void lw_ahocorasick_free (LwAhoCorasick*);
+void lw_ahocorasick_init (LwAhoCorasick*);
+void lw_ahocorasick_deinit (LwAhoCorasick*);
+
+void lw_ahocorasick_set_ignore_case (LwAhoCorasick*, gboolean);
+gint lw_ahocorasick_add (LwAhoCorasick*, const gchar*, gpointer);
+void lw_ahocorasick_compile (LwAhoCorasick*);
+gboolean lw_ahocorasick_scan (LwAhoCorasick*, const gchar*, gsize, LwAhoCorasickMatchFunc, gpointer);
+
+gint lw_ahocorasick_get_total_patterns (LwAhoCorasick*);
+gpointer lw_ahocorasick_get_pattern_data (LwAhoCorasick*, gint);
+
+#endif
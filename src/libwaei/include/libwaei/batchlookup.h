@@ -0,0 +1,53 @@
+#ifndef LW_BATCHLOOKUP_INCLUDED
+#define LW_BATCHLOOKUP_INCLUDED
+
+#define LW_BATCHLOOKUP(object) (LwBatchLookup*) object
+
+//!
+//! @brief How a key of a word matched the headword part of a dictionary line
+//!
+typedef enum {
+  LW_BATCHLOOKUP_MATCH_KANJI_AS_HEADWORD = (1 << 0),
+  LW_BATCHLOOKUP_MATCH_KANJI_AS_READING = (1 << 1),
+  LW_BATCHLOOKUP_MATCH_FURIGANA_AS_HEADWORD = (1 << 2),
+  LW_BATCHLOOKUP_MATCH_FURIGANA_AS_READING = (1 << 3)
+} LwBatchLookupMatch;
+
+//!
+//! @brief The words a dictionary line matched while it is being scanned
+//!
+struct _LwBatchLookupHit {
+  gint word;
+  guint matches;            //!< LwBatchLookupMatch flags
+};
+typedef struct _LwBatchLookupHit LwBatchLookupHit;
+
+//!
+//! @brief Looks up many words in a dictionary at once.  The kanji and furigana
+//!        of every word are compiled into one LwAhoCorasick automaton, so a
+//!        single pass over the dictionary finds the entries of all of them
+//!        instead of one full search per word.
+//!
+struct _LwBatchLookup {
+  LwAhoCorasick *automaton;
+  GArray *scores;           //!< Best score of each word so far, as gint
+  GPtrArray *results;       //!< LwVocabularyItem made from the best entry of each word or NULL
+  GArray *hits;             //!< LwBatchLookupHits of the line being scanned
+  const gchar *line;        //!< The line being scanned
+  const gchar *reading;     //!< Where the reading of the line being scanned starts or NULL
+};
+typedef struct _LwBatchLookup LwBatchLookup;
+
+LwBatchLookup* lw_batchlookup_new (void);
+void lw_batchlookup_free (LwBatchLookup*);
+void lw_batchlookup_init (LwBatchLookup*);
+void lw_batchlookup_deinit (LwBatchLookup*);
+
+gint lw_batchlookup_add (LwBatchLookup*, const gchar*, const gchar*);
+gint lw_batchlookup_add_vocabularylist (LwBatchLookup*, LwVocabularyList*);
+gboolean lw_batchlookup_run (LwBatchLookup*, LwDictInfo*, LwIoProgressCallback, gpointer, GError**);
+
+gint lw_batchlookup_get_total_words (LwBatchLookup*);
+LwVocabularyItem* lw_batchlookup_get_result (LwBatchLookup*, gint);
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef LW_CACHEFILE_INCLUDED
+#define LW_CACHEFILE_INCLUDED
+
+#include <libwaei/dict.h>
+
+#define LW_CACHEFILE_ERROR "gWaei Cache File Error"
+
+typedef enum {
+  LW_CACHEFILE_ERROR_CORRUPT,
+  LW_CACHEFILE_ERROR_OUTDATED
+} LwCacheFileError;
+
+//!
+//! @brief The start of every index file written to the cache folder for a
+//!        dictionary.  An index is only used while the dictionary still has
+//!        the size and modification time it was made from.
+//!
+struct _LwCacheFileHeader {
+  guint32 magic;                  //!< Identifies the kind of index in the byte order of the machine that wrote it
+  guint32 version;
+  gint64 dictionary_size;         //!< Size of the dictionary the index was made from
+  gint64 dictionary_mtime;        //!< Modification time of the dictionary the index was made from
+};
+typedef struct _LwCacheFileHeader LwCacheFileHeader;
+
+typedef gboolean (*LwCacheFileCheckFunc) (const LwCacheFileHeader *header, gsize length);
+typedef gboolean (*LwCacheFileBuildFunc) (LwDictType type, const gchar *filename, GError **error);
+
+//!
+//! @brief Describes a kind of index file kept in the cache folder
+//!
+struct _LwCacheFileType {
+  const gchar *extension;         //!< Added to the name of the dictionary to name the index file
+  guint32 magic;
+  guint32 version;
+  LwCacheFileCheckFunc check;     //!< Checks that the counts in the header match the length of the file
+  LwCacheFileBuildFunc build;     //!< Writes the index of an installed dictionary
+};
+typedef struct _LwCacheFileType LwCacheFileType;
+
+gchar* lw_cachefile_get_uri (const LwCacheFileType*, LwDictType, const gchar*);
+gboolean lw_cachefile_write (const LwCacheFileType*, LwDictType, const gchar*, gchar*, gsize, GError**);
+GMappedFile* lw_cachefile_map (const LwCacheFileType*, LwDictType, const gchar*, GError**);
+void lw_cachefile_remove (const LwCacheFileType*, LwDictType, const gchar*);
+
+#endif
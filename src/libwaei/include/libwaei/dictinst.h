@@ -43,6 +43,7 @@ struct _LwDictInst {
   char **current_source_uris;
   char **current_target_uris;
   gboolean split;
+  guint32 split_tags[2];        //!< The LwIoNameTags of the lines written to the Names and the Places dictionary
   gboolean merge;
   GMutex *mutex;
 };
@@ -89,6 +90,7 @@ void lw_dictinst_set_encoding (LwDictInst*, const LwEncoding);
 void lw_dictinst_set_compression (LwDictInst*, const LwCompression);
 void lw_dictinst_set_download_source (LwDictInst*, const char*);
 void lw_dictinst_set_split (LwDictInst *di, const gboolean);
+void lw_dictinst_set_split_tags (LwDictInst *di, const char*);
 void lw_dictinst_set_merge (LwDictInst *di, const gboolean);
 void lw_dictinst_set_status (LwDictInst *di, const LwDictInstUri);
 gchar* lw_dictinst_get_status_string (LwDictInst*, gboolean);
@@ -97,6 +99,9 @@ void lw_dictinst_regenerate_save_target_uris (LwDictInst*);
 gboolean lw_dictinst_data_is_valid (LwDictInst*);
 
 gboolean lw_dictinst_install (LwDictInst*, LwIoProgressCallback, gpointer, GError**);
+gboolean lw_dictinst_download (LwDictInst*, LwIoProgressCallback, gpointer, GError**);
+gboolean lw_dictinst_process (LwDictInst*, LwIoProgressCallback, gpointer, GError**);
+void lw_dictinst_clean (LwDictInst*, LwIoProgressCallback, gpointer);
 char* lw_dictinst_get_target_uri (LwDictInst*, const LwDictInstUri, const int);
 char* lw_dictinst_get_source_uri (LwDictInst*, const LwDictInstUri, const int);
 
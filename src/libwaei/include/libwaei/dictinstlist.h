@@ -3,6 +3,8 @@
 
 #define LW_DICTINSTLIST(object) (LwDictInstList*) object
 
+#define LW_DICTINSTLIST_MAX_CONCURRENT 2
+
 struct _LwDictInstList {
   GList *list;
   gboolean cancel;
@@ -18,5 +20,6 @@ LwDictInst* lw_dictinstlist_get_dictinst_fuzzy (LwDictInstList*, const char*);
 LwDictInst* lw_dictinstlist_get_dictinst_by_idstring (LwDictInstList*, const char*);
 LwDictInst* lw_dictinstlist_get_dictinst_by_filename (LwDictInstList*, const char*);
 void lw_dictinstlist_set_cancel_operations (LwDictInstList*, gboolean);
+gboolean lw_dictinstlist_install (LwDictInstList*, int, LwIoProgressCallback, gpointer, GError**);
 
 #endif
@@ -0,0 +1,61 @@
+#ifndef LW_DICTMANIFEST_INCLUDED
+#define LW_DICTMANIFEST_INCLUDED
+
+#include <libwaei/dict.h>
+
+#define LW_DICTMANIFEST(object) (LwDictManifest*) object
+
+#define LW_DICTMANIFEST_FILENAME "manifest"
+
+//!
+//! @brief The metadata recorded for an installed dictionary
+//!
+struct _LwDictManifestEntry {
+  gint64 size;               //!< Size of the file in bytes
+  gint64 mtime;              //!< Modification time of the file
+  gint64 lines;              //!< Number of lines in the file or -1 if unknown
+  gchar encoding[20];        //!< Text encoding of the file
+  gchar checksum[65];        //!< SHA-256 of the file or an empty string if unknown
+};
+typedef struct _LwDictManifestEntry LwDictManifestEntry;
+
+//!
+//! @brief The line count and checksum of a dictionary taken while it is written
+//!
+struct _LwDictManifestTally {
+  gint64 lines;              //!< Line ends seen so far
+  gboolean partial;          //!< The text seen so far doesn't end with a line end
+  GChecksum *checksum;       //!< Checksum of the text seen so far
+};
+typedef struct _LwDictManifestTally LwDictManifestTally;
+
+//!
+//! @brief A keyfile in the dictionary folder that caches the metadata of the
+//!        installed dictionaries so they don't have to be read at startup
+//!
+struct _LwDictManifest {
+  GKeyFile *keyfile;         //!< The loaded manifest
+  gchar *uri;                //!< Path to the manifest file
+  gboolean changed;          //!< The manifest needs to be saved
+};
+typedef struct _LwDictManifest LwDictManifest;
+
+LwDictManifest* lw_dictmanifest_new (void);
+void lw_dictmanifest_free (LwDictManifest*);
+void lw_dictmanifest_init (LwDictManifest*);
+void lw_dictmanifest_deinit (LwDictManifest*);
+
+gboolean lw_dictmanifest_get_entry (LwDictManifest*, const LwDictType, const char*, LwDictManifestEntry*);
+gboolean lw_dictmanifest_update_entry (LwDictManifest*, const LwDictType, const char*, GError**);
+void lw_dictmanifest_remove_entry (LwDictManifest*, const LwDictType, const char*);
+gboolean lw_dictmanifest_save (LwDictManifest*, GError**);
+
+void lw_dictmanifest_tally_init (LwDictManifestTally*);
+void lw_dictmanifest_tally_deinit (LwDictManifestTally*);
+gboolean lw_dictmanifest_tally_text (const gchar*, gsize, gpointer);
+
+gboolean lw_dictmanifest_record (const LwDictType, const char*, LwDictManifestTally*, GError**);
+gboolean lw_dictmanifest_forget (const LwDictType, const char*, GError**);
+gboolean lw_dictmanifest_refresh (GList*, GError**);
+
+#endif
@@ -4,6 +4,7 @@
 #define LW_MAX_HIGH_RELEVENT_RESULTS 1000
 #define LW_MAX_MEDIUM_IRRELEVENT_RESULTS 1000
 #define LW_MAX_LOW_IRRELEVENT_RESULTS    1000
+#define LW_ENGINE_PROGRESS_STEPS 100 //!< Times per search the watches are woken for progress
 
 void lw_searchitem_start_search (LwSearchItem*, gboolean, gboolean);
 
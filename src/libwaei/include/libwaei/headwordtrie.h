@@ -0,0 +1,66 @@
+#ifndef LW_HEADWORDTRIE_INCLUDED
+#define LW_HEADWORDTRIE_INCLUDED
+
+#define LW_HEADWORDTRIE(object) (LwHeadwordTrie*) object
+
+#define LW_HEADWORDTRIE_MAGIC 0x5448574cU     //!< "LWHT" in the byte order of the machine that wrote it
+#define LW_HEADWORDTRIE_VERSION 1
+#define LW_HEADWORDTRIE_MAX_KEY_LENGTH 96     //!< Longest indexed headword or reading in bytes
+
+//!
+//! @brief The start of a headword trie file.  The bases and checks of the
+//!        cells, the posting offsets and the postings follow as arrays.
+//!
+struct _LwHeadwordTrieHeader {
+  LwCacheFileHeader file;
+  guint32 total_cells;
+  guint32 total_keys;
+  guint32 total_postings;
+  guint32 reserved;
+};
+typedef struct _LwHeadwordTrieHeader LwHeadwordTrieHeader;
+
+//!
+//! @brief The headwords and readings of an EDICT dictionary in a double-array
+//!        trie with the byte offsets of the lines of each one.  The child of
+//!        cell s for byte c is base[s] + c if its check is s.  The child for
+//!        byte 0 ends a key and keeps -(key + 1) as its base.  It is written to
+//!        the cache folder when the dictionary is installed and memory mapped
+//!        for text analysis.
+//!
+struct _LwHeadwordTrie {
+  GMappedFile *file;
+  const LwHeadwordTrieHeader *header;
+  const gint32 *base;
+  const gint32 *check;
+  const guint32 *posting_offsets; //!< total_keys + 1 offsets into postings
+  const guint32 *postings;        //!< Byte offsets of dictionary lines
+};
+typedef struct _LwHeadwordTrie LwHeadwordTrie;
+
+//!
+//! @brief The headwords and readings of a dictionary and the lines they are in
+//!        while its headword trie is built
+//!
+struct _LwHeadwordTrieBuilder {
+  GHashTable *table;              //!< A GArray of line offsets for each key
+  GStringChunk *strings;          //!< The keys
+  guint32 offset;                 //!< Byte offset of the next line
+};
+typedef struct _LwHeadwordTrieBuilder LwHeadwordTrieBuilder;
+
+LwHeadwordTrie* lw_headwordtrie_new (LwDictType, const gchar*, GError**);
+void lw_headwordtrie_free (LwHeadwordTrie*);
+
+LwHeadwordTrieBuilder* lw_headwordtrie_builder_new (void);
+void lw_headwordtrie_builder_free (LwHeadwordTrieBuilder*);
+gboolean lw_headwordtrie_builder_add_line (const gchar*, gsize, gpointer);
+gboolean lw_headwordtrie_builder_write (LwHeadwordTrieBuilder*, LwDictType, const gchar*, GError**);
+
+gboolean lw_headwordtrie_build (LwDictType, const gchar*, GError**);
+void lw_headwordtrie_remove (LwDictType, const gchar*);
+
+gsize lw_headwordtrie_match_longest (LwHeadwordTrie*, const gchar*, gsize, guint32*);
+const guint32* lw_headwordtrie_get_postings (LwHeadwordTrie*, guint32, guint32*);
+
+#endif
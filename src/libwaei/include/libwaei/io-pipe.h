@@ -0,0 +1,39 @@
+#ifndef LW_IOPIPE_INCLUDED
+#define LW_IOPIPE_INCLUDED
+
+#define LW_IOPIPE(object) (LwIoPipe*) object
+
+#define LW_IOPIPE_CHUNK_SIZE (64 * 1024)
+#define LW_IOPIPE_MAX_CHUNKS 8
+
+struct _LwIoPipeChunk {
+    gsize length;                      //!< The number of bytes used in data
+    gsize offset;                      //!< Bytes of the original source consumed up to this chunk
+    gchar data[LW_IOPIPE_CHUNK_SIZE];  //!< The chunk contents
+};
+typedef struct _LwIoPipeChunk LwIoPipeChunk;
+
+struct _LwIoPipe {
+    GQueue *queue;       //!< Chunks waiting for the next stage
+    GMutex *mutex;       //!< Guards every other member
+    GCond *not_empty;    //!< Signaled when a chunk is pushed or the pipe is closed
+    GCond *not_full;     //!< Signaled when a chunk is popped or the pipe is aborted
+    guint max;           //!< The number of chunks allowed in flight before writers block
+    gboolean closed;     //!< The writing stage has no more data
+    gboolean aborted;    //!< A stage failed or was cancelled and the data should be dropped
+};
+typedef struct _LwIoPipe LwIoPipe;
+
+LwIoPipe* lw_iopipe_new (guint);
+void lw_iopipe_free (LwIoPipe*);
+
+LwIoPipeChunk* lw_iopipe_chunk_new (void);
+void lw_iopipe_chunk_free (LwIoPipeChunk*);
+
+gboolean lw_iopipe_push (LwIoPipe*, LwIoPipeChunk*);
+LwIoPipeChunk* lw_iopipe_pop (LwIoPipe*);
+void lw_iopipe_close (LwIoPipe*);
+void lw_iopipe_abort (LwIoPipe*);
+gboolean lw_iopipe_is_aborted (LwIoPipe*);
+
+#endif
@@ -1,12 +1,20 @@
 #ifndef LW_IO_INCLUDED
 #define LW_IO_INCLUDED
 
+#include <stdio.h>
 #include <glib.h>
 
 #define LW_IO_MAX_FGETS_LINE 5000
+#define LW_IO_MAX_CARRY 16
+#define LW_IO_PROGRESS_INTERVAL 0.1
+#define LW_IO_SPLIT_BATCH_SIZE (256 * 1024)
+#define LW_IO_SPLIT_MAX_THREADS 4
+#define LW_IO_SPLIT_MAX_BATCHES (LW_IO_SPLIT_MAX_THREADS * 2)
 #define LW_IO_ERROR "libwaei generic error"
 
 typedef int (*LwIoProgressCallback) (double percent, gpointer data);
+typedef gboolean (*LwIoLineFunc) (const gchar *line, gsize length, gpointer data);
+typedef gboolean (*LwIoWriteFunc) (const gchar *text, gsize length, gpointer data);
 
 struct _LwIoProgressCallbackWithData {
   LwIoProgressCallback cb;
@@ -14,6 +22,45 @@ struct _LwIoProgressCallbackWithData {
 };
 typedef struct _LwIoProgressCallbackWithData LwIoProgressCallbackWithData;
 
+struct _LwIoMixData {
+  GHashTable *radicals;    //!< The radicals of each kanji keyed by its codepoint
+  GString *buffer;         //!< Scratch space for building merged lines
+  LwIoWriteFunc write_func; //!< Writes the merged lines
+  gpointer output;         //!< Data passed to the write function
+};
+typedef struct _LwIoMixData LwIoMixData;
+
+typedef enum {
+  LW_IO_NAME_TAG_SURNAME = (1 << 0),        //!< s
+  LW_IO_NAME_TAG_PLACE = (1 << 1),          //!< p
+  LW_IO_NAME_TAG_UNCLASSIFIED = (1 << 2),   //!< u
+  LW_IO_NAME_TAG_GIVEN = (1 << 3),          //!< g
+  LW_IO_NAME_TAG_FEMALE = (1 << 4),         //!< f
+  LW_IO_NAME_TAG_MALE = (1 << 5),           //!< m
+  LW_IO_NAME_TAG_FULL = (1 << 6),           //!< h
+  LW_IO_NAME_TAG_PRODUCT = (1 << 7),        //!< pr
+  LW_IO_NAME_TAG_COMPANY = (1 << 8),        //!< co
+  LW_IO_NAME_TAG_STATION = (1 << 9)         //!< st
+} LwIoNameTag;
+
+#define LW_IO_NAME_TAGS_PERSONS (LW_IO_NAME_TAG_SURNAME | LW_IO_NAME_TAG_UNCLASSIFIED | LW_IO_NAME_TAG_GIVEN | LW_IO_NAME_TAG_FEMALE | LW_IO_NAME_TAG_MALE | LW_IO_NAME_TAG_FULL)
+#define LW_IO_NAME_TAGS_NAMES (LW_IO_NAME_TAGS_PERSONS | LW_IO_NAME_TAG_PRODUCT | LW_IO_NAME_TAG_COMPANY)
+#define LW_IO_NAME_TAGS_PLACES (LW_IO_NAME_TAG_PLACE | LW_IO_NAME_TAG_STATION)
+
+struct _LwIoSplitter {
+  LwIoWriteFunc write_func; //!< Writes the sorted lines of an output
+  gpointer *outputs;       //!< Data passed to the write function for each output
+  guint32 *tags;           //!< The mask of LwIoNameTags for each file
+  int total;               //!< The number of outputs
+  GThreadPool *pool;       //!< Sorts the batches of lines
+  GQueue *batches;         //!< Batches waiting to be written in the order they were read
+  GMutex *mutex;           //!< Guards the batches
+  GCond *cond;             //!< Signaled when a batch is sorted
+  struct _LwIoSplitBatch *current;  //!< The batch being filled
+  gboolean write_error;    //!< A write to one of the outputs failed
+};
+typedef struct _LwIoSplitter LwIoSplitter;
+
 typedef enum  {
   LW_IO_READ_ERROR,
   LW_IO_WRITE_ERROR,
@@ -27,8 +74,24 @@ void lw_io_write_file (const char*, const char*, gchar*, LwIoProgressCallback, g
 char** lw_io_get_dictionary_file_list (const int);
 size_t lw_io_get_filesize (const char*);
 
+gboolean lw_io_fwrite_func (const gchar*, gsize, gpointer);
+
+LwIoMixData* lw_io_mixdata_new (LwIoWriteFunc, gpointer);
+void lw_io_mixdata_free (LwIoMixData*);
+gboolean lw_io_mixdata_add_radicals_line (const gchar*, gsize, gpointer);
+gboolean lw_io_mixdata_merge_kanji_line (const gchar*, gsize, gpointer);
+
+guint32 lw_io_parse_name_tags (const gchar*, gsize);
+guint32 lw_io_get_name_tags_from_string (const char*);
+LwIoSplitter* lw_io_splitter_new (LwIoWriteFunc, gpointer*, const guint32*, const int);
+void lw_io_splitter_free (LwIoSplitter*);
+gboolean lw_io_splitter_add_line (const gchar*, gsize, gpointer);
+gboolean lw_io_splitter_finish (LwIoSplitter*);
+
 gboolean lw_io_create_mix_dictionary (const char*, const char*, const char*, LwIoProgressCallback, gpointer, GError**);
+gboolean lw_io_split_names_dictionary (const char*, const char**, const guint32*, const int, LwIoProgressCallback, gpointer, GError**);
 gboolean lw_io_split_places_from_names_dictionary (const char*, const char*, const char*, LwIoProgressCallback, gpointer, GError**);
+gboolean lw_io_stream_file (const char*, const LwCompression, const char*, LwIoLineFunc, gpointer, LwIoProgressCallback, gpointer, GError**);
 gboolean lw_io_copy_with_encoding (const char*, const char*, const char*, const char*, LwIoProgressCallback, gpointer, GError**);
 gboolean lw_io_copy (const char*, const char*, LwIoProgressCallback, gpointer, GError**);
 gboolean lw_io_remove (const char*, GError**);
@@ -0,0 +1,33 @@
+#ifndef LW_LEVENSHTEIN_INCLUDED
+#define LW_LEVENSHTEIN_INCLUDED
+
+#define LW_LEVENSHTEIN(object) (LwLevenshtein*) object
+
+#define LW_LEVENSHTEIN_MAX_DISTANCE 3    //!< Larger distances match too much of a dictionary to be useful
+
+//!
+//! @brief A Levenshtein automaton accepting every string within max_distance
+//!        edits of a pattern.  A state is the last row of the edit distance table,
+//!        with every cell past max_distance cut down to max_distance + 1, so it
+//!        can be stepped one character at a time along a sorted list of terms
+//!        and abandoned as soon as no continuation can match.
+//!
+struct _LwLevenshtein {
+  gunichar *pattern;
+  gint length;                   //!< Characters in the pattern
+  gint max_distance;
+};
+typedef struct _LwLevenshtein LwLevenshtein;
+
+LwLevenshtein* lw_levenshtein_new (const gchar*, gint);
+void lw_levenshtein_free (LwLevenshtein*);
+void lw_levenshtein_init (LwLevenshtein*, const gchar*, gint);
+void lw_levenshtein_deinit (LwLevenshtein*);
+
+gint lw_levenshtein_get_state_size (LwLevenshtein*);
+void lw_levenshtein_start (LwLevenshtein*, gint*);
+gboolean lw_levenshtein_step (LwLevenshtein*, const gint*, gunichar, gint*);
+gint lw_levenshtein_get_distance (LwLevenshtein*, const gint*);
+gint lw_levenshtein_match (LwLevenshtein*, const gchar*);
+
+#endif
@@ -10,18 +10,29 @@
 #include <libwaei/utilities.h>
 #include <libwaei/io.h>
 #include <libwaei/preferences.h>
+#include <libwaei/ahocorasick.h>
 #include <libwaei/vocabularyitem.h>
 #include <libwaei/vocabularylist.h>
 #include <libwaei/dict.h>
 #include <libwaei/dictinfo.h>
+#include <libwaei/dictmanifest.h>
 #include <libwaei/dictinfolist.h>
 #include <libwaei/dictinst.h>
 #include <libwaei/dictinstlist.h>
 #include <libwaei/resultline.h>
+#include <libwaei/resultlist.h>
 #include <libwaei/queryline.h>
 #include <libwaei/searchitem.h>
 #include <libwaei/engine.h>
 #include <libwaei/history.h>
+#include <libwaei/strokedb.h>
+#include <libwaei/spellindex.h>
+#include <libwaei/levenshtein.h>
+#include <libwaei/cachefile.h>
+#include <libwaei/termindex.h>
+#include <libwaei/batchlookup.h>
+#include <libwaei/headwordtrie.h>
+#include <libwaei/textanalyzer.h>
 
 
 #endif
@@ -22,6 +22,8 @@
 #define LW_KEY_SPELLCHECK          "query-spellcheck"
 #define LW_KEY_SEARCH_AS_YOU_TYPE  "search-as-you-type"
 #define LW_KEY_WINDOW_POSITIONS    "window-positions"
+#define LW_KEY_RESULTS_LIST_VIEW   "results-list-view"
+#define LW_KEY_KANJIPAD_ENGINE_PROCESS "kanjipad-engine-process"
 
 //////////////////////////
 #define LW_SCHEMA_FONT               "org.gnome.gwaei.fonts"
@@ -49,6 +51,7 @@
 #define LW_KEY_KANJI_SOURCE        "kanji-source"
 #define LW_KEY_NAMES_PLACES_SOURCE "names-places-source"
 #define LW_KEY_EXAMPLES_SOURCE     "examples-source"
+#define LW_KEY_NAMES_PLACES_SPLIT  "names-places-split"
 #define LW_KEY_LOAD_ORDER          "load-order"
 
 #define LW_PREFMANAGER(object) (LwPreferences*) object
@@ -3,6 +3,8 @@
 
 #define LW_QUERYLINE(object) (LwQueryLine*) object
 #define LW_QUERYLINE_MAX_ATOMS 20
+#define LW_QUERYLINE_FUZZY_MARKER '~'     //!< Ends a query that should be matched approximately, optionally followed by the max distance
+#define LW_QUERYLINE_FUZZY_DISTANCE 2     //!< Max distance of a fuzzy query that doesn't give one.  Short words get less.
 
 struct _LwQueryLine {
     //Storage for the original query string
@@ -19,6 +21,14 @@ struct _LwQueryLine {
     GRegex*** re_frequency;
     GRegex*** re_grade;
     GRegex*** re_jlpt;
+
+    //Literal romaji atoms found together in one pass over a line
+    LwAhoCorasick *roma_literals;  //!< Alternatives of each romaji atom with its index as data or NULL if an atom needs its regexes
+    guint32 roma_literals_mask;    //!< A bit set for each romaji atom, what a line must match for all of them to be found
+
+    //Fuzzy search of the term index
+    char **fuzzy;          //!< Lowercased words and hiragana readings to match approximately or NULL
+    int fuzzy_distance;    //!< Most edits a fuzzy match can be from one of them or -1 to go by their length
 };
 typedef struct _LwQueryLine LwQueryLine;
 
@@ -33,4 +43,6 @@ int lw_queryline_parse_kanjidict_string (LwQueryLine*, LwPreferences*, const cha
 int lw_queryline_parse_exampledict_string (LwQueryLine*, LwPreferences*, const char*, GError**);
 int lw_queryline_parse_edict_string (LwQueryLine*, LwPreferences*, const char*, GError**);
 
+int lw_queryline_get_fuzzy_distance (LwQueryLine*, const char*);
+
 #endif
@@ -42,6 +42,34 @@ typedef enum {
   TOTAL_RESULTLINE_RELEVANCE
 } LwResultLineRelevance;
 
+//!
+//! @brief The parsed fields of a LwResultLine that a match span can point into
+//!
+typedef enum {
+  LW_RESULTLINE_FIELD_STRING,      //!< The whole unparsed string of an unknown dictionary
+  LW_RESULTLINE_FIELD_KANJI,       //!< kanji_start
+  LW_RESULTLINE_FIELD_FURIGANA,    //!< furigana_start
+  LW_RESULTLINE_FIELD_DEFINITION,  //!< def_start[index]
+  LW_RESULTLINE_FIELD_CHARACTER,   //!< The kanji of a kanjidict entry
+  LW_RESULTLINE_FIELD_RADICALS,    //!< radicals
+  LW_RESULTLINE_FIELD_READING,     //!< readings[index]
+  LW_RESULTLINE_FIELD_MEANINGS,    //!< meanings
+  TOTAL_RESULTLINE_FIELDS
+} LwResultLineField;
+
+#define LW_RESULTLINE_MAX_MATCHES 64
+
+//!
+//! @brief Where a query atom matched inside of a field in bytes
+//!
+struct _LwResultLineMatch {
+    guint8 field;               //!< The LwResultLineField the span is in
+    guint8 index;               //!< Index of the definition or reading for fields that have many
+    guint16 start;              //!< Byte offset of the start of the match from the start of the field
+    guint16 end;                //!< Byte offset of the end of the match from the start of the field
+};
+typedef struct _LwResultLineMatch LwResultLineMatch;
+
 //!
 //! @brief Primitive for storing lists of dictionaries
 //!
@@ -70,6 +98,10 @@ struct _LwResultLine {
 
     gboolean important; //!< Weather a word/phrase has a high frequency of usage.
 
+    //Match spans
+    LwResultLineMatch matches[LW_RESULTLINE_MAX_MATCHES]; //!< Filled in by the search engine when a line is accepted
+    int match_total;                                      //!< Number of used matches
+
 };
 typedef struct _LwResultLine LwResultLine;
 
@@ -87,4 +119,8 @@ void lw_resultline_parse_unknowndict_result_string (LwResultLine*);
 
 gboolean lw_resultline_is_similar (LwResultLine *rl1, LwResultLine *rl2);
 
+const char* lw_resultline_get_field (LwResultLine*, LwResultLineField, int);
+void lw_resultline_clear_matches (LwResultLine*);
+gboolean lw_resultline_add_match (LwResultLine*, LwResultLineField, int, int, int);
+
 #endif
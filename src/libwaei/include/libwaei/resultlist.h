@@ -0,0 +1,27 @@
+#ifndef LW_RESULTLIST_INCLUDED
+#define LW_RESULTLIST_INCLUDED
+
+#define LW_RESULTLIST(object) (LwResultList*) object
+
+//!
+//! @brief Stores search results in a compact form.  A LwResultLine reserves a
+//!        full line buffer while an entry here only keeps the bytes in use.
+//!
+struct _LwResultList {
+  GPtrArray *entries;       //!< The compacted results in the order they were appended
+  gsize size;               //!< Bytes used by the entries
+};
+typedef struct _LwResultList LwResultList;
+
+LwResultList* lw_resultlist_new (void);
+void lw_resultlist_free (LwResultList*);
+void lw_resultlist_init (LwResultList*);
+void lw_resultlist_deinit (LwResultList*);
+
+void lw_resultlist_clear (LwResultList*);
+guint lw_resultlist_append (LwResultList*, LwResultLine*);
+gboolean lw_resultlist_get (LwResultList*, guint, LwResultLine*);
+guint lw_resultlist_length (LwResultList*);
+gsize lw_resultlist_get_size (LwResultList*);
+
+#endif
@@ -30,6 +30,7 @@
 //!
 
 #include <stdio.h>
+#include <time.h>
 
 #include <libwaei/queryline.h>
 #include <libwaei/resultline.h>
@@ -52,12 +53,46 @@ typedef enum
 
 typedef void(*LwSearchItemDataFreeFunc)(gpointer);
 
+//!
+//! @brief The parts of a result line a query regex can be run against
+//!
+typedef enum
+{
+  LW_SEARCHFIELD_KANJI,
+  LW_SEARCHFIELD_FURIGANA,
+  LW_SEARCHFIELD_ROMAJI,
+  LW_SEARCHFIELD_MIX,
+  LW_SEARCHFIELD_FILTER,                     //!< Kanji stroke, grade, frequency and jlpt fields
+  LW_SEARCHFIELD_TOTAL
+} LwSearchField;
+
+//!
+//! @brief Counters collected while a search runs.  Times are in seconds.
+//!
+struct _LwSearchStats {
+    glong lines_scanned;                    //!< Lines read from the dictionary file
+    glong bytes_read;                       //!< Bytes read from the dictionary file
+    glong comment_lines_skipped;            //!< Lines skipped because they were comments
+    glong terms_matched;                    //!< Terms of the term index a fuzzy query matched
+    glong literal_scans;                    //!< Definitions scanned for literal romaji atoms instead of regexes
+    glong regex_evaluations[LW_RELEVANCE_TOTAL]; //!< Regex matches run per relevance tier
+    glong field_evaluations[LW_SEARCHFIELD_TOTAL]; //!< Regex matches run per field category
+    gint results_accepted;                  //!< Matches added to the result lists
+    gint results_dropped;                   //!< Matches thrown away because a result cap was reached
+    gdouble compile_time;                   //!< Time spent parsing the query into regexes
+    gdouble first_result_time;              //!< Time from the search start to the first result or -1.0
+    gdouble wall_time;                      //!< Time from the search start to the end
+    gdouble cpu_time;                       //!< Processor time used by the process during the search
+};
+typedef struct _LwSearchStats LwSearchStats;
+
 //!
 //! @brief Primitive for storing search item information
 //!
 //Object
 struct _LwSearchItem {
     LwQueryLine* queryline;                 //!< Result line to store parsed result
+    gboolean shares_queryline;              //!< The queryline belongs to someone else and isn't freed with the item
     LwDictInfo* dictionary;                 //!< Pointer to the dictionary used
 
     FILE* fd;                               //!< File descriptor for file search position
@@ -79,13 +114,22 @@ struct _LwSearchItem {
 
     LwResultLine* resultline;               //!< Result line to store parsed result
 
+    LwSearchStats stats;                    //!< Instrumentation counters for the last search
+    GTimer *timer;                          //!< Measures the wall time of the stats
+    clock_t clock_start;                    //!< Processor time when the search started
+
+    GSList *sources;                        //!< Attached watch sources to wake up when there are new results
+
     gpointer data;                 //!< Pointer to a buffer that stays constant unlike when the target attribute is used
     LwSearchItemDataFreeFunc free_data_func;
 };
 typedef struct _LwSearchItem LwSearchItem;
 
+typedef gboolean(*LwSearchItemWatchFunc)(LwSearchItem*, gpointer);
+
 //Methods
 LwSearchItem* lw_searchitem_new (const char*, LwDictInfo*, LwPreferences*, GError**);
+LwSearchItem* lw_searchitem_new_with_queryline (LwQueryLine*, LwDictInfo*);
 void lw_searchitem_free (LwSearchItem*);
 void lw_searchitem_init (LwSearchItem*, const char*, LwDictInfo*, LwPreferences*, GError**);
 void lw_searchitem_deinit (LwSearchItem*);
@@ -108,11 +152,19 @@ gboolean lw_searchitem_should_check_results (LwSearchItem*);
 LwResultLine* lw_searchitem_get_result (LwSearchItem*);
 void lw_searchitem_parse_result_string (LwSearchItem*);
 void lw_searchitem_cancel_search (LwSearchItem*);
+gboolean lw_searchitem_has_result (LwSearchItem*);
+
+GSource* lw_searchitem_source_new (LwSearchItem*);
+guint lw_searchitem_add_watch (LwSearchItem*, GMainContext*, LwSearchItemWatchFunc, gpointer, GDestroyNotify);
+void lw_searchitem_notify_sources (LwSearchItem*);
 
 void lw_searchitem_lock_mutex (LwSearchItem*);
 void lw_searchitem_unlock_mutex (LwSearchItem*);
 
 double lw_searchitem_get_progress (LwSearchItem*);
+void lw_searchitem_get_stats (LwSearchItem*, LwSearchStats*);
+void lw_searchitem_stats_begin (LwSearchItem*);
+void lw_searchitem_stats_end (LwSearchItem*);
 
 
 
@@ -0,0 +1,50 @@
+#ifndef LW_SPELLINDEX_INCLUDED
+#define LW_SPELLINDEX_INCLUDED
+
+#define LW_SPELLINDEX(object) (LwSpellIndex*) object
+
+#define LW_SPELLINDEX_MIN_WORD_LENGTH 2     //!< Shorter gloss words are not indexed
+#define LW_SPELLINDEX_MAX_WORD_LENGTH 32    //!< Longer gloss words are not indexed
+#define LW_SPELLINDEX_PREFIX_LENGTH 7       //!< Deletes are only made from this many leading letters
+#define LW_SPELLINDEX_MAX_DISTANCE 2        //!< Most edits a suggestion can be away from the word
+
+//!
+//! @brief One delete of a word, a hash of the letters left and the word it came from
+//!
+struct _LwSpellIndexDelete {
+  guint32 hash;
+  guint32 word;
+};
+typedef struct _LwSpellIndexDelete LwSpellIndexDelete;
+
+//!
+//! @brief Spelling suggestions from the English glosses of the installed
+//!        dictionaries so a suggestion is always something a search will find.
+//!        The words are indexed by every string that is left after deleting up to
+//!        LW_SPELLINDEX_MAX_DISTANCE letters, so a lookup only has to make the deletes
+//!        of the looked up word instead of every edit of it.
+//!
+struct _LwSpellIndex {
+  GMutex *mutex;
+  gboolean loaded;
+  GStringChunk *strings;
+  GPtrArray *words;               //!< The word of each id
+  GArray *counts;                 //!< How many times each word was seen, as guint
+  GHashTable *ids;                //!< Word to id + 1
+  LwSpellIndexDelete *deletes;    //!< Sorted by hash
+  gsize total_deletes;
+};
+typedef struct _LwSpellIndex LwSpellIndex;
+
+LwSpellIndex* lw_spellindex_new (void);
+void lw_spellindex_free (LwSpellIndex*);
+void lw_spellindex_init (LwSpellIndex*);
+void lw_spellindex_deinit (LwSpellIndex*);
+
+gboolean lw_spellindex_load (LwSpellIndex*, gchar**, GError**);
+void lw_spellindex_clear (LwSpellIndex*);
+gboolean lw_spellindex_is_loaded (LwSpellIndex*);
+gboolean lw_spellindex_has_word (LwSpellIndex*, const gchar*);
+GList* lw_spellindex_lookup (LwSpellIndex*, const gchar*, gint);
+
+#endif
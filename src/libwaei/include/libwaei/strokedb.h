@@ -0,0 +1,96 @@
+#ifndef LW_STROKEDB_INCLUDED
+#define LW_STROKEDB_INCLUDED
+
+#define LW_STROKEDB(object) (LwStrokeDB*) object
+
+#define LW_STROKEDB_ERROR "gWaei Stroke Database Error"
+
+typedef enum {
+  LW_STROKEDB_ERROR_CORRUPT
+} LwStrokeDBError;
+
+#define LW_STROKEDB_MAX_STROKES 32        //!< Largest stroke count that the database has characters for
+#define LW_STROKEDB_MAX_POINTS 256        //!< Points kept per stroke.  Extra points are dropped.
+#define LW_STROKEDB_DEFAULT_CANDIDATES 5  //!< Candidates kpengine has always answered with
+#define LW_STROKEDB_MAX_THREADS 4         //!< Most threads one recognition is split over
+#define LW_STROKEDB_MIN_THREAD_LOAD 128   //!< Fewest characters worth giving a thread of its own
+
+//!
+//! @brief A stroke drawn by the user.  The coordinates are screen coordinates.
+//!
+struct _LwStroke {
+  guint length;
+  guint8 x[LW_STROKEDB_MAX_POINTS];
+  guint8 y[LW_STROKEDB_MAX_POINTS];
+};
+typedef struct _LwStroke LwStroke;
+
+//!
+//! @brief A recognized character and how far it was from the strokes.  Lower scores are better.
+//!
+struct _LwStrokeDBCandidate {
+  guchar jis[2];                          //!< The character as a JIS X 0208 row and cell
+  gulong score;
+  gint strokes;                           //!< Stroke count of the character.  More than were drawn for a prediction.
+};
+typedef struct _LwStrokeDBCandidate LwStrokeDBCandidate;
+
+//!
+//! @brief The characters with one stroke count, decoded from jdata.dat into
+//!        parallel arrays.  The direction codes of stroke s of character c are
+//!        paths[path_offsets[c * strokes + s]] up to the next offset, and its
+//!        extra filters are filter_offsets[c] to filter_offsets[c + 1] in filters.
+//!
+struct _LwStrokeDBTable {
+  gint total;               //!< The number of characters
+  gint strokes;
+  guchar *jis;              //!< Two bytes per character as a JIS X 0208 row and cell
+  guint *path_offsets;      //!< total * strokes + 1 offsets into paths
+  gchar *paths;             //!< Direction codes in 32nds of a circle
+  guint *filter_offsets;    //!< total + 1 offsets into filters
+  guint8 *filters;          //!< Decoded extra filters of five bytes each
+};
+typedef struct _LwStrokeDBTable LwStrokeDBTable;
+
+//!
+//! @brief The jstroke handwriting database, jdata.dat.  It is decoded once at
+//!        load and only read after that so any number of threads can recognize
+//!        with it at once.
+//!
+struct _LwStrokeDB {
+  LwStrokeDBTable tables[LW_STROKEDB_MAX_STROKES + 1];  //!< Characters for each stroke count
+};
+typedef struct _LwStrokeDB LwStrokeDB;
+
+//!
+//! @brief Recognizes strokes as they are drawn.  The summed squared stroke scores of
+//!        every character with at least as many strokes are kept so each new stroke
+//!        is the only one scored.  Characters with more strokes are ranked by the
+//!        strokes they have so far.
+//!
+struct _LwStrokeDBSession {
+  LwStrokeDB *db;
+  LwStroke strokes[LW_STROKEDB_MAX_STROKES];
+  gint total_strokes;
+  gulong *sums[LW_STROKEDB_MAX_STROKES + 1];  //!< For each table, the partial sum of each character
+};
+typedef struct _LwStrokeDBSession LwStrokeDBSession;
+
+LwStrokeDB* lw_strokedb_new (const char*, GError**);
+void lw_strokedb_free (LwStrokeDB*);
+void lw_strokedb_init (LwStrokeDB*, const char*, GError**);
+void lw_strokedb_deinit (LwStrokeDB*);
+
+gchar* lw_strokedb_get_default_path (void);
+gint lw_strokedb_recognize (LwStrokeDB*, const LwStroke*, gint, LwStrokeDBCandidate*, gint);
+
+LwStrokeDBSession* lw_strokedb_session_new (LwStrokeDB*);
+void lw_strokedb_session_free (LwStrokeDBSession*);
+void lw_strokedb_session_init (LwStrokeDBSession*, LwStrokeDB*);
+void lw_strokedb_session_deinit (LwStrokeDBSession*);
+
+void lw_strokedb_session_clear (LwStrokeDBSession*);
+gboolean lw_strokedb_session_add_stroke (LwStrokeDBSession*, const LwStroke*);
+gint lw_strokedb_session_get_candidates (LwStrokeDBSession*, LwStrokeDBCandidate*, gint);
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef LW_TERMINDEX_INCLUDED
+#define LW_TERMINDEX_INCLUDED
+
+#define LW_TERMINDEX(object) (LwTermIndex*) object
+
+#define LW_TERMINDEX_MAGIC 0x4954574cU       //!< "LWTI" in the byte order of the machine that wrote it
+#define LW_TERMINDEX_VERSION 1
+#define LW_TERMINDEX_MIN_TERM_LENGTH 2       //!< Shorter terms are in too many lines to be worth indexing
+#define LW_TERMINDEX_MAX_TERM_LENGTH 32      //!< Longest indexed term in characters
+
+//!
+//! @brief The start of a term index file.  The term offsets, the posting
+//!        offsets and the postings follow as guint32 arrays, then the
+//!        NUL terminated terms.
+//!
+struct _LwTermIndexHeader {
+  LwCacheFileHeader file;
+  guint32 total_terms;
+  guint32 total_postings;
+  guint32 strings_length;
+  guint32 reserved;
+};
+typedef struct _LwTermIndexHeader LwTermIndexHeader;
+
+//!
+//! @brief A term found by a fuzzy lookup and its edit distance from the query
+//!
+struct _LwTermIndexMatch {
+  guint32 term;
+  gint distance;
+};
+typedef struct _LwTermIndexMatch LwTermIndexMatch;
+
+//!
+//! @brief A sorted dictionary of the lowercased gloss words and hiragana readings
+//!        of an EDICT dictionary with the byte offsets of the lines each one is in.
+//!        It is written to the cache folder when the dictionary is installed
+//!        and memory mapped for fuzzy searches.
+//!
+struct _LwTermIndex {
+  GMappedFile *file;
+  const LwTermIndexHeader *header;
+  const guint32 *terms;           //!< total_terms + 1 offsets into strings
+  const guint32 *posting_offsets; //!< total_terms + 1 offsets into postings
+  const guint32 *postings;        //!< Byte offsets of dictionary lines
+  const gchar *strings;
+};
+typedef struct _LwTermIndex LwTermIndex;
+
+//!
+//! @brief The terms of a dictionary and the lines they are in while its term index is built
+//!
+struct _LwTermIndexBuilder {
+  GHashTable *table;              //!< A GArray of line offsets for each term
+  GStringChunk *strings;          //!< The terms
+  guint32 offset;                 //!< Byte offset of the next line
+};
+typedef struct _LwTermIndexBuilder LwTermIndexBuilder;
+
+LwTermIndex* lw_termindex_new (LwDictType, const gchar*, GError**);
+void lw_termindex_free (LwTermIndex*);
+
+LwTermIndexBuilder* lw_termindex_builder_new (void);
+void lw_termindex_builder_free (LwTermIndexBuilder*);
+gboolean lw_termindex_builder_add_line (const gchar*, gsize, gpointer);
+gboolean lw_termindex_builder_write (LwTermIndexBuilder*, LwDictType, const gchar*, GError**);
+
+gboolean lw_termindex_build (LwDictType, const gchar*, GError**);
+void lw_termindex_remove (LwDictType, const gchar*);
+
+guint32 lw_termindex_get_total_terms (LwTermIndex*);
+const gchar* lw_termindex_get_term (LwTermIndex*, guint32);
+const guint32* lw_termindex_get_postings (LwTermIndex*, guint32, guint32*);
+void lw_termindex_find_fuzzy (LwTermIndex*, LwLevenshtein*, GArray*);
+
+gboolean lw_termindex_normalize_reading (gchar*);
+
+#endif
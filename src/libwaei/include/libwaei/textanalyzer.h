@@ -0,0 +1,48 @@
+#ifndef LW_TEXTANALYZER_INCLUDED
+#define LW_TEXTANALYZER_INCLUDED
+
+#define LW_TEXTANALYZER(object) (LwTextAnalyzer*) object
+
+#define LW_TEXTANALYZER_ERROR "gWaei Text Analyzer Error"
+
+typedef enum {
+  LW_TEXTANALYZER_ERROR_UNSUPPORTED
+} LwTextAnalyzerError;
+
+#define LW_TEXTANALYZER_MAX_ENTRIES 8      //!< Most dictionary entries kept for a segment
+#define LW_TEXTANALYZER_MAX_CANDIDATES 32  //!< Most dictionary lines ranked for a segment to choose them from
+
+//!
+//! @brief A piece of an analyzed text and the dictionary entries for it.  The
+//!        entries are kept as line offsets so only the ones that are shown
+//!        get parsed, with lw_textanalyzer_read_entry.
+//!
+struct _LwTextSegment {
+  gchar *text;                                  //!< The text of the segment
+  gsize offset;                                 //!< Byte offset of the segment in the analyzed text
+  guint32 entries[LW_TEXTANALYZER_MAX_ENTRIES]; //!< Lines with the text as a headword or reading, best first
+  gint total_entries;                           //!< 0 for text no entry starts
+};
+typedef struct _LwTextSegment LwTextSegment;
+
+//!
+//! @brief Splits a text into the longest headwords and readings of an EDICT
+//!        dictionary it is made of, using the headword trie of the dictionary
+//!        and reading the entries of each piece straight from their offsets.
+//!
+struct _LwTextAnalyzer {
+  LwDictInfo *di;
+  LwHeadwordTrie *trie;
+  GMappedFile *file;        //!< The dictionary the postings of the trie point into
+};
+typedef struct _LwTextAnalyzer LwTextAnalyzer;
+
+LwTextAnalyzer* lw_textanalyzer_new (LwDictInfo*, GError**);
+void lw_textanalyzer_free (LwTextAnalyzer*);
+
+GList* lw_textanalyzer_analyze (LwTextAnalyzer*, const gchar*);
+gboolean lw_textanalyzer_read_entry (LwTextAnalyzer*, guint32, LwResultLine*);
+
+void lw_textsegment_free (LwTextSegment*);
+
+#endif
@@ -11,6 +11,7 @@ typedef enum {
 
 struct _LwVocabularyItem {
   gchar *fields[TOTAL_LW_VOCABULARYITEM_FIELDS];
+  guint id;                     //!< Names the item in the journal of its LwVocabularyList
 };
 
 typedef struct _LwVocabularyItem LwVocabularyItem;
@@ -21,6 +22,9 @@ LwVocabularyItem* lw_vocabularyitem_new ();
 LwVocabularyItem* lw_vocabularyitem_new_from_string (const gchar*);
 void lw_vocabularyitem_free (LwVocabularyItem*);
 
+void lw_vocabularyitem_set_field (LwVocabularyItem*, LwVocabularyItemField, const gchar*);
+const gchar* lw_vocabularyitem_get_field (LwVocabularyItem*, LwVocabularyItemField);
+
 void lw_vocabularyitem_set_kanji (LwVocabularyItem*, const gchar*);
 const gchar* lw_vocabularyitem_get_kanji (LwVocabularyItem*);
 
@@ -1,9 +1,25 @@
 #ifndef LW_VOCABULARYLIST_INCLUDED
 #define LW_VOCABULARYLIST_INCLUDED
 
+#define LW_VOCABULARYLIST_JOURNAL_HEADER "#LWJ1"             //!< First word of a journal file
+#define LW_VOCABULARYLIST_JOURNAL_SUFFIX ".journal"
+#define LW_VOCABULARYLIST_MIN_COMPACTION_RECORDS 256      //!< Journals are never compacted before this many records
+
+//!
+//! @brief A vocabulary list and the edits made to it since it was last written.
+//!        The list file is only rewritten when the journal of edits next to it
+//!        grows past the length of the list, so saving a few edits only appends
+//!        those few records.
+//!
 struct _LwVocabularyList {
   gchar *name;
-  GList *items;
+  GQueue *items;                //!< The LwVocabularyItems in their order
+  GHashTable *links;            //!< Item id to its GList link in items
+  guint next_id;
+  GString *journal;             //!< Records of the edits since the last save
+  gint pending_records;         //!< Records in journal
+  gint total_records;           //!< Records already in the journal file
+  gboolean compact;             //!< Rewrite the list file on the next save
   gboolean changed;
   gdouble progress;
 };
@@ -13,10 +29,24 @@ typedef struct _LwVocabularyList LwVocabularyList;
 #define LW_VOCABULARYLIST(obj) (LwVocabularyList*)obj
 
 gchar** lw_vocabularylist_get_lists ();
+gboolean lw_vocabularylist_is_journal_filename (const gchar*);
+gchar* lw_vocabularylist_get_name_from_filename (const gchar*);
+
 LwVocabularyList* lw_vocabularylist_new (const gchar*);
 void lw_vocabularylist_free (LwVocabularyList*);
 
 void lw_vocabularylist_save (LwVocabularyList*, LwIoProgressCallback);
 void lw_vocabularylist_load (LwVocabularyList*, LwIoProgressCallback);
 
+void lw_vocabularylist_insert_after (LwVocabularyList*, LwVocabularyItem*, LwVocabularyItem*);
+void lw_vocabularylist_remove (LwVocabularyList*, LwVocabularyItem*);
+void lw_vocabularylist_set_field (LwVocabularyList*, LwVocabularyItem*, LwVocabularyItemField, const gchar*);
+
+void lw_vocabularylist_set_name (LwVocabularyList*, const gchar*);
+const gchar* lw_vocabularylist_get_name (LwVocabularyList*);
+GList* lw_vocabularylist_get_items (LwVocabularyList*);
+gint lw_vocabularylist_get_length (LwVocabularyList*);
+void lw_vocabularylist_set_changed (LwVocabularyList*, gboolean);
+gboolean lw_vocabularylist_changed (LwVocabularyList*);
+
 #endif
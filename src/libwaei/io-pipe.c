@@ -0,0 +1,235 @@
+/******************************************************************************
+    AUTHOR:
+    File written and Copyrighted by Zachary Dovel. All Rights Reserved.
+
+    LICENSE:
+    This file is part of gWaei.
+
+    gWaei is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    gWaei is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    
+    You should have received a copy of the GNU General Public License
+    along with gWaei.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+//!
+//! @file io-pipe.c
+//! @brief A bounded queue of data chunks used to connect the stages of a
+//!        streaming io operation running on separate threads.  Writers block
+//!        when the pipe is full so a fast stage can never run away with memory.
+//!
+
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <glib.h>
+
+#include <libwaei/libwaei.h>
+
+#include <libwaei/io-pipe.h>
+
+
+//!
+//! @brief Creates a new LwIoPipe object
+//! @param max The number of chunks that can be queued before lw_iopipe_push blocks
+//! @return An allocated LwIoPipe that will be needed to be freed by lw_iopipe_free.
+//!
+LwIoPipe* 
+lw_iopipe_new (guint max)
+{
+    LwIoPipe *temp;
+
+    temp = (LwIoPipe*) malloc(sizeof(LwIoPipe));
+
+    if (temp != NULL)
+    {
+      temp->queue = g_queue_new ();
+      temp->mutex = g_mutex_new ();
+      temp->not_empty = g_cond_new ();
+      temp->not_full = g_cond_new ();
+      temp->max = (max > 0) ? max : 1;
+      temp->closed = FALSE;
+      temp->aborted = FALSE;
+    }
+
+    return temp;
+}
+
+
+//!
+//! @brief Releases a LwIoPipe object from memory along with any chunks still queued.
+//!        No thread should be using the pipe when this is called.
+//! @param pipe A LwIoPipe object created by lw_iopipe_new.
+//!
+void 
+lw_iopipe_free (LwIoPipe *pipe)
+{
+    //Declarations
+    LwIoPipeChunk *chunk;
+
+    while ((chunk = g_queue_pop_head (pipe->queue)) != NULL)
+      lw_iopipe_chunk_free (chunk);
+
+    g_queue_free (pipe->queue);
+    g_mutex_free (pipe->mutex);
+    g_cond_free (pipe->not_empty);
+    g_cond_free (pipe->not_full);
+
+    free (pipe);
+}
+
+
+//!
+//! @brief Creates a new empty LwIoPipeChunk
+//! @return An allocated LwIoPipeChunk that will be needed to be freed by lw_iopipe_chunk_free.
+//!
+LwIoPipeChunk* 
+lw_iopipe_chunk_new ()
+{
+    LwIoPipeChunk *temp;
+
+    temp = (LwIoPipeChunk*) malloc(sizeof(LwIoPipeChunk));
+
+    if (temp != NULL)
+    {
+      temp->length = 0;
+      temp->offset = 0;
+    }
+
+    return temp;
+}
+
+
+//!
+//! @brief Releases a LwIoPipeChunk object from memory.
+//! @param chunk A LwIoPipeChunk object created by lw_iopipe_chunk_new.
+//!
+void 
+lw_iopipe_chunk_free (LwIoPipeChunk *chunk)
+{
+    free (chunk);
+}
+
+
+//!
+//! @brief Hands a chunk off to the next stage, waiting for room if the pipe is full.
+//!        The pipe takes ownership of the chunk, even if the push fails.
+//! @param pipe The LwIoPipe to push to
+//! @param chunk The LwIoPipeChunk to queue
+//! @returns FALSE if the pipe was aborted and the chunk was dropped
+//!
+gboolean 
+lw_iopipe_push (LwIoPipe *pipe, LwIoPipeChunk *chunk)
+{
+    //Declarations
+    gboolean queued;
+
+    g_mutex_lock (pipe->mutex);
+
+    while (pipe->aborted == FALSE && g_queue_get_length (pipe->queue) >= pipe->max)
+      g_cond_wait (pipe->not_full, pipe->mutex);
+
+    queued = (pipe->aborted == FALSE);
+    if (queued)
+    {
+      g_queue_push_tail (pipe->queue, chunk);
+      g_cond_signal (pipe->not_empty);
+    }
+
+    g_mutex_unlock (pipe->mutex);
+
+    if (!queued) lw_iopipe_chunk_free (chunk);
+
+    return queued;
+}
+
+
+//!
+//! @brief Takes the next chunk from the pipe, waiting for one if the pipe is empty.
+//! @param pipe The LwIoPipe to pop from
+//! @returns A LwIoPipeChunk that the caller now owns or NULL when the pipe was
+//!          closed and drained, or aborted.
+//!
+LwIoPipeChunk* 
+lw_iopipe_pop (LwIoPipe *pipe)
+{
+    //Declarations
+    LwIoPipeChunk *chunk;
+
+    //Initializations
+    chunk = NULL;
+
+    g_mutex_lock (pipe->mutex);
+
+    while (pipe->aborted == FALSE && pipe->closed == FALSE && g_queue_is_empty (pipe->queue))
+      g_cond_wait (pipe->not_empty, pipe->mutex);
+
+    if (pipe->aborted == FALSE)
+    {
+      chunk = g_queue_pop_head (pipe->queue);
+      g_cond_signal (pipe->not_full);
+    }
+
+    g_mutex_unlock (pipe->mutex);
+
+    return chunk;
+}
+
+
+//!
+//! @brief Marks that the writing stage is done.  Queued chunks can still be popped.
+//! @param pipe The LwIoPipe to close
+//!
+void 
+lw_iopipe_close (LwIoPipe *pipe)
+{
+    g_mutex_lock (pipe->mutex);
+    pipe->closed = TRUE;
+    g_cond_broadcast (pipe->not_empty);
+    g_mutex_unlock (pipe->mutex);
+}
+
+
+//!
+//! @brief Wakes up both ends of the pipe and makes them give up.  Used for
+//!        errors and cancellation.
+//! @param pipe The LwIoPipe to abort
+//!
+void 
+lw_iopipe_abort (LwIoPipe *pipe)
+{
+    g_mutex_lock (pipe->mutex);
+    pipe->aborted = TRUE;
+    g_cond_broadcast (pipe->not_empty);
+    g_cond_broadcast (pipe->not_full);
+    g_mutex_unlock (pipe->mutex);
+}
+
+
+//!
+//! @brief Checks if the pipe was aborted by one of its stages
+//! @param pipe The LwIoPipe to check
+//! @returns TRUE if lw_iopipe_abort was called on the pipe
+//!
+gboolean 
+lw_iopipe_is_aborted (LwIoPipe *pipe)
+{
+    //Declarations
+    gboolean aborted;
+
+    g_mutex_lock (pipe->mutex);
+    aborted = pipe->aborted;
+    g_mutex_unlock (pipe->mutex);
+
+    return aborted;
+}
+
@@ -28,13 +28,19 @@
 #include <stdio.h>
 #include <string.h>
 #include <locale.h>
+#include <errno.h>
 
 #include <glib.h>
 #include <glib/gstdio.h>
+#ifdef G_OS_UNIX
+#include <sys/wait.h>
+#endif
 #include <curl/curl.h>
 
 #include <libwaei/libwaei.h>
 
+#include <libwaei/io-pipe.h>
+
 
 static gchar *_savepath = NULL;
 static gboolean _cancel = FALSE;
@@ -121,6 +127,497 @@ lw_io_write_file (const char* PATH, const char* mode, gchar *text, LwIoProgressC
 }
 
 
+//!
+//! @brief Used for passing data between the threads of a streaming io operation
+//!
+struct _LwIoStreamData {
+  const char *uri;                //!< The file path being read
+  LwCompression compression;      //!< The compression of the file being read
+  const char *source_encoding;    //!< The encoding of the file or NULL if no conversion is needed
+  const char *target_encoding;    //!< The wanted encoding of the lines
+  LwIoPipe *raw;                  //!< Connects the reader to the converter
+  LwIoPipe *text;                 //!< Connects the converter to the line handler
+  GError *read_error;             //!< An error from the reader thread
+  GError *convert_error;          //!< An error from the converter thread
+};
+typedef struct _LwIoStreamData LwIoStreamData;
+
+
+//!
+//! @brief Estimates how many bytes a stream of the file will produce
+//!        so the progress can be calculated.  For gzip files this is read
+//!        from the size field at the end of the file.
+//! @param URI The path to the file
+//! @param COMPRESSION The compression of the file
+//! @returns The expected size of the stream in bytes
+//!
+static gsize 
+_io_stream_get_expected_size (const char *URI, const LwCompression COMPRESSION)
+{
+    //Declarations
+    FILE *file;
+    guchar trailer[4];
+    gsize size;
+
+    //Initializations
+    size = 0;
+
+    if (COMPRESSION == LW_COMPRESSION_GZIP)
+    {
+      file = fopen (URI, "rb");
+      if (file != NULL)
+      {
+        if (fseek (file, -4L, SEEK_END) == 0 && fread (trailer, sizeof(guchar), 4, file) == 4)
+          size = ((gsize) trailer[0])       | ((gsize) trailer[1] << 8) | 
+                 ((gsize) trailer[2] << 16) | ((gsize) trailer[3] << 24);
+        fclose (file);
+      }
+    }
+    else
+    {
+      size = lw_io_get_size_for_uri (URI);
+    }
+
+    return size;
+}
+
+
+//!
+//! @brief First stage of a stream.  Reads the file, decompressing it if needed,
+//!        and pushes the raw data in chunks to the next stage.
+//! @param data A pointer to a LwIoStreamData object
+//! @returns Returns if there was an error
+//!
+static gpointer 
+_io_stream_read_func (gpointer data)
+{
+    //Declarations
+    LwIoStreamData *sd;
+    LwIoPipeChunk *chunk;
+    FILE *file;
+    gchar *argv[] = { GZIP, "-cd", NULL, NULL };
+    gint stdout_fd;
+    GPid pid;
+    gboolean spawned;
+    gboolean finished;
+    gint status;
+    GPid waited;
+    gsize offset;
+    const char *message;
+    GQuark domain;
+
+    //Initializations
+    sd = data;
+    file = NULL;
+    spawned = FALSE;
+    finished = FALSE;
+    offset = 0;
+    domain = g_quark_from_string (LW_IO_ERROR);
+
+    if (sd->compression == LW_COMPRESSION_GZIP)
+    {
+      argv[2] = (gchar*) sd->uri;
+      spawned = g_spawn_async_with_pipes (
+            NULL,
+            argv, 
+            NULL, 
+            G_SPAWN_STDERR_TO_DEV_NULL | G_SPAWN_DO_NOT_REAP_CHILD, 
+            NULL, 
+            NULL, 
+            &pid, 
+            NULL, 
+            &stdout_fd, 
+            NULL, 
+            &sd->read_error
+      );
+      if (spawned) file = fdopen (stdout_fd, "rb");
+    }
+    else
+    {
+      file = fopen (sd->uri, "rb");
+    }
+
+    if (file == NULL && sd->read_error == NULL)
+    {
+      message = gettext("Unable to read data from the input file.");
+      sd->read_error = g_error_new (domain, LW_IO_READ_ERROR, message);
+    }
+
+    while (file != NULL && !_cancel && (chunk = lw_iopipe_chunk_new ()) != NULL)
+    {
+      chunk->length = fread(chunk->data, sizeof(char), LW_IOPIPE_CHUNK_SIZE, file);
+      if (chunk->length == 0)
+      {
+        lw_iopipe_chunk_free (chunk);
+        finished = (ferror(file) == 0);
+        break;
+      }
+      offset += chunk->length;
+      chunk->offset = offset;
+      if (!lw_iopipe_push (sd->raw, chunk)) break;
+    }
+
+    if (file != NULL && ferror(file) != 0)
+    {
+      message = gettext("Unable to read data from the input file.");
+      sd->read_error = g_error_new (domain, LW_IO_READ_ERROR, message);
+    }
+
+    if (file != NULL) fclose(file);
+    file = NULL;
+
+#ifdef G_OS_UNIX
+    //A truncated or corrupt archive only shows up in the exit status of gzip.
+    //Closing the pipe above lets a gzip that was stopped early exit too.
+    if (spawned)
+    {
+      do waited = waitpid (pid, &status, 0); while (waited == -1 && errno == EINTR);
+      if (finished && sd->read_error == NULL && (waited != pid || !WIFEXITED (status) || WEXITSTATUS (status) != 0))
+      {
+        message = gettext("The compressed file is damaged or incomplete.");
+        sd->read_error = g_error_new (domain, LW_IO_READ_ERROR, message);
+      }
+    }
+#endif
+
+    if (sd->read_error != NULL) lw_iopipe_abort (sd->raw);
+    lw_iopipe_close (sd->raw);
+
+    //Cleanup
+    if (spawned) g_spawn_close_pid (pid);
+
+    return (sd->read_error);
+}
+
+
+//!
+//! @brief Second stage of a stream.  Converts the raw chunks to the target
+//!        encoding, carrying incomplete multibyte characters over to the next chunk.
+//! @param data A pointer to a LwIoStreamData object
+//! @returns Returns if there was an error
+//!
+static gpointer 
+_io_stream_convert_func (gpointer data)
+{
+    //Declarations
+    LwIoStreamData *sd;
+    LwIoPipeChunk *in;
+    LwIoPipeChunk *out;
+    GIConv conv;
+    gchar *buffer;
+    gchar *inptr, *outptr;
+    gsize inbytes_left, outbytes_left;
+    gsize result;
+    gsize carry;
+    const char *message;
+    GQuark domain;
+
+    //Initializations
+    sd = data;
+    out = NULL;
+    buffer = NULL;
+    carry = 0;
+    conv = (GIConv) -1;
+
+    //No conversion needed so just pass the chunks along
+    if (sd->source_encoding == NULL)
+    {
+      while ((in = lw_iopipe_pop (sd->raw)) != NULL)
+        if (!lw_iopipe_push (sd->text, in)) break;
+    }
+    else if ((conv = g_iconv_open (sd->target_encoding, sd->source_encoding)) == (GIConv) -1)
+    {
+      domain = g_quark_from_string (LW_IO_ERROR);
+      message = gettext("Unable to convert the text encoding of the file.");
+      sd->convert_error = g_error_new (domain, LW_IO_ENCODING_CONVERSION_ERROR, message);
+    }
+    else
+    {
+      buffer = g_malloc (LW_IOPIPE_CHUNK_SIZE + LW_IO_MAX_CARRY);
+      out = lw_iopipe_chunk_new ();
+
+      while ((in = lw_iopipe_pop (sd->raw)) != NULL)
+      {
+        memcpy(buffer + carry, in->data, in->length);
+        inptr = buffer;
+        inbytes_left = carry + in->length;
+
+        while (inbytes_left > 0)
+        {
+          outptr = out->data + out->length;
+          outbytes_left = LW_IOPIPE_CHUNK_SIZE - out->length;
+          result = g_iconv (conv, &inptr, &inbytes_left, &outptr, &outbytes_left);
+          out->length = LW_IOPIPE_CHUNK_SIZE - outbytes_left;
+          if (result != (gsize) -1) break;
+
+          //The output chunk is full so send it along
+          if (errno == E2BIG)
+          {
+            out->offset = in->offset;
+            if (!lw_iopipe_push (sd->text, out)) { out = NULL; break; }
+            out = lw_iopipe_chunk_new ();
+          }
+          //The chunk ends in the middle of a character
+          else if (errno == EINVAL && inbytes_left <= LW_IO_MAX_CARRY)
+          {
+            break;
+          }
+          //Force increment if there is something wrong
+          else
+          {
+            inptr++;
+            inbytes_left--;
+          }
+        }
+        if (out == NULL) 
+        {
+          lw_iopipe_chunk_free (in);
+          break;
+        }
+        carry = inbytes_left;
+        memmove(buffer, inptr, carry);
+
+        out->offset = in->offset;
+        lw_iopipe_chunk_free (in);
+
+        if (out->length > 0)
+        {
+          if (!lw_iopipe_push (sd->text, out)) { out = NULL; break; }
+          out = lw_iopipe_chunk_new ();
+        }
+      }
+    }
+
+    if (sd->convert_error != NULL || lw_iopipe_is_aborted (sd->raw)) 
+    {
+      lw_iopipe_abort (sd->raw);
+      lw_iopipe_abort (sd->text);
+    }
+    lw_iopipe_close (sd->text);
+
+    //Cleanup
+    if (out != NULL) lw_iopipe_chunk_free (out);
+    if (buffer != NULL) g_free (buffer);
+    if (conv != (GIConv) -1) g_iconv_close (conv);
+
+    return (sd->convert_error);
+}
+
+
+//!
+//! @brief Streams a file through a decompression, encoding conversion and line
+//!        splitting pipeline.  Each stage runs on its own thread and they are connected
+//!        by bounded LwIoPipes.  The line function is called from the calling thread.
+//! @param SOURCE_PATH The path to the file to stream
+//! @param COMPRESSION The compression of the file
+//! @param SOURCE_ENCODING The encoding of the file or NULL if it is already in the target encoding
+//! @param TARGET_ENCODING The encoding the lines should be converted to
+//! @param line_func A LwIoLineFunc that is called for every line of the converted file
+//! @param line_data A gpointer to data to pass to the LwIoLineFunc
+//! @param cb A LwIoProgressCallback function to give progress feedback or NULL
+//! @param data A generic pointer to data to pass to the LwIoProgressCallback
+//! @param error A pointer to a GError object to write an error to or NULL
+//!
+static gboolean 
+_io_stream (const char          *SOURCE_PATH,
+            const LwCompression  COMPRESSION,
+            const char          *SOURCE_ENCODING,
+            const char          *TARGET_ENCODING,
+            LwIoLineFunc         line_func,
+            gpointer             line_data,
+            LwIoProgressCallback cb,
+            gpointer             data,
+            GError             **error           )
+{
+    //Sanity check
+    if (error != NULL && *error != NULL) return FALSE;
+
+    //Declarations
+    LwIoStreamData sd;
+    GThread *read_thread;
+    GThread *convert_thread;
+    LwIoPipeChunk *chunk;
+    GString *line;
+    GTimer *timer;
+    gchar *start, *end, *newline;
+    gsize total;
+    gsize offset;
+    gboolean written;
+    GError *thread_error;
+    const char *message;
+    GQuark domain;
+
+    //Initializations
+    sd.uri = SOURCE_PATH;
+    sd.compression = COMPRESSION;
+    sd.source_encoding = SOURCE_ENCODING;
+    sd.target_encoding = TARGET_ENCODING;
+    sd.raw = lw_iopipe_new (LW_IOPIPE_MAX_CHUNKS);
+    sd.text = lw_iopipe_new (LW_IOPIPE_MAX_CHUNKS);
+    sd.read_error = NULL;
+    sd.convert_error = NULL;
+    read_thread = NULL;
+    convert_thread = NULL;
+    thread_error = NULL;
+    line = g_string_sized_new (LW_IO_MAX_FGETS_LINE);
+    timer = g_timer_new ();
+    total = _io_stream_get_expected_size (SOURCE_PATH, COMPRESSION);
+    offset = 0;
+    written = TRUE;
+
+    if (SOURCE_ENCODING != NULL && g_ascii_strcasecmp (SOURCE_ENCODING, TARGET_ENCODING) == 0)
+      sd.source_encoding = NULL;
+
+    read_thread = g_thread_create (_io_stream_read_func, &sd, TRUE, &thread_error);
+    if (read_thread != NULL)
+      convert_thread = g_thread_create (_io_stream_convert_func, &sd, TRUE, &thread_error);
+    if (convert_thread == NULL)
+      lw_iopipe_abort (sd.raw);
+
+    if (cb != NULL) cb (0.0, data);
+
+    //Split the converted text into lines
+    while (convert_thread != NULL && (chunk = lw_iopipe_pop (sd.text)) != NULL)
+    {
+      start = chunk->data;
+      end = chunk->data + chunk->length;
+
+      while (start < end && written)
+      {
+        newline = memchr(start, '\n', end - start);
+        if (newline == NULL)
+        {
+          g_string_append_len (line, start, end - start);
+          break;
+        }
+        g_string_append_len (line, start, newline - start + 1);
+        written = line_func (line->str, line->len, line_data);
+        g_string_truncate (line, 0);
+        start = newline + 1;
+      }
+
+      offset = chunk->offset;
+      lw_iopipe_chunk_free (chunk);
+
+      if (!written || _cancel)
+      {
+        lw_iopipe_abort (sd.raw);
+        lw_iopipe_abort (sd.text);
+        break;
+      }
+
+      //Throttle the progress updates
+      if (cb != NULL && total > 0 && g_timer_elapsed (timer, NULL) >= LW_IO_PROGRESS_INTERVAL)
+      {
+        cb (MIN((double) offset / (double) total, 1.0), data);
+        g_timer_start (timer);
+      }
+    }
+
+    //Wait for the other stages to finish
+    if (read_thread != NULL) g_thread_join (read_thread);
+    if (convert_thread != NULL) g_thread_join (convert_thread);
+
+    //The file didn't end in a newline
+    if (written && line->len > 0 && !_cancel && !lw_iopipe_is_aborted (sd.text))
+      written = line_func (line->str, line->len, line_data);
+
+    if (cb != NULL && !_cancel) cb (1.0, data);
+
+    //Set the first error from the stages if there isn't one already
+    if (thread_error == NULL && sd.read_error != NULL) 
+    {
+      thread_error = sd.read_error;
+      sd.read_error = NULL;
+    }
+    if (thread_error == NULL && sd.convert_error != NULL) 
+    {
+      thread_error = sd.convert_error;
+      sd.convert_error = NULL;
+    }
+    if (thread_error == NULL && !written)
+    {
+      domain = g_quark_from_string (LW_IO_ERROR);
+      message = gettext("Unable to write the stream's output to a file.");
+      thread_error = g_error_new (domain, LW_IO_WRITE_ERROR, message);
+    }
+    if (thread_error != NULL)
+    {
+      if (error != NULL && *error == NULL)
+        *error = thread_error;
+      else
+        g_error_free (thread_error);
+    }
+
+    //Cleanup
+    if (sd.read_error != NULL) g_error_free (sd.read_error);
+    if (sd.convert_error != NULL) g_error_free (sd.convert_error);
+    lw_iopipe_free (sd.raw);
+    lw_iopipe_free (sd.text);
+    g_string_free (line, TRUE);
+    g_timer_destroy (timer);
+
+    return (thread_error == NULL && !_cancel);
+}
+
+
+//!
+//! @brief Streams a dictionary file to a line handler, decompressing it and converting
+//!        it to UTF-8 on the way.  The source is read only once and no temporary files
+//!        are written.
+//! @param SOURCE_PATH The path to the file to stream
+//! @param COMPRESSION The compression of the file
+//! @param SOURCE_ENCODING The encoding of the file or NULL if it is already UTF-8
+//! @param line_func A LwIoLineFunc that is called for every line of the file
+//! @param line_data A gpointer to data to pass to the LwIoLineFunc
+//! @param cb A LwIoProgressCallback function to give progress feedback or NULL
+//! @param data A generic pointer to data to pass to the LwIoProgressCallback
+//! @param error A pointer to a GError object to write an error to or NULL
+//! @returns FALSE if the stream failed or was cancelled
+//!
+gboolean 
+lw_io_stream_file (const char          *SOURCE_PATH,
+                   const LwCompression  COMPRESSION,
+                   const char          *SOURCE_ENCODING,
+                   LwIoLineFunc         line_func,
+                   gpointer             line_data,
+                   LwIoProgressCallback cb,
+                   gpointer             data,
+                   GError             **error           )
+{
+    return _io_stream (SOURCE_PATH, COMPRESSION, SOURCE_ENCODING, "UTF-8", line_func, line_data, cb, data, error);
+}
+
+
+//!
+//! @brief Used by _io_stream_fputs_line to write lines to a file
+//!
+struct _LwIoStreamFileData {
+  FILE *file;              //!< The file being written to
+};
+typedef struct _LwIoStreamFileData LwIoStreamFileData;
+
+
+//!
+//! @brief A LwIoLineFunc that writes every line it is given to a file
+//! @param LINE The line to write
+//! @param LENGTH The length of the line in bytes
+//! @param data A pointer to a LwIoStreamFileData object
+//! @returns FALSE if the line could not be written
+//!
+static gboolean 
+_io_stream_fputs_line (const gchar *LINE, gsize LENGTH, gpointer data)
+{
+    //Declarations
+    LwIoStreamFileData *fdata;
+
+    //Initializations
+    fdata = data;
+
+    return (fwrite(LINE, sizeof(char), LENGTH, fdata->file) == LENGTH);
+}
+
+
 //!
 //! @brief Copies a file and creates a new one using the new encoding
 //! @param SOURCE_PATH The source file to change the encoding on.
@@ -137,65 +634,34 @@ lw_io_copy_with_encoding (const char *SOURCE_PATH, const char *TARGET_PATH,
                                    const char *SOURCE_ENCODING, const char *TARGET_ENCODING,
                                    LwIoProgressCallback cb, gpointer data, GError **error   )
 {
-    if (*error != NULL) return FALSE;
+    if (error != NULL && *error != NULL) return FALSE;
 
     //Declarations
-    FILE* readfd = NULL;
-    FILE* writefd = NULL;
-    const int MAX = LW_IO_MAX_FGETS_LINE;
-    char buffer[MAX];
-    char output[MAX];
-    gsize inbytes_left, outbytes_left;
-    char *inptr, *outptr;
-    char prev_inbytes;
-    size_t curpos;
-    size_t end;
-    GIConv conv;
-    double fraction;
+    LwIoStreamFileData fdata;
+    const char *message;
+    GQuark domain;
 
     //Initializations
-    readfd = fopen (SOURCE_PATH, "r");
-    writefd = fopen (TARGET_PATH, "w");
-    conv = g_iconv_open (TARGET_ENCODING, SOURCE_ENCODING);
-    prev_inbytes = 0;
-    end = lw_io_get_filesize (SOURCE_PATH);
-    curpos = 0;
+    fdata.file = fopen (TARGET_PATH, "wb");
 
-    while (ferror(readfd) == 0 && feof(readfd) == 0 && ferror(writefd) == 0 && feof(writefd) == 0)
+    if (fdata.file == NULL)
     {
-      fgets(buffer, MAX, readfd);
-      fraction = ((double) curpos / (double) end);
-      if (cb != NULL) cb (fraction, data);
-
-      curpos += strlen(buffer);
-      inptr = buffer; outptr = output;
-      inbytes_left = MAX; outbytes_left = MAX;
-      while (inbytes_left && outbytes_left)
+      if (error != NULL)
       {
-        if (g_iconv (conv, &inptr, &inbytes_left, &outptr, &outbytes_left) == -1) break;
-
-        //Force increment if there is something wrong
-        if (prev_inbytes == inbytes_left)
-        {
-          inptr++;
-          inbytes_left--;
-        }
-        //Normal operation
-        prev_inbytes = inbytes_left;
-        inptr = inptr + strlen(inptr) - inbytes_left;
-        outptr = outptr + strlen(outptr) - outbytes_left;
+        domain = g_quark_from_string (LW_IO_ERROR);
+        message = gettext("Unable to write the stream's output to a file.");
+        *error = g_error_new (domain, LW_IO_WRITE_ERROR, message);
       }
-      fwrite(output, 1, strlen(output), writefd); 
+      return FALSE;
     }
-    fraction = ((double) curpos / (double) end);
-    if (cb != NULL) cb (fraction, data);
+
+    _io_stream (SOURCE_PATH, LW_COMPRESSION_NONE, SOURCE_ENCODING, TARGET_ENCODING, 
+                _io_stream_fputs_line, &fdata, cb, data, error);
 
     //Cleanup
-    g_iconv_close (conv);
-    fclose(readfd);
-    fclose(writefd);
+    fclose(fdata.file);
 
-    return TRUE;
+    return (error == NULL || *error == NULL);
 }
 
 
@@ -375,6 +841,140 @@ lw_io_copy (const char *SOURCE_PATH, const char *TARGET_PATH,
 }
 
 
+//!
+//!
+//! @brief A LwIoWriteFunc that writes the text to a file
+//! @param TEXT The text to write
+//! @param LENGTH The length of the text in bytes
+//! @param data The FILE to write to
+//! @returns FALSE if the text could not be written
+//!
+gboolean 
+lw_io_fwrite_func (const gchar *TEXT, gsize LENGTH, gpointer data)
+{
+    return (fwrite(TEXT, sizeof(char), LENGTH, (FILE*) data) == LENGTH);
+}
+
+
+//! @brief Creates a new LwIoMixData object used for merging the radicals dictionary into kanjidic
+//! @param write_func The LwIoWriteFunc merged lines are written with
+//! @param output The data to pass to the LwIoWriteFunc, such as a FILE for lw_io_fwrite_func
+//! @return An allocated LwIoMixData that will be needed to be freed by lw_io_mixdata_free.
+//!
+LwIoMixData* 
+lw_io_mixdata_new (LwIoWriteFunc write_func, gpointer output)
+{
+    LwIoMixData *temp;
+
+    temp = (LwIoMixData*) malloc(sizeof(LwIoMixData));
+
+    if (temp != NULL)
+    {
+      temp->radicals = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, g_free);
+      temp->buffer = g_string_sized_new (LW_IO_MAX_FGETS_LINE * 2);
+      temp->write_func = write_func;
+      temp->output = output;
+    }
+
+    return temp;
+}
+
+
+//!
+//! @brief Releases a LwIoMixData object from memory.  The output is not closed.
+//! @param mix A LwIoMixData object created by lw_io_mixdata_new.
+//!
+void 
+lw_io_mixdata_free (LwIoMixData *mix)
+{
+    g_hash_table_destroy (mix->radicals);
+    g_string_free (mix->buffer, TRUE);
+
+    free (mix);
+}
+
+
+//!
+//! @brief A LwIoLineFunc that loads a line of the radicals dictionary into a LwIoMixData.
+//!        The lines are in the form "KANJI : RADICAL RADICAL...".  The first line
+//!        for a kanji is the one that is used.
+//! @param LINE A line of the radicals dictionary
+//! @param LENGTH The length of the line in bytes
+//! @param data A LwIoMixData object
+//! @returns Always TRUE
+//!
+gboolean 
+lw_io_mixdata_add_radicals_line (const gchar *LINE, gsize LENGTH, gpointer data)
+{
+    //Declarations
+    LwIoMixData *mix;
+    const gchar *ptr;
+    gunichar key;
+
+    //Initializations
+    mix = data;
+    key = g_utf8_get_char_validated (LINE, LENGTH);
+    if (key == (gunichar) -1 || key == (gunichar) -2) return TRUE;
+
+    //The key has to be a single character followed by a space
+    ptr = g_utf8_next_char (LINE);
+    if (*ptr != ' ') return TRUE;
+    if (g_hash_table_lookup (mix->radicals, GUINT_TO_POINTER (key)) != NULL) return TRUE;
+
+    //Skip over the colon and keep the data without the newline
+    ptr++;
+    if (*ptr != '\0') ptr++;
+    if (*ptr == '\0') return TRUE;
+
+    g_hash_table_insert (mix->radicals, GUINT_TO_POINTER (key), g_strndup (ptr, LENGTH - (ptr - LINE) - 1));
+
+    return TRUE;
+}
+
+
+//!
+//! @brief A LwIoLineFunc that inserts the radicals of a kanji after the kanji in its
+//!        kanjidic line and writes the result to the output of the LwIoMixData.
+//! @param LINE A line of kanjidic
+//! @param LENGTH The length of the line in bytes
+//! @param data A LwIoMixData object with the radicals already loaded
+//! @returns FALSE if the line could not be written
+//!
+gboolean 
+lw_io_mixdata_merge_kanji_line (const gchar *LINE, gsize LENGTH, gpointer data)
+{
+    //Declarations
+    LwIoMixData *mix;
+    const gchar *kanji_ptr;
+    const gchar *radicals;
+    gunichar key;
+
+    //Initializations
+    mix = data;
+
+    if (LINE[0] == '#') return TRUE;
+
+    //1. Copy the kanji character from the kanji line
+    kanji_ptr = strchr(LINE, ' ');
+    if (kanji_ptr == NULL) kanji_ptr = LINE + LENGTH;
+    g_string_truncate (mix->buffer, 0);
+    g_string_append_len (mix->buffer, LINE, kanji_ptr - LINE);
+
+    //2. Insert the radicals if available
+    key = g_utf8_get_char_validated (LINE, LENGTH);
+    if (key != (gunichar) -1 && key != (gunichar) -2)
+    {
+      radicals = g_hash_table_lookup (mix->radicals, GUINT_TO_POINTER (key));
+      if (radicals != NULL) g_string_append (mix->buffer, radicals);
+    }
+
+    //3. Copy the rest of the kanji line
+    g_string_append_len (mix->buffer, kanji_ptr, LENGTH - (kanji_ptr - LINE));
+
+    return mix->write_func (mix->buffer->str, mix->buffer->len, mix->output);
+}
+
+
 //!
 //! @brief Creates a single dictionary containing both the radical dict and kanji dict
 //! @param output_path Mix dictionary path to write to
@@ -393,106 +993,479 @@ lw_io_create_mix_dictionary (const char *output_path,
                              GError **error)
 {
     //Sanity check
-    if (*error != NULL) return FALSE;
+    if (error != NULL && *error != NULL) return FALSE;
 
     //Declarations
-    FILE *output_file, *kanji_file, *radicals_file;
-    char radicals_input[LW_IO_MAX_FGETS_LINE];
-    char kanji_input[LW_IO_MAX_FGETS_LINE];
-    char output[LW_IO_MAX_FGETS_LINE * 2];
-    char *radicals_ptr, *kanji_ptr, *output_ptr, *temp_ptr;
+    FILE *output_file;
+    LwIoMixData *mix;
+    const char *message;
+    GQuark domain;
 
-    size_t curpos;
-    size_t end;
-    double fraction;
+    //Initializations
+    output_file = fopen(output_path, "wb");
+
+    if (output_file == NULL)
+    {
+      if (error != NULL)
+      {
+        domain = g_quark_from_string (LW_IO_ERROR);
+        message = gettext("Unable to write the stream's output to a file.");
+        *error = g_error_new (domain, LW_IO_WRITE_ERROR, message);
+      }
+      return FALSE;
+    }
+
+    mix = lw_io_mixdata_new (lw_io_fwrite_func, output_file);
+
+    //Load the radicals once and then stream the kanji through them
+    lw_io_stream_file (radicals_dictionary_path, LW_COMPRESSION_NONE, NULL, 
+                       lw_io_mixdata_add_radicals_line, mix, NULL, NULL, error);
+    if (error == NULL || *error == NULL)
+      lw_io_stream_file (kanji_dictionary_path, LW_COMPRESSION_NONE, NULL,
+                         lw_io_mixdata_merge_kanji_line, mix, cb, data, error);
+
+    //Cleanup
+    lw_io_mixdata_free (mix);
+    fclose(output_file);
+
+    return (error == NULL || *error == NULL);
+}
+
+
+//!
+//! @brief The classification tags of the Enamdic and their LwIoNameTag values
+//!
+static const struct {
+  const char *name;
+  guint32 tag;
+} _name_tags[] = {
+  { "s", LW_IO_NAME_TAG_SURNAME },
+  { "p", LW_IO_NAME_TAG_PLACE },
+  { "u", LW_IO_NAME_TAG_UNCLASSIFIED },
+  { "g", LW_IO_NAME_TAG_GIVEN },
+  { "f", LW_IO_NAME_TAG_FEMALE },
+  { "m", LW_IO_NAME_TAG_MALE },
+  { "h", LW_IO_NAME_TAG_FULL },
+  { "pr", LW_IO_NAME_TAG_PRODUCT },
+  { "co", LW_IO_NAME_TAG_COMPANY },
+  { "st", LW_IO_NAME_TAG_STATION },
+  { NULL, 0 }
+};
+
+
+//!
+//! @brief Gets the LwIoNameTag for a tag name
+//! @param NAME The tag name in any case.  It does not need to be null terminated.
+//! @param LENGTH The length of the name in bytes
+//! @returns The LwIoNameTag or 0 if the name isn't a tag
+//!
+static guint32 
+_io_get_name_tag (const gchar *NAME, gsize LENGTH)
+{
+    //Declarations
+    int i;
+
+    for (i = 0; _name_tags[i].name != NULL; i++)
+    {
+      if (strlen(_name_tags[i].name) == LENGTH && g_ascii_strncasecmp(_name_tags[i].name, NAME, LENGTH) == 0)
+        return _name_tags[i].tag;
+    }
+
+    return 0;
+}
+
+
+//!
+//! @brief Finds the classification tags of an Enamdic line.  A tag is recognized
+//!        when it is surrounded by parenthesis or commas such as (s) or (u,p)
+//!        and case is ignored like the regexes it replaced did.
+//! @param LINE The line to parse
+//! @param LENGTH The length of the line in bytes
+//! @returns A mask of LwIoNameTags
+//!
+guint32 
+lw_io_parse_name_tags (const gchar *LINE, gsize LENGTH)
+{
+    //Declarations
+    const gchar *ptr;
+    const gchar *end;
+    const gchar *tag;
+    guint32 tags;
 
     //Initializations
-    kanji_file =  fopen(kanji_dictionary_path, "r");
-    radicals_file = fopen(radicals_dictionary_path, "r");
-    output_file = fopen(output_path, "w");
-    radicals_ptr = NULL;
-    kanji_ptr = NULL;
-    output_ptr = NULL;
+    end = LINE + LENGTH;
+    tags = 0;
 
-    curpos = 0;
-    end = lw_io_get_filesize (kanji_dictionary_path);
-    fraction = 0.0;
+    for (ptr = LINE; ptr < end; ptr++)
+    {
+      if (*ptr != '(' && *ptr != ',') continue;
+
+      tag = ptr + 1;
+      for (ptr = tag; ptr < end && ptr - tag < 3 && g_ascii_isalpha (*ptr); ptr++);
+      if (ptr < end && (*ptr == ')' || *ptr == ','))
+        tags |= _io_get_name_tag (tag, ptr - tag);
+      ptr--;
+    }
 
-    //Loop through the kanji file
-    while (fgets(kanji_input, LW_IO_MAX_FGETS_LINE, kanji_file) != NULL && !_cancel)
+    return tags;
+}
+
+
+//!
+//! @brief Converts a comma separated list of tag names such as "s,u,g" to a mask
+//!        of LwIoNameTags so the splits can be configured
+//! @param STRING The list of tag names
+//! @returns A mask of LwIoNameTags
+//!
+guint32 
+lw_io_get_name_tags_from_string (const char *STRING)
+{
+    //Declarations
+    gchar **atoms;
+    guint32 tags;
+    int i;
+
+    //Initializations
+    atoms = g_strsplit (STRING, ",", -1);
+    tags = 0;
+
+    for (i = 0; atoms[i] != NULL; i++)
     {
-      fraction = ((double) curpos)/((double) end);
-      if (cb != NULL) cb (fraction, data);
+      g_strstrip (atoms[i]);
+      tags |= _io_get_name_tag (atoms[i], strlen(atoms[i]));
+    }
+
+    //Cleanup
+    g_strfreev (atoms);
+
+    return tags;
+}
 
-      curpos += strlen (kanji_input);
 
-      if (kanji_input[0] == '#') continue;
+//!
+//! @brief A batch of whole lines sorted by a worker of a LwIoSplitter
+//!
+struct _LwIoSplitBatch {
+  GString *input;          //!< The lines to be sorted
+  GString **output;        //!< The lines for each output of the splitter
+  gboolean done;           //!< The worker finished sorting the lines
+};
+typedef struct _LwIoSplitBatch LwIoSplitBatch;
+
+
+static LwIoSplitBatch* 
+_io_splitbatch_new (int total)
+{
+    //Declarations
+    LwIoSplitBatch *temp;
+    int i;
+
+    temp = (LwIoSplitBatch*) malloc(sizeof(LwIoSplitBatch));
 
-      kanji_ptr = kanji_input;
-      output_ptr = output;
+    if (temp != NULL)
+    {
+      temp->input = g_string_sized_new (LW_IO_SPLIT_BATCH_SIZE + LW_IO_MAX_FGETS_LINE);
+      temp->output = g_new (GString*, total);
+      for (i = 0; i < total; i++)
+        temp->output[i] = g_string_sized_new (LW_IO_SPLIT_BATCH_SIZE);
+      temp->done = FALSE;
+    }
+
+    return temp;
+}
+
+
+static void 
+_io_splitbatch_free (LwIoSplitBatch *batch, int total)
+{
+    //Declarations
+    int i;
 
-      //1. Copy the kanji character from the kanji line
-      while (*kanji_ptr != ' ')
+    for (i = 0; i < total; i++)
+      g_string_free (batch->output[i], TRUE);
+    g_free (batch->output);
+    g_string_free (batch->input, TRUE);
+
+    free (batch);
+}
+
+
+//!
+//! @brief The thread pool function of a LwIoSplitter.  Sorts the lines of a batch
+//!        into the outputs by their tags.
+//! @param data The LwIoSplitBatch to sort
+//! @param user_data The LwIoSplitter the batch belongs to
+//!
+static void 
+_io_splitter_sort_func (gpointer data, gpointer user_data)
+{
+    //Declarations
+    LwIoSplitBatch *batch;
+    LwIoSplitter *splitter;
+    gchar *start, *end, *newline;
+    guint32 tags;
+    int i;
+
+    //Initializations
+    batch = data;
+    splitter = user_data;
+    start = batch->input->str;
+    end = batch->input->str + batch->input->len;
+
+    while (start < end)
+    {
+      newline = memchr(start, '\n', end - start);
+      newline = (newline == NULL) ? end : newline + 1;
+
+      tags = lw_io_parse_name_tags (start, newline - start);
+      for (i = 0; i < splitter->total; i++)
       {
-        *output_ptr = *kanji_ptr;
-        output_ptr++;
-        kanji_ptr++;
+        if (tags & splitter->tags[i])
+          g_string_append_len (batch->output[i], start, newline - start);
       }
 
-      //2. Find the relevent radical line and insert it if available
-      rewind (radicals_file);
-      while (fgets(radicals_input, LW_IO_MAX_FGETS_LINE, radicals_file) != NULL)
-      {
-        //Check for a match
-        temp_ptr = kanji_input;
-        radicals_ptr = radicals_input;
-        while (*radicals_ptr != ' ' && *radicals_ptr == *temp_ptr)
-        {
-          temp_ptr++;
-          radicals_ptr++;
-        }
+      start = newline;
+    }
 
-        //If a match is found...
-        if (*radicals_ptr == ' ')
-        {
-          //Skip over the colon
-          radicals_ptr++;
-          radicals_ptr++;
-   
-          //Copy the data
-          while (*(radicals_ptr + 1) != '\0')
-          {
-            *output_ptr = *radicals_ptr;
-            output_ptr++;
-            radicals_ptr++;
-          }
+    g_mutex_lock (splitter->mutex);
+    batch->done = TRUE;
+    g_cond_broadcast (splitter->cond);
+    g_mutex_unlock (splitter->mutex);
+}
 
-          break;
-        }
+
+//!
+//! @brief Writes the sorted batches to the outputs in the order they were read
+//! @param splitter The LwIoSplitter to write the batches of
+//! @param wait_all Wait for every queued batch instead of only as much as needed
+//!        to keep the number of queued batches bounded
+//!
+static void 
+_io_splitter_write_batches (LwIoSplitter *splitter, gboolean wait_all)
+{
+    //Declarations
+    LwIoSplitBatch *batch;
+    int i;
+
+    g_mutex_lock (splitter->mutex);
+    while ((batch = g_queue_peek_head (splitter->batches)) != NULL)
+    {
+      if (!batch->done)
+      {
+        if (!wait_all && g_queue_get_length (splitter->batches) < LW_IO_SPLIT_MAX_BATCHES) break;
+        g_cond_wait (splitter->cond, splitter->mutex);
+        continue;
       }
+      g_queue_pop_head (splitter->batches);
+      g_mutex_unlock (splitter->mutex);
 
-      //3. Copy the rest of the kanji line to output
-      while (*kanji_ptr != '\0')
+      for (i = 0; i < splitter->total; i++)
       {
-        *output_ptr = *kanji_ptr;
-        output_ptr++;
-        kanji_ptr++;
+        if (splitter->outputs[i] != NULL && batch->output[i]->len > 0 &&
+            !splitter->write_func (batch->output[i]->str, batch->output[i]->len, splitter->outputs[i]))
+          splitter->write_error = TRUE;
       }
+      _io_splitbatch_free (batch, splitter->total);
 
-      //4. Close off the string and write it to the file
-      *output_ptr = '\0';
-      fputs(output, output_file);
-      output[0] = '\0';
+      g_mutex_lock (splitter->mutex);
+    }
+    g_mutex_unlock (splitter->mutex);
+}
+
+
+//!
+//! @brief Creates a new LwIoSplitter object that sorts the lines of the Enamdic
+//!        into outputs by their classification tags.  The lines are sorted in
+//!        batches on a thread pool and written in their original order, a
+//!        batch of whole lines per call of the LwIoWriteFunc.
+//! @param write_func The LwIoWriteFunc the outputs are written with
+//! @param outputs An array with the data to pass to the LwIoWriteFunc for each
+//!        output, such as a FILE for lw_io_fwrite_func.  NULL outputs are skipped.
+//! @param TAGS An array with a mask of LwIoNameTags for each output.  A line is
+//!        written to every output that shares a tag with it.
+//! @param TOTAL The number of outputs
+//! @return An allocated LwIoSplitter that will be needed to be freed by lw_io_splitter_free.
+//!
+LwIoSplitter* 
+lw_io_splitter_new (LwIoWriteFunc write_func, gpointer *outputs, const guint32 *TAGS, const int TOTAL)
+{
+    //Declarations
+    LwIoSplitter *temp;
+    int i;
+
+    temp = (LwIoSplitter*) malloc(sizeof(LwIoSplitter));
+
+    if (temp != NULL)
+    {
+      temp->write_func = write_func;
+      temp->outputs = g_new (gpointer, TOTAL);
+      temp->tags = g_new (guint32, TOTAL);
+      for (i = 0; i < TOTAL; i++)
+      {
+        temp->outputs[i] = outputs[i];
+        temp->tags[i] = TAGS[i];
+      }
+      temp->total = TOTAL;
+      temp->pool = g_thread_pool_new (_io_splitter_sort_func, temp, LW_IO_SPLIT_MAX_THREADS, FALSE, NULL);
+      temp->batches = g_queue_new ();
+      temp->mutex = g_mutex_new ();
+      temp->cond = g_cond_new ();
+      temp->current = NULL;
+      temp->write_error = FALSE;
+    }
+
+    return temp;
+}
+
+
+//!
+//! @brief Releases a LwIoSplitter object from memory.  Lines that weren't written
+//!        with lw_io_splitter_finish are dropped.  The outputs are not closed.
+//! @param splitter A LwIoSplitter object created by lw_io_splitter_new.
+//!
+void 
+lw_io_splitter_free (LwIoSplitter *splitter)
+{
+    //Declarations
+    LwIoSplitBatch *batch;
+
+    g_thread_pool_free (splitter->pool, FALSE, TRUE);
+    while ((batch = g_queue_pop_head (splitter->batches)) != NULL)
+      _io_splitbatch_free (batch, splitter->total);
+    if (splitter->current != NULL) _io_splitbatch_free (splitter->current, splitter->total);
+
+    g_queue_free (splitter->batches);
+    g_mutex_free (splitter->mutex);
+    g_cond_free (splitter->cond);
+    g_free (splitter->outputs);
+    g_free (splitter->tags);
+
+    free (splitter);
+}
+
+
+//!
+//! @brief Sends the current batch of a LwIoSplitter to the thread pool
+//!
+static void 
+_io_splitter_queue_current (LwIoSplitter *splitter)
+{
+    g_mutex_lock (splitter->mutex);
+    g_queue_push_tail (splitter->batches, splitter->current);
+    g_mutex_unlock (splitter->mutex);
+
+    g_thread_pool_push (splitter->pool, splitter->current, NULL);
+    splitter->current = NULL;
+}
+
+
+//!
+//! @brief A LwIoLineFunc that adds a line of the Enamdic to a LwIoSplitter
+//! @param LINE The line to add
+//! @param LENGTH The length of the line in bytes
+//! @param data A LwIoSplitter object
+//! @returns FALSE if there was an error writing the earlier lines
+//!
+gboolean 
+lw_io_splitter_add_line (const gchar *LINE, gsize LENGTH, gpointer data)
+{
+    //Declarations
+    LwIoSplitter *splitter;
+
+    //Initializations
+    splitter = data;
+
+    if (splitter->current == NULL) 
+      splitter->current = _io_splitbatch_new (splitter->total);
+    g_string_append_len (splitter->current->input, LINE, LENGTH);
+
+    if (splitter->current->input->len >= LW_IO_SPLIT_BATCH_SIZE)
+    {
+      _io_splitter_queue_current (splitter);
+      _io_splitter_write_batches (splitter, FALSE);
+    }
+
+    return (!splitter->write_error);
+}
+
+
+//!
+//! @brief Sorts and writes the remaining lines of a LwIoSplitter
+//! @param splitter The LwIoSplitter to finish
+//! @returns FALSE if there was an error writing to the outputs
+//!
+gboolean 
+lw_io_splitter_finish (LwIoSplitter *splitter)
+{
+    if (splitter->current != NULL) 
+      _io_splitter_queue_current (splitter);
+    _io_splitter_write_batches (splitter, TRUE);
+
+    return (!splitter->write_error);
+}
+
+
+//!
+//! @brief Splits an Enamdic formatted dictionary into multiple files by the
+//!        classification tags of each line in a single pass
+//! @param INPUT_PATH The file to use to generate the split dictionaries
+//! @param OUTPUT_PATHS An array of paths to write the split dictionaries to
+//! @param TAGS An array with a mask of LwIoNameTags for each output path
+//! @param TOTAL The number of output paths
+//! @param cb A LwIoProgressCallback to use to give progress feedback or NULL
+//! @param data A gpointer to data to pass to the LwIoProgressCallback
+//! @param error pointer to a GError to write errors to
+//!
+gboolean 
+lw_io_split_names_dictionary (const char     *INPUT_PATH,
+                              const char    **OUTPUT_PATHS,
+                              const guint32  *TAGS,
+                              const int       TOTAL,
+                              LwIoProgressCallback cb,
+                              gpointer        data,
+                              GError        **error         )
+{
+    if (error != NULL && *error != NULL) return FALSE;
+
+    //Declarations
+    gpointer *files;
+    LwIoSplitter *splitter;
+    gboolean written;
+    int i;
+    const char *message;
+    GQuark domain;
+
+    //Initializations
+    files = g_new (gpointer, TOTAL);
+    written = TRUE;
+
+    for (i = 0; i < TOTAL; i++)
+    {
+      files[i] = fopen(OUTPUT_PATHS[i], "wb");
+      if (files[i] == NULL) written = FALSE;
+    }
+
+    if (written)
+    {
+      splitter = lw_io_splitter_new (lw_io_fwrite_func, files, TAGS, TOTAL);
+      lw_io_stream_file (INPUT_PATH, LW_COMPRESSION_NONE, NULL, lw_io_splitter_add_line, splitter, cb, data, error);
+      written = lw_io_splitter_finish (splitter);
+      lw_io_splitter_free (splitter);
+    }
+
+    if (!written && error != NULL && *error == NULL)
+    {
+      domain = g_quark_from_string (LW_IO_ERROR);
+      message = gettext("Unable to write the stream's output to a file.");
+      *error = g_error_new (domain, LW_IO_WRITE_ERROR, message);
     }
-    fraction = 1.0;
-    if (cb != NULL) cb (fraction, data);
 
     //Cleanup
-    fclose(kanji_file);
-    fclose(output_file);
-    fclose(radicals_file);
+    for (i = 0; i < TOTAL; i++)
+      if (files[i] != NULL) fclose(files[i]);
+    g_free (files);
 
-    return TRUE;
+    return (written && (error == NULL || *error == NULL));
 }
 
 
@@ -531,64 +1504,10 @@ lw_io_split_places_from_names_dictionary (const char *OUTPUT_NAMES_PATH,
     */
 
     //Declarations
-    char buffer[LW_IO_MAX_FGETS_LINE];
-    FILE *inputf;
-    size_t curpos;
-    size_t end;
-    double fraction;
-
-    FILE *placesf;
-    GRegex *re_place;
-    const char *place_pattern = "([\\(,])((p)|(st))([\\),])";
-    int  place_write_error;
+    const char *paths[] = { OUTPUT_NAMES_PATH, OUTPUT_PLACES_PATH };
+    const guint32 tags[] = { LW_IO_NAME_TAGS_NAMES, LW_IO_NAME_TAGS_PLACES };
 
-    FILE *namesf;
-    GRegex *re_name;
-    const char *name_pattern = "([\\(,])((s)|(u)|(g)|(f)|(m)|(h)|(pr)|(co))([\\),])";
-    int  name_write_error;
-
-    //Initializations
-    inputf = fopen(INPUT_NAMES_PLACES_PATH, "r");
-    curpos = 0;
-    end = lw_io_get_filesize (INPUT_NAMES_PLACES_PATH);
-    fraction = 0.0;
-
-    re_place = g_regex_new (place_pattern,  LW_RE_COMPILE_FLAGS, LW_RE_LOCATE_FLAGS, error);
-    placesf = fopen(OUTPUT_PLACES_PATH, "w");
-    place_write_error = 0;
-
-    re_name = g_regex_new (name_pattern,  LW_RE_COMPILE_FLAGS, LW_RE_LOCATE_FLAGS, error);
-    namesf = fopen(OUTPUT_NAMES_PATH, "w");
-    name_write_error  = 0;
-
-
-    //Start writing the child files
-    while (fgets(buffer, LW_IO_MAX_FGETS_LINE, inputf) != NULL &&
-           place_write_error != EOF &&
-           name_write_error  != EOF &&
-           *error == NULL &&
-           !_cancel)
-    {
-      fraction = ((double) curpos) / ((double) end);
-      if (cb != NULL) cb (fraction, data);
-
-      if (placesf != NULL && g_regex_match (re_place, buffer, 0, NULL))
-        place_write_error = fputs(buffer, placesf);
-      if (namesf != NULL && g_regex_match(re_name, buffer, 0, NULL))
-        name_write_error =  fputs(buffer, namesf);
-      curpos += strlen(buffer);
-    }
-    fraction = 1.0;
-    if (cb != NULL) cb (fraction, data);
-
-    //Cleanup
-    fclose(inputf);
-    fclose(placesf);
-    fclose(namesf);
-    g_regex_unref (re_place);
-    g_regex_unref (re_name);
-
-    return (place_write_error != EOF && name_write_error != EOF);
+    return lw_io_split_names_dictionary (INPUT_NAMES_PLACES_PATH, paths, tags, 2, cb, data, error);
 }
 
 
@@ -685,22 +1604,11 @@ lw_io_get_filesize (const char *URI)
     g_assert (g_file_test (URI, G_FILE_TEST_IS_REGULAR));
 
     //Declarations
-    const int MAX_CHUNK = 128;
-    char buffer[MAX_CHUNK];
-    FILE *file;
-    size_t size;
-
-    //Initializations
-    file = fopen(URI, "rb");
-    size = 0;
+    GStatBuf info;
 
-    while (file != NULL && ferror(file) == 0 && feof(file) == 0)
-        size += fread(buffer, sizeof(char), MAX_CHUNK, file);
+    if (g_stat (URI, &info) != 0) return 0;
 
-    //Cleanup
-    fclose(file);
-
-    return size;
+    return info.st_size;
 }
 
 
@@ -936,28 +1844,16 @@ lw_io_set_cancel_operations (gboolean state)
 
 
 //!
-//! @brief A quick way to get the number of lines in a file for use in progress functions
-//! @param FILENAME The path to the file to see how many lines it has
+//! @brief A quick way to get the size of a file for use in progress functions
+//! @param URI The path to the file to see how large it is
 //!
 long 
 lw_io_get_size_for_uri (const char *URI)
 {
     //Declarations
-    FILE *file;
-    long length;
-
-    //Initializations
-    file = fopen (URI, "r");
-    length = 0L;
+    GStatBuf info;
 
-    if (file != NULL)
-    {
-      fseek (file, 0L, SEEK_END);
-      length = ftell (file);
-      fclose(file);
-    }
+    if (g_stat (URI, &info) != 0) return 0L;
    
-    return length;
+    return info.st_size;
 }
-
-
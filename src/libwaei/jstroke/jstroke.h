@@ -55,6 +55,9 @@
  */
 #define diMaxListCount       5
 #define diMaxXyPairs       256	/* Max pairs in stroke... */
+#define diPathBufLen        16	/* Max direction codes in one stroke path */
+#define diFilterOpLen        5	/* cArg0, iStroke0, cArg1, iStroke1, bMust */
+#define diMaxFilterOps      16	/* Max extra filters kept for one entry */
 
 /* ----- List Memory ---------------------------------------------------------
  * The idea here is to have a single nonmovable chunk of memory which contains
@@ -85,6 +88,35 @@ typedef struct ScoreItemStruct {
     CharPtr      m_cp;
 } ScoreItem;
 
+/* ----- StrokeCache ------------------------------------------------------
+ * Per-stroke state that lives for one recognition.  The angles between
+ * sample pairs don't depend on the dictionary entry, so they are worked
+ * out once and shared by all of them.
+ * Whole-stroke scores are kept by path too, since many entries describe a
+ * stroke the same way.
+ */
+
+typedef struct {
+	UInt   m_iKey;
+	UInt   m_iGen;				/* 0 for an empty slot. */
+	ULong  m_iScore;
+} MemoItem;
+
+typedef struct {
+	UInt   m_iLen;				/* 0 for an empty slot. */
+	char   m_cPath[diPathBufLen];
+	ULong  m_iScore;
+} PathItem;
+
+typedef struct StrokeCacheStruct {
+	RawStroke* m_pRawStroke;
+	Byte*      m_bpAngles;		/* Angle32 of samples i, j at [i*m_len+j]. */
+	MemoItem*  m_pPathMemo;		/* Sub-path scores of the path being scored. */
+	UInt       m_iPathGen;
+	Boolean    m_bPathMemo;		/* Whether the path is long enough to use it. */
+	PathItem*  m_pPathCache;	/* Whole stroke scores by path. */
+} StrokeCache;
+
 /* ----- StrokeScorer------------------------------------------------------ */
 
 typedef struct StrokeScorer *StrokeScorerPtr;
@@ -96,6 +128,7 @@ typedef struct StrokeScorerStruct {
 	ScoreItem*  m_pScores;
 	UInt        m_iScoreLen;
 	CharPtr     m_cpPath;
+	StrokeCache* m_pCaches;		/* One per raw stroke. */
 } StrokeScorer;
 
 ListMem*  AppEmptyList();
@@ -119,5 +152,40 @@ Long          StrokeScorerProcess  (StrokeScorer *pScorer, Long iMaxCnt);
 /* Return best diMaxListCount candidates processed so far */
 ListMem*      StrokeScorerTopPicks (StrokeScorer *pScorer);
 
+/* The pieces of StrokeScorerEvalItem, for callers that decode the
+ * dictionary once and score it many times.
+ */
+
+/* Decode the letters of one stroke description into direction codes and
+ * move *cppEntry past them.  Returns the number of codes, 0 if there is
+ * no stroke description at *cppEntry.
+ */
+UInt          StrokeDicDecodeStroke(CharPtr* cppEntry, CharPtr cpPath);
+
+/* Decode the extra filters following a '|' into ops of diFilterOpLen
+ * bytes.  Returns a pointer to the start of the next entry.
+ */
+CharPtr       StrokeDicDecodeFilters(CharPtr cp, Byte* bpOps,
+									 UInt* ipOpCnt);
+
+/* Score decoded paths against the raw strokes.  The codes of stroke i
+ * are cpPaths[ipOffsets[i]] up to cpPaths[ipOffsets[i+1]].
+ */
+ULong         StrokeScorerScorePaths(StrokeScorer *pScorer, CharPtr cpPaths,
+									 const UInt* ipOffsets);
+
+/* Adjust a score with decoded extra filters */
+void          StrokeScorerApplyFilters(StrokeScorer *pScorer, const Byte* bpOps,
+									   UInt iOpCnt, ULong* ipScore);
+
+/* Score one raw stroke against a decoded path.  The stroke scores of an
+ * entry are combined by summing them with StrokeScoreAddSquare and taking
+ * the SqrtULong of the sum, so partial sums can be kept between strokes.
+ */
+ULong         StrokeScorerScoreStroke(StrokeScorer *pScorer, UInt iStroke,
+									  CharPtr cpPath, UInt iPathLen);
+ULong         StrokeScoreAddSquare(ULong iScore, ULong iThisScore);
+ULong         SqrtULong(ULong val);
+
 #endif /*__JSTROKE_H__*/
 /* ----- End of jstroke.h ------------------------------------------------- */
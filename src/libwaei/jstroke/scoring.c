@@ -41,23 +41,42 @@
  */
 #define diScoreTextLen (2 + 2+2 + 9 + 1 + 10)
 
-#define diPathBufLen        16
+#define diMemoLen         1024	/* Slots in a memo table, a power of 2. */
+#define diMemoProbes         8
+#define diPathCacheLen     256	/* Slots in a path cache, a power of 2. */
+
+#define diMemoMinPathLen     5	/* Shorter paths never repeat a sub-problem. */
+
+/* Memo keys pack the sample range, the path range and the depth into
+ * 32 bits.  Starts are < 256 and lengths are <= 256.
+ */
+#define PathMemoKey(s, l, ps, pl, d) ((s) | ((l) << 8) | ((ps) << 17) | ((pl) << 21) | ((d) << 26))
+#define diMemoMaxDepth       8
+#define diAngUnknown      0xff	/* Angle32 is never more than 32. */
 
 CharPtr   StrokeScorerEvalItem(StrokeScorer *pScorer, CharPtr cpEntry,
 							   ULong* ipScore /*OUT*/);
 
-ULong     StrokeDicScoreStroke(Byte* bpX, Byte* bpY, UInt iLen,
-							   CharPtr cpPath, UInt iPathLen,
+Boolean   StrokeCacheInit(StrokeCache* pCache, RawStroke* rsp);
+void      StrokeCacheDeinit(StrokeCache* pCache);
+ULong     StrokeCacheScorePath(StrokeCache* pCache,
+							   CharPtr cpPath, UInt iPathLen);
+
+Boolean   MemoFind(MemoItem* pMemo, UInt iKey, UInt iGen,
+				   ULong* ipScore /*OUT*/);
+void      MemoStore(MemoItem* pMemo, UInt iKey, UInt iGen, ULong iScore);
+
+ULong     StrokeDicScoreStroke(StrokeCache* pCache, UInt iStart, UInt iLen,
+							   CharPtr cpPath, UInt iPathStart, UInt iPathLen,
 							   UInt iDepth);
 
 CharPtr   StrokeScorerExtraFilters(StrokeScorer *pscorer,
 								   CharPtr cp, ULong* ipScore /*OUT*/);
 
+
 Long      StrokeScorerExtraEval(StrokeScorer *pscorer,
 								char cArg, UInt iStroke);
 
-ULong     SqrtULong(ULong val);
-
 /* ----- SqrtULong ---------------------------------------------------------*/
 
 ULong SqrtULong(ULong val) {
@@ -87,11 +106,139 @@ ULong SqrtULong(ULong val) {
 	return root;
 }
 
+/* ----- MemoFind / MemoStore -------------------------------------------------
+ * A small open addressed table.  Slots from an older generation count as
+ * empty, so a table is cleared by bumping the generation.  When the probes
+ * run out a score is simply not remembered.
+ */
+
+#define MemoSlot(k) ((UInt) ((((k) ^ ((k) >> 15)) * 2654435761U) >> 16) & (diMemoLen-1))
+
+Boolean MemoFind(MemoItem* pMemo, UInt iKey, UInt iGen,
+				 ULong* ipScore /*OUT*/) {
+	UInt i, iSlot;
+
+	iSlot = MemoSlot(iKey);
+	for (i = 0; i < diMemoProbes; i++) {
+		MemoItem* pItem = pMemo + ((iSlot + i) & (diMemoLen-1));
+		if (pItem->m_iGen != iGen)
+			return false;
+		if (pItem->m_iKey == iKey) {
+			*ipScore = pItem->m_iScore;
+			return true;
+		}
+	}
+	return false;
+}
+
+void MemoStore(MemoItem* pMemo, UInt iKey, UInt iGen, ULong iScore) {
+	UInt i, iSlot;
+
+	iSlot = MemoSlot(iKey);
+	for (i = 0; i < diMemoProbes; i++) {
+		MemoItem* pItem = pMemo + ((iSlot + i) & (diMemoLen-1));
+		if (pItem->m_iGen != iGen || pItem->m_iKey == iKey) {
+			pItem->m_iKey = iKey;
+			pItem->m_iGen = iGen;
+			pItem->m_iScore = iScore;
+			return;
+		}
+	}
+}
+
+/* ----- StrokeCacheInit ---------------------------------------------------*/
+/* Set up the per-recognition state of a raw stroke.  Sample pair angles
+   are filled in as they are first needed, since the mid-point steps only
+   reach a small part of them on long strokes.
+   (Returns false if can't get memory) */
+
+Boolean StrokeCacheInit(StrokeCache* pCache, RawStroke* rsp) {
+	UInt n;
+
+	n = rsp->m_len;
+
+	pCache->m_pRawStroke = rsp;
+	pCache->m_iPathGen = 0;
+	pCache->m_bPathMemo = false;
+	pCache->m_bpAngles = (Byte*) MemPtrNew(n*n + 1);
+	pCache->m_pPathMemo = (MemoItem*) MemPtrNew(diMemoLen*sizeof(MemoItem));
+	pCache->m_pPathCache = (PathItem*) MemPtrNew(diPathCacheLen*sizeof(PathItem));
+
+	if (!pCache->m_bpAngles || !pCache->m_pPathMemo || !pCache->m_pPathCache) {
+		StrokeCacheDeinit(pCache);
+		return false;
+	}
+
+	memset(pCache->m_pPathMemo, 0, diMemoLen*sizeof(MemoItem));
+	memset(pCache->m_pPathCache, 0, diPathCacheLen*sizeof(PathItem));
+
+	memset(pCache->m_bpAngles, diAngUnknown, n*n + 1);
+
+	return true;
+}
+
+/* ----- StrokeCacheDeinit -------------------------------------------------*/
+
+void StrokeCacheDeinit(StrokeCache* pCache) {
+	if (pCache->m_bpAngles) MemPtrFree(pCache->m_bpAngles);
+	if (pCache->m_pPathMemo) MemPtrFree(pCache->m_pPathMemo);
+	if (pCache->m_pPathCache) MemPtrFree(pCache->m_pPathCache);
+	pCache->m_bpAngles = NULL;
+	pCache->m_pPathMemo = NULL;
+	pCache->m_pPathCache = NULL;
+}
+
+/* ----- StrokeCacheScorePath ----------------------------------------------*/
+/* Score a whole raw stroke against a path, reusing the score from an
+   earlier dictionary entry with the same path when there is one. */
+
+ULong StrokeCacheScorePath(StrokeCache* pCache,
+						   CharPtr cpPath, UInt iPathLen) {
+	PathItem* pItem = NULL;
+	UInt      i, iHash;
+	ULong     iScore;
+
+	if (iPathLen > 0 && iPathLen <= diPathBufLen) {
+		iHash = iPathLen;
+		for (i = 0; i < iPathLen; i++)
+			iHash = iHash * 31 + (Byte) cpPath[i];
+
+		for (i = 0; i < diMemoProbes; i++) {
+			pItem = pCache->m_pPathCache + ((iHash + i) & (diPathCacheLen-1));
+			if (pItem->m_iLen == 0)
+				break;
+			if (pItem->m_iLen == iPathLen &&
+				memcmp(pItem->m_cPath, cpPath, iPathLen) == 0)
+				return pItem->m_iScore;
+			pItem = NULL;
+		}
+	}
+
+	/* Sub-path scores are only good for the path they were found for.
+	 * Below 5 directions no (range, sub-path) pair is tried twice, so
+	 * looking them up would only cost time.
+	 */
+	pCache->m_iPathGen++;
+	pCache->m_bPathMemo = (iPathLen >= diMemoMinPathLen);
+
+	iScore = StrokeDicScoreStroke(pCache, 0, pCache->m_pRawStroke->m_len,
+								  cpPath, 0, iPathLen, 0 /*depth*/);
+
+	if (pItem) {
+		pItem->m_iLen = iPathLen;
+		memcpy(pItem->m_cPath, cpPath, iPathLen);
+		pItem->m_iScore = iScore;
+	}
+
+	return iScore;
+}
+
 /* ----- StrokeScorerCreate-------------------------------------------------*/
 /* Create a StrokeScorer object. (Returns NULL if can't get memory) */
 
 StrokeScorer *StrokeScorerCreate  (CharPtr cpStrokeDic, RawStroke *rsp,
 			 					   UInt iStrokeCnt) {
+	UInt i;
 	StrokeScorer *pScorer = (StrokeScorer *) MemPtrNew(sizeof(StrokeScorer));
 	if (!pScorer) {
 		ErrBox("Not enough memory.");
@@ -120,6 +267,24 @@ StrokeScorer *StrokeScorerCreate  (CharPtr cpStrokeDic, RawStroke *rsp,
 		return NULL;
 	}
 
+	pScorer->m_pCaches = (StrokeCache*) MemPtrNew(iStrokeCnt*sizeof(StrokeCache) + 1);
+
+	for (i = 0; pScorer->m_pCaches && i < iStrokeCnt; i++) {
+		if (!StrokeCacheInit(pScorer->m_pCaches + i, rsp + i))
+			break;
+	}
+
+	if (!pScorer->m_pCaches || i < iStrokeCnt) {
+		ErrBox("Not enough memory.");
+		while (pScorer->m_pCaches && i-- > 0)
+			StrokeCacheDeinit(pScorer->m_pCaches + i);
+		if (pScorer->m_pCaches) MemPtrFree(pScorer->m_pCaches);
+		MemPtrFree(pScorer->m_cpPath);
+		MemPtrFree(pScorer->m_pScores);
+		MemPtrFree(pScorer);
+		return NULL;
+	}
+
 	return pScorer;
 }
 
@@ -127,7 +292,12 @@ StrokeScorer *StrokeScorerCreate  (CharPtr cpStrokeDic, RawStroke *rsp,
 /* Destroy a StrokeScorer object */
 
 void StrokeScorerDestroy  (StrokeScorer *pScorer) {
+	UInt i;
+
 	if (pScorer) {
+		for (i = 0; i < pScorer->m_iStrokeCnt; i++)
+			StrokeCacheDeinit(pScorer->m_pCaches + i);
+		MemPtrFree (pScorer->m_pCaches);
 		MemPtrFree (pScorer->m_pScores);
 		MemPtrFree (pScorer->m_cpPath);
 		MemPtrFree (pScorer);
@@ -276,9 +446,8 @@ CharPtr StrokeScorerEvalItem(StrokeScorer *pScorer, CharPtr cpEntry,
 							 ULong* ipScore /*OUT*/) {
 	CharPtr cp = cpEntry;
 	UInt    iStroke;
+	UInt    iPathLen;
 	CharPtr cpPath = pScorer->m_cpPath;
-	CharPtr cpPathEnd;
-	RawStroke* rsp;
 	ULong   iThisScore;
 	ULong   iScore = 0;
 
@@ -296,90 +465,19 @@ CharPtr StrokeScorerEvalItem(StrokeScorer *pScorer, CharPtr cpEntry,
 	/* Loop through stroke descriptions */
 	for (iStroke = 0; iStroke < pScorer->m_iStrokeCnt; iStroke++) {
 
-		cpPathEnd = cpPath;
-
-		switch (*cp) {		/* Break out on first char value... */
-		case 'A':			/* TDR='1' CLK=07:30 DEG=225 */
-			*cpPathEnd++ = 20; break; 
-		case 'B':			/* TDR='2' CLK=06:00 DEG=180 */
-			*cpPathEnd++ = 16; break; 
-		case 'C':			/* TDR='3' CLK=04:30 DEG=135 */
-			*cpPathEnd++ = 12; break; 
-		case 'D':			/* TDR='4' CLK=09:00 DEG=270 */
-			*cpPathEnd++ = 24; break; 
-		case 'F':			/* TDR='6' CLK=03:00 DEG=090 */
-			*cpPathEnd++ =  8; break; 
-		case 'G':			/* TDR='7' CLK=10:30 DEG=315 */
-			*cpPathEnd++ = 28; break; 
-		case 'H':			/* TDR='8' CLK=12:00 DEG=360 */
-			*cpPathEnd++ =  0; break; 
-		case 'I':			/* TDR='9' CLK=01:30 DEG=045 */
-			*cpPathEnd++ =  4; break; 
-		case 'J':			/* TDR='x' down   06:00 then 07:30 */
-			*cpPathEnd++ = 16; *cpPathEnd++ = 20; break; 
-		case 'K':			/* TDR='y' down   06:00 then 04:30 */
-			*cpPathEnd++ = 16; *cpPathEnd++ = 12; break; 
-		case 'L':			/* TDR='c' down   06:00 then 03:00 */
-			*cpPathEnd++ = 16; *cpPathEnd++ =  8; break; 
-		case 'M':			/* TDR='b' across 03:00 then 06:00 */
-			*cpPathEnd++ =  8; *cpPathEnd++ = 16; break; 
-		default:
-			goto NoMoreStrokes;
-		} /* end switch on first char value */
-
-		for (cp++; ; cp++) {	/* Loop through following chars for stroke */
-			switch (*cp) {		/* Break out on char value... */
-			case 'a':			/* TDR='1' CLK=07:30 DEG=225 */
-				*cpPathEnd++ = 20; break; 
-			case 'b':			/* TDR='2' CLK=06:00 DEG=180 */
-				*cpPathEnd++ = 16; break; 
-			case 'c':			/* TDR='3' CLK=04:30 DEG=135 */
-				*cpPathEnd++ = 12; break; 
-			case 'd':			/* TDR='4' CLK=09:00 DEG=270 */
-				*cpPathEnd++ = 24; break; 
-			case 'f':			/* TDR='6' CLK=03:00 DEG=090 */
-				*cpPathEnd++ =  8; break; 
-			case 'g':			/* TDR='7' CLK=10:30 DEG=315 */
-				*cpPathEnd++ = 28; break; 
-			case 'h':			/* TDR='8' CLK=12:00 DEG=360 */
-				*cpPathEnd++ =  0; break; 
-			case 'i':			/* TDR='9' CLK=01:30 DEG=045 */
-				*cpPathEnd++ =  4; break; 
-			case 'j':			/* TDR='x' down   06:00 then 07:30 */
-				*cpPathEnd++ = 16; *cpPathEnd++ = 20; break; 
-			case 'k':			/* TDR='y' down   06:00 then 04:30 */
-				*cpPathEnd++ = 16; *cpPathEnd++ = 12; break; 
-			case 'l':			/* TDR='c' down   06:00 then 03:00 */
-				*cpPathEnd++ = 16; *cpPathEnd++ =  8; break; 
-			case 'm':			/* TDR='b' across 03:00 then 06:00 */
-				*cpPathEnd++ =  8; *cpPathEnd++ = 16; break; 
-			default:
-				goto ThisStrokeDone;
-			} /* end switch on char value */
-		} /* end loop through chars for stroke */
-ThisStrokeDone:
+		iPathLen = StrokeDicDecodeStroke(&cp, cpPath);
+		if (iPathLen == 0)
+			break;
 
-		rsp = &(pScorer->m_pRawStrokes[iStroke]);
+		iThisScore = StrokeCacheScorePath(pScorer->m_pCaches + iStroke,
+										  cpPath, iPathLen);
 
-		iThisScore = StrokeDicScoreStroke(rsp->m_x, rsp->m_y, rsp->m_len,
-										  cpPath, (cpPathEnd - cpPath),
-										  0 /*depth*/);
-		
 		MemoWrite2d(" s", iStroke+1);
 		MemoWrite2d("=", iThisScore); /* DEBUG: stroke score */
 
-		if (iThisScore >= diMaxScoreToSquare)
-			iThisScore = diMaxScoreSquared;
-		else
-			iThisScore = (iThisScore * iThisScore);
-
-		if (iScore >= (diMaxScoreSquared - iThisScore))
-			iScore = diMaxScoreSquared;
-		else
-			iScore += iThisScore;
+		iScore = StrokeScoreAddSquare(iScore, iThisScore);
 
 	} /* end loop through stroke descriptions */
-NoMoreStrokes:
 
 	iScore = SqrtULong(iScore);
 	*ipScore = iScore;
@@ -403,22 +501,138 @@ NoMoreStrokes:
 	return cp;
 }
 
+/* ----- StrokeScorerScorePaths ---------------------------------------------*/
+
+ULong StrokeScorerScorePaths(StrokeScorer *pScorer, CharPtr cpPaths,
+							 const UInt* ipOffsets) {
+	UInt    iStroke;
+	UInt    iPathLen;
+	ULong   iThisScore;
+	ULong   iScore = 0;
+
+	for (iStroke = 0; iStroke < pScorer->m_iStrokeCnt; iStroke++) {
+
+		iPathLen = ipOffsets[iStroke+1] - ipOffsets[iStroke];
+		if (iPathLen == 0)
+			break;				/* Description ran out of strokes. */
+
+		iThisScore = StrokeCacheScorePath(pScorer->m_pCaches + iStroke,
+										  cpPaths + ipOffsets[iStroke],
+										  iPathLen);
+
+		iScore = StrokeScoreAddSquare(iScore, iThisScore);
+	}
+
+	return SqrtULong(iScore);
+}
+
+/* ----- StrokeScorerScoreStroke -------------------------------------------*/
+
+ULong StrokeScorerScoreStroke(StrokeScorer *pScorer, UInt iStroke,
+							  CharPtr cpPath, UInt iPathLen) {
+	if (iStroke >= pScorer->m_iStrokeCnt)
+		return diHugeCost;
+
+	return StrokeCacheScorePath(pScorer->m_pCaches + iStroke,
+								cpPath, iPathLen);
+}
+
+/* ----- StrokeScoreAddSquare -----------------------------------------------*/
+/* Add the square of a stroke score to a sum, saturating both. */
+
+ULong StrokeScoreAddSquare(ULong iScore, ULong iThisScore) {
+	if (iThisScore >= diMaxScoreToSquare)
+		iThisScore = diMaxScoreSquared;
+	else
+		iThisScore = (iThisScore * iThisScore);
+
+	if (iScore >= (diMaxScoreSquared - iThisScore))
+		return diMaxScoreSquared;
+	else
+		return iScore + iThisScore;
+}
+
+/* ----- StrokeDicDecodeStroke ----------------------------------------------*/
+
+#define PutCode(n) do { if (cpPathEnd < cpPath + diPathBufLen) *cpPathEnd++ = (n); } while (0)
+
+UInt StrokeDicDecodeStroke(CharPtr* cppEntry, CharPtr cpPath /*OUT*/) {
+	CharPtr cp = *cppEntry;
+	CharPtr cpPathEnd = cpPath;
+	char    c;
+
+	/* The first char is upper case and the ones after it for the same
+	 * stroke are lower case, so fold those up and share the table.
+	 */
+	for (c = *cp; ; c = *++cp - ('a' - 'A')) {
+		switch (c) {		/* Break out on char value... */
+		case 'A':			/* TDR='1' CLK=07:30 DEG=225 */
+			PutCode(20); break;
+		case 'B':			/* TDR='2' CLK=06:00 DEG=180 */
+			PutCode(16); break;
+		case 'C':			/* TDR='3' CLK=04:30 DEG=135 */
+			PutCode(12); break;
+		case 'D':			/* TDR='4' CLK=09:00 DEG=270 */
+			PutCode(24); break;
+		case 'F':			/* TDR='6' CLK=03:00 DEG=090 */
+			PutCode( 8); break;
+		case 'G':			/* TDR='7' CLK=10:30 DEG=315 */
+			PutCode(28); break;
+		case 'H':			/* TDR='8' CLK=12:00 DEG=360 */
+			PutCode( 0); break;
+		case 'I':			/* TDR='9' CLK=01:30 DEG=045 */
+			PutCode( 4); break;
+		case 'J':			/* TDR='x' down   06:00 then 07:30 */
+			PutCode(16); PutCode(20); break;
+		case 'K':			/* TDR='y' down   06:00 then 04:30 */
+			PutCode(16); PutCode(12); break;
+		case 'L':			/* TDR='c' down   06:00 then 03:00 */
+			PutCode(16); PutCode( 8); break;
+		case 'M':			/* TDR='b' across 03:00 then 06:00 */
+			PutCode( 8); PutCode(16); break;
+		default:
+			goto ThisStrokeDone;
+		} /* end switch on char value */
+
+		if (cp[1] < 'a' || cp[1] > 'm') {
+			cp++;
+			goto ThisStrokeDone;
+		}
+	} /* end loop through chars for stroke */
+ThisStrokeDone:
+
+	*cppEntry = cp;
+	return (cpPathEnd - cpPath);
+}
+
+#undef PutCode
+
 /* ----- StrokeDicScoreStroke ---------------------------------------------- */
+/* Score the iLen samples of a raw stroke from iStart against iPathLen
+ * directions of cpPath from iPathStart.  On long paths the same sub-strokes
+ * come up against the same sub-paths over and over while trying the
+ * mid-points, so those scores are remembered by sample range, path range
+ * and depth while the path is being scored.
+ */
 
-ULong StrokeDicScoreStroke(Byte* bpX, Byte* bpY, UInt iLen,
-						   CharPtr cpPath, UInt iPathLen,
-								  UInt iDepth) {
+ULong StrokeDicScoreStroke(StrokeCache* pCache, UInt iStart, UInt iLen,
+						   CharPtr cpPath, UInt iPathStart, UInt iPathLen,
+						   UInt iDepth) {
+	RawStroke* rsp = pCache->m_pRawStroke;
 	ULong iScore, iThisScore;
 	Long iMid, iStep, iPathMid, iPathRest;
 	Long iDifX, iDifY;
-	UInt iAng32, iPath32, iDif32;
+	UInt iAng32, iPath32, iDif32, iEnd, iKey;
+	Boolean bMemo;
 
 	if (iLen < 2 || iPathLen < 1)
 		return diHugeCost;
 
+	iEnd = iStart + iLen - 1;
+
 	if (iPathLen == 1) {
-		iDifX = bpX[iLen-1] - bpX[0];
-		iDifY = bpY[0] - bpY[iLen-1]; /* Flip from display to math axes. */
+		iDifX = ((Long) rsp->m_x[iEnd]) - rsp->m_x[iStart];
+		iDifY = ((Long) rsp->m_y[iStart]) - rsp->m_y[iEnd]; /* Flip from display to math axes. */
 
 		if (iDifX == 0 && iDifY == 0) /* Two samples at same place... */
 			return diHugeCost;
@@ -433,21 +647,28 @@ ULong StrokeDicScoreStroke(Byte* bpX, Byte* bpY, UInt iLen,
 
 			/* Note that we use the middle point on both sides... */
 
-			iScore  = StrokeDicScoreStroke(bpX, bpY, iMid+1,
-										   cpPath, iPathLen, iDepth+1);
+			iScore  = StrokeDicScoreStroke(pCache, iStart, iMid+1,
+										   cpPath, iPathStart, iPathLen, iDepth+1);
 
-			iScore += StrokeDicScoreStroke(bpX+iMid, bpY+iMid, iLen-iMid,
-										   cpPath, iPathLen, iDepth+1);
+			iScore += StrokeDicScoreStroke(pCache, iStart+iMid, iLen-iMid,
+										   cpPath, iPathStart, iPathLen, iDepth+1);
 
 			return (iScore >> 1);
 
 		} /* End if stroke is long, and depth is shallow... */
 
-		/* Time to score this segment against desired direction. */
-		
-		iAng32 = Angle32(iDifX, iDifY);
+		/* Time to score this segment against desired direction.  The
+		 * angle of a sample pair doesn't depend on the path, so it is
+		 * only worked out once per recognition.
+		 */
+
+		iAng32 = pCache->m_bpAngles[iStart * rsp->m_len + iEnd];
+		if (iAng32 == diAngUnknown) {
+			iAng32 = Angle32(iDifX, iDifY);
+			pCache->m_bpAngles[iStart * rsp->m_len + iEnd] = iAng32;
+		}
 
-		iPath32 = *cpPath;
+		iPath32 = cpPath[iPathStart];
 
 		if (iAng32 >= iPath32)
 			iDif32 = iAng32 - iPath32;
@@ -459,24 +680,31 @@ ULong StrokeDicScoreStroke(Byte* bpX, Byte* bpY, UInt iLen,
 	} /* end if path len is 1. */
 	else {
 
+		bMemo = (pCache->m_bPathMemo && iDepth < diMemoMaxDepth);
+		iKey = PathMemoKey(iStart, iLen, iPathStart, iPathLen, iDepth);
+
+		if (bMemo && MemoFind(pCache->m_pPathMemo, iKey, pCache->m_iPathGen, &iScore))
+			return iScore;
+
 		iScore = diHugeCost * iPathLen * 2;
 		iPathMid = iPathLen >> 1;
 		iPathRest = iPathLen - iPathMid;
-		
+
 		if (iLen < 20)
 			iStep = 1;
 		else
 			iStep = iLen / 10;
 
-		for (iMid = iPathMid; iMid < iLen - iPathRest; iMid += iStep) {
+		for (iMid = iPathMid; iMid < (Long) iLen - iPathRest; iMid += iStep) {
 
 			/* TDR original doesn't increase iDepth... -rwells, 970719. */
 
-			iThisScore  = StrokeDicScoreStroke(bpX, bpY, iMid+1,
-											   cpPath, iPathMid, iDepth+1);
+			iThisScore  = StrokeDicScoreStroke(pCache, iStart, iMid+1,
+											   cpPath, iPathStart, iPathMid,
+											   iDepth+1);
 
-			iThisScore += StrokeDicScoreStroke(bpX+iMid, bpY+iMid, iLen-iMid,
-											   cpPath+iPathMid, iPathRest,
+			iThisScore += StrokeDicScoreStroke(pCache, iStart+iMid, iLen-iMid,
+											   cpPath, iPathStart+iPathMid, iPathRest,
 											   iDepth+1);
 
 			/* TDR original doesn't divide sum by 2... -rwells, 970719. */
@@ -487,6 +715,9 @@ ULong StrokeDicScoreStroke(Byte* bpX, Byte* bpY, UInt iLen,
 
 		} /* end for trials on various mid-point divisions of stroke... */
 
+		if (bMemo)
+			MemoStore(pCache->m_pPathMemo, iKey, pCache->m_iPathGen, iScore);
+
 		return iScore;
 	} /* end if path len is >1. */
 }
@@ -495,32 +726,45 @@ ULong StrokeDicScoreStroke(Byte* bpX, Byte* bpY, UInt iLen,
 
 CharPtr StrokeScorerExtraFilters(StrokeScorer *pScorer,
 								 CharPtr cp, ULong* ipScore /*OUT*/) {
+	Byte    bOps[diMaxFilterOps*diFilterOpLen];
+	UInt    iOpCnt;
+
+	cp = StrokeDicDecodeFilters(cp, bOps, &iOpCnt);
+	StrokeScorerApplyFilters(pScorer, bOps, iOpCnt, ipScore);
+
+	return cp;
+}
+
+/* ----- StrokeDicDecodeFilters -----------------------------------------------*/
+
+CharPtr StrokeDicDecodeFilters(CharPtr cp, Byte* bpOps /*OUT*/,
+							   UInt* ipOpCnt /*OUT*/) {
 	char    c;
 	char    cArg[2];
 	Byte    iStroke[2];
-	Long    iDiff, iVal[2];
 	UInt    idx = 0;
 	Boolean bMust = false;
-  
+
 	MemoWrite(" F(");
 
+	*ipOpCnt = 0;
 	cArg[0] = cArg[1] = 0;
 	iStroke[0] = iStroke[1] = 0;
 
     /* Simple parser for Filter strings. assumes a1-b1 structure,
-	 * where a and b can be any single alphabetic cmd char, the 
-	 * numbers can be multiple digit, and b1 can optionally be 
+	 * where a and b can be any single alphabetic cmd char, the
+	 * numbers can be multiple digit, and b1 can optionally be
 	 * followed by '!' to insist on the filter passing.  There can
 	 * be multiple filters but they have to be separated by '!' or
 	 * space(s).  The filter string is terminated by a null byte
-	 * or an 8-bit char, the beginning of the next entry.  
+	 * or an 8-bit char, the beginning of the next entry.
 	 * Leading spaces and trailing spaces are ignored. -rwells, 970722.
 	 */
 
 	for (c = *cp; true; cp++, c = *cp) {
 		switch (c) {
 
-		case 'x': 
+		case 'x':
 		case 'y':
 		case 'i':
 		case 'j':
@@ -563,41 +807,17 @@ CharPtr StrokeScorerExtraFilters(StrokeScorer *pScorer,
 			MemoWrite2d(" @", idx);
 			MemoWrite(")");
 
-			/* If we are in the second argument, execute and reset. */
+			/* If we are in the second argument, save an op and reset. */
 			if (idx == 1) {
-				iVal[0] = StrokeScorerExtraEval(pScorer, cArg[0], iStroke[0]);
-				iVal[1] = StrokeScorerExtraEval(pScorer, cArg[1], iStroke[1]);
-				iDiff = (iVal[0] - iVal[1]);
-
-				MemoWrite(" ");
-				MemoWriteLen(cArg+0, 1);
-				MemoWrite2d("", iStroke[0]);
-				MemoWrite2d(":", iVal[0]);
-				
-				MemoWrite("-");
-				MemoWriteLen(cArg+1, 1);
-				MemoWrite2d("", iStroke[1]);
-				MemoWrite2d(":", iVal[1]);
-				
-				MemoWrite2d("=", iDiff);
-
-				if (iDiff < 0) {
-					iDiff = -iDiff;
-					if (bMust)
-						iDiff = 9999999;
-					if (*ipScore < (diMaxScoreSquared-iDiff))
-						*ipScore += iDiff;
-					else
-						*ipScore = diMaxScoreSquared;
+				if (*ipOpCnt < diMaxFilterOps) {
+					bpOps[0] = cArg[0];
+					bpOps[1] = iStroke[0];
+					bpOps[2] = cArg[1];
+					bpOps[3] = iStroke[1];
+					bpOps[4] = bMust;
+					bpOps += diFilterOpLen;
+					(*ipOpCnt)++;
 				}
-				else {
-					if (*ipScore > iDiff)
-						*ipScore -= iDiff;
-					else
-						*ipScore = 0;
-				}
-
-				MemoWrite2d(" ips=", *ipScore);
 
 				/* Reset state for next filter... */
 				idx = 0;
@@ -615,6 +835,46 @@ ReturnNow:
 	return cp;
 }
 
+/* ----- StrokeScorerApplyFilters ---------------------------------------------*/
+
+void StrokeScorerApplyFilters(StrokeScorer *pScorer, const Byte* bpOps,
+							  UInt iOpCnt, ULong* ipScore /*IN/OUT*/) {
+	Long    iDiff, iVal[2];
+	UInt    i;
+
+	for (i = 0; i < iOpCnt; i++, bpOps += diFilterOpLen) {
+		iVal[0] = StrokeScorerExtraEval(pScorer, bpOps[0], bpOps[1]);
+		iVal[1] = StrokeScorerExtraEval(pScorer, bpOps[2], bpOps[3]);
+		iDiff = (iVal[0] - iVal[1]);
+
+		MemoWrite(" ");
+		MemoWrite2d("", bpOps[1]);
+		MemoWrite2d(":", iVal[0]);
+		MemoWrite("-");
+		MemoWrite2d("", bpOps[3]);
+		MemoWrite2d(":", iVal[1]);
+		MemoWrite2d("=", iDiff);
+
+		if (iDiff < 0) {
+			iDiff = -iDiff;
+			if (bpOps[4])
+				iDiff = 9999999;
+			if (*ipScore < (diMaxScoreSquared-iDiff))
+				*ipScore += iDiff;
+			else
+				*ipScore = diMaxScoreSquared;
+		}
+		else {
+			if (*ipScore > iDiff)
+				*ipScore -= iDiff;
+			else
+				*ipScore = 0;
+		}
+
+		MemoWrite2d(" ips=", *ipScore);
+	}
+}
+
 /* ----- StrokeScorerExtraEval ------------------------------------------------*/
 
 Long StrokeScorerExtraEval(StrokeScorer *pScorer,
@@ -0,0 +1,228 @@
+/******************************************************************************
+    AUTHOR:
+    File written and Copyrighted by Zachary Dovel. All Rights Reserved.
+
+    LICENSE:
+    This file is part of gWaei.
+
+    gWaei is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    gWaei is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    
+    You should have received a copy of the GNU General Public License
+    along with gWaei.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+
+//!
+//! @file levenshtein.c
+//!
+//! @brief A Levenshtein automaton for fuzzy matching of dictionary terms
+//!
+//! The states are rows of the edit distance table between the pattern and
+//! the characters stepped so far.  Cells are capped at max_distance + 1, so
+//! there are only finitely many states and a row whose every cell is capped
+//! can never lead to a match.  Stepping is O(pattern length), and because a
+//! row only depends on the characters before it, walking a sorted term list
+//! can reuse the rows of the prefix shared with the previous term.
+//!
+
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <glib.h>
+
+#include <libwaei/libwaei.h>
+
+
+//!
+//! @brief Creates a new LwLevenshtein object
+//! @param PATTERN The UTF-8 string to match against
+//! @param max_distance How many edits away from the pattern a match can be
+//! @return An allocated LwLevenshtein that will be needed to be freed by lw_levenshtein_free.
+//!
+LwLevenshtein* 
+lw_levenshtein_new (const gchar *PATTERN, gint max_distance)
+{
+    LwLevenshtein *temp;
+
+    temp = (LwLevenshtein*) malloc(sizeof(LwLevenshtein));
+
+    if (temp != NULL)
+    {
+      lw_levenshtein_init (temp, PATTERN, max_distance);
+    }
+
+    return temp;
+}
+
+
+//!
+//! @brief Releases a LwLevenshtein object from memory.
+//! @param automaton A LwLevenshtein object created by lw_levenshtein_new.
+//!
+void 
+lw_levenshtein_free (LwLevenshtein *automaton)
+{
+    lw_levenshtein_deinit (automaton);
+    free (automaton);
+}
+
+
+//!
+//! @brief Used to initialize the memory inside of a new LwLevenshtein
+//!        object.  Usually lw_levenshtein_new calls this for you.
+//! @param automaton The LwLevenshtein to initialize
+//! @param PATTERN The UTF-8 string to match against
+//! @param max_distance How many edits away from the pattern a match can be
+//!
+void 
+lw_levenshtein_init (LwLevenshtein *automaton, const gchar *PATTERN, gint max_distance)
+{
+    //Declarations
+    glong length;
+
+    //Initializations
+    automaton->pattern = g_utf8_to_ucs4_fast (PATTERN, -1, &length);
+    automaton->length = length;
+    automaton->max_distance = CLAMP (max_distance, 0, LW_LEVENSHTEIN_MAX_DISTANCE);
+}
+
+
+//!
+//! @brief Used to free the memory inside of a LwLevenshtein object.
+//!        Usually lw_levenshtein_free calls this for you.
+//! @param automaton The LwLevenshtein to deinitialize
+//!
+void 
+lw_levenshtein_deinit (LwLevenshtein *automaton)
+{
+    g_free (automaton->pattern);
+    automaton->pattern = NULL;
+    automaton->length = 0;
+}
+
+
+//!
+//! @brief How many gints a state of the automaton takes
+//! @param automaton An LwLevenshtein
+//! @returns The length of the arrays to pass as states
+//!
+gint 
+lw_levenshtein_get_state_size (LwLevenshtein *automaton)
+{
+    return automaton->length + 1;
+}
+
+
+//!
+//! @brief Writes the state before any characters have been read
+//! @param automaton An LwLevenshtein
+//! @param state An array of lw_levenshtein_get_state_size gints to write to
+//!
+void 
+lw_levenshtein_start (LwLevenshtein *automaton, gint *state)
+{
+    //Declarations
+    gint i;
+
+    for (i = 0; i <= automaton->length; i++)
+      state[i] = MIN (i, automaton->max_distance + 1);
+}
+
+
+//!
+//! @brief Moves the automaton along one character
+//! @param automaton An LwLevenshtein
+//! @param STATE The current state
+//! @param c The next character of the string being matched
+//! @param next An array to write the new state to.  It must not be STATE.
+//! @returns FALSE when no string starting with the characters read so far can match
+//!
+gboolean 
+lw_levenshtein_step (LwLevenshtein *automaton, const gint *STATE, gunichar c, gint *next)
+{
+    //Declarations
+    gint cap;
+    gint cost;
+    gint best;
+    gint i;
+
+    //Initializations
+    cap = automaton->max_distance + 1;
+    next[0] = MIN (STATE[0] + 1, cap);
+    best = next[0];
+
+    for (i = 1; i <= automaton->length; i++)
+    {
+      cost = STATE[i - 1] + (automaton->pattern[i - 1] != c);
+      cost = MIN (cost, STATE[i] + 1);
+      cost = MIN (cost, next[i - 1] + 1);
+      next[i] = MIN (cost, cap);
+      if (next[i] < best) best = next[i];
+    }
+
+    return (best < cap);
+}
+
+
+//!
+//! @brief The edit distance of the characters read so far from the pattern
+//! @param automaton An LwLevenshtein
+//! @param STATE The current state
+//! @returns The distance or -1 if it is past the max distance
+//!
+gint 
+lw_levenshtein_get_distance (LwLevenshtein *automaton, const gint *STATE)
+{
+    if (STATE[automaton->length] > automaton->max_distance) return -1;
+    return STATE[automaton->length];
+}
+
+
+//!
+//! @brief Runs a whole string through the automaton
+//! @param automaton An LwLevenshtein
+//! @param TEXT A UTF-8 string to match
+//! @returns The edit distance of TEXT from the pattern or -1 if it is too far
+//!
+gint 
+lw_levenshtein_match (LwLevenshtein *automaton, const gchar *TEXT)
+{
+    //Declarations
+    gint *state;
+    gint *next;
+    gint *temp;
+    const gchar *ptr;
+    gint distance;
+    gboolean alive;
+
+    //Initializations
+    state = g_new (gint, lw_levenshtein_get_state_size (automaton));
+    next = g_new (gint, lw_levenshtein_get_state_size (automaton));
+    alive = TRUE;
+
+    lw_levenshtein_start (automaton, state);
+
+    for (ptr = TEXT; *ptr != '\0' && alive; ptr = g_utf8_next_char (ptr))
+    {
+      alive = lw_levenshtein_step (automaton, state, g_utf8_get_char (ptr), next);
+      temp = state; state = next; next = temp;
+    }
+
+    distance = (alive) ? lw_levenshtein_get_distance (automaton, state) : -1;
+
+    //Cleanup
+    g_free (state);
+    g_free (next);
+
+    return distance;
+}
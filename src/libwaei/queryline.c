@@ -36,6 +36,9 @@
 static GRegex*** _queryline_allocate_pointers (int);
 static void _queryline_free_pointers (LwQueryLine*);
 static char** _queryline_initialize_pointers (LwQueryLine*, const char*);
+static gboolean _queryline_parse_fuzzy (LwQueryLine*, const char*, gboolean);
+static gboolean _queryline_add_romaji_literals (LwQueryLine*, const char*, int);
+static void _queryline_finish_romaji_literals (LwQueryLine*, gboolean);
 
 
 //!
@@ -88,6 +91,10 @@ lw_queryline_init (LwQueryLine *ql)
     ql->re_frequency = NULL;
     ql->re_grade = NULL;
     ql->re_jlpt = NULL;
+    ql->roma_literals = NULL;
+    ql->roma_literals_mask = 0;
+    ql->fuzzy = NULL;
+    ql->fuzzy_distance = 0;
 }
 
 
@@ -137,6 +144,8 @@ static void _queryline_free_pointers (LwQueryLine *ql)
    _free_regex_pointer (ql->re_frequency);
    _free_regex_pointer (ql->re_grade);
    _free_regex_pointer (ql->re_jlpt);
+   if (ql->roma_literals != NULL) lw_ahocorasick_free (ql->roma_literals);
+   g_strfreev (ql->fuzzy);
 
    ql->string = NULL;
    ql->re_kanji = NULL;
@@ -147,6 +156,91 @@ static void _queryline_free_pointers (LwQueryLine *ql)
    ql->re_frequency = NULL;
    ql->re_grade = NULL;
    ql->re_jlpt = NULL;
+   ql->roma_literals = NULL;
+   ql->roma_literals_mask = 0;
+   ql->fuzzy = NULL;
+   ql->fuzzy_distance = 0;
+}
+
+
+//!
+//! @brief Adds the alternatives of a romaji atom to the literal automaton if the
+//!        atom is nothing more than words separated by |.  Anything else a regex
+//!        could make of it, including non-ASCII letters that PCRE folds by case,
+//!        has to go through the regexes.
+//! @param ql The LwQueryLine being parsed
+//! @param ATOM The stripped romaji atom
+//! @param index The index of the atom in the romaji regexes
+//! @returns TRUE if the atom was added
+//!
+static gboolean 
+_queryline_add_romaji_literals (LwQueryLine *ql, const char *ATOM, int index)
+{
+    //Sanity check
+    if (index >= 32) return FALSE;
+
+    //Declarations
+    char **alternatives;
+    char **iter;
+    const char *ptr;
+    gboolean is_literal;
+
+    //Initializations
+    is_literal = TRUE;
+
+    for (ptr = ATOM; *ptr != '\0' && is_literal; ptr++)
+    {
+      if ((guchar) *ptr >= 0x80 || strchr ("\\^$.?*+()[]{}", *ptr) != NULL) is_literal = FALSE;
+    }
+    if (!is_literal) return FALSE;
+
+    //An empty alternative matches everything
+    alternatives = g_strsplit (ATOM, "|", -1);
+    for (iter = alternatives; *iter != NULL && is_literal; iter++)
+    {
+      if (**iter == '\0') is_literal = FALSE;
+    }
+
+    if (is_literal)
+    {
+      if (ql->roma_literals == NULL)
+      {
+        ql->roma_literals = lw_ahocorasick_new ();
+        lw_ahocorasick_set_ignore_case (ql->roma_literals, TRUE);
+      }
+      for (iter = alternatives; *iter != NULL; iter++)
+        lw_ahocorasick_add (ql->roma_literals, *iter, GINT_TO_POINTER (index));
+      ql->roma_literals_mask |= (1u << index);
+    }
+
+    //Cleanup
+    g_strfreev (alternatives);
+
+    return is_literal;
+}
+
+
+//!
+//! @brief Compiles the literal automaton once every romaji atom was added or drops
+//!        it when one of them needs its regexes anyway
+//! @param ql The LwQueryLine being parsed
+//! @param all_literal Whether every romaji atom was added to the automaton
+//!
+static void 
+_queryline_finish_romaji_literals (LwQueryLine *ql, gboolean all_literal)
+{
+    if (ql->roma_literals == NULL) return;
+
+    if (all_literal)
+    {
+      lw_ahocorasick_compile (ql->roma_literals);
+    }
+    else
+    {
+      lw_ahocorasick_free (ql->roma_literals);
+      ql->roma_literals = NULL;
+      ql->roma_literals_mask = 0;
+    }
 }
    
 
@@ -200,6 +294,94 @@ static GRegex*** _queryline_allocate_pointers (int length)
 }
 
 
+//!
+//! @brief Reads a query like "acomodate~" or "みづ~1" into the fuzzy terms.  Romaji
+//!        is looked up both as an English word and as the hiragana it spells.
+//! @param ql The LwQueryLine to write the terms to
+//! @param ATOM The whole query
+//! @param want_rk_conv Whether romaji should also be looked up as kana
+//! @returns FALSE if the query isn't a fuzzy one
+//!
+static gboolean _queryline_parse_fuzzy (LwQueryLine *ql, const char *ATOM, gboolean want_rk_conv)
+{
+    //Declarations
+    const char *marker;
+    char *term;
+    char *temp;
+    char buffer[300];
+    int distance;
+    gboolean is_word;
+    GPtrArray *terms;
+
+    //Initializations
+    marker = strrchr (ATOM, LW_QUERYLINE_FUZZY_MARKER);
+    if (marker == NULL) return FALSE;
+
+    if (marker[1] == '\0')
+      distance = -1;
+    else if (g_ascii_isdigit (marker[1]) && marker[2] == '\0')
+      distance = marker[1] - '0';
+    else
+      return FALSE;
+
+    term = g_strndup (ATOM, marker - ATOM);
+    g_strstrip (term);
+    is_word = (*term != '\0' && strchr (term, ' ') == NULL); //The index only has single words
+    terms = g_ptr_array_new ();
+
+    if (is_word && lw_util_is_furigana_str (term))
+    {
+      temp = g_strdup (term);
+      if (lw_termindex_normalize_reading (temp)) g_ptr_array_add (terms, temp);
+      else g_free (temp);
+    }
+    else if (is_word && lw_util_is_romaji_str (term))
+    {
+      g_ptr_array_add (terms, g_ascii_strdown (term, -1));
+      if (want_rk_conv && lw_util_str_roma_to_hira (term, buffer, 300) && lw_termindex_normalize_reading (buffer))
+        g_ptr_array_add (terms, g_strdup (buffer));
+    }
+
+    //Cleanup
+    g_free (term);
+
+    if (terms->len == 0)
+    {
+      g_ptr_array_free (terms, TRUE);
+      return FALSE;
+    }
+
+    g_ptr_array_add (terms, NULL);
+    ql->fuzzy = (char**) g_ptr_array_free (terms, FALSE);
+    ql->fuzzy_distance = MIN (distance, LW_LEVENSHTEIN_MAX_DISTANCE);
+
+    return TRUE;
+}
+
+
+//!
+//! @brief Gets how many edits away from one of the fuzzy terms a match can be.
+//!        When the query didn't give a distance, two letter words have to match
+//!        exactly and three or four letter words get one edit, since every short
+//!        word is a couple of edits from hundreds of others.
+//! @param ql A LwQueryLine with fuzzy terms
+//! @param TERM One of the fuzzy terms
+//! @returns The max edit distance for the term
+//!
+int 
+lw_queryline_get_fuzzy_distance (LwQueryLine *ql, const char *TERM)
+{
+    //Declarations
+    int length;
+
+    if (ql->fuzzy_distance >= 0) return ql->fuzzy_distance;
+
+    length = g_utf8_strlen (TERM, -1);
+
+    return MIN (LW_QUERYLINE_FUZZY_DISTANCE, (length - 1) / 2);
+}
+
+
 //!
 //! @brief Parses a query using the edict style
 //! @param ql Pointer to a LwQueryLine object ot parse a query string into.
@@ -233,12 +415,14 @@ lw_queryline_parse_edict_string (LwQueryLine *ql, LwPreferences *pm, const char*
    gboolean want_hk_conv;
    gboolean want_kh_conv;
    gboolean all_regex_built;
+   gboolean all_literal;
    int length;
    GRegex ***re;
    int i;
 
    //Memory initializations
    all_regex_built = TRUE;
+   all_literal = TRUE;
 
    if (pm != NULL)
    {
@@ -258,6 +442,13 @@ lw_queryline_parse_edict_string (LwQueryLine *ql, LwPreferences *pm, const char*
    atoms = _queryline_initialize_pointers (ql, STRING);
    length = g_strv_length (atoms);
 
+   //A fuzzy query is looked up in the term index instead of matched with regexes
+   if (length == 1 && _queryline_parse_fuzzy (ql, atoms[0], want_rk_conv))
+   {
+     g_strfreev (atoms);
+     return TRUE;
+   }
+
    //Setup the expression to be used in the base of the regex for kanji-ish strings
    re = ql->re_kanji;
    for (iter = atoms; *iter != NULL && re < (ql->re_kanji + length); iter++)
@@ -370,11 +561,13 @@ lw_queryline_parse_edict_string (LwQueryLine *ql, LwPreferences *pm, const char*
        //Compile the regexes
        for (i = 0; i < LW_RELEVANCE_TOTAL; i++)
          if (((*re)[i] = lw_regex_romaji_new (expression, LW_DICTTYPE_EDICT, i, error)) == NULL) all_regex_built = FALSE;
+       if (!_queryline_add_romaji_literals (ql, atom, re - ql->re_roma)) all_literal = FALSE;
 
        g_free (expression);
        re++;
      }
    }  
+   _queryline_finish_romaji_literals (ql, all_literal);
 
 
    //Setup the expression to be used in the base of the regex
@@ -636,6 +829,7 @@ lw_queryline_parse_exampledict_string (LwQueryLine *ql, LwPreferences* pm, const
     gboolean want_hk_conv;
     gboolean want_kh_conv;
     gboolean all_regex_built;
+    gboolean all_literal;
     int length;
     int i;
     GRegex ***re;
@@ -644,6 +838,7 @@ lw_queryline_parse_exampledict_string (LwQueryLine *ql, LwPreferences* pm, const
     char *expression;
 
     //Initializations
+    all_literal = TRUE;
     if (pm != NULL)
     {
       rk_conv_pref = lw_preferences_get_int_by_schema (pm, LW_SCHEMA_BASE, LW_KEY_ROMAN_KANA);
@@ -743,11 +938,13 @@ lw_queryline_parse_exampledict_string (LwQueryLine *ql, LwPreferences* pm, const
        //Compile the regexes
         for (i = 0; i < LW_RELEVANCE_TOTAL; i++)
           if (((*re)[i] = lw_regex_romaji_new (expression, LW_DICTTYPE_EDICT, i, error)) == NULL) all_regex_built = FALSE;
+        if (!_queryline_add_romaji_literals (ql, atom, re - ql->re_roma)) all_literal = FALSE;
  
         g_free (expression);
         re++;
       }
     }  
+    _queryline_finish_romaji_literals (ql, all_literal);
 
     //Cleanup
     g_strfreev (atoms);
@@ -99,6 +99,9 @@ lw_resultline_init (LwResultLine *rl)
     rl->jlpt = NULL;
     rl->kanji = NULL;
     rl->radicals = NULL;
+
+    //Match spans
+    rl->match_total = 0;
 }
 
 
@@ -491,3 +494,81 @@ lw_resultline_is_similar (LwResultLine *rl1, LwResultLine *rl2)
     return (same_first_def && same_def_totals);
 }
 
+
+
+//!
+//! @brief Gets the start of one of the parsed fields of a result line
+//! @param rl The LwResultLine to get the field of
+//! @param FIELD The LwResultLineField to get
+//! @param index The index of the definition or reading when the field has many
+//! @returns A pointer into the string of the result line or NULL if the field isn't set
+//!
+const char* 
+lw_resultline_get_field (LwResultLine *rl, LwResultLineField FIELD, int index)
+{
+    switch (FIELD)
+    {
+      case LW_RESULTLINE_FIELD_STRING:
+        return rl->string;
+      case LW_RESULTLINE_FIELD_KANJI:
+        return rl->kanji_start;
+      case LW_RESULTLINE_FIELD_FURIGANA:
+        return rl->furigana_start;
+      case LW_RESULTLINE_FIELD_DEFINITION:
+        if (index < 0 || index >= G_N_ELEMENTS (rl->def_start)) return NULL;
+        return rl->def_start[index];
+      case LW_RESULTLINE_FIELD_CHARACTER:
+        return rl->kanji;
+      case LW_RESULTLINE_FIELD_RADICALS:
+        return rl->radicals;
+      case LW_RESULTLINE_FIELD_READING:
+        if (index < 0 || index >= G_N_ELEMENTS (rl->readings)) return NULL;
+        return rl->readings[index];
+      case LW_RESULTLINE_FIELD_MEANINGS:
+        return rl->meanings;
+      default:
+        return NULL;
+    }
+}
+
+
+//!
+//! @brief Forgets the match spans of a result line
+//! @param rl The LwResultLine to clear the matches of
+//!
+void 
+lw_resultline_clear_matches (LwResultLine *rl)
+{
+    rl->match_total = 0;
+}
+
+
+//!
+//! @brief Records where a query atom matched in a field of the result line
+//! @param rl The LwResultLine to add the match to
+//! @param FIELD The LwResultLineField the match is in
+//! @param index The index of the definition or reading when the field has many
+//! @param start The byte offset of the start of the match in the field
+//! @param end The byte offset of the end of the match in the field
+//! @returns FALSE when there was no room left for the match
+//!
+gboolean 
+lw_resultline_add_match (LwResultLine *rl, LwResultLineField FIELD, int index, int start, int end)
+{
+    //Declarations
+    LwResultLineMatch *match;
+
+    if (rl->match_total >= LW_RESULTLINE_MAX_MATCHES) return FALSE;
+    if (start < 0 || end <= start || end > G_MAXUINT16) return FALSE;
+
+    //Initializations
+    match = &rl->matches[rl->match_total];
+
+    match->field = FIELD;
+    match->index = index;
+    match->start = start;
+    match->end = end;
+    rl->match_total++;
+
+    return TRUE;
+}
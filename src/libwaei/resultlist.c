@@ -0,0 +1,303 @@
+/******************************************************************************
+    AUTHOR:
+    File written and Copyrighted by Zachary Dovel. All Rights Reserved.
+
+    LICENSE:
+    This file is part of gWaei.
+
+    gWaei is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    gWaei is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    
+    You should have received a copy of the GNU General Public License
+    along with gWaei.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+//!
+//! @file resultlist.c
+//!
+//! @brief A compact store for many search results
+//!
+
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <glib.h>
+
+#include <libwaei/libwaei.h>
+
+#define LW_RESULTLIST_FIXED_FIELDS 13
+
+//!
+//! @brief One result.  The offsets of the LwResultLine pointers are followed by
+//!        the match spans and then the bytes of the line they point into.  An
+//!        offset of -1 is a NULL pointer.
+//!
+struct _LwResultListEntry {
+  guint16 length;           //!< Bytes of text after the offsets and matches
+  guint8 relevance;
+  guint8 important;
+  guint8 def_total;         //!< Number of def_start and number pointers stored
+  guint8 match_total;       //!< Number of LwResultLineMatch spans stored
+  gint16 offsets[];
+};
+typedef struct _LwResultListEntry LwResultListEntry;
+
+
+//!
+//! @brief Lists the addresses of the pointers of a LwResultLine
+//! @returns The number of addresses written
+//!
+static int 
+_resultlist_get_fields (LwResultLine *resultline, char **fields[], int def_total)
+{
+    int i;
+    int n;
+
+    n = 0;
+    fields[n++] = &resultline->kanji_start;
+    fields[n++] = &resultline->furigana_start;
+    fields[n++] = &resultline->classification_start;
+    fields[n++] = &resultline->strokes;
+    fields[n++] = &resultline->frequency;
+    fields[n++] = &resultline->readings[0];
+    fields[n++] = &resultline->readings[1];
+    fields[n++] = &resultline->readings[2];
+    fields[n++] = &resultline->meanings;
+    fields[n++] = &resultline->grade;
+    fields[n++] = &resultline->jlpt;
+    fields[n++] = &resultline->kanji;
+    fields[n++] = &resultline->radicals;
+
+    for (i = 0; i < def_total; i++)
+    {
+      fields[n++] = &resultline->def_start[i];
+      fields[n++] = &resultline->number[i];
+    }
+
+    return n;
+}
+
+
+static gboolean 
+_resultlist_is_internal (LwResultLine *resultline, const char *ptr)
+{
+    return (ptr >= resultline->string && ptr < resultline->string + LW_IO_MAX_FGETS_LINE);
+}
+
+
+LwResultList* 
+lw_resultlist_new ()
+{
+    LwResultList *temp;
+
+    temp = (LwResultList*) malloc(sizeof(LwResultList));
+
+    if (temp != NULL)
+    {
+      lw_resultlist_init (temp);
+    }
+
+    return temp;
+}
+
+
+void 
+lw_resultlist_free (LwResultList *list)
+{
+    lw_resultlist_deinit (list);
+
+    free (list);
+}
+
+
+void 
+lw_resultlist_init (LwResultList *list)
+{
+    list->entries = g_ptr_array_new_with_free_func (g_free);
+    list->size = 0;
+}
+
+
+void 
+lw_resultlist_deinit (LwResultList *list)
+{
+    g_ptr_array_free (list->entries, TRUE);
+    list->entries = NULL;
+    list->size = 0;
+}
+
+
+//!
+//! @brief Removes all of the results from the list
+//! @param list The LwResultList to empty
+//!
+void 
+lw_resultlist_clear (LwResultList *list)
+{
+    g_ptr_array_set_size (list->entries, 0);
+    list->size = 0;
+}
+
+
+//!
+//! @brief Stores a compact copy of a parsed result.  Only the bytes the result
+//!        pointers reach are kept.
+//! @param list The LwResultList to append to
+//! @param resultline A parsed LwResultLine.  It is not modified.
+//! @returns The index of the new entry
+//!
+guint 
+lw_resultlist_append (LwResultList *list, LwResultLine *resultline)
+{
+    //Declarations
+    LwResultListEntry *entry;
+    char **fields[LW_RESULTLIST_FIXED_FIELDS + 100];
+    LwResultLineMatch *matches;
+    char *text;
+    char *ptr;
+    gsize used;
+    gsize external;
+    gsize end;
+    gsize size;
+    int def_total;
+    int total;
+    int i;
+
+    //Initializations
+    for (def_total = 0; def_total < 49 && resultline->def_start[def_total] != NULL; def_total++);
+    total = _resultlist_get_fields (resultline, fields, def_total);
+    used = 0;
+    external = 0;
+
+    //Find how much of the line buffer is in use and the size of the strings outside of it
+    for (i = 0; i < total; i++)
+    {
+      ptr = *fields[i];
+      if (ptr == NULL) continue;
+      if (_resultlist_is_internal (resultline, ptr))
+      {
+        end = (ptr - resultline->string) + strlen (ptr) + 1;
+        if (end > used) used = end;
+      }
+      else
+      {
+        external += strlen (ptr) + 1;
+      }
+    }
+    size = sizeof(LwResultListEntry) + sizeof(gint16) * total + 
+           sizeof(LwResultLineMatch) * resultline->match_total + used + external;
+    entry = (LwResultListEntry*) g_malloc (size);
+    entry->relevance = resultline->relevance;
+    entry->important = resultline->important;
+    entry->def_total = def_total;
+    entry->match_total = resultline->match_total;
+    matches = (LwResultLineMatch*) (entry->offsets + total);
+    memcpy (matches, resultline->matches, sizeof(LwResultLineMatch) * entry->match_total);
+    text = (char*) (matches + entry->match_total);
+    memcpy (text, resultline->string, used);
+    end = used;
+
+    for (i = 0; i < total; i++)
+    {
+      ptr = *fields[i];
+      if (ptr == NULL)
+      {
+        entry->offsets[i] = -1;
+      }
+      else if (_resultlist_is_internal (resultline, ptr))
+      {
+        entry->offsets[i] = ptr - resultline->string;
+      }
+      else
+      {
+        strcpy (text + end, ptr);
+        entry->offsets[i] = end;
+        end += strlen (ptr) + 1;
+      }
+    }
+    entry->length = end;
+
+    g_ptr_array_add (list->entries, entry);
+    list->size += size;
+
+    return list->entries->len - 1;
+}
+
+
+//!
+//! @brief Rebuilds a stored result into a LwResultLine.  A string that doesn't
+//!        fit in the line buffer after the line itself is left in the list,
+//!        so it is only valid until the list is cleared.
+//! @param list The LwResultList to read from
+//! @param index The index of the entry
+//! @param resultline A LwResultLine to overwrite with the entry
+//! @returns FALSE if the index is out of range
+//!
+gboolean 
+lw_resultlist_get (LwResultList *list, guint index, LwResultLine *resultline)
+{
+    //Declarations
+    LwResultListEntry *entry;
+    char **fields[LW_RESULTLIST_FIXED_FIELDS + 100];
+    LwResultLineMatch *matches;
+    char *text;
+    gsize copied;
+    int total;
+    int i;
+
+    if (index >= list->entries->len) return FALSE;
+
+    //Initializations
+    entry = g_ptr_array_index (list->entries, index);
+    lw_resultline_init (resultline);
+    total = _resultlist_get_fields (resultline, fields, entry->def_total);
+    matches = (LwResultLineMatch*) (entry->offsets + total);
+    text = (char*) (matches + entry->match_total);
+
+    copied = MIN (entry->length, LW_IO_MAX_FGETS_LINE);
+    memcpy (resultline->string, text, copied);
+    for (i = 0; i < total; i++)
+    {
+      if (entry->offsets[i] < 0)
+        *fields[i] = NULL;
+      else if (entry->offsets[i] + strlen (text + entry->offsets[i]) < copied)
+        *fields[i] = resultline->string + entry->offsets[i];
+      else
+        *fields[i] = text + entry->offsets[i];
+    }
+    resultline->def_start[entry->def_total] = NULL;
+    resultline->number[entry->def_total] = NULL;
+    resultline->def_total = entry->def_total;
+    resultline->relevance = entry->relevance;
+    resultline->important = entry->important;
+    memcpy (resultline->matches, matches, sizeof(LwResultLineMatch) * entry->match_total);
+    resultline->match_total = entry->match_total;
+
+    return TRUE;
+}
+
+
+guint 
+lw_resultlist_length (LwResultList *list)
+{
+    return list->entries->len;
+}
+
+
+//!
+//! @brief The memory held by the entries, for comparing with a text buffer
+//!
+gsize 
+lw_resultlist_get_size (LwResultList *list)
+{
+    return list->size;
+}
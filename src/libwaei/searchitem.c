@@ -32,6 +32,18 @@
 
 #include <libwaei/libwaei.h>
 
+//!
+//! @brief A GSource that dispatches when a LwSearchItem has results ready
+//!        or its search has ended
+//!
+struct _LwSearchItemSource {
+  GSource source;
+  LwSearchItem *item;       //!< NULL once the item has been freed
+  gboolean pending;         //!< Set by lw_searchitem_notify_sources.  Guarded by the item mutex.
+};
+typedef struct _LwSearchItemSource LwSearchItemSource;
+
+
 static gboolean _query_is_sane (const char* query)
 {
     //Declarations
@@ -111,24 +123,17 @@ lw_searchitem_free (LwSearchItem* item)
 
 
 //!
-//! @brief Used to initialize the memory inside of a new LwSearchItem
-//!        object.  Usually lw_searchitem_new calls this for you.  It is also 
-//!        used in class implimentations that extends LwSearchItem.
-//! @param item A LwSearchItem to initialize the inner variables of
-//! @param query The text to be search for
-//! @param dictionary The LwDictInfo object to use
-//! @param TARGET The widget to output the results to
-//! @param pm The Application preference manager to get information from
-//! @param error A GError to place errors into or NULL
+//! @brief Sets up everything of a LwSearchItem but its queryline
 //!
-void 
-lw_searchitem_init (LwSearchItem *item, const char* query, LwDictInfo* dictionary, LwPreferences *pm, GError **error)
+static void 
+_searchitem_init_state (LwSearchItem *item, LwDictInfo* dictionary)
 {
     item->results_high = NULL;
     item->results_medium = NULL;
     item->results_low = NULL;
     item->thread = NULL;
     item->mutex = g_mutex_new ();
+    item->sources = NULL;
 
     //Set the internal pointers to the correct global variables
     item->fd = NULL;
@@ -142,8 +147,30 @@ lw_searchitem_init (LwSearchItem *item, const char* query, LwDictInfo* dictionar
     item->total_results = 0;
     item->current = 0L;
     item->resultline = NULL;
-    item->queryline = lw_queryline_new ();
     item->history_relevance_idle_timer = 0;
+    item->timer = g_timer_new ();
+    memset (&item->stats, 0, sizeof(LwSearchStats));
+    item->stats.first_result_time = -1.0;
+}
+
+
+//!
+//! @brief Used to initialize the memory inside of a new LwSearchItem
+//!        object.  Usually lw_searchitem_new calls this for you.  It is also 
+//!        used in class implimentations that extends LwSearchItem.
+//! @param item A LwSearchItem to initialize the inner variables of
+//! @param query The text to be search for
+//! @param dictionary The LwDictInfo object to use
+//! @param TARGET The widget to output the results to
+//! @param pm The Application preference manager to get information from
+//! @param error A GError to place errors into or NULL
+//!
+void 
+lw_searchitem_init (LwSearchItem *item, const char* query, LwDictInfo* dictionary, LwPreferences *pm, GError **error)
+{
+    _searchitem_init_state (item, dictionary);
+    item->queryline = lw_queryline_new ();
+    item->shares_queryline = FALSE;
 
     //Set function pointers
     switch (item->dictionary->type)
@@ -161,6 +188,34 @@ lw_searchitem_init (LwSearchItem *item, const char* query, LwDictInfo* dictionar
           lw_queryline_parse_edict_string (item->queryline, pm, query, error);
           break;
     }
+
+    item->stats.compile_time = g_timer_elapsed (item->timer, NULL);
+}
+
+
+//!
+//! @brief Creates a new LwSearchItem for a query that was already parsed.  The
+//!        queryline is only read while searching, so the items of many threads
+//!        can share one.  It isn't freed with the item.
+//! @param queryline A LwQueryLine parsed for the type of the dictionary, often the one of another item
+//! @param dictionary The LwDictInfo object to use
+//! @return Returns an allocated LwSearchItem object that should be freed with lw_searchitem_free
+//!
+LwSearchItem* 
+lw_searchitem_new_with_queryline (LwQueryLine *queryline, LwDictInfo* dictionary)
+{
+    LwSearchItem *temp;
+
+    temp = (LwSearchItem*) malloc(sizeof(LwSearchItem));
+
+    if (temp != NULL)
+    {
+      _searchitem_init_state (temp, dictionary);
+      temp->queryline = queryline;
+      temp->shares_queryline = TRUE;
+    }
+
+    return temp;
 }
 
 
@@ -173,20 +228,39 @@ lw_searchitem_init (LwSearchItem *item, const char* query, LwDictInfo* dictionar
 void 
 lw_searchitem_deinit (LwSearchItem *item)
 {
+    //Declarations
+    GSList *sources;
+    GSList *link;
+
     if (item->thread != NULL) 
     {
       item->status = LW_SEARCHSTATUS_CANCELING;
       g_thread_join (item->thread);
       item->thread = NULL;
     }
+
+    //Detach the watches so they never look at the freed item
+    g_mutex_lock (item->mutex);
+    sources = item->sources;
+    item->sources = NULL;
+    for (link = sources; link != NULL; link = link->next)
+      ((LwSearchItemSource*) link->data)->item = NULL;
+    g_mutex_unlock (item->mutex);
+
+    for (link = sources; link != NULL; link = link->next)
+      g_source_destroy ((GSource*) link->data);
+    g_slist_free (sources);
+
     lw_searchitem_clear_results (item);
     lw_searchitem_cleanup_search (item);
-    lw_queryline_free (item->queryline);
+    if (!item->shares_queryline) lw_queryline_free (item->queryline);
     if (lw_searchitem_has_data (item))
       lw_searchitem_free_data (item);
 
     g_mutex_free (item->mutex);
     item->mutex = NULL;
+    g_timer_destroy (item->timer);
+    item->timer = NULL;
 }
 
 
@@ -251,6 +325,8 @@ lw_searchitem_prepare_search (LwSearchItem* item)
       g_free (path);
     }
 
+    lw_searchitem_stats_begin (item);
+
     item->status = LW_SEARCHSTATUS_SEARCHING;
 }
 
@@ -289,12 +365,117 @@ lw_searchitem_cleanup_search (LwSearchItem* item)
 }
 
 
-static gboolean _edict_existance_comparison (LwQueryLine *ql, LwResultLine *rl, const LwRelevance RELEVANCE)
+//!
+//! @brief Runs a query regex against a field of a result line and counts it in the stats
+//!
+static gboolean _searchitem_match (LwSearchStats *stats, GRegex *re, const char *TEXT, const LwRelevance RELEVANCE, const LwSearchField FIELD)
+{
+    stats->regex_evaluations[RELEVANCE]++;
+    stats->field_evaluations[FIELD]++;
+
+    return g_regex_match (re, TEXT, 0, NULL);
+}
+
+
+//!
+//! @brief Runs a query regex against a field of a result line.  The low relevance
+//!        comparison is the one that accepts a line, so there the spans the regex
+//!        matched are also recorded for the output to highlight.
+//!
+static gboolean _searchitem_match_field (LwSearchStats *stats, GRegex *re, LwResultLine *rl, const LwResultLineField LINE_FIELD, int index, const LwRelevance RELEVANCE, const LwSearchField FIELD)
+{
+    //Declarations
+    const char *text;
+    GMatchInfo *match_info;
+    gboolean matched;
+    int start, end;
+
+    //Initializations
+    text = lw_resultline_get_field (rl, LINE_FIELD, index);
+    if (RELEVANCE != LW_RELEVANCE_LOW) return _searchitem_match (stats, re, text, RELEVANCE, FIELD);
+
+    stats->regex_evaluations[RELEVANCE]++;
+    stats->field_evaluations[FIELD]++;
+    matched = g_regex_match (re, text, 0, &match_info);
+
+    while (g_match_info_matches (match_info))
+    {
+      g_match_info_fetch_pos (match_info, 0, &start, &end);
+      lw_resultline_add_match (rl, LINE_FIELD, index, start, end);
+      g_match_info_next (match_info, NULL);
+    }
+
+    //Cleanup
+    g_match_info_free (match_info);
+
+    return matched;
+}
+
+
+//!
+//! @brief What a scan of the literal romaji atoms has found so far
+//!
+struct _LwSearchItemLiteralScan {
+    LwAhoCorasick *automaton;
+    guint32 found;
+    guint32 wanted;
+    LwResultLine *rl;           //!< Gets the spans of the literals found or NULL to stop once all were
+    int index;                  //!< The definition being scanned
+};
+typedef struct _LwSearchItemLiteralScan LwSearchItemLiteralScan;
+
+
+static gboolean _searchitem_collect_literal (gint pattern, gsize start, gsize end, gpointer data)
+{
+    //Declarations
+    LwSearchItemLiteralScan *scan;
+
+    //Initializations
+    scan = (LwSearchItemLiteralScan*) data;
+    scan->found |= (1u << GPOINTER_TO_INT (lw_ahocorasick_get_pattern_data (scan->automaton, pattern)));
+
+    if (scan->rl == NULL) return (scan->found != scan->wanted);
+
+    lw_resultline_add_match (scan->rl, LW_RESULTLINE_FIELD_DEFINITION, scan->index, start, end);
+
+    return TRUE;
+}
+
+
+//!
+//! @brief Finds which literal romaji atoms of a query are in a definition in one
+//!        pass over it instead of matching a regex per atom.  For the low relevance
+//!        comparison the whole definition is scanned to record the spans of the literals.
+//! @returns A mask with the bit of each found atom set
+//!
+static guint32 _searchitem_match_literals (LwSearchStats *stats, LwQueryLine *ql, LwResultLine *rl, int index, const LwRelevance RELEVANCE)
+{
+    //Declarations
+    LwSearchItemLiteralScan scan;
+    const char *text;
+
+    //Initializations
+    text = rl->def_start[index];
+    scan.automaton = ql->roma_literals;
+    scan.found = 0;
+    scan.wanted = ql->roma_literals_mask;
+    scan.rl = (RELEVANCE == LW_RELEVANCE_LOW) ? rl : NULL;
+    scan.index = index;
+
+    stats->literal_scans++;
+    lw_ahocorasick_scan (scan.automaton, text, strlen (text), _searchitem_collect_literal, &scan);
+
+    return scan.found;
+}
+
+
+static gboolean _edict_existance_comparison (LwQueryLine *ql, LwResultLine *rl, LwSearchStats *stats, const LwRelevance RELEVANCE)
 {
     //Declarations
     int j;
     GRegex *re;
     GRegex ***iter;
+    gboolean found;
 
     //Compare kanji atoms
     if (rl->kanji_start != NULL)
@@ -302,7 +483,7 @@ static gboolean _edict_existance_comparison (LwQueryLine *ql, LwResultLine *rl,
       for (iter = ql->re_kanji; *iter != NULL && **iter != NULL; iter++)
       {
         re = (*iter)[RELEVANCE];
-        if (g_regex_match (re, rl->kanji_start, 0, NULL) == FALSE) break;
+        if (_searchitem_match_field (stats, re, rl, LW_RESULTLINE_FIELD_KANJI, 0, RELEVANCE, LW_SEARCHFIELD_KANJI) == FALSE) break;
       }
       if (ql->re_kanji[0][RELEVANCE] != NULL && *iter == NULL) return TRUE;
     }
@@ -313,7 +494,7 @@ static gboolean _edict_existance_comparison (LwQueryLine *ql, LwResultLine *rl,
       for (iter = ql->re_furi; *iter != NULL && **iter != NULL; iter++)
       {
         re = (*iter)[RELEVANCE];
-        if (g_regex_match (re, rl->furigana_start, 0, NULL) == FALSE) break;
+        if (_searchitem_match_field (stats, re, rl, LW_RESULTLINE_FIELD_FURIGANA, 0, RELEVANCE, LW_SEARCHFIELD_FURIGANA) == FALSE) break;
       }
       if (ql->re_furi[0][RELEVANCE] != NULL && *iter == NULL) return TRUE;
     }
@@ -323,22 +504,39 @@ static gboolean _edict_existance_comparison (LwQueryLine *ql, LwResultLine *rl,
       for (iter = ql->re_furi; *iter != NULL && **iter != NULL; iter++)
       {
         re = (*iter)[RELEVANCE];
-        if (g_regex_match (re, rl->kanji_start, 0, NULL) == FALSE) break;
+        if (_searchitem_match_field (stats, re, rl, LW_RESULTLINE_FIELD_KANJI, 0, RELEVANCE, LW_SEARCHFIELD_FURIGANA) == FALSE) break;
       }
       if (ql->re_furi[0][RELEVANCE] != NULL && *iter == NULL) return TRUE;
     }
 
 
-    //Compare romaji atoms
+    //Compare romaji atoms.  A low match goes on through the rest of the definitions to record their spans.
+    found = FALSE;
     for (j = 0; rl->def_start[j] != NULL; j++)
     {
+      //A definition missing a literal atom can't match its regexes, and having all of them is a low match
+      if (ql->roma_literals != NULL)
+      {
+        if (_searchitem_match_literals (stats, ql, rl, j, RELEVANCE) != ql->roma_literals_mask) continue;
+        if (RELEVANCE == LW_RELEVANCE_LOW)
+        {
+          found = TRUE;
+          continue;
+        }
+      }
+
       for (iter = ql->re_roma; *iter != NULL && **iter != NULL; iter++)
       {
         re = (*iter)[RELEVANCE];
-        if (g_regex_match (re, rl->def_start[j], 0, NULL) == FALSE) break;
+        if (_searchitem_match_field (stats, re, rl, LW_RESULTLINE_FIELD_DEFINITION, j, RELEVANCE, LW_SEARCHFIELD_ROMAJI) == FALSE) break;
+      }
+      if (ql->re_roma[0][RELEVANCE] != NULL && *iter == NULL)
+      {
+        if (RELEVANCE != LW_RELEVANCE_LOW) return TRUE;
+        found = TRUE;
       }
-      if (ql->re_roma[0][RELEVANCE] != NULL && *iter == NULL) return TRUE;
     }
+    if (found) return TRUE;
 
     //Compare mix atoms
     if (rl->string != NULL)
@@ -346,7 +544,7 @@ static gboolean _edict_existance_comparison (LwQueryLine *ql, LwResultLine *rl,
       for (iter = ql->re_mix; *iter != NULL && **iter != NULL; iter++)
       {
         re = (*iter)[RELEVANCE];
-        if (g_regex_match (re, rl->string, 0, NULL) == FALSE) break;
+        if (_searchitem_match_field (stats, re, rl, LW_RESULTLINE_FIELD_STRING, 0, RELEVANCE, LW_SEARCHFIELD_MIX) == FALSE) break;
       }
       if (ql->re_roma[0][RELEVANCE] != NULL && *iter == NULL) return TRUE;
     }
@@ -355,7 +553,7 @@ static gboolean _edict_existance_comparison (LwQueryLine *ql, LwResultLine *rl,
 }
 
 
-static gboolean _kanji_existance_comparison (LwQueryLine *ql, LwResultLine *rl, const LwRelevance RELEVANCE)
+static gboolean _kanji_existance_comparison (LwQueryLine *ql, LwResultLine *rl, LwSearchStats *stats, const LwRelevance RELEVANCE)
 {
     //Declarations
     gboolean strokes_check_passed;
@@ -392,7 +590,7 @@ static gboolean _kanji_existance_comparison (LwQueryLine *ql, LwResultLine *rl,
       for (iter = ql->re_strokes; iter != NULL && *iter != NULL; iter++)
       {
         re = (*iter)[RELEVANCE];
-        if (re != NULL && g_regex_match (re, rl->strokes, 0, NULL) == FALSE) 
+        if (re != NULL && _searchitem_match (stats, re, rl->strokes, RELEVANCE, LW_SEARCHFIELD_FILTER) == FALSE) 
           strokes_check_passed = FALSE;
       }
     }
@@ -406,7 +604,7 @@ static gboolean _kanji_existance_comparison (LwQueryLine *ql, LwResultLine *rl,
       for (iter = ql->re_frequency; iter != NULL && *iter != NULL; iter++)
       {
         re = (*iter)[RELEVANCE];
-        if (re != NULL && g_regex_match (re, rl->frequency, 0, NULL) == FALSE) 
+        if (re != NULL && _searchitem_match (stats, re, rl->frequency, RELEVANCE, LW_SEARCHFIELD_FILTER) == FALSE) 
           frequency_check_passed = FALSE;
       }
     }
@@ -421,7 +619,7 @@ static gboolean _kanji_existance_comparison (LwQueryLine *ql, LwResultLine *rl,
       for (iter = ql->re_grade; iter != NULL && *iter != NULL; iter++)
       {
         re = (*iter)[RELEVANCE];
-        if (re != NULL && g_regex_match (re, rl->grade, 0, NULL) == FALSE) 
+        if (re != NULL && _searchitem_match (stats, re, rl->grade, RELEVANCE, LW_SEARCHFIELD_FILTER) == FALSE) 
           grade_check_passed = FALSE;
       }
     }
@@ -436,7 +634,7 @@ static gboolean _kanji_existance_comparison (LwQueryLine *ql, LwResultLine *rl,
       for (iter = ql->re_jlpt; iter != NULL && *iter != NULL; iter++)
       {
         re = (*iter)[RELEVANCE];
-        if (re != NULL && g_regex_match (re, rl->jlpt, 0, NULL) == FALSE) 
+        if (re != NULL && _searchitem_match (stats, re, rl->jlpt, RELEVANCE, LW_SEARCHFIELD_FILTER) == FALSE) 
           jlpt_check_passed = FALSE;
       }
     }
@@ -460,7 +658,7 @@ static gboolean _kanji_existance_comparison (LwQueryLine *ql, LwResultLine *rl,
       {
         re = (*iter)[RELEVANCE];
 
-        if (re != NULL && g_regex_match (re, rl->meanings, 0, NULL) == TRUE) 
+        if (re != NULL && _searchitem_match_field (stats, re, rl, LW_RESULTLINE_FIELD_MEANINGS, 0, RELEVANCE, LW_SEARCHFIELD_ROMAJI) == TRUE) 
         {
           romaji_check_passed = TRUE;
         }
@@ -480,7 +678,7 @@ static gboolean _kanji_existance_comparison (LwQueryLine *ql, LwResultLine *rl,
       for (iter = ql->re_furi; iter != NULL && *iter != NULL; iter++)
       {
         re = (*iter)[RELEVANCE];
-        if (re != NULL && g_regex_match (re, rl->readings[i], 0, NULL) == TRUE) 
+        if (re != NULL && _searchitem_match_field (stats, re, rl, LW_RESULTLINE_FIELD_READING, i, RELEVANCE, LW_SEARCHFIELD_FURIGANA) == TRUE) 
         {
           furigana_check_passed = TRUE;
         }
@@ -494,7 +692,7 @@ static gboolean _kanji_existance_comparison (LwQueryLine *ql, LwResultLine *rl,
       for (iter = ql->re_kanji; iter != NULL && *iter != NULL; iter++)
       {
         re = (*iter)[RELEVANCE];
-        if (re != NULL && g_regex_match (re, rl->kanji, 0, NULL) == FALSE) 
+        if (re != NULL && _searchitem_match_field (stats, re, rl, LW_RESULTLINE_FIELD_CHARACTER, 0, RELEVANCE, LW_SEARCHFIELD_KANJI) == FALSE) 
         {
           kanji_check_passed = FALSE;
           kanji_index = -1;
@@ -510,7 +708,7 @@ static gboolean _kanji_existance_comparison (LwQueryLine *ql, LwResultLine *rl,
       for (iter = ql->re_kanji; iter != NULL && *iter != NULL; iter++)
       {
         re = (*iter)[RELEVANCE];
-        if (re != NULL && g_regex_match (re, rl->radicals, 0, NULL) == FALSE) 
+        if (re != NULL && _searchitem_match_field (stats, re, rl, LW_RESULTLINE_FIELD_RADICALS, 0, RELEVANCE, LW_SEARCHFIELD_KANJI) == FALSE) 
         {
           if (radical_index != kanji_index) //Make sure the radical wasn't found as a kanji before setting false
              radical_check_passed = FALSE;
@@ -547,17 +745,20 @@ lw_searchitem_run_comparison (LwSearchItem *item, const LwRelevance RELEVANCE)
     rl = item->resultline;
     ql = item->queryline;
 
+    //The low relevance comparison records the spans of the line it accepts
+    if (RELEVANCE == LW_RELEVANCE_LOW) lw_resultline_clear_matches (rl);
+
     //Kanji radical dictionary search
     switch (item->dictionary->type)
     {
       case LW_DICTTYPE_EDICT:
-        return _edict_existance_comparison (ql, rl, RELEVANCE);
+        return _edict_existance_comparison (ql, rl, &item->stats, RELEVANCE);
       case LW_DICTTYPE_KANJI:
-        return _kanji_existance_comparison (ql, rl, RELEVANCE);
+        return _kanji_existance_comparison (ql, rl, &item->stats, RELEVANCE);
       case LW_DICTTYPE_EXAMPLES:
-        return _edict_existance_comparison (ql, rl, RELEVANCE);
+        return _edict_existance_comparison (ql, rl, &item->stats, RELEVANCE);
       default:
-        return _edict_existance_comparison (ql, rl, RELEVANCE);
+        return _edict_existance_comparison (ql, rl, &item->stats, RELEVANCE);
     }
 }
 
@@ -770,3 +971,250 @@ lw_searchitem_get_progress (LwSearchItem *item)
 
     return fraction;
 }
+
+
+//!
+//! @brief Marks the start of a search for the wall and processor time stats
+//! @param item The LwSearchItem that is starting a search
+//!
+void 
+lw_searchitem_stats_begin (LwSearchItem *item)
+{
+    gdouble compile_time;
+
+    compile_time = item->stats.compile_time;
+    memset (&item->stats, 0, sizeof(LwSearchStats));
+    item->stats.compile_time = compile_time;
+    item->stats.first_result_time = -1.0;
+
+    g_timer_start (item->timer);
+    item->clock_start = clock ();
+}
+
+
+//!
+//! @brief Marks the end of a search for the wall and processor time stats
+//! @param item The LwSearchItem that finished its search
+//!
+void 
+lw_searchitem_stats_end (LwSearchItem *item)
+{
+    item->stats.wall_time = g_timer_elapsed (item->timer, NULL);
+    item->stats.cpu_time = (gdouble) (clock () - item->clock_start) / (gdouble) CLOCKS_PER_SEC;
+}
+
+
+//!
+//! @brief Copies the instrumentation counters of the last search.  It is safe
+//!        to call while the search is still running.
+//! @param item The LwSearchItem to get the stats of
+//! @param stats A LwSearchStats to copy the counters into
+//!
+void 
+lw_searchitem_get_stats (LwSearchItem *item, LwSearchStats *stats)
+{
+    g_assert (item != NULL && stats != NULL);
+
+    g_mutex_lock (item->mutex);
+    *stats = item->stats;
+    if (item->status == LW_SEARCHSTATUS_SEARCHING)
+      stats->wall_time = g_timer_elapsed (item->timer, NULL);
+    g_mutex_unlock (item->mutex);
+}
+
+
+static gboolean 
+_searchitem_has_result_unlocked (LwSearchItem *item)
+{
+    return (item->results_high != NULL ||
+            (item->status == LW_SEARCHSTATUS_IDLE && (item->results_medium != NULL || item->results_low != NULL)));
+}
+
+
+//!
+//! @brief Checks if lw_searchitem_get_result would return a result right now
+//! @param item The LwSearchItem to check
+//! @returns TRUE if a result can be taken without waiting
+//!
+gboolean 
+lw_searchitem_has_result (LwSearchItem *item)
+{
+    //Declarations
+    gboolean has_result;
+
+    g_assert (item != NULL);
+
+    g_mutex_lock (item->mutex);
+    has_result = _searchitem_has_result_unlocked (item);
+    g_mutex_unlock (item->mutex);
+
+    return has_result;
+}
+
+
+static gboolean 
+_searchitem_source_check (GSource *source)
+{
+    //Declarations
+    LwSearchItemSource *searchsource;
+    LwSearchItem *item;
+    gboolean ready;
+
+    //Initializations
+    searchsource = (LwSearchItemSource*) source;
+    item = searchsource->item;
+    if (item == NULL) return FALSE;
+
+    //Results left over from a budgeted dispatch keep the source ready
+    g_mutex_lock (item->mutex);
+    ready = (searchsource->pending || _searchitem_has_result_unlocked (item));
+    g_mutex_unlock (item->mutex);
+
+    return ready;
+}
+
+
+static gboolean 
+_searchitem_source_prepare (GSource *source, gint *timeout)
+{
+    *timeout = -1;
+
+    return _searchitem_source_check (source);
+}
+
+
+static gboolean 
+_searchitem_source_dispatch (GSource *source, GSourceFunc callback, gpointer data)
+{
+    //Declarations
+    LwSearchItemSource *searchsource;
+    LwSearchItem *item;
+
+    //Initializations
+    searchsource = (LwSearchItemSource*) source;
+    item = searchsource->item;
+    if (item == NULL || callback == NULL) return FALSE;
+
+    g_mutex_lock (item->mutex);
+    searchsource->pending = FALSE;
+    g_mutex_unlock (item->mutex);
+
+    //The callback may free the item so it is not touched afterwards
+    return ((LwSearchItemWatchFunc) callback) (item, data);
+}
+
+
+static void 
+_searchitem_source_finalize (GSource *source)
+{
+    //Declarations
+    LwSearchItemSource *searchsource;
+    LwSearchItem *item;
+
+    //Initializations
+    searchsource = (LwSearchItemSource*) source;
+    item = searchsource->item;
+
+    if (item != NULL)
+    {
+      g_mutex_lock (item->mutex);
+      item->sources = g_slist_remove (item->sources, source);
+      g_mutex_unlock (item->mutex);
+    }
+}
+
+
+static GSourceFuncs _searchitem_source_funcs = {
+  _searchitem_source_prepare,
+  _searchitem_source_check,
+  _searchitem_source_dispatch,
+  _searchitem_source_finalize
+};
+
+
+//!
+//! @brief Creates a GSource that dispatches when the item has results that can
+//!        be taken with lw_searchitem_get_result, when the search progresses and
+//!        when the search ends.  The callback is a LwSearchItemWatchFunc.  The
+//!        source dispatches once right after being attached so a search that
+//!        already finished is still seen.  Free the item in the thread that runs
+//!        the source's GMainContext.
+//! @param item The LwSearchItem to watch.  Its search should already be started.
+//! @returns A new GSource that should be unreffed after being attached
+//!
+GSource* 
+lw_searchitem_source_new (LwSearchItem *item)
+{
+    //Declarations
+    GSource *source;
+    LwSearchItemSource *searchsource;
+
+    //Initializations
+    g_assert (item != NULL);
+    source = g_source_new (&_searchitem_source_funcs, sizeof(LwSearchItemSource));
+    searchsource = (LwSearchItemSource*) source;
+    searchsource->item = item;
+    searchsource->pending = TRUE;
+
+    g_mutex_lock (item->mutex);
+    item->sources = g_slist_prepend (item->sources, source);
+    g_mutex_unlock (item->mutex);
+
+    return source;
+}
+
+
+//!
+//! @brief Calls a function whenever the item has news for its reader.  It
+//!        replaces polling lw_searchitem_get_result on a timer.  The function
+//!        should return FALSE once lw_searchitem_should_check_results does.
+//! @param item The LwSearchItem to watch
+//! @param context The GMainContext to run the function in or NULL for the default one
+//! @param func The function to call
+//! @param data Data to pass to the function
+//! @param notify A function to free the data with or NULL
+//! @returns The id of the source in the context
+//!
+guint 
+lw_searchitem_add_watch (LwSearchItem *item, GMainContext *context, LwSearchItemWatchFunc func, gpointer data, GDestroyNotify notify)
+{
+    //Declarations
+    GSource *source;
+    guint id;
+
+    //Initializations
+    source = lw_searchitem_source_new (item);
+
+    //Run after redraws so a burst of results does not starve the display
+    g_source_set_priority (source, G_PRIORITY_DEFAULT_IDLE);
+    g_source_set_callback (source, (GSourceFunc) func, data, notify);
+    id = g_source_attach (source, context);
+    g_source_unref (source);
+
+    return id;
+}
+
+
+//!
+//! @brief Wakes up the main contexts of the item's watches.  The engine calls
+//!        this with the item mutex held.
+//! @param item The LwSearchItem whose state changed
+//!
+void 
+lw_searchitem_notify_sources (LwSearchItem *item)
+{
+    //Declarations
+    GSList *link;
+    LwSearchItemSource *searchsource;
+    GMainContext *context;
+
+    for (link = item->sources; link != NULL; link = link->next)
+    {
+      searchsource = (LwSearchItemSource*) link->data;
+      if (searchsource->pending) continue;
+
+      searchsource->pending = TRUE;
+      context = g_source_get_context ((GSource*) searchsource);
+      if (context != NULL) g_main_context_wakeup (context);
+    }
+}
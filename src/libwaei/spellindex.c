@@ -0,0 +1,610 @@
+/******************************************************************************
+    AUTHOR:
+    File written and Copyrighted by Zachary Dovel. All Rights Reserved.
+
+    LICENSE:
+    This file is part of gWaei.
+
+    gWaei is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    gWaei is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    
+    You should have received a copy of the GNU General Public License
+    along with gWaei.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+//!
+//! @file spellindex.c
+//!
+//! @brief Spelling suggestions made from the English glosses of the dictionaries
+//!
+//! This is a symmetric delete index.  Every word is stored under each string
+//! left after deleting up to LW_SPELLINDEX_MAX_DISTANCE of its letters, so a
+//! word that is a couple of edits away shares at least one delete with the
+//! word looked up.  Only the first LW_SPELLINDEX_PREFIX_LENGTH letters are
+//! used for the deletes to keep the index small, and the candidates are
+//! checked against the whole word.
+//!
+
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <glib.h>
+
+#include <libwaei/libwaei.h>
+
+
+//!
+//! @brief A word found by a lookup and how far it is from the word looked up
+//!
+struct _LwSpellIndexMatch {
+  guint32 word;
+  gint distance;
+  guint count;
+};
+typedef struct _LwSpellIndexMatch LwSpellIndexMatch;
+
+
+//!
+//! @brief Creates a new, empty LwSpellIndex object
+//! @return An allocated LwSpellIndex that will be needed to be freed by lw_spellindex_free.
+//!
+LwSpellIndex* 
+lw_spellindex_new ()
+{
+    LwSpellIndex *temp;
+
+    temp = (LwSpellIndex*) malloc(sizeof(LwSpellIndex));
+
+    if (temp != NULL)
+    {
+      lw_spellindex_init (temp);
+    }
+
+    return temp;
+}
+
+
+//!
+//! @brief Releases a LwSpellIndex object from memory.
+//! @param index A LwSpellIndex object created by lw_spellindex_new.
+//!
+void 
+lw_spellindex_free (LwSpellIndex *index)
+{
+    lw_spellindex_deinit (index);
+    free (index);
+}
+
+
+//!
+//! @brief Used to initialize the memory inside of a new LwSpellIndex
+//!        object.  Usually lw_spellindex_new calls this for you.
+//! @param index The LwSpellIndex to initialize
+//!
+void 
+lw_spellindex_init (LwSpellIndex *index)
+{
+    index->mutex = g_mutex_new ();
+    index->loaded = FALSE;
+    index->strings = g_string_chunk_new (64 * 1024);
+    index->words = g_ptr_array_new ();
+    index->counts = g_array_new (FALSE, FALSE, sizeof(guint));
+    index->ids = g_hash_table_new (g_str_hash, g_str_equal);
+    index->deletes = NULL;
+    index->total_deletes = 0;
+}
+
+
+//!
+//! @brief Used to free the memory inside of a LwSpellIndex object.
+//!        Usually lw_spellindex_free calls this for you.
+//! @param index The LwSpellIndex to deinitialize
+//!
+void 
+lw_spellindex_deinit (LwSpellIndex *index)
+{
+    g_free (index->deletes);
+    index->deletes = NULL;
+    index->total_deletes = 0;
+
+    g_hash_table_destroy (index->ids);
+    g_array_free (index->counts, TRUE);
+    g_ptr_array_free (index->words, TRUE);
+    g_string_chunk_free (index->strings);
+    g_mutex_free (index->mutex);
+}
+
+
+static guint32 
+_spellindex_hash (const gchar *text, gint length)
+{
+    //Declarations
+    guint32 hash;
+    gint i;
+
+    //Initializations
+    hash = 2166136261U;
+
+    for (i = 0; i < length; i++)
+    {
+      hash ^= (guchar) text[i];
+      hash *= 16777619U;
+    }
+
+    return hash;
+}
+
+
+//!
+//! @brief Lowercases an ASCII word into a buffer of LW_SPELLINDEX_MAX_WORD_LENGTH + 1
+//! @returns The length of the word or 0 if it can't be indexed
+//!
+static gint 
+_spellindex_normalize (const gchar *word, gint length, gchar *buffer)
+{
+    //Declarations
+    gint i;
+
+    if (length < LW_SPELLINDEX_MIN_WORD_LENGTH || length > LW_SPELLINDEX_MAX_WORD_LENGTH) return 0;
+
+    for (i = 0; i < length; i++)
+    {
+      if (!g_ascii_isalpha (word[i])) return 0;
+      buffer[i] = g_ascii_tolower (word[i]);
+    }
+    buffer[length] = '\0';
+
+    return length;
+}
+
+
+static void 
+_spellindex_add_word (LwSpellIndex *index, const gchar *word, gint length)
+{
+    //Declarations
+    gchar buffer[LW_SPELLINDEX_MAX_WORD_LENGTH + 1];
+    gpointer id;
+    gchar *copy;
+    guint count;
+
+    if (!_spellindex_normalize (word, length, buffer)) return;
+
+    id = g_hash_table_lookup (index->ids, buffer);
+
+    if (id != NULL)
+    {
+      g_array_index (index->counts, guint, GPOINTER_TO_UINT (id) - 1)++;
+    }
+    else
+    {
+      copy = g_string_chunk_insert_len (index->strings, buffer, length);
+      count = 1;
+      g_ptr_array_add (index->words, copy);
+      g_array_append_val (index->counts, count);
+      g_hash_table_insert (index->ids, copy, GUINT_TO_POINTER (index->words->len));
+    }
+}
+
+
+//!
+//! @brief Adds the words of the glosses of one EDICT line.  Part of speech
+//!        tags and other notes in parentheses and words with digits are skipped.
+//!
+static void 
+_spellindex_add_glosses (LwSpellIndex *index, const gchar *line)
+{
+    //Declarations
+    const gchar *ptr;
+    const gchar *start;
+    gboolean has_digits;
+    gint depth;
+
+    //Initializations
+    ptr = strchr (line, '/');
+    depth = 0;
+
+    if (ptr == NULL) return;
+
+    while (*ptr != '\0')
+    {
+      if (g_ascii_isalnum (*ptr))
+      {
+        start = ptr;
+        has_digits = FALSE;
+        while (g_ascii_isalnum (*ptr))
+        {
+          if (g_ascii_isdigit (*ptr)) has_digits = TRUE;
+          ptr++;
+        }
+        if (depth == 0 && !has_digits) _spellindex_add_word (index, start, ptr - start);
+        continue;
+      }
+
+      if (*ptr == '(') depth++;
+      else if (*ptr == ')' && depth > 0) depth--;
+      else if (*ptr == '/') depth = 0;
+
+      ptr++;
+    }
+}
+
+
+//!
+//! @brief Appends a word under the given letters and under everything left after
+//!        deleting up to distance more of them, in increasing positions so
+//!        the same set of positions is only deleted once.
+//!
+static void 
+_spellindex_append_deletes (GArray *deletes, const gchar *letters, gint length, gint start, gint distance, guint32 word)
+{
+    //Declarations
+    LwSpellIndexDelete delete;
+    gchar buffer[LW_SPELLINDEX_PREFIX_LENGTH];
+    gint i;
+
+    //Initializations
+    delete.hash = _spellindex_hash (letters, length);
+    delete.word = word;
+
+    g_array_append_val (deletes, delete);
+    if (distance == 0) return;
+
+    for (i = start; i < length; i++)
+    {
+      memcpy (buffer, letters, i);
+      memcpy (buffer + i, letters + i + 1, length - i - 1);
+      _spellindex_append_deletes (deletes, buffer, length - 1, i, distance - 1, word);
+    }
+}
+
+
+static gint 
+_spellindex_compare_deletes (gconstpointer a, gconstpointer b)
+{
+    const LwSpellIndexDelete *da = a;
+    const LwSpellIndexDelete *db = b;
+
+    if (da->hash != db->hash) return (da->hash < db->hash) ? -1 : 1;
+    if (da->word != db->word) return (da->word < db->word) ? -1 : 1;
+    return 0;
+}
+
+
+//!
+//! @brief Makes the sorted delete table once all of the words are added
+//!
+static void 
+_spellindex_build (LwSpellIndex *index)
+{
+    //Declarations
+    GArray *deletes;
+    LwSpellIndexDelete *delete;
+    const gchar *word;
+    gsize total;
+    guint i;
+
+    //Initializations
+    deletes = g_array_sized_new (FALSE, FALSE, sizeof(LwSpellIndexDelete), index->words->len * 16);
+
+    for (i = 0; i < index->words->len; i++)
+    {
+      word = g_ptr_array_index (index->words, i);
+      _spellindex_append_deletes (deletes, word, MIN (strlen (word), LW_SPELLINDEX_PREFIX_LENGTH), 0, LW_SPELLINDEX_MAX_DISTANCE, i);
+    }
+
+    g_array_sort (deletes, _spellindex_compare_deletes);
+
+    //Letters like the ll of "all" make the same delete twice
+    delete = (LwSpellIndexDelete*) deletes->data;
+    total = 0;
+    for (i = 0; i < deletes->len; i++)
+    {
+      if (total > 0 && _spellindex_compare_deletes (&delete[total - 1], &delete[i]) == 0) continue;
+      delete[total++] = delete[i];
+    }
+
+    index->total_deletes = total;
+    index->deletes = (LwSpellIndexDelete*) g_array_free (deletes, FALSE);
+}
+
+
+//!
+//! @brief Reads the glosses of EDICT format dictionaries into the index.  It only
+//!        loads once, so later calls return at once.  It can take a while and
+//!        is meant to be called from a thread other than the main one.
+//! @param index An LwSpellIndex
+//! @param paths A NULL terminated array of the paths of EDICT format dictionaries
+//! @param error A pointer to a GError to write errors to or NULL
+//! @returns FALSE if one of the dictionaries couldn't be read
+//!
+gboolean 
+lw_spellindex_load (LwSpellIndex *index, gchar **paths, GError **error)
+{
+    //Declarations
+    FILE *file;
+    char buffer[LW_IO_MAX_FGETS_LINE];
+    gboolean ok;
+    gint i;
+
+    //Initializations
+    ok = TRUE;
+
+    g_mutex_lock (index->mutex);
+
+    if (!index->loaded)
+    {
+      for (i = 0; paths != NULL && paths[i] != NULL; i++)
+      {
+        file = fopen (paths[i], "r");
+        if (file == NULL)
+        {
+          if (ok) g_set_error (error, g_quark_from_string (LW_IO_ERROR), LW_IO_READ_ERROR, "Unable to read the dictionary %s", paths[i]);
+          ok = FALSE;
+          continue;
+        }
+
+        while (fgets (buffer, LW_IO_MAX_FGETS_LINE, file) != NULL)
+          _spellindex_add_glosses (index, buffer);
+
+        fclose (file);
+      }
+
+      _spellindex_build (index);
+      index->loaded = TRUE;
+    }
+
+    g_mutex_unlock (index->mutex);
+
+    return ok;
+}
+
+
+//!
+//! @brief Empties the index so the next lw_spellindex_load reads the
+//!        dictionaries again.  Called when the installed dictionaries change.
+//! @param index An LwSpellIndex
+//!
+void 
+lw_spellindex_clear (LwSpellIndex *index)
+{
+    g_mutex_lock (index->mutex);
+
+    g_free (index->deletes);
+    index->deletes = NULL;
+    index->total_deletes = 0;
+
+    g_hash_table_remove_all (index->ids);
+    g_array_set_size (index->counts, 0);
+    g_ptr_array_set_size (index->words, 0);
+    g_string_chunk_clear (index->strings);
+    index->loaded = FALSE;
+
+    g_mutex_unlock (index->mutex);
+}
+
+
+//!
+//! @brief Checks if lw_spellindex_load has finished
+//!
+gboolean 
+lw_spellindex_is_loaded (LwSpellIndex *index)
+{
+    //Declarations
+    gboolean loaded;
+
+    g_mutex_lock (index->mutex);
+    loaded = index->loaded;
+    g_mutex_unlock (index->mutex);
+
+    return loaded;
+}
+
+
+//!
+//! @brief Checks if a word is in a gloss of one of the dictionaries.  Case is ignored.
+//!
+gboolean 
+lw_spellindex_has_word (LwSpellIndex *index, const gchar *WORD)
+{
+    //Declarations
+    gchar buffer[LW_SPELLINDEX_MAX_WORD_LENGTH + 1];
+    gboolean found;
+
+    //Initializations
+    found = FALSE;
+
+    g_mutex_lock (index->mutex);
+    if (index->loaded && _spellindex_normalize (WORD, strlen (WORD), buffer))
+      found = (g_hash_table_lookup (index->ids, buffer) != NULL);
+    g_mutex_unlock (index->mutex);
+
+    return found;
+}
+
+
+//!
+//! @brief The optimal string alignment distance between two words, adjacent
+//!        letters swapped counting as one edit
+//! @returns The distance or limit + 1 if it is over the limit
+//!
+static gint 
+_spellindex_get_distance (const gchar *a, gint la, const gchar *b, gint lb, gint limit)
+{
+    //Declarations
+    gint rows[3][LW_SPELLINDEX_MAX_WORD_LENGTH + 1];
+    gint *previous2, *previous, *current, *temp;
+    gint i, j;
+    gint cost;
+    gint best;
+
+    //Initializations
+    previous2 = rows[0];
+    previous = rows[1];
+    current = rows[2];
+
+    if (ABS (la - lb) > limit) return limit + 1;
+
+    for (j = 0; j <= lb; j++) previous[j] = j;
+
+    for (i = 1; i <= la; i++)
+    {
+      current[0] = i;
+      best = i;
+      for (j = 1; j <= lb; j++)
+      {
+        cost = (a[i - 1] == b[j - 1]) ? 0 : 1;
+        current[j] = MIN (MIN (previous[j] + 1, current[j - 1] + 1), previous[j - 1] + cost);
+        if (i > 1 && j > 1 && a[i - 1] == b[j - 2] && a[i - 2] == b[j - 1])
+          current[j] = MIN (current[j], previous2[j - 2] + 1);
+        if (current[j] < best) best = current[j];
+      }
+      if (best > limit) return limit + 1;
+
+      temp = previous2;
+      previous2 = previous;
+      previous = current;
+      current = temp;
+    }
+
+    return MIN (previous[lb], limit + 1);
+}
+
+
+//!
+//! @brief Finds the first delete with a hash by binary search
+//!
+static gsize 
+_spellindex_find_hash (LwSpellIndex *index, guint32 hash)
+{
+    //Declarations
+    gsize low, high, middle;
+
+    //Initializations
+    low = 0;
+    high = index->total_deletes;
+
+    while (low < high)
+    {
+      middle = low + (high - low) / 2;
+      if (index->deletes[middle].hash < hash) low = middle + 1;
+      else high = middle;
+    }
+
+    return low;
+}
+
+
+//!
+//! @brief Checks every word under the deletes of the looked up letters
+//!
+static void 
+_spellindex_collect (LwSpellIndex *index, const gchar *letters, gint length, gint start, gint distance,
+                     const gchar *WORD, gint word_length, gint limit, GArray *matches, GHashTable *seen)
+{
+    //Declarations
+    LwSpellIndexMatch match;
+    gchar buffer[LW_SPELLINDEX_PREFIX_LENGTH];
+    const gchar *candidate;
+    guint32 hash;
+    gsize i;
+    gint j;
+
+    //Initializations
+    hash = _spellindex_hash (letters, length);
+
+    for (i = _spellindex_find_hash (index, hash); i < index->total_deletes && index->deletes[i].hash == hash; i++)
+    {
+      match.word = index->deletes[i].word;
+      if (g_hash_table_lookup (seen, GUINT_TO_POINTER (match.word + 1)) != NULL) continue;
+      g_hash_table_insert (seen, GUINT_TO_POINTER (match.word + 1), GINT_TO_POINTER (1));
+
+      candidate = g_ptr_array_index (index->words, match.word);
+      match.distance = _spellindex_get_distance (WORD, word_length, candidate, strlen (candidate), limit);
+      if (match.distance == 0 || match.distance > limit) continue;
+
+      match.count = g_array_index (index->counts, guint, match.word);
+      g_array_append_val (matches, match);
+    }
+
+    if (distance == 0) return;
+
+    for (j = start; j < length; j++)
+    {
+      memcpy (buffer, letters, j);
+      memcpy (buffer + j, letters + j + 1, length - j - 1);
+      _spellindex_collect (index, buffer, length - 1, j, distance - 1, WORD, word_length, limit, matches, seen);
+    }
+}
+
+
+static gint 
+_spellindex_compare_matches (gconstpointer a, gconstpointer b)
+{
+    const LwSpellIndexMatch *ma = a;
+    const LwSpellIndexMatch *mb = b;
+
+    if (ma->distance != mb->distance) return ma->distance - mb->distance;
+    if (ma->count != mb->count) return (ma->count > mb->count) ? -1 : 1;
+    return (ma->word < mb->word) ? -1 : (ma->word > mb->word);
+}
+
+
+//!
+//! @brief Finds the dictionary words closest to a word.  Words of four letters
+//!        or less only get suggestions one edit away.
+//! @param index A loaded LwSpellIndex
+//! @param WORD The word to find suggestions for
+//! @param max The most suggestions to return
+//! @returns A GList of allocated strings, the closest and most common first, that
+//!          should be freed with g_free and g_list_free.  The word itself is never
+//!          in it.
+//!
+GList* 
+lw_spellindex_lookup (LwSpellIndex *index, const gchar *WORD, gint max)
+{
+    //Declarations
+    gchar buffer[LW_SPELLINDEX_MAX_WORD_LENGTH + 1];
+    GArray *matches;
+    GHashTable *seen;
+    GList *list;
+    gint length;
+    gint limit;
+    gint i;
+
+    //Initializations
+    list = NULL;
+
+    g_mutex_lock (index->mutex);
+
+    length = _spellindex_normalize (WORD, strlen (WORD), buffer);
+
+    if (index->loaded && index->total_deletes > 0 && length > 0 && max > 0)
+    {
+      matches = g_array_new (FALSE, FALSE, sizeof(LwSpellIndexMatch));
+      seen = g_hash_table_new (g_direct_hash, g_direct_equal);
+      limit = (length <= 4) ? 1 : LW_SPELLINDEX_MAX_DISTANCE;
+
+      _spellindex_collect (index, buffer, MIN (length, LW_SPELLINDEX_PREFIX_LENGTH), 0, limit, buffer, length, limit, matches, seen);
+      g_array_sort (matches, _spellindex_compare_matches);
+
+      for (i = MIN (matches->len, max) - 1; i >= 0; i--)
+        list = g_list_prepend (list, g_strdup (g_ptr_array_index (index->words, g_array_index (matches, LwSpellIndexMatch, i).word)));
+
+      g_hash_table_destroy (seen);
+      g_array_free (matches, TRUE);
+    }
+
+    g_mutex_unlock (index->mutex);
+
+    return list;
+}
@@ -0,0 +1,747 @@
+/******************************************************************************
+    AUTHOR:
+    File written and Copyrighted by Zachary Dovel. All Rights Reserved.
+
+    LICENSE:
+    This file is part of gWaei.
+
+    gWaei is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    gWaei is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    
+    You should have received a copy of the GNU General Public License
+    along with gWaei.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+
+//!
+//! @file strokedb.c
+//!
+//! @brief Handwriting recognition against the jstroke database
+//!
+//! This is the recognizer of the kpengine program as a library.  The database
+//! is decoded once when it is loaded and nothing here exits on errors.
+//!
+
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <glib.h>
+
+#include <libwaei/libwaei.h>
+
+#include "jstroke/jstroke.h"
+
+
+//!
+//! @brief One slice of a table scored by one thread and the best characters it found
+//!
+struct _LwStrokeDBChunk {
+  LwStrokeDBTable *table;
+  RawStroke *raw;
+  gint start;
+  gint end;
+  gint max;
+  LwStrokeDBCandidate *candidates;  //!< The best characters of the slice with the lowest score first
+  gint total;
+};
+typedef struct _LwStrokeDBChunk LwStrokeDBChunk;
+
+//!
+//! @brief One part of the characters a new stroke of a session is scored against
+//!
+struct _LwStrokeDBSessionPart {
+  LwStrokeDBSession *session;
+  RawStroke *raw;           //!< The new stroke
+  gint part;
+  gint parts;               //!< Each table is split into this many slices
+};
+typedef struct _LwStrokeDBSessionPart LwStrokeDBSessionPart;
+
+
+//!
+//! @brief Creates a new LwStrokeDB object
+//! @param path The path to jdata.dat or NULL to use lw_strokedb_get_default_path
+//! @param error A pointer to a GError to write errors to or NULL
+//! @return An allocated LwStrokeDB that will be needed to be freed by lw_strokedb_free.
+//!
+LwStrokeDB* 
+lw_strokedb_new (const char *path, GError **error)
+{
+    LwStrokeDB *temp;
+
+    temp = (LwStrokeDB*) malloc(sizeof(LwStrokeDB));
+
+    if (temp != NULL)
+    {
+      lw_strokedb_init (temp, path, error);
+      if (error != NULL && *error != NULL)
+      {
+        lw_strokedb_free (temp);
+        temp = NULL;
+      }
+    }
+
+    return temp;
+}
+
+
+//!
+//! @brief Releases a LwStrokeDB object from memory.
+//! @param db A LwStrokeDB object created by lw_strokedb_new.
+//!
+void 
+lw_strokedb_free (LwStrokeDB *db)
+{
+    lw_strokedb_deinit (db);
+    free (db);
+}
+
+
+//!
+//! @brief Converts a Shift-JIS character to a JIS row and cell
+//!
+//! From Ken Lunde's _Understanding Japanese Information Processing_
+//! O'Reilly, 1993
+//!
+static void 
+_strokedb_sjis_to_jis (guchar *p1, guchar *p2)
+{
+    guchar c1 = *p1;
+    guchar c2 = *p2;
+    int adjust = c2 < 159;
+    int row_offset = c1 < 160 ? 112 : 176;
+    int cell_offset = adjust ? (c2 > 127 ? 32 : 31) : 126;
+
+    *p1 = ((c1 - row_offset) << 1) - adjust;
+    *p2 -= cell_offset;
+}
+
+
+//!
+//! @brief Decodes the letter coded characters of one stroke count
+//! @param table The LwStrokeDBTable to fill
+//! @param dict The characters from jdata.dat.  It ends with a null byte.
+//! @param strokes The stroke count of the characters
+//!
+static void 
+_strokedb_table_decode (LwStrokeDBTable *table, const char *dict, gint strokes)
+{
+    //Declarations
+    GByteArray *jis;
+    GByteArray *paths;
+    GByteArray *filters;
+    GArray *path_offsets;
+    GArray *filter_offsets;
+    guchar code[2];
+    gchar path[diPathBufLen];
+    guint8 ops[diMaxFilterOps * diFilterOpLen];
+    CharPtr ptr;
+    guint offset;
+    UInt length;
+    int i;
+
+    //Initializations
+    jis = g_byte_array_new ();
+    paths = g_byte_array_new ();
+    filters = g_byte_array_new ();
+    path_offsets = g_array_new (FALSE, FALSE, sizeof(guint));
+    filter_offsets = g_array_new (FALSE, FALSE, sizeof(guint));
+    ptr = (CharPtr) dict;
+    table->total = 0;
+    table->strokes = strokes;
+
+    //Each character is two bytes of Shift-JIS, the strokes and then optional filters after a |
+    while (ptr[0] != '\0' && ptr[1] != '\0')
+    {
+      code[0] = ptr[0];
+      code[1] = ptr[1];
+      _strokedb_sjis_to_jis (&code[0], &code[1]);
+      g_byte_array_append (jis, code, 2);
+      ptr += 2;
+
+      //A character with too few strokes gets empty paths for the rest
+      for (i = 0; i < strokes; i++)
+      {
+        offset = paths->len;
+        g_array_append_val (path_offsets, offset);
+        length = StrokeDicDecodeStroke (&ptr, path);
+        g_byte_array_append (paths, (guint8*) path, length);
+      }
+
+      offset = filters->len;
+      g_array_append_val (filter_offsets, offset);
+      if (*ptr == '|')
+      {
+        ptr = StrokeDicDecodeFilters (ptr + 1, ops, &length);
+        g_byte_array_append (filters, ops, length * diFilterOpLen);
+      }
+
+      //Skip anything left over up to the next character
+      while (*ptr != '\0' && !(*ptr & 0x80)) ptr++;
+
+      table->total++;
+    }
+
+    offset = paths->len;
+    g_array_append_val (path_offsets, offset);
+    offset = filters->len;
+    g_array_append_val (filter_offsets, offset);
+
+    table->jis = g_byte_array_free (jis, FALSE);
+    table->paths = (gchar*) g_byte_array_free (paths, FALSE);
+    table->filters = g_byte_array_free (filters, FALSE);
+    table->path_offsets = (guint*) g_array_free (path_offsets, FALSE);
+    table->filter_offsets = (guint*) g_array_free (filter_offsets, FALSE);
+}
+
+
+static void 
+_strokedb_table_clear (LwStrokeDBTable *table)
+{
+    g_free (table->jis);
+    g_free (table->paths);
+    g_free (table->filters);
+    g_free (table->path_offsets);
+    g_free (table->filter_offsets);
+    memset (table, 0, sizeof(LwStrokeDBTable));
+}
+
+
+//!
+//! @brief Reads the database and decodes the characters of each stroke count
+//! @param db The LwStrokeDB to initialize
+//! @param path The path to jdata.dat or NULL to use lw_strokedb_get_default_path
+//! @param error A pointer to a GError to write errors to or NULL
+//!
+void 
+lw_strokedb_init (LwStrokeDB *db, const char *path, GError **error)
+{
+    //Declarations
+    GMappedFile *file;
+    gchar *default_path;
+    const char *ptr;
+    const char *end;
+    guint32 header[2];
+    guint32 strokes;
+    guint32 length;
+    gboolean finished;
+    GQuark domain;
+
+    //Initializations
+    memset (db->tables, 0, sizeof(db->tables));
+    if (error != NULL && *error != NULL) return;
+    default_path = NULL;
+    finished = FALSE;
+    if (path == NULL) path = default_path = lw_strokedb_get_default_path ();
+
+    file = g_mapped_file_new (path, FALSE, error);
+
+    if (file != NULL)
+    {
+      ptr = g_mapped_file_get_contents (file);
+      end = ptr + g_mapped_file_get_length (file);
+
+      //Each block is a big endian stroke count and length followed by the characters
+      while (TRUE)
+      {
+        if (ptr + sizeof(header) > end) break;
+        memcpy (header, ptr, sizeof(header));
+        strokes = GUINT32_FROM_BE (header[0]);
+        length = GUINT32_FROM_BE (header[1]);
+        ptr += sizeof(header);
+
+        if (strokes == 0)
+        {
+          finished = TRUE;
+          break;
+        }
+        if (strokes > LW_STROKEDB_MAX_STROKES || length == 0 || length > end - ptr || ptr[length - 1] != '\0') break;
+
+        _strokedb_table_clear (&db->tables[strokes]);
+        _strokedb_table_decode (&db->tables[strokes], ptr, strokes);
+        ptr += length;
+      }
+
+      if (!finished)
+      {
+        domain = g_quark_from_string (LW_STROKEDB_ERROR);
+        g_set_error (error, domain, LW_STROKEDB_ERROR_CORRUPT, gettext("The stroke database %s is corrupt."), path);
+        lw_strokedb_deinit (db);
+      }
+
+      g_mapped_file_unref (file);
+    }
+
+    //Cleanup
+    g_free (default_path);
+}
+
+
+//!
+//! @brief Frees the decoded tables
+//! @param db The LwStrokeDB to deinitialize
+//!
+void 
+lw_strokedb_deinit (LwStrokeDB *db)
+{
+    int i;
+
+    for (i = 0; i <= LW_STROKEDB_MAX_STROKES; i++) _strokedb_table_clear (&db->tables[i]);
+}
+
+
+//!
+//! @brief Finds the installed jdata.dat
+//! @returns A newly allocated path that should be freed with g_free
+//!
+gchar* 
+lw_strokedb_get_default_path ()
+{
+    gchar *path;
+
+#ifdef G_OS_WIN32
+    path = g_build_filename ("..", "share", PACKAGE, "jdata.dat", NULL);
+#else
+    path = g_build_filename (DATADIR2, PACKAGE, "jdata.dat", NULL);
+#endif
+
+    if (!g_file_test (path, G_FILE_TEST_EXISTS))
+    {
+      g_free (path);
+      path = g_strdup ("jdata.dat");
+    }
+
+    return path;
+}
+
+
+//!
+//! @brief Keeps a score if it is among the best of the chunk.  Equal scores
+//!        stay in table order like the jstroke list does.
+//!
+static void 
+_strokedb_chunk_insert (LwStrokeDBChunk *chunk, LwStrokeDBTable *table, gint index, gulong score)
+{
+    gint i;
+
+    for (i = chunk->total; i > 0 && score < chunk->candidates[i - 1].score; i--);
+    if (i >= chunk->max) return;
+
+    if (chunk->total < chunk->max) chunk->total++;
+    memmove (chunk->candidates + i + 1, chunk->candidates + i, sizeof(LwStrokeDBCandidate) * (chunk->total - i - 1));
+    chunk->candidates[i].jis[0] = table->jis[index * 2];
+    chunk->candidates[i].jis[1] = table->jis[index * 2 + 1];
+    chunk->candidates[i].score = score;
+    chunk->candidates[i].strokes = table->strokes;
+}
+
+
+//!
+//! @brief Copies strokes into the fixed size buffers of jstroke
+//!
+static void 
+_strokedb_copy_raw (RawStroke *raw, const LwStroke *stroke)
+{
+    raw->m_len = MIN (stroke->length, diMaxXyPairs);
+    memcpy (raw->m_x, stroke->x, raw->m_len);
+    memcpy (raw->m_y, stroke->y, raw->m_len);
+}
+
+
+//!
+//! @brief Runs a function over an array of parts with a thread for each one.
+//!        The calling thread does the first part itself.
+//!
+static void 
+_strokedb_run_parts (GThreadFunc func, gpointer parts, gsize size, gint total)
+{
+    //Declarations
+    GThread *threads[LW_STROKEDB_MAX_THREADS];
+    int i;
+
+    for (i = 1; i < total; i++)
+    {
+      threads[i] = g_thread_create (func, (char*) parts + size * i, TRUE, NULL);
+      if (threads[i] == NULL) func ((char*) parts + size * i);
+    }
+
+    func (parts);
+
+    for (i = 1; i < total; i++)
+    {
+      if (threads[i] != NULL) g_thread_join (threads[i]);
+    }
+}
+
+
+//!
+//! @brief Scores the characters of a chunk.  Each thread has its own
+//!        StrokeScorer since the scorer caches work for the strokes.
+//!
+static gpointer 
+_strokedb_chunk_score (gpointer data)
+{
+    //Declarations
+    LwStrokeDBChunk *chunk;
+    LwStrokeDBTable *table;
+    StrokeScorer *scorer;
+    ULong score;
+    guint filter_start;
+    guint filter_end;
+    gint i;
+
+    //Initializations
+    chunk = data;
+    table = chunk->table;
+    scorer = StrokeScorerCreate (NULL, chunk->raw, table->strokes);
+    if (scorer == NULL) return NULL;
+
+    for (i = chunk->start; i < chunk->end; i++)
+    {
+      score = StrokeScorerScorePaths (scorer, table->paths, table->path_offsets + i * table->strokes);
+
+      filter_start = table->filter_offsets[i];
+      filter_end = table->filter_offsets[i + 1];
+      if (filter_end > filter_start)
+      {
+        StrokeScorerApplyFilters (scorer, table->filters + filter_start, (filter_end - filter_start) / diFilterOpLen, &score);
+      }
+
+      _strokedb_chunk_insert (chunk, table, i, score);
+    }
+
+    //Cleanup
+    StrokeScorerDestroy (scorer);
+
+    return NULL;
+}
+
+
+//!
+//! @brief Merges the best characters of chunks.  The earlier chunk wins a tie.
+//! @returns The number of candidates written
+//!
+static gint 
+_strokedb_chunk_merge (LwStrokeDBChunk *chunks, gint total, LwStrokeDBCandidate *candidates, gint max)
+{
+    //Declarations
+    gint heads[LW_STROKEDB_MAX_THREADS];
+    gint count;
+    gint best;
+    int i;
+
+    for (i = 0; i < total; i++) heads[i] = 0;
+
+    for (count = 0; count < max; count++)
+    {
+      best = -1;
+      for (i = 0; i < total; i++)
+      {
+        if (heads[i] == chunks[i].total) continue;
+        if (best == -1 || chunks[i].candidates[heads[i]].score < chunks[best].candidates[heads[best]].score) best = i;
+      }
+      if (best == -1) break;
+
+      candidates[count] = chunks[best].candidates[heads[best]];
+      heads[best]++;
+    }
+
+    return count;
+}
+
+
+//!
+//! @brief Scores the strokes against every character with the same stroke count
+//! @param db A LwStrokeDB
+//! @param strokes The strokes to recognize
+//! @param total The number of strokes
+//! @param candidates An array to write the best matches to with the best first
+//! @param max The size of the candidates array.  Any number of candidates can be asked for.
+//! @returns The number of candidates written
+//!
+gint 
+lw_strokedb_recognize (LwStrokeDB *db, const LwStroke *strokes, gint total, LwStrokeDBCandidate *candidates, gint max)
+{
+    //Declarations
+    RawStroke raw[LW_STROKEDB_MAX_STROKES];
+    LwStrokeDBChunk chunks[LW_STROKEDB_MAX_THREADS];
+    LwStrokeDBTable *table;
+    gint thread_total;
+    gint count;
+    int i;
+
+    if (db == NULL || total < 1 || total > LW_STROKEDB_MAX_STROKES || max < 1) return 0;
+    table = &db->tables[total];
+    if (table->total == 0) return 0;
+
+    //Initializations
+    for (i = 0; i < total; i++) _strokedb_copy_raw (&raw[i], &strokes[i]);
+    thread_total = CLAMP (table->total / LW_STROKEDB_MIN_THREAD_LOAD, 1, LW_STROKEDB_MAX_THREADS);
+
+    for (i = 0; i < thread_total; i++)
+    {
+      chunks[i].table = table;
+      chunks[i].raw = raw;
+      chunks[i].start = table->total * i / thread_total;
+      chunks[i].end = table->total * (i + 1) / thread_total;
+      chunks[i].max = max;
+      chunks[i].candidates = g_new (LwStrokeDBCandidate, max);
+      chunks[i].total = 0;
+    }
+
+    _strokedb_run_parts (_strokedb_chunk_score, chunks, sizeof(LwStrokeDBChunk), thread_total);
+    count = _strokedb_chunk_merge (chunks, thread_total, candidates, max);
+
+    //Cleanup
+    for (i = 0; i < thread_total; i++) g_free (chunks[i].candidates);
+
+    return count;
+}
+
+
+//!
+//! @brief Creates a new LwStrokeDBSession object
+//! @param db The LwStrokeDB to recognize with.  It must outlive the session.
+//! @return An allocated LwStrokeDBSession that will be needed to be freed by lw_strokedb_session_free.
+//!
+LwStrokeDBSession* 
+lw_strokedb_session_new (LwStrokeDB *db)
+{
+    LwStrokeDBSession *temp;
+
+    temp = (LwStrokeDBSession*) malloc(sizeof(LwStrokeDBSession));
+
+    if (temp != NULL)
+    {
+      lw_strokedb_session_init (temp, db);
+    }
+
+    return temp;
+}
+
+
+//!
+//! @brief Releases a LwStrokeDBSession object from memory.
+//! @param session A LwStrokeDBSession object created by lw_strokedb_session_new.
+//!
+void 
+lw_strokedb_session_free (LwStrokeDBSession *session)
+{
+    lw_strokedb_session_deinit (session);
+    free (session);
+}
+
+
+void 
+lw_strokedb_session_init (LwStrokeDBSession *session, LwStrokeDB *db)
+{
+    int i;
+
+    session->db = db;
+    session->total_strokes = 0;
+
+    for (i = 0; i <= LW_STROKEDB_MAX_STROKES; i++)
+    {
+      if (db->tables[i].total > 0)
+        session->sums[i] = g_new0 (gulong, db->tables[i].total);
+      else
+        session->sums[i] = NULL;
+    }
+}
+
+
+void 
+lw_strokedb_session_deinit (LwStrokeDBSession *session)
+{
+    int i;
+
+    for (i = 0; i <= LW_STROKEDB_MAX_STROKES; i++)
+    {
+      g_free (session->sums[i]);
+      session->sums[i] = NULL;
+    }
+    session->total_strokes = 0;
+}
+
+
+//!
+//! @brief Forgets the strokes so a new character can be drawn
+//! @param session A LwStrokeDBSession
+//!
+void 
+lw_strokedb_session_clear (LwStrokeDBSession *session)
+{
+    int i;
+
+    for (i = 0; i <= LW_STROKEDB_MAX_STROKES; i++)
+    {
+      if (session->sums[i] != NULL)
+        memset (session->sums[i], 0, sizeof(gulong) * session->db->tables[i].total);
+    }
+    session->total_strokes = 0;
+}
+
+
+//!
+//! @brief Scores the new stroke of a session against a slice of each table
+//!        that has a stroke for it
+//!
+static gpointer 
+_strokedb_session_score_part (gpointer data)
+{
+    //Declarations
+    LwStrokeDBSessionPart *part;
+    LwStrokeDBSession *session;
+    LwStrokeDBTable *table;
+    StrokeScorer *scorer;
+    gulong *sums;
+    guint offset;
+    guint length;
+    gint stroke;
+    gint start;
+    gint end;
+    gint i;
+    gint j;
+
+    //Initializations
+    part = data;
+    session = part->session;
+    stroke = session->total_strokes - 1;
+    scorer = StrokeScorerCreate (NULL, part->raw, 1);
+    if (scorer == NULL) return NULL;
+
+    for (i = stroke + 1; i <= LW_STROKEDB_MAX_STROKES; i++)
+    {
+      table = &session->db->tables[i];
+      sums = session->sums[i];
+      if (sums == NULL) continue;
+      start = table->total * part->part / part->parts;
+      end = table->total * (part->part + 1) / part->parts;
+
+      for (j = start; j < end; j++)
+      {
+        offset = table->path_offsets[j * table->strokes + stroke];
+        length = table->path_offsets[j * table->strokes + stroke + 1] - offset;
+        if (length == 0) continue;  //The description ran out of strokes
+
+        sums[j] = StrokeScoreAddSquare (sums[j], StrokeScorerScoreStroke (scorer, 0, table->paths + offset, length));
+      }
+    }
+
+    //Cleanup
+    StrokeScorerDestroy (scorer);
+
+    return NULL;
+}
+
+
+//!
+//! @brief Adds a stroke and scores only it against the characters that have that many strokes
+//! @param session A LwStrokeDBSession
+//! @param stroke The new stroke
+//! @returns FALSE if the session already has LW_STROKEDB_MAX_STROKES strokes
+//!
+gboolean 
+lw_strokedb_session_add_stroke (LwStrokeDBSession *session, const LwStroke *stroke)
+{
+    //Declarations
+    LwStrokeDBSessionPart parts[LW_STROKEDB_MAX_THREADS];
+    RawStroke raw;
+    gint load;
+    gint part_total;
+    int i;
+
+    if (session->total_strokes >= LW_STROKEDB_MAX_STROKES) return FALSE;
+
+    //Initializations
+    session->strokes[session->total_strokes] = *stroke;
+    session->total_strokes++;
+    _strokedb_copy_raw (&raw, stroke);
+    load = 0;
+    for (i = session->total_strokes; i <= LW_STROKEDB_MAX_STROKES; i++) load += session->db->tables[i].total;
+    part_total = CLAMP (load / LW_STROKEDB_MIN_THREAD_LOAD, 1, LW_STROKEDB_MAX_THREADS);
+
+    for (i = 0; i < part_total; i++)
+    {
+      parts[i].session = session;
+      parts[i].raw = &raw;
+      parts[i].part = i;
+      parts[i].parts = part_total;
+    }
+
+    _strokedb_run_parts (_strokedb_session_score_part, parts, sizeof(LwStrokeDBSessionPart), part_total);
+
+    return TRUE;
+}
+
+
+//!
+//! @brief Ranks the characters against the strokes drawn so far.  Characters with
+//!        the same stroke count get the same score as lw_strokedb_recognize gives
+//!        them.  Characters with more strokes are scored on the ones drawn.
+//! @param session A LwStrokeDBSession
+//! @param candidates An array to write the best matches to with the best first
+//! @param max The size of the candidates array
+//! @returns The number of candidates written
+//!
+gint 
+lw_strokedb_session_get_candidates (LwStrokeDBSession *session, LwStrokeDBCandidate *candidates, gint max)
+{
+    //Declarations
+    RawStroke raw[LW_STROKEDB_MAX_STROKES];
+    LwStrokeDBChunk chunk;
+    LwStrokeDBTable *table;
+    StrokeScorer *scorer;
+    ULong score;
+    guint filter_start;
+    guint filter_end;
+    gint total;
+    gint i;
+    gint j;
+
+    total = session->total_strokes;
+    if (total < 1 || max < 1) return 0;
+
+    //Initializations
+    for (i = 0; i < total; i++) _strokedb_copy_raw (&raw[i], &session->strokes[i]);
+    chunk.max = max;
+    chunk.candidates = candidates;
+    chunk.total = 0;
+    scorer = NULL;
+
+    for (i = total; i <= LW_STROKEDB_MAX_STROKES; i++)
+    {
+      table = &session->db->tables[i];
+      if (session->sums[i] == NULL) continue;
+
+      for (j = 0; j < table->total; j++)
+      {
+        score = SqrtULong (session->sums[i][j]);
+
+        //The extra filters compare strokes so they only apply once all of them are drawn
+        filter_start = table->filter_offsets[j];
+        filter_end = table->filter_offsets[j + 1];
+        if (i == total && filter_end > filter_start)
+        {
+          if (scorer == NULL) scorer = StrokeScorerCreate (NULL, raw, total);
+          if (scorer != NULL) StrokeScorerApplyFilters (scorer, table->filters + filter_start, (filter_end - filter_start) / diFilterOpLen, &score);
+        }
+
+        _strokedb_chunk_insert (&chunk, table, j, score);
+      }
+    }
+
+    //Cleanup
+    if (scorer != NULL) StrokeScorerDestroy (scorer);
+
+    return chunk.total;
+}
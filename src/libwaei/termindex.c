@@ -0,0 +1,614 @@
+/******************************************************************************
+    AUTHOR:
+    File written and Copyrighted by Zachary Dovel. All Rights Reserved.
+
+    LICENSE:
+    This file is part of gWaei.
+
+    gWaei is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    gWaei is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    
+    You should have received a copy of the GNU General Public License
+    along with gWaei.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+
+//!
+//! @file termindex.c
+//!
+//! @brief A sorted term dictionary of an EDICT dictionary for fuzzy searches
+//!
+//! The terms are the lowercased words of the English glosses and the readings
+//! of the entries shifted to hiragana.  Each one has the byte offsets of the
+//! lines it is in, so a search only has to read the lines of the terms a
+//! LwLevenshtein automaton accepts.  The index is kept in the cache folder
+//! as a LwCacheFile.
+//!
+
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include <libwaei/libwaei.h>
+
+
+//!
+//! @brief Shifts the katakana of a reading to hiragana in place.  Both take three
+//!        bytes in UTF-8 so the length doesn't change.  The long vowel mark is kept.
+//! @param text A UTF-8 string to normalize
+//! @returns FALSE if the text has something other than kana or is too long or short to be a term
+//!
+gboolean 
+lw_termindex_normalize_reading (gchar *text)
+{
+    //Declarations
+    gchar *ptr;
+    gunichar c;
+    gint length;
+
+    //Initializations
+    length = 0;
+
+    for (ptr = text; *ptr != '\0'; ptr = g_utf8_next_char (ptr))
+    {
+      c = g_utf8_get_char (ptr);
+      if (c < 0x3041 || c > 0x30ff || c == 0x30fb) return FALSE;
+      if (c >= 0x30a1 && c <= 0x30f6) g_unichar_to_utf8 (c - 0x60, ptr);
+      length++;
+    }
+
+    return (length >= LW_TERMINDEX_MIN_TERM_LENGTH && length <= LW_TERMINDEX_MAX_TERM_LENGTH);
+}
+
+
+static void 
+_termindex_add (LwTermIndexBuilder *builder, const gchar *TERM, guint32 offset)
+{
+    //Declarations
+    GArray *postings;
+
+    //Initializations
+    postings = g_hash_table_lookup (builder->table, TERM);
+
+    if (postings == NULL)
+    {
+      postings = g_array_new (FALSE, FALSE, sizeof(guint32));
+      g_hash_table_insert (builder->table, g_string_chunk_insert (builder->strings, TERM), postings);
+    }
+
+    //A word can be in more than one gloss of a line
+    if (postings->len > 0 && g_array_index (postings, guint32, postings->len - 1) == offset) return;
+
+    g_array_append_val (postings, offset);
+}
+
+
+//!
+//! @brief Adds the readings of one EDICT line, the text in the brackets or the
+//!        headword when the headword is already kana.  Alternate readings are
+//!        separated with semicolons and can have notes in parentheses.
+//!
+static void 
+_termindex_add_readings (LwTermIndexBuilder *builder, const gchar *LINE, guint32 offset)
+{
+    //Declarations
+    gchar buffer[LW_TERMINDEX_MAX_TERM_LENGTH * 4 + 1];
+    const gchar *start;
+    const gchar *end;
+    const gchar *ptr;
+    const gchar *next;
+    const gchar *slash;
+    const gchar *paren;
+    gsize length;
+
+    //Initializations
+    slash = strchr (LINE, '/');
+    if (slash == NULL) return;
+
+    start = memchr (LINE, '[', slash - LINE);
+    if (start != NULL)
+    {
+      start++;
+      end = memchr (start, ']', slash - start);
+    }
+    else
+    {
+      start = LINE;
+      end = memchr (start, ' ', slash - start);
+    }
+    if (end == NULL) return;
+
+    for (ptr = start; ptr < end; ptr = next + 1)
+    {
+      next = memchr (ptr, ';', end - ptr);
+      if (next == NULL) next = end;
+
+      paren = memchr (ptr, '(', next - ptr);
+      length = ((paren != NULL) ? paren : next) - ptr;
+
+      if (length > 0 && length < sizeof(buffer))
+      {
+        memcpy (buffer, ptr, length);
+        buffer[length] = '\0';
+        if (lw_termindex_normalize_reading (buffer)) _termindex_add (builder, buffer, offset);
+      }
+    }
+}
+
+
+//!
+//! @brief Adds the words of the glosses of one EDICT line the same way the
+//!        LwSpellIndex reads them.  Notes in parentheses and words with digits
+//!        are skipped.
+//!
+static void 
+_termindex_add_glosses (LwTermIndexBuilder *builder, const gchar *LINE, guint32 offset)
+{
+    //Declarations
+    gchar buffer[LW_TERMINDEX_MAX_TERM_LENGTH + 1];
+    const gchar *ptr;
+    const gchar *start;
+    gboolean has_digits;
+    gint depth;
+    gint length;
+    gint i;
+
+    //Initializations
+    ptr = strchr (LINE, '/');
+    depth = 0;
+
+    if (ptr == NULL) return;
+
+    while (*ptr != '\0')
+    {
+      if (g_ascii_isalnum (*ptr))
+      {
+        start = ptr;
+        has_digits = FALSE;
+        while (g_ascii_isalnum (*ptr))
+        {
+          if (g_ascii_isdigit (*ptr)) has_digits = TRUE;
+          ptr++;
+        }
+        length = ptr - start;
+        if (depth == 0 && !has_digits && length >= LW_TERMINDEX_MIN_TERM_LENGTH && length <= LW_TERMINDEX_MAX_TERM_LENGTH)
+        {
+          for (i = 0; i < length; i++) buffer[i] = g_ascii_tolower (start[i]);
+          buffer[length] = '\0';
+          _termindex_add (builder, buffer, offset);
+        }
+        continue;
+      }
+
+      if (*ptr == '(') depth++;
+      else if (*ptr == ')' && depth > 0) depth--;
+      else if (*ptr == '/') depth = 0;
+
+      ptr++;
+    }
+}
+
+
+static void 
+_termindex_free_postings (gpointer data)
+{
+    g_array_free ((GArray*) data, TRUE);
+}
+
+
+//!
+//! @brief Checks that the counts in the header of a term index match its length
+//!
+static gboolean 
+_termindex_check (const LwCacheFileHeader *FILE_HEADER, gsize length)
+{
+    //Declarations
+    const LwTermIndexHeader *header;
+    const guint32 *terms;
+    const guint32 *posting_offsets;
+
+    //Initializations
+    header = (const LwTermIndexHeader*) FILE_HEADER;
+
+    if (length < sizeof(LwTermIndexHeader)) return FALSE;
+    if (length != sizeof(LwTermIndexHeader) + sizeof(guint32) * (2 * ((gsize) header->total_terms + 1) + header->total_postings) + header->strings_length) return FALSE;
+
+    terms = (const guint32*) (header + 1);
+    posting_offsets = terms + header->total_terms + 1;
+
+    return (terms[header->total_terms] == header->strings_length && posting_offsets[header->total_terms] == header->total_postings);
+}
+
+
+static const LwCacheFileType _termindex_type = {
+  "terms", LW_TERMINDEX_MAGIC, LW_TERMINDEX_VERSION, _termindex_check, lw_termindex_build
+};
+
+
+//!
+//! @brief Creates a new LwTermIndexBuilder object to collect the terms of a dictionary
+//! @return An allocated LwTermIndexBuilder that will be needed to be freed by lw_termindex_builder_free.
+//!
+LwTermIndexBuilder* 
+lw_termindex_builder_new ()
+{
+    LwTermIndexBuilder *temp;
+
+    temp = (LwTermIndexBuilder*) malloc(sizeof(LwTermIndexBuilder));
+
+    if (temp != NULL)
+    {
+      temp->table = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, _termindex_free_postings);
+      temp->strings = g_string_chunk_new (64 * 1024);
+      temp->offset = 0;
+    }
+
+    return temp;
+}
+
+
+//!
+//! @brief Releases a LwTermIndexBuilder object from memory.
+//! @param builder A LwTermIndexBuilder object created by lw_termindex_builder_new.
+//!
+void 
+lw_termindex_builder_free (LwTermIndexBuilder *builder)
+{
+    g_hash_table_destroy (builder->table);
+    g_string_chunk_free (builder->strings);
+
+    free (builder);
+}
+
+
+//!
+//! @brief A LwIoLineFunc that adds the terms of the next line of an EDICT dictionary
+//!        to a LwTermIndexBuilder.  The lines have to be passed in file order.
+//! @param LINE The nul terminated line with its line end
+//! @param LENGTH The length of the line in bytes
+//! @param data A LwTermIndexBuilder
+//! @returns Always TRUE
+//!
+gboolean 
+lw_termindex_builder_add_line (const gchar *LINE, gsize LENGTH, gpointer data)
+{
+    //Declarations
+    LwTermIndexBuilder *builder;
+    gunichar first;
+
+    //Initializations
+    builder = data;
+    first = g_utf8_get_char (LINE);
+
+    if (first != '#' && first != L'？' && first != 0x3000)
+    {
+      _termindex_add_readings (builder, LINE, builder->offset);
+      _termindex_add_glosses (builder, LINE, builder->offset);
+    }
+    builder->offset += LENGTH;
+
+    return TRUE;
+}
+
+
+//!
+//! @brief Writes the term index of an installed dictionary to the cache folder
+//!        from the lines given to a LwTermIndexBuilder
+//! @param builder A LwTermIndexBuilder that was given every line of the dictionary
+//! @param TYPE The LwDictType of the dictionary
+//! @param FILENAME The filename of the dictionary in its dictionary folder
+//! @param error A pointer to a GError to write errors to or NULL
+//! @returns FALSE if the index couldn't be written
+//!
+gboolean 
+lw_termindex_builder_write (LwTermIndexBuilder *builder, LwDictType TYPE, const gchar *FILENAME, GError **error)
+{
+    //Sanity check
+    if (error != NULL && *error != NULL) return FALSE;
+
+    //Declarations
+    GList *keys;
+    GList *link;
+    GArray *postings;
+    LwTermIndexHeader header;
+    gchar *data;
+    gsize length;
+    guint32 *terms;
+    guint32 *posting_offsets;
+    guint32 *posting_data;
+    gchar *string_data;
+    guint32 i;
+    gboolean written;
+
+    //Initializations
+    keys = g_list_sort (g_hash_table_get_keys (builder->table), (GCompareFunc) strcmp);
+
+    memset (&header, 0, sizeof(LwTermIndexHeader));
+    header.total_terms = g_hash_table_size (builder->table);
+
+    for (link = keys; link != NULL; link = link->next)
+    {
+      postings = g_hash_table_lookup (builder->table, link->data);
+      header.total_postings += postings->len;
+      header.strings_length += strlen ((gchar*) link->data) + 1;
+    }
+
+    //Lay out the file
+    length = sizeof(LwTermIndexHeader) + sizeof(guint32) * (2 * (header.total_terms + 1) + header.total_postings) + header.strings_length;
+    data = g_malloc (length);
+    memcpy (data, &header, sizeof(LwTermIndexHeader));
+    terms = (guint32*) (data + sizeof(LwTermIndexHeader));
+    posting_offsets = terms + header.total_terms + 1;
+    posting_data = posting_offsets + header.total_terms + 1;
+    string_data = (gchar*) (posting_data + header.total_postings);
+
+    terms[0] = 0;
+    posting_offsets[0] = 0;
+    for (link = keys, i = 0; link != NULL; link = link->next, i++)
+    {
+      postings = g_hash_table_lookup (builder->table, link->data);
+      memcpy (posting_data + posting_offsets[i], postings->data, sizeof(guint32) * postings->len);
+      posting_offsets[i + 1] = posting_offsets[i] + postings->len;
+      strcpy (string_data + terms[i], (gchar*) link->data);
+      terms[i + 1] = terms[i] + strlen ((gchar*) link->data) + 1;
+    }
+
+    written = lw_cachefile_write (&_termindex_type, TYPE, FILENAME, data, length, error);
+
+    //Cleanup
+    g_list_free (keys);
+    g_free (data);
+
+    return written;
+}
+
+
+//!
+//! @brief Reads an installed EDICT dictionary and writes its term index to the cache folder.
+//!        The installer feeds a LwTermIndexBuilder from the lines it writes instead.
+//! @param TYPE The LwDictType of the dictionary
+//! @param FILENAME The filename of the dictionary in its dictionary folder
+//! @param error A pointer to a GError to write errors to or NULL
+//! @returns FALSE if the dictionary couldn't be read or the index couldn't be written
+//!
+gboolean 
+lw_termindex_build (LwDictType TYPE, const gchar *FILENAME, GError **error)
+{
+    //Sanity check
+    if (error != NULL && *error != NULL) return FALSE;
+
+    //Declarations
+    LwTermIndexBuilder *builder;
+    gchar *path;
+    gboolean written;
+
+    //Initializations
+    builder = lw_termindex_builder_new ();
+    path = lw_util_build_filename_by_dicttype (TYPE, FILENAME);
+
+    written = (lw_io_stream_file (path, LW_COMPRESSION_NONE, NULL, lw_termindex_builder_add_line, builder, NULL, NULL, error) &&
+               lw_termindex_builder_write (builder, TYPE, FILENAME, error));
+
+    //Cleanup
+    lw_termindex_builder_free (builder);
+    g_free (path);
+
+    return written;
+}
+
+
+//!
+//! @brief Removes the term index of a dictionary from the cache folder if there is one
+//! @param TYPE The LwDictType of the dictionary
+//! @param FILENAME The filename of the dictionary in its dictionary folder
+//!
+void 
+lw_termindex_remove (LwDictType TYPE, const gchar *FILENAME)
+{
+    lw_cachefile_remove (&_termindex_type, TYPE, FILENAME);
+}
+
+
+//!
+//! @brief Maps the term index of a dictionary, writing it first if it is missing
+//!        or older than the dictionary.  Writing it reads the whole dictionary,
+//!        so this shouldn't be called from the main thread.
+//! @param TYPE The LwDictType of the dictionary
+//! @param FILENAME The filename of the dictionary in its dictionary folder
+//! @param error A pointer to a GError to write errors to or NULL
+//! @return An allocated LwTermIndex that will be needed to be freed by lw_termindex_free or NULL on error
+//!
+LwTermIndex* 
+lw_termindex_new (LwDictType TYPE, const gchar *FILENAME, GError **error)
+{
+    //Sanity check
+    if (error != NULL && *error != NULL) return NULL;
+
+    //Declarations
+    LwTermIndex *index;
+    GMappedFile *file;
+    const LwTermIndexHeader *header;
+
+    //Initializations
+    file = lw_cachefile_map (&_termindex_type, TYPE, FILENAME, error);
+    if (file == NULL) return NULL;
+
+    index = (LwTermIndex*) malloc(sizeof(LwTermIndex));
+    if (index == NULL)
+    {
+      g_mapped_file_unref (file);
+      return NULL;
+    }
+
+    header = (const LwTermIndexHeader*) g_mapped_file_get_contents (file);
+    index->file = file;
+    index->header = header;
+    index->terms = (const guint32*) (header + 1);
+    index->posting_offsets = index->terms + header->total_terms + 1;
+    index->postings = index->posting_offsets + header->total_terms + 1;
+    index->strings = (const gchar*) (index->postings + header->total_postings);
+
+    return index;
+}
+
+
+//!
+//! @brief Releases a LwTermIndex object from memory.
+//! @param index A LwTermIndex object created by lw_termindex_new.
+//!
+void 
+lw_termindex_free (LwTermIndex *index)
+{
+    g_mapped_file_unref (index->file);
+    free (index);
+}
+
+
+guint32 
+lw_termindex_get_total_terms (LwTermIndex *index)
+{
+    return index->header->total_terms;
+}
+
+
+const gchar* 
+lw_termindex_get_term (LwTermIndex *index, guint32 term)
+{
+    g_assert (term < index->header->total_terms);
+
+    return index->strings + index->terms[term];
+}
+
+
+//!
+//! @brief Gets the lines a term is in
+//! @param index An LwTermIndex
+//! @param term The number of the term
+//! @param total A pointer to write the number of lines to
+//! @returns The byte offsets of the lines in increasing order.  They belong to the index.
+//!
+const guint32* 
+lw_termindex_get_postings (LwTermIndex *index, guint32 term, guint32 *total)
+{
+    g_assert (term < index->header->total_terms);
+
+    *total = index->posting_offsets[term + 1] - index->posting_offsets[term];
+
+    return index->postings + index->posting_offsets[term];
+}
+
+
+//!
+//! @brief Finds the first term after term i that doesn't start with the first length bytes of PREFIX
+//!
+static guint32 
+_termindex_skip_prefix (LwTermIndex *index, guint32 i, const gchar *PREFIX, gsize length)
+{
+    //Declarations
+    guint32 low;
+    guint32 high;
+    guint32 middle;
+
+    //Initializations
+    low = i + 1;
+    high = index->header->total_terms;
+
+    while (low < high)
+    {
+      middle = low + (high - low) / 2;
+      if (strncmp (lw_termindex_get_term (index, middle), PREFIX, length) == 0)
+        low = middle + 1;
+      else
+        high = middle;
+    }
+
+    return low;
+}
+
+
+//!
+//! @brief Runs a Levenshtein automaton over the sorted terms.  The states of the
+//!        characters a term shares with the one before it are kept, and when
+//!        the automaton can't match anything past some characters the terms
+//!        that start with them are skipped with a binary search.
+//! @param index An LwTermIndex
+//! @param automaton The LwLevenshtein to match with
+//! @param matches A GArray of LwTermIndexMatch to append the matching terms to
+//!
+void 
+lw_termindex_find_fuzzy (LwTermIndex *index, LwLevenshtein *automaton, GArray *matches)
+{
+    //Declarations
+    gint size;
+    gint *states;
+    gsize ends[LW_TERMINDEX_MAX_TERM_LENGTH + 1];
+    const gchar *term;
+    const gchar *previous;
+    gsize common;
+    gint valid;
+    gint depth;
+    gboolean alive;
+    LwTermIndexMatch match;
+    guint32 total;
+    guint32 i;
+
+    //Initializations
+    size = lw_levenshtein_get_state_size (automaton);
+    states = g_new (gint, (LW_TERMINDEX_MAX_TERM_LENGTH + 1) * size);
+    ends[0] = 0;
+    previous = "";
+    valid = 0;
+    total = lw_termindex_get_total_terms (index);
+    i = 0;
+
+    lw_levenshtein_start (automaton, states);
+
+    while (i < total)
+    {
+      term = lw_termindex_get_term (index, i);
+
+      //Keep the states of the whole characters shared with the previous term
+      for (common = 0; term[common] != '\0' && term[common] == previous[common]; common++);
+      for (depth = 0; depth < valid && ends[depth + 1] <= common; depth++);
+
+      alive = TRUE;
+      while (alive && term[ends[depth]] != '\0' && depth < LW_TERMINDEX_MAX_TERM_LENGTH)
+      {
+        ends[depth + 1] = g_utf8_next_char (term + ends[depth]) - term;
+        alive = lw_levenshtein_step (automaton, states + depth * size, g_utf8_get_char (term + ends[depth]), states + (depth + 1) * size);
+        depth++;
+      }
+
+      previous = term;
+      valid = depth;
+
+      if (!alive)
+      {
+        i = _termindex_skip_prefix (index, i, term, ends[depth]);
+        continue;
+      }
+
+      match.distance = lw_levenshtein_get_distance (automaton, states + depth * size);
+      if (match.distance >= 0)
+      {
+        match.term = i;
+        g_array_append_val (matches, match);
+      }
+      i++;
+    }
+
+    //Cleanup
+    g_free (states);
+}
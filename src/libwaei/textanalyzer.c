@@ -0,0 +1,324 @@
+/******************************************************************************
+    AUTHOR:
+    File written and Copyrighted by Zachary Dovel. All Rights Reserved.
+
+    LICENSE:
+    This file is part of gWaei.
+
+    gWaei is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    gWaei is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with gWaei.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+
+//!
+//! @file textanalyzer.c
+//!
+//! @brief Splits Japanese text into dictionary words for reading it
+//!
+//! The text is cut greedily: at each position the longest headword or reading
+//! the LwHeadwordTrie knows is taken, and characters no key starts are
+//! gathered into segments of their own.  The entries of a segment are read
+//! from the mapped dictionary at the offsets the trie keeps, so nothing is
+//! scanned and the work per character is bounded by the longest key.
+//!
+
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <glib.h>
+
+#include <libwaei/libwaei.h>
+
+
+//!
+//! @brief Creates a new LwTextAnalyzer object
+//! @param di An installed EDICT dictionary
+//! @param error A pointer to a GError to write errors to or NULL
+//! @return An allocated LwTextAnalyzer that will be needed to be freed by lw_textanalyzer_free or NULL on error
+//!
+LwTextAnalyzer* 
+lw_textanalyzer_new (LwDictInfo *di, GError **error)
+{
+    //Sanity check
+    if (error != NULL && *error != NULL) return NULL;
+    if (di->type != LW_DICTTYPE_EDICT)
+    {
+      g_set_error (error, g_quark_from_string (LW_TEXTANALYZER_ERROR), LW_TEXTANALYZER_ERROR_UNSUPPORTED,
+        gettext("Text can only be analyzed with a word dictionary."));
+      return NULL;
+    }
+
+    //Declarations
+    LwTextAnalyzer *analyzer;
+    LwHeadwordTrie *trie;
+    GMappedFile *file;
+    gchar *path;
+
+    //Initializations
+    trie = lw_headwordtrie_new (di->type, di->filename, error);
+    if (trie == NULL) return NULL;
+
+    path = lw_util_build_filename_by_dicttype (di->type, di->filename);
+    file = g_mapped_file_new (path, FALSE, error);
+    g_free (path);
+
+    //The dictionary could have been replaced after the trie was checked
+    if (file != NULL && g_mapped_file_get_length (file) != trie->header->file.dictionary_size)
+    {
+      g_set_error (error, g_quark_from_string (LW_CACHEFILE_ERROR), LW_CACHEFILE_ERROR_OUTDATED, "The dictionary changed since its headword trie was made");
+      g_mapped_file_unref (file);
+      file = NULL;
+    }
+
+    analyzer = NULL;
+    if (file != NULL) analyzer = (LwTextAnalyzer*) malloc(sizeof(LwTextAnalyzer));
+
+    if (analyzer != NULL)
+    {
+      analyzer->di = di;
+      analyzer->trie = trie;
+      analyzer->file = file;
+    }
+    else
+    {
+      if (file != NULL) g_mapped_file_unref (file);
+      lw_headwordtrie_free (trie);
+    }
+
+    return analyzer;
+}
+
+
+//!
+//! @brief Releases a LwTextAnalyzer object from memory.
+//! @param analyzer A LwTextAnalyzer object created by lw_textanalyzer_new.
+//!
+void 
+lw_textanalyzer_free (LwTextAnalyzer *analyzer)
+{
+    lw_headwordtrie_free (analyzer->trie);
+    g_mapped_file_unref (analyzer->file);
+    free (analyzer);
+}
+
+
+//!
+//! @brief Releases a LwTextSegment object from memory.
+//! @param segment A LwTextSegment from lw_textanalyzer_analyze
+//!
+void 
+lw_textsegment_free (LwTextSegment *segment)
+{
+    g_free (segment->text);
+    free (segment);
+}
+
+
+static LwTextSegment* 
+_textanalyzer_new_segment (const gchar *TEXT, const gchar *START, gsize length)
+{
+    //Declarations
+    LwTextSegment *segment;
+
+    segment = (LwTextSegment*) malloc(sizeof(LwTextSegment));
+    if (segment == NULL) return NULL;
+
+    segment->text = g_strndup (START, length);
+    segment->offset = START - TEXT;
+    segment->total_entries = 0;
+
+    return segment;
+}
+
+
+//!
+//! @brief Gets the bounds of the dictionary line at an offset
+//! @returns FALSE if the offset is outside of the dictionary
+//!
+static gboolean 
+_textanalyzer_get_line (LwTextAnalyzer *analyzer, guint32 offset, const gchar **start, const gchar **end)
+{
+    //Declarations
+    const gchar *contents;
+    gsize length;
+
+    //Initializations
+    contents = g_mapped_file_get_contents (analyzer->file);
+    length = g_mapped_file_get_length (analyzer->file);
+    if (offset >= length) return FALSE;
+
+    *start = contents + offset;
+    *end = memchr (*start, '\n', length - offset);
+    if (*end == NULL) *end = contents + length;
+
+    return TRUE;
+}
+
+
+//!
+//! @brief Tells how well a dictionary line fits a segment.  Being one of the
+//!        headwords beats only being a reading, and then common words come first.
+//!
+static gint 
+_textanalyzer_get_rank (const gchar *START, const gchar *END, const gchar *TEXT)
+{
+    //Declarations
+    const gchar *ptr;
+    const gchar *headwords_end;
+    gsize length;
+    gint rank;
+
+    //Initializations
+    length = strlen (TEXT);
+    rank = (g_strstr_len (START, END - START, "/(P)/") != NULL) ? 1 : 0;
+    headwords_end = memchr (START, ' ', END - START);
+    if (headwords_end == NULL) return rank;
+
+    for (ptr = START; ptr < headwords_end; ptr++)
+    {
+      if (headwords_end - ptr >= length && strncmp (ptr, TEXT, length) == 0 && 
+          (ptr + length == headwords_end || ptr[length] == ';' || ptr[length] == '('))
+      {
+        return rank + 2;
+      }
+      if ((ptr = memchr (ptr, ';', headwords_end - ptr)) == NULL) break;
+    }
+
+    return rank;
+}
+
+
+//!
+//! @brief Ranks the lines of a key and keeps the best ones in the segment
+//!
+static void 
+_textanalyzer_choose_entries (LwTextAnalyzer *analyzer, LwTextSegment *segment, guint32 key)
+{
+    //Declarations
+    const guint32 *postings;
+    const gchar *start;
+    const gchar *end;
+    gint ranks[LW_TEXTANALYZER_MAX_ENTRIES];
+    gint rank;
+    guint32 total;
+    guint32 i;
+    gint j;
+
+    //Initializations
+    postings = lw_headwordtrie_get_postings (analyzer->trie, key, &total);
+
+    //Insert each line after the ones that rank as high so the dictionary order breaks ties
+    for (i = 0; i < total && i < LW_TEXTANALYZER_MAX_CANDIDATES; i++)
+    {
+      if (!_textanalyzer_get_line (analyzer, postings[i], &start, &end)) continue;
+      rank = _textanalyzer_get_rank (start, end, segment->text);
+
+      for (j = segment->total_entries; j > 0 && ranks[j - 1] < rank; j--)
+      {
+        if (j < LW_TEXTANALYZER_MAX_ENTRIES)
+        {
+          ranks[j] = ranks[j - 1];
+          segment->entries[j] = segment->entries[j - 1];
+        }
+      }
+      if (j < LW_TEXTANALYZER_MAX_ENTRIES)
+      {
+        ranks[j] = rank;
+        segment->entries[j] = postings[i];
+        if (segment->total_entries < LW_TEXTANALYZER_MAX_ENTRIES) segment->total_entries++;
+      }
+    }
+}
+
+
+//!
+//! @brief Parses the dictionary line of an entry of a segment
+//! @param analyzer The LwTextAnalyzer the segment came from
+//! @param offset One of the entries of the segment
+//! @param resultline The LwResultLine to parse the line into
+//! @returns FALSE if the offset isn't the start of an entry of the dictionary
+//!
+gboolean 
+lw_textanalyzer_read_entry (LwTextAnalyzer *analyzer, guint32 offset, LwResultLine *resultline)
+{
+    //Declarations
+    const gchar *start;
+    const gchar *end;
+
+    if (!_textanalyzer_get_line (analyzer, offset, &start, &end)) return FALSE;
+    if (memchr (start, ' ', end - start) == NULL) return FALSE;
+
+    //Keep the newline the same as fgets would have
+    if (*end == '\n') end++;
+    if (end - start >= LW_IO_MAX_FGETS_LINE) end = start + LW_IO_MAX_FGETS_LINE - 1;
+
+    memcpy (resultline->string, start, end - start);
+    resultline->string[end - start] = '\0';
+    lw_resultline_clear_matches (resultline);
+    lw_resultline_parse_edict_result_string (resultline);
+
+    return TRUE;
+}
+
+
+//!
+//! @brief Splits a text into the longest dictionary words it starts with, one after the other
+//! @param analyzer A LwTextAnalyzer
+//! @param TEXT A UTF-8 text.  It is analyzed up to the first invalid byte.
+//! @returns A GList of LwTextSegments in text order to be freed with lw_textsegment_free
+//!
+GList* 
+lw_textanalyzer_analyze (LwTextAnalyzer *analyzer, const gchar *TEXT)
+{
+    //Declarations
+    GList *segments;
+    LwTextSegment *segment;
+    const gchar *ptr;
+    const gchar *end;
+    const gchar *unmatched;
+    gsize length;
+    guint32 key;
+
+    //Initializations
+    segments = NULL;
+    unmatched = NULL;
+    g_utf8_validate (TEXT, -1, &end);
+
+    for (ptr = TEXT; ptr < end; ptr += length)
+    {
+      length = lw_headwordtrie_match_longest (analyzer->trie, ptr, end - ptr, &key);
+      if (length == 0)
+      {
+        if (unmatched == NULL) unmatched = ptr;
+        length = g_utf8_next_char (ptr) - ptr;
+        continue;
+      }
+
+      if (unmatched != NULL && (segment = _textanalyzer_new_segment (TEXT, unmatched, ptr - unmatched)) != NULL)
+        segments = g_list_prepend (segments, segment);
+      unmatched = NULL;
+
+      if ((segment = _textanalyzer_new_segment (TEXT, ptr, length)) != NULL)
+      {
+        _textanalyzer_choose_entries (analyzer, segment, key);
+        segments = g_list_prepend (segments, segment);
+      }
+    }
+
+    if (unmatched != NULL && (segment = _textanalyzer_new_segment (TEXT, unmatched, end - unmatched)) != NULL)
+      segments = g_list_prepend (segments, segment);
+
+    return g_list_reverse (segments);
+}
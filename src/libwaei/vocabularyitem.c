@@ -1,5 +1,19 @@
 #include <libwaei/libwaei.h>
 
+const gchar* lw_vocabularyitem_get_field (LwVocabularyItem *item, LwVocabularyItemField field)
+{
+  g_assert (field >= 0 && field < TOTAL_LW_VOCABULARYITEM_FIELDS);
+  return item->fields[field];
+}
+
+void lw_vocabularyitem_set_field (LwVocabularyItem *item, LwVocabularyItemField field, const gchar *text)
+{
+  g_assert (field >= 0 && field < TOTAL_LW_VOCABULARYITEM_FIELDS);
+  if (item->fields[field] != NULL)
+    g_free (item->fields[field]);
+  item->fields[field] = g_strdup (text);
+}
+
 const gchar* lw_vocabularyitem_get_kanji (LwVocabularyItem *item)
 {
   return item->fields[LW_VOCABULARYITEM_FIELD_KANJI];
@@ -1,3 +1,11 @@
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdarg.h>
+
+#include <glib.h>
+#include <glib/gstdio.h>
+
 #include <libwaei/libwaei.h>
 
 
@@ -24,6 +32,7 @@ lw_vocabularylist_get_lists ()
         //Get the size needed for the buffer
         while ((name = g_dir_read_name (dir)) != NULL)
         {
+          if (*name == '.') continue;
           chars += strlen(name) + 1;
         }
 
@@ -34,10 +43,11 @@ lw_vocabularylist_get_lists ()
           //Set the buffer
           while ((name = g_dir_read_name (dir)) != NULL)
           {
+            if (*name == '.') continue; //Journals and hidden files
             strcat(buffer, name);
             strcat(buffer, ";");
           }
-          buffer[strlen(buffer) - 1] = '\0';
+          if (*buffer != '\0') buffer[strlen(buffer) - 1] = '\0';
 
           //Split it
           atoms = g_strsplit (buffer, ";", -1);
@@ -52,6 +62,51 @@ lw_vocabularylist_get_lists ()
     return atoms;
 }
 
+//!
+//! @brief Tells if a file in the vocabulary folder is the journal of a list
+//! @param FILENAME The name of the file without its folder
+//! @returns TRUE if the file is a journal instead of a list
+//!
+gboolean
+lw_vocabularylist_is_journal_filename (const gchar *FILENAME)
+{
+    return (FILENAME[0] == '.' && g_str_has_suffix (FILENAME, LW_VOCABULARYLIST_JOURNAL_SUFFIX));
+}
+
+
+//!
+//! @brief Gets the name of the list a file in the vocabulary folder belongs to
+//! @param FILENAME The name of a list file or journal file without its folder
+//! @returns A newly allocated list name that should be freed with g_free
+//!
+gchar*
+lw_vocabularylist_get_name_from_filename (const gchar *FILENAME)
+{
+    if (lw_vocabularylist_is_journal_filename (FILENAME))
+      return g_strndup (FILENAME + 1, strlen (FILENAME) - 1 - strlen (LW_VOCABULARYLIST_JOURNAL_SUFFIX));
+    else
+      return g_strdup (FILENAME);
+}
+
+
+static gchar*
+_vocabularylist_build_journal_filename (LwVocabularyList *list)
+{
+    //Declarations
+    gchar *filename;
+    gchar *uri;
+
+    //Initializations
+    filename = g_strjoin (NULL, ".", list->name, LW_VOCABULARYLIST_JOURNAL_SUFFIX, NULL);
+    uri = lw_util_build_filename (LW_PATH_VOCABULARY, filename);
+
+    //Cleanup
+    g_free (filename); filename = NULL;
+
+    return uri;
+}
+
+
 LwVocabularyList*
 lw_vocabularylist_new (const gchar *NAME)
 {
@@ -63,87 +118,529 @@ lw_vocabularylist_new (const gchar *NAME)
     if (list != NULL)
     {
       list->name = g_strdup (NAME);
+      list->items = g_queue_new ();
+      list->links = g_hash_table_new (g_direct_hash, g_direct_equal);
+      list->journal = g_string_new (NULL);
+      list->next_id = 1;
+      list->compact = TRUE;
     }
     return list;
 }
 
 
+static void
+_vocabularylist_clear (LwVocabularyList *list)
+{
+    g_queue_foreach (list->items, (GFunc) lw_vocabularyitem_free, NULL);
+    g_queue_clear (list->items);
+    g_hash_table_remove_all (list->links);
+    g_string_truncate (list->journal, 0);
+    list->next_id = 1;
+    list->pending_records = 0;
+    list->total_records = 0;
+}
+
+
 void
 lw_vocabularylist_free (LwVocabularyList *list)
 {
+    _vocabularylist_clear (list);
     if (list->name != NULL) g_free (list->name);
-    g_list_foreach (list->items, (GFunc) lw_vocabularyitem_free, NULL);
-    g_list_free (list->items); list->items = NULL;
+    g_queue_free (list->items); list->items = NULL;
+    g_hash_table_destroy (list->links); list->links = NULL;
+    g_string_free (list->journal, TRUE); list->journal = NULL;
+    g_free (list);
+}
+
+
+//!
+//! @brief Links an item into the list after another one, giving it an id if it has none
+//! @param list The LwVocabularyList to add to
+//! @param sibling The link to add after or NULL to add at the start
+//! @param item The LwVocabularyItem the list takes ownership of
+//!
+static void
+_vocabularylist_link_after (LwVocabularyList *list, GList *sibling, LwVocabularyItem *item)
+{
+    //Declarations
+    GList *link;
+
+    if (item->id == 0) item->id = list->next_id;
+    if (item->id >= list->next_id) list->next_id = item->id + 1;
+
+    if (sibling == NULL)
+    {
+      g_queue_push_head (list->items, item);
+      link = list->items->head;
+    }
+    else
+    {
+      g_queue_insert_after (list->items, sibling, item);
+      link = sibling->next;
+    }
+
+    g_hash_table_insert (list->links, GUINT_TO_POINTER (item->id), link);
+}
+
+
+static void
+_vocabularylist_unlink (LwVocabularyList *list, GList *link)
+{
+    //Declarations
+    LwVocabularyItem *item;
+
+    //Initializations
+    item = LW_VOCABULARYITEM (link->data);
+
+    g_hash_table_remove (list->links, GUINT_TO_POINTER (item->id));
+    g_queue_delete_link (list->items, link);
+    lw_vocabularyitem_free (item);
+}
+
+
+static GList*
+_vocabularylist_get_link (LwVocabularyList *list, guint id)
+{
+    return (GList*) g_hash_table_lookup (list->links, GUINT_TO_POINTER (id));
 }
 
 
+//!
+//! @brief Adds a record of an edit to the ones written on the next save
+//!
+static void
+_vocabularylist_record (LwVocabularyList *list, const gchar *FORMAT, ...)
+{
+    //Declarations
+    va_list args;
+
+    va_start (args, FORMAT);
+    g_string_append_vprintf (list->journal, FORMAT, args);
+    va_end (args);
+
+    g_string_append_c (list->journal, '\n');
+    list->pending_records++;
+    list->changed = TRUE;
+}
+
+
+//!
+//! @brief Adds an item to the list after another one
+//! @param list The LwVocabularyList to add to
+//! @param sibling An item of the list to add after or NULL to add at the start
+//! @param item The LwVocabularyItem to add.  The list takes ownership of it.
+//!
+void
+lw_vocabularylist_insert_after (LwVocabularyList *list, LwVocabularyItem *sibling, LwVocabularyItem *item)
+{
+    //Declarations
+    GList *link;
+    gchar *text;
+
+    //Initializations
+    link = (sibling != NULL) ? _vocabularylist_get_link (list, sibling->id) : NULL;
+    item->id = 0;
+
+    _vocabularylist_link_after (list, link, item);
+
+    text = lw_vocabularyitem_to_string (item);
+    g_strdelimit (text, "\r\n", ' ');
+    _vocabularylist_record (list, "+%u %u %s", item->id, (sibling != NULL) ? sibling->id : 0, text);
+
+    //Cleanup
+    g_free (text); text = NULL;
+}
+
+
+//!
+//! @brief Removes an item from the list and frees it
+//! @param list The LwVocabularyList to remove from
+//! @param item An item of the list
+//!
+void
+lw_vocabularylist_remove (LwVocabularyList *list, LwVocabularyItem *item)
+{
+    //Declarations
+    GList *link;
+    guint id;
+
+    //Initializations
+    id = item->id;
+
+    if ((link = _vocabularylist_get_link (list, id)) != NULL)
+    {
+      _vocabularylist_unlink (list, link);
+      _vocabularylist_record (list, "-%u", id);
+    }
+}
+
+
+//!
+//! @brief Changes one field of an item of the list
+//! @param list The LwVocabularyList the item belongs to
+//! @param item An item of the list
+//! @param field The field to change
+//! @param TEXT The new text of the field
+//!
+void
+lw_vocabularylist_set_field (LwVocabularyList *list, LwVocabularyItem *item, LwVocabularyItemField field, const gchar *TEXT)
+{
+    //Declarations
+    gchar *text;
+
+    //Initializations
+    text = g_strdup (TEXT);
+    g_strdelimit (text, "\r\n;", ' ');
+
+    lw_vocabularyitem_set_field (item, field, text);
+    _vocabularylist_record (list, "=%u %d %s", item->id, field, text);
+
+    //Cleanup
+    g_free (text); text = NULL;
+}
+
+
+static gboolean
+_vocabularylist_get_file_stamp (const gchar *URI, gint64 *size, gint64 *mtime)
+{
+    //Declarations
+    GStatBuf info;
+
+    if (g_stat (URI, &info) != 0) return FALSE;
+
+    *size = (gint64) info.st_size;
+    *mtime = (gint64) info.st_mtime;
+
+    return TRUE;
+}
+
+
+//!
+//! @brief Applies one journal record to the list
+//! @returns FALSE if the record could not be read
+//!
+static gboolean
+_vocabularylist_replay_record (LwVocabularyList *list, gchar *record)
+{
+    //Declarations
+    LwVocabularyItem *item;
+    GList *link;
+    gchar *ptr;
+    guint id, after;
+    gint field;
+
+    //Initializations
+    id = (guint) strtoul (record + 1, &ptr, 10);
+    if (id == 0) return FALSE;
+
+    switch (record[0])
+    {
+      case '+':
+        after = (guint) strtoul (ptr, &ptr, 10);
+        if (*ptr == ' ') ptr++;
+        if (_vocabularylist_get_link (list, id) != NULL) return FALSE;
+        if ((item = lw_vocabularyitem_new_from_string (ptr)) == NULL) return FALSE;
+        item->id = id;
+        link = (after != 0) ? _vocabularylist_get_link (list, after) : NULL;
+        if (after != 0 && link == NULL) link = list->items->tail;
+        _vocabularylist_link_after (list, link, item);
+        return TRUE;
+      case '-':
+        if ((link = _vocabularylist_get_link (list, id)) == NULL) return FALSE;
+        _vocabularylist_unlink (list, link);
+        return TRUE;
+      case '=':
+        field = (gint) strtol (ptr, &ptr, 10);
+        if (*ptr == ' ') ptr++;
+        if (field < 0 || field >= TOTAL_LW_VOCABULARYITEM_FIELDS) return FALSE;
+        if ((link = _vocabularylist_get_link (list, id)) == NULL) return FALSE;
+        lw_vocabularyitem_set_field (LW_VOCABULARYITEM (link->data), field, ptr);
+        return TRUE;
+      default:
+        return FALSE;
+    }
+}
+
+
+//!
+//! @brief Applies the journal that was written since the list file was last rewritten.
+//!        A journal made for another version of the list file is deleted, and a
+//!        last record cut short by a crash is dropped.
+//! @returns FALSE if the journal ends in a cut short record, so records appended
+//!          after it would be read as part of it
+//!
+static gboolean
+_vocabularylist_replay_journal (LwVocabularyList *list, const gchar *URI)
+{
+    //Declarations
+    gchar *journaluri;
+    gchar *contents;
+    gsize length;
+    gchar *line, *end;
+    gint64 size, mtime;
+    gint64 journal_size, journal_mtime;
+    gboolean valid;
+    gboolean complete;
+
+    //Initializations
+    journaluri = _vocabularylist_build_journal_filename (list);
+    contents = NULL;
+    valid = FALSE;
+    complete = TRUE;
+    if (journaluri == NULL) return TRUE;
+    if (!_vocabularylist_get_file_stamp (URI, &size, &mtime)) size = mtime = 0;
+
+    if (g_file_get_contents (journaluri, &contents, &length, NULL))
+    {
+      valid = (sscanf (contents, LW_VOCABULARYLIST_JOURNAL_HEADER " %" G_GINT64_FORMAT " %" G_GINT64_FORMAT, &journal_size, &journal_mtime) == 2 &&
+               journal_size == size && journal_mtime == mtime &&
+               (line = strchr (contents, '\n')) != NULL);
+
+      if (valid)
+      {
+        for (line++; (end = strchr (line, '\n')) != NULL; line = end + 1)
+        {
+          *end = '\0';
+          if (_vocabularylist_replay_record (list, line)) list->total_records++;
+        }
+        complete = (*line == '\0');
+      }
+      else
+      {
+        g_remove (journaluri);
+      }
+    }
+
+    //Cleanup
+    if (contents != NULL) g_free (contents); contents = NULL;
+    g_free (journaluri); journaluri = NULL;
+
+    return complete;
+}
+
+
+//!
+//! @brief Reads the list file and replays its journal.  The lines of the list
+//!        can be of any length.
+//! @param list The LwVocabularyList to load into
+//! @param cb Unused
+//!
 void
 lw_vocabularylist_load (LwVocabularyList *list, LwIoProgressCallback cb)
 {
+    //Declarations
     LwVocabularyItem *item;
     gchar *uri;
-    FILE *stream;
-    const gint MAX = 200;
-    gchar buffer[MAX + 1];
+    gchar *contents;
+    gsize length;
+    gchar *line, *end;
 
+    //Initializations
     uri = lw_util_build_filename (LW_PATH_VOCABULARY, list->name);
-    stream = fopen (uri, "r");
-    buffer[MAX] = '\0';
+    if (uri == NULL) return;
+
+    _vocabularylist_clear (list);
 
-    while (stream != NULL && feof(stream) == 0)
+    if (g_file_get_contents (uri, &contents, &length, NULL))
     {
-      if (fgets (buffer, MAX, stream) != NULL)
+      for (line = contents; line < contents + length; line = end + 1)
       {
-        item = lw_vocabularyitem_new_from_string (buffer);
-        if (item != NULL)
+        if ((end = strchr (line, '\n')) == NULL) end = contents + length;
+        *end = '\0';
+        if (*g_strstrip (line) == '\0') continue;
+
+        if ((item = lw_vocabularyitem_new_from_string (line)) != NULL)
         {
-          list->items = g_list_append (list->items, item);
+          _vocabularylist_link_after (list, list->items->tail, item);
         }
       }
+      g_free (contents); contents = NULL;
     }
+
+    //A cut short journal is replaced by rewriting the list on the next save
+    list->compact = !_vocabularylist_replay_journal (list, uri);
+    list->changed = FALSE;
+
+    //Cleanup
+    g_free (uri); uri = NULL;
 }
 
+
+//!
+//! @brief Rewrites the whole list file, renumbering the items in their new
+//!        order, and deletes the journal it replaces
+//! @returns FALSE if the list file could not be written.  The ids are only
+//!          renumbered once it was.
+//!
+static gboolean
+_vocabularylist_compact (LwVocabularyList *list, const gchar *URI, const gchar *JOURNALURI)
+{
+    //Declarations
+    LwVocabularyItem *item;
+    GString *contents;
+    GList *link;
+    gchar *text;
+    guint id;
+    GError *error;
+    gboolean written;
+
+    //Initializations
+    contents = g_string_sized_new (1024);
+    error = NULL;
+
+    //The line of an item is its id so every item has to be written.  A blank
+    //line would be skipped on load and shift the ids the journal refers to.
+    for (link = list->items->head; link != NULL; link = link->next)
+    {
+      item = LW_VOCABULARYITEM (link->data);
+      if ((text = lw_vocabularyitem_to_string (item)) == NULL) break;
+      g_string_append (contents, text);
+      g_string_append_c (contents, '\n');
+      g_free (text); text = NULL;
+    }
+
+    //Leave the old list and its journal alone if an item couldn't be written
+    if (link != NULL)
+    {
+      g_string_free (contents, TRUE); contents = NULL;
+      return FALSE;
+    }
+
+    written = g_file_set_contents (URI, contents->str, contents->len, &error);
+
+    if (written)
+    {
+      g_remove (JOURNALURI);
+      g_hash_table_remove_all (list->links);
+      id = 1;
+      for (link = list->items->head; link != NULL; link = link->next)
+      {
+        item = LW_VOCABULARYITEM (link->data);
+        item->id = id++;
+        g_hash_table_insert (list->links, GUINT_TO_POINTER (item->id), link);
+      }
+      list->next_id = id;
+      list->total_records = 0;
+      list->compact = FALSE;
+    }
+    else
+    {
+      fprintf (stderr, "%s\n", error->message);
+      g_error_free (error); error = NULL;
+    }
+
+    //Cleanup
+    g_string_free (contents, TRUE); contents = NULL;
+
+    return written;
+}
+
+
+//!
+//! @brief Appends the records of the edits since the last save to the journal
+//! @returns FALSE if the records could not all be written
+//!
+static gboolean
+_vocabularylist_append_journal (LwVocabularyList *list, const gchar *URI, const gchar *JOURNALURI)
+{
+    //Declarations
+    FILE *stream;
+    gboolean exists;
+    gboolean written;
+    gint64 size, mtime;
+
+    //Initializations
+    exists = g_file_test (JOURNALURI, G_FILE_TEST_IS_REGULAR);
+    written = FALSE;
+    if (!_vocabularylist_get_file_stamp (URI, &size, &mtime)) return FALSE;
+
+    if ((stream = g_fopen (JOURNALURI, "ab")) != NULL)
+    {
+      written = TRUE;
+      if (!exists)
+      {
+        written = (fprintf (stream, LW_VOCABULARYLIST_JOURNAL_HEADER " %" G_GINT64_FORMAT " %" G_GINT64_FORMAT "\n", size, mtime) > 0);
+      }
+      if (written)
+      {
+        written = (fwrite (list->journal->str, sizeof(gchar), list->journal->len, stream) == list->journal->len);
+      }
+      if (fclose (stream) != 0) written = FALSE;
+      stream = NULL;
+
+      if (written) list->total_records += list->pending_records;
+    }
+
+    return written;
+}
+
+
+//!
+//! @brief Saves the edits made since the last save.  Small edits are appended to
+//!        the journal of the list, and the list file is only rewritten when the
+//!        journal has grown past the length of the list or the list was renamed.
+//! @param list The LwVocabularyList to save
+//! @param cb Unused
+//!
 void
 lw_vocabularylist_save (LwVocabularyList *list, LwIoProgressCallback cb)
 {
     //Declarations
-    LwVocabularyItem *item;
-    GList *iter;
-    gint i;
     gchar *uri;
-    FILE *stream;
+    gchar *journaluri;
+    gint limit;
+    gboolean saved;
 
+    //Initializations
     uri = lw_util_build_filename (LW_PATH_VOCABULARY, list->name);
-    stream = fopen (uri, "w");
+    journaluri = _vocabularylist_build_journal_filename (list);
+    limit = MAX (LW_VOCABULARYLIST_MIN_COMPACTION_RECORDS, g_queue_get_length (list->items));
 
-    for (iter = list->items; iter != NULL; iter = iter->next)
+    if (uri != NULL && journaluri != NULL)
     {
-      item = LW_VOCABULARYITEM (iter->data);
-      if (item != NULL)
+      if (list->compact || 
+          list->total_records + list->pending_records > limit ||
+          !g_file_test (uri, G_FILE_TEST_IS_REGULAR))
       {
-        for (i = 0; i < TOTAL_LW_VOCABULARYITEM_FIELDS - 1 && feof (stream) == 0; i++)
-        {
-          if (item->fields[i] != NULL)
-          {
-            fputs(item->fields[i], stream);
-            fputc(';', stream);
-          }
-        }
-        if (item->fields[i] != NULL) fputs(item->fields[i], stream);
-        fputc('\n', stream);
+        saved = _vocabularylist_compact (list, uri, journaluri);
+      }
+      else if (list->pending_records > 0)
+      {
+        saved = _vocabularylist_append_journal (list, uri, journaluri);
+
+        //Part of a record may have made it to the journal, so stop appending to it
+        if (!saved) list->compact = TRUE;
+      }
+      else
+      {
+        saved = TRUE;
+      }
+
+      //Failed edits stay pending and the list stays changed for the next save
+      if (saved)
+      {
+        g_string_truncate (list->journal, 0);
+        list->pending_records = 0;
+        list->changed = FALSE;
       }
     }
 
-    fclose(stream);
-    g_free (uri);
+    //Cleanup
+    if (uri != NULL) g_free (uri); uri = NULL;
+    if (journaluri != NULL) g_free (journaluri); journaluri = NULL;
 }
 
+
+//!
+//! @brief Renames the list.  The list file is rewritten under the new name on the next save.
+//!
 void
 lw_vocabularylist_set_name (LwVocabularyList *list, const gchar *name)
 {
     if (list->name != NULL)
       g_free (list->name);
     list->name = g_strdup (name);
+    list->compact = TRUE;
 }
 
 const gchar*
@@ -155,7 +652,13 @@ lw_vocabularylist_get_name (LwVocabularyList *list)
 GList *
 lw_vocabularylist_get_items (LwVocabularyList *list)
 {
-    return list->items;
+    return list->items->head;
+}
+
+gint
+lw_vocabularylist_get_length (LwVocabularyList *list)
+{
+    return g_queue_get_length (list->items);
 }
 
 void
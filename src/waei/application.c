@@ -98,6 +98,9 @@ w_application_finalize (GObject *object)
     if (priv->dictinfolist != NULL) lw_dictinfolist_free (priv->dictinfolist); priv->dictinfolist = NULL;
     if (priv->context != NULL) g_option_context_free (priv->context); priv->context = NULL;
     if (priv->arg_query_text_data != NULL) g_free(priv->arg_query_text_data); priv->arg_query_text_data = NULL;
+    if (priv->arg_batch_switch_data != NULL) g_free(priv->arg_batch_switch_data); priv->arg_batch_switch_data = NULL;
+    if (priv->arg_serve_switch_data != NULL) g_free(priv->arg_serve_switch_data); priv->arg_serve_switch_data = NULL;
+    if (priv->arg_connect_switch_data != NULL) g_free(priv->arg_connect_switch_data); priv->arg_connect_switch_data = NULL;
     if (priv->preferences != NULL) lw_preferences_free (priv->preferences); priv->preferences = NULL;
 
     lw_regex_free ();
@@ -136,7 +139,13 @@ w_application_parse_args (WApplication *application, int *argc, char** argv[])
     //Reset the switches to their default state
     if (priv->arg_dictionary_switch_data != NULL) g_free (priv->arg_dictionary_switch_data); priv->arg_dictionary_switch_data = NULL;
     if (priv->arg_query_text_data != NULL) g_free (priv->arg_query_text_data); priv->arg_query_text_data = NULL;
+    if (priv->arg_batch_switch_data != NULL) g_free (priv->arg_batch_switch_data); priv->arg_batch_switch_data = NULL;
+    if (priv->arg_serve_switch_data != NULL) g_free (priv->arg_serve_switch_data); priv->arg_serve_switch_data = NULL;
+    if (priv->arg_connect_switch_data != NULL) g_free (priv->arg_connect_switch_data); priv->arg_connect_switch_data = NULL;
+    priv->arg_jobs_switch_data = 0;
+    priv->arg_limit_switch_data = 0;
     priv->arg_version_switch = FALSE;
+    priv->arg_analyze_switch = FALSE;
     error = NULL;
     if (priv->context != NULL) g_option_context_free (priv->context); priv->context = NULL;
 
@@ -162,10 +171,17 @@ w_application_parse_args (WApplication *application, int *argc, char** argv[])
       { "exact", 'e', 0, G_OPTION_ARG_NONE, &(priv->arg_exact_switch), gettext("Do not display less relevant results"), NULL },
       { "quiet", 'q', 0, G_OPTION_ARG_NONE, &(priv->arg_quiet_switch), gettext("Display less information"), NULL },
       { "color", 'c', 0, G_OPTION_ARG_NONE, &(priv->arg_color_switch), gettext("Display results with color"), NULL },
+      { "stats", 0, 0, G_OPTION_ARG_NONE, &(priv->arg_stats_switch), gettext("Print search statistics after the results"), NULL },
       { "dictionary", 'd', 0, G_OPTION_ARG_STRING, &(priv->arg_dictionary_switch_data), gettext("Search using a chosen dictionary"), NULL },
       { "list", 'l', 0, G_OPTION_ARG_NONE, &(priv->arg_list_switch), gettext("Show available dictionaries for searches"), NULL },
       { "install", 'i', 0, G_OPTION_ARG_STRING, &(priv->arg_install_switch_data), gettext("Install dictionary"), NULL },
       { "uninstall", 'u', 0, G_OPTION_ARG_STRING, &(priv->arg_uninstall_switch_data), gettext("Uninstall dictionary"), NULL },
+      { "batch", 'b', 0, G_OPTION_ARG_FILENAME, &(priv->arg_batch_switch_data), gettext("Search each line of a file (- for stdin) and print JSON"), NULL },
+      { "jobs", 'j', 0, G_OPTION_ARG_INT, &(priv->arg_jobs_switch_data), gettext("Number of searches to run at once in batch mode"), NULL },
+      { "serve", 0, 0, G_OPTION_ARG_FILENAME, &(priv->arg_serve_switch_data), gettext("Answer searches from a unix socket until interrupted"), "SOCKET" },
+      { "connect", 0, 0, G_OPTION_ARG_FILENAME, &(priv->arg_connect_switch_data), gettext("Send the search to a waei server on a unix socket"), "SOCKET" },
+      { "analyze", 0, 0, G_OPTION_ARG_NONE, &(priv->arg_analyze_switch), gettext("Show the words of the text (or of each line of stdin) with their entries"), NULL },
+      { "limit", 0, 0, G_OPTION_ARG_INT, &(priv->arg_limit_switch_data), gettext("Stop after this many results when using a server"), NULL },
       { "version", 'v', 0, G_OPTION_ARG_NONE, &(priv->arg_version_switch), gettext("Check the waei version information"), NULL },
       { NULL }
     };
@@ -254,6 +270,34 @@ w_application_get_preferences (WApplication *application)
 }
 
 
+//The preferences object caches its GSettings in a plain list so query parsing is serialized
+G_LOCK_DEFINE (w_application_parse_query);
+
+//!
+//! @brief Creates a LwSearchItem using the application preferences.  It is safe
+//!        to call from the worker threads of the batch and server modes.
+//! @param application The WApplication holding the preferences
+//! @param QUERY The text to search for
+//! @param di The LwDictInfo to search in
+//! @param error A pointer to a GError to write errors to or NULL
+//! @returns A new LwSearchItem or NULL if the query is not usable
+//!
+LwSearchItem* 
+w_application_new_searchitem (WApplication *application, const char *QUERY, LwDictInfo *di, GError **error)
+{
+    //Declarations
+    LwPreferences *preferences;
+    LwSearchItem *item;
+
+    G_LOCK (w_application_parse_query);
+    preferences = w_application_get_preferences (application);
+    item = lw_searchitem_new (QUERY, di, preferences, error);
+    G_UNLOCK (w_application_parse_query);
+
+    return item;
+}
+
+
 LwDictInfoList* 
 w_application_get_dictinfolist (WApplication *application)
 {
@@ -326,6 +370,22 @@ w_application_run (WApplication *application, int *argc, char **argv[])
     else if (priv->arg_uninstall_switch_data != NULL)
       resolution = w_console_uninstall_dictinfo (application, &error);
 
+    //User wants to run a search server
+    else if (priv->arg_serve_switch_data != NULL)
+      resolution = w_server_run (application, &error);
+
+    //User wants a running server to do the search
+    else if (priv->arg_connect_switch_data != NULL)
+      resolution = w_server_connect (application, &error);
+
+    //User wants the words of a text explained
+    else if (priv->arg_analyze_switch)
+      resolution = w_console_analyze (application, &error);
+
+    //User wants to search a list of queries
+    else if (priv->arg_batch_switch_data != NULL)
+      resolution = w_console_batch_search (application, &error);
+
     //User wants to do a search
     else if (priv->arg_query_text_data != NULL)
       resolution = w_console_search (application, &error);
@@ -386,6 +446,24 @@ w_application_get_color_switch (WApplication *application)
 }
 
 
+gboolean
+w_application_get_stats_switch (WApplication *application)
+{
+  WApplicationPrivate *priv;
+  priv = application->priv;
+  return priv->arg_stats_switch;
+}
+
+
+gboolean
+w_application_get_analyze_switch (WApplication *application)
+{
+  WApplicationPrivate *priv;
+  priv = application->priv;
+  return priv->arg_analyze_switch;
+}
+
+
 const gchar*
 w_application_get_dictionary_switch_data (WApplication *application)
 {
@@ -413,6 +491,51 @@ w_application_get_uninstall_switch_data (WApplication *application)
 }
 
 
+const gchar*
+w_application_get_batch_switch_data (WApplication *application)
+{
+  WApplicationPrivate *priv;
+  priv = application->priv;
+  return priv->arg_batch_switch_data;
+}
+
+
+gint
+w_application_get_jobs_switch_data (WApplication *application)
+{
+  WApplicationPrivate *priv;
+  priv = application->priv;
+  return priv->arg_jobs_switch_data;
+}
+
+
+const gchar*
+w_application_get_serve_switch_data (WApplication *application)
+{
+  WApplicationPrivate *priv;
+  priv = application->priv;
+  return priv->arg_serve_switch_data;
+}
+
+
+const gchar*
+w_application_get_connect_switch_data (WApplication *application)
+{
+  WApplicationPrivate *priv;
+  priv = application->priv;
+  return priv->arg_connect_switch_data;
+}
+
+
+gint
+w_application_get_limit_switch_data (WApplication *application)
+{
+  WApplicationPrivate *priv;
+  priv = application->priv;
+  return priv->arg_limit_switch_data;
+}
+
+
 const gchar*
 w_application_get_query_text_data (WApplication *application)
 {
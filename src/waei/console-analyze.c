@@ -0,0 +1,140 @@
+/******************************************************************************
+    AUTHOR:
+    File written and Copyrighted by Zachary Dovel. All Rights Reserved.
+
+    LICENSE:
+    This file is part of gWaei.
+
+    gWaei is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    gWaei is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with gWaei.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+//!
+//! @file console-analyze.c
+//!
+//! @brief Prints the words of a Japanese text for the --analyze switch
+//!
+//! The text is split into dictionary words by a LwTextAnalyzer and each word
+//! is printed in text order followed by its entries, so a text can be read
+//! through without looking every word up on its own.
+//!
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <glib.h>
+
+#include <waei/waei.h>
+
+
+//!
+//! @brief Prints the segments of one analyzed text
+//!
+static void
+_analyze_print_text (WApplication *application, LwTextAnalyzer *analyzer, LwResultLine *resultline, const gchar *TEXT)
+{
+    //Declarations
+    GList *segments;
+    GList *link;
+    LwTextSegment *segment;
+    gboolean color_switch;
+    gint total;
+    gint i;
+
+    //Initializations
+    segments = lw_textanalyzer_analyze (analyzer, TEXT);
+    color_switch = w_application_get_color_switch (application);
+    total = (w_application_get_quiet_switch (application)) ? 1 : LW_TEXTANALYZER_MAX_ENTRIES;
+
+    for (link = segments; link != NULL; link = link->next)
+    {
+      segment = link->data;
+
+      if (color_switch)
+        printf("[1m%s[0m\n", segment->text);
+      else
+        printf("%s\n", segment->text);
+
+      for (i = 0; i < segment->total_entries && i < total; i++)
+      {
+        if (lw_textanalyzer_read_entry (analyzer, segment->entries[i], resultline))
+          w_console_print_edict_resultline (application, resultline);
+      }
+      if (segment->total_entries == 0) printf("\n");
+    }
+
+    //Cleanup
+    g_list_foreach (segments, (GFunc) lw_textsegment_free, NULL);
+    g_list_free (segments);
+}
+
+
+//!
+//! @brief Splits the query text, or each line of stdin if there is none, into
+//!        dictionary words and prints them with their entries in text order.
+//! @param application The WApplication holding the switch data
+//! @param error A pointer to a GError to write errors to or NULL
+//!
+int
+w_console_analyze (WApplication *application, GError **error)
+{
+    //Sanity check
+    if (error != NULL && *error != NULL) return 1;
+
+    //Declarations
+    LwDictInfoList *dictinfolist;
+    LwDictInfo *di;
+    LwTextAnalyzer *analyzer;
+    LwResultLine *resultline;
+    const gchar *query_text_data;
+    char buffer[LW_IO_MAX_FGETS_LINE];
+    char *text;
+
+    //Initializations
+    dictinfolist = w_application_get_dictinfolist (application);
+    query_text_data = w_application_get_query_text_data (application);
+    di = lw_dictinfolist_get_dictinfo_fuzzy (dictinfolist, w_application_get_dictionary_switch_data (application));
+
+    if (di == NULL)
+    {
+      fprintf (stderr, gettext("Requested dictionary not found!\n"));
+      return 1;
+    }
+
+    analyzer = lw_textanalyzer_new (di, error);
+    if (analyzer == NULL) return 1;
+    resultline = lw_resultline_new ();
+
+    if (query_text_data != NULL)
+    {
+      _analyze_print_text (application, analyzer, resultline, query_text_data);
+    }
+    else
+    {
+      while (fgets (buffer, LW_IO_MAX_FGETS_LINE, stdin) != NULL)
+      {
+        text = g_strchomp (buffer);
+        if (*text == '\0') continue;
+        _analyze_print_text (application, analyzer, resultline, text);
+      }
+    }
+
+    //Cleanup
+    lw_resultline_free (resultline);
+    lw_textanalyzer_free (analyzer);
+
+    return 0;
+}
+
@@ -0,0 +1,345 @@
+/******************************************************************************
+    AUTHOR:
+    File written and Copyrighted by Zachary Dovel. All Rights Reserved.
+
+    LICENSE:
+    This file is part of gWaei.
+
+    gWaei is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    gWaei is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    
+    You should have received a copy of the GNU General Public License
+    along with gWaei.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+//!
+//! @file console-batch.c
+//!
+//! @brief Runs many queries in one process for the --batch switch
+//!
+//! The queries are read one per line and searched on a thread pool that shares
+//! the already loaded dictionary list and preferences.  Each query gets one line
+//! of JSON on stdout, written in the same order as the input.  Word lists repeat
+//! queries, so the parsed queries are kept and shared by the searches of the
+//! same text.
+//!
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <glib.h>
+
+#include <waei/waei.h>
+
+
+//!
+//! @brief One line of the batch input
+//!
+struct _WBatchJob {
+  gint index;
+  gchar *query;
+  GString *output;       //!< The finished JSON line or NULL while it is being searched
+};
+typedef struct _WBatchJob WBatchJob;
+
+//!
+//! @brief A parsed query of the cache
+//!
+struct _WBatchQuery {
+  gchar *text;
+  LwQueryLine *queryline;
+  gint users;            //!< Searches running with the queryline
+  GList *unused_link;    //!< Its link in the unused queue while no search uses it
+};
+typedef struct _WBatchQuery WBatchQuery;
+
+//!
+//! @brief State shared between the reader and the search workers
+//!
+struct _WBatch {
+  WApplication *application;
+  LwDictInfo *di;
+  gboolean exact;
+  GMutex *mutex;
+  GCond *cond;
+  GHashTable *queries;   //!< Query text to its WBatchQuery.  Guarded by the query parsing lock.
+  GQueue unused;         //!< Queries no search uses, least recently used first
+};
+typedef struct _WBatch WBatch;
+
+
+static void
+_batch_query_free (WBatchQuery *query)
+{
+    lw_queryline_free (query->queryline);
+    g_free (query->text);
+    g_free (query);
+}
+
+
+//!
+//! @brief Creates the search item of a query, parsing the query only when the
+//!        cache doesn't have it yet
+//! @returns A LwSearchItem to give back with _batch_free_searchitem or NULL if the query is not usable
+//!
+static LwSearchItem* 
+_batch_new_searchitem (WBatch *batch, const gchar *QUERY, GError **error)
+{
+    //Declarations
+    LwPreferences *preferences;
+    LwSearchItem *item;
+    WBatchQuery *query;
+
+    G_LOCK (w_application_parse_query);
+
+    query = g_hash_table_lookup (batch->queries, QUERY);
+    if (query != NULL)
+    {
+      if (query->unused_link != NULL)
+      {
+        g_queue_delete_link (&batch->unused, query->unused_link);
+        query->unused_link = NULL;
+      }
+      item = lw_searchitem_new_with_queryline (query->queryline, batch->di);
+    }
+    else
+    {
+      preferences = w_application_get_preferences (batch->application);
+      item = lw_searchitem_new (QUERY, batch->di, preferences, error);
+      if (item != NULL)
+      {
+        //The cache takes over the queryline of the first item
+        query = g_new0 (WBatchQuery, 1);
+        query->text = g_strdup (QUERY);
+        query->queryline = item->queryline;
+        item->shares_queryline = TRUE;
+        g_hash_table_insert (batch->queries, query->text, query);
+      }
+    }
+    if (item != NULL) query->users++;
+
+    G_UNLOCK (w_application_parse_query);
+
+    return item;
+}
+
+
+//!
+//! @brief Frees a search item of _batch_new_searchitem.  The least recently used
+//!        queries are dropped once too many aren't used by any search.
+//!
+static void 
+_batch_free_searchitem (WBatch *batch, const gchar *QUERY, LwSearchItem *item)
+{
+    //Declarations
+    WBatchQuery *query;
+
+    G_LOCK (w_application_parse_query);
+
+    query = g_hash_table_lookup (batch->queries, QUERY);
+    lw_searchitem_free (item);
+
+    if (--query->users == 0)
+    {
+      g_queue_push_tail (&batch->unused, query);
+      query->unused_link = g_queue_peek_tail_link (&batch->unused);
+    }
+
+    while (g_queue_get_length (&batch->unused) > W_CONSOLE_BATCH_QUERY_CACHE)
+    {
+      query = g_queue_pop_head (&batch->unused);
+      g_hash_table_remove (batch->queries, query->text);
+      _batch_query_free (query);
+    }
+
+    G_UNLOCK (w_application_parse_query);
+}
+
+
+static void 
+_batch_search_func (gpointer data, gpointer user_data)
+{
+    //Declarations
+    WBatchJob *job;
+    WBatch *batch;
+    LwSearchItem *item;
+    LwResultLine *resultline;
+    GString *output;
+    GError *error;
+    int total;
+
+    //Initializations
+    job = data;
+    batch = user_data;
+    error = NULL;
+    total = 0;
+    output = g_string_new ("{");
+
+    g_string_append_printf (output, "\"index\":%d,\"query\":", job->index);
+    w_json_append_string (output, job->query);
+    g_string_append (output, ",\"dictionary\":");
+    w_json_append_string (output, batch->di->filename);
+
+    item = _batch_new_searchitem (batch, job->query, &error);
+
+    if (item != NULL)
+    {
+      //Search in this worker thread so the pool size caps the concurrency
+      lw_searchitem_start_search (item, FALSE, batch->exact);
+
+      g_string_append (output, ",\"results\":[");
+      while ((resultline = lw_searchitem_get_result (item)) != NULL)
+      {
+        if (total > 0) g_string_append_c (output, ',');
+        w_json_append_resultline (output, batch->di->type, resultline);
+        lw_resultline_free (resultline);
+        total++;
+      }
+      g_string_append_printf (output, "],\"total\":%d,\"relevant\":%d", total, item->total_relevant_results);
+      _batch_free_searchitem (batch, job->query, item);
+    }
+    else
+    {
+      g_string_append (output, ",\"error\":");
+      w_json_append_string (output, (error != NULL) ? error->message : "Invalid query");
+    }
+    g_string_append (output, "}\n");
+
+    if (error != NULL) g_error_free (error);
+
+    g_mutex_lock (batch->mutex);
+    job->output = output;
+    g_cond_broadcast (batch->cond);
+    g_mutex_unlock (batch->mutex);
+}
+
+
+//!
+//! @brief Waits for the oldest job to finish, prints it and frees it
+//!
+static void 
+_batch_write_next (WBatch *batch, GQueue *pending)
+{
+    //Declarations
+    WBatchJob *job;
+
+    //Initializations
+    job = g_queue_pop_head (pending);
+    if (job == NULL) return;
+
+    g_mutex_lock (batch->mutex);
+    while (job->output == NULL)
+      g_cond_wait (batch->cond, batch->mutex);
+    g_mutex_unlock (batch->mutex);
+
+    fputs (job->output->str, stdout);
+    fflush (stdout);
+
+    g_string_free (job->output, TRUE);
+    g_free (job->query);
+    g_free (job);
+}
+
+
+//!
+//! @brief Searches every query of the batch file and writes the results as line
+//!        delimited JSON in input order.
+//! @param application The WApplication holding the switch data
+//! @param error A pointer to a GError to write errors to or NULL
+//!
+int 
+w_console_batch_search (WApplication *application, GError **error)
+{
+    //Sanity check
+    if (error != NULL && *error != NULL) return 1;
+
+    //Declarations
+    WBatch batch;
+    WBatchJob *job;
+    GThreadPool *pool;
+    GQueue pending;
+    LwDictInfoList *dictinfolist;
+    const gchar *path;
+    FILE *file;
+    char buffer[LW_IO_MAX_FGETS_LINE];
+    char *query;
+    gint jobs;
+    gint index;
+    guint window;
+
+    //Initializations
+    dictinfolist = w_application_get_dictinfolist (application);
+    path = w_application_get_batch_switch_data (application);
+    jobs = w_application_get_jobs_switch_data (application);
+    if (jobs < 1) jobs = W_CONSOLE_BATCH_DEFAULT_JOBS;
+    window = jobs * W_CONSOLE_BATCH_WINDOW_PER_JOB;
+    batch.di = lw_dictinfolist_get_dictinfo_fuzzy (dictinfolist, w_application_get_dictionary_switch_data (application));
+    batch.application = application;
+    batch.exact = w_application_get_exact_switch (application);
+    batch.queries = g_hash_table_new (g_str_hash, g_str_equal);
+    g_queue_init (&batch.unused);
+    g_queue_init (&pending);
+    index = 0;
+
+    if (batch.di == NULL)
+    {
+      fprintf (stderr, gettext("Requested dictionary not found!\n"));
+      g_hash_table_destroy (batch.queries);
+      return 1;
+    }
+
+    if (strcmp (path, "-") == 0)
+      file = stdin;
+    else
+      file = fopen (path, "r");
+
+    if (file == NULL)
+    {
+      fprintf (stderr, gettext("Unable to read the file %s.\n"), path);
+      g_hash_table_destroy (batch.queries);
+      return 1;
+    }
+
+    batch.mutex = g_mutex_new ();
+    batch.cond = g_cond_new ();
+    pool = g_thread_pool_new (_batch_search_func, &batch, jobs, TRUE, error);
+
+    //Keep a bounded window of queries in flight so output streams as it is read
+    while (pool != NULL && fgets (buffer, LW_IO_MAX_FGETS_LINE, file) != NULL)
+    {
+      query = g_strchomp (buffer);
+      if (*query == '\0') continue;
+
+      job = g_new0 (WBatchJob, 1);
+      job->index = index++;
+      job->query = g_strdup (query);
+      g_queue_push_tail (&pending, job);
+      g_thread_pool_push (pool, job, NULL);
+
+      if (g_queue_get_length (&pending) >= window)
+        _batch_write_next (&batch, &pending);
+    }
+
+    while (!g_queue_is_empty (&pending))
+      _batch_write_next (&batch, &pending);
+
+    //Cleanup
+    if (pool != NULL) g_thread_pool_free (pool, FALSE, TRUE);
+    if (file != stdin) fclose (file);
+    g_cond_free (batch.cond);
+    g_mutex_free (batch.mutex);
+    g_queue_foreach (&batch.unused, (GFunc) _batch_query_free, NULL);
+    g_queue_clear (&batch.unused);
+    g_hash_table_destroy (batch.queries);
+
+    return (pool == NULL);
+}
@@ -91,35 +91,32 @@ w_console_install_progress_cb (double fraction, gpointer data)
 }
 
 
+//!
+//! @brief Prints the results a search has ready.  The engine wakes this watch
+//!        up when results arrive and it prints for at most
+//!        W_CONSOLE_RESULT_BUDGET milliseconds before letting the loop run.
+//! @param item The LwSearchItem being watched
+//! @param data Unused
+//! @returns FALSE once the search is finished and all of its results are printed
+//!
 gboolean 
-w_console_append_result_timeout (gpointer data)
+w_console_append_result_watch (LwSearchItem *item, gpointer data)
 {
-  LwSearchItem *item;
   WSearchData *sdata;
-  int chunk;
-  int max_chunk;
-  gboolean is_still_searching;
+  gint64 deadline;
 
-  item = LW_SEARCHITEM (data);
   sdata = W_SEARCHDATA (lw_searchitem_get_data (item));
-  chunk = 0;
-  max_chunk = 50;
+  deadline = g_get_monotonic_time () + W_CONSOLE_RESULT_BUDGET * 1000;
 
-  if (item != NULL && lw_searchitem_should_check_results (item))
-  {
-    while (item != NULL && lw_searchitem_should_check_results (item) && chunk < max_chunk)
-    {
-      w_console_append_result (sdata->application, item);
-      chunk++;
-    }
-    is_still_searching = TRUE;
-  }
-  else
+  while (lw_searchitem_has_result (item) && g_get_monotonic_time () < deadline)
   {
-      w_console_no_result (sdata->application, item);
-      g_main_loop_quit (sdata->loop);
-      is_still_searching = FALSE;
+    w_console_append_result (sdata->application, item);
   }
 
-  return is_still_searching;
+  if (lw_searchitem_should_check_results (item)) return TRUE;
+
+  w_console_no_result (sdata->application, item);
+  g_main_loop_quit (sdata->loop);
+
+  return FALSE;
 }
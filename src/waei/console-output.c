@@ -45,6 +45,7 @@ static void w_console_append_kanjidict_result (WApplication*, LwSearchItem*);
 static void w_console_append_examplesdict_result (WApplication*, LwSearchItem*);
 static void w_console_append_unknowndict_result (WApplication*, LwSearchItem*);
 static void w_console_append_less_relevant_header (WApplication*, LwSearchItem*);
+static void w_console_print_field (LwResultLine*, LwResultLineField, gint, gboolean, const char*);
 
 
 void 
@@ -74,6 +75,59 @@ w_console_append_result (WApplication *application, LwSearchItem *item)
 }
 
 
+//!
+//! @brief Prints a field of a result with the spans the search engine matched highlighted
+//!
+//! The highlights are only added when colors are switched on.  RESUME is the escape
+//! sequence that brings back the color the rest of the field is printed in.
+//!
+static void 
+w_console_print_field (LwResultLine *resultline, LwResultLineField FIELD, gint index, gboolean color_switch, const char *RESUME)
+{
+    //Declarations
+    const char *text;
+    LwResultLineMatch *match;
+    gsize length;
+    guint8 *highlight;
+    gsize start, end;
+    int i;
+
+    //Initializations
+    text = lw_resultline_get_field (resultline, FIELD, index);
+    if (text == NULL) return;
+    if (!color_switch || resultline->match_total == 0)
+    {
+      printf("%s", text);
+      return;
+    }
+    length = strlen (text);
+    highlight = g_new0 (guint8, length + 1);
+
+    for (i = 0; i < resultline->match_total; i++)
+    {
+      match = &resultline->matches[i];
+      if (match->field != FIELD || match->index != index || match->end > length) continue;
+      memset (highlight + match->start, 1, match->end - match->start);
+    }
+
+    //Print the runs of highlighted and plain text
+    start = 0;
+    while (start < length)
+    {
+      end = start;
+      while (end < length && highlight[end] == highlight[start]) end++;
+      if (highlight[start])
+        printf("[1;31m%.*s%s", (int) (end - start), text + start, RESUME);
+      else
+        printf("%.*s", (int) (end - start), text + start);
+      start = end;
+    }
+
+    //Cleanup
+    g_free (highlight);
+}
+
+
 //!
 //! @brief Not yet written
 //!
@@ -82,28 +136,49 @@ w_console_append_edict_result (WApplication *application, LwSearchItem *item)
 {
     //Definitions
     LwResultLine *resultline;
-    gboolean color_switch;
-    gint cont;
 
     //Initializations
     resultline = lw_searchitem_get_result (item);
     if (resultline == NULL) return;
-    color_switch = w_application_get_color_switch (application);
-    cont = 0;
 
     w_console_append_less_relevant_header (application, item);
+    w_console_print_edict_resultline (application, resultline);
+
+    //Cleanup
+    lw_resultline_free (resultline);
+}
+
+
+//!
+//! @brief Prints an edict result line with its numbered definitions
+//! @param application The WApplication holding the color switch
+//! @param resultline A parsed edict LwResultLine
+//!
+void 
+w_console_print_edict_resultline (WApplication *application, LwResultLine *resultline)
+{
+    //Definitions
+    gboolean color_switch;
+    gint cont;
+
+    //Initializations
+    color_switch = w_application_get_color_switch (application);
+    cont = 0;
 
     //Kanji
     if (resultline->kanji_start)
     {
       if (color_switch)
-        printf("[32m%s", resultline->kanji_start);
-      else
-        printf("%s", resultline->kanji_start);
+        printf("[32m");
+      w_console_print_field (resultline, LW_RESULTLINE_FIELD_KANJI, 0, color_switch, "[0;32m");
     }
     //Furigana
     if (resultline->furigana_start)
-      printf(" [%s]", resultline->furigana_start);
+    {
+      printf(" [");
+      w_console_print_field (resultline, LW_RESULTLINE_FIELD_FURIGANA, 0, color_switch, "[0;32m");
+      printf("]");
+    }
     //Other info
     if (resultline->classification_start)
     {
@@ -125,15 +200,14 @@ w_console_append_edict_result (WApplication *application, LwSearchItem *item)
     while (cont < resultline->def_total)
     {
       if (color_switch)
-        printf("[0m      [35m%s [0m%s\n", resultline->number[cont], resultline->def_start[cont]);
+        printf("[0m      [35m%s [0m", resultline->number[cont]);
       else
-        printf("      %s %s\n", resultline->number[cont], resultline->def_start[cont]);
+        printf("      %s ", resultline->number[cont]);
+      w_console_print_field (resultline, LW_RESULTLINE_FIELD_DEFINITION, cont, color_switch, "[0m");
+      printf("\n");
       cont++;
     }
     printf("\n");
-
-    //Cleanup
-    lw_resultline_free (resultline);
 }
 
 
@@ -160,12 +234,18 @@ w_console_append_kanjidict_result (WApplication *application, LwSearchItem *item
 
     //Kanji
     if (color_switch)
-      printf("[32;1m%s[0m\n", resultline->kanji);
-    else
-      printf("%s\n", resultline->kanji);
+      printf("[32;1m");
+    w_console_print_field (resultline, LW_RESULTLINE_FIELD_CHARACTER, 0, color_switch, "[0;32;1m");
+    if (color_switch)
+      printf("[0m");
+    printf("\n");
 
     if (resultline->radicals)
-      printf("%s%s\n", gettext("Radicals:"), resultline->radicals);
+    {
+      printf("%s", gettext("Radicals:"));
+      w_console_print_field (resultline, LW_RESULTLINE_FIELD_RADICALS, 0, color_switch, "[0m");
+      printf("\n");
+    }
 
     if (resultline->strokes)
     {
@@ -201,14 +281,30 @@ w_console_append_kanjidict_result (WApplication *application, LwSearchItem *item
       printf("\n");
 
     if (resultline->readings[0])
-      printf("%s%s\n", gettext("Readings:"), resultline->readings[0]);
+    {
+      printf("%s", gettext("Readings:"));
+      w_console_print_field (resultline, LW_RESULTLINE_FIELD_READING, 0, color_switch, "[0m");
+      printf("\n");
+    }
     if (resultline->readings[1])
-      printf("%s%s\n", gettext("Name:"), resultline->readings[1]);
+    {
+      printf("%s", gettext("Name:"));
+      w_console_print_field (resultline, LW_RESULTLINE_FIELD_READING, 1, color_switch, "[0m");
+      printf("\n");
+    }
     if (resultline->readings[2])
-      printf("%s%s\n", gettext("Radical Name:"), resultline->readings[2]);
+    {
+      printf("%s", gettext("Radical Name:"));
+      w_console_print_field (resultline, LW_RESULTLINE_FIELD_READING, 2, color_switch, "[0m");
+      printf("\n");
+    }
 
     if (resultline->meanings)
-      printf("%s%s\n", gettext("Meanings:"), resultline->meanings);
+    {
+      printf("%s", gettext("Meanings:"));
+      w_console_print_field (resultline, LW_RESULTLINE_FIELD_MEANINGS, 0, color_switch, "[0m");
+      printf("\n");
+    }
     printf("\n");
 
     //Cleanup
@@ -241,7 +337,7 @@ w_console_append_examplesdict_result (WApplication *application, LwSearchItem *i
         printf ("[32;1m%s[0m", gettext("E:\t"));
       else
         printf ("%s", gettext("E:\t"));
-      printf ("%s", resultline->def_start[0]);
+      w_console_print_field (resultline, LW_RESULTLINE_FIELD_DEFINITION, 0, color_switch, "[0m");
     }
 
     if (resultline->kanji_start != NULL)
@@ -250,7 +346,7 @@ w_console_append_examplesdict_result (WApplication *application, LwSearchItem *i
         printf ("[32;1m%s[0m", gettext("\nJ:\t"));
       else
         printf ("%s", gettext("\nJ:\t"));
-      printf ("%s", resultline->kanji_start);
+      w_console_print_field (resultline, LW_RESULTLINE_FIELD_KANJI, 0, color_switch, "[0m");
     }
 
     if (resultline->furigana_start != NULL)
@@ -259,7 +355,7 @@ w_console_append_examplesdict_result (WApplication *application, LwSearchItem *i
         printf("[32;1m%s[0m", gettext("\nD:\t"));
       else
         printf("%s", gettext("\nD:\t"));
-      printf("%s", resultline->furigana_start);
+      w_console_print_field (resultline, LW_RESULTLINE_FIELD_FURIGANA, 0, color_switch, "[0m");
     }
 
     printf("\n\n");
@@ -279,14 +375,17 @@ w_console_append_unknowndict_result (WApplication *application, LwSearchItem *it
 
     //Definitions
     LwResultLine *resultline;
+    gboolean color_switch;
 
     //Initializations
     resultline = lw_searchitem_get_result (item);
     if (resultline == NULL) return;
+    color_switch = w_application_get_color_switch (application);
 
     w_console_append_less_relevant_header (application, item);
 
-    printf("%s\n", item->resultline->string);
+    w_console_print_field (resultline, LW_RESULTLINE_FIELD_STRING, 0, color_switch, "[0m");
+    printf("\n");
 
     //Cleanup
     lw_resultline_free (resultline);
@@ -402,3 +501,46 @@ w_console_no_result (WApplication *application, LwSearchItem *item)
     else
       printf("%s\n\n", gettext("No results found!"));
 }
+
+
+//!
+//! @brief Print the counters collected by the search engine for the --stats switch.
+//!
+void 
+w_console_print_stats (WApplication *application, LwSearchItem *item)
+{
+    //Sanity check
+    if (application == NULL || item == NULL) return;
+
+    //Declarations
+    LwSearchStats stats;
+
+    //Initializations
+    lw_searchitem_get_stats (item, &stats);
+
+    printf("\n%s\n", gettext("Search statistics:"));
+    printf("  %-34s %ld\n", gettext("Lines scanned"), stats.lines_scanned);
+    printf("  %-34s %ld\n", gettext("Bytes read"), stats.bytes_read);
+    printf("  %-34s %ld\n", gettext("Comment lines skipped"), stats.comment_lines_skipped);
+    if (stats.terms_matched > 0)
+      printf("  %-34s %ld\n", gettext("Fuzzy terms matched"), stats.terms_matched);
+    if (stats.literal_scans > 0)
+      printf("  %-34s %ld\n", gettext("Literal atom scans"), stats.literal_scans);
+    printf("  %-34s %ld / %ld / %ld\n", gettext("Regex high/medium/low"),
+           stats.regex_evaluations[LW_RELEVANCE_HIGH],
+           stats.regex_evaluations[LW_RELEVANCE_MEDIUM],
+           stats.regex_evaluations[LW_RELEVANCE_LOW]);
+    printf("  %-34s %ld / %ld / %ld / %ld / %ld\n", gettext("Regex kanji/furi/roma/mix/filter"),
+           stats.field_evaluations[LW_SEARCHFIELD_KANJI],
+           stats.field_evaluations[LW_SEARCHFIELD_FURIGANA],
+           stats.field_evaluations[LW_SEARCHFIELD_ROMAJI],
+           stats.field_evaluations[LW_SEARCHFIELD_MIX],
+           stats.field_evaluations[LW_SEARCHFIELD_FILTER]);
+    printf("  %-34s %d\n", gettext("Results accepted"), stats.results_accepted);
+    printf("  %-34s %d\n", gettext("Results dropped by caps"), stats.results_dropped);
+    printf("  %-34s %.3f ms\n", gettext("Query compile time"), stats.compile_time * 1000.0);
+    if (stats.first_result_time >= 0.0)
+      printf("  %-34s %.3f ms\n", gettext("Time to first result"), stats.first_result_time * 1000.0);
+    printf("  %-34s %.3f ms\n", gettext("Wall time"), stats.wall_time * 1000.0);
+    printf("  %-34s %.3f ms\n", gettext("CPU time"), stats.cpu_time * 1000.0);
+}
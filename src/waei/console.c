@@ -310,13 +310,7 @@ w_console_search (WApplication *application, GError **error)
     //Print the results
     lw_searchitem_start_search (item, TRUE, exact_switch);
 
-    g_timeout_add_full (
-        G_PRIORITY_LOW,
-        100,
-        (GSourceFunc) w_console_append_result_timeout,
-        item,
-        NULL
-    );
+    lw_searchitem_add_watch (item, NULL, w_console_append_result_watch, NULL, NULL);
 
     g_main_loop_run (loop);
 
@@ -333,6 +327,9 @@ w_console_search (WApplication *application, GError **error)
 
     lw_searchitem_cancel_search (item);
 
+    if (w_application_get_stats_switch (application))
+      w_console_print_stats (application, item);
+
     //Cleanup
     lw_searchitem_free (item);
 
@@ -16,10 +16,17 @@ struct _WApplicationPrivate {
   gboolean arg_list_switch;
   gboolean arg_version_switch;
   gboolean arg_color_switch;
+  gboolean arg_stats_switch;
+  gboolean arg_analyze_switch;
+  gint arg_jobs_switch_data;
+  gint arg_limit_switch_data;
 
   char* arg_dictionary_switch_data;
   char* arg_install_switch_data;
   char* arg_uninstall_switch_data;
+  char* arg_batch_switch_data;
+  char* arg_serve_switch_data;
+  char* arg_connect_switch_data;
   char* arg_query_text_data;
 
   GOptionContext *context;
@@ -36,6 +36,7 @@ void w_application_handle_error (WApplication*, GError**);
 
 LwPreferences* w_application_get_preferences (WApplication*);
 LwDictInfoList* w_application_get_dictinfolist (WApplication*);
+LwSearchItem* w_application_new_searchitem (WApplication*, const char*, LwDictInfo*, GError**);
 LwDictInstList* w_application_get_dictinstlist (WApplication*);
 
 gboolean w_application_get_quiet_switch (WApplication*);
@@ -43,11 +44,21 @@ gboolean w_application_get_exact_switch (WApplication*);
 gboolean w_application_get_list_switch (WApplication*);
 gboolean w_application_get_version_switch (WApplication*);
 gboolean w_application_get_color_switch (WApplication*);
+gboolean w_application_get_stats_switch (WApplication*);
+gboolean w_application_get_analyze_switch (WApplication*);
 const gchar* w_application_get_dictionary_switch_data (WApplication*);
 const gchar* w_application_get_install_switch_data (WApplication*);
 const gchar* w_application_get_uninstall_switch_data (WApplication*);
+const gchar* w_application_get_batch_switch_data (WApplication*);
+gint w_application_get_jobs_switch_data (WApplication*);
+const gchar* w_application_get_serve_switch_data (WApplication*);
+const gchar* w_application_get_connect_switch_data (WApplication*);
+gint w_application_get_limit_switch_data (WApplication*);
 const gchar* w_application_get_query_text_data (WApplication*);
 
+//Held while a query is parsed with the preferences of the application
+G_LOCK_EXTERN (w_application_parse_query);
+
 G_END_DECLS
 
 #endif
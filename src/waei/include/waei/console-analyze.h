@@ -0,0 +1,6 @@
+#ifndef W_CONSOLE_ANALYZE_INCLUDED
+#define W_CONSOLE_ANALYZE_INCLUDED
+
+int w_console_analyze (WApplication*, GError**);
+
+#endif
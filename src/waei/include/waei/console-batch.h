@@ -0,0 +1,10 @@
+#ifndef W_CONSOLE_BATCH_INCLUDED
+#define W_CONSOLE_BATCH_INCLUDED
+
+#define W_CONSOLE_BATCH_DEFAULT_JOBS 4
+#define W_CONSOLE_BATCH_WINDOW_PER_JOB 8 //!< Queries read ahead per worker before output has to catch up
+#define W_CONSOLE_BATCH_QUERY_CACHE 256   //!< Parsed queries kept for repeats after no search uses them
+
+int w_console_batch_search (WApplication*, GError**);
+
+#endif
@@ -1,6 +1,6 @@
 #ifndef W_CONSOLE_CALLBACKS_INCLUDED
 #define W_CONSOLE_CALLBACKS_INCLUDED
 
-gboolean w_console_append_result_timeout (gpointer);
+gboolean w_console_append_result_watch (LwSearchItem*, gpointer);
 
 #endif
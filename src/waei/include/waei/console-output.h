@@ -3,6 +3,8 @@
 
 void w_console_append_result (WApplication*, LwSearchItem*);
 void w_console_no_result (WApplication*, LwSearchItem*);
+void w_console_print_stats (WApplication*, LwSearchItem*);
+void w_console_print_edict_resultline (WApplication*, LwResultLine*);
 
 int w_console_install_progress_cb (double, gpointer);
 int w_console_uninstall_progress_cb (double, gpointer);
@@ -1,6 +1,8 @@
 #ifndef W_CONSOLE_INCLUDED
 #define W_CONSOLE_INCLUDED
 
+#define W_CONSOLE_RESULT_BUDGET 10 //!< Milliseconds of result printing per main loop dispatch
+
 void w_console_about (WApplication*);
 void w_console_list (WApplication*);
 void w_console_start_banner (WApplication*);
@@ -13,5 +15,7 @@ int w_console_search (WApplication*, GError**);
 
 #include "console-output.h"
 #include "console-callbacks.h"
+#include "console-batch.h"
+#include "console-analyze.h"
 
 #endif
@@ -0,0 +1,8 @@
+#ifndef W_JSON_INCLUDED
+#define W_JSON_INCLUDED
+
+void w_json_append_string (GString*, const char*);
+void w_json_append_resultline (GString*, const LwDictType, LwResultLine*);
+void w_json_append_stats (GString*, const LwSearchStats*);
+
+#endif
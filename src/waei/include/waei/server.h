@@ -0,0 +1,10 @@
+#ifndef W_SERVER_INCLUDED
+#define W_SERVER_INCLUDED
+
+#define W_SERVER_DEFAULT_JOBS 4
+#define W_SERVER_MAX_CONNECTIONS 16
+
+int w_server_run (WApplication*, GError**);
+int w_server_connect (WApplication*, GError**);
+
+#endif
@@ -9,6 +9,8 @@
 #include <libwaei/libwaei.h>
 #include <waei/application.h>
 #include <waei/search-data.h>
+#include <waei/json.h>
 #include <waei/console.h>
+#include <waei/server.h>
 
 #endif
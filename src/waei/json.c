@@ -0,0 +1,193 @@
+/******************************************************************************
+    AUTHOR:
+    File written and Copyrighted by Zachary Dovel. All Rights Reserved.
+
+    LICENSE:
+    This file is part of gWaei.
+
+    gWaei is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    gWaei is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    
+    You should have received a copy of the GNU General Public License
+    along with gWaei.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+//!
+//! @file json.c
+//!
+//! @brief Helpers to write search results as JSON for the machine readable modes
+//!
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <glib.h>
+
+#include <waei/waei.h>
+
+
+//!
+//! @brief Appends a quoted and escaped JSON string.  NULL is written as null.
+//! @param json The GString to append to
+//! @param TEXT A UTF-8 string or NULL
+//!
+void 
+w_json_append_string (GString *json, const char *TEXT)
+{
+    //Declarations
+    const char *ptr;
+
+    if (TEXT == NULL)
+    {
+      g_string_append (json, "null");
+      return;
+    }
+
+    g_string_append_c (json, '"');
+    for (ptr = TEXT; *ptr != '\0'; ptr++)
+    {
+      switch (*ptr)
+      {
+        case '"':
+          g_string_append (json, "\\\"");
+          break;
+        case '\\':
+          g_string_append (json, "\\\\");
+          break;
+        case '\n':
+          g_string_append (json, "\\n");
+          break;
+        case '\t':
+          g_string_append (json, "\\t");
+          break;
+        case '\r':
+          g_string_append (json, "\\r");
+          break;
+        default:
+          if ((guchar) *ptr < 0x20)
+            g_string_append_printf (json, "\\u%04x", (guint) *ptr);
+          else
+            g_string_append_c (json, *ptr);
+          break;
+      }
+    }
+    g_string_append_c (json, '"');
+}
+
+
+static void 
+_append_member (GString *json, const char *NAME, const char *VALUE)
+{
+    if (VALUE == NULL) return;
+
+    g_string_append_printf (json, ",\"%s\":", NAME);
+    w_json_append_string (json, VALUE);
+}
+
+
+static const char* 
+_get_relevance_name (LwResultLine *resultline)
+{
+    switch (resultline->relevance)
+    {
+      case LW_RESULTLINE_RELEVANCE_HIGH:
+        return "high";
+      case LW_RESULTLINE_RELEVANCE_MEDIUM:
+        return "medium";
+      default:
+        return "low";
+    }
+}
+
+
+//!
+//! @brief Appends a parsed result line as a JSON object.  The members depend on
+//!        the dictionary type in the same way the console output does.
+//! @param json The GString to append to
+//! @param TYPE The LwDictType the result line was parsed with
+//! @param resultline The LwResultLine to write out
+//!
+void 
+w_json_append_resultline (GString *json, const LwDictType TYPE, LwResultLine *resultline)
+{
+    //Declarations
+    int i;
+
+    g_string_append_printf (json, "{\"relevance\":\"%s\"", _get_relevance_name (resultline));
+
+    switch (TYPE)
+    {
+      case LW_DICTTYPE_KANJI:
+        _append_member (json, "kanji", resultline->kanji);
+        _append_member (json, "radicals", resultline->radicals);
+        _append_member (json, "strokes", resultline->strokes);
+        _append_member (json, "frequency", resultline->frequency);
+        _append_member (json, "grade", resultline->grade);
+        _append_member (json, "jlpt", resultline->jlpt);
+        _append_member (json, "readings", resultline->readings[0]);
+        _append_member (json, "name", resultline->readings[1]);
+        _append_member (json, "radical_name", resultline->readings[2]);
+        _append_member (json, "meanings", resultline->meanings);
+        break;
+      case LW_DICTTYPE_EXAMPLES:
+        _append_member (json, "english", resultline->def_start[0]);
+        _append_member (json, "japanese", resultline->kanji_start);
+        _append_member (json, "dissection", resultline->furigana_start);
+        break;
+      case LW_DICTTYPE_UNKNOWN:
+        _append_member (json, "text", resultline->string);
+        break;
+      default:
+        _append_member (json, "kanji", resultline->kanji_start);
+        _append_member (json, "furigana", resultline->furigana_start);
+        _append_member (json, "classification", resultline->classification_start);
+        g_string_append_printf (json, ",\"important\":%s", (resultline->important) ? "true" : "false");
+        g_string_append (json, ",\"definitions\":[");
+        for (i = 0; i < resultline->def_total; i++)
+        {
+          if (i > 0) g_string_append_c (json, ',');
+          w_json_append_string (json, resultline->def_start[i]);
+        }
+        g_string_append_c (json, ']');
+        break;
+    }
+
+    g_string_append_c (json, '}');
+}
+
+
+//!
+//! @brief Appends the counters of a LwSearchStats as a JSON object
+//! @param json The GString to append to
+//! @param stats The LwSearchStats to write out
+//!
+void 
+w_json_append_stats (GString *json, const LwSearchStats *stats)
+{
+    g_string_append_printf (json, "{\"lines_scanned\":%ld,\"bytes_read\":%ld,\"comment_lines_skipped\":%ld,\"terms_matched\":%ld,\"literal_scans\":%ld",
+                            stats->lines_scanned, stats->bytes_read, stats->comment_lines_skipped, stats->terms_matched, stats->literal_scans);
+    g_string_append_printf (json, ",\"regex_high\":%ld,\"regex_medium\":%ld,\"regex_low\":%ld",
+                            stats->regex_evaluations[LW_RELEVANCE_HIGH],
+                            stats->regex_evaluations[LW_RELEVANCE_MEDIUM],
+                            stats->regex_evaluations[LW_RELEVANCE_LOW]);
+    g_string_append_printf (json, ",\"regex_kanji\":%ld,\"regex_furigana\":%ld,\"regex_romaji\":%ld,\"regex_mix\":%ld,\"regex_filter\":%ld",
+                            stats->field_evaluations[LW_SEARCHFIELD_KANJI],
+                            stats->field_evaluations[LW_SEARCHFIELD_FURIGANA],
+                            stats->field_evaluations[LW_SEARCHFIELD_ROMAJI],
+                            stats->field_evaluations[LW_SEARCHFIELD_MIX],
+                            stats->field_evaluations[LW_SEARCHFIELD_FILTER]);
+    g_string_append_printf (json, ",\"results_accepted\":%d,\"results_dropped\":%d",
+                            stats->results_accepted, stats->results_dropped);
+    g_string_append_printf (json, ",\"compile_ms\":%.3f,\"first_result_ms\":%.3f,\"wall_ms\":%.3f,\"cpu_ms\":%.3f}",
+                            stats->compile_time * 1000.0, stats->first_result_time * 1000.0,
+                            stats->wall_time * 1000.0, stats->cpu_time * 1000.0);
+}
+
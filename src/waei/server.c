@@ -0,0 +1,672 @@
+/******************************************************************************
+    AUTHOR:
+    File written and Copyrighted by Zachary Dovel. All Rights Reserved.
+
+    LICENSE:
+    This file is part of gWaei.
+
+    gWaei is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    gWaei is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    
+    You should have received a copy of the GNU General Public License
+    along with gWaei.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+//!
+//! @file server.c
+//!
+//! @brief A long lived search server on a unix socket for the --serve switch
+//!        and the matching --connect client.
+//!
+//! Requests are framed as "key: value" lines ended by an empty line.  The
+//! recognized keys are command (search, cancel or stats), id, query,
+//! dictionary, exact and limit.  Every response is one line of JSON that
+//! carries the id of its request.  Search results are written as soon as
+//! the engine hands them over and a search ends with a "done" line.
+//!
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <gio/gio.h>
+#ifdef G_OS_UNIX
+#include <signal.h>
+#include <glib-unix.h>
+#include <gio/gunixsocketaddress.h>
+#endif
+
+#include <waei/waei.h>
+
+
+#ifdef G_OS_UNIX
+
+//!
+//! @brief State shared by every connection of the server
+//!
+struct _WServer {
+  WApplication *application;
+  GThreadPool *pool;
+  GMainLoop *loop;
+  GMutex *mutex;
+  LwSearchStats totals;     //!< Sum of the stats of every finished search
+  gint requests;            //!< Searches handled since the server started
+  gint active;              //!< Searches that are still running
+  gboolean stopping;        //!< Set when the server shuts down so queued searches are refused
+};
+typedef struct _WServer WServer;
+
+//!
+//! @brief One connected client
+//!
+struct _WServerClient {
+  WServer *server;
+  GOutputStream *output;
+  GMutex *mutex;
+  GCond *cond;
+  GHashTable *requests;     //!< Running WServerRequests keyed by their id
+  gint running;
+  gint next_id;
+};
+typedef struct _WServerClient WServerClient;
+
+//!
+//! @brief A search requested by a client
+//!
+struct _WServerRequest {
+  WServerClient *client;
+  gint id;
+  gchar *query;
+  gchar *dictionary;
+  gboolean exact;
+  gint limit;
+  gboolean cancel;          //!< Set by a cancel command.  Guarded by the client mutex.
+  GMainContext *context;    //!< Runs the watch of the search in its worker
+
+  LwDictType type;
+  gint total;
+  gboolean cancelled;
+  gboolean finished;
+};
+typedef struct _WServerRequest WServerRequest;
+
+
+static void 
+_server_add_stats (LwSearchStats *total, const LwSearchStats *stats)
+{
+    int i;
+
+    total->lines_scanned += stats->lines_scanned;
+    total->bytes_read += stats->bytes_read;
+    total->comment_lines_skipped += stats->comment_lines_skipped;
+    total->terms_matched += stats->terms_matched;
+    total->literal_scans += stats->literal_scans;
+    for (i = 0; i < LW_RELEVANCE_TOTAL; i++)
+      total->regex_evaluations[i] += stats->regex_evaluations[i];
+    for (i = 0; i < LW_SEARCHFIELD_TOTAL; i++)
+      total->field_evaluations[i] += stats->field_evaluations[i];
+    total->results_accepted += stats->results_accepted;
+    total->results_dropped += stats->results_dropped;
+    total->compile_time += stats->compile_time;
+    if (stats->first_result_time > 0.0)
+      total->first_result_time += stats->first_result_time;
+    total->wall_time += stats->wall_time;
+    total->cpu_time += stats->cpu_time;
+}
+
+
+//!
+//! @brief Writes a finished response line to the client
+//! @returns FALSE if the client went away
+//!
+static gboolean 
+_server_client_write (WServerClient *client, GString *line)
+{
+    gboolean written;
+
+    g_string_append_c (line, '\n');
+
+    g_mutex_lock (client->mutex);
+    written = g_output_stream_write_all (client->output, line->str, line->len, NULL, NULL, NULL);
+    g_mutex_unlock (client->mutex);
+
+    return written;
+}
+
+
+static void 
+_server_client_write_error (WServerClient *client, gint id, const char *MESSAGE)
+{
+    GString *line;
+
+    line = g_string_new (NULL);
+    g_string_append_printf (line, "{\"id\":%d,\"error\":", id);
+    w_json_append_string (line, MESSAGE);
+    g_string_append_c (line, '}');
+
+    _server_client_write (client, line);
+
+    g_string_free (line, TRUE);
+}
+
+
+static gboolean 
+_server_request_is_cancelled (WServerRequest *request)
+{
+    gboolean cancel;
+
+    g_mutex_lock (request->client->mutex);
+    cancel = request->cancel;
+    g_mutex_unlock (request->client->mutex);
+
+    return cancel;
+}
+
+
+static void 
+_server_request_free (WServerRequest *request)
+{
+    g_free (request->query);
+    g_free (request->dictionary);
+    g_main_context_unref (request->context);
+    g_free (request);
+}
+
+
+//!
+//! @brief Streams the results of a search as the engine reports them
+//! @returns FALSE once the search is finished
+//!
+static gboolean 
+_server_request_watch (LwSearchItem *item, gpointer data)
+{
+    //Declarations
+    WServerRequest *request;
+    LwResultLine *resultline;
+    GString *line;
+
+    //Initializations
+    request = data;
+    line = g_string_new (NULL);
+
+    while ((resultline = lw_searchitem_get_result (item)) != NULL)
+    {
+      if (!request->cancelled)
+      {
+        g_string_printf (line, "{\"id\":%d,\"result\":", request->id);
+        w_json_append_resultline (line, request->type, resultline);
+        g_string_append_c (line, '}');
+        if (!_server_client_write (request->client, line)) request->cancelled = TRUE;
+        request->total++;
+
+        if (request->limit > 0 && request->total >= request->limit) request->cancelled = TRUE;
+        if (request->cancelled) lw_searchitem_cancel_search (item);
+      }
+      lw_resultline_free (resultline);
+    }
+
+    g_string_free (line, TRUE);
+
+    request->finished = !lw_searchitem_should_check_results (item);
+
+    return !request->finished;
+}
+
+
+//!
+//! @brief Runs one search on the worker pool and streams its results
+//!
+static void 
+_server_search_func (gpointer data, gpointer user_data)
+{
+    //Declarations
+    WServerRequest *request;
+    WServerClient *client;
+    WServer *server;
+    LwDictInfoList *dictinfolist;
+    LwDictInfo *di;
+    LwSearchItem *item;
+    LwSearchStats stats;
+    GString *line;
+    GError *error;
+    gboolean stopping;
+
+    //Initializations
+    request = data;
+    server = user_data;
+    client = request->client;
+    dictinfolist = w_application_get_dictinfolist (server->application);
+    di = lw_dictinfolist_get_dictinfo_fuzzy (dictinfolist, request->dictionary);
+    line = g_string_new (NULL);
+    error = NULL;
+    item = NULL;
+
+    g_mutex_lock (server->mutex);
+    stopping = server->stopping;
+    g_mutex_unlock (server->mutex);
+
+    if (stopping)
+      _server_client_write_error (client, request->id, "The server is shutting down");
+    else if (di == NULL)
+      _server_client_write_error (client, request->id, gettext("Requested dictionary not found!"));
+    else if ((item = w_application_new_searchitem (server->application, request->query, di, &error)) == NULL)
+      _server_client_write_error (client, request->id, (error != NULL) ? error->message : "Invalid query");
+
+    if (item != NULL)
+    {
+      request->type = di->type;
+      lw_searchitem_start_search (item, TRUE, request->exact);
+      lw_searchitem_add_watch (item, request->context, _server_request_watch, request, NULL);
+
+      //A cancel command wakes the context up without a result to hand over
+      while (!request->finished)
+      {
+        g_main_context_iteration (request->context, TRUE);
+        if (!request->cancelled && _server_request_is_cancelled (request))
+        {
+          request->cancelled = TRUE;
+          lw_searchitem_cancel_search (item);
+        }
+      }
+
+      lw_searchitem_get_stats (item, &stats);
+
+      g_string_printf (line, "{\"id\":%d,\"done\":true,\"cancelled\":%s,\"total\":%d,\"stats\":",
+                       request->id, (request->cancelled) ? "true" : "false", request->total);
+      w_json_append_stats (line, &stats);
+      g_string_append_c (line, '}');
+      _server_client_write (client, line);
+
+      g_mutex_lock (server->mutex);
+      _server_add_stats (&server->totals, &stats);
+      g_mutex_unlock (server->mutex);
+
+      lw_searchitem_free (item);
+    }
+
+    //Cleanup
+    g_string_free (line, TRUE);
+    if (error != NULL) g_error_free (error);
+
+    g_mutex_lock (server->mutex);
+    server->active--;
+    g_mutex_unlock (server->mutex);
+
+    g_mutex_lock (client->mutex);
+    g_hash_table_remove (client->requests, GINT_TO_POINTER (request->id));
+    client->running--;
+    g_cond_broadcast (client->cond);
+    g_mutex_unlock (client->mutex);
+
+    _server_request_free (request);
+}
+
+
+static void 
+_server_write_stats (WServerClient *client, gint id)
+{
+    //Declarations
+    WServer *server;
+    GString *line;
+
+    //Initializations
+    server = client->server;
+    line = g_string_new (NULL);
+
+    g_mutex_lock (server->mutex);
+    g_string_printf (line, "{\"id\":%d,\"requests\":%d,\"active\":%d,\"stats\":", id, server->requests, server->active);
+    w_json_append_stats (line, &server->totals);
+    g_mutex_unlock (server->mutex);
+    g_string_append_c (line, '}');
+
+    _server_client_write (client, line);
+
+    g_string_free (line, TRUE);
+}
+
+
+//!
+//! @brief Acts on one complete request frame
+//!
+static void 
+_server_dispatch (WServerClient *client, GHashTable *frame)
+{
+    //Declarations
+    WServer *server;
+    WServerRequest *request;
+    const char *command;
+    const char *value;
+    gboolean in_use;
+    gboolean stopping;
+    gint id;
+
+    //Initializations
+    server = client->server;
+    command = g_hash_table_lookup (frame, "command");
+    if (command == NULL) command = "search";
+    value = g_hash_table_lookup (frame, "id");
+    id = (value != NULL) ? (gint) strtol (value, NULL, 10) : client->next_id++;
+
+    if (strcmp (command, "stats") == 0)
+    {
+      _server_write_stats (client, id);
+    }
+    else if (strcmp (command, "cancel") == 0)
+    {
+      g_mutex_lock (client->mutex);
+      request = g_hash_table_lookup (client->requests, GINT_TO_POINTER (id));
+      if (request != NULL)
+      {
+        request->cancel = TRUE;
+        g_main_context_wakeup (request->context);
+      }
+      g_mutex_unlock (client->mutex);
+    }
+    else if (strcmp (command, "search") == 0)
+    {
+      if ((value = g_hash_table_lookup (frame, "query")) == NULL)
+      {
+        _server_client_write_error (client, id, "A query is required");
+        return;
+      }
+
+      request = g_new0 (WServerRequest, 1);
+      request->client = client;
+      request->id = id;
+      request->query = g_strdup (value);
+      request->dictionary = g_strdup (g_hash_table_lookup (frame, "dictionary"));
+      value = g_hash_table_lookup (frame, "exact");
+      request->exact = (value != NULL && (strcmp (value, "true") == 0 || strcmp (value, "1") == 0));
+      value = g_hash_table_lookup (frame, "limit");
+      request->limit = (value != NULL) ? (gint) strtol (value, NULL, 10) : 0;
+      request->context = g_main_context_new ();
+
+      //A running id has to stay unique so it can be cancelled
+      g_mutex_lock (client->mutex);
+      in_use = (g_hash_table_lookup (client->requests, GINT_TO_POINTER (id)) != NULL);
+      if (!in_use)
+      {
+        g_hash_table_insert (client->requests, GINT_TO_POINTER (id), request);
+        client->running++;
+      }
+      g_mutex_unlock (client->mutex);
+
+      if (in_use)
+      {
+        _server_client_write_error (client, id, "A request with this id is still running");
+        _server_request_free (request);
+        return;
+      }
+
+      //The pool is only pushed to before shutdown starts waiting on it
+      g_mutex_lock (server->mutex);
+      stopping = server->stopping;
+      if (!stopping)
+      {
+        server->requests++;
+        server->active++;
+        g_thread_pool_push (server->pool, request, NULL);
+      }
+      g_mutex_unlock (server->mutex);
+
+      if (stopping)
+      {
+        g_mutex_lock (client->mutex);
+        g_hash_table_remove (client->requests, GINT_TO_POINTER (id));
+        client->running--;
+        g_cond_broadcast (client->cond);
+        g_mutex_unlock (client->mutex);
+
+        _server_client_write_error (client, id, "The server is shutting down");
+        _server_request_free (request);
+      }
+    }
+    else
+    {
+      _server_client_write_error (client, id, "Unknown command");
+    }
+}
+
+
+//!
+//! @brief Reads the request frames of a connection.  GThreadedSocketService
+//!        runs this in its own thread for every client.
+//!
+static gboolean 
+_server_run_cb (GThreadedSocketService *service, GSocketConnection *connection, GObject *source_object, gpointer data)
+{
+    //Declarations
+    WServerClient client;
+    GDataInputStream *input;
+    GHashTable *frame;
+    gchar *line;
+    gchar *value;
+
+    //Initializations
+    client.server = data;
+    client.output = g_io_stream_get_output_stream (G_IO_STREAM (connection));
+    client.mutex = g_mutex_new ();
+    client.cond = g_cond_new ();
+    client.requests = g_hash_table_new (g_direct_hash, g_direct_equal);
+    client.running = 0;
+    client.next_id = 1;
+    input = g_data_input_stream_new (g_io_stream_get_input_stream (G_IO_STREAM (connection)));
+    frame = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+
+    while ((line = g_data_input_stream_read_line (input, NULL, NULL, NULL)) != NULL)
+    {
+      g_strchomp (line);
+      if (*line == '\0')
+      {
+        if (g_hash_table_size (frame) > 0) _server_dispatch (&client, frame);
+        g_hash_table_remove_all (frame);
+      }
+      else if ((value = strchr (line, ':')) != NULL)
+      {
+        *value = '\0';
+        value++;
+        g_hash_table_insert (frame, g_strdup (g_strstrip (line)), g_strdup (g_strstrip (value)));
+      }
+      g_free (line);
+    }
+    if (g_hash_table_size (frame) > 0) _server_dispatch (&client, frame);
+
+    //The client may have only closed its side so let the searches finish
+    g_mutex_lock (client.mutex);
+    while (client.running > 0)
+      g_cond_wait (client.cond, client.mutex);
+    g_mutex_unlock (client.mutex);
+
+    //Cleanup
+    g_hash_table_unref (frame);
+    g_object_unref (input);
+    g_hash_table_unref (client.requests);
+    g_cond_free (client.cond);
+    g_mutex_free (client.mutex);
+
+    return TRUE;
+}
+
+
+static gboolean 
+_server_quit_cb (gpointer data)
+{
+    g_main_loop_quit ((GMainLoop*) data);
+
+    return FALSE;
+}
+
+#endif
+
+
+//!
+//! @brief Runs the search server until it is interrupted
+//! @param application The WApplication holding the switch data
+//! @param error A pointer to a GError to write errors to or NULL
+//!
+int 
+w_server_run (WApplication *application, GError **error)
+{
+    //Sanity check
+    if (error != NULL && *error != NULL) return 1;
+
+#ifdef G_OS_UNIX
+    //Declarations
+    WServer server;
+    GSocketService *service;
+    GSocketAddress *address;
+    GStatBuf info;
+    const gchar *path;
+    gint jobs;
+
+    //Initializations
+    path = w_application_get_serve_switch_data (application);
+    jobs = w_application_get_jobs_switch_data (application);
+    if (jobs < 1) jobs = W_SERVER_DEFAULT_JOBS;
+    memset (&server, 0, sizeof(WServer));
+    server.application = application;
+
+    //Load everything the searches share up front
+    w_application_get_preferences (application);
+    w_application_get_dictinfolist (application);
+
+    //Replace a socket left behind by a server that did not shut down
+    if (g_stat (path, &info) == 0 && S_ISSOCK (info.st_mode))
+      g_unlink (path);
+
+    service = g_threaded_socket_service_new (W_SERVER_MAX_CONNECTIONS);
+    address = g_unix_socket_address_new (path);
+    if (!g_socket_listener_add_address (G_SOCKET_LISTENER (service), address, G_SOCKET_TYPE_STREAM, G_SOCKET_PROTOCOL_DEFAULT, NULL, NULL, error))
+    {
+      g_object_unref (address);
+      g_object_unref (service);
+      return 1;
+    }
+
+    server.mutex = g_mutex_new ();
+    server.loop = g_main_loop_new (NULL, FALSE);
+    server.pool = g_thread_pool_new (_server_search_func, &server, jobs, TRUE, error);
+
+    if (server.pool != NULL)
+    {
+      g_signal_connect (G_OBJECT (service), "run", G_CALLBACK (_server_run_cb), &server);
+      g_unix_signal_add (SIGINT, _server_quit_cb, server.loop);
+      g_unix_signal_add (SIGTERM, _server_quit_cb, server.loop);
+
+      g_socket_service_start (service);
+      fprintf (stderr, gettext("Listening on %s\n"), path);
+      g_main_loop_run (server.loop);
+      g_socket_service_stop (service);
+    }
+
+    //Cleanup
+    g_socket_listener_close (G_SOCKET_LISTENER (service));
+    g_object_unref (service);
+    g_object_unref (address);
+    g_unlink (path);
+
+    //Queued searches still run so their clients hear back, but only to refuse
+    g_mutex_lock (server.mutex);
+    server.stopping = TRUE;
+    g_mutex_unlock (server.mutex);
+    if (server.pool != NULL) g_thread_pool_free (server.pool, FALSE, TRUE);
+    g_main_loop_unref (server.loop);
+    g_mutex_free (server.mutex);
+
+    return (server.pool == NULL);
+#else
+    fprintf (stderr, "%s\n", gettext("The search server needs unix sockets."));
+    return 1;
+#endif
+}
+
+
+//!
+//! @brief Sends the query or a stats request to a running server and prints the
+//!        response lines as they arrive
+//! @param application The WApplication holding the switch data
+//! @param error A pointer to a GError to write errors to or NULL
+//!
+int 
+w_server_connect (WApplication *application, GError **error)
+{
+    //Sanity check
+    if (error != NULL && *error != NULL) return 1;
+
+#ifdef G_OS_UNIX
+    //Declarations
+    GSocketClient *socketclient;
+    GSocketConnection *connection;
+    GSocketAddress *address;
+    GDataInputStream *input;
+    GOutputStream *output;
+    GString *frame;
+    const gchar *query;
+    const gchar *dictionary;
+    gchar *line;
+    gint limit;
+
+    //Initializations
+    query = w_application_get_query_text_data (application);
+    dictionary = w_application_get_dictionary_switch_data (application);
+    limit = w_application_get_limit_switch_data (application);
+    frame = g_string_new (NULL);
+
+    if (query != NULL)
+    {
+      g_string_append_printf (frame, "command: search\nid: 1\nquery: %s\n", query);
+      if (dictionary != NULL) g_string_append_printf (frame, "dictionary: %s\n", dictionary);
+      if (w_application_get_exact_switch (application)) g_string_append (frame, "exact: true\n");
+      if (limit > 0) g_string_append_printf (frame, "limit: %d\n", limit);
+    }
+    else
+    {
+      g_string_append (frame, "command: stats\nid: 1\n");
+    }
+    g_string_append_c (frame, '\n');
+
+    socketclient = g_socket_client_new ();
+    address = g_unix_socket_address_new (w_application_get_connect_switch_data (application));
+    connection = g_socket_client_connect (socketclient, G_SOCKET_CONNECTABLE (address), NULL, error);
+
+    if (connection != NULL)
+    {
+      output = g_io_stream_get_output_stream (G_IO_STREAM (connection));
+      input = g_data_input_stream_new (g_io_stream_get_input_stream (G_IO_STREAM (connection)));
+
+      //Closing our side tells the server there are no more requests
+      if (g_output_stream_write_all (output, frame->str, frame->len, NULL, NULL, error))
+        g_socket_shutdown (g_socket_connection_get_socket (connection), FALSE, TRUE, NULL);
+
+      while ((line = g_data_input_stream_read_line (input, NULL, NULL, NULL)) != NULL)
+      {
+        printf ("%s\n", line);
+        fflush (stdout);
+        g_free (line);
+      }
+
+      g_object_unref (input);
+      g_object_unref (connection);
+    }
+
+    //Cleanup
+    g_object_unref (address);
+    g_object_unref (socketclient);
+    g_string_free (frame, TRUE);
+
+    return (error != NULL && *error != NULL);
+#else
+    fprintf (stderr, "%s\n", gettext("The search server needs unix sockets."));
+    return 1;
+#endif
+}